@@ -0,0 +1,141 @@
+//
+//  BenchAnalysis.c
+//  VoiceChanger Benchmarks
+//
+//  Shared spectral analysis context: FFT count and chain cost with every spectral consumer
+//  requesting the same block, compared with each consumer running its own STFT
+//
+
+#include "BenchCommon.h"
+#include "VCCore.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define kAudioSeconds   10
+#define kOwnStftStages  4       // NS・ピッチシフター・フォルマントシフター・メーター
+
+/// 各段が独自に持つ STFT（共有しない場合の比較用）
+typedef struct {
+    VCFFTPlan *plan;
+    float window[VC_ANALYSIS_FFT_SIZE];
+    float history[VC_ANALYSIS_FFT_SIZE + VC_MAX_FRAME_SIZE];
+    float frame[VC_ANALYSIS_FFT_SIZE];
+    float re[VC_ANALYSIS_BINS];
+    float im[VC_ANALYSIS_BINS];
+    float power[VC_ANALYSIS_BINS];
+} OwnStft;
+
+static void own_stft_init(OwnStft *stft) {
+    stft->plan = vc_fft_plan_create(VC_ANALYSIS_FFT_SIZE);
+    for (int i = 0; i < VC_ANALYSIS_FFT_SIZE; i++) {
+        stft->window[i] = 0.5f - 0.5f * (float)cos(2.0 * M_PI * i / VC_ANALYSIS_FFT_SIZE);
+    }
+    for (int i = 0; i < VC_ANALYSIS_FFT_SIZE + VC_MAX_FRAME_SIZE; i++) {
+        stft->history[i] = 0;
+    }
+}
+
+/// ブロック内の全フレームを窓掛け + FFT（戻り値は FFT 回数）
+static int own_stft_process(OwnStft *stft, const float *samples, int count) {
+    int keep = VC_ANALYSIS_FFT_SIZE;
+    for (int i = 0; i < keep; i++) {
+        stft->history[i] = stft->history[i + count];
+    }
+    for (int i = 0; i < count; i++) {
+        stft->history[keep + i] = samples[i];
+    }
+
+    int frames = count / VC_ANALYSIS_HOP;
+    for (int f = 0; f < frames; f++) {
+        int end = keep + count - (frames - 1 - f) * VC_ANALYSIS_HOP;
+        const float *x = stft->history + end - VC_ANALYSIS_FFT_SIZE;
+        for (int i = 0; i < VC_ANALYSIS_FFT_SIZE; i++) {
+            stft->frame[i] = x[i] * stft->window[i];
+        }
+        vc_fft_forward(stft->plan, stft->frame, stft->re, stft->im);
+        vc_complex_power(stft->re, stft->im, stft->power, VC_ANALYSIS_BINS);
+    }
+    bench_consume(stft->power, VC_ANALYSIS_BINS);
+    return frames;
+}
+
+/// 後段が共有コンテキストに要求する内容（ピッチシフター: 全フレームの複素スペクトル、
+/// NS: 全フレームの振幅、フォルマント: 最新フレームの対数スペクトル + LPC、メーター: 最新フレームのパワー）
+static void consume_shared(VCAnalysisContext *context) {
+    int frames = vc_analysis_frame_count(context);
+    for (int f = 0; f < frames; f++) {
+        const float *re, *im;
+        vc_analysis_spectrum(context, f, &re, &im);
+        bench_consume(re, 1);
+        bench_consume(vc_analysis_magnitude(context, f), 1);
+    }
+    bench_consume(vc_analysis_log_spectrum(context, frames - 1), 1);
+    bench_consume(vc_analysis_lpc(context, NULL), 1);
+    bench_consume(vc_analysis_power(context, frames - 1), 1);
+}
+
+static void bench_block_size(const float *signal, float *work, int total, int blockSize) {
+    int blocks = total / blockSize;
+    double blockUs = (double)blockSize / kBenchSampleRate * 1e6;
+    double ns[2];
+    double ffts[2];
+
+    for (int shared = 1; shared >= 0; shared--) {
+        VCChain *chain = vc_chain_create(kBenchSampleRate);
+        VCAnalysisContext *context = vc_chain_analysis_context(chain);
+        OwnStft *own = calloc(kOwnStftStages, sizeof(OwnStft));
+        for (int s = 0; s < kOwnStftStages; s++) {
+            own_stft_init(&own[s]);
+        }
+
+        uint64_t ownFfts = 0;
+        uint64_t startFfts = vc_analysis_fft_count(context);
+        uint64_t start = bench_now_ns();
+        for (int b = 0; b < blocks; b++) {
+            float *block = work + (size_t)b * blockSize;
+            vc_chain_process(chain, signal + (size_t)b * blockSize, block, blockSize);
+            if (shared) {
+                consume_shared(context);
+            } else {
+                for (int s = 0; s < kOwnStftStages; s++) {
+                    ownFfts += (uint64_t)own_stft_process(&own[s], block, blockSize);
+                }
+            }
+        }
+        ns[shared] = (double)(bench_now_ns() - start) / blocks;
+        ffts[shared] = (double)(vc_analysis_fft_count(context) - startFfts + ownFfts) / blocks;
+        bench_consume(work, total);
+
+        for (int s = 0; s < kOwnStftStages; s++) {
+            vc_fft_plan_destroy(own[s].plan);
+        }
+        free(own);
+        vc_chain_destroy(chain);
+    }
+
+    printf("block=%-4d shared %5.2f FFT/block %7.1f ns/block (%.2f%%)  "
+           "per-stage %5.2f FFT/block %7.1f ns/block (%.2f%%)\n",
+           blockSize, ffts[1], ns[1], ns[1] / (blockUs * 10.0), ffts[0], ns[0], ns[0] / (blockUs * 10.0));
+}
+
+void bench_analysis(void) {
+    int total = kAudioSeconds * kBenchSampleRate;
+    float *signal = malloc((size_t)total * sizeof(float));
+    float *work = malloc((size_t)total * sizeof(float));
+    bench_fill_voice(signal, total, kBenchSampleRate, 140.0f, 9);
+
+    // 共有: 全段の要求を満たしても FFT はフレーム数 + LPC の逆変換 1 回
+    // 各段独自: VAD（発話候補のみ）+ 4 段 × フレーム数
+    static const int kBlockSizes[] = { 128, 256, 512 };
+    for (int s = 0; s < 3; s++) {
+        bench_block_size(signal, work, total, kBlockSizes[s]);
+    }
+
+    free(signal);
+    free(work);
+}
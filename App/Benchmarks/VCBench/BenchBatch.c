@@ -0,0 +1,118 @@
+//
+//  BenchBatch.c
+//  VoiceChanger Benchmarks
+//
+//  Streams-per-core: scalar VCChain vs SoA VCChainBatch at 4/8/16 lanes
+//
+
+#include "BenchCommon.h"
+#include "VCCore.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define kBlockSize      256
+#define kAudioSeconds   4
+#define kStreamCount    16
+
+static void stream_params(VCChainParams *params, int stream) {
+    vc_chain_params_default(params);
+    params->eqLow = (float)(stream % 5) - 2.0f;
+    params->eqHigh = (float)(stream % 3);
+    params->noiseSuppressionEnabled = stream % 2;
+}
+
+/// 1コアで kStreamCount 本を処理した x-realtime（= 1コアあたりのリアルタイムストリーム数）
+static double run_scalar(float **inputs, float *output, int samplesPerStream) {
+    VCChain *chains[kStreamCount];
+    for (int s = 0; s < kStreamCount; s++) {
+        VCChainParams params;
+        stream_params(&params, s);
+        chains[s] = vc_chain_create(kBenchSampleRate);
+        vc_chain_set_params(chains[s], &params);
+    }
+
+    uint64_t start = bench_now_ns();
+    for (int offset = 0; offset + kBlockSize <= samplesPerStream; offset += kBlockSize) {
+        for (int s = 0; s < kStreamCount; s++) {
+            vc_chain_process(chains[s], inputs[s] + offset, output, kBlockSize);
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_consume(output, kBlockSize);
+
+    for (int s = 0; s < kStreamCount; s++) {
+        vc_chain_destroy(chains[s]);
+    }
+
+    double audioSeconds = (double)kStreamCount * samplesPerStream / kBenchSampleRate;
+    return audioSeconds / ((double)elapsed / 1e9);
+}
+
+static double run_batch(int lanes, float **inputs, float *packed, int samplesPerStream) {
+    int groupCount = kStreamCount / lanes;
+    VCChainBatch *batches[kStreamCount];
+    for (int g = 0; g < groupCount; g++) {
+        batches[g] = vc_chain_batch_create(lanes, kBenchSampleRate);
+        for (int lane = 0; lane < lanes; lane++) {
+            VCChainParams params;
+            stream_params(&params, g * lanes + lane);
+            vc_chain_batch_set_lane_params(batches[g], lane, &params);
+        }
+    }
+
+    // インターリーブ処理込みで計測（実運用と同じくブロックごとに pack/unpack）
+    float *outputs[VC_BATCH_MAX_LANES];
+    float scratch[VC_BATCH_MAX_LANES][kBlockSize];
+    for (int lane = 0; lane < lanes; lane++) {
+        outputs[lane] = scratch[lane];
+    }
+
+    uint64_t start = bench_now_ns();
+    for (int offset = 0; offset + kBlockSize <= samplesPerStream; offset += kBlockSize) {
+        for (int g = 0; g < groupCount; g++) {
+            const float *blockInputs[VC_BATCH_MAX_LANES];
+            for (int lane = 0; lane < lanes; lane++) {
+                blockInputs[lane] = inputs[g * lanes + lane] + offset;
+            }
+            vc_batch_pack(blockInputs, packed, lanes, kBlockSize);
+            vc_chain_batch_process(batches[g], packed, packed, kBlockSize);
+            vc_batch_unpack(packed, outputs, lanes, kBlockSize);
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_consume(scratch[0], kBlockSize);
+
+    for (int g = 0; g < groupCount; g++) {
+        vc_chain_batch_destroy(batches[g]);
+    }
+
+    double audioSeconds = (double)kStreamCount * samplesPerStream / kBenchSampleRate;
+    return audioSeconds / ((double)elapsed / 1e9);
+}
+
+void bench_batch(void) {
+    int samplesPerStream = kAudioSeconds * kBenchSampleRate;
+    float *inputs[kStreamCount];
+    for (int s = 0; s < kStreamCount; s++) {
+        inputs[s] = malloc((size_t)samplesPerStream * sizeof(float));
+        bench_fill_voice(inputs[s], samplesPerStream, kBenchSampleRate, 110.0f + 10.0f * s, (uint32_t)(s + 1));
+    }
+    float *packed = malloc((size_t)kBlockSize * VC_BATCH_MAX_LANES * sizeof(float));
+
+    printf("streams=%d block=%d audio=%ds/stream (single core)\n", kStreamCount, kBlockSize, kAudioSeconds);
+
+    double scalar = run_scalar(inputs, packed, samplesPerStream);
+    printf("scalar    streams-per-core=%9.1f\n", scalar);
+
+    static const int kLaneCounts[] = { 4, 8, 16 };
+    for (int i = 0; i < 3; i++) {
+        int lanes = kLaneCounts[i];
+        double batched = run_batch(lanes, inputs, packed, samplesPerStream);
+        printf("batch x%-2d streams-per-core=%9.1f speedup=%5.2fx\n", lanes, batched, batched / scalar);
+    }
+
+    free(packed);
+    for (int s = 0; s < kStreamCount; s++) {
+        free(inputs[s]);
+    }
+}
@@ -0,0 +1,62 @@
+//
+//  BenchCommon.c
+//  VoiceChanger Benchmarks
+//
+//  Shared helpers for VCBench
+//
+
+#include "BenchCommon.h"
+#include <math.h>
+#include <time.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static volatile float gBenchSink = 0;
+
+uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void bench_fill_noise(float *samples, int count, float amplitude, uint32_t *seed) {
+    uint32_t state = *seed;
+    for (int i = 0; i < count; i++) {
+        // xorshift32
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        samples[i] = amplitude * ((float)(state >> 8) / 8388608.0f - 1.0f);
+    }
+    *seed = state;
+}
+
+void bench_fill_voice(float *samples, int count, int sampleRate, float f0, uint32_t seed) {
+    bench_fill_noise(samples, count, 0.003f, &seed);
+
+    double phase = 0;
+    const int syllable = sampleRate / 4;  // 250ms 発話 / 250ms 無音
+    for (int i = 0; i < count; i++) {
+        int voiced = (i / syllable) % 2 == 0;
+        // ゆっくりとしたビブラート
+        double freq = f0 * (1.0 + 0.02 * sin(2.0 * M_PI * 5.0 * i / sampleRate));
+        phase += 2.0 * M_PI * freq / sampleRate;
+        if (voiced) {
+            float s = 0;
+            for (int h = 1; h <= 6; h++) {
+                s += (float)(sin(phase * h) / h);
+            }
+            samples[i] += 0.2f * s;
+        }
+    }
+}
+
+void bench_consume(const float *samples, int count) {
+    float acc = 0;
+    for (int i = 0; i < count; i++) {
+        acc += samples[i];
+    }
+    gBenchSink += acc;
+}
@@ -0,0 +1,70 @@
+//
+//  BenchCommon.h
+//  VoiceChanger Benchmarks
+//
+//  Shared helpers for VCBench
+//
+
+#ifndef BenchCommon_h
+#define BenchCommon_h
+
+#include <stdint.h>
+
+#define kBenchSampleRate 48000
+
+/// 単調増加クロック（ナノ秒）
+uint64_t bench_now_ns(void);
+
+/// 音声に近いテスト信号（基音+倍音+ノイズ、無音区間あり）を生成
+void bench_fill_voice(float *samples, int count, int sampleRate, float f0, uint32_t seed);
+
+/// 一様ノイズ（-amplitude〜amplitude）
+void bench_fill_noise(float *samples, int count, float amplitude, uint32_t *seed);
+
+/// 最適化で結果が消えないようにする
+void bench_consume(const float *samples, int count);
+
+/// ベンチマーク関数
+typedef void (*BenchFunction)(void);
+
+/// 各ベンチマーク
+void bench_multistream(void);
+void bench_batch(void);
+void bench_log(void);
+void bench_meter(void);
+void bench_loopback(void);
+void bench_echo_canceller(void);
+void bench_vad(void);
+void bench_pitch(void);
+void bench_analysis(void);
+void bench_convolution(void);
+void bench_multiband(void);
+void bench_oversampling(void);
+void bench_preset_bank(void);
+void bench_virtual_mic(void);
+void bench_reattach(void);
+void bench_tap_recorder(void);
+void bench_graph(void);
+void bench_voice_converter(void);
+void bench_fast_math(void);
+void bench_signal_guard(void);
+
+/// ベンチマーク用の DSP グラフ（"linear" / "duet" / "wide"、BenchGraph.c）
+/// CONVOLVER には内蔵のホール IR を背景スレッドなしで付ける。知らない名前なら NULL
+typedef struct BenchGraph BenchGraph;
+BenchGraph *bench_graph_create(const char *name, int naiveBuffers, int workerCount);
+void bench_graph_process(void *graph, const float *input, float *output, int frames);
+void bench_graph_destroy(void *graph);
+
+/// ベンチマーク用の声質変換（"small" / "default" / "large"、BenchVoiceConverter.c）
+/// 乱数の重みのモデルを /tmp に書き出して開く。知らない名前・書けない場合は NULL
+typedef struct BenchVoiceConverter BenchVoiceConverter;
+BenchVoiceConverter *bench_voice_converter_create(const char *name, int scalarKernels, int lookAheadFrames);
+void bench_voice_converter_process(void *converter, const float *input, float *output, int frames);
+void bench_voice_converter_destroy(void *converter);
+
+/// 回帰スイート（VCBench --suite ...。argv は --suite の後ろ）
+/// - Returns: 終了コード（0 = OK、4 = ベースラインより遅くなったケースがある）
+int bench_suite_main(int argc, char **argv);
+
+#endif /* BenchCommon_h */
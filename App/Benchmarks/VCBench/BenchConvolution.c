@@ -0,0 +1,157 @@
+//
+//  BenchConvolution.c
+//  VoiceChanger Benchmarks
+//
+//  Non-uniform partitioned convolution: cost vs impulse response length at 128-frame blocks,
+//  inline vs background tail stages, and loading a memory-mapped IR
+//
+
+#include "BenchCommon.h"
+#include "VCCore.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define kBlockSize      128
+#define kAudioSeconds   2
+#define kPaceSpeedup    1       // オーディオデバイスと同じ間隔で供給する（大きくすると背景スレッドの猶予が縮む）
+#define kWavPath        "/tmp/vcbench-ir.wav"
+
+static void sleep_until(uint64_t deadlineNs) {
+    struct timespec ts = {
+        .tv_sec = (time_t)(deadlineNs / 1000000000ull),
+        .tv_nsec = (long)(deadlineNs % 1000000000ull),
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+    }
+}
+
+/// 指数減衰する雑音（残響 IR 相当）
+static void fill_ir(float *ir, int length) {
+    uint32_t seed = 5;
+    bench_fill_noise(ir, length, 1.0f, &seed);
+    float decay = -6.9078f / (float)length;
+    for (int i = 0; i < length; i++) {
+        ir[i] *= expf(decay * (float)i);
+    }
+}
+
+/// 背景段も process 内で計算したときの 1 ブロックあたりのコスト（全段の合計）
+static double inline_ns_per_block(const float *ir, int length, const float *signal, float *work, int total) {
+    VCConvolver *convolver = vc_convolver_create(ir, length, 0);
+    int blocks = total / kBlockSize;
+    uint64_t start = bench_now_ns();
+    for (int b = 0; b < blocks; b++) {
+        vc_convolver_process(convolver, signal + (size_t)b * kBlockSize, work + (size_t)b * kBlockSize, kBlockSize);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_consume(work, total);
+    vc_convolver_destroy(convolver);
+    return (double)elapsed / blocks;
+}
+
+/// 背景スレッドありで実時間に沿って供給し、オーディオスレッド側のコストと遅れを測る
+static void threaded_run(const float *ir, int length, const float *signal, float *work, int total,
+                         double *outMeanNs, double *outMaxNs, VCConvolverStats *outStats) {
+    VCConvolver *convolver = vc_convolver_create(ir, length, 1);
+    int blocks = total / kBlockSize;
+    uint64_t period = (uint64_t)kBlockSize * 1000000000ull / kBenchSampleRate / kPaceSpeedup;
+    uint64_t deadline = bench_now_ns();
+    uint64_t sum = 0, worst = 0;
+    for (int b = 0; b < blocks; b++) {
+        sleep_until(deadline);
+        deadline += period;
+        uint64_t start = bench_now_ns();
+        vc_convolver_process(convolver, signal + (size_t)b * kBlockSize, work + (size_t)b * kBlockSize, kBlockSize);
+        uint64_t elapsed = bench_now_ns() - start;
+        sum += elapsed;
+        worst = elapsed > worst ? elapsed : worst;
+    }
+    bench_consume(work, total);
+    vc_convolver_get_stats(convolver, outStats);
+    vc_convolver_destroy(convolver);
+    *outMeanNs = (double)sum / blocks;
+    *outMaxNs = (double)worst;
+}
+
+/// 32bit float モノラルの WAV を書く
+static int write_wav(const char *path, const float *samples, int length) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return -1;
+    }
+    uint32_t dataBytes = (uint32_t)length * 4;
+    uint8_t header[44];
+    memcpy(header, "RIFF", 4);
+    uint32_t riffSize = 36 + dataBytes;
+    memcpy(header + 4, &riffSize, 4);
+    memcpy(header + 8, "WAVEfmt ", 8);
+    uint32_t fmtSize = 16, rate = kBenchSampleRate, byteRate = kBenchSampleRate * 4;
+    uint16_t format = 3, channels = 1, align = 4, bits = 32;
+    memcpy(header + 16, &fmtSize, 4);
+    memcpy(header + 20, &format, 2);
+    memcpy(header + 22, &channels, 2);
+    memcpy(header + 24, &rate, 4);
+    memcpy(header + 28, &byteRate, 4);
+    memcpy(header + 32, &align, 2);
+    memcpy(header + 34, &bits, 2);
+    memcpy(header + 36, "data", 4);
+    memcpy(header + 40, &dataBytes, 4);
+    int ok = fwrite(header, 1, sizeof(header), file) == sizeof(header) &&
+             fwrite(samples, sizeof(float), (size_t)length, file) == (size_t)length;
+    fclose(file);
+    return ok ? 0 : -1;
+}
+
+void bench_convolution(void) {
+    static const float kSeconds[] = { 0.03f, 0.25f, 0.5f, 1.0f, 2.0f, 4.0f };
+    int maxLength = (int)(4.0f * kBenchSampleRate);
+    int total = kAudioSeconds * kBenchSampleRate / kBlockSize * kBlockSize;
+    float *ir = malloc((size_t)maxLength * sizeof(float));
+    float *signal = malloc((size_t)total * sizeof(float));
+    float *work = malloc((size_t)total * sizeof(float));
+    bench_fill_voice(signal, total, kBenchSampleRate, 140.0f, 9);
+
+    double blockUs = (double)kBlockSize / kBenchSampleRate * 1e6;
+    printf("block=%d, threaded runs fed at %dx real time\n", kBlockSize, kPaceSpeedup);
+    for (int i = 0; i < (int)(sizeof(kSeconds) / sizeof(kSeconds[0])); i++) {
+        int length = (int)(kSeconds[i] * kBenchSampleRate);
+        fill_ir(ir, length);
+
+        double inlineNs = inline_ns_per_block(ir, length, signal, work, total);
+        double meanNs, maxNs;
+        VCConvolverStats stats;
+        threaded_run(ir, length, signal, work, total, &meanNs, &maxNs, &stats);
+        printf("ir=%5.2f s (%6d taps, %d stages)  inline %8.1f ns/block (%5.2f%%)  "
+               "audio thread %7.1f ns/block (%5.2f%%) max %8.1f ns  tail blocks %5llu late %llu\n",
+               kSeconds[i], length, stats.stages, inlineNs, inlineNs / (blockUs * 10.0),
+               meanNs, meanNs / (blockUs * 10.0), maxNs,
+               (unsigned long long)stats.tailBlocks, (unsigned long long)stats.lateBlocks);
+    }
+
+    // 4 秒の IR を mmap で読み、分割スペクトルへ変換するまで
+    int length = maxLength;
+    fill_ir(ir, length);
+    if (write_wav(kWavPath, ir, length) == 0) {
+        uint64_t start = bench_now_ns();
+        VCImpulseResponse loaded;
+        int status = vc_ir_load(kWavPath, &loaded);
+        uint64_t mapped = bench_now_ns();
+        VCConvolver *convolver = status == 0 ? vc_convolver_create(loaded.samples, loaded.length, 1) : NULL;
+        uint64_t built = bench_now_ns();
+        printf("load %d-tap wav: map %.1f us (%s), partition + transform %.2f ms\n", length,
+               (double)(mapped - start) / 1e3, status == 0 && loaded.converted == NULL ? "zero-copy" : "converted",
+               (double)(built - mapped) / 1e6);
+        vc_convolver_destroy(convolver);
+        if (status == 0) {
+            vc_ir_release(&loaded);
+        }
+        remove(kWavPath);
+    }
+
+    free(ir);
+    free(signal);
+    free(work);
+}
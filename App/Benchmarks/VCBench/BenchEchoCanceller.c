@@ -0,0 +1,178 @@
+//
+//  BenchEchoCanceller.c
+//  VoiceChanger Benchmarks
+//
+//  Echo canceller: ERLE on synthetic echo paths, double-talk behaviour and per-block cost
+//
+
+#include "BenchCommon.h"
+#include "VCCore.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define kAudioSeconds       16
+#define kBlockSize          128
+#define kTailMs             100
+#define kDoubleTalkStart    10      // 秒。ここから3秒間近端話者が話す
+#define kDoubleTalkSeconds  3
+#define kTimingBlocks       20000
+
+typedef struct {
+    const char *name;
+    int length;         // インパルス応答長
+    int delay;          // 直接音までの遅延
+    float decayFrames;  // 残響の時定数
+    float gain;         // 経路全体のゲイン（L2 ノルム）
+} EchoPath;
+
+static const EchoPath kPaths[] = {
+    { "headphone leak", 256, 48, 30.0f, 0.1f },
+    { "laptop speaker", 2400, 200, 300.0f, 0.5f },
+    { "room", 4000, 400, 900.0f, 0.7f },
+};
+
+/// ノイズ × 指数減衰のインパルス応答
+static void make_path(const EchoPath *path, float *response, uint32_t seed) {
+    memset(response, 0, (size_t)path->length * sizeof(float));
+    bench_fill_noise(response + path->delay, path->length - path->delay, 1.0f, &seed);
+    double norm = 0;
+    for (int i = path->delay; i < path->length; i++) {
+        response[i] *= expf(-(float)(i - path->delay) / path->decayFrames);
+        norm += (double)response[i] * response[i];
+    }
+    float scale = path->gain / (float)sqrt(norm);
+    for (int i = 0; i < path->length; i++) {
+        response[i] *= scale;
+    }
+}
+
+static void convolve(const float *input, const float *response, int length, float *output, int count) {
+    for (int n = 0; n < count; n++) {
+        float sum = 0;
+        int taps = n + 1 < length ? n + 1 : length;
+        for (int k = 0; k < taps; k++) {
+            sum += response[k] * input[n - k];
+        }
+        output[n] = sum;
+    }
+}
+
+static double ratio_db(const float *reference, const float *a, const float *b, int start, int end) {
+    double num = 0, den = 0;
+    for (int i = start; i < end; i++) {
+        num += (double)reference[i] * reference[i];
+        double diff = (double)a[i] - (b != NULL ? b[i] : 0.0f);
+        den += diff * diff;
+    }
+    return 10.0 * log10((num + 1e-12) / (den + 1e-12));
+}
+
+static void bench_path(const EchoPath *path, const float *far, const float *talker, int total) {
+    float *response = malloc((size_t)path->length * sizeof(float));
+    float *echo = malloc((size_t)total * sizeof(float));
+    float *nearEnd = malloc((size_t)total * sizeof(float));
+    float *near = malloc((size_t)total * sizeof(float));
+    float *output = malloc((size_t)total * sizeof(float));
+
+    make_path(path, response, 5);
+    convolve(far, response, path->length, echo, total);
+
+    // マイク = エコー + 近端話者（ダブルトーク区間のみ）+ 背景雑音 -80 dBFS
+    int dtStart = kDoubleTalkStart * kBenchSampleRate;
+    int dtEnd = dtStart + kDoubleTalkSeconds * kBenchSampleRate;
+    uint32_t seed = 1;
+    bench_fill_noise(near, total, 1e-4f, &seed);
+    for (int i = dtStart; i < dtEnd; i++) {
+        near[i] += 0.5f * talker[i];
+    }
+    for (int i = 0; i < total; i++) {
+        nearEnd[i] = echo[i] + near[i];
+    }
+
+    VCEchoCanceller *aec = vc_aec_create(kBlockSize, kTailMs * kBenchSampleRate / 1000);
+    for (int b = 0; b + kBlockSize <= total; b += kBlockSize) {
+        vc_aec_process(aec, far + b, nearEnd + b, output + b);
+    }
+    VCEchoCancellerStats stats;
+    vc_aec_get_stats(aec, &stats);
+
+    // ERLE = エコー / 残留エコー（近端成分を除いた残差）
+    int sr = kBenchSampleRate;
+    double erleEarly = ratio_db(echo, output, near, 1 * sr, 2 * sr);
+    double erleSteady = ratio_db(echo, output, near, 6 * sr, dtStart);
+    double erleAfter = ratio_db(echo, output, near, dtEnd + sr, total);
+    // ダブルトーク中の近端の保たれ方（残留エコー + 歪み に対する近端の比）
+    double nearSnr = ratio_db(near, output, near, dtStart, dtEnd);
+    double inputSnr = ratio_db(near, nearEnd, near, dtStart, dtEnd);
+
+    printf("%-15s taps=%-5d ERLE 1-2s %5.1f dB  6-10s %5.1f dB  after DT %5.1f dB  "
+           "DT near/residual %5.1f dB (input %5.1f dB)  DT blocks %llu\n",
+           path->name, path->length, erleEarly, erleSteady, erleAfter, nearSnr, inputSnr,
+           (unsigned long long)stats.doubleTalkBlocks);
+
+    vc_aec_destroy(aec);
+    free(response);
+    free(echo);
+    free(nearEnd);
+    free(near);
+    free(output);
+}
+
+/// 1ブロックあたりの処理時間と、その中の複素 MAC（Σ W·X と適応）の割合
+static void bench_cost(const float *far, const float *nearEnd, int total) {
+    VCEchoCanceller *aec = vc_aec_create(kBlockSize, kTailMs * kBenchSampleRate / 1000);
+    float output[kBlockSize];
+    int blocks = total / kBlockSize;
+
+    uint64_t start = bench_now_ns();
+    for (int i = 0; i < kTimingBlocks; i++) {
+        int b = (i % blocks) * kBlockSize;
+        vc_aec_process(aec, far + b, nearEnd + b, output);
+    }
+    double blockNs = (double)(bench_now_ns() - start) / kTimingBlocks;
+    bench_consume(output, kBlockSize);
+    vc_aec_destroy(aec);
+
+    // 同じ規模の MAC のみ（パーティション数 × 2 回 / ブロック）
+    int partitions = (kTailMs * kBenchSampleRate / 1000 + kBlockSize - 1) / kBlockSize;
+    int bins = (kBlockSize + 1 + 3) & ~3;
+    float *a = calloc((size_t)partitions * bins * 2, sizeof(float));
+    float *acc = calloc((size_t)bins * 2, sizeof(float));
+    uint32_t seed = 3;
+    bench_fill_noise(a, partitions * bins * 2, 1.0f, &seed);
+    start = bench_now_ns();
+    for (int i = 0; i < kTimingBlocks; i++) {
+        for (int p = 0; p < partitions; p++) {
+            const float *re = a + (size_t)p * bins * 2;
+            vc_complex_mac(acc, acc + bins, re, re + bins, re, re + bins, bins);
+            vc_complex_conj_mac(acc, acc + bins, re, re + bins, re, re + bins, bins);
+        }
+    }
+    double macNs = (double)(bench_now_ns() - start) / kTimingBlocks;
+    bench_consume(acc, bins * 2);
+    free(a);
+    free(acc);
+
+    double blockUs = (double)kBlockSize / kBenchSampleRate * 1e6;
+    printf("cost: block=%d tail=%dms (%d partitions) %8.1f ns/block (%.2f%% of block time), "
+           "of which complex MAC %8.1f ns\n",
+           kBlockSize, kTailMs, partitions, blockNs, blockNs / (blockUs * 10.0), macNs);
+}
+
+void bench_echo_canceller(void) {
+    int total = kAudioSeconds * kBenchSampleRate;
+    float *far = malloc((size_t)total * sizeof(float));
+    float *talker = malloc((size_t)total * sizeof(float));
+    bench_fill_voice(far, total, kBenchSampleRate, 180.0f, 3);
+    bench_fill_voice(talker, total, kBenchSampleRate, 120.0f, 9);
+
+    for (int i = 0; i < (int)(sizeof(kPaths) / sizeof(kPaths[0])); i++) {
+        bench_path(&kPaths[i], far, talker, total);
+    }
+    bench_cost(far, talker, total);
+
+    free(far);
+    free(talker);
+}
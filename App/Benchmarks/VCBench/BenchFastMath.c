@@ -0,0 +1,267 @@
+//
+//  BenchFastMath.c
+//  VoiceChanger Benchmarks
+//
+//  Fast-math kernels: ns per value for libm, the inline scalar approximations and the 4-wide block kernels,
+//  with the largest error against libm evaluated in double
+//
+
+#include "BenchCommon.h"
+#include "VCCore.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define kValues         4096    // L1 に収まる長さ（メモリではなく計算の速さを比べる）
+#define kRepeats        500
+
+typedef void (*MathKernel)(const float *a, const float *b, float *out, float *out2, int count);
+
+typedef struct {
+    const char *name;
+    float lo, hi;               // a の範囲
+    float lo2, hi2;             // b の範囲（2 引数の関数のみ）
+    int logScale;               // a を対数で一様に取る（log・dB）
+    MathKernel libm;
+    MathKernel scalar;
+    MathKernel block;
+    double (*reference)(double a, double b);
+    int relative;               // 相対誤差で比べる（exp・pow・dB → linear）
+} MathCase;
+
+#pragma mark - Kernels
+
+static void libm_exp(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)b, (void)out2;
+    for (int i = 0; i < count; i++) {
+        out[i] = expf(a[i]);
+    }
+}
+
+static void scalar_exp(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)b, (void)out2;
+    for (int i = 0; i < count; i++) {
+        out[i] = vc_fast_expf(a[i]);
+    }
+}
+
+static void block_exp(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)b, (void)out2;
+    vc_fast_exp(a, out, count);
+}
+
+static void libm_log(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)b, (void)out2;
+    for (int i = 0; i < count; i++) {
+        out[i] = logf(a[i]);
+    }
+}
+
+static void scalar_log(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)b, (void)out2;
+    for (int i = 0; i < count; i++) {
+        out[i] = vc_fast_logf(a[i]);
+    }
+}
+
+static void block_log(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)b, (void)out2;
+    vc_fast_log(a, out, count);
+}
+
+static void libm_pow(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)out2;
+    for (int i = 0; i < count; i++) {
+        out[i] = powf(a[i], b[i]);
+    }
+}
+
+static void scalar_pow(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)out2;
+    for (int i = 0; i < count; i++) {
+        out[i] = vc_fast_powf(a[i], b[i]);
+    }
+}
+
+static void block_pow(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)out2;
+    vc_fast_pow(a, b, out, count);
+}
+
+static void libm_tanh(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)b, (void)out2;
+    for (int i = 0; i < count; i++) {
+        out[i] = tanhf(a[i]);
+    }
+}
+
+static void scalar_tanh(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)b, (void)out2;
+    for (int i = 0; i < count; i++) {
+        out[i] = vc_fast_tanhf(a[i]);
+    }
+}
+
+static void block_tanh(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)b, (void)out2;
+    vc_fast_tanh(a, out, count);
+}
+
+static void libm_sincos(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)b;
+    for (int i = 0; i < count; i++) {
+        out[i] = sinf(a[i]);
+        out2[i] = cosf(a[i]);
+    }
+}
+
+static void scalar_sincos(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)b;
+    for (int i = 0; i < count; i++) {
+        vc_fast_sincosf(a[i], &out[i], &out2[i]);
+    }
+}
+
+static void block_sincos(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)b;
+    vc_fast_sincos(a, out, out2, count);
+}
+
+static void libm_atan2(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)out2;
+    for (int i = 0; i < count; i++) {
+        out[i] = atan2f(a[i], b[i]);
+    }
+}
+
+static void scalar_atan2(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)out2;
+    for (int i = 0; i < count; i++) {
+        out[i] = vc_fast_atan2f(a[i], b[i]);
+    }
+}
+
+static void block_atan2(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)out2;
+    vc_fast_atan2(a, b, out, count);
+}
+
+static void libm_db_to_linear(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)b, (void)out2;
+    for (int i = 0; i < count; i++) {
+        out[i] = powf(10.0f, a[i] / 20.0f);
+    }
+}
+
+static void scalar_db_to_linear(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)b, (void)out2;
+    for (int i = 0; i < count; i++) {
+        out[i] = vc_fast_db_to_linear(a[i]);
+    }
+}
+
+static void block_db_to_linear(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)b, (void)out2;
+    vc_fast_db_to_linear_block(a, out, count);
+}
+
+static void libm_linear_to_db(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)b, (void)out2;
+    for (int i = 0; i < count; i++) {
+        out[i] = 20.0f * log10f(a[i]);
+    }
+}
+
+static void scalar_linear_to_db(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)b, (void)out2;
+    for (int i = 0; i < count; i++) {
+        out[i] = vc_fast_linear_to_db(a[i]);
+    }
+}
+
+static void block_linear_to_db(const float *a, const float *b, float *out, float *out2, int count) {
+    (void)b, (void)out2;
+    vc_fast_linear_to_db_block(a, out, count);
+}
+
+#pragma mark - References
+
+static double ref_exp(double a, double b) { (void)b; return exp(a); }
+static double ref_log(double a, double b) { (void)b; return log(a); }
+static double ref_pow(double a, double b) { return pow(a, b); }
+static double ref_tanh(double a, double b) { (void)b; return tanh(a); }
+static double ref_sin(double a, double b) { (void)b; return sin(a); }
+static double ref_atan2(double a, double b) { return atan2(a, b); }
+static double ref_db_to_linear(double a, double b) { (void)b; return pow(10.0, a / 20.0); }
+static double ref_linear_to_db(double a, double b) { (void)b; return 20.0 * log10(a); }
+
+static const MathCase kCases[] = {
+    { "exp", -20, 20, 0, 0, 0, libm_exp, scalar_exp, block_exp, ref_exp, 1 },
+    { "log", 1e-6f, 1e3f, 0, 0, 1, libm_log, scalar_log, block_log, ref_log, 0 },
+    { "pow", 1e-3f, 1e3f, -4, 4, 1, libm_pow, scalar_pow, block_pow, ref_pow, 1 },
+    { "tanh", -4, 4, 0, 0, 0, libm_tanh, scalar_tanh, block_tanh, ref_tanh, 0 },
+    { "sincos", -3.2f, 3.2f, 0, 0, 0, libm_sincos, scalar_sincos, block_sincos, ref_sin, 0 },
+    { "atan2", -1, 1, -1, 1, 0, libm_atan2, scalar_atan2, block_atan2, ref_atan2, 0 },
+    { "db->linear", -120, 20, 0, 0, 0, libm_db_to_linear, scalar_db_to_linear, block_db_to_linear, ref_db_to_linear, 1 },
+    { "linear->db", 1e-6f, 4, 0, 0, 1, libm_linear_to_db, scalar_linear_to_db, block_linear_to_db, ref_linear_to_db, 0 },
+};
+
+#pragma mark - Measurement
+
+static double ns_per_value(MathKernel kernel, const float *a, const float *b, float *out, float *out2) {
+    kernel(a, b, out, out2, kValues);
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < kRepeats; r++) {
+        kernel(a, b, out, out2, kValues);
+        bench_consume(out, 1);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_consume(out, kValues);
+    return (double)elapsed / ((double)kRepeats * kValues);
+}
+
+static double max_error(const MathCase *c, const float *a, const float *b, const float *out) {
+    double worst = 0;
+    for (int i = 0; i < kValues; i++) {
+        double expected = c->reference(a[i], b[i]);
+        double error = fabs(out[i] - expected);
+        worst = fmax(worst, c->relative ? error / fabs(expected) : error);
+    }
+    return worst;
+}
+
+void bench_fast_math(void) {
+    float *a = malloc(kValues * sizeof(float));
+    float *b = malloc(kValues * sizeof(float));
+    float *out = malloc(kValues * sizeof(float));
+    float *out2 = malloc(kValues * sizeof(float));
+    printf("%d values x %d, ns/value (x = speedup over libm), max error vs double libm (rel for exp/pow/dB->linear)\n",
+           kValues, kRepeats);
+
+    for (size_t n = 0; n < sizeof(kCases) / sizeof(kCases[0]); n++) {
+        const MathCase *c = &kCases[n];
+        uint32_t seed = 17 + (uint32_t)n;
+        bench_fill_noise(a, kValues, 0.5f, &seed);
+        bench_fill_noise(b, kValues, 0.5f, &seed);
+        for (int i = 0; i < kValues; i++) {
+            float u = a[i] + 0.5f;
+            a[i] = c->logScale ? c->lo * powf(c->hi / c->lo, u) : c->lo + (c->hi - c->lo) * u;
+            b[i] = c->lo2 + (c->hi2 - c->lo2) * (b[i] + 0.5f);
+        }
+
+        double libmNs = ns_per_value(c->libm, a, b, out, out2);
+        double libmError = max_error(c, a, b, out);
+        double scalarNs = ns_per_value(c->scalar, a, b, out, out2);
+        double scalarError = max_error(c, a, b, out);
+        double blockNs = ns_per_value(c->block, a, b, out, out2);
+        double blockError = max_error(c, a, b, out);
+        printf("  %-11s libm %6.2f ns (err %.1e)  scalar %6.2f ns (%4.1fx, err %.1e)  block %6.2f ns (%4.1fx, err %.1e)\n",
+               c->name, libmNs, libmError, scalarNs, libmNs / scalarNs, scalarError, blockNs, libmNs / blockNs,
+               blockError);
+    }
+
+    free(a);
+    free(b);
+    free(out);
+    free(out2);
+}
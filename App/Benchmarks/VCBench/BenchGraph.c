@@ -0,0 +1,200 @@
+//
+//  BenchGraph.c
+//  VoiceChanger Benchmarks
+//
+//  DSP graph: working set and per-block cost with liveness-based buffers vs one buffer per node,
+//  and independent branches on helper threads
+//
+
+#include "BenchCommon.h"
+#include "VCCore.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define kAudioSeconds   10
+#define kMaxConvolvers  4
+
+struct BenchGraph {
+    VCGraph *graph;
+    VCConvolver *convolvers[kMaxConvolvers];
+    int convolverCount;
+};
+
+static int add_node(VCGraphNodeDesc *nodes, int *count, VCGraphNodeKind kind, int input, float param) {
+    VCGraphNodeDesc *node = &nodes[*count];
+    vc_graph_node_init(node, kind);
+    if (input >= 0) {
+        node->inputs[node->inputCount++] = input;
+    }
+    if (param != 0) {
+        node->param[0] = param;
+    }
+    return (*count)++;
+}
+
+/// input → hpf → vad → gate → agc（gate / agc は vad に従う）。agc の番号を返す
+static int add_front(VCGraphNodeDesc *nodes, int *count) {
+    int input = add_node(nodes, count, VC_GRAPH_NODE_INPUT, -1, 0);
+    int hpf = add_node(nodes, count, VC_GRAPH_NODE_HPF, input, 0);
+    int vad = add_node(nodes, count, VC_GRAPH_NODE_VAD, hpf, 0);
+    int gate = add_node(nodes, count, VC_GRAPH_NODE_GATE, vad, 0);
+    nodes[gate].sidechain = vad;
+    int agc = add_node(nodes, count, VC_GRAPH_NODE_AGC, gate, 0);
+    nodes[agc].sidechain = vad;
+    return agc;
+}
+
+static int add_mix(VCGraphNodeDesc *nodes, int *count, const int *inputs, const float *gains, int inputCount) {
+    VCGraphNodeDesc *node = &nodes[*count];
+    vc_graph_node_init(node, VC_GRAPH_NODE_MIX);
+    for (int i = 0; i < inputCount; i++) {
+        node->inputs[i] = inputs[i];
+        node->gains[i] = gains[i];
+    }
+    node->inputCount = inputCount;
+    return (*count)++;
+}
+
+/// 名前からグラフを組み立てる（ノード数、知らない名前なら 0）
+///   linear: 既定のプリセットと同じ直列の処理
+///   duet:   ProcessingGraph.layered(semitones: -12)（VoicePreset.duet）
+///   wide:   4 本の移調レイヤーとホールを並べ、2 段の mix で合流する
+static int describe(const char *name, VCGraphNodeDesc *nodes) {
+    int count = 0;
+    int agc = add_front(nodes, &count);
+    int last;
+    if (strcmp(name, "linear") == 0) {
+        int eq = add_node(nodes, &count, VC_GRAPH_NODE_EQ, agc, 0);
+        last = add_node(nodes, &count, VC_GRAPH_NODE_LIMITER, eq, 0);
+    } else if (strcmp(name, "duet") == 0) {
+        int shift = add_node(nodes, &count, VC_GRAPH_NODE_PITCH_SHIFT, agc, -12);
+        int eq = add_node(nodes, &count, VC_GRAPH_NODE_EQ, shift, 2);
+        int wet = add_node(nodes, &count, VC_GRAPH_NODE_CONVOLVER, agc, 0);
+        int mixed = add_mix(nodes, &count, (const int[]){ agc, eq, wet }, (const float[]){ 0.8f, 0.45f, 0.3f }, 3);
+        last = add_node(nodes, &count, VC_GRAPH_NODE_LIMITER, mixed, 0);
+    } else if (strcmp(name, "wide") == 0) {
+        static const float kSemitones[] = { -12, -5, 7, 12 };
+        int layers[4];
+        for (int i = 0; i < 4; i++) {
+            int shift = add_node(nodes, &count, VC_GRAPH_NODE_PITCH_SHIFT, agc, kSemitones[i]);
+            layers[i] = add_node(nodes, &count, VC_GRAPH_NODE_EQ, shift, 0);
+        }
+        int wet = add_node(nodes, &count, VC_GRAPH_NODE_CONVOLVER, agc, 0);
+        int low = add_mix(nodes, &count, (const int[]){ agc, layers[0], layers[1] }, (const float[]){ 0.7f, 0.3f, 0.3f }, 3);
+        int high = add_mix(nodes, &count, (const int[]){ low, layers[2], layers[3], wet },
+                           (const float[]){ 1.0f, 0.25f, 0.25f, 0.3f }, 4);
+        last = add_node(nodes, &count, VC_GRAPH_NODE_LIMITER, high, 0);
+    } else {
+        return 0;
+    }
+    add_node(nodes, &count, VC_GRAPH_NODE_OUTPUT, last, 0);
+    return count;
+}
+
+BenchGraph *bench_graph_create(const char *name, int naiveBuffers, int workerCount) {
+    VCGraphNodeDesc nodes[VC_GRAPH_MAX_NODES];
+    int count = describe(name, nodes);
+    VCGraphOptions options = { naiveBuffers, workerCount };
+    BenchGraph *bench = calloc(1, sizeof(BenchGraph));
+    bench->graph = count > 0 ? vc_graph_create(kBenchSampleRate, nodes, count, &options, NULL) : NULL;
+    if (bench->graph == NULL) {
+        free(bench);
+        return NULL;
+    }
+
+    // 内蔵のホール（背景スレッドなし。後段も処理したスレッドで計算する）
+    int length = vc_ir_builtin_length(VC_IR_HALL, kBenchSampleRate);
+    float *ir = malloc((size_t)length * sizeof(float));
+    vc_ir_builtin_render(VC_IR_HALL, kBenchSampleRate, ir, length);
+    for (int n = 0; n < count && bench->convolverCount < kMaxConvolvers; n++) {
+        if (nodes[n].kind == VC_GRAPH_NODE_CONVOLVER) {
+            VCConvolver *convolver = vc_convolver_create(ir, length, 0);
+            vc_graph_set_convolver(bench->graph, n, convolver);
+            bench->convolvers[bench->convolverCount++] = convolver;
+        }
+    }
+    free(ir);
+    return bench;
+}
+
+void bench_graph_process(void *graph, const float *input, float *output, int frames) {
+    vc_graph_process(((BenchGraph *)graph)->graph, input, output, frames);
+}
+
+void bench_graph_destroy(void *graph) {
+    BenchGraph *bench = graph;
+    if (bench == NULL) {
+        return;
+    }
+    vc_graph_destroy(bench->graph);
+    for (int i = 0; i < bench->convolverCount; i++) {
+        vc_convolver_destroy(bench->convolvers[i]);
+    }
+    free(bench);
+}
+
+static double ns_per_block(BenchGraph *bench, const float *signal, float *work, int total, int blockSize) {
+    int blocks = total / blockSize;
+    uint64_t start = bench_now_ns();
+    for (int b = 0; b < blocks; b++) {
+        size_t offset = (size_t)b * blockSize;
+        vc_graph_process(bench->graph, signal + offset, work + offset, blockSize);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_consume(work, blocks * blockSize);
+    return (double)elapsed / blocks;
+}
+
+void bench_graph(void) {
+    static const char *kGraphs[] = { "linear", "duet", "wide" };
+    static const int kBlockSizes[] = { 128, 256, 512 };
+    int total = kAudioSeconds * kBenchSampleRate;
+    float *signal = malloc((size_t)total * sizeof(float));
+    float *work = malloc((size_t)total * sizeof(float));
+    bench_fill_voice(signal, total, kBenchSampleRate, 140.0f, 29);
+    int cpus = vc_stream_pool_cpu_count();
+
+    for (int g = 0; g < 3; g++) {
+        BenchGraph *naive = bench_graph_create(kGraphs[g], 1, 0);
+        BenchGraph *reused = bench_graph_create(kGraphs[g], 0, 0);
+        VCGraphInfo naiveInfo;
+        VCGraphInfo info;
+        vc_graph_get_info(naive->graph, &naiveInfo);
+        vc_graph_get_info(reused->graph, &info);
+
+        // 並ぶ枝の数まで補助スレッドを付ける（1 CPU では測らない）
+        int workers = info.maxParallel - 1 < cpus - 1 ? info.maxParallel - 1 : cpus - 1;
+        BenchGraph *parallel = workers > 0 ? bench_graph_create(kGraphs[g], 0, workers) : NULL;
+
+        printf("%s: %d nodes, %d tasks in %d levels (up to %d in parallel), latency %.0f samples\n", kGraphs[g],
+               info.nodeCount, info.taskCount, info.levelCount, info.maxParallel, vc_graph_latency(reused->graph));
+        printf("  buffers  per node %2d (%6zu bytes)  liveness %2d (%6zu bytes)\n", naiveInfo.bufferCount,
+               naiveInfo.bufferBytes, info.bufferCount, info.bufferBytes);
+        for (int b = 0; b < 3; b++) {
+            int blockSize = kBlockSizes[b];
+            double blockNs = (double)blockSize / kBenchSampleRate * 1e9;
+            double naiveNs = ns_per_block(naive, signal, work, total, blockSize);
+            double reusedNs = ns_per_block(reused, signal, work, total, blockSize);
+            printf("  block=%3d  per node %9.1f ns (%5.2f%%)  liveness %9.1f ns (%5.2f%%, %+5.1f%%)", blockSize,
+                   naiveNs, 100.0 * naiveNs / blockNs, reusedNs, 100.0 * reusedNs / blockNs,
+                   100.0 * (reusedNs - naiveNs) / naiveNs);
+            if (parallel != NULL) {
+                double parallelNs = ns_per_block(parallel, signal, work, total, blockSize);
+                printf("  %d worker(s) %9.1f ns (%+5.1f%%)", workers, parallelNs,
+                       100.0 * (parallelNs - reusedNs) / reusedNs);
+            }
+            printf("\n");
+        }
+        if (parallel == NULL) {
+            printf("  parallel: skipped (%d CPU, %d branch)\n", cpus, info.maxParallel);
+        }
+
+        bench_graph_destroy(naive);
+        bench_graph_destroy(reused);
+        bench_graph_destroy(parallel);
+    }
+
+    free(signal);
+    free(work);
+}
@@ -0,0 +1,103 @@
+//
+//  BenchLog.c
+//  VoiceChanger Benchmarks
+//
+//  RT-side cost of VCLogRing writes (ns/event) vs formatting on the calling thread
+//
+
+#include "BenchCommon.h"
+#include "VCCore.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define kEventCount     2000000
+#define kRingCapacity   4096
+
+typedef struct {
+    VCLogRing *ring;
+    atomic_int running;
+    uint64_t drained;
+    char line[256];
+} DrainContext;
+
+/// バックグラウンドで読み出して整形する（実運用の drain スレッド相当）
+static void *drain_main(void *arg) {
+    DrainContext *context = (DrainContext *)arg;
+    VCLogEvent event;
+    for (;;) {
+        int gotAny = 0;
+        while (vc_log_ring_read(context->ring, &event)) {
+            snprintf(context->line, sizeof(context->line), "event=%u level=%u frames=%.0f status=%.0f",
+                     event.eventId, event.level, event.args[0], event.args[1]);
+            context->drained++;
+            gotAny = 1;
+        }
+        if (!gotAny) {
+            if (!atomic_load(&context->running)) {
+                break;
+            }
+            struct timespec pause = { 0, 100000 };
+            nanosleep(&pause, NULL);
+        }
+    }
+    return NULL;
+}
+
+void bench_log(void) {
+    VCLogRing *ring = vc_log_ring_create(kRingCapacity);
+
+    // 1. リングへの書き込みのみ（drain スレッド並走、満杯時は破棄）
+    DrainContext context = { .ring = ring, .drained = 0 };
+    atomic_store(&context.running, 1);
+    pthread_t drainThread;
+    pthread_create(&drainThread, NULL, drain_main, &context);
+
+    uint64_t start = bench_now_ns();
+    for (int i = 0; i < kEventCount; i++) {
+        vc_log_ring_write(ring, 1, VCLogLevelDebug, 2, (double)i, -50.0, 0, 0);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    atomic_store(&context.running, 0);
+    pthread_join(drainThread, NULL);
+
+    uint64_t dropped = vc_log_ring_dropped(ring);
+    printf("ring write          %6.1f ns/event  drained=%llu dropped=%llu\n",
+           (double)elapsed / kEventCount,
+           (unsigned long long)context.drained,
+           (unsigned long long)dropped);
+
+    // 2. 1秒あたり数百イベント程度の現実的な頻度（満杯にならない）での書き込み
+    uint64_t writeTotal = 0;
+    int burstCount = 0;
+    for (int burst = 0; burst < 1000; burst++) {
+        uint64_t burstStart = bench_now_ns();
+        for (int i = 0; i < 64; i++) {
+            vc_log_ring_write(ring, 2, VCLogLevelWarning, 1, (double)i, 0, 0, 0);
+        }
+        writeTotal += bench_now_ns() - burstStart;
+        burstCount += 64;
+
+        VCLogEvent event;
+        while (vc_log_ring_read(ring, &event)) {
+        }
+    }
+    printf("ring write (burst)  %6.1f ns/event\n", (double)writeTotal / burstCount);
+
+    // 3. 比較: 呼び出しスレッドで文字列整形（従来の Logger 相当の下限）
+    char line[256];
+    int characters = 0;
+    start = bench_now_ns();
+    for (int i = 0; i < kEventCount / 10; i++) {
+        characters += snprintf(line, sizeof(line), "event=%u level=%u frames=%.0f status=%.0f", 1u, 0u, (double)i, -50.0);
+    }
+    elapsed = bench_now_ns() - start;
+    float sink = (float)characters;
+    bench_consume(&sink, 1);
+    printf("inline snprintf     %6.1f ns/event\n", (double)elapsed / (kEventCount / 10));
+
+    vc_log_ring_destroy(ring);
+}
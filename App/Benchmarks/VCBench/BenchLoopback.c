@@ -0,0 +1,260 @@
+//
+//  BenchLoopback.c
+//  VoiceChanger Benchmarks
+//
+//  Round-trip latency through both shared rings:
+//  App (256-frame blocks) → mic ring → "driver" IO (ReadInput + WriteMix)
+//  → speaker ring → App listening output (VCMonitor, 512-frame pulls)
+//
+//  各リングは shm_open した名前付き共有メモリを2回 mmap して、
+//  App とドライバーが別アドレスで同じページを見る状況を再現する
+//
+
+#include "BenchCommon.h"
+#include "VCCore.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+#define kLoopbackSeconds     4
+#define kAppFrames           256
+#define kDriverFrames        512
+#define kOutputFrames        512
+#define kRingCapacity        16384
+#define kMarkerIntervalBlocks 16
+#define kMaxMarkers          1024
+
+typedef struct {
+    void *memory;
+    size_t size;
+} BenchMapping;
+
+typedef struct {
+    VCSharedRing appMic;       // App が producer
+    VCSharedRing driverMic;    // ドライバーが consumer
+    VCSharedRing driverSpeaker; // ドライバーが producer
+    VCSharedRing appSpeaker;   // App が consumer
+    VCMonitor *listening;
+
+    uint64_t startNs;
+    uint64_t endNs;
+
+    uint64_t markerWriteNs[kMaxMarkers];
+    _Atomic int markersWritten;
+    double latencyUs[kMaxMarkers];
+    int markersFound;
+    uint64_t micUnderruns;
+} LoopbackContext;
+
+static int map_segment(const char *name, size_t size, int create, BenchMapping *out) {
+    int fd = shm_open(name, create ? (O_CREAT | O_RDWR) : O_RDWR, 0600);
+    if (fd < 0) {
+        return -1;
+    }
+    if (create && ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        return -1;
+    }
+    void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        return -1;
+    }
+    out->memory = memory;
+    out->size = size;
+    return 0;
+}
+
+/// 絶対時刻まで待つ（CLOCK_MONOTONIC）
+static void sleep_until(uint64_t deadlineNs) {
+    struct timespec ts = {
+        .tv_sec = (time_t)(deadlineNs / 1000000000ull),
+        .tv_nsec = (long)(deadlineNs % 1000000000ull),
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+    }
+}
+
+static uint64_t frames_to_ns(int frames) {
+    return (uint64_t)frames * 1000000000ull / kBenchSampleRate;
+}
+
+#pragma mark - Threads
+
+/// App 送話側: DSP 後のブロックを仮想マイクのリングへ
+static void *app_producer(void *arg) {
+    LoopbackContext *ctx = arg;
+    float block[kAppFrames];
+    uint64_t period = frames_to_ns(kAppFrames);
+    uint64_t deadline = ctx->startNs;
+
+    for (int n = 0; deadline < ctx->endNs; n++) {
+        sleep_until(deadline);
+        memset(block, 0, sizeof(block));
+
+        int marker = atomic_load_explicit(&ctx->markersWritten, memory_order_relaxed);
+        int isMarker = n % kMarkerIntervalBlocks == kMarkerIntervalBlocks / 2 && marker < kMaxMarkers;
+        if (isMarker) {
+            block[0] = 1.0f;
+            ctx->markerWriteNs[marker] = bench_now_ns();
+        }
+        vc_shared_ring_write(&ctx->appMic, block, kAppFrames);
+        if (isMarker) {
+            atomic_store_explicit(&ctx->markersWritten, marker + 1, memory_order_release);
+        }
+        deadline += period;
+    }
+    return NULL;
+}
+
+/// ドライバー側: 入力デバイスの ReadInput → 会議アプリがそのまま再生 → 出力デバイスの WriteMix
+static void *driver_io(void *arg) {
+    LoopbackContext *ctx = arg;
+    float ioBuffer[kDriverFrames];
+    uint64_t period = frames_to_ns(kDriverFrames);
+    // App とは位相をずらす
+    uint64_t deadline = ctx->startNs + period / 3;
+
+    while (deadline < ctx->endNs) {
+        sleep_until(deadline);
+
+        // Mic_ReadInput と同じゼロコピー読み出し（足りなければ消費せず無音）
+        VCRingRegions regions;
+        int granted = vc_shared_ring_read_regions(&ctx->driverMic, kDriverFrames, &regions);
+        if (granted < kDriverFrames) {
+            memset(ioBuffer, 0, sizeof(ioBuffer));
+            ctx->micUnderruns++;
+        } else {
+            memcpy(ioBuffer, regions.first, (size_t)regions.firstCount * sizeof(float));
+            if (regions.secondCount > 0) {
+                memcpy(ioBuffer + regions.firstCount, regions.second, (size_t)regions.secondCount * sizeof(float));
+            }
+            vc_shared_ring_commit_read(&ctx->driverMic, granted);
+        }
+
+        // Speaker_WriteMix
+        vc_shared_ring_write(&ctx->driverSpeaker, ioBuffer, kDriverFrames);
+        deadline += period;
+    }
+    return NULL;
+}
+
+/// App 受話側: ListeningOutput のレンダーコールバック相当
+static void *app_listening(void *arg) {
+    LoopbackContext *ctx = arg;
+    float output[kOutputFrames];
+    uint64_t period = frames_to_ns(kOutputFrames);
+    uint64_t deadline = ctx->startNs + period / 2;
+    float previous = 0;
+
+    while (deadline < ctx->endNs) {
+        sleep_until(deadline);
+        uint64_t pullNs = bench_now_ns();
+        vc_monitor_pull(ctx->listening, output, kOutputFrames);
+
+        int written = atomic_load_explicit(&ctx->markersWritten, memory_order_acquire);
+        for (int i = 0; i < kOutputFrames; i++) {
+            // 補間で2サンプルに分かれるので立ち上がりだけを見る
+            if (output[i] > 0.25f && previous <= 0.25f && ctx->markersFound < written) {
+                uint64_t playedNs = pullNs + frames_to_ns(i);
+                ctx->latencyUs[ctx->markersFound] = (double)(playedNs - ctx->markerWriteNs[ctx->markersFound]) / 1000.0;
+                ctx->markersFound++;
+            }
+            previous = output[i];
+        }
+        deadline += period;
+    }
+    return NULL;
+}
+
+#pragma mark - Bench
+
+void bench_loopback(void) {
+    char micName[64];
+    char speakerName[64];
+    snprintf(micName, sizeof(micName), "/vcbench.mic.%d", (int)getpid());
+    snprintf(speakerName, sizeof(speakerName), "/vcbench.speaker.%d", (int)getpid());
+
+    size_t size = vc_shared_ring_size(kRingCapacity);
+    BenchMapping appMic, driverMic, appSpeaker, driverSpeaker;
+    if (map_segment(micName, size, 1, &appMic) != 0 || map_segment(speakerName, size, 1, &appSpeaker) != 0) {
+        printf("shm_open failed; skipping\n");
+        shm_unlink(micName);
+        return;
+    }
+
+    LoopbackContext *ctx = calloc(1, sizeof(LoopbackContext));
+
+    // 両方とも App が作成し、ドライバーは後から接続する
+    vc_shared_ring_format(&ctx->appMic, appMic.memory, size, kBenchSampleRate, kAppFrames, kRingCapacity);
+    vc_shared_ring_format(&ctx->appSpeaker, appSpeaker.memory, size, kBenchSampleRate, kAppFrames, kRingCapacity);
+    map_segment(micName, size, 0, &driverMic);
+    map_segment(speakerName, size, 0, &driverSpeaker);
+    if (vc_shared_ring_attach(&ctx->driverMic, driverMic.memory, size) != 0 ||
+        vc_shared_ring_attach(&ctx->driverSpeaker, driverSpeaker.memory, size) != 0) {
+        printf("attach failed\n");
+        free(ctx);
+        return;
+    }
+    vc_shared_ring_set_active(&ctx->appMic, 1);
+    vc_shared_ring_set_active(&ctx->driverSpeaker, 1);
+
+    // 目標遅延: max(8ms, ドライバー周期 + 出力バッファ)
+    int target = kBenchSampleRate * 8 / 1000;
+    if (target < kDriverFrames + kOutputFrames) {
+        target = kDriverFrames + kOutputFrames;
+    }
+    ctx->listening = vc_monitor_create_attached(&ctx->appSpeaker, target);
+
+    ctx->startNs = bench_now_ns() + 20000000ull;
+    ctx->endNs = ctx->startNs + (uint64_t)kLoopbackSeconds * 1000000000ull;
+
+    pthread_t threads[3];
+    pthread_create(&threads[0], NULL, app_producer, ctx);
+    pthread_create(&threads[1], NULL, driver_io, ctx);
+    pthread_create(&threads[2], NULL, app_listening, ctx);
+    for (int i = 0; i < 3; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // 最初の数マーカーはプライミング中なので除く
+    int skip = ctx->markersFound > 4 ? 4 : 0;
+    double minUs = 1e30, maxUs = 0, sumUs = 0;
+    for (int i = skip; i < ctx->markersFound; i++) {
+        double us = ctx->latencyUs[i];
+        minUs = us < minUs ? us : minUs;
+        maxUs = us > maxUs ? us : maxUs;
+        sumUs += us;
+    }
+    int measured = ctx->markersFound - skip;
+
+    VCMonitorStats stats;
+    vc_monitor_get_stats(ctx->listening, &stats);
+
+    if (measured > 0) {
+        double meanUs = sumUs / measured;
+        printf("round trip (%d/%d markers)  min %.0f us  mean %.0f us (%.0f frames)  max %.0f us\n",
+               measured, atomic_load(&ctx->markersWritten), minUs, meanUs,
+               meanUs * kBenchSampleRate / 1e6, maxUs);
+    } else {
+        printf("no markers received\n");
+    }
+    printf("app %d + driver %d + listening target %d frames  mic underruns %llu  listening underruns %llu\n",
+           kAppFrames, kDriverFrames, target,
+           (unsigned long long)ctx->micUnderruns, (unsigned long long)stats.underruns);
+
+    vc_monitor_destroy(ctx->listening);
+    munmap(appMic.memory, size);
+    munmap(driverMic.memory, size);
+    munmap(appSpeaker.memory, size);
+    munmap(driverSpeaker.memory, size);
+    shm_unlink(micName);
+    shm_unlink(speakerName);
+    free(ctx);
+}
@@ -0,0 +1,62 @@
+//
+//  BenchMeter.c
+//  VoiceChanger Benchmarks
+//
+//  Per-block metering cost (peak / RMS / K-weighted loudness + triple-buffer publish)
+//
+
+#include "BenchCommon.h"
+#include "VCCore.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define kAudioSeconds 20
+
+/// 従来の updateStats 相当（スカラーの二乗和のみ）
+static float naive_rms(const float *samples, int count) {
+    float sum = 0;
+    for (int i = 0; i < count; i++) {
+        sum += samples[i] * samples[i];
+    }
+    return sqrtf(sum / (float)count);
+}
+
+void bench_meter(void) {
+    int total = kAudioSeconds * kBenchSampleRate;
+    float *signal = malloc((size_t)total * sizeof(float));
+    bench_fill_voice(signal, total, kBenchSampleRate, 140.0f, 7);
+
+    static const int kBlockSizes[] = { 128, 256, 512 };
+    for (int s = 0; s < 3; s++) {
+        int blockSize = kBlockSizes[s];
+        int blocks = total / blockSize;
+
+        VCMeter *meter = vc_meter_create(kBenchSampleRate);
+        VCMeterReading reading;
+
+        uint64_t start = bench_now_ns();
+        for (int b = 0; b < blocks; b++) {
+            vc_meter_process(meter, signal + (size_t)b * blockSize, blockSize);
+        }
+        uint64_t meterElapsed = bench_now_ns() - start;
+        vc_meter_read(meter, &reading);
+
+        float sink = 0;
+        start = bench_now_ns();
+        for (int b = 0; b < blocks; b++) {
+            sink += naive_rms(signal + (size_t)b * blockSize, blockSize);
+        }
+        uint64_t naiveElapsed = bench_now_ns() - start;
+        bench_consume(&sink, 1);
+
+        double blockUs = (double)blockSize / kBenchSampleRate * 1e6;
+        double meterNs = (double)meterElapsed / blocks;
+        printf("block=%-4d meter %7.1f ns/block (%.3f%% of block time)  naive rms %7.1f ns/block  S=%.1f LUFS\n",
+               blockSize, meterNs, meterNs / (blockUs * 10.0), (double)naiveElapsed / blocks, reading.shortTermLufs);
+
+        vc_meter_destroy(meter);
+    }
+
+    free(signal);
+}
@@ -0,0 +1,69 @@
+//
+//  BenchMultiband.c
+//  VoiceChanger Benchmarks
+//
+//  Multiband compressor / de-esser: cost per block, and the chain with the stage on and off
+//
+
+#include "BenchCommon.h"
+#include "VCCore.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define kAudioSeconds   10
+
+static double multiband_ns_per_block(const float *signal, float *work, int total, int blockSize) {
+    VCMultiband *multiband = vc_multiband_create(kBenchSampleRate);
+    int blocks = total / blockSize;
+    for (int i = 0; i < total; i++) {
+        work[i] = signal[i];
+    }
+    uint64_t start = bench_now_ns();
+    for (int b = 0; b < blocks; b++) {
+        vc_multiband_process(multiband, work + (size_t)b * blockSize, blockSize);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_consume(work, total);
+    vc_multiband_destroy(multiband);
+    return (double)elapsed / blocks;
+}
+
+static double chain_ns_per_block(const float *signal, float *work, int total, int blockSize, int multibandEnabled) {
+    VCChain *chain = vc_chain_create(kBenchSampleRate);
+    VCChainParams params;
+    vc_chain_params_default(&params);
+    params.multibandEnabled = multibandEnabled;
+    vc_chain_set_params(chain, &params);
+    int blocks = total / blockSize;
+    uint64_t start = bench_now_ns();
+    for (int b = 0; b < blocks; b++) {
+        size_t offset = (size_t)b * blockSize;
+        vc_chain_process(chain, signal + offset, work + offset, blockSize);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_consume(work, total);
+    vc_chain_destroy(chain);
+    return (double)elapsed / blocks;
+}
+
+void bench_multiband(void) {
+    static const int kBlockSizes[] = { 128, 256, 512 };
+    int total = kAudioSeconds * kBenchSampleRate;
+    float *signal = malloc((size_t)total * sizeof(float));
+    float *work = malloc((size_t)total * sizeof(float));
+    bench_fill_voice(signal, total, kBenchSampleRate, 140.0f, 11);
+
+    for (int i = 0; i < (int)(sizeof(kBlockSizes) / sizeof(kBlockSizes[0])); i++) {
+        int blockSize = kBlockSizes[i];
+        double blockUs = (double)blockSize / kBenchSampleRate * 1e6;
+        double multibandNs = multiband_ns_per_block(signal, work, total, blockSize);
+        double offNs = chain_ns_per_block(signal, work, total, blockSize, 0);
+        double onNs = chain_ns_per_block(signal, work, total, blockSize, 1);
+        printf("block=%3d  multiband %7.1f ns/block (%5.2f%%)  chain off %8.1f ns (%5.2f%%)  on %8.1f ns (%5.2f%%)\n",
+               blockSize, multibandNs, multibandNs / (blockUs * 10.0),
+               offNs, offNs / (blockUs * 10.0), onNs, onNs / (blockUs * 10.0));
+    }
+
+    free(signal);
+    free(work);
+}
@@ -0,0 +1,115 @@
+//
+//  BenchOversampling.c
+//  VoiceChanger Benchmarks
+//
+//  Half-band oversampling: round-trip cost per factor and block size, the limiter run oversampled,
+//  and aliasing of a tanh saturator on swept sines
+//
+
+#include "BenchCommon.h"
+#include "VCCore.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define kAudioSeconds   10
+#define kFftSize        4096
+
+/// 往復（upsample → downsample）のみ、または間にリミッターを挟んだときの 1 ブロックあたりのコスト
+static double round_trip_ns_per_block(int factor, const float *signal, float *work, int total, int blockSize,
+                                      int withLimiter) {
+    VCOversampler *oversampler = vc_oversampler_create(factor, blockSize);
+    VCLimiter limiter;
+    vc_limiter_init(&limiter);
+    vc_limiter_set_oversampling(&limiter, factor);
+    int blocks = total / blockSize;
+    uint64_t start = bench_now_ns();
+    for (int b = 0; b < blocks; b++) {
+        size_t offset = (size_t)b * blockSize;
+        float *upsampled = vc_oversampler_upsample(oversampler, signal + offset, blockSize);
+        if (withLimiter) {
+            vc_limiter_process(&limiter, upsampled, blockSize * factor);
+        }
+        vc_oversampler_downsample(oversampler, work + offset, blockSize);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_consume(work, blocks * blockSize);
+    vc_oversampler_destroy(oversampler);
+    return (double)elapsed / blocks;
+}
+
+/// tanh(4x) で歪ませた正弦波（FFT のビンに一致）の、高調波以外に入った電力の割合（dB）
+static double aliasing_db(int factor, int bin, VCFFTPlan *plan) {
+    float *input = malloc(2 * kFftSize * sizeof(float));
+    float *output = malloc(2 * kFftSize * sizeof(float));
+    float *re = malloc((kFftSize / 2 + 1) * sizeof(float));
+    float *im = malloc((kFftSize / 2 + 1) * sizeof(float));
+    float *power = malloc((kFftSize / 2 + 1) * sizeof(float));
+
+    VCOversampler *oversampler = vc_oversampler_create(factor, 512);
+    double omega = 2.0 * M_PI * bin / kFftSize;
+    for (int i = 0; i < 2 * kFftSize; i++) {
+        input[i] = 0.8f * (float)sin(omega * i);
+    }
+    for (int offset = 0; offset < 2 * kFftSize; offset += 512) {
+        float *upsampled = vc_oversampler_upsample(oversampler, input + offset, 512);
+        for (int i = 0; i < 512 * factor; i++) {
+            upsampled[i] = tanhf(4.0f * upsampled[i]);
+        }
+        vc_oversampler_downsample(oversampler, output + offset, 512);
+    }
+    vc_oversampler_destroy(oversampler);
+
+    // 後半（フィルタの立ち上がりを除いた区間）を解析
+    vc_fft_forward(plan, output + kFftSize, re, im);
+    vc_complex_power(re, im, power, kFftSize / 2 + 1);
+    double total = 0, aliased = 0;
+    for (int k = 1; k <= kFftSize / 2; k++) {
+        total += power[k];
+        if (k % bin != 0) {
+            aliased += power[k];
+        }
+    }
+
+    free(input);
+    free(output);
+    free(re);
+    free(im);
+    free(power);
+    return 10.0 * log10(aliased / total);
+}
+
+void bench_oversampling(void) {
+    static const int kFactors[] = { 1, 2, 4 };
+    static const int kBlockSizes[] = { 128, 256, 512 };
+    int total = kAudioSeconds * kBenchSampleRate;
+    float *signal = malloc((size_t)total * sizeof(float));
+    float *work = malloc((size_t)total * sizeof(float));
+    bench_fill_voice(signal, total, kBenchSampleRate, 140.0f, 13);
+
+    for (int f = 0; f < 3; f++) {
+        VCOversampler *oversampler = vc_oversampler_create(kFactors[f], 128);
+        printf("factor %d (latency %.1f samples)\n", kFactors[f], vc_oversampler_latency(oversampler));
+        vc_oversampler_destroy(oversampler);
+        for (int b = 0; b < 3; b++) {
+            int blockSize = kBlockSizes[b];
+            double blockUs = (double)blockSize / kBenchSampleRate * 1e6;
+            double roundTripNs = round_trip_ns_per_block(kFactors[f], signal, work, total, blockSize, 0);
+            double limiterNs = round_trip_ns_per_block(kFactors[f], signal, work, total, blockSize, 1);
+            printf("  block=%3d  up + down %8.1f ns/block (%5.2f%%)  with limiter %8.1f ns/block (%5.2f%%)\n",
+                   blockSize, roundTripNs, roundTripNs / (blockUs * 10.0), limiterNs, limiterNs / (blockUs * 10.0));
+        }
+    }
+
+    // 正弦波の周波数を変えながら tanh の折り返しを測る
+    VCFFTPlan *plan = vc_fft_plan_create(kFftSize);
+    printf("aliasing of tanh(4x), 0.8 amplitude sine (dB of total power)\n");
+    for (int bin = 40; bin <= 640; bin += 60) {
+        printf("  %5.0f Hz  1x %6.1f  2x %6.1f  4x %6.1f\n", bin * (double)kBenchSampleRate / kFftSize,
+               aliasing_db(1, bin, plan), aliasing_db(2, bin, plan), aliasing_db(4, bin, plan));
+    }
+    vc_fft_plan_destroy(plan);
+
+    free(signal);
+    free(work);
+}
@@ -0,0 +1,128 @@
+//
+//  BenchPitch.c
+//  VoiceChanger Benchmarks
+//
+//  Pitch tracker: accuracy on synthetic voiced signals and per-block cost
+//
+
+#include "BenchCommon.h"
+#include "VCCore.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define kAudioSeconds   4
+#define kGrossCents     50.0    // 半音の半分を超えたら誤検出（オクターブ誤り等）
+
+/// 声門パルス列に近い倍音構成（1/h）+ ビブラート ±2% + 背景雑音
+/// 各サンプルの真の f0 を truth に書く
+static void fill_voiced(float *samples, float *truth, int count, float f0, int harmonics, uint32_t seed) {
+    bench_fill_noise(samples, count, 0.003f, &seed);
+    double phase = 0;
+    for (int i = 0; i < count; i++) {
+        double freq = f0 * (1.0 + 0.02 * sin(2.0 * M_PI * 5.0 * i / kBenchSampleRate));
+        phase += 2.0 * M_PI * freq / kBenchSampleRate;
+        float s = 0;
+        for (int h = 1; h <= harmonics; h++) {
+            if (freq * h < kBenchSampleRate / 2) {
+                s += (float)(sin(phase * h) / h);
+            }
+        }
+        samples[i] += 0.2f * s;
+        truth[i] = (float)freq;
+    }
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+void bench_pitch(void) {
+    int total = kAudioSeconds * kBenchSampleRate;
+    float *signal = malloc((size_t)total * sizeof(float));
+    float *truth = malloc((size_t)total * sizeof(float));
+    double *errors = malloc((size_t)total * sizeof(double));
+
+    // 低い男声〜高い女声・子供、倍音の少ない（フィルタされた）声も
+    static const float kPitches[] = { 85.0f, 120.0f, 180.0f, 260.0f, 400.0f, 600.0f };
+    static const int kHarmonics[] = { 12, 3 };
+    const int blockSize = 128;
+
+    VCPitchTracker *probe = vc_pitch_create(kBenchSampleRate, VC_PITCH_DEFAULT_MIN_HZ, VC_PITCH_DEFAULT_MAX_HZ);
+    int latency = vc_pitch_latency(probe);
+    vc_pitch_destroy(probe);
+    printf("latency %d frames (%.1f ms)\n", latency, latency * 1000.0 / kBenchSampleRate);
+
+    for (int h = 0; h < 2; h++) {
+        for (int p = 0; p < (int)(sizeof(kPitches) / sizeof(kPitches[0])); p++) {
+            fill_voiced(signal, truth, total, kPitches[p], kHarmonics[h], 17 + p);
+            VCPitchTracker *tracker = vc_pitch_create(kBenchSampleRate, VC_PITCH_DEFAULT_MIN_HZ,
+                                                      VC_PITCH_DEFAULT_MAX_HZ);
+
+            int measured = 0, gross = 0, unvoiced = 0;
+            double confidence = 0;
+            for (int b = 0; b + blockSize <= total; b += blockSize) {
+                VCPitchEstimate estimate;
+                vc_pitch_process(tracker, signal + b, blockSize, 1, &estimate);
+                if (b < kBenchSampleRate / 10) {
+                    continue;   // 窓が埋まるまで
+                }
+                // 推定は窓の中心時刻のもの
+                int center = b + blockSize - latency;
+                if (!estimate.voiced) {
+                    unvoiced++;
+                    continue;
+                }
+                double cents = 1200.0 * log2(estimate.f0Hz / truth[center]);
+                if (fabs(cents) > kGrossCents) {
+                    gross++;
+                } else {
+                    errors[measured++] = fabs(cents);
+                }
+                confidence += estimate.confidence;
+            }
+            qsort(errors, (size_t)measured, sizeof(double), compare_doubles);
+            int voicedBlocks = measured + gross;
+            printf("f0=%5.0f Hz harmonics=%-2d  median error %5.2f cents  p95 %5.2f cents  "
+                   "gross %4.1f%%  unvoiced %4.1f%%  confidence %.2f\n",
+                   kPitches[p], kHarmonics[h], measured ? errors[measured / 2] : 0.0,
+                   measured ? errors[measured * 95 / 100] : 0.0,
+                   100.0 * gross / (voicedBlocks + unvoiced), 100.0 * unvoiced / (voicedBlocks + unvoiced),
+                   voicedBlocks ? confidence / voicedBlocks : 0.0);
+            vc_pitch_destroy(tracker);
+        }
+    }
+
+    // コスト（探索あり / 履歴更新のみ）
+    fill_voiced(signal, truth, total, 150.0f, 12, 3);
+    static const int kBlockSizes[] = { 128, 256, 512 };
+    for (int s = 0; s < 3; s++) {
+        int size = kBlockSizes[s];
+        int blocks = total / size;
+        double blockUs = (double)size / kBenchSampleRate * 1e6;
+        double costs[2];
+        for (int search = 1; search >= 0; search--) {
+            VCPitchTracker *tracker = vc_pitch_create(kBenchSampleRate, VC_PITCH_DEFAULT_MIN_HZ,
+                                                      VC_PITCH_DEFAULT_MAX_HZ);
+            VCPitchEstimate estimate = { 0 };
+            uint64_t start = bench_now_ns();
+            for (int b = 0; b < blocks; b++) {
+                vc_pitch_process(tracker, signal + (size_t)b * size, size, search, &estimate);
+            }
+            costs[search] = (double)(bench_now_ns() - start) / blocks;
+            bench_consume(&estimate.f0Hz, 1);
+            vc_pitch_destroy(tracker);
+        }
+        printf("block=%-4d %7.1f ns/block (%.2f%% of block time), history only %7.1f ns/block\n",
+               size, costs[1], costs[1] / (blockUs * 10.0), costs[0]);
+    }
+
+    free(signal);
+    free(truth);
+    free(errors);
+}
@@ -0,0 +1,114 @@
+//
+//  BenchPresetBank.c
+//  VoiceChanger Benchmarks
+//
+//  Binary preset bank: writing, opening (map + validate + decode) and id lookup for 1,000 presets,
+//  and how long the file watcher takes to hand over a rewritten bank
+//
+
+#include "BenchCommon.h"
+#include "VCCore.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define kPresetCount    1000
+#define kOpenRuns       50
+#define kBankPath       "/tmp/vcbench-presets.vcpb"
+#define kPollMs         5
+
+static char sIds[kPresetCount][32];
+static char sNames[kPresetCount][48];
+
+static void fill_entries(VCPresetEntry *entries, float pitchOffset) {
+    for (int i = 0; i < kPresetCount; i++) {
+        snprintf(sIds[i], sizeof(sIds[i]), "user_preset_%04d", i);
+        snprintf(sNames[i], sizeof(sNames[i]), "User Preset %d", i);
+        entries[i].id = sIds[i];
+        entries[i].name = sNames[i];
+        entries[i].impulseResponse = i % 4 == 0 ? "hall" : NULL;
+        vc_chain_params_default(&entries[i].params);
+        entries[i].params.pitchShift = (float)(i % 25 - 12) + pitchOffset;
+        entries[i].params.eqHigh = (float)(i % 7);
+        entries[i].params.convolutionMix = i % 4 == 0 ? 0.3f : 0.0f;
+    }
+}
+
+static _Atomic uint64_t sReloadedAt;
+
+static void on_reload(void *context) {
+    (void)context;
+    atomic_store(&sReloadedAt, bench_now_ns());
+}
+
+void bench_preset_bank(void) {
+    VCPresetEntry *entries = malloc(kPresetCount * sizeof(VCPresetEntry));
+    fill_entries(entries, 0);
+
+    uint64_t start = bench_now_ns();
+    if (vc_preset_bank_write(kBankPath, entries, kPresetCount) != 0) {
+        printf("failed to write %s\n", kBankPath);
+        free(entries);
+        return;
+    }
+    uint64_t written = bench_now_ns();
+    FILE *file = fopen(kBankPath, "rb");
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    printf("%d presets: %ld bytes, write %.1f us\n", kPresetCount, size, (double)(written - start) / 1e3);
+
+    // 開く（mmap → 全体の検証 → VCChainParams への変換）
+    uint64_t best = UINT64_MAX, sum = 0;
+    for (int run = 0; run < kOpenRuns; run++) {
+        uint64_t t0 = bench_now_ns();
+        VCPresetBank *bank = vc_preset_bank_open(kBankPath);
+        uint64_t elapsed = bench_now_ns() - t0;
+        vc_preset_bank_close(bank);
+        sum += elapsed;
+        best = elapsed < best ? elapsed : best;
+    }
+    printf("open + validate + decode: mean %.1f us, best %.1f us\n", (double)sum / kOpenRuns / 1e3, (double)best / 1e3);
+
+    // 全 id を引く
+    VCPresetBank *bank = vc_preset_bank_open(kBankPath);
+    int found = 0;
+    uint64_t t0 = bench_now_ns();
+    for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < kPresetCount; i++) {
+            found += vc_preset_bank_find(bank, sIds[i]) == i;
+        }
+    }
+    uint64_t lookup = bench_now_ns() - t0;
+    VCPresetEntry entry;
+    vc_preset_bank_get(bank, vc_preset_bank_find(bank, "user_preset_0500"), &entry);
+    printf("lookup by id: %.1f ns (%d/%d found)\n", (double)lookup / (100.0 * kPresetCount), found / 100, kPresetCount);
+    vc_preset_bank_close(bank);
+
+    // 書き換えてから監視スレッドが検証済みのバンクを渡すまで
+    VCPresetBankWatcher *watcher = vc_preset_bank_watcher_create(kBankPath, kPollMs, on_reload, NULL);
+    usleep(20000);
+    fill_entries(entries, 1.0f);
+    atomic_store(&sReloadedAt, 0);
+    uint64_t rewrite = bench_now_ns();
+    vc_preset_bank_write(kBankPath, entries, kPresetCount);
+    for (int i = 0; i < 500 && atomic_load(&sReloadedAt) == 0; i++) {
+        usleep(1000);
+    }
+    VCPresetBank *reloaded = vc_preset_bank_watcher_take(watcher);
+    uint64_t reloadedAt = atomic_load(&sReloadedAt);
+    if (reloaded != NULL && reloadedAt != 0) {
+        vc_preset_bank_get(reloaded, vc_preset_bank_find(reloaded, "user_preset_0500"), &entry);
+        printf("hot reload (poll %d ms): %.2f ms after rewrite, pitch %.0f -> %.0f\n", kPollMs,
+               (double)(reloadedAt - rewrite) / 1e6, entries[500].params.pitchShift - 1.0f, entry.params.pitchShift);
+    } else {
+        printf("hot reload: not observed\n");
+    }
+    vc_preset_bank_close(reloaded);
+    vc_preset_bank_watcher_destroy(watcher);
+
+    remove(kBankPath);
+    free(entries);
+}
@@ -0,0 +1,288 @@
+//
+//  BenchReattach.c
+//  VoiceChanger Benchmarks
+//
+//  Crash recovery of the App -> Driver shared ring: the producer process is
+//  SIGKILLed and relaunched, and the "driver" (this process) detects it via
+//  the heartbeat / generation and resumes
+//
+//  子プロセスが App（producer）として SharedMemorySegment.create と同じ手順で区画を作り、
+//  親プロセスがドライバーの Mic_ReadInput と同じ監視をしながら 1ms ごとに読む
+//
+
+#include "BenchCommon.h"
+#include "VCCore.h"
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define kAppFrames          256
+#define kDriverFrames       48          // 1ms
+#define kRingCapacity       16384
+#define kHeartbeatTimeoutNs 15000000ull // VirtualMicDriver.h の kHeartbeatTimeoutMs
+#define kTrials             5
+#define kSteadyMs           100         // 再起動後に安定させる時間
+#define kGiveUpMs           2000
+
+typedef enum {
+    ProducerMode_Reclaim,   // 通常の再起動（同じレイアウトを引き継ぐ）
+    ProducerMode_Format,    // レイアウトを作り直す（別バージョンの App など）
+} ProducerMode;
+
+typedef struct {
+    void *memory;
+    size_t size;
+    VCSharedRing ring;
+    VCSharedRingWatch watch;
+    int remaps;
+} BenchDriverView;
+
+/// 絶対時刻まで待つ（CLOCK_MONOTONIC）
+static void sleep_until(uint64_t deadlineNs) {
+    struct timespec ts = {
+        .tv_sec = (time_t)(deadlineNs / 1000000000ull),
+        .tv_nsec = (long)(deadlineNs % 1000000000ull),
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+    }
+}
+
+static uint64_t frames_to_ns(int frames) {
+    return (uint64_t)frames * 1000000000ull / kBenchSampleRate;
+}
+
+#pragma mark - Producer (child)
+
+/// App 側: 区画を作成または引き継ぎ、リアルタイムの速さで書き続ける（kill されるまで）
+static void run_producer(const char *name, ProducerMode mode) {
+    size_t required = vc_shared_ring_size(kRingCapacity);
+    int fd = shm_open(name, O_CREAT | O_RDWR, 0600);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        _exit(1);
+    }
+    if ((size_t)info.st_size < required && ftruncate(fd, (off_t)required) != 0) {
+        _exit(1);
+    }
+    size_t size = (size_t)info.st_size > required ? (size_t)info.st_size : required;
+    void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        _exit(1);
+    }
+
+    VCSharedRing ring;
+    int result = mode == ProducerMode_Reclaim
+        ? vc_shared_ring_reclaim(&ring, memory, size, kBenchSampleRate, kAppFrames, kRingCapacity)
+        : vc_shared_ring_format(&ring, memory, size, kBenchSampleRate, kAppFrames, kRingCapacity);
+    if (result < 0) {
+        _exit(1);
+    }
+    vc_shared_ring_set_active(&ring, 1);
+
+    float block[kAppFrames];
+    for (int i = 0; i < kAppFrames; i++) {
+        block[i] = 1.0f;
+    }
+    uint64_t period = frames_to_ns(kAppFrames);
+    uint64_t deadline = bench_now_ns();
+    for (;;) {
+        vc_shared_ring_write(&ring, block, kAppFrames);
+        deadline += period;
+        sleep_until(deadline);
+    }
+}
+
+static pid_t spawn_producer(const char *name, ProducerMode mode) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        run_producer(name, mode);
+        _exit(0);
+    }
+    return pid;
+}
+
+static void kill_producer(pid_t pid) {
+    kill(pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+}
+
+#pragma mark - Driver (parent)
+
+static void driver_unmap(BenchDriverView *view) {
+    if (view->memory != NULL) {
+        munmap(view->memory, view->size);
+        view->memory = NULL;
+    }
+}
+
+/// ドライバーの SharedMemory_Open 相当（保守スレッドの仕事をここでは同じスレッドで行う）
+static int driver_map(BenchDriverView *view, const char *name) {
+    int fd = shm_open(name, O_RDWR, 0600);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < VC_SHARED_RING_HEADER_SIZE) {
+        close(fd);
+        return -1;
+    }
+    void *memory = mmap(NULL, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        return -1;
+    }
+    if (vc_shared_ring_attach(&view->ring, memory, (size_t)info.st_size) != 0) {
+        munmap(memory, (size_t)info.st_size);
+        return -1;
+    }
+    view->memory = memory;
+    view->size = (size_t)info.st_size;
+    vc_shared_ring_watch_init(&view->watch, &view->ring, bench_now_ns(), kHeartbeatTimeoutNs);
+    return 0;
+}
+
+/// 1 IO 周期分（Mic_ReadInput と同じ判定）
+/// - Returns: 1 = 音声を読めた、0 = 無音、-1 = 停止を検出、-2 = 作り直しを検出
+static int driver_cycle(BenchDriverView *view, const char *name, float *buffer) {
+    if (view->memory == NULL && driver_map(view, name) != 0) {
+        return 0;
+    }
+
+    VCSharedRingPeer peer = vc_shared_ring_watch_check(&view->watch, &view->ring, bench_now_ns());
+    if (peer == VC_SHARED_RING_PEER_REPLACED) {
+        driver_unmap(view);
+        view->remaps++;
+        return -2;
+    }
+    if (!vc_shared_ring_is_active(&view->ring)) {
+        return 0;
+    }
+    if (vc_shared_ring_available_read(&view->ring) < kDriverFrames) {
+        return peer == VC_SHARED_RING_PEER_STALLED ? -1 : 0;
+    }
+    vc_shared_ring_read(&view->ring, buffer, kDriverFrames);
+    return buffer[0] != 0.0f;
+}
+
+/// 結果が条件を満たすまで IO 周期を回し、かかった時間を返す（ns、諦めたら UINT64_MAX）
+static uint64_t driver_run_until(BenchDriverView *view, const char *name, int (*done)(int), uint64_t startNs) {
+    float buffer[kDriverFrames];
+    uint64_t period = frames_to_ns(kDriverFrames);
+    uint64_t deadline = bench_now_ns();
+    uint64_t giveUp = startNs + (uint64_t)kGiveUpMs * 1000000ull;
+
+    while (deadline < giveUp) {
+        if (done(driver_cycle(view, name, buffer))) {
+            return bench_now_ns() - startNs;
+        }
+        deadline += period;
+        sleep_until(deadline);
+    }
+    return UINT64_MAX;
+}
+
+static int is_audio(int result) { return result == 1; }
+static int is_peer_lost(int result) { return result < 0; }
+
+static void driver_settle(BenchDriverView *view, const char *name) {
+    float buffer[kDriverFrames];
+    uint64_t period = frames_to_ns(kDriverFrames);
+    uint64_t deadline = bench_now_ns();
+    uint64_t end = deadline + (uint64_t)kSteadyMs * 1000000ull;
+    while (deadline < end) {
+        driver_cycle(view, name, buffer);
+        deadline += period;
+        sleep_until(deadline);
+    }
+}
+
+#pragma mark - Scenario
+
+typedef struct {
+    double detectMs[kTrials];
+    double recoverMs[kTrials];
+    int remaps;
+    int failures;
+} ReattachResult;
+
+static void run_scenario(const char *name, ProducerMode relaunchMode, ReattachResult *out) {
+    memset(out, 0, sizeof(*out));
+    BenchDriverView view = { 0 };
+
+    pid_t producer = spawn_producer(name, ProducerMode_Reclaim);
+    if (driver_run_until(&view, name, is_audio, bench_now_ns()) == UINT64_MAX) {
+        kill_producer(producer);
+        out->failures = kTrials;
+        return;
+    }
+    driver_settle(&view, name);
+    int baseRemaps = view.remaps;
+
+    for (int trial = 0; trial < kTrials; trial++) {
+        // App が落ちる
+        uint64_t killNs = bench_now_ns();
+        kill_producer(producer);
+        uint64_t detect = driver_run_until(&view, name, is_peer_lost, killNs);
+        if (detect == UINT64_MAX) {
+            out->failures++;
+        }
+
+        // App を再起動し、ドライバーが音声を読めるようになるまで
+        uint64_t spawnNs = bench_now_ns();
+        producer = spawn_producer(name, relaunchMode);
+        uint64_t recover = driver_run_until(&view, name, is_audio, spawnNs);
+        if (recover == UINT64_MAX) {
+            out->failures++;
+        }
+
+        out->detectMs[trial] = detect == UINT64_MAX ? -1.0 : (double)detect / 1e6;
+        out->recoverMs[trial] = recover == UINT64_MAX ? -1.0 : (double)recover / 1e6;
+        driver_settle(&view, name);
+    }
+
+    out->remaps = view.remaps - baseRemaps;
+    kill_producer(producer);
+    driver_unmap(&view);
+}
+
+static void print_result(const char *label, const ReattachResult *result) {
+    double detectSum = 0, detectMax = 0, recoverSum = 0, recoverMax = 0;
+    for (int i = 0; i < kTrials; i++) {
+        detectSum += result->detectMs[i];
+        recoverSum += result->recoverMs[i];
+        if (result->detectMs[i] > detectMax) detectMax = result->detectMs[i];
+        if (result->recoverMs[i] > recoverMax) recoverMax = result->recoverMs[i];
+    }
+    printf("%-8s  detect %6.2f ms (max %6.2f)  recover %6.2f ms (max %6.2f)  remaps %d/%d  %s\n",
+           label, detectSum / kTrials, detectMax, recoverSum / kTrials, recoverMax,
+           result->remaps, kTrials, result->failures == 0 ? "ok" : "FAILED");
+}
+
+void bench_reattach(void) {
+    char name[64];
+    snprintf(name, sizeof(name), "/vcbench.reattach.%d", (int)getpid());
+    shm_unlink(name);
+
+    printf("heartbeat timeout %.0f ms, driver IO %d frames, app block %d frames, %d trials\n",
+           (double)kHeartbeatTimeoutNs / 1e6, kDriverFrames, kAppFrames, kTrials);
+
+    // 通常の再起動: 引き継ぐので張り替えなし（detect = 停止の検出、recover = 起動から音声の再開まで）
+    ReattachResult reclaim;
+    run_scenario(name, ProducerMode_Reclaim, &reclaim);
+    print_result("reclaim", &reclaim);
+
+    // レイアウトを作り直す再起動: 世代の変化で張り替える（recover に張り替えを含む）
+    ReattachResult format;
+    run_scenario(name, ProducerMode_Format, &format);
+    print_result("format", &format);
+
+    shm_unlink(name);
+}
@@ -0,0 +1,134 @@
+//
+//  BenchSignalGuard.c
+//  VoiceChanger Benchmarks
+//
+//  Signal guard: chain CPU time on digital silence after speech with the guard off / on,
+//  scan throughput against a scalar isfinite/fpclassify loop, and recovery from a NaN block
+//
+
+#include "BenchCommon.h"
+#include "VCCore.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define kBlockSize          256
+#define kSpeechSeconds      1       // 状態を揺らしてから
+#define kSilentSeconds      4       // 完全な 0（ミュートしたマイク）を流して減衰させる
+#define kScanValues         4096
+#define kScanRepeats        2000
+
+typedef struct {
+    double averageNs;
+    double worstNs;
+    double firstSecondNs;           // 無音に入って最初の 1 秒（減衰が非正規化数の範囲を通る区間）
+} SilentCost;
+
+static SilentCost measure_silence(int guard, int multiband) {
+    VCChain *chain = vc_chain_create(kBenchSampleRate);
+    vc_chain_set_signal_guard(chain, guard);
+    VCChainParams params;
+    vc_chain_params_default(&params);
+    params.multibandEnabled = multiband;
+    params.eqLow = 3;
+    params.eqHigh = -2;
+    vc_chain_set_params(chain, &params);
+
+    int speechFrames = kSpeechSeconds * kBenchSampleRate;
+    float *speech = malloc((size_t)speechFrames * sizeof(float));
+    bench_fill_voice(speech, speechFrames, kBenchSampleRate, 140.0f, 7);
+    float block[kBlockSize];
+    for (int offset = 0; offset + kBlockSize <= speechFrames; offset += kBlockSize) {
+        vc_chain_process(chain, speech + offset, block, kBlockSize);
+    }
+
+    SilentCost cost = { 0, 0, 0 };
+    int blocks = kSilentSeconds * kBenchSampleRate / kBlockSize;
+    int firstSecond = kBenchSampleRate / kBlockSize;
+    double total = 0, first = 0;
+    for (int b = 0; b < blocks; b++) {
+        for (int i = 0; i < kBlockSize; i++) {
+            block[i] = 0.0f;
+        }
+        uint64_t start = bench_now_ns();
+        vc_chain_process(chain, block, block, kBlockSize);
+        double elapsed = (double)(bench_now_ns() - start);
+        bench_consume(block, kBlockSize);
+        total += elapsed;
+        first += b < firstSecond ? elapsed : 0;
+        cost.worstNs = fmax(cost.worstNs, elapsed);
+    }
+    cost.averageNs = total / blocks;
+    cost.firstSecondNs = first / firstSecond;
+
+    free(speech);
+    vc_chain_destroy(chain);
+    return cost;
+}
+
+static int scalar_scan(const float *samples, int count) {
+    int flags = 0;
+    for (int i = 0; i < count; i++) {
+        if (isnan(samples[i])) {
+            flags |= VC_SIGNAL_NAN;
+        } else if (isinf(samples[i])) {
+            flags |= VC_SIGNAL_INFINITE;
+        } else if (fpclassify(samples[i]) == FP_SUBNORMAL) {
+            flags |= VC_SIGNAL_DENORMAL;
+        }
+    }
+    return flags;
+}
+
+static double scan_ns(int (*scan)(const float *, int), const float *samples) {
+    volatile int sink = 0;
+    uint64_t start = bench_now_ns();
+    for (int r = 0; r < kScanRepeats; r++) {
+        sink += scan(samples, kScanValues);
+    }
+    (void)sink;
+    return (double)(bench_now_ns() - start) / ((double)kScanRepeats * kScanValues);
+}
+
+void bench_signal_guard(void) {
+    printf("FTZ/DAZ control: %s\n", vc_denormals_flush_supported() ? "yes" : "no (state flush at block end)");
+    printf("Silent input after %ds of speech, %d frames/block (ns/block)\n", kSpeechSeconds, kBlockSize);
+    for (int multiband = 0; multiband <= 1; multiband++) {
+        SilentCost off = measure_silence(0, multiband);
+        SilentCost on = measure_silence(1, multiband);
+        printf("  %-10s guard off: avg %8.0f  first 1s %8.0f  worst %8.0f\n",
+               multiband ? "multiband" : "default", off.averageNs, off.firstSecondNs, off.worstNs);
+        printf("  %-10s guard on:  avg %8.0f  first 1s %8.0f  worst %8.0f  (%.1fx)\n",
+               "", on.averageNs, on.firstSecondNs, on.worstNs, off.averageNs / on.averageNs);
+    }
+
+    float *samples = malloc(kScanValues * sizeof(float));
+    uint32_t seed = 3;
+    bench_fill_noise(samples, kScanValues, 0.5f, &seed);
+    double vectorNs = scan_ns(vc_signal_scan, samples);
+    double scalarNs = scan_ns(scalar_scan, samples);
+    printf("Scan (%d values): vc_signal_scan %.3f ns/value, isnan/isinf/fpclassify %.3f ns/value (%.1fx)\n",
+           kScanValues, vectorNs, scalarNs, scalarNs / vectorNs);
+    free(samples);
+
+    // NaN を 1 つ含むブロックの後、出力が有限のまま続くか
+    VCChain *chain = vc_chain_create(kBenchSampleRate);
+    float block[kBlockSize];
+    int nonFiniteOutputs = 0;
+    for (int b = 0; b < 20; b++) {
+        bench_fill_voice(block, kBlockSize, kBenchSampleRate, 140.0f, 11 + (uint32_t)b);
+        if (b == 5) {
+            block[17] = NAN;
+        }
+        vc_chain_process(chain, block, block, kBlockSize);
+        for (int i = 0; i < kBlockSize; i++) {
+            nonFiniteOutputs += !isfinite(block[i]);
+        }
+    }
+    VCSignalGuardStats stats;
+    vc_chain_get_signal_guard_stats(chain, &stats);
+    printf("NaN input block: %llu blocks, %llu non-finite input, %llu resets, %d non-finite output samples\n",
+           (unsigned long long)stats.blocks, (unsigned long long)stats.nonFiniteInputBlocks,
+           (unsigned long long)stats.resets, nonFiniteOutputs);
+    vc_chain_destroy(chain);
+}
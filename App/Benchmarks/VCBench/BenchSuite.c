@@ -0,0 +1,958 @@
+//
+//  BenchSuite.c
+//  VoiceChanger Benchmarks
+//
+//  Regression suite: every DSP kernel at 128/256/512 frames, the full chain per built-in preset,
+//  ring transport and the driver read path. Results as JSON, compared against a stored baseline
+//
+
+#include "BenchCommon.h"
+#include "VCCore.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define kSuiteSeconds       2       // テスト信号の長さ（パスの中では繰り返して使う）
+#define kSuitePasses        7       // 中央値・最小を取るパス数
+#define kSuiteQuickPasses   3
+#define kSuitePassMs        40      // 1 パスの最短時間（短いとタイマーと割り込みの揺れが残る）
+#define kSuiteQuickPassMs   10
+#define kSuiteMaxResults    256
+#define kSuiteTolerance     0.25    // 既定の許容（ベースラインより 25% 遅くなったら退行）
+#define kHandoffBlocks      2000
+#define kAecTailMs          100
+
+static const int kFrameSizes[] = { 128, 256, 512 };
+#define kFrameSizeCount ((int)(sizeof(kFrameSizes) / sizeof(kFrameSizes[0])))
+
+/// 1 ブロックずつ処理するカーネル（in-place のものは input を output に写してから処理する）
+typedef struct {
+    const char *name;
+    void *(*create)(int frames);
+    void (*process)(void *state, const float *input, float *output, int frames);
+    void (*destroy)(void *state);
+} SuiteKernel;
+
+typedef struct {
+    char name[48];
+    int frames;
+    double ns;          // パスの中央値（ns / ブロック。ring.handoff は 1 ブロックの受け渡しの遅れ）
+    double minNs;
+    double maxNs;       // ring.handoff は p99
+    double refNs;       // 直前に測った基準ループ（マシン全体の速さの揺れを打ち消すのに使う）
+} SuiteResult;
+
+typedef struct {
+    SuiteResult results[kSuiteMaxResults];
+    int count;
+    int passes;
+    int passMs;
+    const char *const *filters;
+    int filterCount;
+    const float *signal;
+    float *work;
+    int total;
+} Suite;
+
+static void copy_input(const float *input, float *output, int frames) {
+    memcpy(output, input, (size_t)frames * sizeof(float));
+}
+
+#pragma mark - Filters & Dynamics
+
+typedef struct {
+    VCBiquadCoeffs coeffs[3];
+    VCBiquadState states[3];
+} EqState;
+
+static void *eq_create(int frames) {
+    (void)frames;
+    EqState *eq = calloc(1, sizeof(EqState));
+    vc_biquad_set_lowshelf(&eq->coeffs[0], 200.0f, 3.0f, kBenchSampleRate);
+    vc_biquad_set_peaking(&eq->coeffs[1], 1500.0f, -2.0f, 0.7f, kBenchSampleRate);
+    vc_biquad_set_highshelf(&eq->coeffs[2], 6000.0f, 4.0f, kBenchSampleRate);
+    return eq;
+}
+
+static void eq_process(void *state, const float *input, float *output, int frames) {
+    EqState *eq = state;
+    vc_biquad_process(&eq->coeffs[0], &eq->states[0], input, output, frames);
+    vc_biquad_process(&eq->coeffs[1], &eq->states[1], output, output, frames);
+    vc_biquad_process(&eq->coeffs[2], &eq->states[2], output, output, frames);
+}
+
+static void *gate_create(int frames) {
+    (void)frames;
+    VCNoiseGate *gate = calloc(1, sizeof(VCNoiseGate));
+    vc_noise_gate_init(gate);
+    vc_noise_gate_set_strength(gate, 0.5f);
+    return gate;
+}
+
+static void gate_process(void *state, const float *input, float *output, int frames) {
+    copy_input(input, output, frames);
+    vc_noise_gate_process(state, output, frames);
+}
+
+static void *agc_create(int frames) {
+    (void)frames;
+    VCAgc *agc = calloc(1, sizeof(VCAgc));
+    vc_agc_init(agc);
+    return agc;
+}
+
+static void agc_process(void *state, const float *input, float *output, int frames) {
+    copy_input(input, output, frames);
+    vc_agc_process(state, output, frames);
+}
+
+static void *limiter_create_factor(int factor) {
+    VCLimiter *limiter = calloc(1, sizeof(VCLimiter));
+    vc_limiter_init(limiter);
+    vc_limiter_set_ceiling(limiter, -6.0f);
+    vc_limiter_set_oversampling(limiter, factor);
+    return limiter;
+}
+
+static void *limiter_create(int frames) {
+    (void)frames;
+    return limiter_create_factor(1);
+}
+
+static void *limiter4_create(int frames) {
+    (void)frames;
+    return limiter_create_factor(4);
+}
+
+static void limiter_process(void *state, const float *input, float *output, int frames) {
+    copy_input(input, output, frames);
+    vc_limiter_process(state, output, frames);
+}
+
+static void *multiband_create(int frames) {
+    (void)frames;
+    return vc_multiband_create(kBenchSampleRate);
+}
+
+static void multiband_process(void *state, const float *input, float *output, int frames) {
+    copy_input(input, output, frames);
+    vc_multiband_process(state, output, frames);
+}
+
+static void multiband_destroy(void *state) {
+    vc_multiband_destroy(state);
+}
+
+static void *oversampler2_create(int frames) {
+    return vc_oversampler_create(2, frames);
+}
+
+static void *oversampler4_create(int frames) {
+    return vc_oversampler_create(4, frames);
+}
+
+static void oversampler_process(void *state, const float *input, float *output, int frames) {
+    vc_oversampler_upsample(state, input, frames);
+    vc_oversampler_downsample(state, output, frames);
+}
+
+static void oversampler_destroy(void *state) {
+    vc_oversampler_destroy(state);
+}
+
+#pragma mark - Analysis
+
+static void *meter_create(int frames) {
+    (void)frames;
+    return vc_meter_create(kBenchSampleRate);
+}
+
+static void meter_process(void *state, const float *input, float *output, int frames) {
+    (void)output;
+    vc_meter_process(state, input, frames);
+}
+
+static void meter_destroy(void *state) {
+    vc_meter_destroy(state);
+}
+
+static void *vad_create(int frames) {
+    (void)frames;
+    return vc_vad_create(kBenchSampleRate);
+}
+
+static void vad_process(void *state, const float *input, float *output, int frames) {
+    output[0] = (float)vc_vad_process(state, input, frames);
+}
+
+static void vad_destroy(void *state) {
+    vc_vad_destroy(state);
+}
+
+static void *pitch_create(int frames) {
+    (void)frames;
+    return vc_pitch_create(kBenchSampleRate, VC_PITCH_DEFAULT_MIN_HZ, VC_PITCH_DEFAULT_MAX_HZ);
+}
+
+static void pitch_process(void *state, const float *input, float *output, int frames) {
+    VCPitchEstimate estimate;
+    vc_pitch_process(state, input, frames, 1, &estimate);
+    output[0] = estimate.f0Hz;
+}
+
+static void pitch_destroy(void *state) {
+    vc_pitch_destroy(state);
+}
+
+typedef struct {
+    VCPlanCache *cache;
+    VCAnalysisContext *context;
+} AnalysisState;
+
+static void *analysis_create(int frames) {
+    AnalysisState *analysis = calloc(1, sizeof(AnalysisState));
+    analysis->cache = vc_plan_cache_create();
+    vc_plan_cache_prepare(analysis->cache, frames);
+    analysis->context = vc_analysis_create(frames, analysis->cache);
+    return analysis;
+}
+
+/// チェーンの各段が使う分（全フレームのパワー・最後のフレームの対数スペクトル・LPC）
+static void analysis_process(void *state, const float *input, float *output, int frames) {
+    AnalysisState *analysis = state;
+    vc_analysis_begin_block(analysis->context, input, frames);
+    int count = vc_analysis_frame_count(analysis->context);
+    for (int f = 0; f < count; f++) {
+        output[f] = vc_analysis_power(analysis->context, f)[1];
+    }
+    output[0] += vc_analysis_log_spectrum(analysis->context, count - 1)[1];
+    output[0] += vc_analysis_lpc(analysis->context, NULL)[1];
+}
+
+static void analysis_destroy(void *state) {
+    AnalysisState *analysis = state;
+    vc_analysis_destroy(analysis->context);
+    vc_plan_cache_destroy(analysis->cache);
+    free(analysis);
+}
+
+typedef struct {
+    VCFFTPlan *plan;
+    float re[VC_MAX_FRAME_SIZE + 1];
+    float im[VC_MAX_FRAME_SIZE + 1];
+    float padded[2 * VC_MAX_FRAME_SIZE];
+    float result[2 * VC_MAX_FRAME_SIZE];
+} FFTState;
+
+static void *fft_create(int frames) {
+    FFTState *fft = calloc(1, sizeof(FFTState));
+    fft->plan = vc_fft_plan_create(2 * frames);
+    return fft;
+}
+
+/// ゼロ詰めした 2 倍長の往復（重畳加算の 1 ブロック分）
+static void fft_process(void *state, const float *input, float *output, int frames) {
+    FFTState *fft = state;
+    memcpy(fft->padded, input, (size_t)frames * sizeof(float));
+    vc_fft_forward(fft->plan, fft->padded, fft->re, fft->im);
+    vc_fft_inverse(fft->plan, fft->re, fft->im, fft->result);
+    memcpy(output, fft->result, (size_t)frames * sizeof(float));
+}
+
+static void fft_destroy(void *state) {
+    FFTState *fft = state;
+    vc_fft_plan_destroy(fft->plan);
+    free(fft);
+}
+
+#pragma mark - Fast Math
+
+/// 4 倍に持ち上げた入力の tanh（ソフトクリップ。状態は持たない）
+static void *fastmath_tanh_create(int frames) {
+    (void)frames;
+    return calloc(1, sizeof(float));
+}
+
+static void fastmath_tanh_process(void *state, const float *input, float *output, int frames) {
+    (void)state;
+    for (int i = 0; i < frames; i++) {
+        output[i] = 4.0f * input[i];
+    }
+    vc_fast_tanh(output, output, frames);
+}
+
+/// 入力を位相（×π）とみなした sin / cos（cos は作業領域に書いて捨てる）
+static void *fastmath_sincos_create(int frames) {
+    return malloc((size_t)frames * sizeof(float));
+}
+
+static void fastmath_sincos_process(void *state, const float *input, float *output, int frames) {
+    for (int i = 0; i < frames; i++) {
+        output[i] = 3.14159265f * input[i];
+    }
+    vc_fast_sincos(output, output, state, frames);
+}
+
+#pragma mark - Echo, Convolution, Monitor
+
+typedef struct {
+    VCEchoCanceller *aec;
+    float farEnd[VC_MAX_FRAME_SIZE];
+} AecState;
+
+static void *aec_create(int frames) {
+    (void)frames;
+    AecState *state = calloc(1, sizeof(AecState));
+    state->aec = vc_aec_create(VC_CHAIN_AEC_BLOCK_SIZE, kAecTailMs * kBenchSampleRate / 1000);
+    return state;
+}
+
+/// チェーンと同じく 128 フレームずつ。遠端は 1 ブロック前の入力（エコー経路の代わり）
+static void aec_process(void *state, const float *input, float *output, int frames) {
+    AecState *aec = state;
+    for (int offset = 0; offset < frames; offset += VC_CHAIN_AEC_BLOCK_SIZE) {
+        vc_aec_process(aec->aec, aec->farEnd + offset, input + offset, output + offset);
+    }
+    memcpy(aec->farEnd, input, (size_t)frames * sizeof(float));
+}
+
+static void aec_destroy(void *state) {
+    AecState *aec = state;
+    vc_aec_destroy(aec->aec);
+    free(aec);
+}
+
+/// 内蔵 IR の畳み込み（背景スレッドなし。後段も呼び出しスレッドで計算し、CPU 数に左右されない合計を測る）
+static VCConvolver *make_builtin_convolver(VCBuiltinImpulseResponse kind) {
+    int length = vc_ir_builtin_length(kind, kBenchSampleRate);
+    float *ir = malloc((size_t)length * sizeof(float));
+    vc_ir_builtin_render(kind, kBenchSampleRate, ir, length);
+    VCConvolver *convolver = vc_convolver_create(ir, length, 0);
+    free(ir);
+    return convolver;
+}
+
+static void *convolver_create(int frames) {
+    (void)frames;
+    return make_builtin_convolver(VC_IR_HALL);
+}
+
+static void convolver_process(void *state, const float *input, float *output, int frames) {
+    vc_convolver_process(state, input, output, frames);
+}
+
+static void convolver_destroy(void *state) {
+    vc_convolver_destroy(state);
+}
+
+static void *monitor_create(int frames) {
+    return vc_monitor_create(2 * frames, 8 * frames);
+}
+
+static void monitor_process(void *state, const float *input, float *output, int frames) {
+    vc_monitor_push(state, input, frames);
+    vc_monitor_pull(state, output, frames);
+}
+
+static void monitor_destroy(void *state) {
+    vc_monitor_destroy(state);
+}
+
+#pragma mark - Chain Presets
+
+/// 組み込みプリセット（DSPChain.swift の VoicePreset と同じ値）
+typedef struct {
+    const char *id;
+    float pitchShift;
+    float formantShift;
+    float eqLow;
+    float eqMid;
+    float eqHigh;
+    int multibandEnabled;
+    float deEsserThresholdDb;
+    float deEsserRatio;
+    int impulseResponse;        // VCBuiltinImpulseResponse、なしは -1
+    float convolutionMix;
+} SuitePreset;
+
+static const SuitePreset kPresets[] = {
+    { "default", 0, 0, 0, 0, 0, 0, -30, 4, -1, 0 },
+    { "male_to_female", 4, 0.3f, 0, 0, 2, 1, -32, 5, -1, 0 },
+    { "female_to_male", -4, -0.3f, 2, 0, 0, 0, -30, 4, -1, 0 },
+    { "phone", 0, 0, 0, 0, 0, 0, -30, 4, VC_IR_PHONE, 1 },
+    { "radio", 0, 0, 0, 2, 0, 0, -30, 4, VC_IR_RADIO, 1 },
+    { "hall", 0, 0, 0, 0, 0, 0, -30, 4, VC_IR_HALL, 0.3f },
+};
+#define kPresetCount ((int)(sizeof(kPresets) / sizeof(kPresets[0])))
+
+typedef struct {
+    VCPlanCache *cache;
+    VCChain *chain;
+    VCConvolver *convolver;
+} ChainState;
+
+static void *chain_create_preset(const SuitePreset *preset, int frames) {
+    ChainState *state = calloc(1, sizeof(ChainState));
+    state->cache = vc_plan_cache_create();
+    vc_plan_cache_prepare(state->cache, frames);
+    state->chain = vc_chain_create(kBenchSampleRate);
+    vc_chain_prepare(state->chain, state->cache);
+
+    VCChainParams params;
+    vc_chain_params_default(&params);
+    params.pitchShift = preset->pitchShift;
+    params.formantShift = preset->formantShift;
+    params.eqLow = preset->eqLow;
+    params.eqMid = preset->eqMid;
+    params.eqHigh = preset->eqHigh;
+    params.multibandEnabled = preset->multibandEnabled;
+    params.deEsserThresholdDb = preset->deEsserThresholdDb;
+    params.deEsserRatio = preset->deEsserRatio;
+    params.convolutionMix = preset->convolutionMix;
+    if (preset->impulseResponse >= 0) {
+        state->convolver = make_builtin_convolver((VCBuiltinImpulseResponse)preset->impulseResponse);
+        vc_chain_set_convolver(state->chain, state->convolver);
+    }
+    vc_chain_set_params(state->chain, &params);
+    return state;
+}
+
+static void chain_process(void *state, const float *input, float *output, int frames) {
+    vc_chain_process(((ChainState *)state)->chain, input, output, frames);
+}
+
+static void chain_destroy(void *state) {
+    ChainState *chain = state;
+    vc_chain_destroy(chain->chain);
+    vc_convolver_destroy(chain->convolver);
+    vc_plan_cache_destroy(chain->cache);
+    free(chain);
+}
+
+#pragma mark - Graph
+
+/// VoicePreset.duet のグラフ（生存区間でバッファを使い回す / ノードごとに持つ）
+static void *graph_duet_create(int frames) {
+    (void)frames;
+    return bench_graph_create("duet", 0, 0);
+}
+
+static void *graph_duet_naive_create(int frames) {
+    (void)frames;
+    return bench_graph_create("duet", 1, 0);
+}
+
+#pragma mark - Voice Conversion
+
+/// 既定の大きさの声質変換（補助スレッドなし、process 内で推論）
+static void *voice_default_create(int frames) {
+    (void)frames;
+    return bench_voice_converter_create("default", 0, 0);
+}
+
+#pragma mark - Transport
+
+static void *ring_create(int frames) {
+    return vc_audio_ring_create(8 * frames);
+}
+
+/// 同じスレッドで書いて読む（コピー 2 回とインデックスの往復）
+static void ring_process(void *state, const float *input, float *output, int frames) {
+    vc_audio_ring_write(state, input, frames);
+    vc_audio_ring_read(state, output, frames);
+}
+
+static void ring_destroy(void *state) {
+    vc_audio_ring_destroy(state);
+}
+
+typedef struct {
+    VCAudioRing *ring;
+    VCSharedRingWatch watch;
+    int peerActive;
+    uint64_t now;
+    uint64_t ticksPerBlock;
+} DriverState;
+
+static void *driver_create(int frames) {
+    DriverState *driver = calloc(1, sizeof(DriverState));
+    driver->ring = vc_audio_ring_create(8 * frames);
+    VCSharedRing *view = vc_audio_ring_view(driver->ring);
+    vc_shared_ring_set_active(view, 1);
+    vc_shared_ring_watch_init(&driver->watch, view, 0, 100);
+    // ホスト時刻は ns とみなす
+    driver->ticksPerBlock = (uint64_t)frames * 1000000000ull / kBenchSampleRate;
+    return driver;
+}
+
+/// ドライバーの 1 IO 周期（ReadInput・受け渡しの刻印・ゼロタイムスタンプ）。アプリ側はコピーせずに進めるだけ
+static void driver_process(void *state, const float *input, float *output, int frames) {
+    (void)input;
+    DriverState *driver = state;
+    VCSharedRing *view = vc_audio_ring_view(driver->ring);
+    vc_shared_ring_commit_write(view, frames);
+    vc_shared_ring_heartbeat(view);
+
+    driver->now += driver->ticksPerBlock;
+    VCDriverReadResult result = vc_driver_read_input(view, &driver->watch, driver->now / 1000000,
+                                                     output, frames, &driver->peerActive);
+    vc_shared_ring_stamp_delivery(view, result.readIndex, driver->now);
+    double sampleTime;
+    uint64_t hostTime;
+    vc_driver_zero_timestamp(0, driver->now, 1e9 / kBenchSampleRate, (uint32_t)frames, &sampleTime, &hostTime);
+}
+
+static void driver_destroy(void *state) {
+    DriverState *driver = state;
+    vc_audio_ring_destroy(driver->ring);
+    free(driver);
+}
+
+static const SuiteKernel kKernels[] = {
+    { "eq", eq_create, eq_process, free },
+    { "gate", gate_create, gate_process, free },
+    { "agc", agc_create, agc_process, free },
+    { "limiter", limiter_create, limiter_process, free },
+    { "limiter.x4", limiter4_create, limiter_process, free },
+    { "multiband", multiband_create, multiband_process, multiband_destroy },
+    { "oversampler.x2", oversampler2_create, oversampler_process, oversampler_destroy },
+    { "oversampler.x4", oversampler4_create, oversampler_process, oversampler_destroy },
+    { "meter", meter_create, meter_process, meter_destroy },
+    { "vad", vad_create, vad_process, vad_destroy },
+    { "pitch", pitch_create, pitch_process, pitch_destroy },
+    { "analysis", analysis_create, analysis_process, analysis_destroy },
+    { "fft", fft_create, fft_process, fft_destroy },
+    { "fastmath.tanh", fastmath_tanh_create, fastmath_tanh_process, free },
+    { "fastmath.sincos", fastmath_sincos_create, fastmath_sincos_process, free },
+    { "aec", aec_create, aec_process, aec_destroy },
+    { "convolver.hall", convolver_create, convolver_process, convolver_destroy },
+    { "monitor", monitor_create, monitor_process, monitor_destroy },
+    { "ring.transfer", ring_create, ring_process, ring_destroy },
+    { "driver.read", driver_create, driver_process, driver_destroy },
+    { "graph.duet", graph_duet_create, bench_graph_process, bench_graph_destroy },
+    { "graph.duet.naive", graph_duet_naive_create, bench_graph_process, bench_graph_destroy },
+    { "neural.default", voice_default_create, bench_voice_converter_process, bench_voice_converter_destroy },
+};
+#define kKernelCount ((int)(sizeof(kKernels) / sizeof(kKernels[0])))
+
+#pragma mark - Cross-Thread Handoff
+
+typedef struct {
+    VCAudioRing *ring;
+    int frames;
+    uint64_t sentAt[kHandoffBlocks];
+    double latencies[kHandoffBlocks];
+    _Atomic int received;
+} Handoff;
+
+/// consumer: 届いたブロックを読み、書いた時刻との差を記録する（空なら譲る）
+static void *handoff_consumer(void *context) {
+    Handoff *handoff = context;
+    float block[VC_MAX_FRAME_SIZE];
+    for (int b = 0; b < kHandoffBlocks; b++) {
+        while (vc_audio_ring_available_read(handoff->ring) < handoff->frames) {
+            sched_yield();
+        }
+        uint64_t now = bench_now_ns();
+        vc_audio_ring_read(handoff->ring, block, handoff->frames);
+        handoff->latencies[b] = (double)(now - handoff->sentAt[b]);
+        atomic_store_explicit(&handoff->received, b + 1, memory_order_release);
+    }
+    return NULL;
+}
+
+static int compare_double(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return x < y ? -1 : x > y;
+}
+
+/// 1 ブロックずつ書き、読まれるのを待ってから次を書く（受け渡しの遅れだけを測る）
+static void measure_handoff(int frames, SuiteResult *result) {
+    Handoff *handoff = calloc(1, sizeof(Handoff));
+    handoff->ring = vc_audio_ring_create(8 * frames);
+    handoff->frames = frames;
+
+    pthread_t consumer;
+    pthread_create(&consumer, NULL, handoff_consumer, handoff);
+    float block[VC_MAX_FRAME_SIZE] = { 0 };
+    for (int b = 0; b < kHandoffBlocks; b++) {
+        handoff->sentAt[b] = bench_now_ns();
+        vc_audio_ring_write(handoff->ring, block, frames);
+        while (atomic_load_explicit(&handoff->received, memory_order_acquire) <= b) {
+            sched_yield();
+        }
+    }
+    pthread_join(consumer, NULL);
+
+    qsort(handoff->latencies, kHandoffBlocks, sizeof(double), compare_double);
+    result->ns = handoff->latencies[kHandoffBlocks / 2];
+    result->minNs = handoff->latencies[0];
+    result->maxNs = handoff->latencies[kHandoffBlocks * 99 / 100];
+    vc_audio_ring_destroy(handoff->ring);
+    free(handoff);
+}
+
+#pragma mark - Runner
+
+#define kReferenceLength    1024
+#define kReferenceRounds    64
+#define kReferenceRuns      5
+
+/// VCCore を使わない固定の計算（xorshift + 積和）。各ケースの直前に測り、その間のマシンの速さとする
+static double measure_reference(void) {
+    static float buffer[kReferenceLength];
+    double best = 0.0;
+    for (int run = 0; run < kReferenceRuns; run++) {
+        uint32_t seed = 1;
+        uint64_t start = bench_now_ns();
+        for (int round = 0; round < kReferenceRounds; round++) {
+            bench_fill_noise(buffer, kReferenceLength, 1.0f, &seed);
+            float acc = 0.0f;
+            for (int i = 1; i < kReferenceLength; i++) {
+                acc = acc * 0.5f + buffer[i] * buffer[i - 1];
+            }
+            buffer[0] = acc;
+        }
+        double elapsed = (double)(bench_now_ns() - start);
+        if (run == 0 || elapsed < best) {
+            best = elapsed;
+        }
+    }
+    bench_consume(buffer, 1);
+    return best;
+}
+
+static int matches_filter(const Suite *suite, const char *name) {
+    if (suite->filterCount == 0) {
+        return 1;
+    }
+    for (int i = 0; i < suite->filterCount; i++) {
+        if (strstr(name, suite->filters[i]) != NULL) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static SuiteResult *add_result(Suite *suite, const char *name, int frames) {
+    if (suite->count >= kSuiteMaxResults) {
+        return NULL;
+    }
+    SuiteResult *result = &suite->results[suite->count++];
+    memset(result, 0, sizeof(*result));
+    snprintf(result->name, sizeof(result->name), "%s", name);
+    result->frames = frames;
+    result->refNs = measure_reference();
+    return result;
+}
+
+/// 1 パス = 信号を passMs 以上かかるまで繰り返す。最初の 1 パスは捨て、残りの中央値・最小・最大
+static void measure_kernel(Suite *suite, void *state, void (*process)(void *, const float *, float *, int),
+                           int frames, SuiteResult *result) {
+    int signalBlocks = suite->total / frames;
+    uint64_t passNsMin = (uint64_t)suite->passMs * 1000000ull;
+    double passNs[kSuitePasses];
+    for (int pass = -1; pass < suite->passes; pass++) {
+        uint64_t start = bench_now_ns();
+        uint64_t elapsed = 0;
+        long blocks = 0;
+        do {
+            for (int b = 0; b < signalBlocks; b++) {
+                size_t offset = (size_t)b * frames;
+                process(state, suite->signal + offset, suite->work + offset, frames);
+            }
+            blocks += signalBlocks;
+            elapsed = bench_now_ns() - start;
+        } while (elapsed < passNsMin);
+        bench_consume(suite->work, suite->total);
+        if (pass >= 0) {
+            passNs[pass] = (double)elapsed / (double)blocks;
+        }
+    }
+    qsort(passNs, (size_t)suite->passes, sizeof(double), compare_double);
+    result->ns = passNs[suite->passes / 2];
+    result->minNs = passNs[0];
+    result->maxNs = passNs[suite->passes - 1];
+}
+
+static void print_result(const SuiteResult *result) {
+    double blockNs = (double)result->frames / kBenchSampleRate * 1e9;
+    if (strcmp(result->name, "ring.handoff") == 0) {
+        printf("%-24s %4d  %10.1f ns  (p99 %.1f ns)\n", result->name, result->frames, result->ns, result->maxNs);
+    } else {
+        printf("%-24s %4d  %10.1f ns  %7.3f%%  [%.1f .. %.1f]\n", result->name, result->frames, result->ns,
+               100.0 * result->ns / blockNs, result->minNs, result->maxNs);
+    }
+}
+
+static void run_suite(Suite *suite) {
+    for (int k = 0; k < kKernelCount; k++) {
+        if (!matches_filter(suite, kKernels[k].name)) {
+            continue;
+        }
+        for (int f = 0; f < kFrameSizeCount; f++) {
+            SuiteResult *result = add_result(suite, kKernels[k].name, kFrameSizes[f]);
+            if (result == NULL) {
+                return;
+            }
+            void *state = kKernels[k].create(kFrameSizes[f]);
+            measure_kernel(suite, state, kKernels[k].process, kFrameSizes[f], result);
+            kKernels[k].destroy(state);
+            print_result(result);
+        }
+    }
+
+    for (int p = 0; p < kPresetCount; p++) {
+        char name[48];
+        snprintf(name, sizeof(name), "chain.%s", kPresets[p].id);
+        if (!matches_filter(suite, name)) {
+            continue;
+        }
+        for (int f = 0; f < kFrameSizeCount; f++) {
+            SuiteResult *result = add_result(suite, name, kFrameSizes[f]);
+            if (result == NULL) {
+                return;
+            }
+            void *state = chain_create_preset(&kPresets[p], kFrameSizes[f]);
+            measure_kernel(suite, state, chain_process, kFrameSizes[f], result);
+            chain_destroy(state);
+            print_result(result);
+        }
+    }
+
+    if (matches_filter(suite, "ring.handoff")) {
+        for (int f = 0; f < kFrameSizeCount; f++) {
+            SuiteResult *result = add_result(suite, "ring.handoff", kFrameSizes[f]);
+            if (result == NULL) {
+                return;
+            }
+            measure_handoff(kFrameSizes[f], result);
+            print_result(result);
+        }
+    }
+}
+
+#pragma mark - JSON
+
+static int write_json(const Suite *suite, const char *path) {
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        return -1;
+    }
+    fprintf(file, "{\n  \"suite\": \"vcbench\",\n  \"version\": 1,\n  \"sampleRate\": %d,\n  \"passes\": %d,\n",
+            kBenchSampleRate, suite->passes);
+    fprintf(file, "  \"results\": [\n");
+    for (int i = 0; i < suite->count; i++) {
+        const SuiteResult *result = &suite->results[i];
+        double blockNs = (double)result->frames / kBenchSampleRate * 1e9;
+        fprintf(file, "    { \"name\": \"%s\", \"frames\": %d, \"ns\": %.1f, \"minNs\": %.1f, \"maxNs\": %.1f, \"refNs\": %.1f, \"load\": %.6f }%s\n",
+                result->name, result->frames, result->ns, result->minNs, result->maxNs, result->refNs,
+                result->ns / blockNs, i + 1 < suite->count ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    return fclose(file) == 0 ? 0 : -1;
+}
+
+static char *read_file(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *text = size >= 0 ? malloc((size_t)size + 1) : NULL;
+    if (text != NULL && fread(text, 1, (size_t)size, file) != (size_t)size) {
+        free(text);
+        text = NULL;
+    }
+    if (text != NULL) {
+        text[size] = '\0';
+    }
+    fclose(file);
+    return text;
+}
+
+/// object の中の "key": の値の先頭（なければ NULL）
+static const char *find_value(const char *object, const char *end, const char *key) {
+    char quoted[32];
+    snprintf(quoted, sizeof(quoted), "\"%s\"", key);
+    const char *found = strstr(object, quoted);
+    if (found == NULL || found >= end) {
+        return NULL;
+    }
+    const char *colon = strchr(found + strlen(quoted), ':');
+    if (colon == NULL || colon >= end) {
+        return NULL;
+    }
+    colon++;
+    while (*colon == ' ' || *colon == '\t' || *colon == '\n' || *colon == '\r') {
+        colon++;
+    }
+    return colon;
+}
+
+/// write_json が書いた形（results の中は入れ子のないオブジェクト）を読む。読めた数を返す
+static int read_baseline(const char *path, SuiteResult *results, int capacity) {
+    char *text = read_file(path);
+    if (text == NULL) {
+        return -1;
+    }
+    const char *cursor = strstr(text, "\"results\"");
+    int count = 0;
+    while (cursor != NULL && count < capacity) {
+        const char *object = strchr(cursor, '{');
+        const char *end = object != NULL ? strchr(object, '}') : NULL;
+        if (end == NULL) {
+            break;
+        }
+        const char *name = find_value(object, end, "name");
+        const char *frames = find_value(object, end, "frames");
+        const char *ns = find_value(object, end, "ns");
+        const char *minNs = find_value(object, end, "minNs");
+        const char *refNs = find_value(object, end, "refNs");
+        if (name != NULL && *name == '"' && frames != NULL && ns != NULL) {
+            SuiteResult *result = &results[count];
+            memset(result, 0, sizeof(*result));
+            const char *close = strchr(name + 1, '"');
+            int length = close != NULL && close < end ? (int)(close - name - 1) : 0;
+            if (length > 0 && length < (int)sizeof(result->name)) {
+                memcpy(result->name, name + 1, (size_t)length);
+                result->frames = (int)strtol(frames, NULL, 10);
+                result->ns = strtod(ns, NULL);
+                result->minNs = minNs != NULL ? strtod(minNs, NULL) : result->ns;
+                result->refNs = refNs != NULL ? strtod(refNs, NULL) : 0.0;
+                count++;
+            }
+        }
+        cursor = end + 1;
+    }
+    free(text);
+    return count;
+}
+
+/// ベースラインと比べる（tolerance を超えて遅くなったものの数を返す）
+/// 比べるのはパスの最小（他のプロセスや割り込みに邪魔されなかったときの値）。ring.handoff は中央値。
+/// 両方に基準ループの時間があれば、その比でマシン全体の速さの違い（クロック・他の VM）を割り引く
+static int compare_baseline(const Suite *suite, const SuiteResult *baseline, int baselineCount, double tolerance) {
+    int regressions = 0;
+    printf("\n%-24s %4s  %12s %12s  %8s\n", "name", "n", "baseline", "current", "change");
+    for (int i = 0; i < suite->count; i++) {
+        const SuiteResult *result = &suite->results[i];
+        const SuiteResult *base = NULL;
+        for (int j = 0; j < baselineCount; j++) {
+            if (baseline[j].frames == result->frames && strcmp(baseline[j].name, result->name) == 0) {
+                base = &baseline[j];
+                break;
+            }
+        }
+        int handoff = strcmp(result->name, "ring.handoff") == 0;
+        double current = handoff ? result->ns : result->minNs;
+        double reference = base == NULL ? 0.0 : handoff ? base->ns : base->minNs;
+        if (reference <= 0.0) {
+            printf("%-24s %4d  %12s %12.1f  %8s  new\n", result->name, result->frames, "-", current, "-");
+            continue;
+        }
+        double ratio = current / reference;
+        if (base->refNs > 0.0 && result->refNs > 0.0) {
+            ratio *= base->refNs / result->refNs;
+        }
+        const char *verdict = "ok";
+        if (ratio > 1.0 + tolerance) {
+            verdict = "REGRESSED";
+            regressions++;
+        } else if (ratio < 1.0 / (1.0 + tolerance)) {
+            verdict = "faster";
+        }
+        printf("%-24s %4d  %12.1f %12.1f  %+7.1f%%  %s\n", result->name, result->frames, reference, current,
+               (ratio - 1.0) * 100.0, verdict);
+    }
+
+    // フィルターなしで回したときだけ、消えたケースを知らせる
+    if (suite->filterCount == 0) {
+        for (int j = 0; j < baselineCount; j++) {
+            int found = 0;
+            for (int i = 0; i < suite->count && !found; i++) {
+                found = baseline[j].frames == suite->results[i].frames && strcmp(baseline[j].name, suite->results[i].name) == 0;
+            }
+            if (!found) {
+                printf("%-24s %4d  %12.1f %12s  %8s  missing\n", baseline[j].name, baseline[j].frames, baseline[j].minNs, "-", "-");
+            }
+        }
+    }
+    return regressions;
+}
+
+#pragma mark - Entry
+
+static int suite_usage(void) {
+    fprintf(stderr,
+            "Usage: VCBench --suite [--quick] [--json out.json] [--baseline base.json] [--tolerance 0.25] [filter ...]\n");
+    return 2;
+}
+
+int bench_suite_main(int argc, char **argv) {
+    const char *jsonPath = NULL;
+    const char *baselinePath = NULL;
+    double tolerance = kSuiteTolerance;
+    const char *filters[argc > 0 ? argc : 1];
+    Suite *suite = calloc(1, sizeof(Suite));
+    suite->passes = kSuitePasses;
+    suite->passMs = kSuitePassMs;
+    suite->filters = filters;
+
+    for (int arg = 0; arg < argc; arg++) {
+        if (strcmp(argv[arg], "--quick") == 0) {
+            suite->passes = kSuiteQuickPasses;
+            suite->passMs = kSuiteQuickPassMs;
+        } else if (strcmp(argv[arg], "--json") == 0 && arg + 1 < argc) {
+            jsonPath = argv[++arg];
+        } else if (strcmp(argv[arg], "--baseline") == 0 && arg + 1 < argc) {
+            baselinePath = argv[++arg];
+        } else if (strcmp(argv[arg], "--tolerance") == 0 && arg + 1 < argc) {
+            tolerance = atof(argv[++arg]);
+        } else if (argv[arg][0] == '-') {
+            free(suite);
+            return suite_usage();
+        } else {
+            filters[suite->filterCount++] = argv[arg];
+        }
+    }
+
+    suite->total = kSuiteSeconds * kBenchSampleRate;
+    float *signal = malloc((size_t)suite->total * sizeof(float));
+    suite->work = calloc((size_t)suite->total, sizeof(float));
+    bench_fill_voice(signal, suite->total, kBenchSampleRate, 140.0f, 3);
+    suite->signal = signal;
+
+    printf("%-24s %4s  %13s  %8s\n", "name", "n", "median", "load");
+    run_suite(suite);
+
+    int status = 0;
+    if (jsonPath != NULL && write_json(suite, jsonPath) != 0) {
+        fprintf(stderr, "Failed to write %s\n", jsonPath);
+        status = 1;
+    }
+    if (baselinePath != NULL && status == 0) {
+        SuiteResult *baseline = malloc(kSuiteMaxResults * sizeof(SuiteResult));
+        int count = read_baseline(baselinePath, baseline, kSuiteMaxResults);
+        if (count < 0) {
+            fprintf(stderr, "Failed to read %s\n", baselinePath);
+            status = 1;
+        } else {
+            int regressions = compare_baseline(suite, baseline, count, tolerance);
+            printf("\n%d regression(s) beyond %.0f%%\n", regressions, tolerance * 100.0);
+            status = regressions > 0 ? 4 : 0;
+        }
+        free(baseline);
+    }
+
+    free(signal);
+    free(suite->work);
+    free(suite);
+    return status;
+}
@@ -0,0 +1,166 @@
+//
+//  BenchTapRecorder.c
+//  VoiceChanger Benchmarks
+//
+//  Capture taps: 3 simultaneous 48kHz taps (2 pushed, 1 drained from an external
+//  ring like the driver tap) streamed to WAV files for hours of audio, run faster
+//  than real time
+//
+//  既定は 1 時間分の音声を 100 倍速で流す（VCBENCH_TAP_HOURS / VCBENCH_TAP_SPEED で変更）。
+//  リングの長さと読み出し間隔は壁時計で App（CaptureRecorder）と同じにするので、
+//  書き込みスレッドは App の speed 倍の量を同じ遅れの中で書き切る必要がある
+//
+
+#include "BenchCommon.h"
+#include "VCCore.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define kTapCount           3
+#define kPushedTaps         2
+#define kBlockFrames        256
+#define kRingSeconds        2       // CaptureRecorder.ringSeconds
+#define kDrainIntervalMs    20      // CaptureRecorder.drainIntervalMs
+#define kWavHeaderSize      92
+#define kRampPeriod         (1 << 24)   // float で正確に表せる範囲
+#define kHistogramBuckets   1000        // push 時間の分布（1µs 刻み、最後は 1ms 以上）
+
+static double env_or(const char *name, double fallback) {
+    const char *value = getenv(name);
+    return value != NULL && atof(value) > 0 ? atof(value) : fallback;
+}
+
+static void sleep_until(uint64_t deadlineNs) {
+    struct timespec ts = {
+        .tv_sec = (time_t)(deadlineNs / 1000000000ull),
+        .tv_nsec = (long)(deadlineNs % 1000000000ull),
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+    }
+}
+
+/// ファイルの長さとランプの先頭・末尾を確かめる（欠落がなければ k 番目のサンプルは k）
+static int verify_file(const char *path, uint64_t frames, int checkRamp) {
+    struct stat info;
+    if (stat(path, &info) != 0 || (uint64_t)info.st_size != kWavHeaderSize + frames * sizeof(float)) {
+        return 0;
+    }
+    if (!checkRamp || frames == 0) {
+        return 1;
+    }
+    int fd = open(path, O_RDONLY);
+    float first = -1, last = -1;
+    int ok = fd >= 0 &&
+             pread(fd, &first, sizeof(float), kWavHeaderSize) == sizeof(float) &&
+             pread(fd, &last, sizeof(float), (off_t)(kWavHeaderSize + (frames - 1) * sizeof(float))) == sizeof(float);
+    if (fd >= 0) {
+        close(fd);
+    }
+    return ok && first == 0.0f && last == (float)((frames - 1) % kRampPeriod);
+}
+
+void bench_tap_recorder(void) {
+    double hours = env_or("VCBENCH_TAP_HOURS", 1.0);
+    double speed = env_or("VCBENCH_TAP_SPEED", 100.0);
+    uint64_t totalBlocks = (uint64_t)(hours * 3600.0 * kBenchSampleRate / kBlockFrames);
+    int ringFrames = (int)(kRingSeconds * kBenchSampleRate * speed);
+
+    VCTapRecorder *recorder = vc_tap_recorder_create(kBenchSampleRate, kDrainIntervalMs);
+    VCAudioRing *external = vc_audio_ring_create(ringFrames);
+    for (int tap = 0; tap < kPushedTaps; tap++) {
+        vc_tap_recorder_add(recorder, ringFrames);
+    }
+    vc_tap_recorder_add_ring(recorder, vc_audio_ring_view(external));
+
+    char paths[kTapCount][64];
+    const char *pathPointers[kTapCount];
+    for (int tap = 0; tap < kTapCount; tap++) {
+        snprintf(paths[tap], sizeof(paths[tap]), "/tmp/vcbench-tap-%d-%d.wav", (int)getpid(), tap);
+        pathPointers[tap] = paths[tap];
+    }
+    if (vc_tap_recorder_start(recorder, pathPointers, VC_TAP_FORMAT_WAV) != 0) {
+        printf("failed to start recording in /tmp\n");
+        vc_tap_recorder_destroy(recorder);
+        vc_audio_ring_destroy(external);
+        return;
+    }
+
+    printf("%d taps, %.2f h of audio at %.0fx, block %d frames, ring %d frames\n",
+           kTapCount, hours, speed, kBlockFrames, ringFrames);
+
+    // オーディオスレッド役: 1 ブロックごとに 3 タップへ書き、speed 倍の速さで進める
+    float block[kBlockFrames];
+    uint64_t period = (uint64_t)(kBlockFrames * 1e9 / kBenchSampleRate / speed);
+    uint64_t pushSum = 0, pushMax = 0;
+    static uint64_t histogram[kHistogramBuckets];
+    memset(histogram, 0, sizeof(histogram));
+    uint64_t externalDropped = 0;
+    uint64_t start = bench_now_ns();
+    uint64_t deadline = start;
+    for (uint64_t b = 0; b < totalBlocks; b++) {
+        uint64_t base = b * kBlockFrames;
+        for (int i = 0; i < kBlockFrames; i++) {
+            block[i] = (float)((base + (uint64_t)i) % kRampPeriod);
+        }
+
+        uint64_t t0 = bench_now_ns();
+        for (int tap = 0; tap < kPushedTaps; tap++) {
+            vc_tap_recorder_push(recorder, tap, block, kBlockFrames);
+        }
+        uint64_t elapsed = bench_now_ns() - t0;
+        pushSum += elapsed;
+        if (elapsed > pushMax) {
+            pushMax = elapsed;
+        }
+        histogram[elapsed / 1000 < kHistogramBuckets ? elapsed / 1000 : kHistogramBuckets - 1]++;
+        externalDropped += (uint64_t)(kBlockFrames - vc_audio_ring_write(external, block, kBlockFrames));
+
+        deadline += period;
+        if (deadline > bench_now_ns()) {
+            sleep_until(deadline);
+        }
+    }
+    uint64_t produced = bench_now_ns() - start;
+    uint64_t stopStart = bench_now_ns();
+    vc_tap_recorder_stop(recorder);
+    uint64_t stopNs = bench_now_ns() - stopStart;
+
+    double audioSeconds = (double)totalBlocks * kBlockFrames / kBenchSampleRate;
+    double wallSeconds = (double)(produced + stopNs) / 1e9;
+    uint64_t bytes = 0;
+    int allOk = 1;
+    for (int tap = 0; tap < kTapCount; tap++) {
+        VCTapStats stats;
+        vc_tap_recorder_get_stats(recorder, tap, &stats);
+        uint64_t dropped = tap < kPushedTaps ? stats.droppedFrames : externalDropped;
+        int ok = stats.framesWritten + dropped == totalBlocks * kBlockFrames && stats.writeErrors == 0 &&
+                 verify_file(paths[tap], stats.framesWritten, dropped == 0);
+        allOk &= ok;
+        bytes += stats.framesWritten * sizeof(float);
+        printf("tap %d %-8s  written %10.1f s  dropped %8llu frames (%llu overflows)  errors %llu  %s\n",
+               tap, tap < kPushedTaps ? "push" : "external", (double)stats.framesWritten / kBenchSampleRate,
+               (unsigned long long)dropped, (unsigned long long)stats.overflows,
+               (unsigned long long)stats.writeErrors, ok ? "ok" : "MISMATCH");
+        unlink(paths[tap]);
+    }
+
+    // 1 CPU の環境では max に書き込みスレッドへの切り替えが入るので p99.9 も出す
+    uint64_t rank = totalBlocks - totalBlocks / 1000, seen = 0;
+    int p999 = 0;
+    while (p999 < kHistogramBuckets - 1 && (seen += histogram[p999]) < rank) {
+        p999++;
+    }
+    printf("push (%d taps)  mean %6.0f ns  p99.9 < %d us  max %8.0f ns\n", kPushedTaps,
+           (double)pushSum / (double)totalBlocks, p999 + 1, (double)pushMax);
+    printf("writer  %.1f MB in %.1f s wall (%.1f MB/s, %.0fx realtime), final stop %.1f ms  %s\n",
+           (double)bytes / 1e6, wallSeconds, (double)bytes / 1e6 / wallSeconds, audioSeconds / wallSeconds,
+           (double)stopNs / 1e6, allOk ? "ok" : "FAILED");
+
+    vc_tap_recorder_destroy(recorder);
+    vc_audio_ring_destroy(external);
+}
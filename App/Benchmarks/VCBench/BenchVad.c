@@ -0,0 +1,109 @@
+//
+//  BenchVad.c
+//  VoiceChanger Benchmarks
+//
+//  Voice activity detector: detection on a conversation-like speech/silence mix and chain cost
+//  with gating on / off
+//
+
+#include "BenchCommon.h"
+#include "VCCore.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define kAudioSeconds   20
+#define kTurnSeconds    2       // 2秒話して2秒黙る（相手の発言を聞いている区間）
+#define kNoiseBurstAmp  0.05f   // 黙っている区間に入れる広帯域ノイズ（-30 dBFS 程度）
+
+/// 発話中の区間なら 1（発話区間の中も bench_fill_voice の 250ms 音節 / 250ms 無音が続く）
+static int in_turn(int sample) {
+    return (sample / (kTurnSeconds * kBenchSampleRate)) % 2 == 0;
+}
+
+static int is_voiced(int sample) {
+    return in_turn(sample) && (sample / (kBenchSampleRate / 4)) % 2 == 0;
+}
+
+/// 話している区間は音声、黙っている区間は背景雑音のみ + 途中に 100ms のノイズバースト
+static void fill_conversation(float *samples, int total) {
+    bench_fill_voice(samples, total, kBenchSampleRate, 140.0f, 5);
+    uint32_t seed = 11;
+    int turn = kTurnSeconds * kBenchSampleRate;
+    for (int start = turn; start < total; start += 2 * turn) {
+        int frames = start + turn <= total ? turn : total - start;
+        bench_fill_noise(samples + start, frames, 0.003f, &seed);
+        bench_fill_noise(samples + start + turn / 2, kBenchSampleRate / 10, kNoiseBurstAmp, &seed);
+    }
+}
+
+static void bench_detection(const float *signal, int total, int blockSize) {
+    VCVad *vad = vc_vad_create(kBenchSampleRate);
+    int blocks = total / blockSize;
+    int voicedBlocks = 0, voicedHits = 0;
+    int silentBlocks = 0, silentHits = 0;
+    int skippedBlocks = 0;
+
+    uint64_t start = bench_now_ns();
+    for (int b = 0; b < blocks; b++) {
+        int offset = b * blockSize;
+        vc_vad_process(vad, signal + offset, blockSize);
+
+        VCVadState state;
+        vc_vad_get_state(vad, &state);
+        if (is_voiced(offset) && is_voiced(offset + blockSize - 1)) {
+            voicedBlocks++;
+            voicedHits += state.rawSpeech;
+        } else if (!is_voiced(offset) && !is_voiced(offset + blockSize - 1)) {
+            silentBlocks++;
+            silentHits += state.rawSpeech;
+        }
+        skippedBlocks += state.activity <= 0.0f;
+    }
+    double vadNs = (double)(bench_now_ns() - start) / blocks;
+
+    printf("block=%-4d vad %6.1f ns/block  speech hit %5.1f%%  false alarm %5.1f%%  heavy stages skipped %5.1f%%\n",
+           blockSize, vadNs, 100.0 * voicedHits / voicedBlocks, 100.0 * silentHits / silentBlocks,
+           100.0 * skippedBlocks / blocks);
+    vc_vad_destroy(vad);
+}
+
+static double chain_ns_per_block(const float *signal, float *work, int total, int blockSize, int vadEnabled) {
+    VCChain *chain = vc_chain_create(kBenchSampleRate);
+    VCChainParams params;
+    vc_chain_params_default(&params);
+    params.vadEnabled = vadEnabled;
+    vc_chain_set_params(chain, &params);
+
+    int blocks = total / blockSize;
+    uint64_t start = bench_now_ns();
+    for (int b = 0; b < blocks; b++) {
+        vc_chain_process(chain, signal + (size_t)b * blockSize, work + (size_t)b * blockSize, blockSize);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_consume(work, total);
+    vc_chain_destroy(chain);
+    return (double)elapsed / blocks;
+}
+
+void bench_vad(void) {
+    int total = kAudioSeconds * kBenchSampleRate;
+    float *signal = malloc((size_t)total * sizeof(float));
+    float *work = malloc((size_t)total * sizeof(float));
+    fill_conversation(signal, total);
+
+    static const int kBlockSizes[] = { 128, 256, 512 };
+    for (int s = 0; s < 3; s++) {
+        bench_detection(signal, total, kBlockSizes[s]);
+    }
+    for (int s = 0; s < 3; s++) {
+        int blockSize = kBlockSizes[s];
+        double blockUs = (double)blockSize / kBenchSampleRate * 1e6;
+        double off = chain_ns_per_block(signal, work, total, blockSize, 0);
+        double on = chain_ns_per_block(signal, work, total, blockSize, 1);
+        printf("block=%-4d chain vad off %7.1f ns/block (%.2f%%)  on %7.1f ns/block (%.2f%%)\n",
+               blockSize, off, off / (blockUs * 10.0), on, on / (blockUs * 10.0));
+    }
+
+    free(signal);
+    free(work);
+}
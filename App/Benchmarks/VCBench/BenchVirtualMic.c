@@ -0,0 +1,151 @@
+//
+//  BenchVirtualMic.c
+//  VoiceChanger Benchmarks
+//
+//  Multiple virtual mics: fan-out of one capture to N chains + shared rings, and the driver read per device
+//
+
+#include "BenchCommon.h"
+#include "VCCore.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define kAudioSeconds   10
+#define kBlockSize      256
+#define kRingCapacity   16384   // SharedMemoryConfig.capacity
+
+typedef struct {
+    VCChain *chains[VC_VIRTUAL_MIC_MAX];
+    void *memory[VC_VIRTUAL_MIC_MAX];
+    VCSharedRing rings[VC_VIRTUAL_MIC_MAX];
+} BenchMics;
+
+/// マイクごとに別のプリセット相当（ピッチ・EQ を変える）
+static void mics_create(BenchMics *mics, int count) {
+    size_t size = vc_shared_ring_size(kRingCapacity);
+    for (int mic = 0; mic < count; mic++) {
+        VCChainParams params;
+        vc_chain_params_default(&params);
+        params.pitchShift = (float)(mic % 3) * 2.0f;
+        params.eqHigh = (float)(mic % 2) * 3.0f;
+        params.multibandEnabled = mic % 2;
+        mics->chains[mic] = vc_chain_create(kBenchSampleRate);
+        vc_chain_set_params(mics->chains[mic], &params);
+        mics->memory[mic] = calloc(1, size);
+        vc_shared_ring_format(&mics->rings[mic], mics->memory[mic], size, kBenchSampleRate, kBlockSize, kRingCapacity);
+        vc_shared_ring_set_active(&mics->rings[mic], 1);
+    }
+}
+
+static void mics_destroy(BenchMics *mics, int count) {
+    for (int mic = 0; mic < count; mic++) {
+        vc_chain_destroy(mics->chains[mic]);
+        free(mics->memory[mic]);
+    }
+}
+
+/// ドライバの Mic_ReadInput と同じ読み方（リングの領域から HAL のバッファへ1回コピー）
+static void driver_read(VCSharedRing *ring, float *buffer, int count) {
+    VCRingRegions regions;
+    int granted = vc_shared_ring_read_regions(ring, count, &regions);
+    if (granted < count) {
+        memset(buffer, 0, (size_t)count * sizeof(float));
+        return;
+    }
+    memcpy(buffer, regions.first, (size_t)regions.firstCount * sizeof(float));
+    if (regions.secondCount > 0) {
+        memcpy(buffer + regions.firstCount, regions.second, (size_t)regions.secondCount * sizeof(float));
+    }
+    vc_shared_ring_commit_read(ring, granted);
+}
+
+/// 1 スレッドで順に処理した場合（並行化の基準）
+static double serial_ns_per_block(const float *signal, int total, int count) {
+    BenchMics mics;
+    mics_create(&mics, count);
+    float *output = malloc(kBlockSize * sizeof(float));
+    float *device = malloc(kBlockSize * sizeof(float));
+    int blocks = total / kBlockSize;
+
+    uint64_t start = bench_now_ns();
+    for (int b = 0; b < blocks; b++) {
+        const float *input = signal + (size_t)b * kBlockSize;
+        for (int mic = 0; mic < count; mic++) {
+            vc_chain_process(mics.chains[mic], input, output, kBlockSize);
+            vc_shared_ring_write(&mics.rings[mic], output, kBlockSize);
+            driver_read(&mics.rings[mic], device, kBlockSize);
+        }
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    bench_consume(device, kBlockSize);
+    free(output);
+    free(device);
+    mics_destroy(&mics, count);
+    return (double)elapsed / blocks;
+}
+
+/// VCMicFanout で並行に処理し、ドライバ側の読み出しは別に測る
+static void fanout_ns_per_block(const float *signal, int total, int count, double *outFanoutNs, double *outReadNs,
+                                uint64_t *outDropped) {
+    BenchMics mics;
+    mics_create(&mics, count);
+    VCMicFanout *fanout = vc_mic_fanout_create(kBlockSize, 0);
+    for (int mic = 0; mic < count; mic++) {
+        vc_mic_fanout_add(fanout, mics.chains[mic], &mics.rings[mic]);
+    }
+    float *device = malloc(kBlockSize * sizeof(float));
+    int blocks = total / kBlockSize;
+
+    uint64_t fanoutNs = 0, readNs = 0;
+    for (int b = 0; b < blocks; b++) {
+        uint64_t t0 = bench_now_ns();
+        vc_mic_fanout_process(fanout, signal + (size_t)b * kBlockSize, kBlockSize);
+        uint64_t t1 = bench_now_ns();
+        for (int mic = 0; mic < count; mic++) {
+            driver_read(&mics.rings[mic], device, kBlockSize);
+        }
+        uint64_t t2 = bench_now_ns();
+        fanoutNs += t1 - t0;
+        readNs += t2 - t1;
+    }
+
+    uint64_t dropped = 0;
+    for (int mic = 0; mic < count; mic++) {
+        VCMicFanoutStats stats;
+        vc_mic_fanout_get_stats(fanout, mic, &stats);
+        dropped += stats.droppedFrames;
+    }
+    bench_consume(device, kBlockSize);
+    free(device);
+    vc_mic_fanout_destroy(fanout);
+    mics_destroy(&mics, count);
+
+    *outFanoutNs = (double)fanoutNs / blocks;
+    *outReadNs = (double)readNs / blocks;
+    *outDropped = dropped;
+}
+
+void bench_virtual_mic(void) {
+    static const int kMicCounts[] = { 1, 2, 4, 8 };
+    int total = kAudioSeconds * kBenchSampleRate;
+    float *signal = malloc((size_t)total * sizeof(float));
+    bench_fill_voice(signal, total, kBenchSampleRate, 140.0f, 41);
+    double blockUs = (double)kBlockSize / kBenchSampleRate * 1e6;
+
+    printf("block=%d  cpus=%d\n", kBlockSize, vc_stream_pool_cpu_count());
+    for (int i = 0; i < (int)(sizeof(kMicCounts) / sizeof(kMicCounts[0])); i++) {
+        int count = kMicCounts[i];
+        double serialNs = serial_ns_per_block(signal, total, count);
+        double fanoutNs, readNs;
+        uint64_t dropped;
+        fanout_ns_per_block(signal, total, count, &fanoutNs, &readNs, &dropped);
+        printf("mics=%d  serial %8.1f ns/block (%5.2f%%)  fan-out %8.1f ns (%5.2f%%, x%.2f)  "
+               "per device %7.1f ns  driver read %5.1f ns/device  dropped %llu\n",
+               count, serialNs, serialNs / (blockUs * 10.0), fanoutNs, fanoutNs / (blockUs * 10.0),
+               serialNs / fanoutNs, fanoutNs / count, readNs / count, (unsigned long long)dropped);
+    }
+
+    free(signal);
+}
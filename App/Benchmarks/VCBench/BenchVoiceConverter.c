@@ -0,0 +1,207 @@
+//
+//  BenchVoiceConverter.c
+//  VoiceChanger Benchmarks
+//
+//  Neural voice conversion: x-realtime of int8 inference per model size (SIMD vs scalar kernels),
+//  cached activations vs recomputing the receptive field, and the look-ahead worker fed in real time
+//
+
+#include "BenchCommon.h"
+#include "VCCore.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define kBlockSize      256
+#define kAudioSeconds   4
+#define kPacedSeconds   2
+#define kLookAhead      2
+#define kRecomputeBlocks 16     // 計算し直す方式は受容野ぶん重いので、このブロック数だけ測る
+
+struct BenchVoiceConverter {
+    VCVoiceModel *model;
+    VCVoiceConverter *converter;
+};
+
+/// 名前から構成を決める（知らない名前なら -1）
+///   small:   128 チャンネル × 4 層、GRU 128
+///   default: vc_voice_model_config_default（256 × 6、GRU 256）
+///   large:   384 チャンネル × 8 層、GRU 384
+static int describe(const char *name, VCVoiceModelConfig *config) {
+    vc_voice_model_config_default(config);
+    if (strcmp(name, "small") == 0) {
+        config->channels = 128;
+        config->convLayers = 4;
+        config->hiddenSize = 128;
+    } else if (strcmp(name, "large") == 0) {
+        config->channels = 384;
+        config->convLayers = 8;
+        config->hiddenSize = 384;
+    } else if (strcmp(name, "default") != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+BenchVoiceConverter *bench_voice_converter_create(const char *name, int scalarKernels, int lookAheadFrames) {
+    VCVoiceModelConfig config;
+    if (describe(name, &config) != 0) {
+        return NULL;
+    }
+    // 乱数の重みを書き出して mmap で開く（ファイルはマップしたままでも消してよい）
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/vcbench-voice-%d.vcvm", (int)getpid());
+    VCVoiceModel *model = vc_voice_model_write_random(path, &config, 11) == 0 ? vc_voice_model_open(path) : NULL;
+    unlink(path);
+    if (model == NULL) {
+        return NULL;
+    }
+
+    VCVoiceConverterOptions options = { lookAheadFrames, scalarKernels };
+    BenchVoiceConverter *bench = calloc(1, sizeof(BenchVoiceConverter));
+    bench->model = model;
+    bench->converter = vc_voice_converter_create(model, &options);
+    if (bench->converter == NULL) {
+        bench_voice_converter_destroy(bench);
+        return NULL;
+    }
+    return bench;
+}
+
+void bench_voice_converter_process(void *converter, const float *input, float *output, int frames) {
+    vc_voice_converter_process(((BenchVoiceConverter *)converter)->converter, input, output, frames);
+}
+
+void bench_voice_converter_destroy(void *converter) {
+    BenchVoiceConverter *bench = converter;
+    if (bench == NULL) {
+        return;
+    }
+    vc_voice_converter_destroy(bench->converter);
+    vc_voice_model_close(bench->model);
+    free(bench);
+}
+
+static double ns_per_block(BenchVoiceConverter *bench, const float *signal, float *work, int total) {
+    int blocks = total / kBlockSize;
+    vc_voice_converter_reset(bench->converter);
+    uint64_t start = bench_now_ns();
+    for (int b = 0; b < blocks; b++) {
+        size_t offset = (size_t)b * kBlockSize;
+        vc_voice_converter_process(bench->converter, signal + offset, work + offset, kBlockSize);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_consume(work, total);
+    return (double)elapsed / blocks;
+}
+
+/// 状態を持たない実装の代わり: ブロックごとにリセットし、受容野ぶんの過去から計算し直す
+static double recompute_ns_per_block(BenchVoiceConverter *bench, const float *signal, float *work, int total,
+                                     int window) {
+    int first = (window + kBlockSize - 1) / kBlockSize;
+    int blocks = total / kBlockSize - first < kRecomputeBlocks ? total / kBlockSize - first : kRecomputeBlocks;
+    if (blocks <= 0) {
+        return 0.0;
+    }
+    uint64_t start = bench_now_ns();
+    for (int b = first; b < first + blocks; b++) {
+        size_t end = (size_t)(b + 1) * kBlockSize;
+        vc_voice_converter_reset(bench->converter);
+        vc_voice_converter_process(bench->converter, signal + end - window, work, window);
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+    bench_consume(work, window);
+    return (double)elapsed / blocks;
+}
+
+static void sleep_until(uint64_t deadlineNs) {
+    struct timespec ts = {
+        .tv_sec = (time_t)(deadlineNs / 1000000000ull),
+        .tv_nsec = (long)(deadlineNs % 1000000000ull),
+    };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+    }
+}
+
+/// 補助スレッドありで実時間に沿って供給し、オーディオスレッド側のコストと遅れを測る
+static void paced_run(BenchVoiceConverter *bench, const float *signal, float *work, int total) {
+    int blocks = total / kBlockSize;
+    uint64_t period = (uint64_t)kBlockSize * 1000000000ull / kBenchSampleRate;
+    uint64_t deadline = bench_now_ns();
+    uint64_t sum = 0, worst = 0;
+    for (int b = 0; b < blocks; b++) {
+        sleep_until(deadline);
+        deadline += period;
+        uint64_t start = bench_now_ns();
+        vc_voice_converter_process(bench->converter, signal + (size_t)b * kBlockSize, work + (size_t)b * kBlockSize,
+                                   kBlockSize);
+        uint64_t elapsed = bench_now_ns() - start;
+        sum += elapsed;
+        worst = elapsed > worst ? elapsed : worst;
+    }
+    bench_consume(work, total);
+    VCVoiceConverterStats stats;
+    vc_voice_converter_get_stats(bench->converter, &stats);
+    printf("  worker (look-ahead %d, +%d samples)  audio thread %7.1f ns/block max %8.1f ns  "
+           "frames %llu computed %llu late %llu\n",
+           kLookAhead, vc_voice_converter_latency(bench->converter), (double)sum / blocks, (double)worst,
+           (unsigned long long)stats.frames, (unsigned long long)stats.computed,
+           (unsigned long long)stats.lateFrames);
+}
+
+void bench_voice_converter(void) {
+    static const char *kModels[] = { "small", "default", "large" };
+    int total = kAudioSeconds * kBenchSampleRate / kBlockSize * kBlockSize;
+    float *signal = malloc((size_t)total * sizeof(float));
+    float *work = malloc((size_t)total * sizeof(float));
+    bench_fill_voice(signal, total, kBenchSampleRate, 140.0f, 31);
+    double blockNs = (double)kBlockSize / kBenchSampleRate * 1e9;
+    printf("block=%d, %d CPU(s)\n", kBlockSize, vc_stream_pool_cpu_count());
+
+    for (int m = 0; m < 3; m++) {
+        BenchVoiceConverter *simd = bench_voice_converter_create(kModels[m], 0, 0);
+        BenchVoiceConverter *scalar = bench_voice_converter_create(kModels[m], 1, 0);
+        if (simd == NULL || scalar == NULL) {
+            printf("%s: failed to write or open the model in /tmp\n", kModels[m]);
+            bench_voice_converter_destroy(simd);
+            bench_voice_converter_destroy(scalar);
+            continue;
+        }
+        VCVoiceModelConfig config;
+        vc_voice_model_get_config(simd->model, &config);
+        long macs = vc_voice_model_macs_per_frame(simd->model);
+        int framesPerBlock = kBlockSize / config.hop;
+
+        double simdNs = ns_per_block(simd, signal, work, total);
+        double scalarNs = ns_per_block(scalar, signal, work, total);
+        printf("%s: %d ch x %d layers, GRU %d, %zu KB int8 weights, %ld MACs/frame\n", kModels[m], config.channels,
+               config.convLayers, config.hiddenSize, vc_voice_model_weight_bytes(simd->model) / 1024, macs);
+        printf("  SIMD   %9.1f ns/block (%5.2f%%, %5.1fx realtime, %5.2f GMAC/s)\n", simdNs, 100.0 * simdNs / blockNs,
+               blockNs / simdNs, (double)macs * framesPerBlock / simdNs);
+        printf("  scalar %9.1f ns/block (%5.2f%%, %5.1fx realtime, %5.2f GMAC/s)\n", scalarNs,
+               100.0 * scalarNs / blockNs, blockNs / scalarNs, (double)macs * framesPerBlock / scalarNs);
+
+        // 受容野（dilation 2^l の conv の最も古いタップまで）+ 今回のブロック
+        int receptive = 1 + (config.kernelSize - 1) * ((1 << config.convLayers) - 1);
+        int window = (receptive + framesPerBlock) * config.hop;
+        double recomputeNs = recompute_ns_per_block(simd, signal, work, total, window);
+        printf("  recompute %d frames/block without cached state %9.1f ns/block (%5.1fx the cached cost)\n",
+               receptive + framesPerBlock, recomputeNs, recomputeNs / simdNs);
+
+        bench_voice_converter_destroy(simd);
+        bench_voice_converter_destroy(scalar);
+    }
+
+    // 補助スレッド（1 CPU では処理スレッドと同じコアを取り合う）
+    BenchVoiceConverter *worker = bench_voice_converter_create("default", 0, kLookAhead);
+    if (worker != NULL) {
+        int paced = kPacedSeconds * kBenchSampleRate / kBlockSize * kBlockSize;
+        paced_run(worker, signal, work, paced);
+        bench_voice_converter_destroy(worker);
+    }
+
+    free(signal);
+    free(work);
+}
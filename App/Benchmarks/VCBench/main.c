@@ -0,0 +1,74 @@
+//
+//  main.c
+//  VoiceChanger Benchmarks
+//
+//  Usage: VCBench [name ...]   (引数なしで全ベンチマーク)
+//         VCBench --suite [--quick] [--json out.json] [--baseline base.json] [--tolerance 0.25] [filter ...]
+//
+//  --suite は全カーネル × 128/256/512 フレーム・プリセットごとのチェーン・DSP グラフ・声質変換・リング・ドライバーの読み出しを
+//  同じ形で測り、JSON に書き出してベースラインと比べる（遅くなったケースがあれば終了コード 4）
+//
+
+#include "BenchCommon.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    const char *name;
+    BenchFunction function;
+} BenchEntry;
+
+static const BenchEntry kBenches[] = {
+    { "multistream", bench_multistream },
+    { "batch", bench_batch },
+    { "log", bench_log },
+    { "meter", bench_meter },
+    { "loopback", bench_loopback },
+    { "aec", bench_echo_canceller },
+    { "vad", bench_vad },
+    { "pitch", bench_pitch },
+    { "analysis", bench_analysis },
+    { "convolution", bench_convolution },
+    { "multiband", bench_multiband },
+    { "oversampling", bench_oversampling },
+    { "presetbank", bench_preset_bank },
+    { "virtualmic", bench_virtual_mic },
+    { "reattach", bench_reattach },
+    { "taprecorder", bench_tap_recorder },
+    { "graph", bench_graph },
+    { "neural", bench_voice_converter },
+    { "fastmath", bench_fast_math },
+    { "guard", bench_signal_guard },
+};
+
+static const int kBenchCount = (int)(sizeof(kBenches) / sizeof(kBenches[0]));
+
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "--suite") == 0) {
+        return bench_suite_main(argc - 2, argv + 2);
+    }
+
+    if (argc <= 1) {
+        for (int i = 0; i < kBenchCount; i++) {
+            printf("== %s ==\n", kBenches[i].name);
+            kBenches[i].function();
+        }
+        return 0;
+    }
+
+    for (int arg = 1; arg < argc; arg++) {
+        int found = 0;
+        for (int i = 0; i < kBenchCount; i++) {
+            if (strcmp(argv[arg], kBenches[i].name) == 0) {
+                printf("== %s ==\n", kBenches[i].name);
+                kBenches[i].function();
+                found = 1;
+            }
+        }
+        if (!found) {
+            fprintf(stderr, "Unknown benchmark: %s\n", argv[arg]);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -57,6 +57,12 @@ final class AppController: ObservableObject {
             lastError = error.localizedDescription
             logError("Failed to prepare AudioEngine: \(error)", category: .audio)
         }
+
+        if let path = presetBankPath(), FileManager.default.fileExists(atPath: path) {
+            if !(await audioEngine.setPresetBank(path: path)) {
+                logError("Preset bank is invalid, using built-in presets: \(path)", category: .audio)
+            }
+        }
     }
 
     func shutdown() {
@@ -124,6 +130,14 @@ final class AppController: ObservableObject {
             .store(in: &cancellables)
     }
 
+    private func presetBankPath() -> String? {
+        guard let support = FileManager.default.urls(for: .applicationSupportDirectory, in: .userDomainMask).first else {
+            return nil
+        }
+        return support.appendingPathComponent("VoiceChanger")
+            .appendingPathComponent(Constants.DSP.presetBankFileName).path
+    }
+
     private func loadSettings() {
         let settings = settingsStore.load()
         selectedInputDeviceId = settings.inputDeviceId
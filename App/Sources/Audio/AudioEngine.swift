@@ -5,6 +5,7 @@ import CoreAudio
 import AudioToolbox
 import DSP
 import Utilities
+import VCCore
 
 /// オーディオエンジンの状態
 public enum EngineState: String, Codable, Sendable {
@@ -40,7 +41,7 @@ extension EngineState {
 }
 
 /// レイテンシモード
-public enum LatencyMode: String, Codable, Sendable {
+public enum LatencyMode: String, Codable, Sendable, CaseIterable {
     case ultraLow    // 128 samples (~2.7ms)
     case balanced    // 256 samples (~5.3ms)
     case highQuality // 512 samples (~10.7ms)
@@ -52,15 +53,37 @@ public enum LatencyMode: String, Codable, Sendable {
         case .highQuality: return 512
         }
     }
+
+    /// 目標レイテンシ（ミリ秒。キャプチャから仮想マイクの受け渡しまで）
+    public var targetMs: Double {
+        switch self {
+        case .ultraLow: return Constants.Audio.LatencyTarget.ultraLow
+        case .balanced: return Constants.Audio.LatencyTarget.balanced
+        case .highQuality: return Constants.Audio.LatencyTarget.highQuality
+        }
+    }
+
+    /// 全モードの最大フレームサイズ（作業領域はこの大きさで一度だけ確保する）
+    /// 定数にしておく（計算すると初回アクセスで配列を作るため。frameSize と揃っていることはテストで確かめる）
+    public static let maxFrameSize = 512
 }
 
 /// エンジン統計情報
 public struct EngineStats: Sendable {
     public var inputLevelDb: Float = -60
     public var outputLevelDb: Float = -60
+    public var inputPeakDb: Float = -60
+    public var outputPeakDb: Float = -60
+    /// K特性ラウドネス（3s）
+    public var inputLoudnessLufs: Float = -60
+    public var outputLoudnessLufs: Float = -60
     public var cpuLoad: Float = 0
     public var xruns: Int = 0
     public var droppedFrames: Int = 0
+    /// オーディオスレッドで行われた VCCore の確保回数（0 であるべき）
+    public var realtimeAllocations: Int = 0
+    /// キャプチャから仮想マイク 0 の受け渡しまで
+    public var latency = LatencyStats()
 }
 
 /// オーディオエンジン
@@ -70,7 +93,7 @@ public final class AudioEngine: @unchecked Sendable {
     // MARK: - Properties
 
     private var state: EngineState = .idle
-    private var latencyMode: LatencyMode = .balanced
+    private var latencyMode: LatencyMode = .balanced  // lock で保護（処理キューと入力コールバックはキャプチャリングのブロック長を読む）
     private var currentPresetId: String = "default"
     private var inputDeviceId: AudioDeviceID = 0
     private var isMonitorEnabled: Bool = false
@@ -91,26 +114,70 @@ public final class AudioEngine: @unchecked Sendable {
 
     // Core Audio
     private var inputUnit: AudioComponentInstance?
-    private var inputBuffer: [Float] = []
 
-    // DSP
-    private let dspChain = DSPChain()
+    // 作業領域（prepare で最大 LatencyMode 分を一度だけ確保し、以降オーディオスレッドは確保しない）
+    private var arena: OpaquePointer?
+    private var planCache: OpaquePointer?
+    private var inputSamples: UnsafeMutablePointer<Float>?      // AudioUnitRender の書き込み先
+    private var processSamples: UnsafeMutablePointer<Float>?    // 処理キュー側の読み出し先（マイク 0 の DSP はここをインプレースで）
+    private var drySamples: UnsafeMutablePointer<Float>?        // 仮想マイク 1 以降が読む DSP 前のコピー
+    private var captureRing: OpaquePointer?                     // 入力コールバック → 処理キュー（SPSC）
+    private var captureSignal: DispatchSourceUserDataAdd?
+    private let captureBlocks = 8
+
+    // DSP（アクターは処理キューの上で動き、drainCapture から同期的に呼ぶ）
+    private let dspChain: DSPChain
 
-    // 共有メモリ出力
+    // 共有メモリ出力（仮想マイク 0）
     private let sharedMemoryOutput = SharedMemoryOutput()
 
+    // 仮想マイク 1 以降（同じキャプチャを別のプリセットで。処理キューからのみ触る）
+    private let virtualMics = VirtualMicFanout()
+
+    // モニター出力（ヘッドホン直出し）
+    private let monitorOutput = MonitorOutput()
+
+    // リスニング出力（仮想スピーカー → ヘッドホン）
+    private let listeningOutput = ListeningOutput()
+
+    // 録音タップ（DSP 前・DSP 後・ドライバー出力。prepare で一度だけ作り、録音していない間の push は何もしない）
+    private var captureRecorder: CaptureRecorder?
+    private var ioTraceRecorder: IOTraceRecorder?
+
+    // レイテンシ計測（prepare で一度だけ作る）
+    private var latencyProbe: LatencyProbe?
+
+    // エコー参照のスロット（DSPChain.setEchoReference）
+    private enum EchoSlot {
+        static let monitor = 0
+        static let listening = 1
+    }
+
     // スレッド
-    private let processingQueue = DispatchQueue(label: "com.voicechanger.audioengine", qos: .userInteractive)
+    private let processingQueue: DispatchSerialQueue
     private let lock = NSLock()
 
-    // 統計
-    private var lastStatsUpdate = Date()
-    private var frameCount: Int = 0
+    // レンダースレッド用ログ（wait-free、整形は Logger 側のバックグラウンドで行う）
+    private let renderLog = Logger.shared.makeRealtimeChannel(label: "render")
+
+    // 統計（メーターはDSPチェーン内でタップし、タイマーで読み出して配信する）
+    private var statsTimer: DispatchSourceTimer?
+    private let statsInterval: DispatchTimeInterval = .milliseconds(100)
 
     // MARK: - Initialization
 
     public init() {
-        inputBuffer = [Float](repeating: 0, count: latencyMode.frameSize)
+        let queue = DispatchSerialQueue(label: "com.voicechanger.audioengine", qos: .userInteractive)
+        processingQueue = queue
+        dspChain = DSPChain(queue: queue)
+    }
+
+    deinit {
+        // DSPChain はプランキャッシュを参照するだけで、破棄時には触らない
+        captureSignal?.cancel()
+        vc_audio_ring_destroy(captureRing)
+        vc_arena_destroy(arena)
+        vc_plan_cache_destroy(planCache)
     }
 
     // MARK: - Public Methods
@@ -131,9 +198,20 @@ public final class AudioEngine: @unchecked Sendable {
         // デフォルト入力デバイス取得
         inputDeviceId = try getDefaultInputDevice()
 
+        // 作業領域・FFT プラン（以降の処理・モード変更では確保しない）
+        try prepareBuffers()
+        await dspChain.prepare(planCache: planCache)
+
         // 共有メモリ接続
         try sharedMemoryOutput.connect()
 
+        // 仮想スピーカー側（失敗しても送話は続けられる）
+        do {
+            try listeningOutput.connect()
+        } catch {
+            logError("Listening connect failed: \(error.localizedDescription)", category: .audio)
+        }
+
         // AudioUnit設定
         try setupInputUnit()
 
@@ -156,6 +234,7 @@ public final class AudioEngine: @unchecked Sendable {
 
         // 共有メモリをアクティブに
         sharedMemoryOutput.activate()
+        processingQueue.async { self.virtualMics.activate() }
 
         // AudioUnit開始
         let status = AudioOutputUnitStart(inputUnit)
@@ -165,6 +244,8 @@ public final class AudioEngine: @unchecked Sendable {
 
         state = .running
         stateSubject.send(state)
+        startStatsTimer()
+        updateMonitor()
 
         logInfo("AudioEngine started", category: .audio)
     }
@@ -179,6 +260,9 @@ public final class AudioEngine: @unchecked Sendable {
         }
 
         sharedMemoryOutput.deactivate()
+        processingQueue.async { self.virtualMics.deactivate() }
+        stopStatsTimer()
+        stopMonitor()
 
         if state == .running {
             state = .armed
@@ -200,7 +284,13 @@ public final class AudioEngine: @unchecked Sendable {
             self.inputUnit = nil
         }
 
-        sharedMemoryOutput.disconnect()
+        captureRecorder?.stop()
+        ioTraceRecorder?.stop()
+        // 書き込み中のブロックが終わってから外す（drainCapture は ring を確かめた後、ブロックの終わりまで使う）
+        processingQueue.sync { sharedMemoryOutput.disconnect() }
+        processingQueue.async { self.virtualMics.removeAll() }
+        setEchoReference(nil, slot: EchoSlot.listening)
+        listeningOutput.disconnect()
 
         state = .idle
         stateSubject.send(state)
@@ -236,23 +326,199 @@ public final class AudioEngine: @unchecked Sendable {
         await dspChain.loadPreset(presetId)
     }
 
+    /// プリセットバンク設定（ファイルの更新は監視して自動で差し替える。nil で組み込みのみ）
+    @discardableResult
+    public func setPresetBank(path: String?) async -> Bool {
+        let opened = await dspChain.setPresetBank(path: path)
+        await dspChain.loadPreset(currentPresetId)
+        return opened
+    }
+
+    /// 仮想マイク 1 以降の有効化とプリセット（nil で無効）
+    /// マイク 0 と同じキャプチャを別のチェーンで処理し、ドライバの「VoiceChanger Virtual Mic \(mic + 1)」へ出す
+    public func setVirtualMic(_ mic: Int, preset: VoicePreset?) throws {
+        guard (1..<SharedMemoryConfig.micCount).contains(mic) else {
+            throw AudioEngineError.invalidState
+        }
+        // 処理キューでブロックの合間に切り替える
+        try processingQueue.sync {
+            try virtualMics.setMic(mic, preset: preset)
+        }
+    }
+
+    /// 録音開始（DSP 前・DSP 後・ドライバーが渡した音声を directory へ同時に録る）
+    /// - Returns: 録音するファイル
+    @discardableResult
+    public func startRecording(to directory: URL) throws -> [URL] {
+        guard let captureRecorder else { throw AudioEngineError.invalidState }
+        return try captureRecorder.start(directory: directory)
+    }
+
+    /// 録音停止
+    public func stopRecording() {
+        captureRecorder?.stop()
+    }
+
+    /// 録音タップの統計（直近の録音）
+    public func recordingStats() -> [CaptureRecorder.Stats] {
+        captureRecorder?.stats ?? []
+    }
+
+    /// IO トレース開始（ドライバーの IO 周期とアプリの書き込みを directory へ記録する。再生は VCReplay）
+    /// - Returns: 記録するファイル
+    @discardableResult
+    public func startIOTrace(to directory: URL) throws -> [URL] {
+        guard let ioTraceRecorder else { throw AudioEngineError.invalidState }
+        return try ioTraceRecorder.start(directory: directory)
+    }
+
+    /// IO トレース停止
+    public func stopIOTrace() {
+        ioTraceRecorder?.stop()
+    }
+
+    /// 校正マーカー（1 秒ごとに入力を短いトーンに置き換え、DSP の内部遅延を EngineStats.latency.markerDelayMs に出す）
+    public func setLatencyMarker(enabled: Bool) {
+        guard let latencyProbe else { return }
+        processingQueue.async { latencyProbe.setMarker(enabled: enabled) }
+    }
+
+    /// 仮想マイク 1 以降の統計
+    public func virtualMicStats() -> [VirtualMicFanout.Stats] {
+        processingQueue.sync { virtualMics.stats }
+    }
+
     /// レイテンシモード設定
     public func setLatencyMode(_ mode: LatencyMode) async {
+        // バッファは最大モード分を確保済みなので、動作中に切り替えても確保し直さない
         lock.lock()
         latencyMode = mode
-        inputBuffer = [Float](repeating: 0, count: mode.frameSize)
         lock.unlock()
+        // ブロック長と計測は処理キューのブロックの合間に切り替える（drainCapture・collect と同時に触らない）
+        // 入力コールバックはキャプチャリングに公開したブロック長を読む（latencyMode は読まない）
+        processingQueue.async {
+            if let captureRing = self.captureRing {
+                vc_audio_ring_set_block_size(captureRing, Int32(mode.frameSize))
+            }
+            self.latencyProbe?.reset()
+        }
 
         await dspChain.setFrameSize(mode.frameSize)
     }
 
     /// モニター設定
     public func setMonitor(enabled: Bool) {
+        lock.lock()
+        defer { lock.unlock() }
+
         isMonitorEnabled = enabled
+        updateMonitor()
+    }
+
+    /// リスニング設定（会議アプリの音声を DSP 経由でヘッドホンへ）
+    /// 送話の開始 / 停止とは独立して動く
+    public func setListening(enabled: Bool, preset: VoicePreset = .default) {
+        lock.lock()
+        defer { lock.unlock() }
+
+        guard enabled, state != .idle else {
+            // 参照を外し終えてから止める
+            setEchoReference(nil, slot: EchoSlot.listening)
+            listeningOutput.stop()
+            return
+        }
+
+        do {
+            try listeningOutput.setPreset(preset)
+            try listeningOutput.start()
+            setEchoReference(listeningOutput.echoReference, slot: EchoSlot.listening)
+        } catch {
+            logError("Listening start failed: \(error.localizedDescription)", category: .audio)
+        }
     }
 
     // MARK: - Private Methods
 
+    /// モニター出力の開始 / 停止（lock 保持中に呼ぶ）
+    /// タップの付け外しは処理キューでブロックの合間に、呼んだ順に反映する
+    private func updateMonitor() {
+        let dspChain = self.dspChain
+        let monitorOutput = self.monitorOutput
+
+        guard isMonitorEnabled, state == .running else {
+            stopMonitor()
+            return
+        }
+
+        do {
+            try monitorOutput.start(frameSize: latencyMode.frameSize)
+            processingQueue.async { dspChain.applyOutputTap(monitorOutput) }
+            setEchoReference(monitorOutput.echoReference, slot: EchoSlot.monitor)
+        } catch {
+            logError("Monitor start failed: \(error.localizedDescription)", category: .audio)
+        }
+    }
+
+    /// モニター出力の停止（lock 保持中に呼ぶ）
+    /// タップと参照を外し終えてから止めるので、以降のブロックは止めたモニターへ書かず、その参照も読まない
+    private func stopMonitor() {
+        let dspChain = self.dspChain
+        processingQueue.sync { dspChain.applyOutputTap(nil) }
+        setEchoReference(nil, slot: EchoSlot.monitor)
+        monitorOutput.stop()
+    }
+
+    /// 出力中の信号をエコーキャンセラの参照として付け外しする
+    /// 処理キューでブロックの合間に、呼んだ順に反映する。外すときは反映を待つ（戻った後は外した参照を読まない）
+    private func setEchoReference(_ reference: OpaquePointer?, slot: Int) {
+        let dspChain = self.dspChain
+        let apply = {
+            if !dspChain.applyEchoReference(reference, slot: slot) {
+                logError("Echo reference \(slot) could not be attached", category: .audio)
+            }
+        }
+        if reference == nil {
+            processingQueue.sync(execute: apply)
+        } else {
+            processingQueue.async(execute: apply)
+        }
+    }
+
+    /// 作業領域・キャプチャリング・プランキャッシュを作る（初回の prepare のみ）
+    func prepareBuffers() throws {
+        guard arena == nil else { return }
+
+        let maxFrames = LatencyMode.maxFrameSize
+        guard let arena = vc_arena_create(3 * maxFrames * MemoryLayout<Float>.size),
+              let planCache = vc_plan_cache_create(),
+              vc_plan_cache_prepare(planCache, Int32(maxFrames)) == 0,
+              let captureRing = vc_audio_ring_create(Int32(maxFrames * captureBlocks)),
+              let captureRecorder = CaptureRecorder(),
+              let ioTraceRecorder = IOTraceRecorder(),
+              let latencyProbe = LatencyProbe() else {
+            throw AudioEngineError.outOfMemory
+        }
+
+        self.arena = arena
+        self.planCache = planCache
+        self.captureRing = captureRing
+        self.captureRecorder = captureRecorder
+        self.ioTraceRecorder = ioTraceRecorder
+        self.latencyProbe = latencyProbe
+        vc_audio_ring_set_block_size(captureRing, Int32(latencyMode.frameSize))
+        inputSamples = vc_arena_floats(arena, Int32(maxFrames))
+        processSamples = vc_arena_floats(arena, Int32(maxFrames))
+        drySamples = vc_arena_floats(arena, Int32(maxFrames))
+
+        // コールバックからは add(data:) で起こすだけ（ブロックの確保・キュー投入をしない）
+        let signal = DispatchSource.makeUserDataAddSource(queue: processingQueue)
+        signal.setEventHandler { [weak self] in
+            self?.drainCapture()
+        }
+        signal.resume()
+        captureSignal = signal
+    }
+
     private func requestMicrophonePermission() async -> Bool {
         await withCheckedContinuation { continuation in
             AVCaptureDevice.requestAccess(for: .audio) { granted in
@@ -403,83 +669,160 @@ public final class AudioEngine: @unchecked Sendable {
     }
 
     /// オーディオ入力コールバックで呼ばれる処理
+    /// 確保済みの領域に取り込んでリングへ書くだけにし、DSP は処理キューで行う
     fileprivate func handleAudioInput(
+        ioActionFlags: UnsafeMutablePointer<AudioUnitRenderActionFlags>,
+        inTimeStamp: UnsafePointer<AudioTimeStamp>,
         inNumberFrames: UInt32,
         ioData: UnsafeMutablePointer<AudioBufferList>?
     ) {
-        guard let inputUnit = inputUnit else { return }
+        guard let inputUnit = inputUnit, let inputSamples = inputSamples, let captureRing = captureRing else {
+            return
+        }
+
+        vc_realtime_enter()
+        defer { vc_realtime_exit() }
+
+        let bufferSize = Int(inNumberFrames)
+        guard bufferSize <= LatencyMode.maxFrameSize else {
+            renderLog?.log(.inputBufferTooSmall, Double(bufferSize), Double(LatencyMode.maxFrameSize))
+            return
+        }
 
-        // バッファリスト作成
         var bufferList = AudioBufferList(
             mNumberBuffers: 1,
             mBuffers: AudioBuffer(
                 mNumberChannels: 1,
-                mDataByteSize: inNumberFrames * 4,
-                mData: nil
+                mDataByteSize: UInt32(bufferSize * MemoryLayout<Float>.size),
+                mData: UnsafeMutableRawPointer(inputSamples)
             )
         )
 
-        // バッファ確保
-        let bufferSize = Int(inNumberFrames)
-        if inputBuffer.count < bufferSize {
-            inputBuffer = [Float](repeating: 0, count: bufferSize)
-        }
-
-        inputBuffer.withUnsafeMutableBufferPointer { ptr in
-            bufferList.mBuffers.mData = UnsafeMutableRawPointer(ptr.baseAddress!)
-            bufferList.mBuffers.mDataByteSize = UInt32(bufferSize * MemoryLayout<Float>.size)
-
-            // 入力データ取得
-            var timeStamp = AudioTimeStamp()
-            let status = AudioUnitRender(
-                inputUnit,
-                nil,
-                &timeStamp,
-                1,  // Input element
-                inNumberFrames,
-                &bufferList
-            )
+        // 入力データ取得（コールバックの時刻をそのまま渡す）
+        let status = AudioUnitRender(
+            inputUnit,
+            ioActionFlags,
+            inTimeStamp,
+            1,  // Input element
+            inNumberFrames,
+            &bufferList
+        )
+
+        guard status == noErr else {
+            renderLog?.log(.renderFailed, Double(status))
+            return
+        }
+
+        captureRecorder?.push(.input, inputSamples, count: bufferSize)
 
-            guard status == noErr else { return }
+        // このブロックをキャプチャした時刻をリングの位置で覚えておく
+        if let latencyProbe {
+            var writeIndex: UInt32 = 0
+            var readIndex: UInt32 = 0
+            vc_shared_ring_indices(vc_audio_ring_view(captureRing), &writeIndex, &readIndex)
+            let hostTimeValid = inTimeStamp.pointee.mFlags.contains(.hostTimeValid)
+            latencyProbe.markCapture(index: writeIndex, hostTime: hostTimeValid ? inTimeStamp.pointee.mHostTime : mach_absolute_time())
         }
 
-        // DSP処理（非同期）
-        processingQueue.async { [weak self] in
-            guard let self = self else { return }
+        // 処理キューへ（溢れた分は捨てる）
+        let written = Int(vc_audio_ring_write(captureRing, inputSamples, Int32(bufferSize)))
+        if written < bufferSize {
+            let pending = Int(vc_audio_ring_available_read(captureRing)) / Int(vc_audio_ring_block_size(captureRing))
+            renderLog?.log(.processingBacklog, Double(pending))
+        }
+        captureSignal?.add(data: 1)
+    }
 
-            // AudioFrame作成
-            let samples = Array(self.inputBuffer.prefix(bufferSize))
-            var frame = AudioFrame(samples: samples, sampleRate: 48000)
+    /// 入力コールバックと同じくキャプチャリングへ書き、処理キューで DSP から共有メモリまで通す
+    /// デバイスなしで処理経路を動かす（テスト用。prepareBuffers の後に、処理キューの外から呼ぶ）
+    func processCapture(_ samples: UnsafePointer<Float>, count: Int) {
+        guard let captureRing else { return }
+        processingQueue.sync {
+            _ = vc_audio_ring_write(captureRing, samples, Int32(count))
+            drainCapture()
+        }
+    }
 
-            // DSP処理
-            Task {
-                await self.dspChain.process(&frame)
+    /// リングに溜まった入力をフレームサイズ（キャプチャリングに公開したブロック長）ごとに DSP へ渡す（処理キュー）
+    /// DSPChain はこのキューの上で動くので、processSamples をそのままインプレースで処理する（配列・Task を作らない）
+    private func drainCapture() {
+        guard let captureRing = captureRing, let processSamples = processSamples, let drySamples = drySamples else { return }
+
+        vc_realtime_enter()
+        defer { vc_realtime_exit() }
+
+        let frameSize = Int(vc_audio_ring_block_size(captureRing))
+        let latencyProbe = self.latencyProbe
+        let extraMics = !virtualMics.activeMics.isEmpty
+        while Int(vc_audio_ring_available_read(captureRing)) >= frameSize {
+            var writeIndex: UInt32 = 0
+            var readIndex: UInt32 = 0
+            vc_shared_ring_indices(vc_audio_ring_view(captureRing), &writeIndex, &readIndex)
+            let count = Int(vc_audio_ring_read(captureRing, processSamples, Int32(frameSize)))
+            latencyProbe?.injectMarker(processSamples, count: count)
+            let captureTime = latencyProbe?.captureTime(index: readIndex) ?? 0
+            if extraMics {
+                drySamples.update(from: processSamples, count: count)
+            }
 
-                // 共有メモリに書き込み
-                self.sharedMemoryOutput.write(frame.samples)
+            let block = UnsafeMutableBufferPointer(start: processSamples, count: count)
+            dspChain.process(inPlace: block)
+            captureRecorder?.push(.processed, processSamples, count: count)
+
+            // 共有メモリに書き込み（キャプチャ時刻を共有リングの位置に付け替え、書いた結果をそのまま IO トレースへ）
+            // 切断も処理キューで行うので、ここで確かめた ring はこのブロックの間ずっと有効
+            let ring = sharedMemoryOutput.isConnected ? sharedMemoryOutput.ring : nil
+            if let ring {
+                latencyProbe?.markOutput(ring: ring, captureTime: captureTime)
+                let written = sharedMemoryOutput.write(UnsafeBufferPointer(block))
+                ioTraceRecorder?.recordWrite(ring: ring, requested: count, written: written)
+            }
+            latencyProbe?.collect(ring: ring, processed: processSamples, count: count)
 
-                // 統計更新
-                self.updateStats(frame: frame)
+            // 仮想マイク 1 以降はマイク 0 を書いた後に、DSP 前のコピーを処理する
+            if extraMics {
+                virtualMics.process(drySamples, count: count)
             }
         }
     }
 
-    private func updateStats(frame: AudioFrame) {
-        // RMS計算（入力レベル）
-        let rms = sqrt(frame.samples.reduce(0) { $0 + $1 * $1 } / Float(frame.samples.count))
-        let db = 20 * log10(max(rms, 1e-10))
+    private func startStatsTimer() {
+        guard statsTimer == nil else { return }
 
-        stats.inputLevelDb = db
-        stats.outputLevelDb = db  // TODO: 出力後のレベル計算
+        let timer = DispatchSource.makeTimerSource(queue: .main)
+        timer.schedule(deadline: .now() + statsInterval, repeating: statsInterval)
+        timer.setEventHandler { [weak self] in
+            self?.publishStats()
+        }
+        timer.resume()
+        statsTimer = timer
+    }
 
-        frameCount += 1
+    private func stopStatsTimer() {
+        statsTimer?.cancel()
+        statsTimer = nil
+    }
 
-        // 100msごとに統計を更新
-        let now = Date()
-        if now.timeIntervalSince(lastStatsUpdate) >= 0.1 {
-            statsSubject.send(stats)
-            lastStatsUpdate = now
+    /// メーター読み出しと配信（メインキューのみ。メーターの読み手は常にこのタイマー1本）
+    private func publishStats() {
+        let input = dspChain.inputMeter.read()
+        let output = dspChain.outputMeter.read()
+
+        stats.inputLevelDb = input.rmsDb
+        stats.outputLevelDb = output.rmsDb
+        stats.inputPeakDb = input.peakDb
+        stats.outputPeakDb = output.peakDb
+        stats.inputLoudnessLufs = input.shortTermLufs
+        stats.outputLoudnessLufs = output.shortTermLufs
+        stats.realtimeAllocations = Int(vc_realtime_alloc_count())
+        if let latencyProbe {
+            lock.lock()
+            let targetMs = latencyMode.targetMs
+            lock.unlock()
+            stats.latency = latencyProbe.read(targetMs: targetMs)
         }
+
+        statsSubject.send(stats)
     }
 }
 
@@ -494,7 +837,7 @@ private func audioInputCallback(
     ioData: UnsafeMutablePointer<AudioBufferList>?
 ) -> OSStatus {
     let engine = Unmanaged<AudioEngine>.fromOpaque(inRefCon).takeUnretainedValue()
-    engine.handleAudioInput(inNumberFrames: inNumberFrames, ioData: ioData)
+    engine.handleAudioInput(ioActionFlags: ioActionFlags, inTimeStamp: inTimeStamp, inNumberFrames: inNumberFrames, ioData: ioData)
     return noErr
 }
 
@@ -506,6 +849,8 @@ public enum AudioEngineError: LocalizedError {
     case invalidState
     case audioUnitError(OSStatus)
     case sharedMemoryError(Error)
+    case outOfMemory
+    case recordingFailed
 
     public var errorDescription: String? {
         switch self {
@@ -519,6 +864,10 @@ public enum AudioEngineError: LocalizedError {
             return "Audio Unit error: \(status)"
         case .sharedMemoryError(let error):
             return "Shared memory error: \(error.localizedDescription)"
+        case .outOfMemory:
+            return "Failed to allocate audio buffers."
+        case .recordingFailed:
+            return "Failed to start recording."
         }
     }
 }
@@ -0,0 +1,166 @@
+import Foundation
+import Utilities
+import VCCore
+
+/// 録音タップ（DSP 前の入力・DSP 後の出力・ドライバーが渡した音声を同時にファイルへ）
+///
+/// 書き込み側（入力コールバック / 処理キュー）は push で事前確保したリングへコピーするだけで、
+/// ファイルへの書き込みは VCTapRecorder の背景スレッドがまとめて行う。録音していない間の push は何もしない。
+/// ドライバーの音声は共有メモリ（com.voicechanger.tap）を録音中だけ作成して受け取る。
+public final class CaptureRecorder: @unchecked Sendable {
+
+    // MARK: - Types
+
+    /// タップの位置（VCTapRecorder の tap 番号と同じ並び）
+    public enum Tap: Int, CaseIterable, Sendable {
+        case input      // DSP 前（AudioUnitRender の直後）
+        case processed  // DSP 後（仮想マイク 0 へ書く直前）
+        case delivered  // ドライバーが HAL に渡した音声（仮想マイク 0）
+
+        var fileSuffix: String {
+            switch self {
+            case .input: return "input"
+            case .processed: return "processed"
+            case .delivered: return "delivered"
+            }
+        }
+    }
+
+    /// タップごとの統計（録音を始めるたびに 0 に戻る）
+    public struct Stats: Sendable {
+        public var tap: Tap
+        public var framesWritten: UInt64
+        /// リングが満杯で捨てたフレーム数（書き込みスレッドが追いついていない）
+        public var droppedFrames: UInt64
+        public var overflows: UInt64
+        public var writeErrors: UInt64
+    }
+
+    // MARK: - Properties
+
+    /// 録音 1 回ぶんのリング（背景スレッドが 20ms ごとに読むので十分長くとる）
+    private static let ringSeconds = 2
+    private static let drainIntervalMs: Int32 = 20
+
+    private let recorder: OpaquePointer
+    private let sampleRate: Int
+    private let tapSegment = SharedMemorySegment(name: SharedMemoryConfig.tapName)
+    private let lock = NSLock()
+
+    public private(set) var isRecording = false
+
+    // MARK: - Initialization
+
+    public init?(sampleRate: Int = Constants.Audio.sampleRate) {
+        guard let recorder = vc_tap_recorder_create(Int32(sampleRate), Self.drainIntervalMs) else { return nil }
+        self.recorder = recorder
+        self.sampleRate = sampleRate
+
+        let ringFrames = Int32(sampleRate * Self.ringSeconds)
+        guard vc_tap_recorder_add(recorder, ringFrames) == Tap.input.rawValue,
+              vc_tap_recorder_add(recorder, ringFrames) == Tap.processed.rawValue,
+              vc_tap_recorder_add_ring(recorder, tapSegment.ring) == Tap.delivered.rawValue else {
+            vc_tap_recorder_destroy(recorder)
+            return nil
+        }
+    }
+
+    deinit {
+        vc_tap_recorder_destroy(recorder)
+    }
+
+    // MARK: - Public Methods
+
+    /// 録音開始（directory に capture-<日時>-<tap>.wav を作る）
+    /// ドライバーの区画を作れなければ delivered は録らずに続ける
+    /// - Returns: 録音するファイル
+    @discardableResult
+    public func start(directory: URL, format: VCTapFormat = VC_TAP_FORMAT_WAV) throws -> [URL] {
+        lock.lock()
+        defer { lock.unlock() }
+
+        guard !isRecording else { throw AudioEngineError.invalidState }
+
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+
+        do {
+            try tapSegment.create(
+                sampleRate: sampleRate,
+                frameSize: Int(SharedMemoryConfig.frameSize),
+                capacity: sampleRate.nextPowerOfTwo
+            )
+        } catch {
+            logError("Capture tap segment unavailable: \(error.localizedDescription)", category: .audio)
+        }
+
+        let formatter = DateFormatter()
+        formatter.dateFormat = "yyyyMMdd-HHmmss"
+        let stamp = formatter.string(from: Date())
+        let fileExtension = format == VC_TAP_FORMAT_WAV ? "wav" : "f32"
+        let urls = Tap.allCases.map { tap in
+            directory.appendingPathComponent("capture-\(stamp)-\(tap.fileSuffix).\(fileExtension)")
+        }
+
+        let paths = urls.map { strdup($0.path) }
+        defer { paths.forEach { free($0) } }
+        let pathPointers = paths.map { UnsafePointer<CChar>($0) }
+        guard vc_tap_recorder_start(recorder, pathPointers, format) == 0 else {
+            tapSegment.unmap()
+            throw AudioEngineError.recordingFailed
+        }
+
+        isRecording = true
+        logInfo("Capture recording started: \(directory.path)", category: .audio)
+        return tapSegment.isMapped ? urls : Array(urls.prefix(Tap.delivered.rawValue))
+    }
+
+    /// 録音停止（残りを書き出してファイルを閉じる）
+    public func stop() {
+        lock.lock()
+        defer { lock.unlock() }
+
+        guard isRecording else { return }
+
+        vc_tap_recorder_stop(recorder)
+        tapSegment.unmap()
+        isRecording = false
+
+        for stats in stats where stats.droppedFrames > 0 || stats.writeErrors > 0 {
+            logWarning("Capture \(stats.tap.fileSuffix): dropped \(stats.droppedFrames) frames, \(stats.writeErrors) write errors",
+                       category: .audio)
+        }
+        logInfo("Capture recording stopped", category: .audio)
+    }
+
+    /// タップへ書き込む（タップごとに書き込み側は1つだけ。順序はその書き込み側が push した順）
+    /// input は入力コールバック、processed は処理キューの drainCapture が DSP の直後に呼ぶ（Task などから呼ばないこと）
+    @inline(__always)
+    public func push(_ tap: Tap, _ samples: UnsafePointer<Float>, count: Int) {
+        vc_tap_recorder_push(recorder, Int32(tap.rawValue), samples, Int32(count))
+    }
+
+    public var stats: [Stats] {
+        Tap.allCases.map { tap in
+            var raw = VCTapStats()
+            vc_tap_recorder_get_stats(recorder, Int32(tap.rawValue), &raw)
+            return Stats(
+                tap: tap,
+                framesWritten: raw.framesWritten,
+                droppedFrames: raw.droppedFrames,
+                overflows: raw.overflows,
+                writeErrors: raw.writeErrors
+            )
+        }
+    }
+}
+
+private extension Int {
+    /// 2 のべき乗への切り上げ（共有リングの容量）
+    var nextPowerOfTwo: Int {
+        var value = 1
+        while value < self {
+            value <<= 1
+        }
+        return value
+    }
+}
@@ -0,0 +1,148 @@
+import Foundation
+import Utilities
+import VCCore
+
+/// IO トレース（ドライバーの IO 周期とアプリの書き込みを VCIOTrace のレコードでファイルへ）
+///
+/// ドライバーは仮想マイク 0 の ReadInput / GetZeroTimeStamp ごとに共有メモリ（com.voicechanger.iotrace）へ
+/// レコードを書き、アプリは仮想マイク 0 のリングへ書くたびに APP_WRITE を積む。
+/// 2 つのファイルは VCReplay がホスト時刻順に混ぜて再生する（Linux でも動く）。
+/// 記録していない間の recordWrite は何もしない。
+public final class IOTraceRecorder: @unchecked Sendable {
+
+    // MARK: - Types
+
+    /// トレースの出どころ（VCTapRecorder の tap 番号と同じ並び）
+    public enum Source: Int, CaseIterable, Sendable {
+        case driver     // ドライバーの IO 周期（共有メモリ経由）
+        case app        // アプリの書き込み
+
+        var fileSuffix: String {
+            switch self {
+            case .driver: return "driver"
+            case .app: return "app"
+            }
+        }
+    }
+
+    // MARK: - Properties
+
+    /// 1 秒あたり IO 周期とゼロタイムスタンプで数百レコード。背景スレッドが 20ms ごとに読むので十分余裕がある
+    private static let ringRecords = 8192
+    private static let drainIntervalMs: Int32 = 20
+
+    private let recorder: OpaquePointer
+    private let sampleRate: Int
+    private let traceSegment = SharedMemorySegment(name: SharedMemoryConfig.traceName)
+    private let lock = NSLock()
+
+    public private(set) var isRecording = false
+
+    // MARK: - Initialization
+
+    public init?(sampleRate: Int = Constants.Audio.sampleRate) {
+        guard let recorder = vc_tap_recorder_create(Int32(sampleRate), Self.drainIntervalMs) else { return nil }
+        self.recorder = recorder
+        self.sampleRate = sampleRate
+
+        let ringFloats = Int32(Self.ringRecords * Int(VC_IO_TRACE_RECORD_FLOATS))
+        guard vc_tap_recorder_add_ring(recorder, traceSegment.ring) == Source.driver.rawValue,
+              vc_tap_recorder_add(recorder, ringFloats) == Source.app.rawValue else {
+            vc_tap_recorder_destroy(recorder)
+            return nil
+        }
+    }
+
+    deinit {
+        vc_tap_recorder_destroy(recorder)
+    }
+
+    // MARK: - Public Methods
+
+    /// 記録開始（directory に iotrace-<日時>-<source>.vctrace を作る）
+    /// ドライバーの区画を作れなければアプリ側だけ記録する
+    /// - Returns: 記録するファイル
+    @discardableResult
+    public func start(directory: URL) throws -> [URL] {
+        lock.lock()
+        defer { lock.unlock() }
+
+        guard !isRecording else { throw AudioEngineError.invalidState }
+
+        try FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+
+        do {
+            try traceSegment.create(
+                sampleRate: sampleRate,
+                frameSize: Int(VC_IO_TRACE_RECORD_FLOATS),
+                capacity: Self.ringRecords * Int(VC_IO_TRACE_RECORD_FLOATS)
+            )
+        } catch {
+            logError("IO trace segment unavailable: \(error.localizedDescription)", category: .audio)
+        }
+
+        let formatter = DateFormatter()
+        formatter.dateFormat = "yyyyMMdd-HHmmss"
+        let stamp = formatter.string(from: Date())
+        let urls = Source.allCases.map { source in
+            directory.appendingPathComponent("iotrace-\(stamp)-\(source.fileSuffix).vctrace")
+        }
+
+        // ドライバーの区画がなければ driver のファイルは作らない（NULL で飛ばす）
+        let paths = urls.enumerated().map { index, url in
+            index == Source.driver.rawValue && !traceSegment.isMapped ? nil : strdup(url.path)
+        }
+        defer { paths.forEach { free($0) } }
+        let pathPointers = paths.map { $0.map { UnsafePointer<CChar>($0) } }
+        guard vc_tap_recorder_start(recorder, pathPointers, VC_TAP_FORMAT_RAW) == 0 else {
+            traceSegment.unmap()
+            throw AudioEngineError.recordingFailed
+        }
+
+        isRecording = true
+        logInfo("IO trace started: \(directory.path)", category: .audio)
+        return traceSegment.isMapped ? urls : [urls[Source.app.rawValue]]
+    }
+
+    /// 記録停止（残りを書き出してファイルを閉じる）
+    public func stop() {
+        lock.lock()
+        defer { lock.unlock() }
+
+        guard isRecording else { return }
+
+        vc_tap_recorder_stop(recorder)
+        traceSegment.unmap()
+        isRecording = false
+
+        for source in Source.allCases {
+            var stats = VCTapStats()
+            vc_tap_recorder_get_stats(recorder, Int32(source.rawValue), &stats)
+            if stats.droppedFrames > 0 || stats.writeErrors > 0 {
+                logWarning("IO trace \(source.fileSuffix): dropped \(stats.droppedFrames / UInt64(VC_IO_TRACE_RECORD_FLOATS)) records, \(stats.writeErrors) write errors",
+                           category: .audio)
+            }
+        }
+        logInfo("IO trace stopped", category: .audio)
+    }
+
+    /// アプリが仮想マイク 0 のリングへ書いたことを記録する（書き込み側は1つだけ）
+    /// 処理キューの drainCapture が SharedMemoryOutput.write の直後に、同じ ring と結果で呼ぶ（記録の順 = 書いた順）
+    /// - Parameters:
+    ///   - ring: 書いたリング（インデックスは書いた後の値を記録する）
+    ///   - requested: 書こうとしたフレーム数
+    ///   - written: 書けたフレーム数
+    public func recordWrite(ring: UnsafeMutablePointer<VCSharedRing>, requested: Int, written: Int) {
+        var record = VCIOTraceRecord()
+        record.hostTime = mach_absolute_time()
+        record.kind = UInt16(VC_IO_TRACE_APP_WRITE.rawValue)
+        record.frames = UInt32(written)
+        record.value = UInt64(requested)
+        vc_shared_ring_indices(ring, &record.writeIndex, &record.readIndex)
+
+        withUnsafeBytes(of: record) { bytes in
+            let words = bytes.bindMemory(to: Float.self)
+            vc_tap_recorder_push(recorder, Int32(Source.app.rawValue), words.baseAddress, Int32(words.count))
+        }
+    }
+}
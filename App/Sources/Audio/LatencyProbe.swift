@@ -0,0 +1,162 @@
+import Foundation
+import Utilities
+import VCCore
+
+/// レイテンシの統計（EngineStats.latency）
+public struct LatencyStats: Sendable {
+    /// 測った受け渡しの数
+    public var count: Int = 0
+    public var minMs: Double = 0
+    public var meanMs: Double = 0
+    public var p50Ms: Double = 0
+    public var p95Ms: Double = 0
+    public var p99Ms: Double = 0
+    public var maxMs: Double = 0
+    /// 1ms 刻みのヒストグラム（VC_LATENCY_BINS 個）
+    public var histogram: [UInt32] = []
+    /// ヒストグラムの範囲を超えた数
+    public var overflow: Int = 0
+    /// 今のレイテンシモードの目標（Constants.Audio.LatencyTarget）
+    public var targetMs: Double = 0
+    /// 目標を超えた割合（0〜1）
+    public var overTargetFraction: Double = 0
+    /// 校正マーカーで測った DSP の内部遅延（マーカー無効 / 未計測なら nil）
+    public var markerDelayMs: Double?
+    public var markerMisses: Int = 0
+}
+
+/// エンドツーエンドのレイテンシ計測（マイクのキャプチャ → DSP → 仮想マイク 0 がクライアントへ渡すまで）
+///
+/// キャプチャの時刻はキャプチャリングの位置に、DSP 後はその時刻を共有リングの位置に付け替えて運ぶ。
+/// ドライバーは ReadInput のたびに「どの位置をいつ渡したか」を共有リングのヘッダーに刻印するので、
+/// 処理キューが共有リングへ書くたびにそれを読んで差をヒストグラムに数える。
+/// 数える側（markOutput / collect / reset / setMarker）はすべて処理キューから、DSP と同じ順序で呼ぶこと。
+/// DSP の内部遅延（ルックアヘッドなど）は位置では見えないので、校正マーカーで別に測る。
+public final class LatencyProbe: @unchecked Sendable {
+
+    // MARK: - Properties
+
+    private static let timelineCapacity: Int32 = 64
+    private static let markerIntervalMs = 1000.0
+
+    private let captureTimeline: OpaquePointer     // キャプチャリングの位置 → キャプチャ時刻（入力コールバックが mark）
+    private let outputTimeline: OpaquePointer      // 共有リングの位置 → キャプチャ時刻（処理キューが mark）
+    private let probe: OpaquePointer
+    private let marker: OpaquePointer
+
+    // 処理キューのみ
+    private var lastDeliveryIndex: UInt32?
+
+    // 処理キューが書いてタイマーが読む（NaN = 未計測。8 バイト 1 語なので読み違いは問題にならない）
+    private var markerDelayMs = Double.nan
+
+    // MARK: - Initialization
+
+    public init?(sampleRate: Int = Constants.Audio.sampleRate) {
+        var timebase = mach_timebase_info_data_t()
+        mach_timebase_info(&timebase)
+        let hostTicksPerMs = 1e6 * Double(timebase.denom) / Double(timebase.numer)
+        let hostTicksPerFrame = hostTicksPerMs * 1000 / Double(sampleRate)
+
+        guard let captureTimeline = vc_latency_timeline_create(Self.timelineCapacity, hostTicksPerFrame),
+              let outputTimeline = vc_latency_timeline_create(Self.timelineCapacity, hostTicksPerFrame),
+              let probe = vc_latency_probe_create(hostTicksPerMs),
+              let marker = vc_latency_marker_create(Int32(sampleRate), Self.markerIntervalMs) else {
+            return nil
+        }
+        self.captureTimeline = captureTimeline
+        self.outputTimeline = outputTimeline
+        self.probe = probe
+        self.marker = marker
+    }
+
+    deinit {
+        vc_latency_timeline_destroy(captureTimeline)
+        vc_latency_timeline_destroy(outputTimeline)
+        vc_latency_probe_destroy(probe)
+        vc_latency_marker_destroy(marker)
+    }
+
+    // MARK: - Audio Thread
+
+    /// 入力コールバック: キャプチャリングの writeIndex から書くブロックの時刻
+    func markCapture(index: UInt32, hostTime: UInt64) {
+        vc_latency_timeline_mark(captureTimeline, index, hostTime)
+    }
+
+    /// 処理キュー: キャプチャリングの readIndex から読むブロックのキャプチャ時刻（分からなければ 0）
+    func captureTime(index: UInt32) -> UInt64 {
+        var hostTime: UInt64 = 0
+        return vc_latency_timeline_lookup(captureTimeline, index, &hostTime) != 0 ? hostTime : 0
+    }
+
+    /// 処理キュー: DSP に渡す前（無効なら位置を進めるだけ）
+    func injectMarker(_ samples: UnsafeMutablePointer<Float>, count: Int) {
+        vc_latency_marker_inject(marker, samples, Int32(count))
+    }
+
+    /// 処理キュー: 共有リングへ書く直前に、書くブロックのキャプチャ時刻を付ける
+    func markOutput(ring: UnsafeMutablePointer<VCSharedRing>, captureTime: UInt64) {
+        guard captureTime != 0 else { return }
+        var writeIndex: UInt32 = 0
+        var readIndex: UInt32 = 0
+        vc_shared_ring_indices(ring, &writeIndex, &readIndex)
+        vc_latency_timeline_mark(outputTimeline, writeIndex, captureTime)
+    }
+
+    /// 処理キュー: 書いた後にドライバーの刻印を見て、新しければ数える。DSP 後の音からマーカーを探す
+    func collect(ring: UnsafeMutablePointer<VCSharedRing>?, processed: UnsafePointer<Float>, count: Int) {
+        var delayMs = 0.0
+        if vc_latency_marker_detect(marker, processed, Int32(count), &delayMs) != 0 {
+            markerDelayMs = delayMs
+        }
+
+        guard let ring else { return }
+        var index: UInt32 = 0
+        var deliveredHostTime: UInt64 = 0
+        guard vc_shared_ring_delivery(ring, &index, &deliveredHostTime) != 0, index != lastDeliveryIndex else { return }
+        lastDeliveryIndex = index
+
+        var captureHostTime: UInt64 = 0
+        if vc_latency_timeline_lookup(outputTimeline, index, &captureHostTime) != 0 {
+            vc_latency_probe_record(probe, captureHostTime, deliveredHostTime)
+        }
+    }
+
+    // MARK: - Public Methods
+
+    /// 校正マーカー（入力の一部を 1 秒ごとに短いトーンに置き換える。通話中は使わないこと。処理キューから）
+    public func setMarker(enabled: Bool) {
+        vc_latency_marker_set_enabled(marker, enabled ? 1 : 0)
+        if !enabled {
+            markerDelayMs = .nan
+        }
+    }
+
+    /// 統計を読む（どのスレッドからでも）
+    public func read(targetMs: Double) -> LatencyStats {
+        var raw = VCLatencyStats()
+        vc_latency_probe_read(probe, &raw)
+
+        var stats = LatencyStats()
+        stats.count = Int(raw.count)
+        stats.minMs = raw.minMs
+        stats.meanMs = raw.meanMs
+        stats.p50Ms = raw.p50Ms
+        stats.p95Ms = raw.p95Ms
+        stats.p99Ms = raw.p99Ms
+        stats.maxMs = raw.maxMs
+        stats.histogram = withUnsafeBytes(of: raw.bins) { Array($0.bindMemory(to: UInt32.self)) }
+        stats.overflow = Int(raw.overflow)
+        stats.targetMs = targetMs
+        stats.overTargetFraction = vc_latency_stats_fraction_over(&raw, targetMs)
+        stats.markerDelayMs = markerDelayMs.isNaN ? nil : markerDelayMs
+        stats.markerMisses = Int(vc_latency_marker_misses(marker))
+        return stats
+    }
+
+    /// 0 に戻す（レイテンシモードを変えたときなど。処理キューから呼び、ブロックの合間に戻す）
+    public func reset() {
+        vc_latency_probe_reset(probe)
+    }
+}
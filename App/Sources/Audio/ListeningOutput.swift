@@ -0,0 +1,243 @@
+import Foundation
+import CoreAudio
+import AudioToolbox
+import DSP
+import Utilities
+import VCCore
+
+/// リスニング出力（会議アプリ → Virtual Speaker → App → DSP → ヘッドホン）
+///
+/// 仮想スピーカーの共有リングは App が作成し、ドライバーが WriteMix で書き込む。
+/// 読み出しは VCMonitor を共有リングに接続して行うので、ドライバーと出力デバイスの
+/// クロック差は仮想マイクのモニターと同じ仕組みで吸収される。
+/// ヘッドホンへ出した信号は echoReference に流す（スピーカー使用時のエコーキャンセル用）。
+public final class ListeningOutput: @unchecked Sendable {
+
+    // MARK: - Properties
+
+    private let sampleRate: Double
+    private let segment = SharedMemorySegment(name: SharedMemoryConfig.speakerName)
+
+    /// 出力した信号の参照（DSPChain.setEchoReference に渡す）。接続し直しても同じものを使う
+    public let echoReference: OpaquePointer
+
+    /// レンダースレッドが参照する状態（出力 AudioUnit より長く生存させる）
+    private var renderState: ListeningRenderState?
+
+    private var outputUnit: AudioComponentInstance?
+    private var preset: VoicePreset = .default
+
+    public private(set) var isConnected: Bool = false
+    public private(set) var isRunning: Bool = false
+
+    private let lock = NSLock()
+
+    // MARK: - Initialization
+
+    public init(sampleRate: Int = Constants.Audio.sampleRate) {
+        self.sampleRate = Double(sampleRate)
+        self.echoReference = makeEchoReference(sampleRate: sampleRate)
+    }
+
+    deinit {
+        disconnect()
+        vc_monitor_destroy(echoReference)
+    }
+
+    // MARK: - Public Methods
+
+    /// 仮想スピーカー用の共有メモリを作成（ドライバーの StartIO より前に呼ぶ）
+    public func connect() throws {
+        lock.lock()
+        defer { lock.unlock() }
+
+        guard !isConnected else { return }
+
+        try segment.create(
+            sampleRate: Int(sampleRate),
+            frameSize: Int(SharedMemoryConfig.frameSize),
+            capacity: SharedMemoryConfig.capacity
+        )
+
+        let target = Int32(Constants.Audio.Monitor.targetLatencyMs * sampleRate / 1000)
+        guard let state = ListeningRenderState(
+            ring: segment.ring,
+            echoReference: echoReference,
+            sampleRate: Int(sampleRate),
+            target: target
+        ) else {
+            segment.unmap()
+            throw SharedMemoryError.invalidLayout
+        }
+        var params = preset.chainParams
+        vc_chain_set_params(state.chain, &params)
+
+        renderState = state
+        isConnected = true
+    }
+
+    /// 切断（名前付き共有メモリは残す）
+    public func disconnect() {
+        stop()
+
+        lock.lock()
+        defer { lock.unlock() }
+
+        guard isConnected else { return }
+
+        renderState = nil
+        segment.unmap()
+        isConnected = false
+    }
+
+    /// 出力開始
+    public func start() throws {
+        lock.lock()
+        defer { lock.unlock() }
+
+        guard !isRunning else { return }
+        guard let state = renderState else {
+            throw SharedMemoryError.notConnected
+        }
+
+        if outputUnit == nil {
+            outputUnit = try makeStereoOutputUnit(
+                sampleRate: sampleRate,
+                renderProc: listeningRenderCallback,
+                refCon: Unmanaged.passUnretained(state).toOpaque()
+            )
+        }
+        guard let outputUnit = outputUnit else {
+            throw AudioEngineError.invalidState
+        }
+
+        // ドライバーの IO 周期と出力デバイスのバッファを両方吸収できる目標遅延
+        let deviceFrames = outputUnitBufferFrameSize(outputUnit)
+        let requested = Int(Constants.Audio.Monitor.targetLatencyMs * sampleRate / 1000)
+        let target = max(requested, Int(SharedMemoryConfig.frameSize) + deviceFrames)
+        vc_monitor_restart(state.monitor, Int32(target))
+        vc_chain_reset(state.chain)
+
+        let status = AudioOutputUnitStart(outputUnit)
+        guard status == noErr else {
+            throw AudioEngineError.audioUnitError(status)
+        }
+
+        isRunning = true
+        logInfo("Listening started (target \(target) frames)", category: .audio)
+    }
+
+    /// 出力停止
+    public func stop() {
+        lock.lock()
+        defer { lock.unlock() }
+
+        guard let outputUnit = outputUnit else { return }
+
+        if isRunning {
+            AudioOutputUnitStop(outputUnit)
+            isRunning = false
+        }
+        AudioUnitUninitialize(outputUnit)
+        AudioComponentInstanceDispose(outputUnit)
+        self.outputUnit = nil
+
+        logInfo("Listening stopped", category: .audio)
+    }
+
+    /// 受話側に掛けるプリセット（レンダー中は切り替えないため、動作中なら出力を再起動する）
+    public func setPreset(_ preset: VoicePreset) throws {
+        let wasRunning = isRunning
+        if wasRunning {
+            stop()
+        }
+
+        lock.lock()
+        self.preset = preset
+        if let state = renderState {
+            var params = preset.chainParams
+            vc_chain_set_params(state.chain, &params)
+        }
+        lock.unlock()
+
+        if wasRunning {
+            try start()
+        }
+    }
+
+    /// 統計
+    public var stats: VCMonitorStats {
+        var stats = VCMonitorStats()
+        lock.lock()
+        if let state = renderState {
+            vc_monitor_get_stats(state.monitor, &stats)
+        }
+        lock.unlock()
+        return stats
+    }
+}
+
+// MARK: - Render State
+
+/// レンダーコールバック用（不変参照のみ）
+private final class ListeningRenderState {
+    let ring: UnsafeMutablePointer<VCSharedRing>
+    let monitor: OpaquePointer
+    let chain: OpaquePointer
+    let echoReference: OpaquePointer  // ListeningOutput が所有
+
+    init?(ring: UnsafeMutablePointer<VCSharedRing>, echoReference: OpaquePointer, sampleRate: Int, target: Int32) {
+        guard let monitor = vc_monitor_create_attached(ring, target) else { return nil }
+        guard let chain = vc_chain_create(Int32(sampleRate)) else {
+            vc_monitor_destroy(monitor)
+            return nil
+        }
+        self.ring = ring
+        self.monitor = monitor
+        self.chain = chain
+        self.echoReference = echoReference
+    }
+
+    deinit {
+        vc_chain_destroy(chain)
+        vc_monitor_destroy(monitor)
+    }
+}
+
+// MARK: - Render Callback
+
+/// 出力スレッド: 共有リング → DSP → 左右（ロック・確保なし）
+private func listeningRenderCallback(
+    inRefCon: UnsafeMutableRawPointer,
+    ioActionFlags: UnsafeMutablePointer<AudioUnitRenderActionFlags>,
+    inTimeStamp: UnsafePointer<AudioTimeStamp>,
+    inBusNumber: UInt32,
+    inNumberFrames: UInt32,
+    ioData: UnsafeMutablePointer<AudioBufferList>?
+) -> OSStatus {
+    guard let ioData = ioData else { return noErr }
+
+    let state = Unmanaged<ListeningRenderState>.fromOpaque(inRefCon).takeUnretainedValue()
+    let buffers = UnsafeMutableAudioBufferListPointer(ioData)
+    guard let left = buffers.first?.mData?.assumingMemoryBound(to: Float.self) else {
+        return noErr
+    }
+    let count = Int32(inNumberFrames)
+
+    if vc_shared_ring_is_active(state.ring) != 0 {
+        vc_monitor_pull(state.monitor, left, count)
+        vc_chain_process(state.chain, left, left, count)
+    } else {
+        // 会議アプリが再生していない
+        left.update(repeating: 0, count: Int(inNumberFrames))
+        ioActionFlags.pointee.insert(.unitRenderAction_OutputIsSilence)
+    }
+    vc_monitor_push(state.echoReference, left, count)
+
+    for index in 1..<buffers.count {
+        if let data = buffers[index].mData {
+            data.copyMemory(from: left, byteCount: Int(inNumberFrames) * MemoryLayout<Float>.size)
+        }
+    }
+    return noErr
+}
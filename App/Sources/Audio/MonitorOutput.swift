@@ -0,0 +1,275 @@
+import Foundation
+import CoreAudio
+import AudioToolbox
+import DSP
+import Utilities
+import VCCore
+
+/// モニター出力（DSP後の音声を既定の出力デバイスへ直接出す）
+///
+/// 仮想マイク経由の往復を通らず、DSPChain の出力タップから専用の SPSC リング
+/// （VCMonitor）を経由して出力 AudioUnit のレンダーコールバックで読み出す。
+/// 入力と出力のクロック差は VCMonitor 側で吸収する。
+/// 実際に鳴らした信号は echoReference に流し、スピーカー使用時のエコーキャンセルに使う。
+public final class MonitorOutput: AudioOutputTap, @unchecked Sendable {
+
+    // MARK: - Properties
+
+    private let sampleRate: Double
+    private let renderState: MonitorRenderState
+
+    private var outputUnit: AudioComponentInstance?
+    public private(set) var isRunning: Bool = false
+
+    private let lock = NSLock()
+
+    // MARK: - Initialization
+
+    public init(sampleRate: Int = Constants.Audio.sampleRate) {
+        self.sampleRate = Double(sampleRate)
+
+        let capacity = Int32(Constants.Audio.Monitor.capacityMs * Double(sampleRate) / 1000)
+        let target = Int32(Constants.Audio.Monitor.targetLatencyMs * Double(sampleRate) / 1000)
+        // 数百KBの確保のみ。失敗はメモリ枯渇を意味する
+        self.renderState = MonitorRenderState(
+            monitor: vc_monitor_create(target, capacity)!,
+            sampleRate: sampleRate
+        )
+    }
+
+    deinit {
+        stop()
+    }
+
+    /// 出力した信号の参照（DSPChain.setEchoReference に渡す。pull は DSPChain 側）
+    public var echoReference: OpaquePointer {
+        renderState.echoReference
+    }
+
+    // MARK: - Public Methods
+
+    /// 出力開始
+    /// - Parameter frameSize: DSP のブロックサイズ（目標遅延の下限に使う）
+    public func start(frameSize: Int) throws {
+        lock.lock()
+        defer { lock.unlock() }
+
+        guard !isRunning else { return }
+
+        if outputUnit == nil {
+            try setupOutputUnit()
+        }
+        guard let outputUnit = outputUnit else {
+            throw AudioEngineError.invalidState
+        }
+
+        // 目標遅延は push / pull 両方のブロックを吸収できる大きさにする
+        let deviceFrames = outputUnitBufferFrameSize(outputUnit)
+        let requested = Int(Constants.Audio.Monitor.targetLatencyMs * sampleRate / 1000)
+        let target = max(requested, frameSize + deviceFrames)
+        vc_monitor_restart(renderState.monitor, Int32(target))
+
+        let status = AudioOutputUnitStart(outputUnit)
+        guard status == noErr else {
+            throw AudioEngineError.audioUnitError(status)
+        }
+
+        isRunning = true
+        logInfo("Monitor started (target \(target) frames)", category: .audio)
+    }
+
+    /// 出力停止
+    public func stop() {
+        lock.lock()
+        defer { lock.unlock() }
+
+        guard let outputUnit = outputUnit else { return }
+
+        if isRunning {
+            AudioOutputUnitStop(outputUnit)
+            isRunning = false
+        }
+        AudioUnitUninitialize(outputUnit)
+        AudioComponentInstanceDispose(outputUnit)
+        self.outputUnit = nil
+
+        logInfo("Monitor stopped", category: .audio)
+    }
+
+    /// 統計
+    public var stats: VCMonitorStats {
+        var stats = VCMonitorStats()
+        vc_monitor_get_stats(renderState.monitor, &stats)
+        return stats
+    }
+
+    // MARK: - AudioOutputTap
+
+    /// DSP 後のブロック（DSPChain アクター上）
+    public func push(_ samples: UnsafeBufferPointer<Float>) {
+        guard let base = samples.baseAddress else { return }
+        vc_monitor_push(renderState.monitor, base, Int32(samples.count))
+    }
+
+    // MARK: - Private Methods
+
+    private func setupOutputUnit() throws {
+        outputUnit = try makeStereoOutputUnit(
+            sampleRate: sampleRate,
+            renderProc: monitorRenderCallback,
+            refCon: Unmanaged.passUnretained(renderState).toOpaque()
+        )
+    }
+}
+
+// MARK: - Render State
+
+/// レンダーコールバック用（不変参照のみ）
+private final class MonitorRenderState {
+    let monitor: OpaquePointer
+    let echoReference: OpaquePointer
+
+    /// - Parameter monitor: 所有権を引き取る
+    init(monitor: OpaquePointer, sampleRate: Int) {
+        self.monitor = monitor
+        self.echoReference = makeEchoReference(sampleRate: sampleRate)
+    }
+
+    deinit {
+        vc_monitor_destroy(echoReference)
+        vc_monitor_destroy(monitor)
+    }
+}
+
+// MARK: - Output Unit
+
+/// 既定出力デバイス向けの AudioUnit を作る（48kHz, 2ch 非インターリーブ, Float32）
+/// MonitorOutput / ListeningOutput で共用。左右に同じ信号を出す前提
+func makeStereoOutputUnit(
+    sampleRate: Double,
+    renderProc: @escaping AURenderCallback,
+    refCon: UnsafeMutableRawPointer
+) throws -> AudioComponentInstance {
+    var desc = AudioComponentDescription(
+        componentType: kAudioUnitType_Output,
+        componentSubType: kAudioUnitSubType_DefaultOutput,
+        componentManufacturer: kAudioUnitManufacturer_Apple,
+        componentFlags: 0,
+        componentFlagsMask: 0
+    )
+
+    guard let component = AudioComponentFindNext(nil, &desc) else {
+        throw AudioEngineError.deviceNotFound
+    }
+
+    var unit: AudioComponentInstance?
+    var status = AudioComponentInstanceNew(component, &unit)
+    guard status == noErr, let outputUnit = unit else {
+        throw AudioEngineError.audioUnitError(status)
+    }
+
+    // フォーマット設定 (48kHz, 2ch 非インターリーブ, Float32)。左右に同じ信号を出す
+    var format = AudioStreamBasicDescription(
+        mSampleRate: sampleRate,
+        mFormatID: kAudioFormatLinearPCM,
+        mFormatFlags: kAudioFormatFlagIsFloat | kAudioFormatFlagIsPacked | kAudioFormatFlagIsNonInterleaved,
+        mBytesPerPacket: 4,
+        mFramesPerPacket: 1,
+        mBytesPerFrame: 4,
+        mChannelsPerFrame: 2,
+        mBitsPerChannel: 32,
+        mReserved: 0
+    )
+
+    status = AudioUnitSetProperty(
+        outputUnit,
+        kAudioUnitProperty_StreamFormat,
+        kAudioUnitScope_Input,
+        0,
+        &format,
+        UInt32(MemoryLayout<AudioStreamBasicDescription>.size)
+    )
+    guard status == noErr else {
+        AudioComponentInstanceDispose(outputUnit)
+        throw AudioEngineError.audioUnitError(status)
+    }
+
+    var callbackStruct = AURenderCallbackStruct(
+        inputProc: renderProc,
+        inputProcRefCon: refCon
+    )
+
+    status = AudioUnitSetProperty(
+        outputUnit,
+        kAudioUnitProperty_SetRenderCallback,
+        kAudioUnitScope_Input,
+        0,
+        &callbackStruct,
+        UInt32(MemoryLayout<AURenderCallbackStruct>.size)
+    )
+    guard status == noErr else {
+        AudioComponentInstanceDispose(outputUnit)
+        throw AudioEngineError.audioUnitError(status)
+    }
+
+    status = AudioUnitInitialize(outputUnit)
+    guard status == noErr else {
+        AudioComponentInstanceDispose(outputUnit)
+        throw AudioEngineError.audioUnitError(status)
+    }
+
+    return outputUnit
+}
+
+/// エコー参照用の VCMonitor（出力コールバックが push、DSPChain が pull）
+/// 数十KBの確保のみ。失敗はメモリ枯渇を意味する
+func makeEchoReference(sampleRate: Int) -> OpaquePointer {
+    let capacity = Int32(Constants.Audio.EchoReference.capacityMs * Double(sampleRate) / 1000)
+    let target = Int32(Constants.Audio.EchoReference.latencyMs * Double(sampleRate) / 1000)
+    return vc_monitor_create(target, capacity)!
+}
+
+/// 出力デバイスのバッファサイズ（取得できなければ 512）
+func outputUnitBufferFrameSize(_ outputUnit: AudioComponentInstance) -> Int {
+    var frames: UInt32 = 0
+    var size = UInt32(MemoryLayout<UInt32>.size)
+    let status = AudioUnitGetProperty(
+        outputUnit,
+        kAudioDevicePropertyBufferFrameSize,
+        kAudioUnitScope_Global,
+        0,
+        &frames,
+        &size
+    )
+    return status == noErr && frames > 0 ? Int(frames) : 512
+}
+
+// MARK: - Render Callback
+
+/// 出力スレッド: リングから読み出し（ロック・確保なし）
+private func monitorRenderCallback(
+    inRefCon: UnsafeMutableRawPointer,
+    ioActionFlags: UnsafeMutablePointer<AudioUnitRenderActionFlags>,
+    inTimeStamp: UnsafePointer<AudioTimeStamp>,
+    inBusNumber: UInt32,
+    inNumberFrames: UInt32,
+    ioData: UnsafeMutablePointer<AudioBufferList>?
+) -> OSStatus {
+    guard let ioData = ioData else { return noErr }
+
+    let state = Unmanaged<MonitorRenderState>.fromOpaque(inRefCon).takeUnretainedValue()
+    let buffers = UnsafeMutableAudioBufferListPointer(ioData)
+    guard let left = buffers.first?.mData?.assumingMemoryBound(to: Float.self) else {
+        return noErr
+    }
+
+    vc_monitor_pull(state.monitor, left, Int32(inNumberFrames))
+    vc_monitor_push(state.echoReference, left, Int32(inNumberFrames))
+
+    for index in 1..<buffers.count {
+        if let data = buffers[index].mData {
+            data.copyMemory(from: left, byteCount: Int(inNumberFrames) * MemoryLayout<Float>.size)
+        }
+    }
+    return noErr
+}
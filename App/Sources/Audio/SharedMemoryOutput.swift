@@ -1,33 +1,36 @@
 import Foundation
 import Utilities
 import DSP
-import CHelpers
+import VCCore
 
 /// 共有メモリ設定
 public enum SharedMemoryConfig {
-    public static let name = "com.voicechanger.audio"
-    public static let magic: UInt32 = 0x4D564356  // 'VCVM'
-    public static let version: UInt32 = 1
+    /// 仮想マイク 0（App → Driver）
+    public static let name = VC_VIRTUAL_MIC_MEMORY_NAME
+    /// ドライバが公開する仮想マイクの数（VirtualMicDriver.h の kMicDeviceCount と揃える）
+    public static let micCount = 4
+    /// 仮想スピーカー（Driver → App）
+    public static let speakerName = "com.voicechanger.speaker"
+    /// 録音タップ（Driver → App。仮想マイク 0 が実際に渡した音声）
+    public static let tapName = "com.voicechanger.tap"
+    /// IO トレース（Driver → App。仮想マイク 0 の IO 周期。VCIOTrace のレコード）
+    public static let traceName = "com.voicechanger.iotrace"
+    public static let version = UInt32(VC_SHARED_RING_VERSION)
     public static let sampleRate: UInt32 = 48000
     public static let frameSize: UInt32 = 256
     public static let bufferFrames: UInt32 = 64  // 約340ms
 
-    public static var headerSize: Int { 64 }  // アライメント済み
-    public static var bufferSize: Int { Int(frameSize * bufferFrames) * MemoryLayout<Float>.size }
-    public static var totalSize: Int { headerSize + bufferSize }
-}
+    public static var headerSize: Int { Int(VC_SHARED_RING_HEADER_SIZE) }
+    /// リング容量（2のべき乗）
+    public static var capacity: Int { Int(frameSize * bufferFrames) }
+    public static var totalSize: Int { vc_shared_ring_size(Int32(capacity)) }
 
-/// 共有メモリヘッダー構造体（Cと互換）
-public struct VCSharedBufferHeader {
-    var magic: UInt32
-    var version: UInt32
-    var sampleRate: UInt32
-    var frameSize: UInt32
-    var bufferFrames: UInt32
-    var writeIndex: UInt32  // Atomic
-    var readIndex: UInt32   // Atomic
-    var state: UInt32       // Atomic: 0=inactive, 1=active
-    var reserved: (UInt32, UInt32, UInt32, UInt32, UInt32, UInt32, UInt32, UInt32)
+    /// mic 番目の仮想マイクの共有メモリ名（0 は name、以降は ".2", ".3", ...）
+    public static func name(forMic mic: Int) -> String? {
+        var buffer = [CChar](repeating: 0, count: Int(VC_VIRTUAL_MIC_MEMORY_NAME_MAX))
+        guard vc_virtual_mic_memory_name(Int32(mic), &buffer, buffer.count) == 0 else { return nil }
+        return String(cString: buffer)
+    }
 }
 
 /// 共有メモリ出力（App → Virtual Mic Driver）
@@ -35,23 +38,26 @@ public final class SharedMemoryOutput {
 
     // MARK: - Properties
 
-    private var fileDescriptor: Int32 = -1
-    private var mappedMemory: UnsafeMutableRawPointer?
-    private var mappedSize: Int = 0
+    private let segment: SharedMemorySegment
 
-    private var header: UnsafeMutablePointer<VCSharedBufferHeader>?
-    private var samples: UnsafeMutablePointer<Float>?
+    /// 仮想マイクの番号（ドライバのデバイス）
+    public let mic: Int
 
     public private(set) var isConnected: Bool = false
 
     private let lock = NSLock()
 
-    // ローカルのインデックス追跡（アトミック操作の代替）
-    private var localWriteIndex: Int = 0
+    /// リングのビュー（VCMicFanout が直接書く。接続中のみ有効）
+    var ring: UnsafeMutablePointer<VCSharedRing> { segment.ring }
 
     // MARK: - Initialization
 
-    public init() {}
+    /// - Parameter mic: 0..<SharedMemoryConfig.micCount
+    public init(mic: Int = 0) {
+        precondition((0..<SharedMemoryConfig.micCount).contains(mic), "mic out of range")
+        self.mic = mic
+        self.segment = SharedMemorySegment(name: SharedMemoryConfig.name(forMic: mic)!)
+    }
 
     deinit {
         disconnect()
@@ -66,47 +72,17 @@ public final class SharedMemoryOutput {
 
         guard !isConnected else { return }
 
-        // 共有メモリを作成 (Cラッパーを使用)
-        let name = SharedMemoryConfig.name
-        fileDescriptor = vc_shm_open(name, O_CREAT | O_RDWR, 0644)
-
-        guard fileDescriptor >= 0 else {
-            throw SharedMemoryError.createFailed(errno: vc_get_errno())
-        }
-
-        // サイズを設定
-        let size = SharedMemoryConfig.totalSize
-        guard ftruncate(fileDescriptor, off_t(size)) == 0 else {
-            Darwin.close(fileDescriptor)
-            fileDescriptor = -1
-            throw SharedMemoryError.truncateFailed(errno: vc_get_errno())
-        }
-
-        // メモリマップ
-        let ptr = mmap(nil, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0)
-        guard ptr != MAP_FAILED else {
-            Darwin.close(fileDescriptor)
-            fileDescriptor = -1
-            throw SharedMemoryError.mmapFailed(errno: vc_get_errno())
-        }
-
-        mappedMemory = ptr
-        mappedSize = size
-
-        // ポインタ設定
-        header = ptr!.assumingMemoryBound(to: VCSharedBufferHeader.self)
-        samples = (ptr! + SharedMemoryConfig.headerSize).assumingMemoryBound(to: Float.self)
-
-        // ヘッダー初期化
-        initializeHeader()
-
-        localWriteIndex = 0
+        try segment.create(
+            sampleRate: Int(SharedMemoryConfig.sampleRate),
+            frameSize: Int(SharedMemoryConfig.frameSize),
+            capacity: SharedMemoryConfig.capacity
+        )
 
         isConnected = true
-        logInfo("SharedMemory connected", category: .audio)
+        logInfo("SharedMemory connected (mic \(mic))", category: .audio)
     }
 
-    /// 共有メモリを切断
+    /// 共有メモリを切断（書き込み側と同じスレッドから。write の途中で ring を外さないため）
     public func disconnect() {
         lock.lock()
         defer { lock.unlock() }
@@ -114,101 +90,45 @@ public final class SharedMemoryOutput {
         guard isConnected else { return }
 
         // 状態を非アクティブに
-        if let header = header {
-            header.pointee.state = 0
-        }
-
-        // メモリアンマップ
-        if let ptr = mappedMemory {
-            munmap(ptr, mappedSize)
-            mappedMemory = nil
-        }
-
-        // ファイルディスクリプタをクローズ
-        if fileDescriptor >= 0 {
-            Darwin.close(fileDescriptor)
-            fileDescriptor = -1
-        }
-
-        header = nil
-        samples = nil
+        vc_shared_ring_set_active(segment.ring, 0)
+        segment.unmap()
         isConnected = false
 
-        logInfo("SharedMemory disconnected", category: .audio)
+        logInfo("SharedMemory disconnected (mic \(mic))", category: .audio)
     }
 
     /// 音声サンプルを書き込み
     /// - Parameter buffer: Float32サンプルの配列
-    /// - Returns: 書き込んだサンプル数
+    /// - Returns: 書き込んだサンプル数（リングが満杯なら溢れた分は捨てる）
     @discardableResult
     public func write(_ buffer: [Float]) -> Int {
-        guard isConnected, let header = header, let samples = samples else {
-            return 0
-        }
-
-        let bufferCapacity = Int(SharedMemoryConfig.frameSize * SharedMemoryConfig.bufferFrames)
-        let count = min(buffer.count, bufferCapacity)
-
-        // 書き込み位置
-        let startPos = localWriteIndex % bufferCapacity
-
-        if startPos + count <= bufferCapacity {
-            // 連続書き込み
-            buffer.withUnsafeBufferPointer { src in
-                memcpy(samples.advanced(by: startPos), src.baseAddress!, count * MemoryLayout<Float>.size)
-            }
-        } else {
-            // 2分割書き込み（wrap-around）
-            let firstPart = bufferCapacity - startPos
-            let secondPart = count - firstPart
-
-            buffer.withUnsafeBufferPointer { src in
-                memcpy(samples.advanced(by: startPos), src.baseAddress!, firstPart * MemoryLayout<Float>.size)
-                memcpy(samples, src.baseAddress!.advanced(by: firstPart), secondPart * MemoryLayout<Float>.size)
-            }
-        }
-
-        // 書き込みインデックス更新
-        localWriteIndex += count
-        header.pointee.writeIndex = UInt32(localWriteIndex % (bufferCapacity * 2))  // wrap around
+        buffer.withUnsafeBufferPointer { write($0) }
+    }
 
-        return count
+    /// 音声サンプルを書き込み（処理キューの作業領域から直接。確保しない）
+    /// - Returns: 書き込んだサンプル数（リングが満杯なら溢れた分は捨てる）
+    @discardableResult
+    public func write(_ buffer: UnsafeBufferPointer<Float>) -> Int {
+        guard isConnected, let base = buffer.baseAddress else { return 0 }
+        return Int(vc_shared_ring_write(segment.ring, base, Int32(buffer.count)))
     }
 
     /// 状態をアクティブに設定
     public func activate() {
-        guard let header = header else { return }
-        header.pointee.state = 1
+        guard isConnected else { return }
+        vc_shared_ring_set_active(segment.ring, 1)
     }
 
     /// 状態を非アクティブに設定
     public func deactivate() {
-        guard let header = header else { return }
-        header.pointee.state = 0
+        guard isConnected else { return }
+        vc_shared_ring_set_active(segment.ring, 0)
     }
 
-    /// リングバッファをリセット
+    /// リングバッファをリセット（ドライバーの IO 停止中に呼ぶこと）
     public func reset() {
-        guard let header = header else { return }
-        localWriteIndex = 0
-        header.pointee.writeIndex = 0
-        header.pointee.readIndex = 0
-    }
-
-    // MARK: - Private Methods
-
-    private func initializeHeader() {
-        guard let header = header else { return }
-
-        header.pointee.magic = SharedMemoryConfig.magic
-        header.pointee.version = SharedMemoryConfig.version
-        header.pointee.sampleRate = SharedMemoryConfig.sampleRate
-        header.pointee.frameSize = SharedMemoryConfig.frameSize
-        header.pointee.bufferFrames = SharedMemoryConfig.bufferFrames
-        header.pointee.writeIndex = 0
-        header.pointee.readIndex = 0
-        header.pointee.state = 0
-        header.pointee.reserved = (0, 0, 0, 0, 0, 0, 0, 0)
+        guard isConnected else { return }
+        vc_shared_ring_reset(segment.ring)
     }
 }
 
@@ -218,6 +138,7 @@ public enum SharedMemoryError: LocalizedError {
     case createFailed(errno: Int32)
     case truncateFailed(errno: Int32)
     case mmapFailed(errno: Int32)
+    case invalidLayout
     case notConnected
 
     public var errorDescription: String? {
@@ -228,6 +149,8 @@ public enum SharedMemoryError: LocalizedError {
             return "Failed to set shared memory size: \(String(cString: strerror(err)))"
         case .mmapFailed(let err):
             return "Failed to map shared memory: \(String(cString: strerror(err)))"
+        case .invalidLayout:
+            return "Shared memory layout is invalid"
         case .notConnected:
             return "Shared memory not connected"
         }
@@ -0,0 +1,106 @@
+import Foundation
+import Utilities
+import CHelpers
+import VCCore
+
+/// App が作成する共有メモリ1区画（中身は VCSharedRing）
+///
+/// 仮想マイク（App → Driver）と仮想スピーカー（Driver → App）の両方向で使う。
+/// 作成は常に App 側で行い、ドライバーは StartIO 時に接続する。
+/// App が再起動したときは、同じレイアウトの区画が残っていればそのまま引き継ぐ（ドライバーは張り替えずに再開できる）。
+final class SharedMemorySegment {
+
+    // MARK: - Properties
+
+    let name: String
+
+    private var fileDescriptor: Int32 = -1
+    private var mappedMemory: UnsafeMutableRawPointer?
+    private var mappedSize: Int = 0
+
+    /// リングのビュー（C 側へポインタで渡すためヒープに固定）
+    let ring: UnsafeMutablePointer<VCSharedRing>
+
+    private(set) var isMapped: Bool = false
+
+    // MARK: - Initialization
+
+    init(name: String) {
+        self.name = name
+        self.ring = UnsafeMutablePointer<VCSharedRing>.allocate(capacity: 1)
+        self.ring.initialize(to: VCSharedRing())
+    }
+
+    deinit {
+        unmap()
+        ring.deinitialize(count: 1)
+        ring.deallocate()
+    }
+
+    // MARK: - Methods
+
+    /// 作成してリングを初期化（同じレイアウトの区画が残っていれば引き継ぐ）
+    func create(sampleRate: Int, frameSize: Int, capacity: Int) throws {
+        guard !isMapped else { return }
+
+        fileDescriptor = vc_shm_open(name, O_CREAT | O_RDWR, 0644)
+        guard fileDescriptor >= 0 else {
+            throw SharedMemoryError.createFailed(errno: vc_get_errno())
+        }
+
+        // 既存の区画は縮めない（ドライバーのマッピングの外になる）。macOS では2度目の ftruncate も失敗する
+        var info = stat()
+        guard fstat(fileDescriptor, &info) == 0 else {
+            let err = vc_get_errno()
+            closeDescriptor()
+            throw SharedMemoryError.createFailed(errno: err)
+        }
+        let required = vc_shared_ring_size(Int32(capacity))
+        if Int(info.st_size) < required {
+            guard ftruncate(fileDescriptor, off_t(required)) == 0 else {
+                let err = vc_get_errno()
+                closeDescriptor()
+                throw SharedMemoryError.truncateFailed(errno: err)
+            }
+        }
+        let size = max(Int(info.st_size), required)
+
+        let ptr = mmap(nil, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0)
+        guard ptr != MAP_FAILED, let memory = ptr else {
+            let err = vc_get_errno()
+            closeDescriptor()
+            throw SharedMemoryError.mmapFailed(errno: err)
+        }
+
+        mappedMemory = memory
+        mappedSize = size
+
+        let result = vc_shared_ring_reclaim(ring, memory, size, Int32(sampleRate), Int32(frameSize), Int32(capacity))
+        guard result >= 0 else {
+            unmap()
+            throw SharedMemoryError.invalidLayout
+        }
+
+        isMapped = true
+        logInfo("SharedMemory \(name) \(result == 1 ? "reclaimed" : "mapped") (\(capacity) frames, generation \(vc_shared_ring_generation(ring)))",
+                category: .audio)
+    }
+
+    /// アンマップ（名前は残すので、ドライバー側のマッピングは有効なまま）
+    func unmap() {
+        if let ptr = mappedMemory {
+            munmap(ptr, mappedSize)
+            mappedMemory = nil
+        }
+        closeDescriptor()
+        ring.pointee = VCSharedRing()
+        isMapped = false
+    }
+
+    private func closeDescriptor() {
+        if fileDescriptor >= 0 {
+            Darwin.close(fileDescriptor)
+            fileDescriptor = -1
+        }
+    }
+}
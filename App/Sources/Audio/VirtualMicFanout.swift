@@ -0,0 +1,165 @@
+import Foundation
+import DSP
+import Utilities
+import VCCore
+
+/// 追加の仮想マイク（2 本目以降）
+///
+/// マイク 0 は AudioEngine の DSPChain が処理し、ここではマイク 1 以降をそれぞれ独立した VCChain と
+/// 共有メモリ（com.voicechanger.audio.2, ...）で処理する。1 ブロックのキャプチャは全マイクが同じ領域を
+/// 読むだけでコピーせず、VCMicFanout がマイクごとに別コアで並行に処理する。
+/// setMic / process はどちらも AudioEngine の処理キューから呼ぶこと（パラメータ変更はブロックの合間に行われる）。
+public final class VirtualMicFanout: @unchecked Sendable {
+
+    // MARK: - Types
+
+    /// 有効なマイク 1 本分
+    private final class Mic {
+        let output: SharedMemoryOutput
+        let chain: OpaquePointer
+        private var convolver: OpaquePointer?
+        private var convolverSource: String?
+
+        init?(index: Int, sampleRate: Int) {
+            // 自前のプランで準備済み（プランキャッシュはワーカー間で共有できないので使わない）
+            guard let chain = vc_chain_create(Int32(sampleRate)) else { return nil }
+            self.output = SharedMemoryOutput(mic: index)
+            self.chain = chain
+        }
+
+        deinit {
+            output.disconnect()
+            vc_chain_destroy(chain)
+            vc_convolver_destroy(convolver)
+        }
+
+        /// DSPChain と同じく、IR が変わったときだけ畳み込みを作り直す
+        func apply(_ preset: VoicePreset) {
+            if preset.impulseResponse != convolverSource {
+                let next = preset.impulseResponse.flatMap { ImpulseResponseLibrary.makeConvolver($0) }
+                vc_chain_set_convolver(chain, next)
+                vc_convolver_destroy(convolver)
+                convolver = next
+                convolverSource = preset.impulseResponse
+            }
+            var params = preset.chainParams
+            vc_chain_set_params(chain, &params)
+        }
+    }
+
+    /// マイクごとの統計
+    public struct Stats: Sendable {
+        public var mic: Int
+        public var blocks: UInt64
+        /// ドライバが読んでいない（リング満杯）ために捨てたフレーム数
+        public var droppedFrames: UInt64
+    }
+
+    // MARK: - Properties
+
+    private let sampleRate: Int
+    private let maxFrames: Int
+
+    /// マイク番号 → 有効なマイク（1..<SharedMemoryConfig.micCount）
+    private var mics: [Int: Mic] = [:]
+    /// ファンアウト上の並び（登録順 = マイク番号順）
+    private var order: [Int] = []
+    private var fanout: OpaquePointer?
+    private var isActive = false
+
+    // MARK: - Initialization
+
+    public init(sampleRate: Int = Constants.Audio.sampleRate, maxFrames: Int = LatencyMode.maxFrameSize) {
+        self.sampleRate = sampleRate
+        self.maxFrames = maxFrames
+    }
+
+    deinit {
+        vc_mic_fanout_destroy(fanout)
+    }
+
+    // MARK: - Public Methods
+
+    /// 有効なマイク番号
+    public var activeMics: [Int] { order }
+
+    /// マイクを有効にしてプリセットを適用する（nil で無効。共有メモリは切断する）
+    /// 有効・無効が変わったときだけファンアウトを作り直す（ワーカーの起動・停止を伴うのでオーディオスレッドからは呼ばない）
+    public func setMic(_ index: Int, preset: VoicePreset?) throws {
+        precondition((1..<SharedMemoryConfig.micCount).contains(index), "extra mics are 1..<micCount")
+
+        guard let preset else {
+            guard mics.removeValue(forKey: index) != nil else { return }
+            rebuild()
+            return
+        }
+
+        if let mic = mics[index] {
+            mic.apply(preset)
+            return
+        }
+
+        guard let mic = Mic(index: index, sampleRate: sampleRate) else {
+            throw AudioEngineError.outOfMemory
+        }
+        try mic.output.connect()
+        mic.apply(preset)
+        if isActive {
+            mic.output.activate()
+        }
+        mics[index] = mic
+        rebuild()
+    }
+
+    /// 1 ブロックを全マイクで処理して各共有メモリへ書く（input は読むだけ）
+    public func process(_ input: UnsafePointer<Float>, count: Int) {
+        guard let fanout else { return }
+        vc_mic_fanout_process(fanout, input, Int32(count))
+    }
+
+    /// 送話の開始 / 停止に合わせて共有メモリの状態を切り替える
+    public func activate() {
+        isActive = true
+        mics.values.forEach { $0.output.activate() }
+    }
+
+    public func deactivate() {
+        isActive = false
+        mics.values.forEach { $0.output.deactivate() }
+    }
+
+    /// 全マイクを無効にする
+    public func removeAll() {
+        mics.removeAll()
+        rebuild()
+    }
+
+    public var stats: [Stats] {
+        guard let fanout else { return [] }
+        return order.enumerated().map { slot, index in
+            var raw = VCMicFanoutStats()
+            vc_mic_fanout_get_stats(fanout, Int32(slot), &raw)
+            return Stats(mic: index, blocks: raw.blocks, droppedFrames: raw.droppedFrames)
+        }
+    }
+
+    // MARK: - Private Methods
+
+    /// ファンアウトは登録のみなので、構成が変わったら作り直す（チェーンの状態はそのまま引き継ぐ）
+    private func rebuild() {
+        vc_mic_fanout_destroy(fanout)
+        fanout = nil
+        order = []
+        guard !mics.isEmpty, let next = vc_mic_fanout_create(Int32(maxFrames), 0) else { return }
+
+        for index in mics.keys.sorted() {
+            guard let mic = mics[index], vc_mic_fanout_add(next, mic.chain, mic.output.ring) >= 0 else {
+                logError("Virtual mic \(index) could not be added", category: .audio)
+                continue
+            }
+            order.append(index)
+        }
+        fanout = next
+        logInfo("Virtual mics active: \(order)", category: .audio)
+    }
+}
@@ -1,5 +1,5 @@
 import Foundation
-import Accelerate
+import VCCore
 
 /// オーディオフレーム
 public struct AudioFrame {
@@ -20,34 +20,84 @@ public struct AudioFrame {
     }
 }
 
+/// DSP後の出力を受け取るタップ
+/// DSPChain のキュー上から1本ずつ呼ばれる（同時に呼ばれることはない）。
+/// 実装はロック・メモリ確保をしないこと
+public protocol AudioOutputTap: AnyObject {
+    func push(_ samples: UnsafeBufferPointer<Float>)
+}
+
 /// DSP処理チェーン
+/// 処理本体はポータブルCコア（VCChain）で行い、本アクターは設定と呼び出しを直列化する
+///
+/// アクターは init で渡したシリアルキューの上で動く。そのキューの上からは process(inPlace:) を
+/// await なしで同期的に呼べ、設定の変更とはキューで直列化される（AudioEngine の処理キュー）
 public actor DSPChain {
 
     // MARK: - Properties
 
+    private static let defaultSampleRate: Int32 = 48000
+
     private var frameSize: Int = 256
     private var sampleRate: Int = 48000
 
-    private var hpf: HighPassFilter
-    private var noiseSuppressor: NoiseSuppressor
-    private var agc: AutoGainControl
-    private var pitchShifter: PitchShifter
-    private var formantShifter: FormantShifter
-    private var equalizer: Equalizer
-    private var limiter: Limiter
+    // アクターの実行キュー（process(inPlace:) はこの上からだけ呼ぶ）
+    private nonisolated let queue: DispatchSerialQueue
+
+    public nonisolated var unownedExecutor: UnownedSerialExecutor {
+        queue.asUnownedSerialExecutor()
+    }
+
+    // 処理スレッドが同期的に読む状態（書き込みはアクター上 = queue 上のみ）
+    private nonisolated let processing: ProcessingState
+
+    // HPF → (AEC) → VAD → NS → AGC → (Pitch/Formant) → (Voice) → (Multiband) → EQ → (Convolution) → Limiter
+    private var chain: OpaquePointer { processing.chain }
+
+    // プリセットが参照する IR の畳み込み（IR が変わったときだけ作り直す）
+    private var convolver: OpaquePointer?
+    private var convolverSource: String?
+
+    // プリセットがグラフを定義しているときの処理本体（あれば chain の代わりに使う）と、その CONVOLVER ノードの畳み込み
+    private var graph: OpaquePointer? {
+        get { processing.graph }
+        set { processing.graph = newValue }
+    }
+    private var graphConvolvers: [OpaquePointer] = []
+    private var graphWorkerCount = 0
+
+    // 声質変換（モデルは mmap したまま変換器が参照する。グラフのプリセットでは使わない）
+    private var voiceModel: OpaquePointer?
+    private var voiceConverter: OpaquePointer?
 
     private var currentPreset: VoicePreset = .default
 
+    // プリセットバンク（id の解決を組み込みより優先）と、ファイルが変わったら差し替える監視
+    private var presetBank: PresetBank?
+    private var presetBankWatcher: OpaquePointer?
+    private var presetBankReloadTarget: PresetBankReloadTarget?
+
+    // メータータップ（DSP前 / DSP後）。読み出しはアクター外から
+    public nonisolated let inputMeter = LevelMeter(sampleRate: Int(DSPChain.defaultSampleRate))
+    public nonisolated let outputMeter = LevelMeter(sampleRate: Int(DSPChain.defaultSampleRate))
+
     // MARK: - Initialization
 
-    public init() {
-        self.hpf = HighPassFilter(cutoffHz: 80, sampleRate: sampleRate)
-        self.noiseSuppressor = NoiseSuppressor()
-        self.agc = AutoGainControl()
-        self.pitchShifter = PitchShifter()
-        self.formantShifter = FormantShifter()
-        self.equalizer = Equalizer()
-        self.limiter = Limiter()
+    /// - Parameter queue: アクターを動かすシリアルキュー（処理スレッド。省略時は専用のキューを作る）
+    public init(queue: DispatchSerialQueue = DispatchSerialQueue(label: "com.voicechanger.dspchain", qos: .userInteractive)) {
+        self.queue = queue
+        // 数十KBの確保のみ。失敗はメモリ枯渇を意味する
+        self.processing = ProcessingState(chain: vc_chain_create(DSPChain.defaultSampleRate)!)
+    }
+
+    deinit {
+        vc_preset_bank_watcher_destroy(presetBankWatcher)
+        vc_graph_destroy(processing.graph)
+        graphConvolvers.forEach { vc_convolver_destroy($0) }
+        vc_chain_destroy(processing.chain)
+        vc_convolver_destroy(convolver)
+        vc_voice_converter_destroy(voiceConverter)
+        vc_voice_model_close(voiceModel)
     }
 
     // MARK: - Public Methods
@@ -57,42 +107,190 @@ public actor DSPChain {
         frameSize = size
     }
 
-    /// プリセット読み込み
-    public func loadPreset(_ presetId: String) {
-        currentPreset = VoicePreset.load(id: presetId) ?? .default
-        applyPreset(currentPreset)
+    /// 処理開始前の準備（FFT プランと窓は planCache から取る）
+    /// 作業領域は最大フレームサイズ分を確保済みなので、以降の setFrameSize / process は確保をしない
+    /// - Parameter planCache: VCPlanCache。このチェーン専用で、チェーンより長く生存すること
+    /// - Returns: false = 確保失敗（自前のプランのまま動作する）
+    @discardableResult
+    public func prepare(planCache: OpaquePointer?) -> Bool {
+        vc_chain_prepare(chain, planCache) == 0
+    }
+
+    /// 出力タップ設定（nil で解除）
+    public func setOutputTap(_ tap: AudioOutputTap?) {
+        applyOutputTap(tap)
+    }
+
+    /// 出力タップ設定（init で渡したキューの上から。ブロックの合間に、呼んだ順に反映される）
+    /// 戻った後のブロックは新しいタップにだけ push する（外したタップへは書かない）
+    public nonisolated func applyOutputTap(_ tap: AudioOutputTap?) {
+        dispatchPrecondition(condition: .onQueue(queue))
+        processing.outputTap = tap
+    }
+
+    /// エコー参照設定（出力コールバックが鳴らした信号を push する VCMonitor、nil で解除）
+    /// 参照があるとき HPF の直後でエコーキャンセルを行う。参照は DSPChain より長く生存すること
+    /// - Parameter slot: 0..<VC_CHAIN_MAX_ECHO_REFERENCES（出力先ごとに1つ）
+    /// - Returns: false = slot 範囲外 / キャンセラの確保失敗
+    @discardableResult
+    public func setEchoReference(_ reference: OpaquePointer?, slot: Int) -> Bool {
+        applyEchoReference(reference, slot: slot)
+    }
+
+    /// エコー参照設定（init で渡したキューの上から。ブロックの合間に、呼んだ順に反映される）
+    /// 戻った後のブロックは外した参照を読まない
+    @discardableResult
+    public nonisolated func applyEchoReference(_ reference: OpaquePointer?, slot: Int) -> Bool {
+        dispatchPrecondition(condition: .onQueue(queue))
+        return vc_chain_set_echo_reference(processing.chain, Int32(slot), reference) == 0
+    }
+
+    /// エコーキャンセラの統計（参照を一度も設定していなければ nil）
+    public func echoCancellerStats() -> VCEchoCancellerStats? {
+        var stats = VCEchoCancellerStats()
+        return vc_chain_get_echo_stats(chain, &stats) != 0 ? stats : nil
+    }
+
+    /// 声質変換モデルを開き、AGC の後で変換する（nil で解除）
+    /// 変換器は hop の倍数のフレームでだけ動き、それ以外のフレームは素通しになる
+    /// - Parameters:
+    ///   - mix: 変換結果の比率（0〜1）
+    ///   - lookAheadFrames: > 0 なら補助スレッドで推論し、その hop 数だけ遅延を足して受け取る（0 = 処理スレッドで推論）
+    /// - Returns: false = 開けない / 壊れている / サンプルレートが違う / 確保失敗（変換なしで動作する）
+    @discardableResult
+    public func setVoiceModel(path: String?, mix: Float = 1, lookAheadFrames: Int = 2) -> Bool {
+        vc_chain_set_voice_converter(chain, nil)
+        vc_voice_converter_destroy(voiceConverter)
+        vc_voice_model_close(voiceModel)
+        voiceConverter = nil
+        voiceModel = nil
+        guard let path else { return true }
+
+        guard let model = vc_voice_model_open(path) else { return false }
+        var config = VCVoiceModelConfig()
+        vc_voice_model_get_config(model, &config)
+        var options = VCVoiceConverterOptions(
+            lookAheadFrames: Int32(min(max(lookAheadFrames, 0), Int(VC_VOICE_CONVERTER_MAX_LOOKAHEAD))),
+            scalarKernels: 0)
+        guard config.sampleRate == DSPChain.defaultSampleRate,
+              let converter = vc_voice_converter_create(model, &options) else {
+            vc_voice_model_close(model)
+            return false
+        }
+        vc_voice_converter_set_mix(converter, mix)
+        vc_chain_set_voice_converter(chain, converter)
+        voiceModel = model
+        voiceConverter = converter
+        return true
     }
 
-    /// 音声処理
-    public func process(_ frame: inout AudioFrame) {
-        // 1. ハイパスフィルタ（DC除去、低周波ノイズ除去）
-        hpf.process(&frame)
+    /// 声質変換の統計（モデルがなければ nil）
+    public func voiceConverterStats() -> VCVoiceConverterStats? {
+        guard let voiceConverter else { return nil }
+        var stats = VCVoiceConverterStats()
+        vc_voice_converter_get_stats(voiceConverter, &stats)
+        return stats
+    }
 
-        // 2. ノイズ抑制
-        if currentPreset.noiseSuppressionEnabled {
-            noiseSuppressor.process(&frame)
-        }
+    /// 信号ガードの統計（入力の NaN・無限大・非正規化数、壊れた出力でモジュールをリセットした回数）
+    /// moduleResets の添字は VCChainModule。グラフのプリセットで処理している間は更新されない
+    public func signalGuardStats() -> VCSignalGuardStats {
+        var stats = VCSignalGuardStats()
+        vc_chain_get_signal_guard_stats(chain, &stats)
+        return stats
+    }
 
-        // 3. 自動ゲイン調整
-        if currentPreset.agcEnabled {
-            agc.process(&frame)
-        }
+    /// 直近ブロックの発話検出状態
+    public func voiceActivity() -> VCVadState {
+        var state = VCVadState()
+        vc_chain_get_vad_state(chain, &state)
+        return state
+    }
+
+    /// 直近ブロックの解析結果（発話検出・f0 と信頼度）
+    public func blockAnalysis() -> VCBlockAnalysis {
+        var analysis = VCBlockAnalysis()
+        vc_chain_get_analysis(chain, &analysis)
+        return analysis
+    }
+
+    /// チェーン自体が加える遅延（サンプル。リミッターのオーバーサンプリング分、グラフなら最も長い経路）
+    public func processingLatency() -> Float {
+        graph.map { vc_graph_latency($0) } ?? vc_chain_latency(chain)
+    }
 
-        // 4. ピッチシフト
-        if currentPreset.pitchShift != 0 {
-            pitchShifter.process(&frame)
+    /// グラフのプリセットで、独立な枝を並行に処理する補助スレッドの数（0 = 直列、既定）
+    /// 読み込み済みのグラフは作り直す。ブロックが小さいと待ち合わせのほうが高くつくので、重い枝があるときだけ使う
+    public func setGraphWorkers(_ count: Int) {
+        graphWorkerCount = max(0, count)
+        if currentPreset.graph != nil {
+            applyPreset(currentPreset)
         }
+    }
+
+    /// グラフで処理しているか（グラフのプリセットでも作れなければ直列チェーンで処理する）
+    public var isRunningGraph: Bool {
+        graph != nil
+    }
+
+    /// プリセット読み込み（バンク → 組み込みの順に探す）
+    public func loadPreset(_ presetId: String) {
+        currentPreset = presetBank?.preset(id: presetId) ?? VoicePreset.load(id: presetId) ?? .default
+        applyPreset(currentPreset)
+    }
 
-        // 5. フォルマントシフト
-        if currentPreset.formantShift != 0 {
-            formantShifter.process(&frame)
+    /// プリセットバンクを開き、以降はファイルの更新を監視して差し替える（nil で解除）
+    /// 検証・変換は監視スレッドで済ませ、差し替え時はアクター上で現在のプリセットを適用し直すだけなので音は止まらない
+    /// - Returns: false = 開けない / 壊れている（組み込みのみに戻る。監視は続け、直ったファイルは読み込む）
+    @discardableResult
+    public func setPresetBank(path: String?, pollIntervalMs: Int = 500) -> Bool {
+        vc_preset_bank_watcher_destroy(presetBankWatcher)
+        presetBankWatcher = nil
+        presetBankReloadTarget = nil
+        presetBank = path.flatMap { PresetBank(path: $0) }
+
+        if let path {
+            let target = PresetBankReloadTarget(chain: self)
+            presetBankReloadTarget = target
+            presetBankWatcher = vc_preset_bank_watcher_create(path, Int32(pollIntervalMs), presetBankDidChange,
+                                                              Unmanaged.passUnretained(target).toOpaque())
         }
+        return presetBank != nil || path == nil
+    }
+
+    /// バンク内のプリセット（バンクがなければ組み込み）
+    public func availablePresets() -> [VoicePreset] {
+        presetBank?.presets ?? VoicePreset.builtins
+    }
 
-        // 6. イコライザ
-        equalizer.process(&frame)
+    /// 監視スレッドが検証を終えたバンクに差し替え、現在のプリセットを新しい値で適用し直す
+    func adoptReloadedPresetBank() {
+        guard let watcher = presetBankWatcher, let handle = vc_preset_bank_watcher_take(watcher) else { return }
+        presetBank = PresetBank(handle: handle)
+        loadPreset(currentPreset.id)
+    }
 
-        // 7. リミッター（クリッピング防止）
-        limiter.process(&frame)
+    /// 音声処理
+    public func process(_ frame: inout AudioFrame) {
+        frame.samples.withUnsafeMutableBufferPointer { buffer in
+            process(inPlace: buffer)
+        }
+    }
+
+    /// 音声処理（インプレース。配列・Task を作らず、確保しない）
+    /// init で渡したキューの上から呼ぶこと（設定の変更と同じキューなので、処理中に差し替わらない）
+    public nonisolated func process(inPlace buffer: UnsafeMutableBufferPointer<Float>) {
+        dispatchPrecondition(condition: .onQueue(queue))
+        guard let base = buffer.baseAddress else { return }
+        let count = Int32(buffer.count)
+        inputMeter.process(UnsafeBufferPointer(buffer))
+        if let graph = processing.graph {
+            vc_graph_process(graph, base, base, count)
+        } else {
+            vc_chain_process(processing.chain, base, base, count)
+        }
+        outputMeter.process(UnsafeBufferPointer(buffer))
+        processing.outputTap?.push(UnsafeBufferPointer(buffer))
     }
 
     /// バイパス処理（変換なし）
@@ -103,11 +301,98 @@ public actor DSPChain {
     // MARK: - Private Methods
 
     private func applyPreset(_ preset: VoicePreset) {
-        pitchShifter.setSemitones(preset.pitchShift)
-        formantShifter.setShift(preset.formantShift)
-        equalizer.setGains(low: preset.eqLow, mid: preset.eqMid, high: preset.eqHigh)
-        noiseSuppressor.setStrength(preset.noiseSuppressionStrength)
-        agc.setTargetLevel(preset.agcTargetDb)
+        if preset.impulseResponse != convolverSource {
+            // 読み込めない IR はドライのまま（畳み込みなし）
+            let next = preset.impulseResponse.flatMap { ImpulseResponseLibrary.makeConvolver($0) }
+            vc_chain_set_convolver(chain, next)
+            vc_convolver_destroy(convolver)
+            convolver = next
+            convolverSource = preset.impulseResponse
+        }
+
+        var params = preset.chainParams
+        vc_chain_set_params(chain, &params)
+        applyGraph(preset)
+    }
+
+    /// グラフを作り直す（スケジュール・バッファの割り当てはここで 1 度だけ。作れなければ直列チェーンに戻る）
+    private func applyGraph(_ preset: VoicePreset) {
+        vc_graph_destroy(graph)
+        graph = nil
+        graphConvolvers.forEach { vc_convolver_destroy($0) }
+        graphConvolvers = []
+
+        guard let description = preset.graph,
+              case .success(let next) = description.makeGraph(sampleRate: sampleRate, workerCount: graphWorkerCount) else {
+            return
+        }
+        // CONVOLVER ノードごとに IR の畳み込みを作る（状態を共有できないため）
+        for node in description.convolverNodes {
+            guard let reference = preset.impulseResponse,
+                  let convolver = ImpulseResponseLibrary.makeConvolver(reference) else { continue }
+            vc_graph_set_convolver(next, Int32(node), convolver)
+            graphConvolvers.append(convolver)
+        }
+        graph = next
+    }
+}
+
+// MARK: - Processing State
+
+/// process(inPlace:) が参照するチェーン・グラフ・タップ
+/// DSPChain のキュー上でだけ読み書きするので、アクターの外（同じキュー上の同期呼び出し）からも読める
+private final class ProcessingState: @unchecked Sendable {
+    let chain: OpaquePointer
+    var graph: OpaquePointer?
+    var outputTap: AudioOutputTap?
+
+    init(chain: OpaquePointer) {
+        self.chain = chain
+    }
+}
+
+// MARK: - Impulse Responses
+
+/// プリセットが参照する IR の解決
+/// 内蔵の名前（"phone" / "radio" / "hall"）はその場で合成し、それ以外は WAV ファイルのパスとして mmap で読む
+public enum ImpulseResponseLibrary {
+    public static let sampleRate = 48000
+
+    /// IR のサンプル列（内蔵名 or WAV パス、読めない / サンプルレートが違う場合は nil）
+    public static func samples(for reference: String) -> [Float]? {
+        let builtin = vc_ir_builtin_named(reference)
+        if builtin >= 0 {
+            let kind = VCBuiltinImpulseResponse(rawValue: UInt32(builtin))
+            let length = Int(vc_ir_builtin_length(kind, Int32(sampleRate)))
+            var samples = [Float](repeating: 0, count: length)
+            let written = samples.withUnsafeMutableBufferPointer { buffer in
+                vc_ir_builtin_render(kind, Int32(sampleRate), buffer.baseAddress, Int32(length))
+            }
+            return written == length ? samples : nil
+        }
+
+        var ir = VCImpulseResponse()
+        guard vc_ir_load(reference, &ir) == 0 else { return nil }
+        defer { vc_ir_release(&ir) }
+        // リサンプルはしない（48kHz の IR のみ）
+        guard Int(ir.sampleRate) == sampleRate, let base = ir.samples else { return nil }
+        return Array(UnsafeBufferPointer(start: base, count: Int(ir.length)))
+    }
+
+    /// 背景スレッド付きの畳み込みを作る（呼び出し側が vc_convolver_destroy する）
+    public static func makeConvolver(_ reference: String) -> OpaquePointer? {
+        var ir = VCImpulseResponse()
+        if vc_ir_builtin_named(reference) < 0 {
+            // ファイルはマップした領域から直接分割・変換する（配列へコピーしない）
+            guard vc_ir_load(reference, &ir) == 0 else { return nil }
+            defer { vc_ir_release(&ir) }
+            guard Int(ir.sampleRate) == sampleRate else { return nil }
+            return vc_convolver_create(ir.samples, ir.length, 1)
+        }
+        guard let samples = samples(for: reference) else { return nil }
+        return samples.withUnsafeBufferPointer { buffer in
+            vc_convolver_create(buffer.baseAddress, Int32(buffer.count), 1)
+        }
     }
 }
 
@@ -131,6 +416,24 @@ public struct VoicePreset: Codable, Identifiable {
     public var noiseSuppressionStrength: Float = 0.5  // 0 to 1
     public var agcEnabled: Bool = true
     public var agcTargetDb: Float = -18
+    public var vadEnabled: Bool = true        // 非発話区間の処理簡略化 / AGC 据え置き
+
+    // Multiband dynamics
+    public var multibandEnabled: Bool = false
+    public var compressorThresholdDb: Float = -24   // 5.5kHz 未満の3帯域
+    public var compressorRatio: Float = 2.5
+    public var deEsserThresholdDb: Float = -30      // 5.5kHz 以上（歯擦音）
+    public var deEsserRatio: Float = 4
+
+    // Convolution
+    public var impulseResponse: String? = nil // 内蔵 IR 名（"phone" / "radio" / "hall"）または WAV のパス
+    public var convolutionMix: Float = 0      // 0 (dry) to 1 (wet)
+
+    // Oversampling
+    public var limiterOversampling: Int = 1   // 1 / 2 / 4（折り返しが減る代わりに遅延が増える）
+
+    // Graph
+    public var graph: ProcessingGraph? = nil  // あれば直列チェーンの代わりにこのグラフで処理する（上の値は使わない）
 
     public static let `default` = VoicePreset(id: "default", name: "Default")
 
@@ -139,7 +442,10 @@ public struct VoicePreset: Codable, Identifiable {
         name: "Male to Female",
         pitchShift: 4,
         formantShift: 0.3,
-        eqHigh: 2
+        eqHigh: 2,
+        multibandEnabled: true,     // 高域を持ち上げるぶん歯擦音を抑える
+        deEsserThresholdDb: -32,
+        deEsserRatio: 5
     )
 
     public static let femaleToMale = VoicePreset(
@@ -150,35 +456,84 @@ public struct VoicePreset: Codable, Identifiable {
         eqLow: 2
     )
 
+    public static let phone = VoicePreset(
+        id: "phone",
+        name: "Phone",
+        impulseResponse: "phone",
+        convolutionMix: 1
+    )
+
+    public static let radio = VoicePreset(
+        id: "radio",
+        name: "Radio",
+        eqMid: 2,
+        impulseResponse: "radio",
+        convolutionMix: 1
+    )
+
+    public static let hall = VoicePreset(
+        id: "hall",
+        name: "Hall",
+        impulseResponse: "hall",
+        convolutionMix: 0.3
+    )
+
+    public static let duet = VoicePreset(
+        id: "duet",
+        name: "Duet",
+        impulseResponse: "hall",
+        graph: .layered(semitones: -12)     // 1 オクターブ下のレイヤーとホールの響きを重ねる
+    )
+
     public static func load(id: String) -> VoicePreset? {
         switch id {
         case "default": return .default
         case "male_to_female": return .maleToFemale
         case "female_to_male": return .femaleToMale
+        case "phone": return .phone
+        case "radio": return .radio
+        case "hall": return .hall
+        case "duet": return .duet
         default: return nil
         }
     }
 }
 
+extension VoicePreset {
+    /// Cコア（VCChain）用パラメータ
+    public var chainParams: VCChainParams {
+        VCChainParams(
+            pitchShift: pitchShift,
+            formantShift: formantShift,
+            eqLow: eqLow,
+            eqMid: eqMid,
+            eqHigh: eqHigh,
+            noiseSuppressionEnabled: noiseSuppressionEnabled ? 1 : 0,
+            noiseSuppressionStrength: noiseSuppressionStrength,
+            agcEnabled: agcEnabled ? 1 : 0,
+            agcTargetDb: agcTargetDb,
+            vadEnabled: vadEnabled ? 1 : 0,
+            multibandEnabled: multibandEnabled ? 1 : 0,
+            compressorThresholdDb: compressorThresholdDb,
+            compressorRatio: compressorRatio,
+            deEsserThresholdDb: deEsserThresholdDb,
+            deEsserRatio: deEsserRatio,
+            convolutionMix: impulseResponse != nil ? convolutionMix : 0,
+            limiterOversampling: Int32(limiterOversampling)
+        )
+    }
+}
+
 // MARK: - DSP Modules
+// 各モジュールは VCCore のカーネルを呼び出す薄いラッパー（単体利用・テスト用）
 
 /// ハイパスフィルタ（Biquad実装）
 public class HighPassFilter {
     private var cutoffHz: Float
     private var sampleRate: Float
 
-    // Biquad coefficients
-    private var b0: Float = 0
-    private var b1: Float = 0
-    private var b2: Float = 0
-    private var a1: Float = 0
-    private var a2: Float = 0
-
-    // Filter state
-    private var x1: Float = 0
-    private var x2: Float = 0
-    private var y1: Float = 0
-    private var y2: Float = 0
+    private var coeffs = VCBiquadCoeffs()
+    private var state = VCBiquadState()
 
     public init(cutoffHz: Float, sampleRate: Int) {
         self.cutoffHz = cutoffHz
@@ -187,89 +542,62 @@ public class HighPassFilter {
     }
 
     private func calculateCoefficients() {
-        let omega = 2.0 * Float.pi * cutoffHz / sampleRate
-        let cosOmega = cos(omega)
-        let sinOmega = sin(omega)
         let q: Float = 0.707  // Butterworth Q
-        let alpha = sinOmega / (2.0 * q)
-
-        let a0 = 1.0 + alpha
-        b0 = ((1.0 + cosOmega) / 2.0) / a0
-        b1 = (-(1.0 + cosOmega)) / a0
-        b2 = ((1.0 + cosOmega) / 2.0) / a0
-        a1 = (-2.0 * cosOmega) / a0
-        a2 = (1.0 - alpha) / a0
+        vc_biquad_set_highpass(&coeffs, cutoffHz, q, sampleRate)
     }
 
     public func process(_ frame: inout AudioFrame) {
-        for i in 0..<frame.count {
-            let x0 = frame.samples[i]
-            let y0 = b0 * x0 + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2
-
-            x2 = x1
-            x1 = x0
-            y2 = y1
-            y1 = y0
-
-            frame.samples[i] = y0
+        let count = Int32(frame.count)
+        frame.samples.withUnsafeMutableBufferPointer { buffer in
+            guard let base = buffer.baseAddress else { return }
+            vc_biquad_process(&coeffs, &state, base, base, count)
         }
     }
 
     public func reset() {
-        x1 = 0
-        x2 = 0
-        y1 = 0
-        y2 = 0
+        vc_biquad_reset(&state)
     }
 }
 
 /// ノイズ抑制
 public class NoiseSuppressor {
-    private var strength: Float = 0.5
+    private var gate = VCNoiseGate()
+
+    public init() {
+        vc_noise_gate_init(&gate)
+    }
 
     public func setStrength(_ value: Float) {
-        strength = max(0, min(1, value))
+        vc_noise_gate_set_strength(&gate, value)
     }
 
     public func process(_ frame: inout AudioFrame) {
-        // 簡易的なノイズゲート実装
-        // TODO: WebRTC NSまたはRNNoiseを統合
-        let threshold: Float = 0.01 * (1 - strength)
-        for i in 0..<frame.count {
-            if abs(frame.samples[i]) < threshold {
-                frame.samples[i] *= 0.1
-            }
+        let count = Int32(frame.count)
+        frame.samples.withUnsafeMutableBufferPointer { buffer in
+            guard let base = buffer.baseAddress else { return }
+            vc_noise_gate_process(&gate, base, count)
         }
     }
 }
 
 /// 自動ゲイン調整
 public class AutoGainControl {
-    private var targetDb: Float = -18
-    private var currentGain: Float = 1.0
-    private let attackTime: Float = 0.01
-    private let releaseTime: Float = 0.1
+    private var agc = VCAgc()
+
+    public init() {
+        vc_agc_init(&agc)
+    }
 
     public func setTargetLevel(_ db: Float) {
-        targetDb = db
+        vc_agc_set_target(&agc, db)
     }
 
     public func process(_ frame: inout AudioFrame) {
-        // RMSレベル計算
-        var rms: Float = 0
-        vDSP_rmsqv(frame.samples, 1, &rms, vDSP_Length(frame.count))
-
-        let currentDb = 20 * log10(max(rms, 1e-10))
-        let targetGain = pow(10, (targetDb - currentDb) / 20)
-
-        // スムーズなゲイン変更
-        let alpha = currentDb < targetDb ? attackTime : releaseTime
-        currentGain = currentGain * (1 - alpha) + targetGain * alpha
-        currentGain = max(0.1, min(10, currentGain))
-
-        // ゲイン適用
-        var gain = currentGain
-        vDSP_vsmul(frame.samples, 1, &gain, &frame.samples, 1, vDSP_Length(frame.count))
+        let count = Int32(frame.count)
+        frame.samples.withUnsafeMutableBufferPointer { buffer in
+            guard let base = buffer.baseAddress else { return }
+            vc_agc_process(&agc, base, count)
+        }
     }
 }
 
@@ -277,6 +605,8 @@ public class AutoGainControl {
 public class PitchShifter {
     private var semitones: Float = 0
 
+    public init() {}
+
     public func setSemitones(_ value: Float) {
         semitones = max(-12, min(12, value))
     }
@@ -292,6 +622,8 @@ public class PitchShifter {
 public class FormantShifter {
     private var shift: Float = 0
 
+    public init() {}
+
     public func setShift(_ value: Float) {
         shift = max(-1, min(1, value))
     }
@@ -358,134 +690,60 @@ public class Equalizer {
 
 /// 汎用Biquadフィルター
 public class BiquadFilter {
-    private var b0: Float = 1
-    private var b1: Float = 0
-    private var b2: Float = 0
-    private var a1: Float = 0
-    private var a2: Float = 0
-
-    private var x1: Float = 0
-    private var x2: Float = 0
-    private var y1: Float = 0
-    private var y2: Float = 0
+    private var coeffs = VCBiquadCoeffs(b0: 1, b1: 0, b2: 0, a1: 0, a2: 0)
+    private var state = VCBiquadState()
 
     public init() {}
 
     /// Low Shelf フィルター設定
     public func setLowShelf(frequency: Float, gain: Float, sampleRate: Float) {
-        let A = pow(10, gain / 40)
-        let omega = 2.0 * Float.pi * frequency / sampleRate
-        let cosOmega = cos(omega)
-        let sinOmega = sin(omega)
-        let alpha = sinOmega / 2.0 * sqrt(2.0)
-
-        let a0 = (A + 1) + (A - 1) * cosOmega + 2 * sqrt(A) * alpha
-        b0 = (A * ((A + 1) - (A - 1) * cosOmega + 2 * sqrt(A) * alpha)) / a0
-        b1 = (2 * A * ((A - 1) - (A + 1) * cosOmega)) / a0
-        b2 = (A * ((A + 1) - (A - 1) * cosOmega - 2 * sqrt(A) * alpha)) / a0
-        a1 = (-2 * ((A - 1) + (A + 1) * cosOmega)) / a0
-        a2 = ((A + 1) + (A - 1) * cosOmega - 2 * sqrt(A) * alpha) / a0
+        vc_biquad_set_lowshelf(&coeffs, frequency, gain, sampleRate)
     }
 
     /// High Shelf フィルター設定
     public func setHighShelf(frequency: Float, gain: Float, sampleRate: Float) {
-        let A = pow(10, gain / 40)
-        let omega = 2.0 * Float.pi * frequency / sampleRate
-        let cosOmega = cos(omega)
-        let sinOmega = sin(omega)
-        let alpha = sinOmega / 2.0 * sqrt(2.0)
-
-        let a0 = (A + 1) - (A - 1) * cosOmega + 2 * sqrt(A) * alpha
-        b0 = (A * ((A + 1) + (A - 1) * cosOmega + 2 * sqrt(A) * alpha)) / a0
-        b1 = (-2 * A * ((A - 1) + (A + 1) * cosOmega)) / a0
-        b2 = (A * ((A + 1) + (A - 1) * cosOmega - 2 * sqrt(A) * alpha)) / a0
-        a1 = (2 * ((A - 1) - (A + 1) * cosOmega)) / a0
-        a2 = ((A + 1) - (A - 1) * cosOmega - 2 * sqrt(A) * alpha) / a0
+        vc_biquad_set_highshelf(&coeffs, frequency, gain, sampleRate)
     }
 
     /// Peaking EQ フィルター設定
     public func setPeaking(frequency: Float, gain: Float, q: Float, sampleRate: Float) {
-        let A = pow(10, gain / 40)
-        let omega = 2.0 * Float.pi * frequency / sampleRate
-        let cosOmega = cos(omega)
-        let sinOmega = sin(omega)
-        let alpha = sinOmega / (2.0 * q)
-
-        let a0 = 1 + alpha / A
-        b0 = (1 + alpha * A) / a0
-        b1 = (-2 * cosOmega) / a0
-        b2 = (1 - alpha * A) / a0
-        a1 = (-2 * cosOmega) / a0
-        a2 = (1 - alpha / A) / a0
+        vc_biquad_set_peaking(&coeffs, frequency, gain, q, sampleRate)
     }
 
     public func process(_ frame: inout AudioFrame) {
-        for i in 0..<frame.count {
-            let x0 = frame.samples[i]
-            let y0 = b0 * x0 + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2
-
-            x2 = x1
-            x1 = x0
-            y2 = y1
-            y1 = y0
-
-            frame.samples[i] = y0
+        let count = Int32(frame.count)
+        frame.samples.withUnsafeMutableBufferPointer { buffer in
+            guard let base = buffer.baseAddress else { return }
+            vc_biquad_process(&coeffs, &state, base, base, count)
         }
     }
 
     public func reset() {
-        x1 = 0
-        x2 = 0
-        y1 = 0
-        y2 = 0
+        vc_biquad_reset(&state)
     }
 }
 
 /// リミッター（ソフトニー + ルックアヘッド）
 public class Limiter {
-    private var ceiling: Float = 0.89  // -1dB
-    private var threshold: Float = 0.7  // Soft knee starts here
-    private var attackCoeff: Float = 0.001
-    private var releaseCoeff: Float = 0.05
-    private var envelope: Float = 0
+    private var limiter = VCLimiter()
+
+    public init() {
+        vc_limiter_init(&limiter)
+    }
 
     public func setCeiling(_ db: Float) {
-        ceiling = pow(10, db / 20)
-        threshold = ceiling * 0.8
+        vc_limiter_set_ceiling(&limiter, db)
     }
 
     public func process(_ frame: inout AudioFrame) {
-        for i in 0..<frame.count {
-            let input = frame.samples[i]
-            let absInput = abs(input)
-
-            // エンベロープ追従
-            if absInput > envelope {
-                envelope = attackCoeff * absInput + (1 - attackCoeff) * envelope
-            } else {
-                envelope = releaseCoeff * absInput + (1 - releaseCoeff) * envelope
-            }
-
-            // ゲイン計算
-            var gain: Float = 1.0
-            if envelope > threshold {
-                // ソフトニー圧縮
-                let overshoot = envelope - threshold
-                let range = ceiling - threshold
-                let compressionRatio: Float = 10.0  // 10:1 limiting
-                gain = threshold + range * tanh(overshoot / range * compressionRatio) / envelope
-            }
-
-            // クリッピング防止
-            if abs(input * gain) > ceiling {
-                gain = ceiling / max(abs(input), 0.0001)
-            }
-
-            frame.samples[i] = input * gain
+        let count = Int32(frame.count)
+        frame.samples.withUnsafeMutableBufferPointer { buffer in
+            guard let base = buffer.baseAddress else { return }
+            vc_limiter_process(&limiter, base, count)
         }
     }
 
     public func reset() {
-        envelope = 0
+        vc_limiter_reset(&limiter)
     }
 }
@@ -0,0 +1,55 @@
+import Foundation
+import VCCore
+
+/// メーター読み値
+public struct MeterReading: Sendable, Equatable {
+    public var peakDb: Float = VC_METER_FLOOR_DB
+    public var rmsDb: Float = VC_METER_FLOOR_DB
+    /// K特性ラウドネス（400ms）
+    public var momentaryLufs: Float = VC_METER_FLOOR_DB
+    /// K特性ラウドネス（3s）
+    public var shortTermLufs: Float = VC_METER_FLOOR_DB
+
+    public init() {}
+
+    init(_ raw: VCMeterReading) {
+        peakDb = raw.peakDb
+        rmsDb = raw.rmsDb
+        momentaryLufs = raw.momentaryLufs
+        shortTermLufs = raw.shortTermLufs
+    }
+}
+
+/// レベルメーター（VCMeter のラッパー）
+/// process は計測スレッド、read は表示スレッドから呼ぶ（それぞれ同時に1スレッド）。
+/// 受け渡しはトリプルバッファで、ロックもメモリ確保もしない。
+public final class LevelMeter: @unchecked Sendable {
+
+    private let meter: OpaquePointer
+
+    public init(sampleRate: Int = 48000) {
+        // 数KBの確保のみ。失敗はメモリ枯渇を意味する
+        self.meter = vc_meter_create(Int32(sampleRate))!
+    }
+
+    deinit {
+        vc_meter_destroy(meter)
+    }
+
+    /// 計測（オーディオスレッドから呼び出し可）
+    public func process(_ samples: UnsafeBufferPointer<Float>) {
+        guard let base = samples.baseAddress else { return }
+        vc_meter_process(meter, base, Int32(samples.count))
+    }
+
+    /// 最新の読み値
+    public func read() -> MeterReading {
+        var raw = VCMeterReading()
+        vc_meter_read(meter, &raw)
+        return MeterReading(raw)
+    }
+
+    public func reset() {
+        vc_meter_reset(meter)
+    }
+}
@@ -0,0 +1,263 @@
+import Foundation
+import VCCore
+
+/// 複数ストリーム同時処理エンジン
+/// 録音済み通話音声や複数話者など、独立した N 本のストリームを
+/// ワークスティーリング・スレッドプール（VCStreamPool）上で並列に処理する。
+/// 同一ストリーム内のブロック順序は保証され、異なるストリームは別コアで並行に処理される。
+/// batchLanes を指定すると、連続する lanes 本のストリームを SoA バッチ（VCChainBatch）として
+/// 1タスクでまとめて処理する（1コアあたりの処理可能ストリーム数が増える）。
+public final class MultiStreamEngine {
+
+    // MARK: - Types
+
+    /// 処理統計
+    public struct Stats: Sendable {
+        public var blocksProcessed: UInt64 = 0
+        public var samplesProcessed: UInt64 = 0
+        public var steals: UInt64 = 0
+        /// 処理済み音声時間 / 経過時間
+        public var realtimeFactor: Double = 0
+    }
+
+    // MARK: - Properties
+
+    public let sampleRate: Int
+    public let blockSize: Int
+    /// バッチレーン数（0ならストリームごとに個別処理）
+    public let batchLanes: Int
+
+    private let pool: OpaquePointer
+    private var chains: [OpaquePointer] = []
+    private let queueCapacity: Int
+
+    // バッチモード: グループごとの VCChainBatch とプール上のストリームID
+    private var batches: [OpaquePointer] = []
+    private var batchStreamIds: [Int32] = []
+    private var batchStreamCount = 0
+
+    private var busyTime: TimeInterval = 0
+
+    // MARK: - Initialization
+
+    /// - Parameters:
+    ///   - workerCount: ワーカースレッド数（0ならCPUコア数）
+    ///   - blockSize: 1タスクあたりのサンプル数
+    ///   - queueCapacity: ストリームごとの未処理ブロック上限
+    ///   - batchLanes: 0 または 4 / 8 / 16
+    public init(workerCount: Int = 0, sampleRate: Int = 48000, blockSize: Int = 256, queueCapacity: Int = 64,
+                batchLanes: Int = 0) {
+        precondition([0, 4, 8, 16].contains(batchLanes), "batchLanes must be 0, 4, 8 or 16")
+        self.sampleRate = sampleRate
+        self.blockSize = blockSize
+        self.queueCapacity = queueCapacity
+        self.batchLanes = batchLanes
+        // ワーカースレッドを1本も起動できない場合のみ失敗する
+        self.pool = vc_stream_pool_create(Int32(workerCount))!
+    }
+
+    deinit {
+        vc_stream_pool_destroy(pool)
+        chains.forEach { vc_chain_destroy($0) }
+        batches.forEach { vc_chain_batch_destroy($0) }
+    }
+
+    // MARK: - Public Methods
+
+    /// ワーカー数
+    public var workerCount: Int {
+        Int(vc_stream_pool_worker_count(pool))
+    }
+
+    /// ストリーム数
+    public var streamCount: Int {
+        batchLanes > 0 ? batchStreamCount : chains.count
+    }
+
+    /// ストリーム追加
+    /// - Returns: ストリームID、上限超過時nil
+    @discardableResult
+    public func addStream(preset: VoicePreset = .default) -> Int? {
+        if batchLanes > 0 {
+            return addBatchStream(preset: preset)
+        }
+
+        guard let chain = vc_chain_create(Int32(sampleRate)) else { return nil }
+
+        var params = preset.chainParams
+        vc_chain_set_params(chain, &params)
+
+        let streamId = vc_stream_pool_add_stream(pool, chain, Int32(queueCapacity))
+        guard streamId >= 0 else {
+            vc_chain_destroy(chain)
+            return nil
+        }
+
+        chains.append(chain)
+        return Int(streamId)
+    }
+
+    /// ストリームのプリセット変更（処理中でないときに呼ぶこと）
+    public func setPreset(_ preset: VoicePreset, forStream streamId: Int) {
+        var params = preset.chainParams
+        if batchLanes > 0 {
+            guard streamId >= 0 && streamId < batchStreamCount else { return }
+            vc_chain_batch_set_lane_params(batches[streamId / batchLanes], Int32(streamId % batchLanes), &params)
+            return
+        }
+        guard chains.indices.contains(streamId) else { return }
+        vc_chain_set_params(chains[streamId], &params)
+    }
+
+    /// 全ストリームをまとめて処理（インプレース）
+    /// 各ストリームのバッファを blockSize ごとのタスクに分割し、ブロック番号順に投入する
+    /// - Parameter buffers: ストリームIDをインデックスとするサンプル配列
+    public func process(_ buffers: inout [[Float]]) {
+        precondition(buffers.count <= streamCount, "More buffers than registered streams")
+
+        if batchLanes > 0 {
+            processBatches(&buffers)
+            return
+        }
+
+        let start = Date()
+        let maxCount = buffers.map(\.count).max() ?? 0
+
+        // 配列の再確保を避けるため、処理中はポインタを固定する
+        var pointers: [UnsafeMutablePointer<Float>] = []
+        for index in buffers.indices {
+            let count = buffers[index].count
+            let pointer = UnsafeMutablePointer<Float>.allocate(capacity: max(count, 1))
+            buffers[index].withUnsafeBufferPointer { source in
+                if let base = source.baseAddress {
+                    pointer.initialize(from: base, count: count)
+                }
+            }
+            pointers.append(pointer)
+        }
+
+        var offset = 0
+        while offset < maxCount {
+            for (streamId, pointer) in pointers.enumerated() {
+                let remaining = buffers[streamId].count - offset
+                guard remaining > 0 else { continue }
+
+                let count = Int32(min(blockSize, remaining))
+                let block = pointer + offset
+                while vc_stream_pool_submit(pool, Int32(streamId), block, block, count) != 0 {
+                    // キュー満杯: 先行ブロックの完了を待つ
+                    vc_stream_pool_wait(pool)
+                }
+            }
+            offset += blockSize
+        }
+        vc_stream_pool_wait(pool)
+
+        for (index, pointer) in pointers.enumerated() {
+            let count = buffers[index].count
+            buffers[index] = Array(UnsafeBufferPointer(start: pointer, count: count))
+            pointer.deallocate()
+        }
+
+        busyTime += Date().timeIntervalSince(start)
+    }
+
+    // MARK: - Batch Mode
+
+    private func addBatchStream(preset: VoicePreset) -> Int? {
+        let lane = batchStreamCount % batchLanes
+        if lane == 0 {
+            guard let batch = vc_chain_batch_create(Int32(batchLanes), Int32(sampleRate)) else { return nil }
+            let poolId = vc_stream_pool_add_batch(pool, batch, Int32(queueCapacity))
+            guard poolId >= 0 else {
+                vc_chain_batch_destroy(batch)
+                return nil
+            }
+            batches.append(batch)
+            batchStreamIds.append(poolId)
+        }
+
+        var params = preset.chainParams
+        vc_chain_batch_set_lane_params(batches[batches.count - 1], Int32(lane), &params)
+
+        let streamId = batchStreamCount
+        batchStreamCount += 1
+        return streamId
+    }
+
+    /// グループ単位でバッチレイアウトに詰めて処理する
+    /// グループ内で短いストリームは無音で埋めて処理される（長さを揃えて渡すこと）
+    private func processBatches(_ buffers: inout [[Float]]) {
+        let start = Date()
+        let lanes = batchLanes
+        let groupCount = (buffers.count + lanes - 1) / lanes
+
+        var packedBuffers: [UnsafeMutablePointer<Float>] = []
+        var groupFrames: [Int] = []
+        for group in 0..<groupCount {
+            let members = (group * lanes)..<min((group + 1) * lanes, buffers.count)
+            let frames = members.map { buffers[$0].count }.max() ?? 0
+            let packed = UnsafeMutablePointer<Float>.allocate(capacity: max(frames * lanes, 1))
+            packed.initialize(repeating: 0, count: max(frames * lanes, 1))
+
+            for index in members {
+                let lane = index - group * lanes
+                buffers[index].withUnsafeBufferPointer { source in
+                    for (frame, sample) in source.enumerated() {
+                        packed[frame * lanes + lane] = sample
+                    }
+                }
+            }
+            packedBuffers.append(packed)
+            groupFrames.append(frames)
+        }
+
+        let maxFrames = groupFrames.max() ?? 0
+        var offset = 0
+        while offset < maxFrames {
+            for group in 0..<groupCount {
+                let remaining = groupFrames[group] - offset
+                guard remaining > 0 else { continue }
+
+                let count = Int32(min(blockSize, remaining))
+                let block = packedBuffers[group] + offset * lanes
+                while vc_stream_pool_submit(pool, batchStreamIds[group], block, block, count) != 0 {
+                    vc_stream_pool_wait(pool)
+                }
+            }
+            offset += blockSize
+        }
+        vc_stream_pool_wait(pool)
+
+        for group in 0..<groupCount {
+            let packed = packedBuffers[group]
+            for index in (group * lanes)..<min((group + 1) * lanes, buffers.count) {
+                let lane = index - group * lanes
+                buffers[index].withUnsafeMutableBufferPointer { destination in
+                    for frame in destination.indices {
+                        destination[frame] = packed[frame * lanes + lane]
+                    }
+                }
+            }
+            packed.deallocate()
+        }
+
+        busyTime += Date().timeIntervalSince(start)
+    }
+
+    /// 統計取得
+    public var stats: Stats {
+        var raw = VCStreamPoolStats()
+        vc_stream_pool_get_stats(pool, &raw)
+
+        var stats = Stats()
+        stats.blocksProcessed = raw.blocksProcessed
+        stats.samplesProcessed = raw.samplesProcessed
+        stats.steals = raw.steals
+        if busyTime > 0 {
+            let audioSeconds = Double(raw.samplesProcessed) / Double(sampleRate)
+            stats.realtimeFactor = audioSeconds / busyTime
+        }
+        return stats
+    }
+}
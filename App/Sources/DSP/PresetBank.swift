@@ -0,0 +1,122 @@
+import Foundation
+import VCCore
+
+/// バイナリのプリセットバンク（VCPresetBank の所有ラッパー）
+/// ファイルは mmap したまま、検証・VCChainParams への変換は開くときに済ませてある
+public final class PresetBank {
+    let handle: OpaquePointer
+
+    /// 開いて検証する（壊れている・版が違うなら nil）
+    public convenience init?(path: String) {
+        guard let handle = vc_preset_bank_open(path) else { return nil }
+        self.init(handle: handle)
+    }
+
+    /// 監視スレッドが検証済みのバンクを受け取る
+    init(handle: OpaquePointer) {
+        self.handle = handle
+    }
+
+    deinit {
+        vc_preset_bank_close(handle)
+    }
+
+    public var count: Int {
+        Int(vc_preset_bank_count(handle))
+    }
+
+    /// id で引く（索引の二分探索）
+    public func preset(id: String) -> VoicePreset? {
+        let index = vc_preset_bank_find(handle, id)
+        return index >= 0 ? preset(at: Int(index)) : nil
+    }
+
+    public func preset(at index: Int) -> VoicePreset? {
+        var entry = VCPresetEntry()
+        guard vc_preset_bank_get(handle, Int32(index), &entry) == 0 else { return nil }
+        return VoicePreset(
+            id: String(cString: entry.id),
+            name: String(cString: entry.name),
+            impulseResponse: entry.impulseResponse.map { String(cString: $0) },
+            chainParams: entry.params
+        )
+    }
+
+    public var presets: [VoicePreset] {
+        (0..<count).compactMap { preset(at: $0) }
+    }
+
+    /// バンクを書き出す（一時ファイルから rename するので、監視中のファイルへそのまま書いてよい）
+    /// グラフ（VoicePreset.graph）は保存しない。バンクから読んだプリセットは直列チェーンで動く
+    @discardableResult
+    public static func write(_ presets: [VoicePreset], to path: String) -> Bool {
+        // 文字列は書き出しが終わるまで保持する
+        let strings = presets.map { preset in
+            (strdup(preset.id), strdup(preset.name), preset.impulseResponse.map { strdup($0) } ?? nil)
+        }
+        defer {
+            for (id, name, impulseResponse) in strings {
+                free(id)
+                free(name)
+                free(impulseResponse)
+            }
+        }
+        var entries = zip(presets, strings).map { preset, string in
+            var params = preset.chainParams
+            params.convolutionMix = preset.convolutionMix
+            return VCPresetEntry(id: UnsafePointer(string.0), name: UnsafePointer(string.1),
+                                 impulseResponse: UnsafePointer(string.2), params: params)
+        }
+        return vc_preset_bank_write(path, &entries, Int32(entries.count)) == 0
+    }
+}
+
+extension VoicePreset {
+    /// バンクのレコードから（VCChainParams の逆変換）
+    init(id: String, name: String, impulseResponse: String?, chainParams params: VCChainParams) {
+        self.init(
+            id: id,
+            name: name,
+            pitchShift: params.pitchShift,
+            formantShift: params.formantShift,
+            eqLow: params.eqLow,
+            eqMid: params.eqMid,
+            eqHigh: params.eqHigh,
+            noiseSuppressionEnabled: params.noiseSuppressionEnabled != 0,
+            noiseSuppressionStrength: params.noiseSuppressionStrength,
+            agcEnabled: params.agcEnabled != 0,
+            agcTargetDb: params.agcTargetDb,
+            vadEnabled: params.vadEnabled != 0,
+            multibandEnabled: params.multibandEnabled != 0,
+            compressorThresholdDb: params.compressorThresholdDb,
+            compressorRatio: params.compressorRatio,
+            deEsserThresholdDb: params.deEsserThresholdDb,
+            deEsserRatio: params.deEsserRatio,
+            impulseResponse: impulseResponse,
+            convolutionMix: params.convolutionMix,
+            limiterOversampling: Int(params.limiterOversampling)
+        )
+    }
+
+    /// 組み込みプリセット（バンクがないとき・バンクにない id のフォールバック）
+    public static let builtins: [VoicePreset] = [.default, .maleToFemale, .femaleToMale, .phone, .radio, .hall, .duet]
+}
+
+// MARK: - Hot Reload
+
+/// 監視スレッドのコールバックから DSPChain へ戻るための箱（監視を止めるまで DSPChain が保持する）
+final class PresetBankReloadTarget {
+    weak var chain: DSPChain?
+
+    init(chain: DSPChain) {
+        self.chain = chain
+    }
+}
+
+/// VCPresetBankCallback（監視スレッドから呼ばれる。ブロックせずアクターへ投げるだけ）
+let presetBankDidChange: VCPresetBankCallback = { context in
+    guard let context else { return }
+    let target = Unmanaged<PresetBankReloadTarget>.fromOpaque(context).takeUnretainedValue()
+    guard let chain = target.chain else { return }
+    Task { await chain.adoptReloadedPresetBank() }
+}
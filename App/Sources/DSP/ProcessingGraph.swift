@@ -0,0 +1,139 @@
+import Foundation
+import VCCore
+
+/// プリセットが定義する DSP グラフ（VCGraph の記述）
+///
+/// ノードは配列の添字で参照し合う。並び順は自由で、実行順・作業バッファ・並行に処理する枝は
+/// プリセットを読み込んだときに VCGraph が 1 度だけ決める。
+/// エコーキャンセルは含まない（グラフのプリセットではエコー参照を使わない）
+public struct ProcessingGraph: Codable, Equatable, Sendable {
+
+    /// ノードの種類（param の意味は VCGraph.h の表）
+    public enum Kind: String, Codable, Sendable {
+        case input
+        case output
+        case highPass
+        case vad
+        case noiseGate
+        case agc
+        case pitchShift
+        case multiband
+        case eq
+        case convolver      // ウェットのみ（IR はプリセットの impulseResponse）
+        case limiter
+        case mix
+
+        var nodeKind: VCGraphNodeKind {
+            switch self {
+            case .input: return VC_GRAPH_NODE_INPUT
+            case .output: return VC_GRAPH_NODE_OUTPUT
+            case .highPass: return VC_GRAPH_NODE_HPF
+            case .vad: return VC_GRAPH_NODE_VAD
+            case .noiseGate: return VC_GRAPH_NODE_GATE
+            case .agc: return VC_GRAPH_NODE_AGC
+            case .pitchShift: return VC_GRAPH_NODE_PITCH_SHIFT
+            case .multiband: return VC_GRAPH_NODE_MULTIBAND
+            case .eq: return VC_GRAPH_NODE_EQ
+            case .convolver: return VC_GRAPH_NODE_CONVOLVER
+            case .limiter: return VC_GRAPH_NODE_LIMITER
+            case .mix: return VC_GRAPH_NODE_MIX
+            }
+        }
+    }
+
+    public struct Node: Codable, Equatable, Sendable {
+        public var kind: Kind
+        public var inputs: [Int]
+        public var gains: [Float]       // mix の各入力（省略時 1）
+        public var sidechain: Int?      // noiseGate / agc が従う vad ノード
+        public var params: [Float]      // 省略した分は種類ごとの既定値
+
+        public init(_ kind: Kind, inputs: [Int] = [], gains: [Float] = [], sidechain: Int? = nil, params: [Float] = []) {
+            self.kind = kind
+            self.inputs = inputs
+            self.gains = gains
+            self.sidechain = sidechain
+            self.params = params
+        }
+    }
+
+    public var nodes: [Node]
+
+    public init(nodes: [Node]) {
+        self.nodes = nodes
+    }
+
+    /// CONVOLVER ノードの番号（それぞれにプリセットの IR の畳み込みを付ける）
+    public var convolverNodes: [Int] {
+        nodes.indices.filter { nodes[$0].kind == .convolver }
+    }
+
+    /// VCGraph を作る（呼び出し側が vc_graph_destroy する。オーディオスレッドからは呼ばないこと）
+    /// - Parameter workerCount: 0 = 直列、> 0 = 独立な枝を補助スレッドと並行に処理
+    public func makeGraph(sampleRate: Int, workerCount: Int = 0) -> Result<OpaquePointer, VCGraphError> {
+        guard nodes.count <= Int(VC_GRAPH_MAX_NODES),
+              nodes.allSatisfy({ $0.inputs.count <= Int(VC_GRAPH_MAX_INPUTS) && $0.params.count <= 4 }) else {
+            return .failure(VC_GRAPH_ERROR_INVALID)
+        }
+
+        var descs: [VCGraphNodeDesc] = nodes.map { node in
+            var desc = VCGraphNodeDesc()
+            vc_graph_node_init(&desc, node.kind.nodeKind)
+            desc.inputCount = Int32(node.inputs.count)
+            desc.sidechain = Int32(node.sidechain ?? -1)
+            withUnsafeMutableBytes(of: &desc.inputs) { raw in
+                let inputs = raw.bindMemory(to: Int32.self)
+                for (i, input) in node.inputs.enumerated() {
+                    inputs[i] = Int32(input)
+                }
+            }
+            withUnsafeMutableBytes(of: &desc.gains) { raw in
+                let gains = raw.bindMemory(to: Float.self)
+                for (i, gain) in node.gains.prefix(gains.count).enumerated() {
+                    gains[i] = gain
+                }
+            }
+            withUnsafeMutableBytes(of: &desc.param) { raw in
+                let param = raw.bindMemory(to: Float.self)
+                for (i, value) in node.params.enumerated() {
+                    param[i] = value
+                }
+            }
+            return desc
+        }
+
+        var options = VCGraphOptions(naiveBuffers: 0, workerCount: Int32(workerCount))
+        var error = VC_GRAPH_OK
+        let graph = vc_graph_create(Int32(sampleRate), &descs, Int32(descs.count), &options, &error)
+        return graph.map { .success($0) } ?? .failure(error)
+    }
+}
+
+extension VCGraphError: Error {}
+
+// MARK: - Templates
+
+extension ProcessingGraph {
+    /// 原音に移調したレイヤーと残響を重ねる
+    ///
+    ///     input → highPass → vad → noiseGate → agc ─┬──────────────────────┬→ mix → limiter → output
+    ///                          └──(sidechain)───┘   ├→ pitchShift → eq ────┤
+    ///                                               └→ convolver ──────────┘
+    ///
+    /// レイヤーと畳み込みは互いに依存しないので、並行処理ではそれぞれ別のコアで動く
+    public static func layered(semitones: Float, dry: Float = 0.8, layer: Float = 0.45, wet: Float = 0.3) -> ProcessingGraph {
+        ProcessingGraph(nodes: [
+            Node(.input),                                           // 0
+            Node(.highPass, inputs: [0]),                           // 1
+            Node(.vad, inputs: [1]),                                // 2
+            Node(.noiseGate, inputs: [2], sidechain: 2),            // 3
+            Node(.agc, inputs: [3], sidechain: 2),                  // 4
+            Node(.pitchShift, inputs: [4], params: [semitones]),    // 5
+            Node(.eq, inputs: [5], params: [semitones < 0 ? 2 : 0, 0, semitones > 0 ? 2 : 0]),
+            Node(.convolver, inputs: [4]),                          // 7
+            Node(.mix, inputs: [4, 6, 7], gains: [dry, layer, wet]),
+            Node(.limiter, inputs: [8]),                            // 9
+            Node(.output, inputs: [9]),
+        ])
+    }
+}
@@ -31,6 +31,24 @@ public enum Constants {
             public static let balanced: Double = 40
             public static let highQuality: Double = 60
         }
+
+        /// モニター（ヘッドホン直出し）設定
+        public enum Monitor {
+            /// 目標遅延（ミリ秒）。実際はフレームサイズ + 出力バッファ以上に切り上げる
+            public static let targetLatencyMs: Double = 8
+
+            /// リング容量（ミリ秒）
+            public static let capacityMs: Double = 100
+        }
+
+        /// エコーキャンセラの参照（出力デバイスへ実際に出した信号）
+        public enum EchoReference {
+            /// 参照の読み出し遅延（ミリ秒）。出力 + 入力デバイスの遅延より短くすること
+            public static let latencyMs: Double = 8
+
+            /// リング容量（ミリ秒）
+            public static let capacityMs: Double = 100
+        }
     }
 
     // MARK: - DSP Settings
@@ -53,6 +71,9 @@ public enum Constants {
 
         /// フォルマントシフト範囲
         public static let formantRange: ClosedRange<Float> = -1...1
+
+        /// プリセットバンク（Application Support/VoiceChanger/ 以下、あれば起動時に読み込む）
+        public static let presetBankFileName = "Presets.vcpb"
     }
 
     // MARK: - UI Settings
@@ -1,5 +1,6 @@
 import Foundation
 import os.log
+import VCCore
 
 /// ログカテゴリ
 public enum LogCategory: String {
@@ -51,6 +52,43 @@ public struct LogEntry: Codable {
     }
 }
 
+/// 固定長の循環バッファ（満杯時は最古のエントリを上書き、追加は O(1)）
+struct LogHistory {
+    private var storage: [LogEntry?]
+    private var head = 0
+    private(set) var count = 0
+
+    init(capacity: Int) {
+        storage = [LogEntry?](repeating: nil, count: max(capacity, 1))
+    }
+
+    var capacity: Int {
+        storage.count
+    }
+
+    mutating func append(_ entry: LogEntry) {
+        storage[(head + count) % capacity] = entry
+        if count < capacity {
+            count += 1
+        } else {
+            head = (head + 1) % capacity
+        }
+    }
+
+    mutating func removeAll() {
+        for index in storage.indices {
+            storage[index] = nil
+        }
+        head = 0
+        count = 0
+    }
+
+    /// 古い順
+    var entries: [LogEntry] {
+        (0..<count).compactMap { storage[(head + $0) % capacity] }
+    }
+}
+
 /// ロガー
 public final class Logger {
 
@@ -58,10 +96,14 @@ public final class Logger {
 
     private let subsystem = Constants.App.bundleId
     private var osLoggers: [LogCategory: os.Logger] = [:]
-    private var logHistory: [LogEntry] = []
-    private let historyLimit = 1000
+    private var logHistory = LogHistory(capacity: 1000)
     private let queue = DispatchQueue(label: "com.voicechanger.logger", qos: .utility)
 
+    // RTスレッド用チャンネル（queue 上でのみ変更・読み出し）
+    private var realtimeChannels: [RealtimeLogChannel] = []
+    private var drainTimer: DispatchSourceTimer?
+    private let drainInterval: DispatchTimeInterval = .milliseconds(50)
+
     public var minimumLevel: LogLevel = .debug
 
     private init() {
@@ -97,11 +139,70 @@ public final class Logger {
             guard let self = self else { return }
             let entry = LogEntry(level: level, category: category, message: message, metadata: metadata)
             self.logHistory.append(entry)
+        }
+    }
+
+    // MARK: - Realtime Logging
+
+    /// RTスレッド用チャンネルを作成（RTスレッドの外で呼ぶこと）
+    /// 返されたチャンネルは1スレッドからのみ書き込む。記録されたイベントは定期的に読み出されて log() に流れる。
+    /// - Parameters:
+    ///   - label: チャンネル名（破棄イベントの報告に使用）
+    ///   - capacity: 未読出しイベントの上限
+    public func makeRealtimeChannel(label: String, capacity: Int = 1024) -> RealtimeLogChannel? {
+        guard let channel = RealtimeLogChannel(label: label, capacity: capacity) else { return nil }
+
+        queue.sync {
+            realtimeChannels.append(channel)
+            startDrainTimerIfNeeded()
+        }
+        return channel
+    }
+
+    /// RTチャンネルの登録解除（未読出しのイベントは読み出してから外す）
+    public func removeRealtimeChannel(_ channel: RealtimeLogChannel) {
+        queue.sync {
+            drain(channel)
+            realtimeChannels.removeAll { $0 === channel }
+        }
+    }
+
+    /// 全RTチャンネルを即座に読み出す
+    public func flushRealtimeChannels() {
+        queue.sync {
+            realtimeChannels.forEach { drain($0) }
+        }
+    }
+
+    private func startDrainTimerIfNeeded() {
+        guard drainTimer == nil else { return }
+
+        let timer = DispatchSource.makeTimerSource(queue: queue)
+        timer.schedule(deadline: .now() + drainInterval, repeating: drainInterval)
+        timer.setEventHandler { [weak self] in
+            guard let self = self else { return }
+            self.realtimeChannels.forEach { self.drain($0) }
+        }
+        timer.resume()
+        drainTimer = timer
+    }
+
+    /// queue 上で呼ぶ
+    private func drain(_ channel: RealtimeLogChannel) {
+        var raw = VCLogEvent()
+        while vc_log_ring_read(channel.ring, &raw) != 0 {
+            guard let event = RealtimeEvent(rawValue: raw.eventId) else { continue }
+
+            let args = withUnsafeBytes(of: raw.args) { Array($0.bindMemory(to: Double.self).prefix(Int(raw.argCount))) }
+            let level = LogLevel(rawValue: Int(raw.level)) ?? event.level
+            // log() は履歴追加を queue.async するので、そのまま呼んでもデッドロックしない
+            log(level, category: event.category, event.message(args),
+                metadata: ["rt.channel": channel.label, "rt.timestampNs": String(raw.timestampNs)])
+        }
 
-            // 履歴サイズを制限
-            if self.logHistory.count > self.historyLimit {
-                self.logHistory.removeFirst(self.logHistory.count - self.historyLimit)
-            }
+        let dropped = channel.takeNewDrops()
+        if dropped > 0 {
+            log(.warning, category: .audio, "Realtime log channel '\(channel.label)' dropped \(dropped) events")
         }
     }
 
@@ -132,7 +233,7 @@ public final class Logger {
     /// ログをJSONとしてエクスポート
     public func exportJSON() -> Data? {
         queue.sync {
-            try? JSONEncoder().encode(logHistory)
+            try? JSONEncoder().encode(logHistory.entries)
         }
     }
 
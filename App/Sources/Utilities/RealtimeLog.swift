@@ -0,0 +1,87 @@
+import Foundation
+import VCCore
+
+/// RTスレッドから記録するログイベント
+/// 文字列はRTスレッドで作らず、イベントIDと数値引数だけをリングに書き込む。
+/// 整形は Logger のバックグラウンド drain で行う。
+public enum RealtimeEvent: UInt32, CaseIterable {
+    case renderFailed = 1           // args: OSStatus
+    case inputBufferTooSmall = 2    // args: 要求フレーム数, 確保済みフレーム数
+    case processingBacklog = 3      // args: 未処理ブロック数
+    case sharedMemoryShortWrite = 4 // args: 要求サンプル数, 書き込めたサンプル数
+    case dspOverload = 5            // args: 処理時間(ms), ブロック時間(ms)
+
+    var level: LogLevel {
+        switch self {
+        case .renderFailed: return .error
+        case .inputBufferTooSmall: return .warning
+        case .processingBacklog: return .warning
+        case .sharedMemoryShortWrite: return .warning
+        case .dspOverload: return .warning
+        }
+    }
+
+    var category: LogCategory {
+        switch self {
+        case .renderFailed, .inputBufferTooSmall, .sharedMemoryShortWrite:
+            return .audio
+        case .processingBacklog, .dspOverload:
+            return .dsp
+        }
+    }
+
+    func message(_ args: [Double]) -> String {
+        func arg(_ index: Int) -> Int { index < args.count ? Int(args[index]) : 0 }
+
+        switch self {
+        case .renderFailed:
+            return "AudioUnitRender failed: \(arg(0))"
+        case .inputBufferTooSmall:
+            return "Input buffer too small: requested \(arg(0)) frames, allocated \(arg(1))"
+        case .processingBacklog:
+            return "DSP processing backlog: \(arg(0)) blocks pending"
+        case .sharedMemoryShortWrite:
+            return "SharedMemory short write: \(arg(1)) of \(arg(0)) samples"
+        case .dspOverload:
+            return String(format: "DSP overload: %.2f ms for %.2f ms block", args.first ?? 0, args.count > 1 ? args[1] : 0)
+        }
+    }
+}
+
+/// RTスレッド専用のログチャンネル
+/// 書き込みスレッドはチャンネルごとに1本（SPSC）。書き込みは wait-free で、満杯時は破棄して数える。
+public final class RealtimeLogChannel: @unchecked Sendable {
+
+    public let label: String
+
+    let ring: OpaquePointer
+    private var reportedDrops: UInt64 = 0
+
+    init?(label: String, capacity: Int) {
+        guard let ring = vc_log_ring_create(Int32(capacity)) else { return nil }
+        self.label = label
+        self.ring = ring
+    }
+
+    deinit {
+        vc_log_ring_destroy(ring)
+    }
+
+    /// イベント記録（RTスレッドから呼び出し可）
+    @inline(__always)
+    public func log(_ event: RealtimeEvent, _ arg0: Double = 0, _ arg1: Double = 0) {
+        vc_log_ring_write(ring, event.rawValue, VCLogLevel(UInt32(event.level.rawValue)), 2, arg0, arg1, 0, 0)
+    }
+
+    /// 破棄されたイベント数（累計）
+    public var droppedCount: UInt64 {
+        vc_log_ring_dropped(ring)
+    }
+
+    /// 前回の呼び出し以降に破棄された数（drain スレッドから）
+    func takeNewDrops() -> UInt64 {
+        let dropped = droppedCount
+        defer { reportedDrops = dropped }
+        return dropped - reportedDrops
+    }
+}
@@ -0,0 +1,21 @@
+//
+//  VCAlloc.h
+//  VoiceChanger
+//
+//  Internal counted heap allocation (every VCCore module allocates through these)
+//
+
+#ifndef VCAlloc_h
+#define VCAlloc_h
+
+#include <stddef.h>
+
+/// libc の malloc / calloc / aligned_alloc / free と同じ意味。
+/// 確保の回数を数え、リアルタイム区間（vc_realtime_enter 〜 exit）での確保を別に数える。
+/// ドライバと共有するソース（VCLog.c / VCSharedRing.c）は単体でビルドされるため使わない
+void *vc_malloc(size_t size);
+void *vc_calloc(size_t count, size_t size);
+void *vc_aligned_alloc(size_t alignment, size_t size);
+void vc_free(void *pointer);
+
+#endif /* VCAlloc_h */
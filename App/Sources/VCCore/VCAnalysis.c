@@ -0,0 +1,278 @@
+//
+//  VCAnalysis.c
+//  VoiceChanger
+//
+//  Per-block spectral analysis context (lazy STFT / magnitude / log-spectrum / LPC)
+//
+
+#include "include/VCAnalysis.h"
+#include "include/VCFFT.h"
+#include "include/VCFastMath.h"
+#include "VCSimd.h"
+#include "VCAlloc.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define kPowerFloor         1e-12f
+#define kNoiseCorrection    1.0001f     // 自己相関 r(0) に足す白色雑音（-40 dB、Levinson の安定化）
+
+/// フレーム単位のキャッシュ（VC_ANALYSIS_BINS ずつ）
+enum {
+    kSliceRe,
+    kSliceIm,
+    kSlicePower,
+    kSliceMagnitude,
+    kSliceLog,
+    kSliceCount
+};
+
+struct VCAnalysisContext {
+    VCFFTPlan *plan;
+    int ownsPlan;           // キャッシュを使わないときは自前のプランと窓
+    const float *window;
+    float ownWindow[VC_ANALYSIS_FFT_SIZE];
+    float frame[VC_ANALYSIS_FFT_SIZE];      // 窓掛け後 / 自己相関
+    float zeros[VC_ANALYSIS_BINS];
+
+    int frameCapacity;      // 1ブロックの最大フレーム数
+    int historySize;        // FFT_SIZE + (frameCapacity - 1) * HOP
+    float *history;         // 直近 historySize サンプル（末尾が最新）
+    float *slices;          // [kSliceCount][frameCapacity][BINS]
+
+    int frameCount;
+    uint32_t valid[kSliceCount];    // 計算済みフレームのビットマスク（re/im は kSliceRe で代表）
+    int lpcValid;
+    float lpc[VC_ANALYSIS_LPC_ORDER + 1];
+    float lpcError;
+
+    uint64_t fftCount;
+};
+
+#pragma mark - Lifecycle
+
+VCAnalysisContext *vc_analysis_create(int maxFrameSize, VCPlanCache *cache) {
+    VCAnalysisContext *context = vc_calloc(1, sizeof(VCAnalysisContext));
+    if (context == NULL) {
+        return NULL;
+    }
+
+    int capacity = maxFrameSize / VC_ANALYSIS_HOP;
+    if (capacity < 1) {
+        capacity = 1;
+    }
+    if (capacity > VC_ANALYSIS_MAX_FRAMES) {
+        capacity = VC_ANALYSIS_MAX_FRAMES;
+    }
+    context->frameCapacity = capacity;
+    context->historySize = VC_ANALYSIS_FFT_SIZE + (capacity - 1) * VC_ANALYSIS_HOP;
+    context->history = vc_calloc((size_t)context->historySize, sizeof(float));
+    context->slices = vc_calloc((size_t)kSliceCount * capacity * VC_ANALYSIS_BINS, sizeof(float));
+
+    if (cache != NULL) {
+        context->plan = vc_plan_cache_fft(cache, VC_ANALYSIS_FFT_SIZE);
+        context->window = vc_plan_cache_window(cache, VC_WINDOW_HANN, VC_ANALYSIS_FFT_SIZE);
+    } else {
+        context->plan = vc_fft_plan_create(VC_ANALYSIS_FFT_SIZE);
+        context->ownsPlan = 1;
+        for (int i = 0; i < VC_ANALYSIS_FFT_SIZE; i++) {
+            context->ownWindow[i] = 0.5f - 0.5f * (float)cos(2.0 * M_PI * i / VC_ANALYSIS_FFT_SIZE);
+        }
+        context->window = context->ownWindow;
+    }
+
+    if (context->history == NULL || context->slices == NULL || context->plan == NULL || context->window == NULL) {
+        vc_analysis_destroy(context);
+        return NULL;
+    }
+    vc_analysis_reset(context);
+    return context;
+}
+
+void vc_analysis_destroy(VCAnalysisContext *context) {
+    if (context == NULL) {
+        return;
+    }
+    if (context->ownsPlan) {
+        vc_fft_plan_destroy(context->plan);
+    }
+    vc_free(context->history);
+    vc_free(context->slices);
+    vc_free(context);
+}
+
+void vc_analysis_reset(VCAnalysisContext *context) {
+    memset(context->history, 0, (size_t)context->historySize * sizeof(float));
+    memset(context->valid, 0, sizeof(context->valid));
+    context->lpcValid = 0;
+    context->frameCount = 1;
+}
+
+uint64_t vc_analysis_fft_count(const VCAnalysisContext *context) {
+    return context->fftCount;
+}
+
+#pragma mark - Block
+
+void vc_analysis_begin_block(VCAnalysisContext *context, const float *samples, int count) {
+    if (count <= 0) {
+        return;
+    }
+
+    int size = context->historySize;
+    if (count >= size) {
+        memcpy(context->history, samples + count - size, (size_t)size * sizeof(float));
+    } else {
+        memmove(context->history, context->history + count, (size_t)(size - count) * sizeof(float));
+        memcpy(context->history + size - count, samples, (size_t)count * sizeof(float));
+    }
+
+    int frames = count / VC_ANALYSIS_HOP;
+    if (frames < 1) {
+        frames = 1;
+    }
+    context->frameCount = frames < context->frameCapacity ? frames : context->frameCapacity;
+    memset(context->valid, 0, sizeof(context->valid));
+    context->lpcValid = 0;
+}
+
+int vc_analysis_frame_count(const VCAnalysisContext *context) {
+    return context->frameCount;
+}
+
+static inline float *slice(const VCAnalysisContext *context, int kind, int frame) {
+    return context->slices + ((size_t)kind * context->frameCapacity + (size_t)frame) * VC_ANALYSIS_BINS;
+}
+
+static inline int clamp_frame(const VCAnalysisContext *context, int frame) {
+    if (frame < 0) {
+        return 0;
+    }
+    return frame < context->frameCount ? frame : context->frameCount - 1;
+}
+
+#pragma mark - Spectra
+
+static void ensure_spectrum(VCAnalysisContext *context, int frame) {
+    uint32_t bit = 1u << frame;
+    if (context->valid[kSliceRe] & bit) {
+        return;
+    }
+
+    // フレーム frame はブロック末尾から (frameCount - 1 - frame) ホップ前で終わる
+    int end = context->historySize - (context->frameCount - 1 - frame) * VC_ANALYSIS_HOP;
+    const float *x = context->history + end - VC_ANALYSIS_FFT_SIZE;
+    int i = 0;
+#if VC_HAS_VECTOR_EXT
+    for (; i + 4 <= VC_ANALYSIS_FFT_SIZE; i += 4) {
+        vc_store4(context->frame + i, vc_load4(x + i) * vc_load4(context->window + i));
+    }
+#endif
+    for (; i < VC_ANALYSIS_FFT_SIZE; i++) {
+        context->frame[i] = x[i] * context->window[i];
+    }
+
+    vc_fft_forward(context->plan, context->frame, slice(context, kSliceRe, frame), slice(context, kSliceIm, frame));
+    context->fftCount++;
+    context->valid[kSliceRe] |= bit;
+}
+
+void vc_analysis_spectrum(VCAnalysisContext *context, int frame, const float **outRe, const float **outIm) {
+    frame = clamp_frame(context, frame);
+    ensure_spectrum(context, frame);
+    *outRe = slice(context, kSliceRe, frame);
+    *outIm = slice(context, kSliceIm, frame);
+}
+
+const float *vc_analysis_power(VCAnalysisContext *context, int frame) {
+    frame = clamp_frame(context, frame);
+    float *power = slice(context, kSlicePower, frame);
+    uint32_t bit = 1u << frame;
+    if (!(context->valid[kSlicePower] & bit)) {
+        ensure_spectrum(context, frame);
+        vc_complex_power(slice(context, kSliceRe, frame), slice(context, kSliceIm, frame), power,
+                         VC_ANALYSIS_BINS);
+        context->valid[kSlicePower] |= bit;
+    }
+    return power;
+}
+
+const float *vc_analysis_magnitude(VCAnalysisContext *context, int frame) {
+    frame = clamp_frame(context, frame);
+    float *magnitude = slice(context, kSliceMagnitude, frame);
+    uint32_t bit = 1u << frame;
+    if (!(context->valid[kSliceMagnitude] & bit)) {
+        const float *power = vc_analysis_power(context, frame);
+        for (int k = 0; k < VC_ANALYSIS_BINS; k++) {
+            magnitude[k] = sqrtf(power[k]);
+        }
+        context->valid[kSliceMagnitude] |= bit;
+    }
+    return magnitude;
+}
+
+const float *vc_analysis_log_spectrum(VCAnalysisContext *context, int frame) {
+    frame = clamp_frame(context, frame);
+    float *logSpectrum = slice(context, kSliceLog, frame);
+    uint32_t bit = 1u << frame;
+    if (!(context->valid[kSliceLog] & bit)) {
+        const float *power = vc_analysis_power(context, frame);
+        for (int k = 0; k < VC_ANALYSIS_BINS; k++) {
+            logSpectrum[k] = power[k] + kPowerFloor;
+        }
+        vc_fast_log(logSpectrum, logSpectrum, VC_ANALYSIS_BINS);
+        context->valid[kSliceLog] |= bit;
+    }
+    return logSpectrum;
+}
+
+#pragma mark - LPC
+
+const float *vc_analysis_lpc(VCAnalysisContext *context, float *outError) {
+    if (!context->lpcValid) {
+        // |X|^2 の逆 FFT = 窓掛けフレームの（循環）自己相関。
+        // 低次のラグでは折り返し分が Hann 窓の両端同士の積になり無視できる
+        const float *power = vc_analysis_power(context, context->frameCount - 1);
+        float *r = context->frame;
+        vc_fft_inverse(context->plan, power, context->zeros, r);
+        context->fftCount++;
+
+        float *a = context->lpc;
+        memset(a, 0, sizeof(context->lpc));
+        a[0] = 1.0f;
+        context->lpcError = 1.0f;
+
+        float error = r[0] * kNoiseCorrection;
+        if (error > kPowerFloor) {
+            float initial = error;
+            for (int i = 1; i <= VC_ANALYSIS_LPC_ORDER; i++) {
+                float acc = r[i];
+                for (int j = 1; j < i; j++) {
+                    acc += a[j] * r[i - j];
+                }
+                float k = -acc / error;
+
+                // a[j] += k a[i - j] を両端から同時に
+                for (int j = 1; j <= i / 2; j++) {
+                    float lo = a[j];
+                    float hi = a[i - j];
+                    a[j] = lo + k * hi;
+                    a[i - j] = hi + k * lo;
+                }
+                a[i] = k;
+                error *= 1.0f - k * k;
+            }
+            context->lpcError = error / initial;
+        }
+        context->lpcValid = 1;
+    }
+
+    if (outError != NULL) {
+        *outError = context->lpcError;
+    }
+    return context->lpc;
+}
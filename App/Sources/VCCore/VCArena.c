@@ -0,0 +1,287 @@
+//
+//  VCArena.c
+//  VoiceChanger
+//
+//  Preallocated arena, FFT plan / window cache and allocation accounting
+//
+
+#include "include/VCArena.h"
+#include "VCAlloc.h"
+#include <math.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__APPLE__)
+#include <pthread.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define kArenaAlignment 64
+#define kCacheSlots     17      // 2^0 〜 2^16（VC_FFT_MAX_SIZE）
+
+#pragma mark - Allocation Accounting
+
+static atomic_uint_fast64_t gAllocations;
+static atomic_uint_fast64_t gRealtimeAllocations;
+static _Thread_local int tRealtimeDepth;
+
+static inline void count_allocation(void) {
+    atomic_fetch_add_explicit(&gAllocations, 1, memory_order_relaxed);
+    if (tRealtimeDepth > 0) {
+        atomic_fetch_add_explicit(&gRealtimeAllocations, 1, memory_order_relaxed);
+    }
+}
+
+void *vc_malloc(size_t size) {
+    count_allocation();
+    return malloc(size);
+}
+
+void *vc_calloc(size_t count, size_t size) {
+    count_allocation();
+    return calloc(count, size);
+}
+
+void *vc_aligned_alloc(size_t alignment, size_t size) {
+    count_allocation();
+    // aligned_alloc はサイズが境界の倍数であることを要求する
+    size_t rounded = (size + alignment - 1) & ~(alignment - 1);
+    return aligned_alloc(alignment, rounded > 0 ? rounded : alignment);
+}
+
+void vc_free(void *pointer) {
+    free(pointer);
+}
+
+uint64_t vc_alloc_count(void) {
+    return atomic_load_explicit(&gAllocations, memory_order_relaxed);
+}
+
+#if defined(__APPLE__)
+// libmalloc が全ゾーンの確保・解放のたびに呼ぶフック（MallocStackLogging と同じ入口。公開ヘッダにはない）
+typedef void (MallocLogger)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result,
+                            uint32_t hotFramesToSkip);
+extern MallocLogger *malloc_logger;
+
+#define kMallocLogAllocate  2u
+
+static atomic_uint_fast64_t gRealtimeHeapAllocations;
+static MallocLogger *gPreviousLogger;
+static pthread_key_t gRealtimeKey;      // フックからはスレッドローカル変数を読まない（初回アクセスで確保が走る）
+static pthread_once_t gRealtimeKeyOnce = PTHREAD_ONCE_INIT;
+static atomic_int gRealtimeKeyReady;
+
+static void create_realtime_key(void) {
+    if (pthread_key_create(&gRealtimeKey, NULL) == 0) {
+        atomic_store(&gRealtimeKeyReady, 1);
+    }
+}
+
+static void mirror_realtime_depth(void) {
+    if (atomic_load_explicit(&gRealtimeKeyReady, memory_order_relaxed)) {
+        pthread_setspecific(gRealtimeKey, (void *)(intptr_t)tRealtimeDepth);
+    }
+}
+
+static void count_heap_allocation(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result,
+                                  uint32_t hotFramesToSkip) {
+    if ((type & kMallocLogAllocate) && pthread_getspecific(gRealtimeKey) != NULL) {
+        atomic_fetch_add_explicit(&gRealtimeHeapAllocations, 1, memory_order_relaxed);
+    }
+    if (gPreviousLogger != NULL) {
+        gPreviousLogger(type, arg1, arg2, arg3, result, hotFramesToSkip + 1);
+    }
+}
+
+int vc_realtime_track_heap(int enabled) {
+    pthread_once(&gRealtimeKeyOnce, create_realtime_key);
+    if (!atomic_load(&gRealtimeKeyReady)) {
+        return 0;
+    }
+    if (enabled && malloc_logger != count_heap_allocation) {
+        gPreviousLogger = malloc_logger;
+        malloc_logger = count_heap_allocation;
+    } else if (!enabled && malloc_logger == count_heap_allocation) {
+        malloc_logger = gPreviousLogger;
+        gPreviousLogger = NULL;
+    }
+    mirror_realtime_depth();
+    return 1;
+}
+
+uint64_t vc_realtime_heap_alloc_count(void) {
+    return atomic_load_explicit(&gRealtimeHeapAllocations, memory_order_relaxed);
+}
+#else
+static void mirror_realtime_depth(void) {
+}
+
+int vc_realtime_track_heap(int enabled) {
+    (void)enabled;
+    return 0;
+}
+
+uint64_t vc_realtime_heap_alloc_count(void) {
+    return 0;
+}
+#endif
+
+void vc_realtime_enter(void) {
+    tRealtimeDepth++;
+    mirror_realtime_depth();
+}
+
+void vc_realtime_exit(void) {
+    if (tRealtimeDepth > 0) {
+        tRealtimeDepth--;
+    }
+    mirror_realtime_depth();
+}
+
+uint64_t vc_realtime_alloc_count(void) {
+    return atomic_load_explicit(&gRealtimeAllocations, memory_order_relaxed);
+}
+
+#pragma mark - Arena
+
+struct VCArena {
+    unsigned char *base;
+    size_t capacity;
+    size_t used;
+};
+
+VCArena *vc_arena_create(size_t capacity) {
+    VCArena *arena = vc_calloc(1, sizeof(VCArena));
+    if (arena == NULL) {
+        return NULL;
+    }
+    arena->capacity = (capacity + kArenaAlignment - 1) & ~(size_t)(kArenaAlignment - 1);
+    arena->base = vc_aligned_alloc(kArenaAlignment, arena->capacity);
+    if (arena->base == NULL) {
+        vc_free(arena);
+        return NULL;
+    }
+    memset(arena->base, 0, arena->capacity);
+    return arena;
+}
+
+void vc_arena_destroy(VCArena *arena) {
+    if (arena == NULL) {
+        return;
+    }
+    vc_free(arena->base);
+    vc_free(arena);
+}
+
+void *vc_arena_alloc(VCArena *arena, size_t size) {
+    size_t rounded = (size + kArenaAlignment - 1) & ~(size_t)(kArenaAlignment - 1);
+    if (rounded > arena->capacity - arena->used) {
+        return NULL;
+    }
+    void *pointer = arena->base + arena->used;
+    arena->used += rounded;
+    return pointer;
+}
+
+float *vc_arena_floats(VCArena *arena, int count) {
+    return count > 0 ? vc_arena_alloc(arena, (size_t)count * sizeof(float)) : NULL;
+}
+
+size_t vc_arena_used(const VCArena *arena) {
+    return arena->used;
+}
+
+size_t vc_arena_capacity(const VCArena *arena) {
+    return arena->capacity;
+}
+
+void vc_arena_reset(VCArena *arena) {
+    memset(arena->base, 0, arena->used);
+    arena->used = 0;
+}
+
+#pragma mark - Plan Cache
+
+struct VCPlanCache {
+    VCFFTPlan *plans[kCacheSlots];
+    float *windows[VC_WINDOW_TYPE_COUNT][kCacheSlots];
+};
+
+/// 2 のべき乗の指数（それ以外は -1）
+static int slot_for_size(int size) {
+    if (size <= 0 || (size & (size - 1)) != 0) {
+        return -1;
+    }
+    int slot = 0;
+    while ((1 << slot) < size) {
+        slot++;
+    }
+    return slot < kCacheSlots ? slot : -1;
+}
+
+VCPlanCache *vc_plan_cache_create(void) {
+    return vc_calloc(1, sizeof(VCPlanCache));
+}
+
+void vc_plan_cache_destroy(VCPlanCache *cache) {
+    if (cache == NULL) {
+        return;
+    }
+    for (int slot = 0; slot < kCacheSlots; slot++) {
+        vc_fft_plan_destroy(cache->plans[slot]);
+        for (int type = 0; type < VC_WINDOW_TYPE_COUNT; type++) {
+            vc_free(cache->windows[type][slot]);
+        }
+    }
+    vc_free(cache);
+}
+
+int vc_plan_cache_prepare(VCPlanCache *cache, int maxFrameSize) {
+    for (int size = VC_FFT_MIN_SIZE * 8; size <= 2 * maxFrameSize && size <= VC_FFT_MAX_SIZE; size <<= 1) {
+        if (vc_plan_cache_fft(cache, size) == NULL) {
+            return -1;
+        }
+        for (int type = 0; type < VC_WINDOW_TYPE_COUNT; type++) {
+            if (vc_plan_cache_window(cache, (VCWindowType)type, size) == NULL) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+VCFFTPlan *vc_plan_cache_fft(VCPlanCache *cache, int size) {
+    int slot = slot_for_size(size);
+    if (slot < 0) {
+        return NULL;
+    }
+    if (cache->plans[slot] == NULL) {
+        cache->plans[slot] = vc_fft_plan_create(size);
+    }
+    return cache->plans[slot];
+}
+
+const float *vc_plan_cache_window(VCPlanCache *cache, VCWindowType type, int size) {
+    int slot = slot_for_size(size);
+    if (slot < 0 || type < 0 || type >= VC_WINDOW_TYPE_COUNT) {
+        return NULL;
+    }
+    float *window = cache->windows[type][slot];
+    if (window != NULL) {
+        return window;
+    }
+
+    window = vc_malloc((size_t)size * sizeof(float));
+    if (window == NULL) {
+        return NULL;
+    }
+    for (int i = 0; i < size; i++) {
+        double hann = 0.5 - 0.5 * cos(2.0 * M_PI * i / size);
+        window[i] = (float)(type == VC_WINDOW_SQRT_HANN ? sqrt(hann) : hann);
+    }
+    cache->windows[type][slot] = window;
+    return window;
+}
@@ -0,0 +1,115 @@
+//
+//  VCAudioRing.c
+//  VoiceChanger
+//
+//  Portable lock-free SPSC float ring with zero-copy region access
+//
+
+#include "include/VCAudioRing.h"
+#include "include/VCSharedRing.h"
+#include "VCAlloc.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define kCacheLineSize 64
+
+// プロセス内リングも共有メモリと同じコア（VCSharedRing）をヒープ上に置いて使う
+struct VCAudioRing {
+    VCSharedRing view;
+    void *memory;
+    atomic_int blockSize;       // consumer がまとめて読む長さ（producer は滞留をブロック数で見るのに使う）
+};
+
+static uint32_t round_up_pow2(uint32_t value) {
+    uint32_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+VCAudioRing *vc_audio_ring_create(int capacity) {
+    if (capacity <= 0 || capacity > (1 << 26)) {
+        return NULL;
+    }
+    // uint32 インデックスの折り返しで位置がずれないよう2のべき乗にする
+    capacity = (int)round_up_pow2((uint32_t)capacity);
+
+    VCAudioRing *ring = vc_calloc(1, sizeof(VCAudioRing));
+    if (ring == NULL) {
+        return NULL;
+    }
+
+    size_t size = vc_shared_ring_size(capacity);
+    ring->memory = vc_aligned_alloc(kCacheLineSize, (size + kCacheLineSize - 1) & ~(size_t)(kCacheLineSize - 1));
+    if (ring->memory == NULL) {
+        vc_free(ring);
+        return NULL;
+    }
+    memset(ring->memory, 0, size);
+    vc_shared_ring_format(&ring->view, ring->memory, size, 0, 0, capacity);
+    atomic_init(&ring->blockSize, 1);
+    return ring;
+}
+
+void vc_audio_ring_destroy(VCAudioRing *ring) {
+    if (ring == NULL) {
+        return;
+    }
+    vc_free(ring->memory);
+    vc_free(ring);
+}
+
+VCSharedRing *vc_audio_ring_view(VCAudioRing *ring) {
+    return &ring->view;
+}
+
+int vc_audio_ring_capacity(const VCAudioRing *ring) {
+    return (int)ring->view.capacity;
+}
+
+void vc_audio_ring_set_block_size(VCAudioRing *ring, int blockSize) {
+    atomic_store_explicit(&ring->blockSize, blockSize > 0 ? blockSize : 1, memory_order_relaxed);
+}
+
+int vc_audio_ring_block_size(const VCAudioRing *ring) {
+    return atomic_load_explicit(&((VCAudioRing *)ring)->blockSize, memory_order_relaxed);
+}
+
+int vc_audio_ring_available_read(const VCAudioRing *ring) {
+    return vc_shared_ring_available_read(&ring->view);
+}
+
+int vc_audio_ring_available_write(const VCAudioRing *ring) {
+    return vc_shared_ring_available_write(&ring->view);
+}
+
+int vc_audio_ring_write_regions(VCAudioRing *ring, int count, VCRingRegions *outRegions) {
+    return vc_shared_ring_write_regions(&ring->view, count, outRegions);
+}
+
+void vc_audio_ring_commit_write(VCAudioRing *ring, int count) {
+    vc_shared_ring_commit_write(&ring->view, count);
+}
+
+int vc_audio_ring_read_regions(VCAudioRing *ring, int count, VCRingRegions *outRegions) {
+    return vc_shared_ring_read_regions(&ring->view, count, outRegions);
+}
+
+void vc_audio_ring_commit_read(VCAudioRing *ring, int count) {
+    vc_shared_ring_commit_read(&ring->view, count);
+}
+
+int vc_audio_ring_write(VCAudioRing *ring, const float *samples, int count) {
+    return vc_shared_ring_write(&ring->view, samples, count);
+}
+
+int vc_audio_ring_read(VCAudioRing *ring, float *samples, int count) {
+    return vc_shared_ring_read(&ring->view, samples, count);
+}
+
+void vc_audio_ring_reset(VCAudioRing *ring) {
+    vc_shared_ring_reset(&ring->view);
+}
@@ -0,0 +1,487 @@
+//
+//  VCBatch.c
+//  VoiceChanger
+//
+//  Structure-of-arrays kernels that advance 4/8/16 streams per sample
+//
+
+#include "include/VCBatch.h"
+#include "include/VCDynamics.h"
+#include "include/VCVad.h"
+#include "VCSimd.h"
+#include "VCAlloc.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// VCChain と同じトポロジ定数
+#define kHpfCutoffHz    80.0f
+#define kHpfQ           0.707f
+#define kEqLowFreq      200.0f
+#define kEqMidFreq      1000.0f
+#define kEqHighFreq     4000.0f
+
+static float clampf(float value, float lo, float hi) {
+    return fmaxf(lo, fminf(hi, value));
+}
+
+static int valid_lanes(int lanes) {
+    return lanes > 0 && lanes <= VC_BATCH_MAX_LANES && lanes % 4 == 0;
+}
+
+#pragma mark - Biquad Batch
+
+int vc_biquad_batch_init(VCBiquadBatch *batch, int lanes) {
+    if (!valid_lanes(lanes)) {
+        return -1;
+    }
+    memset(batch, 0, sizeof(*batch));
+    batch->lanes = lanes;
+    for (int lane = 0; lane < lanes; lane++) {
+        batch->b0[lane] = 1.0f;
+    }
+    return 0;
+}
+
+void vc_biquad_batch_set_lane(VCBiquadBatch *batch, int lane, const VCBiquadCoeffs *coeffs) {
+    if (lane < 0 || lane >= batch->lanes) {
+        return;
+    }
+    batch->b0[lane] = coeffs->b0;
+    batch->b1[lane] = coeffs->b1;
+    batch->b2[lane] = coeffs->b2;
+    batch->a1[lane] = coeffs->a1;
+    batch->a2[lane] = coeffs->a2;
+}
+
+void vc_biquad_batch_process(VCBiquadBatch *batch, float *samples, int frames) {
+    const int lanes = batch->lanes;
+
+#if VC_HAS_VECTOR_EXT
+    // 4レーンずつ、係数と状態をレジスタに保持したままサンプル方向に進める
+    for (int g = 0; g < lanes; g += 4) {
+        const vc_f32x4 b0 = vc_load4(&batch->b0[g]);
+        const vc_f32x4 b1 = vc_load4(&batch->b1[g]);
+        const vc_f32x4 b2 = vc_load4(&batch->b2[g]);
+        const vc_f32x4 a1 = vc_load4(&batch->a1[g]);
+        const vc_f32x4 a2 = vc_load4(&batch->a2[g]);
+        vc_f32x4 x1 = vc_load4(&batch->x1[g]);
+        vc_f32x4 x2 = vc_load4(&batch->x2[g]);
+        vc_f32x4 y1 = vc_load4(&batch->y1[g]);
+        vc_f32x4 y2 = vc_load4(&batch->y2[g]);
+
+        float *p = samples + g;
+        for (int i = 0; i < frames; i++, p += lanes) {
+            vc_f32x4 x0 = vc_load4(p);
+            vc_f32x4 y0 = b0 * x0 + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+            x2 = x1;
+            x1 = x0;
+            y2 = y1;
+            y1 = y0;
+            vc_store4(p, y0);
+        }
+
+        vc_store4(&batch->x1[g], x1);
+        vc_store4(&batch->x2[g], x2);
+        vc_store4(&batch->y1[g], y1);
+        vc_store4(&batch->y2[g], y2);
+    }
+#else
+    for (int lane = 0; lane < lanes; lane++) {
+        VCBiquadCoeffs coeffs = { batch->b0[lane], batch->b1[lane], batch->b2[lane], batch->a1[lane], batch->a2[lane] };
+        VCBiquadState state = { batch->x1[lane], batch->x2[lane], batch->y1[lane], batch->y2[lane] };
+        for (int i = 0; i < frames; i++) {
+            float *p = &samples[i * lanes + lane];
+            vc_biquad_process(&coeffs, &state, p, p, 1);
+        }
+        batch->x1[lane] = state.x1;
+        batch->x2[lane] = state.x2;
+        batch->y1[lane] = state.y1;
+        batch->y2[lane] = state.y2;
+    }
+#endif
+}
+
+void vc_biquad_batch_reset(VCBiquadBatch *batch) {
+    memset(batch->x1, 0, sizeof(batch->x1));
+    memset(batch->x2, 0, sizeof(batch->x2));
+    memset(batch->y1, 0, sizeof(batch->y1));
+    memset(batch->y2, 0, sizeof(batch->y2));
+}
+
+#pragma mark - Limiter Batch
+
+int vc_limiter_batch_init(VCLimiterBatch *batch, int lanes) {
+    if (!valid_lanes(lanes)) {
+        return -1;
+    }
+
+    VCLimiter reference;
+    vc_limiter_init(&reference);
+
+    memset(batch, 0, sizeof(*batch));
+    batch->lanes = lanes;
+    batch->attackCoeff = reference.attackCoeff;
+    batch->releaseCoeff = reference.releaseCoeff;
+    for (int lane = 0; lane < lanes; lane++) {
+        batch->ceiling[lane] = reference.ceiling;
+        batch->threshold[lane] = reference.threshold;
+    }
+    return 0;
+}
+
+void vc_limiter_batch_process(VCLimiterBatch *batch, float *samples, int frames) {
+    const int lanes = batch->lanes;
+    const float attack = batch->attackCoeff;
+    const float release = batch->releaseCoeff;
+
+#if VC_HAS_VECTOR_EXT
+    const vc_f32x4 vAttack = vc_splat4(attack);
+    const vc_f32x4 vAttackKeep = vc_splat4(1.0f - attack);
+    const vc_f32x4 vRelease = vc_splat4(release);
+    const vc_f32x4 vReleaseKeep = vc_splat4(1.0f - release);
+    const vc_f32x4 vOne = vc_splat4(1.0f);
+    const vc_f32x4 vFloor = vc_splat4(0.0001f);
+    const vc_f32x4 vRatio = vc_splat4(10.0f);     // 10:1
+
+    for (int g = 0; g < lanes; g += 4) {
+        const vc_f32x4 ceiling = vc_load4(&batch->ceiling[g]);
+        const vc_f32x4 threshold = vc_load4(&batch->threshold[g]);
+        const vc_f32x4 range = ceiling - threshold;
+        vc_f32x4 envelope = vc_load4(&batch->envelope[g]);
+
+        float *p = samples + g;
+        for (int i = 0; i < frames; i++, p += lanes) {
+            vc_f32x4 input = vc_load4(p);
+            vc_f32x4 absInput = vc_abs4(input);
+
+            // エンベロープ追従
+            vc_f32x4 rising = vAttack * absInput + vAttackKeep * envelope;
+            vc_f32x4 falling = vRelease * absInput + vReleaseKeep * envelope;
+            envelope = vc_select4(absInput > envelope, rising, falling);
+
+            // ソフトニー（スカラー版と同じ式）。どのレーンも入っていなければ tanh を評価しない
+            vc_f32x4 gain = vOne;
+            vc_i32x4 over = envelope > threshold;
+            if (vc_any4(over)) {
+                vc_f32x4 knee = threshold + range * vc_tanh4((envelope - threshold) / range * vRatio) / envelope;
+                gain = vc_select4(over, knee, vOne);
+            }
+
+            // クリッピング防止
+            vc_f32x4 clipGain = ceiling / vc_max4(absInput, vFloor);
+            gain = vc_select4(vc_abs4(input * gain) > ceiling, clipGain, gain);
+
+            vc_store4(p, input * gain);
+        }
+
+        vc_store4(&batch->envelope[g], envelope);
+    }
+#else
+    for (int lane = 0; lane < lanes; lane++) {
+        VCLimiter limiter = {
+            batch->ceiling[lane], batch->threshold[lane], attack, release, batch->envelope[lane]
+        };
+        for (int i = 0; i < frames; i++) {
+            vc_limiter_process(&limiter, &samples[i * lanes + lane], 1);
+        }
+        batch->envelope[lane] = limiter.envelope;
+    }
+#endif
+}
+
+void vc_limiter_batch_reset(VCLimiterBatch *batch) {
+    memset(batch->envelope, 0, sizeof(batch->envelope));
+}
+
+#pragma mark - Pack / Unpack
+
+void vc_batch_pack(const float *const *inputs, float *samples, int lanes, int frames) {
+    for (int lane = 0; lane < lanes; lane++) {
+        const float *input = inputs[lane];
+        float *p = samples + lane;
+        if (input == NULL) {
+            for (int i = 0; i < frames; i++, p += lanes) {
+                *p = 0.0f;
+            }
+        } else {
+            for (int i = 0; i < frames; i++, p += lanes) {
+                *p = input[i];
+            }
+        }
+    }
+}
+
+void vc_batch_unpack(const float *samples, float *const *outputs, int lanes, int frames) {
+    for (int lane = 0; lane < lanes; lane++) {
+        float *output = outputs[lane];
+        if (output == NULL) {
+            continue;
+        }
+        const float *p = samples + lane;
+        for (int i = 0; i < frames; i++, p += lanes) {
+            output[i] = *p;
+        }
+    }
+}
+
+#pragma mark - Chain Batch
+
+struct VCChainBatch {
+    int lanes;
+    float sampleRate;
+
+    VCBiquadBatch hpf;
+    VCBiquadBatch eq[3];
+    VCLimiterBatch limiter;
+
+    // NS: しきい値未満を -20dB（無効レーンはしきい値0）。非発話区間は一定ゲインへクロスフェード
+    float gateThreshold[VC_BATCH_MAX_LANES] __attribute__((aligned(16)));
+    float floorGain[VC_BATCH_MAX_LANES] __attribute__((aligned(16)));
+    float activityStart[VC_BATCH_MAX_LANES] __attribute__((aligned(16)));
+    float activityEnd[VC_BATCH_MAX_LANES] __attribute__((aligned(16)));
+    int noiseSuppressionEnabled[VC_BATCH_MAX_LANES];
+
+    // VAD はレーンごと（VCChain と同じ判定で NS とAGC を切り替える）
+    VCVad *vad[VC_BATCH_MAX_LANES];
+    int vadEnabled[VC_BATCH_MAX_LANES];
+    float activity[VC_BATCH_MAX_LANES];     // 前ブロック末尾の activity
+    float vadScratch[VC_MAX_FRAME_SIZE];    // VAD に渡す 1 レーン分
+
+    // AGC はブロック単位なのでレーンごとのスカラー状態
+    VCAgc agc[VC_BATCH_MAX_LANES];
+    int agcEnabled[VC_BATCH_MAX_LANES];
+    float agcTargetDb[VC_BATCH_MAX_LANES];
+};
+
+VCChainBatch *vc_chain_batch_create(int lanes, int sampleRate) {
+    if (!valid_lanes(lanes)) {
+        return NULL;
+    }
+
+    VCChainBatch *batch = vc_aligned_alloc(16, (sizeof(VCChainBatch) + 15) & ~(size_t)15);
+    if (batch == NULL) {
+        return NULL;
+    }
+    memset(batch, 0, sizeof(*batch));
+    batch->lanes = lanes;
+    batch->sampleRate = (float)sampleRate;
+
+    vc_biquad_batch_init(&batch->hpf, lanes);
+    VCBiquadCoeffs hpf;
+    vc_biquad_set_highpass(&hpf, kHpfCutoffHz, kHpfQ, batch->sampleRate);
+    for (int lane = 0; lane < lanes; lane++) {
+        vc_biquad_batch_set_lane(&batch->hpf, lane, &hpf);
+    }
+    for (int band = 0; band < 3; band++) {
+        vc_biquad_batch_init(&batch->eq[band], lanes);
+    }
+    vc_limiter_batch_init(&batch->limiter, lanes);
+
+    VCChainParams params;
+    vc_chain_params_default(&params);
+    for (int lane = 0; lane < lanes; lane++) {
+        batch->vad[lane] = vc_vad_create(sampleRate);
+        if (batch->vad[lane] == NULL) {
+            vc_chain_batch_destroy(batch);
+            return NULL;
+        }
+        batch->activity[lane] = 1.0f;
+        vc_agc_init(&batch->agc[lane]);
+        vc_chain_batch_set_lane_params(batch, lane, &params);
+    }
+    return batch;
+}
+
+void vc_chain_batch_destroy(VCChainBatch *batch) {
+    if (batch == NULL) {
+        return;
+    }
+    for (int lane = 0; lane < batch->lanes; lane++) {
+        vc_vad_destroy(batch->vad[lane]);
+    }
+    vc_free(batch);
+}
+
+int vc_chain_batch_lanes(const VCChainBatch *batch) {
+    return batch->lanes;
+}
+
+void vc_chain_batch_set_lane_params(VCChainBatch *batch, int lane, const VCChainParams *params) {
+    if (lane < 0 || lane >= batch->lanes) {
+        return;
+    }
+
+    // VCChain と同じ係数計算（レーン単位の結果を一致させる）
+    const float sr = batch->sampleRate;
+    VCBiquadCoeffs coeffs;
+    vc_biquad_set_lowshelf(&coeffs, kEqLowFreq, clampf(params->eqLow, -12, 12), sr);
+    vc_biquad_batch_set_lane(&batch->eq[0], lane, &coeffs);
+    vc_biquad_set_peaking(&coeffs, kEqMidFreq, clampf(params->eqMid, -12, 12), 1.0f, sr);
+    vc_biquad_batch_set_lane(&batch->eq[1], lane, &coeffs);
+    vc_biquad_set_highshelf(&coeffs, kEqHighFreq, clampf(params->eqHigh, -12, 12), sr);
+    vc_biquad_batch_set_lane(&batch->eq[2], lane, &coeffs);
+
+    VCNoiseGate gate;
+    vc_noise_gate_set_strength(&gate, params->noiseSuppressionStrength);
+    batch->gateThreshold[lane] = params->noiseSuppressionEnabled ? 0.01f * (1.0f - gate.strength) : 0.0f;
+    batch->floorGain[lane] = vc_noise_gate_floor_gain(&gate);
+    batch->noiseSuppressionEnabled[lane] = params->noiseSuppressionEnabled;
+    batch->vadEnabled[lane] = params->vadEnabled;
+
+    vc_agc_set_target(&batch->agc[lane], params->agcTargetDb);
+    batch->agcEnabled[lane] = params->agcEnabled;
+    batch->agcTargetDb[lane] = params->agcTargetDb;
+}
+
+void vc_chain_batch_reset(VCChainBatch *batch) {
+    vc_biquad_batch_reset(&batch->hpf);
+    for (int band = 0; band < 3; band++) {
+        vc_biquad_batch_reset(&batch->eq[band]);
+    }
+    vc_limiter_batch_reset(&batch->limiter);
+    for (int lane = 0; lane < batch->lanes; lane++) {
+        vc_agc_init(&batch->agc[lane]);
+        vc_agc_set_target(&batch->agc[lane], batch->agcTargetDb[lane]);
+        vc_vad_reset(batch->vad[lane]);
+        batch->activity[lane] = 1.0f;
+    }
+}
+
+/// レーンごとの発話検出（VCChain と同じく HPF 後の信号で判定し、AGC の更新と NS の強さを切り替える）
+static void batch_detect_voice(VCChainBatch *batch, const float *samples, int frames) {
+    const int lanes = batch->lanes;
+    for (int lane = 0; lane < lanes; lane++) {
+        float activityEnd = 1.0f;
+        int speech = 1;
+        if (batch->vadEnabled[lane]) {
+            const float *p = samples + lane;
+            for (int i = 0; i < frames; i++, p += lanes) {
+                batch->vadScratch[i] = *p;
+            }
+            speech = vc_vad_process(batch->vad[lane], batch->vadScratch, frames);
+            activityEnd = vc_vad_activity(batch->vad[lane]);
+        }
+        vc_agc_set_voice_activity(&batch->agc[lane], speech);
+
+        // NS を掛けないレーンは常に発話扱い（ゲートも一定ゲインも掛けない）
+        int gated = batch->noiseSuppressionEnabled[lane];
+        batch->activityStart[lane] = gated ? batch->activity[lane] : 1.0f;
+        batch->activityEnd[lane] = gated ? activityEnd : 1.0f;
+        batch->activity[lane] = activityEnd;
+    }
+}
+
+/// vc_noise_gate_process_with_activity のレーン版（activity が 1 のレーンは mix = 1 でゲートのみになる）
+static void batch_noise_gate(VCChainBatch *batch, float *samples, int frames) {
+    const int lanes = batch->lanes;
+#if VC_HAS_VECTOR_EXT
+    const vc_f32x4 attenuation = vc_splat4(0.1f);
+    const vc_f32x4 one = vc_splat4(1.0f);
+    const vc_f32x4 frameCount = vc_splat4((float)frames);
+    for (int g = 0; g < lanes; g += 4) {
+        const vc_f32x4 threshold = vc_load4(&batch->gateThreshold[g]);
+        const vc_f32x4 start = vc_load4(&batch->activityStart[g]);
+        const vc_f32x4 end = vc_load4(&batch->activityEnd[g]);
+        float *p = samples + g;
+
+        // 4 レーンとも発話中ならゲートだけ
+        if (!vc_any4((start < one) | (end < one))) {
+            for (int i = 0; i < frames; i++, p += lanes) {
+                vc_f32x4 x = vc_load4(p);
+                vc_store4(p, vc_select4(vc_abs4(x) < threshold, x * attenuation, x));
+            }
+            continue;
+        }
+
+        const vc_f32x4 floorGain = vc_load4(&batch->floorGain[g]);
+        const vc_f32x4 step = (end - start) / frameCount;
+        for (int i = 0; i < frames; i++, p += lanes) {
+            vc_f32x4 x = vc_load4(p);
+            vc_f32x4 gated = vc_select4(vc_abs4(x) < threshold, x * attenuation, x);
+            vc_f32x4 mix = start + step * vc_splat4((float)(i + 1));
+            vc_store4(p, mix * gated + (one - mix) * floorGain * x);
+        }
+    }
+#else
+    for (int lane = 0; lane < lanes; lane++) {
+        const float threshold = batch->gateThreshold[lane];
+        const float start = batch->activityStart[lane];
+        const float step = (batch->activityEnd[lane] - start) / (float)frames;
+        const float floorGain = batch->floorGain[lane];
+        for (int i = 0; i < frames; i++) {
+            float *p = &samples[i * lanes + lane];
+            float gated = fabsf(*p) < threshold ? *p * 0.1f : *p;
+            float mix = start + step * (float)(i + 1);
+            *p = mix * gated + (1.0f - mix) * floorGain * *p;
+        }
+    }
+#endif
+}
+
+static void batch_agc(VCChainBatch *batch, float *samples, int frames) {
+    const int lanes = batch->lanes;
+    float sums[VC_BATCH_MAX_LANES] __attribute__((aligned(16))) = {0};
+    float gains[VC_BATCH_MAX_LANES] __attribute__((aligned(16)));
+
+    // レーンごとの二乗和（スカラー版と同じ加算順）
+#if VC_HAS_VECTOR_EXT
+    for (int g = 0; g < lanes; g += 4) {
+        vc_f32x4 sum = vc_splat4(0.0f);
+        const float *p = samples + g;
+        for (int i = 0; i < frames; i++, p += lanes) {
+            vc_f32x4 x = vc_load4(p);
+            sum += x * x;
+        }
+        vc_store4(&sums[g], sum);
+    }
+#else
+    for (int i = 0; i < frames; i++) {
+        for (int lane = 0; lane < lanes; lane++) {
+            float x = samples[i * lanes + lane];
+            sums[lane] += x * x;
+        }
+    }
+#endif
+
+    for (int lane = 0; lane < lanes; lane++) {
+        gains[lane] = 1.0f;
+        if (batch->agcEnabled[lane]) {
+            float rms = sqrtf(sums[lane] / (float)frames);
+            gains[lane] = vc_agc_update_gain(&batch->agc[lane], rms);
+        }
+    }
+
+    for (int i = 0; i < frames; i++) {
+        float *p = samples + i * lanes;
+        for (int lane = 0; lane < lanes; lane++) {
+            p[lane] *= gains[lane];
+        }
+    }
+}
+
+void vc_chain_batch_process(VCChainBatch *batch, const float *input, float *output, int frames) {
+    if (frames <= 0) {
+        return;
+    }
+    const int lanes = batch->lanes;
+    if (input != output) {
+        memcpy(output, input, (size_t)frames * (size_t)lanes * sizeof(float));
+    }
+
+    // VAD・AGC の判定単位（VCChain の 1 回の process と同じ）を VC_MAX_FRAME_SIZE 以下に揃える
+    for (int offset = 0; offset < frames; offset += VC_MAX_FRAME_SIZE) {
+        int count = frames - offset < VC_MAX_FRAME_SIZE ? frames - offset : VC_MAX_FRAME_SIZE;
+        float *block = output + (size_t)offset * (size_t)lanes;
+        vc_biquad_batch_process(&batch->hpf, block, count);
+        batch_detect_voice(batch, block, count);
+        batch_noise_gate(batch, block, count);
+        batch_agc(batch, block, count);
+        // VCChain が非発話で省略するマルチバンドも、止めない声質変換・畳み込みもこのトポロジにはない
+        // （加えるときは VCChain と同じく activityStart / activityEnd で省略・クロスフェードする）
+        for (int band = 0; band < 3; band++) {
+            vc_biquad_batch_process(&batch->eq[band], block, count);
+        }
+        vc_limiter_batch_process(&batch->limiter, block, count);
+    }
+}
@@ -0,0 +1,144 @@
+//
+//  VCBiquad.c
+//  VoiceChanger
+//
+//  Portable biquad filter kernel (RBJ cookbook, Direct Form I)
+//
+
+#include "include/VCBiquad.h"
+#include "include/VCFastMath.h"
+#include <math.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+void vc_biquad_set_identity(VCBiquadCoeffs *coeffs) {
+    coeffs->b0 = 1;
+    coeffs->b1 = 0;
+    coeffs->b2 = 0;
+    coeffs->a1 = 0;
+    coeffs->a2 = 0;
+}
+
+void vc_biquad_set_highpass(VCBiquadCoeffs *coeffs, float frequency, float q, float sampleRate) {
+    float omega = 2.0f * (float)M_PI * frequency / sampleRate;
+    float sinOmega, cosOmega;
+    vc_fast_sincosf(omega, &sinOmega, &cosOmega);
+    float alpha = sinOmega / (2.0f * q);
+
+    float a0 = 1.0f + alpha;
+    coeffs->b0 = ((1.0f + cosOmega) / 2.0f) / a0;
+    coeffs->b1 = (-(1.0f + cosOmega)) / a0;
+    coeffs->b2 = ((1.0f + cosOmega) / 2.0f) / a0;
+    coeffs->a1 = (-2.0f * cosOmega) / a0;
+    coeffs->a2 = (1.0f - alpha) / a0;
+}
+
+void vc_biquad_set_lowpass(VCBiquadCoeffs *coeffs, float frequency, float q, float sampleRate) {
+    float omega = 2.0f * (float)M_PI * frequency / sampleRate;
+    float sinOmega, cosOmega;
+    vc_fast_sincosf(omega, &sinOmega, &cosOmega);
+    float alpha = sinOmega / (2.0f * q);
+
+    float a0 = 1.0f + alpha;
+    coeffs->b0 = ((1.0f - cosOmega) / 2.0f) / a0;
+    coeffs->b1 = (1.0f - cosOmega) / a0;
+    coeffs->b2 = ((1.0f - cosOmega) / 2.0f) / a0;
+    coeffs->a1 = (-2.0f * cosOmega) / a0;
+    coeffs->a2 = (1.0f - alpha) / a0;
+}
+
+void vc_biquad_set_allpass(VCBiquadCoeffs *coeffs, float frequency, float q, float sampleRate) {
+    float omega = 2.0f * (float)M_PI * frequency / sampleRate;
+    float sinOmega, cosOmega;
+    vc_fast_sincosf(omega, &sinOmega, &cosOmega);
+    float alpha = sinOmega / (2.0f * q);
+
+    float a0 = 1.0f + alpha;
+    coeffs->b0 = (1.0f - alpha) / a0;
+    coeffs->b1 = (-2.0f * cosOmega) / a0;
+    coeffs->b2 = 1.0f;
+    coeffs->a1 = (-2.0f * cosOmega) / a0;
+    coeffs->a2 = (1.0f - alpha) / a0;
+}
+
+void vc_biquad_set_lowshelf(VCBiquadCoeffs *coeffs, float frequency, float gainDb, float sampleRate) {
+    float A = vc_fast_db_to_linear(gainDb * 0.5f);     // 10^(gainDb / 40)
+    float omega = 2.0f * (float)M_PI * frequency / sampleRate;
+    float sinOmega, cosOmega;
+    vc_fast_sincosf(omega, &sinOmega, &cosOmega);
+    float alpha = sinOmega / 2.0f * sqrtf(2.0f);
+    float sqrtA = sqrtf(A);
+
+    float a0 = (A + 1) + (A - 1) * cosOmega + 2 * sqrtA * alpha;
+    coeffs->b0 = (A * ((A + 1) - (A - 1) * cosOmega + 2 * sqrtA * alpha)) / a0;
+    coeffs->b1 = (2 * A * ((A - 1) - (A + 1) * cosOmega)) / a0;
+    coeffs->b2 = (A * ((A + 1) - (A - 1) * cosOmega - 2 * sqrtA * alpha)) / a0;
+    coeffs->a1 = (-2 * ((A - 1) + (A + 1) * cosOmega)) / a0;
+    coeffs->a2 = ((A + 1) + (A - 1) * cosOmega - 2 * sqrtA * alpha) / a0;
+}
+
+void vc_biquad_set_highshelf(VCBiquadCoeffs *coeffs, float frequency, float gainDb, float sampleRate) {
+    float A = vc_fast_db_to_linear(gainDb * 0.5f);     // 10^(gainDb / 40)
+    float omega = 2.0f * (float)M_PI * frequency / sampleRate;
+    float sinOmega, cosOmega;
+    vc_fast_sincosf(omega, &sinOmega, &cosOmega);
+    float alpha = sinOmega / 2.0f * sqrtf(2.0f);
+    float sqrtA = sqrtf(A);
+
+    float a0 = (A + 1) - (A - 1) * cosOmega + 2 * sqrtA * alpha;
+    coeffs->b0 = (A * ((A + 1) + (A - 1) * cosOmega + 2 * sqrtA * alpha)) / a0;
+    coeffs->b1 = (-2 * A * ((A - 1) + (A + 1) * cosOmega)) / a0;
+    coeffs->b2 = (A * ((A + 1) + (A - 1) * cosOmega - 2 * sqrtA * alpha)) / a0;
+    coeffs->a1 = (2 * ((A - 1) - (A + 1) * cosOmega)) / a0;
+    coeffs->a2 = ((A + 1) - (A - 1) * cosOmega - 2 * sqrtA * alpha) / a0;
+}
+
+void vc_biquad_set_peaking(VCBiquadCoeffs *coeffs, float frequency, float gainDb, float q, float sampleRate) {
+    float A = vc_fast_db_to_linear(gainDb * 0.5f);     // 10^(gainDb / 40)
+    float omega = 2.0f * (float)M_PI * frequency / sampleRate;
+    float sinOmega, cosOmega;
+    vc_fast_sincosf(omega, &sinOmega, &cosOmega);
+    float alpha = sinOmega / (2.0f * q);
+
+    float a0 = 1 + alpha / A;
+    coeffs->b0 = (1 + alpha * A) / a0;
+    coeffs->b1 = (-2 * cosOmega) / a0;
+    coeffs->b2 = (1 - alpha * A) / a0;
+    coeffs->a1 = (-2 * cosOmega) / a0;
+    coeffs->a2 = (1 - alpha / A) / a0;
+}
+
+void vc_biquad_process(const VCBiquadCoeffs *coeffs, VCBiquadState *state,
+                       const float *input, float *output, int count) {
+    // 係数と状態はレジスタに載せてループ内のメモリアクセスを避ける
+    const float b0 = coeffs->b0, b1 = coeffs->b1, b2 = coeffs->b2;
+    const float a1 = coeffs->a1, a2 = coeffs->a2;
+    float x1 = state->x1, x2 = state->x2;
+    float y1 = state->y1, y2 = state->y2;
+
+    for (int i = 0; i < count; i++) {
+        float x0 = input[i];
+        float y0 = b0 * x0 + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+
+        x2 = x1;
+        x1 = x0;
+        y2 = y1;
+        y1 = y0;
+
+        output[i] = y0;
+    }
+
+    state->x1 = x1;
+    state->x2 = x2;
+    state->y1 = y1;
+    state->y2 = y2;
+}
+
+void vc_biquad_reset(VCBiquadState *state) {
+    state->x1 = 0;
+    state->x2 = 0;
+    state->y1 = 0;
+    state->y2 = 0;
+}
@@ -0,0 +1,582 @@
+//
+//  VCChain.c
+//  VoiceChanger
+//
+//  Portable DSP chain (HPF → AEC → VAD/Pitch → NS → AGC → Voice conversion → Multiband → EQ → Convolution → Limiter)
+//
+
+#include "include/VCChain.h"
+#include "include/VCAnalysis.h"
+#include "include/VCBiquad.h"
+#include "include/VCConvolver.h"
+#include "include/VCDynamics.h"
+#include "include/VCEchoCanceller.h"
+#include "include/VCMonitor.h"
+#include "include/VCMultiband.h"
+#include "include/VCOversampler.h"
+#include "include/VCPitch.h"
+#include "include/VCSignalGuard.h"
+#include "include/VCVad.h"
+#include "include/VCVoiceConverter.h"
+#include "VCAlloc.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define kHpfCutoffHz    80.0f
+#define kHpfQ           0.707f  // Butterworth Q
+#define kEqLowFreq      200.0f  // Low shelf
+#define kEqMidFreq      1000.0f // Peaking
+#define kEqHighFreq     4000.0f // High shelf
+#define kAecTailMs      100.0f  // 室内の残響 + 出力・入力デバイスの遅延差
+
+struct VCChain {
+    float sampleRate;
+    VCChainParams params;
+
+    VCBiquadCoeffs hpfCoeffs;
+    VCBiquadState hpfState;
+
+    VCVad *vad;
+    float activity;     // 前ブロック末尾の VAD activity（ブロック内で補間する）
+    float gateScratch[VC_MAX_FRAME_SIZE];
+
+    VCPitchTracker *pitch;
+    VCBlockAnalysis analysis;   // 後段が参照する直近ブロックの解析結果
+    VCAnalysisContext *spectra; // 各段が共有する STFT（要求された分だけ計算）
+
+    VCNoiseGate noiseGate;
+    VCAgc agc;
+
+    VCMultiband *multiband;
+    int multibandResting;       // activity 0 で省略中（省略に入るときに状態をクリア済み）
+
+    VCBiquadCoeffs eqCoeffs[3];
+    VCBiquadState eqState[3];
+
+    VCVoiceConverter *voiceConverter;   // 外部所有（読み込んだ声質変換モデル）
+
+    VCConvolver *convolver;     // 外部所有（プリセットの IR）
+    float wetScratch[VC_MAX_FRAME_SIZE];
+
+    VCLimiter limiter;
+    VCOversampler *oversamplers[3];     // 1 / 2 / 4 倍（切り替えで確保しないよう作成時にすべて用意）
+    VCOversampler *limiterOversampler;  // 現在の倍率
+
+    // エコーキャンセラ（参照を初めて設定したときに確保）
+    VCEchoCanceller *aec;
+    VCMonitor *echoReferences[VC_CHAIN_MAX_ECHO_REFERENCES];
+    int echoReferenceCount;
+    float farEnd[VC_CHAIN_AEC_BLOCK_SIZE];
+    float farScratch[VC_CHAIN_AEC_BLOCK_SIZE];
+
+    // 信号ガード（壊れた入力の置き換え、モジュール単位のリセットとフェード）
+    int guardEnabled;
+    VCSignalGuard guard;
+    unsigned pendingResets;     // ロックが取れずリセットを待っているモジュール（1 << VCChainModule、その間は素通し）
+};
+
+static float clampf(float value, float lo, float hi) {
+    return fmaxf(lo, fminf(hi, value));
+}
+
+void vc_chain_params_default(VCChainParams *params) {
+    params->pitchShift = 0;
+    params->formantShift = 0;
+    params->eqLow = 0;
+    params->eqMid = 0;
+    params->eqHigh = 0;
+    params->noiseSuppressionEnabled = 1;
+    params->noiseSuppressionStrength = 0.5f;
+    params->agcEnabled = 1;
+    params->agcTargetDb = -18;
+    params->vadEnabled = 1;
+    params->multibandEnabled = 0;
+    params->compressorThresholdDb = -24;
+    params->compressorRatio = 2.5f;
+    params->deEsserThresholdDb = -30;
+    params->deEsserRatio = 4;
+    params->convolutionMix = 0;
+    params->limiterOversampling = 1;
+}
+
+VCChain *vc_chain_create(int sampleRate) {
+    VCChain *chain = vc_calloc(1, sizeof(VCChain));
+    if (chain == NULL) {
+        return NULL;
+    }
+
+    chain->sampleRate = (float)sampleRate;
+    chain->vad = vc_vad_create(sampleRate);
+    chain->pitch = vc_pitch_create(sampleRate, VC_PITCH_DEFAULT_MIN_HZ, VC_PITCH_DEFAULT_MAX_HZ);
+    chain->spectra = vc_analysis_create(VC_MAX_FRAME_SIZE, NULL);
+    chain->multiband = vc_multiband_create(sampleRate);
+    if (chain->vad == NULL || chain->pitch == NULL || chain->spectra == NULL || chain->multiband == NULL) {
+        vc_chain_destroy(chain);
+        return NULL;
+    }
+    for (int i = 0; i < 3; i++) {
+        chain->oversamplers[i] = vc_oversampler_create(1 << i, VC_MAX_FRAME_SIZE);
+        if (chain->oversamplers[i] == NULL) {
+            vc_chain_destroy(chain);
+            return NULL;
+        }
+    }
+    chain->activity = 1.0f;
+    chain->guardEnabled = 1;
+    vc_signal_guard_init(&chain->guard, sampleRate);
+    vc_biquad_set_highpass(&chain->hpfCoeffs, kHpfCutoffHz, kHpfQ, chain->sampleRate);
+    vc_noise_gate_init(&chain->noiseGate);
+    vc_agc_init(&chain->agc);
+    vc_limiter_init(&chain->limiter);
+
+    VCChainParams params;
+    vc_chain_params_default(&params);
+    vc_chain_set_params(chain, &params);
+
+    return chain;
+}
+
+void vc_chain_destroy(VCChain *chain) {
+    if (chain == NULL) {
+        return;
+    }
+    vc_aec_destroy(chain->aec);
+    vc_vad_destroy(chain->vad);
+    vc_pitch_destroy(chain->pitch);
+    vc_analysis_destroy(chain->spectra);
+    vc_multiband_destroy(chain->multiband);
+    for (int i = 0; i < 3; i++) {
+        vc_oversampler_destroy(chain->oversamplers[i]);
+    }
+    vc_free(chain);
+}
+
+int vc_chain_prepare(VCChain *chain, VCPlanCache *cache) {
+    VCAnalysisContext *spectra = vc_analysis_create(VC_MAX_FRAME_SIZE, cache);
+    if (spectra == NULL) {
+        return -1;
+    }
+    vc_analysis_destroy(chain->spectra);
+    chain->spectra = spectra;
+    return 0;
+}
+
+void vc_chain_set_params(VCChain *chain, const VCChainParams *params) {
+    chain->params = *params;
+
+    // EQ（3バンド）はプリセット適用時のみ係数を再計算する
+    float sr = chain->sampleRate;
+    vc_biquad_set_lowshelf(&chain->eqCoeffs[0], kEqLowFreq, clampf(params->eqLow, -12, 12), sr);
+    vc_biquad_set_peaking(&chain->eqCoeffs[1], kEqMidFreq, clampf(params->eqMid, -12, 12), 1.0f, sr);
+    vc_biquad_set_highshelf(&chain->eqCoeffs[2], kEqHighFreq, clampf(params->eqHigh, -12, 12), sr);
+
+    vc_noise_gate_set_strength(&chain->noiseGate, params->noiseSuppressionStrength);
+    vc_agc_set_target(&chain->agc, params->agcTargetDb);
+
+    // マルチバンド: 下3帯域は同じしきい値・比のコンプレッサー、最上位帯域はディエッサー
+    VCMultibandParams bands;
+    vc_multiband_get_params(chain->multiband, &bands);
+    for (int band = 0; band < VC_MULTIBAND_BANDS; band++) {
+        int sibilance = band == VC_MULTIBAND_SIBILANCE_BAND;
+        bands.thresholdDb[band] = clampf(sibilance ? params->deEsserThresholdDb : params->compressorThresholdDb, -60, 0);
+        bands.ratio[band] = clampf(sibilance ? params->deEsserRatio : params->compressorRatio, 1, 20);
+    }
+    vc_multiband_set_params(chain->multiband, &bands);
+
+    // リミッターの倍率（変わったときだけ履歴を消して切り替える）
+    int stage = params->limiterOversampling >= 4 ? 2 : params->limiterOversampling >= 2 ? 1 : 0;
+    if (chain->limiterOversampler != chain->oversamplers[stage]) {
+        chain->limiterOversampler = chain->oversamplers[stage];
+        vc_oversampler_reset(chain->limiterOversampler);
+        vc_limiter_set_oversampling(&chain->limiter, 1 << stage);
+    }
+}
+
+void vc_chain_get_params(const VCChain *chain, VCChainParams *outParams) {
+    *outParams = chain->params;
+}
+
+void vc_chain_reset(VCChain *chain) {
+    vc_biquad_reset(&chain->hpfState);
+    for (int i = 0; i < 3; i++) {
+        vc_biquad_reset(&chain->eqState[i]);
+    }
+    vc_agc_init(&chain->agc);
+    vc_agc_set_target(&chain->agc, chain->params.agcTargetDb);
+    vc_limiter_reset(&chain->limiter);
+    vc_multiband_reset(chain->multiband);
+    chain->multibandResting = 0;
+    vc_oversampler_reset(chain->limiterOversampler);
+    vc_vad_reset(chain->vad);
+    vc_pitch_reset(chain->pitch);
+    vc_analysis_reset(chain->spectra);
+    memset(&chain->analysis, 0, sizeof(chain->analysis));
+    chain->activity = 1.0f;
+    if (chain->aec != NULL) {
+        vc_aec_reset(chain->aec);
+    }
+    if (chain->convolver != NULL) {
+        vc_convolver_reset(chain->convolver);
+    }
+    if (chain->voiceConverter != NULL) {
+        vc_voice_converter_reset(chain->voiceConverter);
+    }
+    vc_signal_guard_reset(&chain->guard);
+    chain->pendingResets = 0;
+}
+
+void vc_chain_set_convolver(VCChain *chain, VCConvolver *convolver) {
+    chain->convolver = convolver;
+    chain->pendingResets &= ~(1u << VC_CHAIN_MODULE_CONVOLVER);
+}
+
+void vc_chain_set_voice_converter(VCChain *chain, VCVoiceConverter *converter) {
+    chain->voiceConverter = converter;
+    chain->pendingResets &= ~(1u << VC_CHAIN_MODULE_VOICE);
+}
+
+void vc_chain_set_signal_guard(VCChain *chain, int enabled) {
+    chain->guardEnabled = enabled != 0;
+    vc_signal_guard_reset(&chain->guard);
+    chain->pendingResets = 0;
+}
+
+void vc_chain_get_signal_guard_stats(const VCChain *chain, VCSignalGuardStats *outStats) {
+    *outStats = chain->guard.stats;
+}
+
+int vc_chain_set_echo_reference(VCChain *chain, int slot, VCMonitor *reference) {
+    if (slot < 0 || slot >= VC_CHAIN_MAX_ECHO_REFERENCES) {
+        return -1;
+    }
+
+    if (reference != NULL) {
+        if (chain->aec == NULL) {
+            int tailFrames = (int)(kAecTailMs * chain->sampleRate / 1000.0f);
+            chain->aec = vc_aec_create(VC_CHAIN_AEC_BLOCK_SIZE, tailFrames);
+            if (chain->aec == NULL) {
+                return -1;
+            }
+        }
+        // 出力側の現在位置から目標遅延ぶん遅れて読み始める
+        vc_monitor_restart(reference, vc_monitor_target_latency(reference));
+    }
+
+    chain->echoReferences[slot] = reference;
+    chain->echoReferenceCount = 0;
+    for (int i = 0; i < VC_CHAIN_MAX_ECHO_REFERENCES; i++) {
+        if (chain->echoReferences[i] != NULL) {
+            chain->echoReferenceCount++;
+        }
+    }
+    return 0;
+}
+
+float vc_chain_latency(const VCChain *chain) {
+    float latency = vc_oversampler_latency(chain->limiterOversampler);
+    if (chain->voiceConverter != NULL) {
+        latency += (float)vc_voice_converter_latency(chain->voiceConverter);
+    }
+    return latency;
+}
+
+void vc_chain_get_multiband_reduction(const VCChain *chain, float outDb[VC_MULTIBAND_BANDS]) {
+    vc_multiband_get_gain_reduction(chain->multiband, outDb);
+}
+
+int vc_chain_get_echo_stats(const VCChain *chain, VCEchoCancellerStats *outStats) {
+    if (chain->aec == NULL) {
+        memset(outStats, 0, sizeof(*outStats));
+        return 0;
+    }
+    vc_aec_get_stats(chain->aec, outStats);
+    return 1;
+}
+
+void vc_chain_get_vad_state(const VCChain *chain, VCVadState *outState) {
+    vc_vad_get_state(chain->vad, outState);
+}
+
+VCAnalysisContext *vc_chain_analysis_context(VCChain *chain) {
+    return chain->spectra;
+}
+
+void vc_chain_get_analysis(const VCChain *chain, VCBlockAnalysis *outAnalysis) {
+    *outAnalysis = chain->analysis;
+}
+
+#pragma mark - Signal Guard
+
+/// 背景スレッドのあるモジュールはロックを待たずに試し、取れなければ次のブロックでやり直す
+static void reset_module(VCChain *chain, VCChainModule module) {
+    switch (module) {
+    case VC_CHAIN_MODULE_HPF:
+        vc_biquad_reset(&chain->hpfState);
+        break;
+    case VC_CHAIN_MODULE_AEC:
+        vc_aec_reset(chain->aec);
+        break;
+    case VC_CHAIN_MODULE_VOICE:
+        if (vc_voice_converter_try_reset(chain->voiceConverter) != 0) {
+            chain->pendingResets |= 1u << module;
+        }
+        break;
+    case VC_CHAIN_MODULE_MULTIBAND:
+        vc_multiband_reset(chain->multiband);
+        break;
+    case VC_CHAIN_MODULE_EQ:
+        for (int i = 0; i < 3; i++) {
+            vc_biquad_reset(&chain->eqState[i]);
+        }
+        break;
+    case VC_CHAIN_MODULE_CONVOLVER:
+        if (vc_convolver_try_reset(chain->convolver) != 0) {
+            chain->pendingResets |= 1u << module;
+        }
+        break;
+    case VC_CHAIN_MODULE_LIMITER:
+        vc_limiter_reset(&chain->limiter);
+        vc_oversampler_reset(chain->limiterOversampler);
+        break;
+    default:
+        break;
+    }
+}
+
+static void retry_pending_resets(VCChain *chain) {
+    if ((chain->pendingResets & (1u << VC_CHAIN_MODULE_VOICE)) &&
+        vc_voice_converter_try_reset(chain->voiceConverter) == 0) {
+        chain->pendingResets &= ~(1u << VC_CHAIN_MODULE_VOICE);
+    }
+    if ((chain->pendingResets & (1u << VC_CHAIN_MODULE_CONVOLVER)) &&
+        vc_convolver_try_reset(chain->convolver) == 0) {
+        chain->pendingResets &= ~(1u << VC_CHAIN_MODULE_CONVOLVER);
+    }
+}
+
+/// モジュールの出力を検査し、壊れていればそのモジュールの状態だけをリセットする（ブロックは 0 になる）
+static void guard_module(VCChain *chain, VCChainModule module, float *samples, int count) {
+    if (chain->guardEnabled && vc_signal_guard_check(&chain->guard, (int)module, samples, count)) {
+        reset_module(chain, module);
+    }
+}
+
+static int is_pending_reset(const VCChain *chain, VCChainModule module) {
+    return (chain->pendingResets & (1u << module)) != 0;
+}
+
+/// FTZ が使えない環境では、無音で減衰していく再帰フィルタの状態が非正規化数に留まらないよう落とす
+static void flush_state_denormals(VCChain *chain) {
+    VCBiquadState *states[4] = { &chain->hpfState, &chain->eqState[0], &chain->eqState[1], &chain->eqState[2] };
+    for (int i = 0; i < 4; i++) {
+        states[i]->x1 = vc_flush_denormal(states[i]->x1);
+        states[i]->x2 = vc_flush_denormal(states[i]->x2);
+        states[i]->y1 = vc_flush_denormal(states[i]->y1);
+        states[i]->y2 = vc_flush_denormal(states[i]->y2);
+    }
+    chain->limiter.envelope = vc_flush_denormal(chain->limiter.envelope);
+}
+
+#pragma mark - Processing
+
+/// ノイズ抑制。activity が 0 の区間はゲートの代わりに一定ゲインだけを掛け、
+/// 途中はブロック内で線形にクロスフェードする
+static void suppress_noise(VCChain *chain, float *samples, int count, float activityStart, float activityEnd) {
+    float step = (activityEnd - activityStart) / (float)count;
+    for (int offset = 0; offset < count; offset += VC_MAX_FRAME_SIZE) {
+        int frames = count - offset < VC_MAX_FRAME_SIZE ? count - offset : VC_MAX_FRAME_SIZE;
+        float start = offset == 0 ? activityStart : activityStart + step * (float)offset;
+        float end = offset + frames == count ? activityEnd : activityStart + step * (float)(offset + frames);
+        vc_noise_gate_process_with_activity(&chain->noiseGate, samples + offset, chain->gateScratch, frames,
+                                            start, end);
+    }
+}
+
+/// マルチバンドダイナミクス（インプレース。activity が 0 の間は省略し、途中はドライとクロスフェード）
+/// 遅延がなく 1 ブロック前の状態にしか依存しないので省略できる。省略に入るときに状態をクリアし、
+/// 再開時に発話末尾のフィルタ状態・エンベロープを持ち込まない（再開直後は activity ≈ 0 でドライが支配的）
+static void compress_bands(VCChain *chain, float *samples, int count, float activityStart, float activityEnd) {
+    if (activityStart <= 0.0f && activityEnd <= 0.0f) {
+        if (!chain->multibandResting) {
+            vc_multiband_reset(chain->multiband);
+            chain->multibandResting = 1;
+        }
+        return;
+    }
+    chain->multibandResting = 0;
+    if (activityStart >= 1.0f && activityEnd >= 1.0f) {
+        vc_multiband_process(chain->multiband, samples, count);
+        return;
+    }
+
+    float step = (activityEnd - activityStart) / (float)count;
+    for (int offset = 0; offset < count; offset += VC_MAX_FRAME_SIZE) {
+        int frames = count - offset < VC_MAX_FRAME_SIZE ? count - offset : VC_MAX_FRAME_SIZE;
+        float *chunk = samples + offset;
+        memcpy(chain->wetScratch, chunk, (size_t)frames * sizeof(float));
+        vc_multiband_process(chain->multiband, chain->wetScratch, frames);
+        for (int i = 0; i < frames; i++) {
+            float mix = activityStart + step * (float)(offset + i + 1);
+            chunk[i] = mix * chain->wetScratch[i] + (1.0f - mix) * chunk[i];
+        }
+    }
+}
+
+/// 参照の和を遠端としてブロックごとにエコーを差し引く（インプレース）
+static void cancel_echo(VCChain *chain, float *samples, int count) {
+    for (int offset = 0; offset < count; offset += VC_CHAIN_AEC_BLOCK_SIZE) {
+        int first = 1;
+        for (int i = 0; i < VC_CHAIN_MAX_ECHO_REFERENCES; i++) {
+            VCMonitor *reference = chain->echoReferences[i];
+            if (reference == NULL) {
+                continue;
+            }
+            if (first) {
+                vc_monitor_pull(reference, chain->farEnd, VC_CHAIN_AEC_BLOCK_SIZE);
+                first = 0;
+            } else {
+                vc_monitor_pull(reference, chain->farScratch, VC_CHAIN_AEC_BLOCK_SIZE);
+                for (int n = 0; n < VC_CHAIN_AEC_BLOCK_SIZE; n++) {
+                    chain->farEnd[n] += chain->farScratch[n];
+                }
+            }
+        }
+        vc_aec_process(chain->aec, chain->farEnd, samples + offset, samples + offset);
+    }
+}
+
+/// 畳み込み結果をドライと混ぜる（インプレース）
+static void convolve(VCChain *chain, float *samples, int count) {
+    float mix = clampf(chain->params.convolutionMix, 0, 1);
+    for (int offset = 0; offset < count; offset += VC_MAX_FRAME_SIZE) {
+        int frames = count - offset < VC_MAX_FRAME_SIZE ? count - offset : VC_MAX_FRAME_SIZE;
+        float *chunk = samples + offset;
+        vc_convolver_process(chain->convolver, chunk, chain->wetScratch, frames);
+        for (int i = 0; i < frames; i++) {
+            chunk[i] = (1.0f - mix) * chunk[i] + mix * chain->wetScratch[i];
+        }
+    }
+}
+
+/// リミッター（tanh のソフトニーとクリップは非線形なので、指定倍率で処理して折り返しを抑える）
+static void limit(VCChain *chain, float *samples, int count) {
+    VCOversampler *oversampler = chain->limiterOversampler;
+    if (vc_oversampler_factor(oversampler) == 1) {
+        vc_limiter_process(&chain->limiter, samples, count);
+        return;
+    }
+    int factor = vc_oversampler_factor(oversampler);
+    for (int offset = 0; offset < count; offset += VC_MAX_FRAME_SIZE) {
+        int frames = count - offset < VC_MAX_FRAME_SIZE ? count - offset : VC_MAX_FRAME_SIZE;
+        float *upsampled = vc_oversampler_upsample(oversampler, samples + offset, frames);
+        vc_limiter_process(&chain->limiter, upsampled, frames * factor);
+        vc_oversampler_downsample(oversampler, samples + offset, frames);
+    }
+}
+
+static void process_block(VCChain *chain, const float *input, float *output, int count) {
+    // 1. ハイパスフィルタ（DC除去、低周波ノイズ除去）: input → output
+    vc_biquad_process(&chain->hpfCoeffs, &chain->hpfState, input, output, count);
+    guard_module(chain, VC_CHAIN_MODULE_HPF, output, count);
+
+    // 2. エコーキャンセル（線形な経路を推定するので非線形処理より前に）
+    if (chain->echoReferenceCount > 0 && count % VC_CHAIN_AEC_BLOCK_SIZE == 0) {
+        cancel_echo(chain, output, count);
+        guard_module(chain, VC_CHAIN_MODULE_AEC, output, count);
+    }
+
+    // 3. 発話検出（非発話が続く間は重い処理を省略し、AGC のゲインを据え置く）
+    //    スペクトルはここで取り込んだブロックを各段が共有し、最初に要求した段だけが FFT する
+    vc_analysis_begin_block(chain->spectra, output, count);
+    float activityStart = chain->activity;
+    float activityEnd = 1.0f;
+    int speech = 1;
+    if (chain->params.vadEnabled) {
+        speech = vc_vad_process_with_analysis(chain->vad, output, count, chain->spectra);
+        activityEnd = vc_vad_activity(chain->vad);
+    }
+    vc_agc_set_voice_activity(&chain->agc, speech);
+    chain->activity = activityEnd;
+
+    //    ピッチ推定（履歴は常に更新し、探索は発話中のみ）
+    VCBlockAnalysis *analysis = &chain->analysis;
+    analysis->speech = speech;
+    analysis->activity = activityEnd;
+    vc_pitch_process(chain->pitch, output, count, speech, &analysis->pitch);
+
+    // 4. ノイズ抑制
+    if (chain->params.noiseSuppressionEnabled) {
+        suppress_noise(chain, output, count, activityStart, activityEnd);
+    }
+
+    // 5. 自動ゲイン調整
+    if (chain->params.agcEnabled) {
+        vc_agc_process(&chain->agc, output, count);
+    }
+
+    // 6-7. ピッチ/フォルマントシフトは Swift 側と同じくプレースホルダー
+    //      実装時は activity が 0 のブロックを省略し、途中はドライ信号とクロスフェードする
+    //      目標ピッチの補正には analysis->pitch、スペクトル包絡には vc_analysis_lpc / log_spectrum を使う
+
+    //    声質変換（ニューラル。過去の活性を保持しているので、hop の倍数でないブロックで抜けると状態がずれる）
+    //    非発話中も止めない: 遅延（hop + 先読み）を持つのでドライへ切り替えると前後がずれ、
+    //    GRU・因果畳み込みの履歴と補助スレッドのリングも連続した入力を前提にしている（入力は NS で床まで下がっている）
+    if (chain->voiceConverter != NULL && count % vc_voice_converter_hop(chain->voiceConverter) == 0 &&
+        !is_pending_reset(chain, VC_CHAIN_MODULE_VOICE)) {
+        vc_voice_converter_process(chain->voiceConverter, output, output, count);
+        guard_module(chain, VC_CHAIN_MODULE_VOICE, output, count);
+    }
+
+    // 8. マルチバンドダイナミクス（帯域別の圧縮と歯擦音の抑制。EQ で持ち上げる前に揃える）
+    //    NS と同じく activity が 0 のブロックは省略し、途中はクロスフェード
+    if (chain->params.multibandEnabled) {
+        compress_bands(chain, output, count, activityStart, activityEnd);
+        guard_module(chain, VC_CHAIN_MODULE_MULTIBAND, output, count);
+    }
+
+    // 9. イコライザ
+    for (int band = 0; band < 3; band++) {
+        vc_biquad_process(&chain->eqCoeffs[band], &chain->eqState[band], output, output, count);
+    }
+    guard_module(chain, VC_CHAIN_MODULE_EQ, output, count);
+
+    // 10. 畳み込み（電話・ラジオ・ホールなどの響き。IR の先頭は遅延なし、長い残響は背景スレッドで計算）
+    //     非発話中も止めない: 発話の終わりはちょうど非発話に入るブロックなので、止めると残響が途中で切れる。
+    //     背景スレッドの長い区間も途切れない入力の履歴から計算している
+    if (chain->convolver != NULL && chain->params.convolutionMix > 0.0f && count % VC_CONVOLVER_BLOCK_SIZE == 0 &&
+        !is_pending_reset(chain, VC_CHAIN_MODULE_CONVOLVER)) {
+        convolve(chain, output, count);
+        guard_module(chain, VC_CHAIN_MODULE_CONVOLVER, output, count);
+    }
+
+    // 11. リミッター（クリッピング防止。オーバーサンプリング時は間引きのフィルタでわずかに上限を超えうる）
+    limit(chain, output, count);
+    guard_module(chain, VC_CHAIN_MODULE_LIMITER, output, count);
+}
+
+void vc_chain_process(VCChain *chain, const float *input, float *output, int count) {
+    if (count <= 0) {
+        return;
+    }
+    if (!chain->guardEnabled) {
+        process_block(chain, input, output, count);
+        return;
+    }
+
+    // 無音で減衰していく状態が非正規化数になると、何も鳴っていないときほど重くなる
+    VCDenormalScope scope;
+    vc_denormals_flush_begin(&scope);
+    if (chain->pendingResets != 0) {
+        retry_pending_resets(chain);
+    }
+    if (vc_signal_guard_input(&chain->guard, input, output, count)) {
+        input = output;
+    }
+    process_block(chain, input, output, count);
+    vc_signal_guard_finish(&chain->guard, output, count);
+    if (!vc_denormals_flush_supported()) {
+        flush_state_denormals(chain);
+    }
+    vc_denormals_flush_end(&scope);
+}
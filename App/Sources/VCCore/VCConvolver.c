@@ -0,0 +1,672 @@
+//
+//  VCConvolver.c
+//  VoiceChanger
+//
+//  Zero-latency non-uniform partitioned convolution and memory-mapped impulse responses
+//
+
+#include "include/VCConvolver.h"
+#include "include/VCBiquad.h"
+#include "include/VCFFT.h"
+#include "include/VCSignalGuard.h"
+#include "VCAlloc.h"
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define kRingBlocks     8       // 背景段の入出力リング（ブロック数、2 のべき乗）
+#define kWakeTimeoutNs  1000000 // 起床の取りこぼしに備えた待機の上限（1ms）
+
+/// 段の構成（パーティション長と IR 上の開始位置）
+/// 開始位置をパーティション長の 2 倍にすると、ブロック j の入力が揃ってから
+/// 出力が必要になるまで 1 パーティション分の時間がある
+static const int kStageSizes[VC_CONVOLVER_MAX_STAGES] = { VC_CONVOLVER_BLOCK_SIZE, 1024, 8192 };
+static const int kStageOffsets[VC_CONVOLVER_MAX_STAGES] = { 0, 2 * 1024, 2 * 8192 };
+
+typedef struct {
+    int size;               // パーティション長 P
+    int offset;             // IR 上の開始位置
+    int partitions;
+    VCFFTPlan *plan;        // 2P
+
+    float *irRe, *irIm;     // IR のパーティションごとのスペクトル [partitions][P + 1]
+    float *fdlRe, *fdlIm;   // 入力スペクトルの遅延線 [partitions][P + 1]
+    int fdlPos;
+    float *frame;           // 直前 + 現在のブロック（2P）
+    float *time;            // 逆変換結果（2P）
+    float *accRe, *accIm;   // P + 1
+
+    // 背景段のみ（先頭段は frame をそのまま入力履歴に使う）
+    float *input;           // 入力リング [kRingBlocks][P]
+    float *output;          // 出力リング [kRingBlocks][P]
+    atomic_long tags[kRingBlocks];  // 出力スロットに入っているブロック番号（-1 = なし）
+    atomic_long requested;  // 入力が揃ったブロック数（オーディオスレッドが書く）
+    long computed;          // 計算済みブロック数（背景スレッドが書く）
+    long lateBlock;         // 最後に遅れを数えたブロック（オーディオスレッド）
+
+    // 背景スレッド（段ごとに1本。長い段の計算が短い段の締め切りを塞がないように）
+    struct VCConvolver *owner;
+    pthread_t thread;
+    int hasThread;
+    int shuttingDown;
+    pthread_mutex_t sleepLock;
+    pthread_cond_t wakeCond;
+    pthread_mutex_t jobLock;    // ブロック計算中に保持（reset が完了を待つ）
+} VCConvStage;
+
+struct VCConvolver {
+    int length;
+    int stageCount;
+    int threaded;
+    VCConvStage stages[VC_CONVOLVER_MAX_STAGES];
+
+    long position;          // 処理済みサンプル数
+    uint64_t blocks;
+    uint64_t lateBlocks;
+    atomic_uint_fast64_t tailBlocks;
+};
+
+#pragma mark - Partitions
+
+static void stage_free(VCConvStage *stage) {
+    vc_fft_plan_destroy(stage->plan);
+    vc_free(stage->irRe);
+    vc_free(stage->irIm);
+    vc_free(stage->fdlRe);
+    vc_free(stage->fdlIm);
+    vc_free(stage->frame);
+    vc_free(stage->time);
+    vc_free(stage->accRe);
+    vc_free(stage->accIm);
+    vc_free(stage->input);
+    vc_free(stage->output);
+}
+
+static void stage_clear(VCConvStage *stage) {
+    size_t bins = (size_t)stage->size + 1;
+    memset(stage->fdlRe, 0, (size_t)stage->partitions * bins * sizeof(float));
+    memset(stage->fdlIm, 0, (size_t)stage->partitions * bins * sizeof(float));
+    memset(stage->frame, 0, 2 * (size_t)stage->size * sizeof(float));
+    stage->fdlPos = 0;
+    if (stage->input != NULL) {
+        memset(stage->input, 0, (size_t)kRingBlocks * stage->size * sizeof(float));
+        memset(stage->output, 0, (size_t)kRingBlocks * stage->size * sizeof(float));
+    }
+    for (int i = 0; i < kRingBlocks; i++) {
+        atomic_store(&stage->tags[i], -1);
+    }
+    atomic_store(&stage->requested, 0);
+    stage->computed = 0;
+    stage->lateBlock = -1;
+}
+
+/// IR の [offset, end) をパーティションごとに変換して段を作る
+static int stage_init(VCConvStage *stage, int size, int offset, const float *ir, int end, int background) {
+    stage->size = size;
+    stage->offset = offset;
+    stage->partitions = (end - offset + size - 1) / size;
+
+    size_t bins = (size_t)size + 1;
+    size_t spectra = (size_t)stage->partitions * bins;
+    stage->plan = vc_fft_plan_create(2 * size);
+    stage->irRe = vc_calloc(spectra, sizeof(float));
+    stage->irIm = vc_calloc(spectra, sizeof(float));
+    stage->fdlRe = vc_calloc(spectra, sizeof(float));
+    stage->fdlIm = vc_calloc(spectra, sizeof(float));
+    stage->frame = vc_calloc(2 * (size_t)size, sizeof(float));
+    stage->time = vc_calloc(2 * (size_t)size, sizeof(float));
+    stage->accRe = vc_calloc(bins, sizeof(float));
+    stage->accIm = vc_calloc(bins, sizeof(float));
+    if (stage->plan == NULL || stage->irRe == NULL || stage->irIm == NULL || stage->fdlRe == NULL ||
+        stage->fdlIm == NULL || stage->frame == NULL || stage->time == NULL || stage->accRe == NULL ||
+        stage->accIm == NULL) {
+        return -1;
+    }
+    if (background) {
+        stage->input = vc_calloc((size_t)kRingBlocks * size, sizeof(float));
+        stage->output = vc_calloc((size_t)kRingBlocks * size, sizeof(float));
+        if (stage->input == NULL || stage->output == NULL) {
+            return -1;
+        }
+    }
+
+    // 後半をゼロにした 2P 点で変換（overlap-save の巡回畳み込みが線形になる）
+    for (int k = 0; k < stage->partitions; k++) {
+        int start = offset + k * size;
+        int frames = end - start < size ? end - start : size;
+        memset(stage->frame, 0, 2 * (size_t)size * sizeof(float));
+        memcpy(stage->frame, ir + start, (size_t)frames * sizeof(float));
+        vc_fft_forward(stage->plan, stage->frame, stage->irRe + k * bins, stage->irIm + k * bins);
+    }
+
+    stage_clear(stage);
+    return 0;
+}
+
+/// 1 ブロック分の uniform partitioned overlap-save
+/// frame の前半に直前のブロック、後半に現在のブロックが入った状態で呼び、出力 P サンプルを output に書く。
+/// 呼んだ後の frame の前半は現在のブロック（先頭段は次のブロックの履歴としてそのまま使う）
+static void stage_compute(VCConvStage *stage, float *output) {
+    int size = stage->size;
+    size_t bins = (size_t)size + 1;
+    int pos = stage->fdlPos;
+
+    vc_fft_forward(stage->plan, stage->frame, stage->fdlRe + pos * bins, stage->fdlIm + pos * bins);
+    memcpy(stage->frame, stage->frame + size, (size_t)size * sizeof(float));
+
+    // Y = Σ_k X_{j-k} H_k
+    memset(stage->accRe, 0, bins * sizeof(float));
+    memset(stage->accIm, 0, bins * sizeof(float));
+    int slot = pos;
+    for (int k = 0; k < stage->partitions; k++) {
+        vc_complex_mac(stage->accRe, stage->accIm,
+                       stage->fdlRe + slot * bins, stage->fdlIm + slot * bins,
+                       stage->irRe + k * bins, stage->irIm + k * bins, (int)bins);
+        slot = slot == 0 ? stage->partitions - 1 : slot - 1;
+    }
+    stage->fdlPos = pos + 1 == stage->partitions ? 0 : pos + 1;
+
+    // 前半は巡回の折り返しなので捨てる
+    vc_fft_inverse(stage->plan, stage->accRe, stage->accIm, stage->time);
+    memcpy(output, stage->time + size, (size_t)size * sizeof(float));
+}
+
+/// 背景段のブロック j を計算して出力リングへ置く
+static void stage_compute_block(VCConvolver *convolver, VCConvStage *stage, long block) {
+    int size = stage->size;
+    int slot = (int)(block & (kRingBlocks - 1));
+    memcpy(stage->frame + size, stage->input + (size_t)slot * size, (size_t)size * sizeof(float));
+    stage_compute(stage, stage->output + (size_t)slot * size);
+    atomic_store_explicit(&stage->tags[slot], block, memory_order_release);
+    atomic_fetch_add_explicit(&convolver->tailBlocks, 1, memory_order_relaxed);
+}
+
+#pragma mark - Background Threads
+
+static int has_pending_block(VCConvStage *stage) {
+    return stage->computed < atomic_load_explicit(&stage->requested, memory_order_acquire);
+}
+
+static void *stage_worker_main(void *arg) {
+    VCConvStage *stage = (VCConvStage *)arg;
+    vc_denormals_flush_thread();      // 残響の尾が減衰しきるまでの計算が非正規化数で重くならないように
+
+    for (;;) {
+        pthread_mutex_lock(&stage->jobLock);
+        int worked = has_pending_block(stage);
+        if (worked) {
+            stage_compute_block(stage->owner, stage, stage->computed);
+            stage->computed++;
+        }
+        pthread_mutex_unlock(&stage->jobLock);
+        if (worked) {
+            continue;
+        }
+
+        // オーディオスレッドは trylock でしか起こさないので、取りこぼしに備えて時間で区切って待つ
+        pthread_mutex_lock(&stage->sleepLock);
+        if (!stage->shuttingDown && !has_pending_block(stage)) {
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += kWakeTimeoutNs;
+            if (deadline.tv_nsec >= 1000000000L) {
+                deadline.tv_sec += 1;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&stage->wakeCond, &stage->sleepLock, &deadline);
+        }
+        int done = stage->shuttingDown;
+        pthread_mutex_unlock(&stage->sleepLock);
+
+        if (done) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+/// オーディオスレッドから背景スレッドを起こす（ロックが取れなければ時間切れの起床に任せる）
+static void wake_worker(VCConvStage *stage) {
+    if (pthread_mutex_trylock(&stage->sleepLock) == 0) {
+        pthread_cond_signal(&stage->wakeCond);
+        pthread_mutex_unlock(&stage->sleepLock);
+    }
+}
+
+static void stage_stop_worker(VCConvStage *stage) {
+    if (!stage->hasThread) {
+        return;
+    }
+    pthread_mutex_lock(&stage->sleepLock);
+    stage->shuttingDown = 1;
+    pthread_cond_signal(&stage->wakeCond);
+    pthread_mutex_unlock(&stage->sleepLock);
+    pthread_join(stage->thread, NULL);
+    stage->hasThread = 0;
+}
+
+#pragma mark - Lifecycle
+
+VCConvolver *vc_convolver_create(const float *impulseResponse, int length, int threaded) {
+    if (impulseResponse == NULL || length <= 0) {
+        return NULL;
+    }
+
+    VCConvolver *convolver = vc_calloc(1, sizeof(VCConvolver));
+    if (convolver == NULL) {
+        return NULL;
+    }
+    convolver->length = length;
+    for (int s = 0; s < VC_CONVOLVER_MAX_STAGES; s++) {
+        VCConvStage *stage = &convolver->stages[s];
+        stage->owner = convolver;
+        pthread_mutex_init(&stage->sleepLock, NULL);
+        pthread_cond_init(&stage->wakeCond, NULL);
+        pthread_mutex_init(&stage->jobLock, NULL);
+    }
+
+    for (int s = 0; s < VC_CONVOLVER_MAX_STAGES && kStageOffsets[s] < length; s++) {
+        int end = s + 1 < VC_CONVOLVER_MAX_STAGES && kStageOffsets[s + 1] < length ? kStageOffsets[s + 1] : length;
+        convolver->stageCount = s + 1;
+        if (stage_init(&convolver->stages[s], kStageSizes[s], kStageOffsets[s], impulseResponse, end, s > 0) != 0) {
+            vc_convolver_destroy(convolver);
+            return NULL;
+        }
+    }
+
+    // 背景段がなければスレッドは要らない
+    convolver->threaded = threaded && convolver->stageCount > 1;
+    for (int s = 1; s < convolver->stageCount && convolver->threaded; s++) {
+        VCConvStage *stage = &convolver->stages[s];
+        if (pthread_create(&stage->thread, NULL, stage_worker_main, stage) == 0) {
+            stage->hasThread = 1;
+        } else {
+            // 起動済みの分も止めて process 内で計算する
+            for (int i = 1; i < s; i++) {
+                stage_stop_worker(&convolver->stages[i]);
+            }
+            convolver->threaded = 0;
+        }
+    }
+    return convolver;
+}
+
+void vc_convolver_destroy(VCConvolver *convolver) {
+    if (convolver == NULL) {
+        return;
+    }
+    for (int s = 0; s < VC_CONVOLVER_MAX_STAGES; s++) {
+        VCConvStage *stage = &convolver->stages[s];
+        stage_stop_worker(stage);
+        stage_free(stage);
+        pthread_mutex_destroy(&stage->jobLock);
+        pthread_cond_destroy(&stage->wakeCond);
+        pthread_mutex_destroy(&stage->sleepLock);
+    }
+    vc_free(convolver);
+}
+
+int vc_convolver_length(const VCConvolver *convolver) {
+    return convolver->length;
+}
+
+void vc_convolver_reset(VCConvolver *convolver) {
+    // 計算中のブロックが終わるのを待ってから履歴を消す
+    for (int s = 0; s < convolver->stageCount; s++) {
+        VCConvStage *stage = &convolver->stages[s];
+        pthread_mutex_lock(&stage->jobLock);
+        stage_clear(stage);
+        pthread_mutex_unlock(&stage->jobLock);
+    }
+    convolver->position = 0;
+}
+
+int vc_convolver_try_reset(VCConvolver *convolver) {
+    // すべての段のロックが取れたときだけ消す（一部だけ消すと段の間で履歴の位置がずれる）
+    for (int s = 0; s < convolver->stageCount; s++) {
+        if (pthread_mutex_trylock(&convolver->stages[s].jobLock) != 0) {
+            while (--s >= 0) {
+                pthread_mutex_unlock(&convolver->stages[s].jobLock);
+            }
+            return -1;
+        }
+    }
+    for (int s = 0; s < convolver->stageCount; s++) {
+        stage_clear(&convolver->stages[s]);
+        pthread_mutex_unlock(&convolver->stages[s].jobLock);
+    }
+    convolver->position = 0;
+    return 0;
+}
+
+void vc_convolver_get_stats(const VCConvolver *convolver, VCConvolverStats *outStats) {
+    outStats->length = convolver->length;
+    outStats->stages = convolver->stageCount;
+    outStats->blocks = convolver->blocks;
+    outStats->tailBlocks = atomic_load_explicit(&((VCConvolver *)convolver)->tailBlocks, memory_order_relaxed);
+    outStats->lateBlocks = convolver->lateBlocks;
+}
+
+#pragma mark - Processing
+
+/// 背景段へ入力を渡し、揃ったブロックを計算に回す
+static void feed_stage(VCConvolver *convolver, VCConvStage *stage, const float *input) {
+    int size = stage->size;
+    long position = convolver->position;
+    long block = position / size;
+    int offset = (int)(position - block * size);
+    memcpy(stage->input + (size_t)(block & (kRingBlocks - 1)) * size + offset, input,
+           VC_CONVOLVER_BLOCK_SIZE * sizeof(float));
+
+    if (offset + VC_CONVOLVER_BLOCK_SIZE == size) {
+        atomic_store_explicit(&stage->requested, block + 1, memory_order_release);
+        if (convolver->threaded) {
+            wake_worker(stage);
+        } else {
+            stage_compute_block(convolver, stage, block);
+            stage->computed = block + 1;
+        }
+    }
+}
+
+/// 背景段の出力（IR の offset 以降との畳み込み）を output に足す
+static void mix_stage(VCConvolver *convolver, VCConvStage *stage, float *output) {
+    long delayed = convolver->position - stage->offset;
+    if (delayed < 0) {
+        return;
+    }
+    long block = delayed / stage->size;
+    int offset = (int)(delayed - block * stage->size);
+    int slot = (int)(block & (kRingBlocks - 1));
+    if (atomic_load_explicit(&stage->tags[slot], memory_order_acquire) != block) {
+        if (stage->lateBlock != block) {
+            stage->lateBlock = block;
+            convolver->lateBlocks++;
+        }
+        return;
+    }
+
+    const float *tail = stage->output + (size_t)slot * stage->size + offset;
+    for (int i = 0; i < VC_CONVOLVER_BLOCK_SIZE; i++) {
+        output[i] += tail[i];
+    }
+}
+
+int vc_convolver_process(VCConvolver *convolver, const float *input, float *output, int count) {
+    if (count % VC_CONVOLVER_BLOCK_SIZE != 0) {
+        return -1;
+    }
+
+    VCConvStage *head = &convolver->stages[0];
+    for (int offset = 0; offset < count; offset += VC_CONVOLVER_BLOCK_SIZE) {
+        // 入力を先に取り込む（input == output でも読み終えてから書く）
+        memcpy(head->frame + VC_CONVOLVER_BLOCK_SIZE, input + offset, VC_CONVOLVER_BLOCK_SIZE * sizeof(float));
+        for (int s = 1; s < convolver->stageCount; s++) {
+            feed_stage(convolver, &convolver->stages[s], input + offset);
+        }
+
+        stage_compute(head, output + offset);
+        for (int s = 1; s < convolver->stageCount; s++) {
+            mix_stage(convolver, &convolver->stages[s], output + offset);
+        }
+
+        convolver->position += VC_CONVOLVER_BLOCK_SIZE;
+        convolver->blocks++;
+    }
+    return 0;
+}
+
+#pragma mark - Impulse Responses
+
+static uint32_t read_u32(const uint8_t *bytes) {
+    return (uint32_t)bytes[0] | (uint32_t)bytes[1] << 8 | (uint32_t)bytes[2] << 16 | (uint32_t)bytes[3] << 24;
+}
+
+static uint16_t read_u16(const uint8_t *bytes) {
+    return (uint16_t)(bytes[0] | bytes[1] << 8);
+}
+
+/// 1 サンプル（先頭チャンネル）を float へ
+static float decode_sample(const uint8_t *bytes, int isFloat, int bits) {
+    if (isFloat) {
+        uint32_t word = read_u32(bytes);
+        float value;
+        memcpy(&value, &word, sizeof(value));
+        return value;
+    }
+    switch (bits) {
+        case 16: return (float)(int16_t)read_u16(bytes) / 32768.0f;
+        case 24: return (float)((int32_t)((uint32_t)read_u16(bytes) << 8 | (uint32_t)bytes[2] << 24) >> 8) / 8388608.0f;
+        default: return (float)(int32_t)read_u32(bytes) / 2147483648.0f;
+    }
+}
+
+int vc_ir_load(const char *path, VCImpulseResponse *outIR) {
+    memset(outIR, 0, sizeof(*outIR));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < 44) {
+        close(fd);
+        return -1;
+    }
+    size_t size = (size_t)info.st_size;
+    void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return -1;
+    }
+    posix_madvise(mapping, size, POSIX_MADV_SEQUENTIAL);
+    outIR->mapping = mapping;
+    outIR->mappingSize = size;
+
+    const uint8_t *bytes = mapping;
+    if (memcmp(bytes, "RIFF", 4) != 0 || memcmp(bytes + 8, "WAVE", 4) != 0) {
+        vc_ir_release(outIR);
+        return -1;
+    }
+
+    // チャンクを順に見て fmt / data を探す
+    int format = 0, channels = 0, sampleRate = 0, bits = 0;
+    const uint8_t *data = NULL;
+    size_t dataSize = 0;
+    size_t pos = 12;
+    while (pos + 8 <= size) {
+        const uint8_t *chunk = bytes + pos;
+        size_t chunkSize = read_u32(chunk + 4);
+        const uint8_t *body = chunk + 8;
+        if (chunkSize > size - pos - 8) {
+            chunkSize = size - pos - 8;     // 途中で切れたファイルは残りを使う
+        }
+        if (memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16) {
+            format = read_u16(body);
+            channels = read_u16(body + 2);
+            sampleRate = (int)read_u32(body + 4);
+            bits = read_u16(body + 14);
+            if (format == 0xFFFE && chunkSize >= 26) {
+                format = read_u16(body + 24);   // WAVE_FORMAT_EXTENSIBLE のサブフォーマット
+            }
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            data = body;
+            dataSize = chunkSize;
+        }
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    int isFloat = format == 3;
+    int valid = (format == 1 && (bits == 16 || bits == 24 || bits == 32)) || (isFloat && bits == 32);
+    if (data == NULL || !valid || channels <= 0 || sampleRate <= 0) {
+        vc_ir_release(outIR);
+        return -1;
+    }
+    size_t frameBytes = (size_t)channels * (size_t)bits / 8;
+    size_t frames = dataSize / frameBytes;
+    if (frames == 0 || frames > INT32_MAX) {
+        vc_ir_release(outIR);
+        return -1;
+    }
+    outIR->length = (int)frames;
+    outIR->sampleRate = sampleRate;
+
+    // float モノラルはマップした領域をそのまま使う（ページ境界からの位置は 4 の倍数であること）
+    if (isFloat && channels == 1 && ((uintptr_t)data & (sizeof(float) - 1)) == 0) {
+        outIR->samples = (const float *)(const void *)data;
+        return 0;
+    }
+
+    outIR->converted = vc_malloc(frames * sizeof(float));
+    if (outIR->converted == NULL) {
+        vc_ir_release(outIR);
+        return -1;
+    }
+    for (size_t i = 0; i < frames; i++) {
+        outIR->converted[i] = decode_sample(data + i * frameBytes, isFloat, bits);
+    }
+    outIR->samples = outIR->converted;
+
+    // 変換後はファイルを参照しない
+    munmap(outIR->mapping, outIR->mappingSize);
+    outIR->mapping = NULL;
+    outIR->mappingSize = 0;
+    return 0;
+}
+
+void vc_ir_release(VCImpulseResponse *ir) {
+    if (ir->mapping != NULL) {
+        munmap(ir->mapping, ir->mappingSize);
+    }
+    vc_free(ir->converted);
+    memset(ir, 0, sizeof(*ir));
+}
+
+#pragma mark - Built-in Impulse Responses
+
+static const char *const kBuiltinNames[VC_IR_BUILTIN_COUNT] = { "phone", "radio", "hall" };
+static const float kBuiltinSeconds[VC_IR_BUILTIN_COUNT] = { 0.03f, 0.06f, 2.2f };
+
+int vc_ir_builtin_named(const char *name) {
+    if (name == NULL) {
+        return -1;
+    }
+    for (int i = 0; i < VC_IR_BUILTIN_COUNT; i++) {
+        if (strcmp(name, kBuiltinNames[i]) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int vc_ir_builtin_length(VCBuiltinImpulseResponse kind, int sampleRate) {
+    if ((int)kind < 0 || kind >= VC_IR_BUILTIN_COUNT || sampleRate <= 0) {
+        return 0;
+    }
+    return (int)(kBuiltinSeconds[kind] * (float)sampleRate);
+}
+
+/// 決定的な一様乱数（-1〜1）
+static float next_noise(uint32_t *seed) {
+    *seed ^= *seed << 13;
+    *seed ^= *seed >> 17;
+    *seed ^= *seed << 5;
+    return (float)(*seed >> 8) / 8388608.0f - 1.0f;
+}
+
+/// 筐体の反射（遅延 ms、ゲイン）を足す
+static void add_reflections(float *output, int length, const float *delaysMs, const float *gains, int count,
+                            float sampleRate) {
+    for (int r = 0; r < count; r++) {
+        int delay = (int)(delaysMs[r] * sampleRate / 1000.0f);
+        if (delay < length) {
+            output[delay] += gains[r];
+        }
+    }
+}
+
+/// biquad を順に通す
+static void filter_in_place(VCBiquadCoeffs *coeffs, int count, float *samples, int length) {
+    for (int i = 0; i < count; i++) {
+        VCBiquadState state;
+        vc_biquad_reset(&state);
+        vc_biquad_process(&coeffs[i], &state, samples, samples, length);
+    }
+}
+
+int vc_ir_builtin_render(VCBuiltinImpulseResponse kind, int sampleRate, float *output, int capacity) {
+    int length = vc_ir_builtin_length(kind, sampleRate);
+    if (length <= 0 || capacity < length) {
+        return -1;
+    }
+    float sr = (float)sampleRate;
+    memset(output, 0, (size_t)length * sizeof(float));
+    VCBiquadCoeffs filters[5];
+
+    switch (kind) {
+        case VC_IR_PHONE: {
+            static const float delays[] = { 0.0f, 1.1f, 2.3f };
+            static const float gains[] = { 1.0f, 0.25f, -0.12f };
+            add_reflections(output, length, delays, gains, 3, sr);
+            vc_biquad_set_highpass(&filters[0], 300.0f, 0.707f, sr);
+            vc_biquad_set_highpass(&filters[1], 300.0f, 0.707f, sr);
+            vc_biquad_set_lowpass(&filters[2], 3400.0f, 0.707f, sr);
+            vc_biquad_set_lowpass(&filters[3], 3400.0f, 0.707f, sr);
+            vc_biquad_set_peaking(&filters[4], 1500.0f, 4.0f, 1.2f, sr);
+            filter_in_place(filters, 5, output, length);
+            break;
+        }
+        case VC_IR_RADIO: {
+            static const float delays[] = { 0.0f, 0.7f, 1.9f, 3.1f, 4.4f };
+            static const float gains[] = { 1.0f, 0.35f, 0.2f, -0.12f, 0.07f };
+            add_reflections(output, length, delays, gains, 5, sr);
+            vc_biquad_set_highpass(&filters[0], 500.0f, 0.707f, sr);
+            vc_biquad_set_highpass(&filters[1], 500.0f, 0.707f, sr);
+            vc_biquad_set_lowpass(&filters[2], 4500.0f, 0.707f, sr);
+            vc_biquad_set_lowpass(&filters[3], 4500.0f, 0.707f, sr);
+            vc_biquad_set_peaking(&filters[4], 2000.0f, 6.0f, 1.0f, sr);
+            filter_in_place(filters, 5, output, length);
+            break;
+        }
+        case VC_IR_HALL: {
+            // 直接音 + 初期反射 + プリディレイ後に RT60 = 2 秒で減衰する拡散残響
+            static const float delays[] = { 0.0f, 11.0f, 17.0f, 23.0f, 31.0f, 43.0f };
+            static const float gains[] = { 1.0f, 0.45f, -0.38f, 0.32f, -0.27f, 0.22f };
+            add_reflections(output, length, delays, gains, 6, sr);
+            uint32_t seed = 0x2545F491u;
+            int preDelay = (int)(0.025f * sr);
+            float decay = -6.9078f / (2.0f * sr);   // ln(10^-3) / (RT60 × fs)
+            for (int i = preDelay; i < length; i++) {
+                float envelope = 0.35f * expf(decay * (float)(i - preDelay));
+                output[i] += envelope * next_noise(&seed);
+            }
+            // 高域ほど早く減衰する響きの代わりに全体を少し暗くする
+            vc_biquad_set_lowpass(&filters[0], 6000.0f, 0.707f, sr);
+            vc_biquad_set_highpass(&filters[1], 120.0f, 0.707f, sr);
+            filter_in_place(filters, 2, output, length);
+            break;
+        }
+        default:
+            return -1;
+    }
+
+    // エネルギーを 1 に正規化（ウェット音量がドライと大きく変わらないように）
+    double energy = 0;
+    for (int i = 0; i < length; i++) {
+        energy += (double)output[i] * output[i];
+    }
+    if (energy > 0) {
+        float scale = (float)(1.0 / sqrt(energy));
+        for (int i = 0; i < length; i++) {
+            output[i] *= scale;
+        }
+    }
+    return length;
+}
@@ -0,0 +1,85 @@
+//
+//  VCDriverIO.c
+//  VoiceChanger
+//
+//  Portable core of the driver's IO path (virtual mic read, zero timestamp),
+//  shared by the Audio Server plug-in and the Linux IO-trace replay
+//
+
+#include "include/VCDriverIO.h"
+#include <string.h>
+
+static unsigned int set_peer(int *peerActive, int active, unsigned int event) {
+    if (*peerActive == active) {
+        return 0;
+    }
+    *peerActive = active;
+    return event;
+}
+
+VCDriverReadResult vc_driver_read_input(VCSharedRing *ring, VCSharedRingWatch *watch, uint64_t now,
+                                        float *output, int frameCount, int *peerActive) {
+    VCDriverReadResult result;
+    memset(&result, 0, sizeof(result));
+
+    // アプリが区画を作り直した（古いビューは読まずに張り替えを待つ）
+    VCSharedRingPeer peer = VC_SHARED_RING_PEER_ALIVE;
+    if (ring != NULL) {
+        vc_shared_ring_indices(ring, &result.writeIndex, &result.readIndex);
+        result.available = (int)(result.writeIndex - result.readIndex);
+        peer = vc_shared_ring_watch_check(watch, ring, now);
+        if (peer == VC_SHARED_RING_PEER_REPLACED) {
+            result.status = VC_DRIVER_READ_REPLACED;
+            result.events = set_peer(peerActive, 0, VC_DRIVER_PEER_EVENT_LOST);
+            memset(output, 0, (size_t)frameCount * sizeof(float));
+            return result;
+        }
+    }
+
+    // 共有メモリがない、または非アクティブの場合は無音
+    if (ring == NULL || !vc_shared_ring_is_active(ring)) {
+        result.status = ring == NULL ? VC_DRIVER_READ_DETACHED : VC_DRIVER_READ_INACTIVE;
+        result.events = set_peer(peerActive, 0, VC_DRIVER_PEER_EVENT_INACTIVE);
+        memset(output, 0, (size_t)frameCount * sizeof(float));
+        return result;
+    }
+    result.events = set_peer(peerActive, 1, VC_DRIVER_PEER_EVENT_ACTIVE);
+
+    // リングの領域を直接参照し、出力先へ1回だけコピー
+    VCRingRegions regions;
+    int granted = vc_shared_ring_read_regions(ring, frameCount, &regions);
+    if (granted < frameCount) {
+        if (peer == VC_SHARED_RING_PEER_STALLED) {
+            // 稼働中のまま書き込みが止まった。同じ区画を引き継いで再開するまで無音
+            result.status = VC_DRIVER_READ_STALLED;
+            result.events |= set_peer(peerActive, 0, VC_DRIVER_PEER_EVENT_LOST);
+        } else {
+            result.status = VC_DRIVER_READ_UNDERRUN;
+        }
+        memset(output, 0, (size_t)frameCount * sizeof(float));
+        return result;
+    }
+
+    memcpy(output, regions.first, (size_t)regions.firstCount * sizeof(float));
+    if (regions.secondCount > 0) {
+        memcpy(output + regions.firstCount, regions.second, (size_t)regions.secondCount * sizeof(float));
+    }
+    vc_shared_ring_commit_read(ring, granted);
+    result.status = VC_DRIVER_READ_OK;
+    return result;
+}
+
+void vc_driver_zero_timestamp(uint64_t anchorHostTime, uint64_t now, double hostTicksPerFrame, uint32_t period,
+                              double *outSampleTime, uint64_t *outHostTime) {
+    uint64_t elapsedHostTime = now - anchorHostTime;
+    double elapsedSampleTime = (double)elapsedHostTime / hostTicksPerFrame;
+
+    // ゼロタイムスタンプを計算（周期に丸める）
+    uint64_t periods = (uint64_t)elapsedSampleTime / period;
+    *outSampleTime = (double)(periods * period);
+    *outHostTime = anchorHostTime + (uint64_t)(*outSampleTime * hostTicksPerFrame);
+}
+
+uint64_t vc_driver_sample_host_time(uint64_t anchorHostTime, double sampleTime, double hostTicksPerFrame) {
+    return anchorHostTime + (uint64_t)(sampleTime * hostTicksPerFrame);
+}
@@ -0,0 +1,191 @@
+//
+//  VCDynamics.c
+//  VoiceChanger
+//
+//  Portable dynamics kernels: noise gate, AGC, limiter
+//
+
+#include "include/VCDynamics.h"
+#include "include/VCFastMath.h"
+#include <math.h>
+#include <string.h>
+
+#define kGateAttenuation    0.1f    // 閾値未満のサンプルに掛けるゲイン（-20dB）
+#define kLimiterAttack      0.001f  // 1 サンプルあたりの追従係数（元のレート）
+#define kLimiterRelease     0.05f
+
+#pragma mark - Noise Gate
+
+void vc_noise_gate_init(VCNoiseGate *gate) {
+    gate->strength = 0.5f;
+}
+
+void vc_noise_gate_set_strength(VCNoiseGate *gate, float strength) {
+    gate->strength = fmaxf(0.0f, fminf(1.0f, strength));
+}
+
+void vc_noise_gate_process(const VCNoiseGate *gate, float *samples, int count) {
+    // 簡易的なノイズゲート実装
+    // TODO: WebRTC NSまたはRNNoiseを統合
+    const float threshold = 0.01f * (1.0f - gate->strength);
+    for (int i = 0; i < count; i++) {
+        if (fabsf(samples[i]) < threshold) {
+            samples[i] *= kGateAttenuation;
+        }
+    }
+}
+
+float vc_noise_gate_floor_gain(const VCNoiseGate *gate) {
+    return gate->strength > 0 ? kGateAttenuation : 1.0f;
+}
+
+void vc_noise_gate_process_with_activity(const VCNoiseGate *gate, float *samples, float *scratch, int count,
+                                         float activityStart, float activityEnd) {
+    if (activityStart >= 1.0f && activityEnd >= 1.0f) {
+        vc_noise_gate_process(gate, samples, count);
+        return;
+    }
+
+    float floorGain = vc_noise_gate_floor_gain(gate);
+    if (activityStart <= 0.0f && activityEnd <= 0.0f) {
+        for (int i = 0; i < count; i++) {
+            samples[i] *= floorGain;
+        }
+        return;
+    }
+
+    memcpy(scratch, samples, (size_t)count * sizeof(float));
+    vc_noise_gate_process(gate, scratch, count);
+    float step = (activityEnd - activityStart) / (float)count;
+    for (int i = 0; i < count; i++) {
+        float mix = activityStart + step * (float)(i + 1);
+        samples[i] = mix * scratch[i] + (1.0f - mix) * floorGain * samples[i];
+    }
+}
+
+#pragma mark - AGC
+
+void vc_agc_init(VCAgc *agc) {
+    agc->targetDb = -18.0f;
+    agc->currentGain = 1.0f;
+    agc->attackTime = 0.01f;
+    agc->releaseTime = 0.1f;
+    agc->voiceActive = 1;
+}
+
+void vc_agc_set_target(VCAgc *agc, float targetDb) {
+    agc->targetDb = targetDb;
+}
+
+void vc_agc_set_voice_activity(VCAgc *agc, int active) {
+    agc->voiceActive = active;
+}
+
+void vc_agc_process(VCAgc *agc, float *samples, int count) {
+    if (count <= 0) {
+        return;
+    }
+
+    // RMSレベル計算
+    float gain = vc_agc_update_gain(agc, vc_rms(samples, count));
+
+    // ゲイン適用
+    for (int i = 0; i < count; i++) {
+        samples[i] *= gain;
+    }
+}
+
+float vc_agc_update_gain(VCAgc *agc, float rms) {
+    // 無音・雑音区間でゲインを持ち上げるとポンピングになるので据え置く
+    if (!agc->voiceActive) {
+        return agc->currentGain;
+    }
+
+    float currentDb = vc_fast_linear_to_db(fmaxf(rms, 1e-10f));
+    float targetGain = vc_fast_db_to_linear(agc->targetDb - currentDb);
+
+    // スムーズなゲイン変更
+    float alpha = currentDb < agc->targetDb ? agc->attackTime : agc->releaseTime;
+    float gain = agc->currentGain * (1.0f - alpha) + targetGain * alpha;
+    gain = fmaxf(0.1f, fminf(10.0f, gain));
+    agc->currentGain = gain;
+    return gain;
+}
+
+#pragma mark - Limiter
+
+void vc_limiter_init(VCLimiter *limiter) {
+    limiter->ceiling = 0.89f;       // -1dB
+    limiter->threshold = 0.7f;      // Soft knee starts here
+    limiter->attackCoeff = kLimiterAttack;
+    limiter->releaseCoeff = kLimiterRelease;
+    limiter->envelope = 0.0f;
+}
+
+void vc_limiter_set_ceiling(VCLimiter *limiter, float ceilingDb) {
+    limiter->ceiling = vc_fast_db_to_linear(ceilingDb);
+    limiter->threshold = limiter->ceiling * 0.8f;
+}
+
+void vc_limiter_set_oversampling(VCLimiter *limiter, int factor) {
+    // factor 倍のサンプルで元のレートと同じ時定数になるよう係数を換算する
+    float exponent = 1.0f / (float)(factor > 1 ? factor : 1);
+    limiter->attackCoeff = 1.0f - powf(1.0f - kLimiterAttack, exponent);
+    limiter->releaseCoeff = 1.0f - powf(1.0f - kLimiterRelease, exponent);
+}
+
+void vc_limiter_process(VCLimiter *limiter, float *samples, int count) {
+    const float ceiling = limiter->ceiling;
+    const float threshold = limiter->threshold;
+    const float attackCoeff = limiter->attackCoeff;
+    const float releaseCoeff = limiter->releaseCoeff;
+    const float range = ceiling - threshold;
+    const float compressionRatio = 10.0f;  // 10:1 limiting
+    float envelope = limiter->envelope;
+
+    for (int i = 0; i < count; i++) {
+        float input = samples[i];
+        float absInput = fabsf(input);
+
+        // エンベロープ追従
+        if (absInput > envelope) {
+            envelope = attackCoeff * absInput + (1.0f - attackCoeff) * envelope;
+        } else {
+            envelope = releaseCoeff * absInput + (1.0f - releaseCoeff) * envelope;
+        }
+
+        // ゲイン計算
+        float gain = 1.0f;
+        if (envelope > threshold) {
+            // ソフトニー圧縮
+            float overshoot = envelope - threshold;
+            gain = threshold + range * vc_fast_tanhf(overshoot / range * compressionRatio) / envelope;
+        }
+
+        // クリッピング防止
+        if (fabsf(input * gain) > ceiling) {
+            gain = ceiling / fmaxf(absInput, 0.0001f);
+        }
+
+        samples[i] = input * gain;
+    }
+
+    limiter->envelope = envelope;
+}
+
+void vc_limiter_reset(VCLimiter *limiter) {
+    limiter->envelope = 0.0f;
+}
+
+#pragma mark - Utilities
+
+float vc_rms(const float *samples, int count) {
+    if (count <= 0) {
+        return 0.0f;
+    }
+    float sum = 0.0f;
+    for (int i = 0; i < count; i++) {
+        sum += samples[i] * samples[i];
+    }
+    return sqrtf(sum / (float)count);
+}
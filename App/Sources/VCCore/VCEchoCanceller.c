@@ -0,0 +1,331 @@
+//
+//  VCEchoCanceller.c
+//  VoiceChanger
+//
+//  Partitioned-block frequency-domain adaptive filter (MDF) echo canceller
+//
+
+#include "include/VCEchoCanceller.h"
+#include "include/VCFFT.h"
+#include "include/VCFastMath.h"
+#include "VCAlloc.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define kMinBlockSize           8
+#define kMaxBlockSize           1024
+#define kStepSize               0.4f    // 正規化ステップ（0〜1）
+#define kErleSmoothing          0.003f  // ERLE 推定の平滑（≒ 0.7 s @ 128 サンプル）
+#define kShortSmoothing         0.25f   // ダブルトーク判定用の短時間平滑（≒ 10 ms）
+#define kConvergedErleDb        6.0f
+#define kDoubleTalkFactor       2.0f    // マイクがエコー推定の 3dB 超でダブルトーク
+#define kDoubleTalkHangover     16      // ブロック
+#define kFarActiveLevel         1e-7f   // 遠端の平均二乗がこれ以下なら無音（-70 dBFS）
+#define kPowerFloor             1e-6f
+
+struct VCEchoCanceller {
+    int blockSize;      // L
+    int fftSize;        // N = 2L
+    int bins;           // L + 1
+    int stride;         // 4 の倍数に切り上げたビン数
+    int partitions;     // P
+
+    VCFFTPlan *plan;
+
+    // W[p], X[p]（p = 0 が最新）。X はリングで持ち xHead が最新
+    float *weightRe;
+    float *weightIm;
+    float *farRe;
+    float *farIm;
+    int xHead;
+    int constrainIndex;
+
+    float *partitionPower;  // |X[p]|^2（X と同じリング）
+    float *farPower;        // Σp |X[p]|^2（NLMS の正規化）
+    float *farHistory;  // 直近 2L サンプル
+    float *time;        // [N]
+    float *echoRe;      // Y
+    float *echoIm;
+    float *errorRe;     // E（ステップを掛けたもの）
+    float *errorIm;
+    float *power;       // 作業用
+
+    // ERLE / ダブルトーク
+    float nearEnergy;
+    float errorEnergy;
+    float shortNearEnergy;
+    float shortEchoEnergy;
+    float erleDb;
+    int converged;
+    int hangover;
+
+    VCEchoCancellerStats stats;
+};
+
+static int is_pow2(int value) {
+    return value > 0 && (value & (value - 1)) == 0;
+}
+
+static float *alloc_floats(size_t count) {
+    size_t bytes = (count * sizeof(float) + 63) & ~(size_t)63;
+    float *buffer = vc_aligned_alloc(64, bytes);
+    if (buffer != NULL) {
+        memset(buffer, 0, bytes);
+    }
+    return buffer;
+}
+
+static float energy(const float *samples, int count) {
+    float sum = 0;
+    for (int i = 0; i < count; i++) {
+        sum += samples[i] * samples[i];
+    }
+    return sum;
+}
+
+static inline float *slot(float *base, const VCEchoCanceller *aec, int index) {
+    return base + (size_t)index * aec->stride;
+}
+
+#pragma mark - Lifecycle
+
+VCEchoCanceller *vc_aec_create(int blockSize, int tailFrames) {
+    if (!is_pow2(blockSize) || blockSize < kMinBlockSize || blockSize > kMaxBlockSize || tailFrames <= 0) {
+        return NULL;
+    }
+
+    VCEchoCanceller *aec = vc_calloc(1, sizeof(VCEchoCanceller));
+    if (aec == NULL) {
+        return NULL;
+    }
+
+    aec->blockSize = blockSize;
+    aec->fftSize = 2 * blockSize;
+    aec->bins = blockSize + 1;
+    aec->stride = (aec->bins + 3) & ~3;
+    aec->partitions = (tailFrames + blockSize - 1) / blockSize;
+
+    size_t spectra = (size_t)aec->partitions * aec->stride;
+    aec->plan = vc_fft_plan_create(aec->fftSize);
+    aec->weightRe = alloc_floats(spectra);
+    aec->weightIm = alloc_floats(spectra);
+    aec->farRe = alloc_floats(spectra);
+    aec->farIm = alloc_floats(spectra);
+    aec->partitionPower = alloc_floats(spectra);
+    aec->farPower = alloc_floats(aec->stride);
+    aec->farHistory = alloc_floats(aec->fftSize);
+    aec->time = alloc_floats(aec->fftSize);
+    aec->echoRe = alloc_floats(aec->stride);
+    aec->echoIm = alloc_floats(aec->stride);
+    aec->errorRe = alloc_floats(aec->stride);
+    aec->errorIm = alloc_floats(aec->stride);
+    aec->power = alloc_floats(aec->stride);
+
+    if (aec->plan == NULL || aec->weightRe == NULL || aec->weightIm == NULL ||
+        aec->farRe == NULL || aec->farIm == NULL || aec->partitionPower == NULL || aec->farPower == NULL ||
+        aec->farHistory == NULL || aec->time == NULL || aec->echoRe == NULL ||
+        aec->echoIm == NULL || aec->errorRe == NULL || aec->errorIm == NULL || aec->power == NULL) {
+        vc_aec_destroy(aec);
+        return NULL;
+    }
+
+    vc_aec_reset(aec);
+    return aec;
+}
+
+void vc_aec_destroy(VCEchoCanceller *aec) {
+    if (aec == NULL) {
+        return;
+    }
+    vc_fft_plan_destroy(aec->plan);
+    vc_free(aec->weightRe);
+    vc_free(aec->weightIm);
+    vc_free(aec->farRe);
+    vc_free(aec->farIm);
+    vc_free(aec->partitionPower);
+    vc_free(aec->farPower);
+    vc_free(aec->farHistory);
+    vc_free(aec->time);
+    vc_free(aec->echoRe);
+    vc_free(aec->echoIm);
+    vc_free(aec->errorRe);
+    vc_free(aec->errorIm);
+    vc_free(aec->power);
+    vc_free(aec);
+}
+
+int vc_aec_block_size(const VCEchoCanceller *aec) {
+    return aec->blockSize;
+}
+
+void vc_aec_reset(VCEchoCanceller *aec) {
+    size_t spectra = (size_t)aec->partitions * aec->stride;
+    memset(aec->weightRe, 0, spectra * sizeof(float));
+    memset(aec->weightIm, 0, spectra * sizeof(float));
+    memset(aec->farRe, 0, spectra * sizeof(float));
+    memset(aec->farIm, 0, spectra * sizeof(float));
+    memset(aec->partitionPower, 0, spectra * sizeof(float));
+    memset(aec->farPower, 0, (size_t)aec->stride * sizeof(float));
+    memset(aec->farHistory, 0, (size_t)aec->fftSize * sizeof(float));
+    aec->xHead = 0;
+    aec->constrainIndex = 0;
+
+    aec->nearEnergy = 0;
+    aec->errorEnergy = 0;
+    aec->shortNearEnergy = 0;
+    aec->shortEchoEnergy = 0;
+    aec->erleDb = 0;
+    aec->converged = 0;
+    aec->hangover = 0;
+    memset(&aec->stats, 0, sizeof(aec->stats));
+}
+
+void vc_aec_get_stats(const VCEchoCanceller *aec, VCEchoCancellerStats *outStats) {
+    *outStats = aec->stats;
+    outStats->erleDb = aec->erleDb;
+    outStats->converged = aec->converged;
+    outStats->doubleTalk = aec->hangover > 0;
+}
+
+#pragma mark - Processing
+
+/// 時間領域で後半 L タップを捨てる（巡回畳み込みの折り返しを防ぐ勾配拘束）
+/// 毎ブロック1パーティションずつ順番に行う（交互拘束 MDF）
+static void constrain_partition(VCEchoCanceller *aec, int p) {
+    float *re = slot(aec->weightRe, aec, p);
+    float *im = slot(aec->weightIm, aec, p);
+    vc_fft_inverse(aec->plan, re, im, aec->time);
+    memset(aec->time + aec->blockSize, 0, (size_t)aec->blockSize * sizeof(float));
+    vc_fft_forward(aec->plan, aec->time, re, im);
+}
+
+/// ステップ幅: 遠端無音とダブルトーク中は 0
+/// 収束後のマイク入力はほぼエコー推定そのものなので、それを大きく超えたら近端話者がいる（Geigel の周波数領域版）
+/// 残差側で判定すると経路変化まで止めて戻らなくなるため、マイクとエコー推定の比だけを見る
+static float step_size(VCEchoCanceller *aec, int farActive) {
+    if (!farActive) {
+        return 0;
+    }
+
+    if (aec->converged && aec->shortNearEnergy > kDoubleTalkFactor * aec->shortEchoEnergy + kPowerFloor) {
+        aec->hangover = kDoubleTalkHangover;
+    }
+    if (aec->hangover > 0) {
+        aec->hangover--;
+        aec->stats.doubleTalkBlocks++;
+        return 0;
+    }
+    return kStepSize;
+}
+
+void vc_aec_process(VCEchoCanceller *aec, const float *farEnd, const float *nearEnd, float *output) {
+    int L = aec->blockSize;
+    int P = aec->partitions;
+    int stride = aec->stride;
+
+    // 1. 遠端スペクトル X0 = FFT([前ブロック, 今ブロック])
+    memmove(aec->farHistory, aec->farHistory + L, (size_t)L * sizeof(float));
+    memcpy(aec->farHistory + L, farEnd, (size_t)L * sizeof(float));
+    aec->xHead = aec->xHead == 0 ? P - 1 : aec->xHead - 1;
+    float *x0Re = slot(aec->farRe, aec, aec->xHead);
+    float *x0Im = slot(aec->farIm, aec, aec->xHead);
+    vc_fft_forward(aec->plan, aec->farHistory, x0Re, x0Im);
+
+    // 最も古いパーティションのパワーを差し替えて総和を更新
+    float *x0Power = slot(aec->partitionPower, aec, aec->xHead);
+    vc_complex_power(x0Re, x0Im, aec->power, stride);
+    if (aec->xHead == 0) {
+        // 1周ごとに総和を取り直して丸め誤差の蓄積を防ぐ
+        memcpy(x0Power, aec->power, (size_t)stride * sizeof(float));
+        memset(aec->farPower, 0, (size_t)stride * sizeof(float));
+        for (int p = 0; p < P; p++) {
+            const float *partition = slot(aec->partitionPower, aec, p);
+            for (int k = 0; k < stride; k++) {
+                aec->farPower[k] += partition[k];
+            }
+        }
+    } else {
+        for (int k = 0; k < stride; k++) {
+            aec->farPower[k] = fmaxf(0.0f, aec->farPower[k] + aec->power[k] - x0Power[k]);
+            x0Power[k] = aec->power[k];
+        }
+    }
+
+    // 2. エコー推定 Y = Σ W[p] X[p]、y = IFFT(Y) の後半
+    memset(aec->echoRe, 0, (size_t)stride * sizeof(float));
+    memset(aec->echoIm, 0, (size_t)stride * sizeof(float));
+    for (int p = 0; p < P; p++) {
+        int x = aec->xHead + p;
+        if (x >= P) {
+            x -= P;
+        }
+        vc_complex_mac(aec->echoRe, aec->echoIm,
+                       slot(aec->weightRe, aec, p), slot(aec->weightIm, aec, p),
+                       slot(aec->farRe, aec, x), slot(aec->farIm, aec, x), stride);
+    }
+    vc_fft_inverse(aec->plan, aec->echoRe, aec->echoIm, aec->time);
+    const float *echo = aec->time + L;
+
+    // 3. 残差 e = d - y（time 前半を 0 にして E の入力に使う）
+    float farEnergy = energy(farEnd, L);
+    float nearEnergy = energy(nearEnd, L);
+    float echoEnergy = energy(echo, L);
+    float errorEnergy = 0;
+    float *error = aec->time + L;
+    for (int i = 0; i < L; i++) {
+        float e = nearEnd[i] - echo[i];
+        errorEnergy += e * e;
+        error[i] = e;
+    }
+    memset(aec->time, 0, (size_t)L * sizeof(float));
+
+    // 推定が入力より大きい（発散・経路変化直後）ならマイクをそのまま出す
+    if (errorEnergy > nearEnergy) {
+        memmove(output, nearEnd, (size_t)L * sizeof(float));
+        aec->stats.bypassedBlocks++;
+    } else {
+        memcpy(output, error, (size_t)L * sizeof(float));
+    }
+
+    // 4. ERLE 推定（遠端が鳴っている区間のみ）
+    int farActive = farEnergy >= kFarActiveLevel * (float)L;
+    float residual = fminf(errorEnergy, nearEnergy);
+    aec->shortNearEnergy += kShortSmoothing * (nearEnergy - aec->shortNearEnergy);
+    aec->shortEchoEnergy += kShortSmoothing * (echoEnergy - aec->shortEchoEnergy);
+    // ダブルトーク中は近端の声で ERLE を過小評価しないよう据え置く
+    if (farActive && aec->hangover == 0) {
+        aec->nearEnergy += kErleSmoothing * (nearEnergy - aec->nearEnergy);
+        aec->errorEnergy += kErleSmoothing * (residual - aec->errorEnergy);
+        aec->erleDb = 10.0f * vc_fast_log10f((aec->nearEnergy + kPowerFloor) / (aec->errorEnergy + kPowerFloor));
+        aec->converged = aec->erleDb > kConvergedErleDb;
+    }
+
+    // 5. 適応 W[p] += μ / Σ|X|^2 · conj(X[p]) · E
+    float mu = step_size(aec, farActive);
+    aec->stats.blocks++;
+    if (mu <= 0) {
+        return;
+    }
+
+    vc_fft_forward(aec->plan, aec->time, aec->errorRe, aec->errorIm);
+    float floor = kPowerFloor * (float)(aec->fftSize * L);
+    for (int k = 0; k < aec->bins; k++) {
+        float scale = mu / (aec->farPower[k] + floor);
+        aec->errorRe[k] *= scale;
+        aec->errorIm[k] *= scale;
+    }
+
+    for (int p = 0; p < P; p++) {
+        int x = aec->xHead + p;
+        if (x >= P) {
+            x -= P;
+        }
+        vc_complex_conj_mac(slot(aec->weightRe, aec, p), slot(aec->weightIm, aec, p),
+                            slot(aec->farRe, aec, x), slot(aec->farIm, aec, x),
+                            aec->errorRe, aec->errorIm, stride);
+    }
+
+    constrain_partition(aec, aec->constrainIndex);
+    aec->constrainIndex = aec->constrainIndex + 1 == P ? 0 : aec->constrainIndex + 1;
+}
@@ -0,0 +1,295 @@
+//
+//  VCFFT.c
+//  VoiceChanger
+//
+//  Portable real FFT (power-of-two sizes) and split-complex spectral kernels
+//
+
+#include "include/VCFFT.h"
+#include "VCSimd.h"
+#include "VCAlloc.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// 実数 FFT (size) は複素 FFT (size/2) と前後処理で計算する
+struct VCFFTPlan {
+    int size;
+    int half;               // 複素 FFT の長さ M = size / 2
+
+    int *bitReverse;        // [half]
+    float *stageRe;         // 段ごとの回転因子（段 h: e^{-iπj/h}, j < h を連結）
+    float *stageIm;
+    float *realRe;          // 実数化の回転因子 e^{-2πik/size}, k <= half
+    float *realIm;
+
+    float *workRe;          // [half]
+    float *workIm;
+};
+
+static int is_pow2(int value) {
+    return value > 0 && (value & (value - 1)) == 0;
+}
+
+static void *alloc_floats(int count) {
+    // SIMD 読み書きの境界を揃える
+    size_t bytes = ((size_t)count * sizeof(float) + 63) & ~(size_t)63;
+    return vc_aligned_alloc(64, bytes > 0 ? bytes : 64);
+}
+
+#pragma mark - Plan
+
+VCFFTPlan *vc_fft_plan_create(int size) {
+    if (!is_pow2(size) || size < VC_FFT_MIN_SIZE || size > VC_FFT_MAX_SIZE) {
+        return NULL;
+    }
+
+    VCFFTPlan *plan = vc_calloc(1, sizeof(VCFFTPlan));
+    if (plan == NULL) {
+        return NULL;
+    }
+
+    int half = size / 2;
+    plan->size = size;
+    plan->half = half;
+    plan->bitReverse = vc_malloc((size_t)half * sizeof(int));
+    plan->stageRe = alloc_floats(half);
+    plan->stageIm = alloc_floats(half);
+    plan->realRe = alloc_floats(half + 1);
+    plan->realIm = alloc_floats(half + 1);
+    plan->workRe = alloc_floats(half);
+    plan->workIm = alloc_floats(half);
+    if (plan->bitReverse == NULL || plan->stageRe == NULL || plan->stageIm == NULL ||
+        plan->realRe == NULL || plan->realIm == NULL || plan->workRe == NULL || plan->workIm == NULL) {
+        vc_fft_plan_destroy(plan);
+        return NULL;
+    }
+
+    int bits = 0;
+    while ((1 << bits) < half) {
+        bits++;
+    }
+    for (int i = 0; i < half; i++) {
+        int reversed = 0;
+        for (int b = 0; b < bits; b++) {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        plan->bitReverse[i] = reversed;
+    }
+
+    // 段 h (1, 2, 4, ...) の回転因子はオフセット h - 1 から h 個
+    for (int h = 1; h < half; h <<= 1) {
+        for (int j = 0; j < h; j++) {
+            double angle = -M_PI * j / h;
+            plan->stageRe[h - 1 + j] = (float)cos(angle);
+            plan->stageIm[h - 1 + j] = (float)sin(angle);
+        }
+    }
+
+    for (int k = 0; k <= half; k++) {
+        double angle = -2.0 * M_PI * k / size;
+        plan->realRe[k] = (float)cos(angle);
+        plan->realIm[k] = (float)sin(angle);
+    }
+
+    return plan;
+}
+
+void vc_fft_plan_destroy(VCFFTPlan *plan) {
+    if (plan == NULL) {
+        return;
+    }
+    vc_free(plan->bitReverse);
+    vc_free(plan->stageRe);
+    vc_free(plan->stageIm);
+    vc_free(plan->realRe);
+    vc_free(plan->realIm);
+    vc_free(plan->workRe);
+    vc_free(plan->workIm);
+    vc_free(plan);
+}
+
+int vc_fft_plan_size(const VCFFTPlan *plan) {
+    return plan->size;
+}
+
+#pragma mark - Complex FFT
+
+/// ビット反転順に並べた re/im に対する radix-2 DIT（インプレース、順方向）
+/// 逆方向は re と im を入れ替えて呼ぶ（conj(FFT(conj(z))) と同値）
+static void complex_fft(const VCFFTPlan *plan, float *re, float *im) {
+    int n = plan->half;
+
+    // 最初の2段（h = 1, 2）はまとめて radix-4 で
+    for (int i = 0; i < n; i += 4) {
+        float r0 = re[i] + re[i + 1], i0 = im[i] + im[i + 1];
+        float r1 = re[i] - re[i + 1], i1 = im[i] - im[i + 1];
+        float r2 = re[i + 2] + re[i + 3], i2 = im[i + 2] + im[i + 3];
+        float r3 = re[i + 2] - re[i + 3], i3 = im[i + 2] - im[i + 3];
+
+        re[i] = r0 + r2;
+        im[i] = i0 + i2;
+        re[i + 2] = r0 - r2;
+        im[i + 2] = i0 - i2;
+        // (r3 + i i3) * (-i) = i3 - i r3
+        re[i + 1] = r1 + i3;
+        im[i + 1] = i1 - r3;
+        re[i + 3] = r1 - i3;
+        im[i + 3] = i1 + r3;
+    }
+
+    for (int h = 4; h < n; h <<= 1) {
+        const float *wRe = plan->stageRe + h - 1;
+        const float *wIm = plan->stageIm + h - 1;
+        for (int base = 0; base < n; base += 2 * h) {
+            float *aRe = re + base;
+            float *aIm = im + base;
+            float *bRe = aRe + h;
+            float *bIm = aIm + h;
+            int j = 0;
+#if VC_HAS_VECTOR_EXT
+            for (; j + 4 <= h; j += 4) {
+                vc_f32x4 wr = vc_load4(wRe + j), wi = vc_load4(wIm + j);
+                vc_f32x4 br = vc_load4(bRe + j), bi = vc_load4(bIm + j);
+                vc_f32x4 tr = br * wr - bi * wi;
+                vc_f32x4 ti = br * wi + bi * wr;
+                vc_f32x4 ar = vc_load4(aRe + j), ai = vc_load4(aIm + j);
+                vc_store4(aRe + j, ar + tr);
+                vc_store4(aIm + j, ai + ti);
+                vc_store4(bRe + j, ar - tr);
+                vc_store4(bIm + j, ai - ti);
+            }
+#endif
+            for (; j < h; j++) {
+                float tr = bRe[j] * wRe[j] - bIm[j] * wIm[j];
+                float ti = bRe[j] * wIm[j] + bIm[j] * wRe[j];
+                bRe[j] = aRe[j] - tr;
+                bIm[j] = aIm[j] - ti;
+                aRe[j] += tr;
+                aIm[j] += ti;
+            }
+        }
+    }
+}
+
+#pragma mark - Real FFT
+
+void vc_fft_forward(VCFFTPlan *plan, const float *input, float *outRe, float *outIm) {
+    int half = plan->half;
+    float *zRe = plan->workRe;
+    float *zIm = plan->workIm;
+
+    // z[n] = x[2n] + i x[2n+1] をビット反転順に詰める
+    for (int n = 0; n < half; n++) {
+        int dst = plan->bitReverse[n];
+        zRe[dst] = input[2 * n];
+        zIm[dst] = input[2 * n + 1];
+    }
+    complex_fft(plan, zRe, zIm);
+
+    // X[k] = Fe[k] + W^k Fo[k]
+    //   Fe = (Z[k] + conj Z[M-k]) / 2, Fo = (Z[k] - conj Z[M-k]) / 2i
+    outRe[0] = zRe[0] + zIm[0];
+    outIm[0] = 0;
+    outRe[half] = zRe[0] - zIm[0];
+    outIm[half] = 0;
+    for (int k = 1; k < half; k++) {
+        float ar = zRe[k], ai = zIm[k];
+        float br = zRe[half - k], bi = -zIm[half - k];
+        float feRe = 0.5f * (ar + br);
+        float feIm = 0.5f * (ai + bi);
+        // (a - b) / 2i = (ai - bi) / 2 - i (ar - br) / 2
+        float foRe = 0.5f * (ai - bi);
+        float foIm = -0.5f * (ar - br);
+        float wr = plan->realRe[k], wi = plan->realIm[k];
+        outRe[k] = feRe + foRe * wr - foIm * wi;
+        outIm[k] = feIm + foRe * wi + foIm * wr;
+    }
+}
+
+void vc_fft_inverse(VCFFTPlan *plan, const float *re, const float *im, float *output) {
+    int half = plan->half;
+    float *zRe = plan->workRe;
+    float *zIm = plan->workIm;
+
+    // Z[k] = Fe[k] + i Fo[k]
+    //   Fe = (X[k] + conj X[M-k]) / 2, Fo = (X[k] - conj X[M-k]) conj(W^k) / 2
+    for (int k = 0; k < half; k++) {
+        float ar = re[k], ai = k == 0 ? 0 : im[k];
+        float br = re[half - k], bi = k == 0 ? 0 : -im[half - k];
+        float feRe = 0.5f * (ar + br);
+        float feIm = 0.5f * (ai + bi);
+        float dRe = 0.5f * (ar - br);
+        float dIm = 0.5f * (ai - bi);
+        float wr = plan->realRe[k], wi = -plan->realIm[k];
+        float foRe = dRe * wr - dIm * wi;
+        float foIm = dRe * wi + dIm * wr;
+
+        // 逆変換は re / im を入れ替えた順変換で行うので、入れ替えて格納する
+        int dst = plan->bitReverse[k];
+        zIm[dst] = feRe - foIm;
+        zRe[dst] = feIm + foRe;
+    }
+    complex_fft(plan, zRe, zIm);
+
+    float scale = 1.0f / (float)half;
+    for (int n = 0; n < half; n++) {
+        output[2 * n] = zIm[n] * scale;
+        output[2 * n + 1] = zRe[n] * scale;
+    }
+}
+
+#pragma mark - Spectral Kernels
+
+void vc_complex_mac(float *accRe, float *accIm,
+                    const float *aRe, const float *aIm,
+                    const float *bRe, const float *bIm, int count) {
+    int k = 0;
+#if VC_HAS_VECTOR_EXT
+    for (; k + 4 <= count; k += 4) {
+        vc_f32x4 ar = vc_load4(aRe + k), ai = vc_load4(aIm + k);
+        vc_f32x4 br = vc_load4(bRe + k), bi = vc_load4(bIm + k);
+        vc_store4(accRe + k, vc_load4(accRe + k) + ar * br - ai * bi);
+        vc_store4(accIm + k, vc_load4(accIm + k) + ar * bi + ai * br);
+    }
+#endif
+    for (; k < count; k++) {
+        accRe[k] += aRe[k] * bRe[k] - aIm[k] * bIm[k];
+        accIm[k] += aRe[k] * bIm[k] + aIm[k] * bRe[k];
+    }
+}
+
+void vc_complex_conj_mac(float *accRe, float *accIm,
+                         const float *aRe, const float *aIm,
+                         const float *bRe, const float *bIm, int count) {
+    int k = 0;
+#if VC_HAS_VECTOR_EXT
+    for (; k + 4 <= count; k += 4) {
+        vc_f32x4 ar = vc_load4(aRe + k), ai = vc_load4(aIm + k);
+        vc_f32x4 br = vc_load4(bRe + k), bi = vc_load4(bIm + k);
+        vc_store4(accRe + k, vc_load4(accRe + k) + ar * br + ai * bi);
+        vc_store4(accIm + k, vc_load4(accIm + k) + ar * bi - ai * br);
+    }
+#endif
+    for (; k < count; k++) {
+        accRe[k] += aRe[k] * bRe[k] + aIm[k] * bIm[k];
+        accIm[k] += aRe[k] * bIm[k] - aIm[k] * bRe[k];
+    }
+}
+
+void vc_complex_power(const float *re, const float *im, float *outPower, int count) {
+    int k = 0;
+#if VC_HAS_VECTOR_EXT
+    for (; k + 4 <= count; k += 4) {
+        vc_f32x4 r = vc_load4(re + k), i = vc_load4(im + k);
+        vc_store4(outPower + k, r * r + i * i);
+    }
+#endif
+    for (; k < count; k++) {
+        outPower[k] = re[k] * re[k] + im[k] * im[k];
+    }
+}
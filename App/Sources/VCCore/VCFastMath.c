@@ -0,0 +1,114 @@
+//
+//  VCFastMath.c
+//  VoiceChanger
+//
+//  Block kernels for the fast-math approximations (4 lanes per step, scalar tail)
+//
+
+#include "include/VCFastMath.h"
+#include "VCSimd.h"
+
+#pragma mark - Exponential & Logarithm
+
+void vc_fast_exp(const float *input, float *output, int count) {
+    int i = 0;
+#if VC_HAS_VECTOR_EXT
+    for (; i + 4 <= count; i += 4) {
+        vc_store4(output + i, vc_exp4(vc_load4(input + i)));
+    }
+#endif
+    for (; i < count; i++) {
+        output[i] = vc_fast_expf(input[i]);
+    }
+}
+
+void vc_fast_log(const float *input, float *output, int count) {
+    int i = 0;
+#if VC_HAS_VECTOR_EXT
+    for (; i + 4 <= count; i += 4) {
+        vc_store4(output + i, vc_log4(vc_load4(input + i)));
+    }
+#endif
+    for (; i < count; i++) {
+        output[i] = vc_fast_logf(input[i]);
+    }
+}
+
+void vc_fast_pow(const float *base, const float *exponent, float *output, int count) {
+    int i = 0;
+#if VC_HAS_VECTOR_EXT
+    for (; i + 4 <= count; i += 4) {
+        vc_store4(output + i, vc_exp4(vc_load4(exponent + i) * vc_log4(vc_load4(base + i))));
+    }
+#endif
+    for (; i < count; i++) {
+        output[i] = vc_fast_powf(base[i], exponent[i]);
+    }
+}
+
+#pragma mark - Decibels
+
+void vc_fast_db_to_linear_block(const float *input, float *output, int count) {
+    int i = 0;
+#if VC_HAS_VECTOR_EXT
+    for (; i + 4 <= count; i += 4) {
+        vc_store4(output + i, vc_exp4(vc_load4(input + i) * vc_splat4(0.115129255f)));
+    }
+#endif
+    for (; i < count; i++) {
+        output[i] = vc_fast_db_to_linear(input[i]);
+    }
+}
+
+void vc_fast_linear_to_db_block(const float *input, float *output, int count) {
+    int i = 0;
+#if VC_HAS_VECTOR_EXT
+    for (; i + 4 <= count; i += 4) {
+        vc_store4(output + i, vc_log4(vc_load4(input + i)) * vc_splat4(8.68588964f));
+    }
+#endif
+    for (; i < count; i++) {
+        output[i] = vc_fast_linear_to_db(input[i]);
+    }
+}
+
+#pragma mark - Hyperbolic & Trigonometric
+
+void vc_fast_tanh(const float *input, float *output, int count) {
+    int i = 0;
+#if VC_HAS_VECTOR_EXT
+    for (; i + 4 <= count; i += 4) {
+        vc_store4(output + i, vc_tanh4(vc_load4(input + i)));
+    }
+#endif
+    for (; i < count; i++) {
+        output[i] = vc_fast_tanhf(input[i]);
+    }
+}
+
+void vc_fast_sincos(const float *input, float *outSin, float *outCos, int count) {
+    int i = 0;
+#if VC_HAS_VECTOR_EXT
+    for (; i + 4 <= count; i += 4) {
+        vc_f32x4 s, c;
+        vc_sincos4(vc_load4(input + i), &s, &c);
+        vc_store4(outSin + i, s);
+        vc_store4(outCos + i, c);
+    }
+#endif
+    for (; i < count; i++) {
+        vc_fast_sincosf(input[i], &outSin[i], &outCos[i]);
+    }
+}
+
+void vc_fast_atan2(const float *y, const float *x, float *output, int count) {
+    int i = 0;
+#if VC_HAS_VECTOR_EXT
+    for (; i + 4 <= count; i += 4) {
+        vc_store4(output + i, vc_atan24(vc_load4(y + i), vc_load4(x + i)));
+    }
+#endif
+    for (; i < count; i++) {
+        output[i] = vc_fast_atan2f(y[i], x[i]);
+    }
+}
@@ -0,0 +1,895 @@
+//
+//  VCGraph.c
+//  VoiceChanger
+//
+//  DSP graph defined by presets: topological schedule, liveness-based buffer reuse, parallel branches
+//
+
+#include "include/VCGraph.h"
+#include "include/VCBiquad.h"
+#include "include/VCDynamics.h"
+#include "include/VCMultiband.h"
+#include "include/VCOversampler.h"
+#include "include/VCPitch.h"
+#include "include/VCSignalGuard.h"
+#include "include/VCVad.h"
+#include "VCAlloc.h"
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define kHpfQ           0.707f  // Butterworth Q
+#define kEqLowFreq      200.0f  // VCChain と同じ帯域
+#define kEqMidFreq      1000.0f
+#define kEqHighFreq     4000.0f
+#define kWorkerSpins    2000    // 補助スレッドが眠る前に次の段を待つ回数（ブロック内の段の間は眠らない）
+#define kBufferAlign    64
+
+typedef struct {
+    VCGraphNodeDesc desc;
+    int scheduled;
+    int buffer;         // 作業バッファの番号
+    int task;
+    int position;       // 生存区間の単位（直列ではスケジュール上の位置、並行ではタスクの段）
+    int lastUse;        // 音を読む最後のノードの position
+    int audioConsumers; // 音を読むノードの数（重複なし）
+    int consumers;      // sidechain を含めた数
+    float latency;      // INPUT からの最長経路の遅延
+
+    // 種類ごとの状態
+    VCBiquadCoeffs coeffs[3];   // HPF は [0]、EQ は 3 帯域
+    VCBiquadState state[3];
+    VCVad *vad;
+    int speech;
+    float activityStart;        // 前ブロック末尾の activity（ブロック内で補間する）
+    float activityEnd;
+    VCNoiseGate gate;
+    float *scratch;
+    VCAgc agc;
+    VCPitchShifter *shifter;
+    VCMultiband *multiband;
+    VCConvolver *convolver;     // 外部所有
+    VCLimiter limiter;
+    VCOversampler *oversampler; // 倍率 1 なら NULL
+} GraphNode;
+
+/// 分岐も合流もないノードの連なり（schedule[first] から count 個）
+typedef struct {
+    int first;
+    int count;
+    int level;
+} GraphTask;
+
+struct VCGraph {
+    float sampleRate;
+    GraphNode *nodes;
+    int nodeCount;
+    int outputNode;
+
+    int *schedule;
+    int scheduleCount;
+    GraphTask *tasks;           // 段の順
+    int taskCount;
+    int *levelStart;            // 段 l のタスクは tasks[levelStart[l] ..< levelStart[l + 1]]
+    int levelCount;
+    int maxParallel;
+
+    float *buffers;
+    int bufferCount;
+
+    // ブロックごと（処理スレッドが書き、dispatch の公開で補助スレッドに見せる）
+    const float *blockInput;
+    float *blockOutput;
+    int blockFrames;
+    int convolve;
+
+    // 補助スレッド
+    pthread_t *threads;
+    int workerCount;
+    _Atomic uint64_t dispatch;  // 上位 32bit = 世代、次の 16bit = 次に取るタスク、下位 16bit = 段の終わり
+    atomic_int pending;         // 段の未完了タスク数
+    atomic_int sleeping;
+    atomic_int stopping;
+    uint32_t generation;
+    pthread_mutex_t sleepLock;
+    pthread_cond_t wakeCond;
+};
+
+static float clampf(float value, float lo, float hi) {
+    return fmaxf(lo, fminf(hi, value));
+}
+
+#pragma mark - Description
+
+void vc_graph_node_init(VCGraphNodeDesc *node, VCGraphNodeKind kind) {
+    memset(node, 0, sizeof(*node));
+    node->kind = kind;
+    node->sidechain = -1;
+    for (int i = 0; i < VC_GRAPH_MAX_INPUTS; i++) {
+        node->gains[i] = 1.0f;
+    }
+    switch (kind) {
+    case VC_GRAPH_NODE_HPF:
+        node->param[0] = 80.0f;
+        break;
+    case VC_GRAPH_NODE_GATE:
+        node->param[0] = 0.5f;
+        break;
+    case VC_GRAPH_NODE_AGC:
+        node->param[0] = -18.0f;
+        break;
+    case VC_GRAPH_NODE_MULTIBAND:
+        node->param[0] = -24.0f;
+        node->param[1] = 2.5f;
+        node->param[2] = -30.0f;
+        node->param[3] = 4.0f;
+        break;
+    case VC_GRAPH_NODE_LIMITER:
+        node->param[0] = 1.0f;
+        break;
+    default:
+        break;
+    }
+}
+
+static int expected_inputs_ok(VCGraphNodeKind kind, int count) {
+    switch (kind) {
+    case VC_GRAPH_NODE_INPUT:
+        return count == 0;
+    case VC_GRAPH_NODE_MIX:
+        return count >= 1 && count <= VC_GRAPH_MAX_INPUTS;
+    default:
+        return count == 1;
+    }
+}
+
+/// 種類・入力・sidechain の検査と INPUT / OUTPUT の数
+static VCGraphError validate(const VCGraphNodeDesc *nodes, int count, int *outOutput) {
+    if (count <= 0 || count > VC_GRAPH_MAX_NODES) {
+        return VC_GRAPH_ERROR_INVALID;
+    }
+    int inputs = 0;
+    int outputs = 0;
+    for (int n = 0; n < count; n++) {
+        const VCGraphNodeDesc *node = &nodes[n];
+        if ((int)node->kind < 0 || node->kind >= VC_GRAPH_NODE_KIND_COUNT ||
+            !expected_inputs_ok(node->kind, node->inputCount)) {
+            return VC_GRAPH_ERROR_INVALID;
+        }
+        for (int i = 0; i < node->inputCount; i++) {
+            if (node->inputs[i] < 0 || node->inputs[i] >= count || node->inputs[i] == n) {
+                return VC_GRAPH_ERROR_INVALID;
+            }
+        }
+        if (node->sidechain != -1) {
+            int follows = node->kind == VC_GRAPH_NODE_GATE || node->kind == VC_GRAPH_NODE_AGC;
+            if (!follows || node->sidechain < 0 || node->sidechain >= count ||
+                nodes[node->sidechain].kind != VC_GRAPH_NODE_VAD) {
+                return VC_GRAPH_ERROR_INVALID;
+            }
+        }
+        inputs += node->kind == VC_GRAPH_NODE_INPUT;
+        if (node->kind == VC_GRAPH_NODE_OUTPUT) {
+            outputs++;
+            *outOutput = n;
+        }
+    }
+    return inputs == 1 && outputs == 1 ? VC_GRAPH_OK : VC_GRAPH_ERROR_ENDPOINTS;
+}
+
+#pragma mark - Scheduling
+
+/// 依存先（入力と sidechain、重複なし）
+static int dependencies(const VCGraphNodeDesc *node, int out[VC_GRAPH_MAX_INPUTS + 1]) {
+    int count = 0;
+    for (int i = 0; i <= node->inputCount; i++) {
+        int dep = i < node->inputCount ? node->inputs[i] : node->sidechain;
+        if (dep < 0) {
+            continue;
+        }
+        int seen = 0;
+        for (int k = 0; k < count; k++) {
+            seen |= out[k] == dep;
+        }
+        if (!seen) {
+            out[count++] = dep;
+        }
+    }
+    return count;
+}
+
+static int reads_audio(const VCGraphNodeDesc *node, int from) {
+    for (int i = 0; i < node->inputCount; i++) {
+        if (node->inputs[i] == from) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/// OUTPUT に届くノードに印を付け、Kahn 法で並べる（同時に取れるものは番号の小さい順）
+static VCGraphError topological_order(VCGraph *graph, int *order, int *outCount) {
+    GraphNode *nodes = graph->nodes;
+    int n = graph->nodeCount;
+    int deps[VC_GRAPH_MAX_INPUTS + 1];
+
+    int stack[VC_GRAPH_MAX_NODES];
+    int depth = 0;
+    nodes[graph->outputNode].scheduled = 1;
+    stack[depth++] = graph->outputNode;
+    while (depth > 0) {
+        int node = stack[--depth];
+        int count = dependencies(&nodes[node].desc, deps);
+        for (int k = 0; k < count; k++) {
+            if (!nodes[deps[k]].scheduled) {
+                nodes[deps[k]].scheduled = 1;
+                stack[depth++] = deps[k];
+            }
+        }
+    }
+
+    int indegree[VC_GRAPH_MAX_NODES] = { 0 };
+    int live = 0;
+    for (int node = 0; node < n; node++) {
+        if (!nodes[node].scheduled) {
+            continue;
+        }
+        live++;
+        int count = dependencies(&nodes[node].desc, deps);
+        indegree[node] = count;
+        for (int k = 0; k < count; k++) {
+            nodes[deps[k]].consumers++;
+            nodes[deps[k]].audioConsumers += reads_audio(&nodes[node].desc, deps[k]);
+        }
+    }
+
+    int placed = 0;
+    int done[VC_GRAPH_MAX_NODES] = { 0 };
+    while (placed < live) {
+        int next = -1;
+        for (int node = 0; node < n && next < 0; node++) {
+            if (nodes[node].scheduled && !done[node] && indegree[node] == 0) {
+                next = node;
+            }
+        }
+        if (next < 0) {
+            return VC_GRAPH_ERROR_CYCLE;
+        }
+        done[next] = 1;
+        order[placed++] = next;
+        for (int node = 0; node < n; node++) {
+            if (!nodes[node].scheduled || done[node]) {
+                continue;
+            }
+            int count = dependencies(&nodes[node].desc, deps);
+            for (int k = 0; k < count; k++) {
+                indegree[node] -= deps[k] == next;
+            }
+        }
+    }
+    *outCount = live;
+    return VC_GRAPH_OK;
+}
+
+/// 連なりをタスクにまとめ、段の順に並べ直して schedule を作る
+static VCGraphError build_tasks(VCGraph *graph, const int *order, int count) {
+    GraphNode *nodes = graph->nodes;
+    int deps[VC_GRAPH_MAX_INPUTS + 1];
+    int chainNext[VC_GRAPH_MAX_NODES];
+    int taskHead[VC_GRAPH_MAX_NODES];
+    int taskLevel[VC_GRAPH_MAX_NODES];
+    int tasks = 0;
+
+    for (int i = 0; i < count; i++) {
+        int node = order[i];
+        chainNext[node] = -1;
+        int depCount = dependencies(&nodes[node].desc, deps);
+        // 唯一の依存先の、唯一の読み手なら同じタスクに続ける
+        if (depCount == 1 && nodes[deps[0]].consumers == 1) {
+            int previous = deps[0];
+            nodes[node].task = nodes[previous].task;
+            chainNext[previous] = node;
+            continue;
+        }
+        int level = 0;
+        for (int k = 0; k < depCount; k++) {
+            int depLevel = taskLevel[nodes[deps[k]].task] + 1;
+            level = depLevel > level ? depLevel : level;
+        }
+        nodes[node].task = tasks;
+        taskHead[tasks] = node;
+        taskLevel[tasks] = level;
+        tasks++;
+    }
+
+    graph->tasks = vc_calloc((size_t)tasks, sizeof(GraphTask));
+    graph->schedule = vc_calloc((size_t)count, sizeof(int));
+    graph->levelStart = vc_calloc((size_t)tasks + 1, sizeof(int));
+    if (graph->tasks == NULL || graph->schedule == NULL || graph->levelStart == NULL) {
+        return VC_GRAPH_ERROR_MEMORY;
+    }
+
+    // 段の順（同じ段は作った順）に並べる
+    int placed = 0;
+    int levels = 0;
+    for (int level = 0; placed < count; level++) {
+        graph->levelStart[levels] = graph->taskCount;
+        int any = 0;
+        for (int t = 0; t < tasks; t++) {
+            if (taskLevel[t] != level) {
+                continue;
+            }
+            GraphTask *task = &graph->tasks[graph->taskCount++];
+            task->first = placed;
+            task->level = levels;
+            for (int node = taskHead[t]; node >= 0; node = chainNext[node]) {
+                nodes[node].task = (int)(task - graph->tasks);
+                graph->schedule[placed++] = node;
+                task->count++;
+            }
+            any = 1;
+        }
+        if (any) {
+            int width = graph->taskCount - graph->levelStart[levels];
+            graph->maxParallel = width > graph->maxParallel ? width : graph->maxParallel;
+            levels++;
+        }
+    }
+    graph->levelStart[levels] = graph->taskCount;
+    graph->levelCount = levels;
+    graph->scheduleCount = count;
+    return VC_GRAPH_OK;
+}
+
+/// 1 入力で入力のバッファへ上書きできる種類（INPUT 以外すべて。MIX は 1 つ目の入力）
+static int can_overwrite_input(const VCGraphNodeDesc *node) {
+    if (node->kind == VC_GRAPH_NODE_INPUT) {
+        return 0;
+    }
+    for (int i = 1; i < node->inputCount; i++) {
+        if (node->inputs[i] == node->inputs[0]) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/// 生存区間による作業バッファの割り当て
+static VCGraphError assign_buffers(VCGraph *graph, int naive, int parallel) {
+    GraphNode *nodes = graph->nodes;
+    for (int i = 0; i < graph->scheduleCount; i++) {
+        GraphNode *node = &nodes[graph->schedule[i]];
+        node->position = parallel ? graph->tasks[node->task].level : i;
+        node->lastUse = node->position;
+    }
+    for (int i = 0; i < graph->scheduleCount; i++) {
+        GraphNode *node = &nodes[graph->schedule[i]];
+        for (int k = 0; k < node->desc.inputCount; k++) {
+            GraphNode *input = &nodes[node->desc.inputs[k]];
+            input->lastUse = node->position > input->lastUse ? node->position : input->lastUse;
+        }
+    }
+
+    int busyUntil[VC_GRAPH_MAX_NODES];
+    int buffers = 0;
+    for (int i = 0; i < graph->scheduleCount; i++) {
+        GraphNode *node = &nodes[graph->schedule[i]];
+        if (naive) {
+            node->buffer = buffers++;
+            continue;
+        }
+
+        if (can_overwrite_input(&node->desc)) {
+            GraphNode *input = &nodes[node->desc.inputs[0]];
+            // 直列: この読み手が最後。並行: 読み手がこれだけ（同じ段の別タスクが読んでいない）
+            int last = parallel ? input->audioConsumers == 1 : input->lastUse == node->position;
+            if (last) {
+                node->buffer = input->buffer;
+                busyUntil[node->buffer] = node->lastUse;
+                continue;
+            }
+        }
+
+        node->buffer = -1;
+        for (int b = 0; b < buffers && node->buffer < 0; b++) {
+            if (busyUntil[b] < node->position) {
+                node->buffer = b;
+            }
+        }
+        if (node->buffer < 0) {
+            node->buffer = buffers++;
+        }
+        busyUntil[node->buffer] = node->lastUse;
+    }
+
+    graph->bufferCount = buffers;
+    graph->buffers = vc_aligned_alloc(kBufferAlign, (size_t)buffers * VC_MAX_FRAME_SIZE * sizeof(float));
+    if (graph->buffers == NULL) {
+        return VC_GRAPH_ERROR_MEMORY;
+    }
+    memset(graph->buffers, 0, (size_t)buffers * VC_MAX_FRAME_SIZE * sizeof(float));
+    return VC_GRAPH_OK;
+}
+
+#pragma mark - Node State
+
+static int create_state(VCGraph *graph, GraphNode *node) {
+    const float *param = node->desc.param;
+    float sr = graph->sampleRate;
+    switch (node->desc.kind) {
+    case VC_GRAPH_NODE_HPF:
+        vc_biquad_set_highpass(&node->coeffs[0], clampf(param[0], 10.0f, 0.45f * sr), kHpfQ, sr);
+        break;
+    case VC_GRAPH_NODE_VAD:
+        node->vad = vc_vad_create((int)sr);
+        node->activityEnd = 1.0f;
+        node->speech = 1;
+        return node->vad != NULL ? 0 : -1;
+    case VC_GRAPH_NODE_GATE:
+        vc_noise_gate_init(&node->gate);
+        vc_noise_gate_set_strength(&node->gate, param[0]);
+        node->scratch = vc_calloc(VC_MAX_FRAME_SIZE, sizeof(float));
+        return node->scratch != NULL ? 0 : -1;
+    case VC_GRAPH_NODE_AGC:
+        vc_agc_init(&node->agc);
+        vc_agc_set_target(&node->agc, param[0]);
+        break;
+    case VC_GRAPH_NODE_PITCH_SHIFT:
+        node->shifter = vc_pitch_shifter_create((int)sr, VC_PITCH_SHIFTER_DEFAULT_WINDOW_MS);
+        if (node->shifter == NULL) {
+            return -1;
+        }
+        vc_pitch_shifter_set_semitones(node->shifter, param[0]);
+        node->latency = vc_pitch_shifter_latency(node->shifter);
+        break;
+    case VC_GRAPH_NODE_MULTIBAND: {
+        node->multiband = vc_multiband_create((int)sr);
+        if (node->multiband == NULL) {
+            return -1;
+        }
+        VCMultibandParams bands;
+        vc_multiband_get_params(node->multiband, &bands);
+        for (int band = 0; band < VC_MULTIBAND_BANDS; band++) {
+            int sibilance = band == VC_MULTIBAND_SIBILANCE_BAND;
+            bands.thresholdDb[band] = clampf(sibilance ? param[2] : param[0], -60, 0);
+            bands.ratio[band] = clampf(sibilance ? param[3] : param[1], 1, 20);
+        }
+        vc_multiband_set_params(node->multiband, &bands);
+        break;
+    }
+    case VC_GRAPH_NODE_EQ:
+        vc_biquad_set_lowshelf(&node->coeffs[0], kEqLowFreq, clampf(param[0], -12, 12), sr);
+        vc_biquad_set_peaking(&node->coeffs[1], kEqMidFreq, clampf(param[1], -12, 12), 1.0f, sr);
+        vc_biquad_set_highshelf(&node->coeffs[2], kEqHighFreq, clampf(param[2], -12, 12), sr);
+        break;
+    case VC_GRAPH_NODE_LIMITER: {
+        vc_limiter_init(&node->limiter);
+        int factor = param[0] >= 4 ? 4 : param[0] >= 2 ? 2 : 1;
+        if (factor > 1) {
+            node->oversampler = vc_oversampler_create(factor, VC_MAX_FRAME_SIZE);
+            if (node->oversampler == NULL) {
+                return -1;
+            }
+            vc_limiter_set_oversampling(&node->limiter, factor);
+            node->latency = vc_oversampler_latency(node->oversampler);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return 0;
+}
+
+static void destroy_state(GraphNode *node) {
+    vc_vad_destroy(node->vad);
+    vc_free(node->scratch);
+    vc_pitch_shifter_destroy(node->shifter);
+    vc_multiband_destroy(node->multiband);
+    vc_oversampler_destroy(node->oversampler);
+}
+
+#pragma mark - Processing
+
+static inline float *node_buffer(const VCGraph *graph, const GraphNode *node) {
+    return graph->buffers + (size_t)node->buffer * VC_MAX_FRAME_SIZE;
+}
+
+static inline void copy_if_needed(float *out, const float *in, int frames) {
+    if (out != in) {
+        memcpy(out, in, (size_t)frames * sizeof(float));
+    }
+}
+
+static void run_node(VCGraph *graph, GraphNode *node) {
+    const VCGraphNodeDesc *desc = &node->desc;
+    int frames = graph->blockFrames;
+    float *out = node_buffer(graph, node);
+    const float *in = desc->inputCount > 0 ? node_buffer(graph, &graph->nodes[desc->inputs[0]]) : NULL;
+    const GraphNode *vad = desc->sidechain >= 0 ? &graph->nodes[desc->sidechain] : NULL;
+
+    switch (desc->kind) {
+    case VC_GRAPH_NODE_INPUT:
+        memcpy(out, graph->blockInput, (size_t)frames * sizeof(float));
+        break;
+    case VC_GRAPH_NODE_OUTPUT:
+        memcpy(graph->blockOutput, in, (size_t)frames * sizeof(float));
+        break;
+    case VC_GRAPH_NODE_HPF:
+        vc_biquad_process(&node->coeffs[0], &node->state[0], in, out, frames);
+        break;
+    case VC_GRAPH_NODE_VAD:
+        node->speech = vc_vad_process(node->vad, in, frames);
+        node->activityStart = node->activityEnd;
+        node->activityEnd = vc_vad_activity(node->vad);
+        copy_if_needed(out, in, frames);
+        break;
+    case VC_GRAPH_NODE_GATE:
+        copy_if_needed(out, in, frames);
+        if (vad != NULL) {
+            vc_noise_gate_process_with_activity(&node->gate, out, node->scratch, frames, vad->activityStart,
+                                                vad->activityEnd);
+        } else {
+            vc_noise_gate_process(&node->gate, out, frames);
+        }
+        break;
+    case VC_GRAPH_NODE_AGC:
+        copy_if_needed(out, in, frames);
+        vc_agc_set_voice_activity(&node->agc, vad != NULL ? vad->speech : 1);
+        vc_agc_process(&node->agc, out, frames);
+        break;
+    case VC_GRAPH_NODE_PITCH_SHIFT:
+        vc_pitch_shifter_process(node->shifter, in, out, frames);
+        break;
+    case VC_GRAPH_NODE_MULTIBAND:
+        copy_if_needed(out, in, frames);
+        vc_multiband_process(node->multiband, out, frames);
+        break;
+    case VC_GRAPH_NODE_EQ:
+        vc_biquad_process(&node->coeffs[0], &node->state[0], in, out, frames);
+        vc_biquad_process(&node->coeffs[1], &node->state[1], out, out, frames);
+        vc_biquad_process(&node->coeffs[2], &node->state[2], out, out, frames);
+        break;
+    case VC_GRAPH_NODE_CONVOLVER:
+        if (node->convolver == NULL || !graph->convolve) {
+            copy_if_needed(out, in, frames);
+        } else {
+            vc_convolver_process(node->convolver, in, out, frames);
+        }
+        break;
+    case VC_GRAPH_NODE_LIMITER:
+        copy_if_needed(out, in, frames);
+        if (node->oversampler == NULL) {
+            vc_limiter_process(&node->limiter, out, frames);
+        } else {
+            int factor = vc_oversampler_factor(node->oversampler);
+            float *upsampled = vc_oversampler_upsample(node->oversampler, out, frames);
+            vc_limiter_process(&node->limiter, upsampled, frames * factor);
+            vc_oversampler_downsample(node->oversampler, out, frames);
+        }
+        break;
+    case VC_GRAPH_NODE_MIX: {
+        // 1 つ目の入力は out と同じバッファのことがある（先に掛けてから残りを足す）
+        float gain = desc->gains[0];
+        for (int i = 0; i < frames; i++) {
+            out[i] = gain * in[i];
+        }
+        for (int k = 1; k < desc->inputCount; k++) {
+            const float *other = node_buffer(graph, &graph->nodes[desc->inputs[k]]);
+            gain = desc->gains[k];
+            for (int i = 0; i < frames; i++) {
+                out[i] += gain * other[i];
+            }
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+static void run_task(VCGraph *graph, const GraphTask *task) {
+    for (int i = 0; i < task->count; i++) {
+        run_node(graph, &graph->nodes[graph->schedule[task->first + i]]);
+    }
+}
+
+/// 世代 generation の段からタスクを取れるだけ取って実行する
+static void claim_tasks(VCGraph *graph, uint32_t generation) {
+    uint64_t dispatch = atomic_load_explicit(&graph->dispatch, memory_order_acquire);
+    for (;;) {
+        uint32_t next = (uint32_t)(dispatch >> 16) & 0xffff;
+        uint32_t end = (uint32_t)dispatch & 0xffff;
+        if ((uint32_t)(dispatch >> 32) != generation || next >= end) {
+            return;
+        }
+        if (atomic_compare_exchange_weak_explicit(&graph->dispatch, &dispatch, dispatch + (1u << 16),
+                                                  memory_order_acq_rel, memory_order_acquire)) {
+            run_task(graph, &graph->tasks[next]);
+            atomic_fetch_sub_explicit(&graph->pending, 1, memory_order_release);
+            dispatch = atomic_load_explicit(&graph->dispatch, memory_order_acquire);
+        }
+    }
+}
+
+static void *worker_main(void *argument) {
+    VCGraph *graph = argument;
+    uint32_t seen = 0;
+    vc_denormals_flush_thread();
+    while (!atomic_load_explicit(&graph->stopping, memory_order_acquire)) {
+        uint32_t generation = (uint32_t)(atomic_load_explicit(&graph->dispatch, memory_order_acquire) >> 32);
+        if (generation != seen) {
+            seen = generation;
+            claim_tasks(graph, generation);
+            continue;
+        }
+
+        // ブロック内の次の段はすぐ来るので少し待ち、来なければ次のブロックまで眠る
+        int spins = 0;
+        while (spins < kWorkerSpins &&
+               (uint32_t)(atomic_load_explicit(&graph->dispatch, memory_order_acquire) >> 32) == seen) {
+            if (++spins % 64 == 0) {
+                sched_yield();
+            }
+        }
+        if (spins < kWorkerSpins) {
+            continue;
+        }
+        pthread_mutex_lock(&graph->sleepLock);
+        atomic_fetch_add(&graph->sleeping, 1);
+        if ((uint32_t)(atomic_load(&graph->dispatch) >> 32) == seen && !atomic_load(&graph->stopping)) {
+            pthread_cond_wait(&graph->wakeCond, &graph->sleepLock);
+        }
+        atomic_fetch_sub(&graph->sleeping, 1);
+        pthread_mutex_unlock(&graph->sleepLock);
+    }
+    return NULL;
+}
+
+/// 段のタスクを補助スレッドと分け合い、すべて済むまで待つ
+static void run_level_parallel(VCGraph *graph, int first, int end) {
+    atomic_store_explicit(&graph->pending, end - first, memory_order_relaxed);
+    uint32_t generation = ++graph->generation;
+    atomic_store_explicit(&graph->dispatch,
+                          ((uint64_t)generation << 32) | ((uint64_t)first << 16) | (uint64_t)end,
+                          memory_order_release);
+    // 眠っている補助スレッドだけ起こす（ロックが取れなければこの段は自分で処理する）
+    if (atomic_load(&graph->sleeping) > 0 && pthread_mutex_trylock(&graph->sleepLock) == 0) {
+        pthread_cond_broadcast(&graph->wakeCond);
+        pthread_mutex_unlock(&graph->sleepLock);
+    }
+
+    claim_tasks(graph, generation);
+    int spins = 0;
+    while (atomic_load_explicit(&graph->pending, memory_order_acquire) > 0) {
+        if (++spins % 64 == 0) {
+            sched_yield();
+        }
+    }
+}
+
+#pragma mark - Lifecycle
+
+VCGraph *vc_graph_create(int sampleRate, const VCGraphNodeDesc *nodes, int count,
+                         const VCGraphOptions *options, VCGraphError *outError) {
+    VCGraphOptions defaults = { 0, 0 };
+    if (options == NULL) {
+        options = &defaults;
+    }
+    VCGraphError error = VC_GRAPH_ERROR_INVALID;
+    int outputNode = -1;
+    if (sampleRate > 0 && nodes != NULL) {
+        error = validate(nodes, count, &outputNode);
+    }
+    if (error != VC_GRAPH_OK) {
+        if (outError != NULL) {
+            *outError = error;
+        }
+        return NULL;
+    }
+
+    VCGraph *graph = vc_calloc(1, sizeof(VCGraph));
+    if (graph != NULL) {
+        graph->nodes = vc_calloc((size_t)count, sizeof(GraphNode));
+    }
+    if (graph == NULL || graph->nodes == NULL) {
+        vc_free(graph);
+        if (outError != NULL) {
+            *outError = VC_GRAPH_ERROR_MEMORY;
+        }
+        return NULL;
+    }
+    graph->sampleRate = (float)sampleRate;
+    graph->nodeCount = count;
+    graph->outputNode = outputNode;
+    for (int n = 0; n < count; n++) {
+        graph->nodes[n].desc = nodes[n];
+        graph->nodes[n].buffer = -1;
+    }
+
+    int order[VC_GRAPH_MAX_NODES];
+    int scheduled = 0;
+    int parallel = options->workerCount > 0;
+    error = topological_order(graph, order, &scheduled);
+    if (error == VC_GRAPH_OK) {
+        error = build_tasks(graph, order, scheduled);
+    }
+    if (error == VC_GRAPH_OK) {
+        error = assign_buffers(graph, options->naiveBuffers, parallel);
+    }
+    for (int i = 0; i < graph->scheduleCount && error == VC_GRAPH_OK; i++) {
+        if (create_state(graph, &graph->nodes[graph->schedule[i]]) != 0) {
+            error = VC_GRAPH_ERROR_MEMORY;
+        }
+    }
+
+    // 最長経路の遅延（スケジュール順なら入力は計算済み）
+    for (int i = 0; i < graph->scheduleCount && error == VC_GRAPH_OK; i++) {
+        GraphNode *node = &graph->nodes[graph->schedule[i]];
+        float longest = 0.0f;
+        for (int k = 0; k < node->desc.inputCount; k++) {
+            longest = fmaxf(longest, graph->nodes[node->desc.inputs[k]].latency);
+        }
+        node->latency += longest;
+    }
+
+    // 並ぶ枝がなければ補助スレッドは作らない
+    if (error == VC_GRAPH_OK && parallel && graph->maxParallel > 1) {
+        pthread_mutex_init(&graph->sleepLock, NULL);
+        pthread_cond_init(&graph->wakeCond, NULL);
+        graph->threads = vc_calloc((size_t)options->workerCount, sizeof(pthread_t));
+        if (graph->threads == NULL) {
+            error = VC_GRAPH_ERROR_MEMORY;
+        }
+        for (int w = 0; w < options->workerCount && error == VC_GRAPH_OK; w++) {
+            if (pthread_create(&graph->threads[w], NULL, worker_main, graph) != 0) {
+                error = VC_GRAPH_ERROR_MEMORY;
+                break;
+            }
+            graph->workerCount++;
+        }
+    }
+
+    if (error != VC_GRAPH_OK) {
+        vc_graph_destroy(graph);
+        graph = NULL;
+    }
+    if (outError != NULL) {
+        *outError = error;
+    }
+    return graph;
+}
+
+void vc_graph_destroy(VCGraph *graph) {
+    if (graph == NULL) {
+        return;
+    }
+    if (graph->threads != NULL) {
+        pthread_mutex_lock(&graph->sleepLock);
+        atomic_store(&graph->stopping, 1);
+        pthread_cond_broadcast(&graph->wakeCond);
+        pthread_mutex_unlock(&graph->sleepLock);
+        for (int w = 0; w < graph->workerCount; w++) {
+            pthread_join(graph->threads[w], NULL);
+        }
+        pthread_cond_destroy(&graph->wakeCond);
+        pthread_mutex_destroy(&graph->sleepLock);
+        vc_free(graph->threads);
+    }
+    for (int n = 0; n < graph->nodeCount; n++) {
+        destroy_state(&graph->nodes[n]);
+    }
+    vc_free(graph->buffers);
+    vc_free(graph->schedule);
+    vc_free(graph->tasks);
+    vc_free(graph->levelStart);
+    vc_free(graph->nodes);
+    vc_free(graph);
+}
+
+int vc_graph_set_convolver(VCGraph *graph, int node, VCConvolver *convolver) {
+    if (node < 0 || node >= graph->nodeCount || graph->nodes[node].desc.kind != VC_GRAPH_NODE_CONVOLVER) {
+        return -1;
+    }
+    graph->nodes[node].convolver = convolver;
+    return 0;
+}
+
+void vc_graph_reset(VCGraph *graph) {
+    for (int i = 0; i < graph->scheduleCount; i++) {
+        GraphNode *node = &graph->nodes[graph->schedule[i]];
+        for (int b = 0; b < 3; b++) {
+            vc_biquad_reset(&node->state[b]);
+        }
+        switch (node->desc.kind) {
+        case VC_GRAPH_NODE_VAD:
+            vc_vad_reset(node->vad);
+            node->activityStart = node->activityEnd = 1.0f;
+            node->speech = 1;
+            break;
+        case VC_GRAPH_NODE_AGC:
+            vc_agc_init(&node->agc);
+            vc_agc_set_target(&node->agc, node->desc.param[0]);
+            break;
+        case VC_GRAPH_NODE_PITCH_SHIFT:
+            vc_pitch_shifter_reset(node->shifter);
+            break;
+        case VC_GRAPH_NODE_MULTIBAND:
+            vc_multiband_reset(node->multiband);
+            break;
+        case VC_GRAPH_NODE_CONVOLVER:
+            if (node->convolver != NULL) {
+                vc_convolver_reset(node->convolver);
+            }
+            break;
+        case VC_GRAPH_NODE_LIMITER:
+            vc_limiter_reset(&node->limiter);
+            if (node->oversampler != NULL) {
+                vc_oversampler_reset(node->oversampler);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    memset(graph->buffers, 0, (size_t)graph->bufferCount * VC_MAX_FRAME_SIZE * sizeof(float));
+}
+
+void vc_graph_get_info(const VCGraph *graph, VCGraphInfo *outInfo) {
+    outInfo->nodeCount = graph->scheduleCount;
+    outInfo->bufferCount = graph->bufferCount;
+    outInfo->bufferBytes = (size_t)graph->bufferCount * VC_MAX_FRAME_SIZE * sizeof(float);
+    outInfo->taskCount = graph->taskCount;
+    outInfo->levelCount = graph->levelCount;
+    outInfo->maxParallel = graph->maxParallel;
+}
+
+int vc_graph_schedule(const VCGraph *graph, int *outNodes, int capacity) {
+    for (int i = 0; i < graph->scheduleCount && i < capacity; i++) {
+        outNodes[i] = graph->schedule[i];
+    }
+    return graph->scheduleCount;
+}
+
+int vc_graph_node_buffer(const VCGraph *graph, int node) {
+    if (node < 0 || node >= graph->nodeCount || !graph->nodes[node].scheduled) {
+        return -1;
+    }
+    return graph->nodes[node].buffer;
+}
+
+float vc_graph_latency(const VCGraph *graph) {
+    return graph->nodes[graph->outputNode].latency;
+}
+
+void vc_graph_process(VCGraph *graph, const float *input, float *output, int count) {
+    graph->convolve = count % VC_CONVOLVER_BLOCK_SIZE == 0;
+    VCDenormalScope scope;
+    vc_denormals_flush_begin(&scope);
+    for (int offset = 0; offset < count; offset += VC_MAX_FRAME_SIZE) {
+        graph->blockInput = input + offset;
+        graph->blockOutput = output + offset;
+        graph->blockFrames = count - offset < VC_MAX_FRAME_SIZE ? count - offset : VC_MAX_FRAME_SIZE;
+
+        if (graph->workerCount == 0) {
+            for (int t = 0; t < graph->taskCount; t++) {
+                run_task(graph, &graph->tasks[t]);
+            }
+            continue;
+        }
+        for (int level = 0; level < graph->levelCount; level++) {
+            int first = graph->levelStart[level];
+            int end = graph->levelStart[level + 1];
+            if (end - first == 1) {
+                run_task(graph, &graph->tasks[first]);
+            } else {
+                run_level_parallel(graph, first, end);
+            }
+        }
+    }
+    vc_denormals_flush_end(&scope);
+}
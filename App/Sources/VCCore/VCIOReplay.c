@@ -0,0 +1,474 @@
+//
+//  VCIOReplay.c
+//  VoiceChanger
+//
+//  Deterministic replay of IO traces through the driver's read path (VCDriverIO)
+//  on a simulated ring, faster than real time and without CoreAudio
+//
+
+#include "include/VCIOReplay.h"
+#include "include/VCAudioRing.h"
+#include "include/VCDriverIO.h"
+#include "VCAlloc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define kDefaultHeartbeatTimeoutMs  15      // ドライバーの kHeartbeatTimeoutMs
+#define kSynthSampleRate            48000
+#define kSynthPeriod                256     // ドライバーの kFrameSize
+#define kSynthConfigInterval        512     // ドライバーの kTraceConfigInterval
+#define kSynthBaseHostTime          1000000000000ull
+
+struct VCIOReplayTrace {
+    VCIOTraceRecord *records;
+    size_t count;
+};
+
+#pragma mark - Trace Files
+
+typedef struct {
+    VCIOTraceRecord record;
+    uint32_t source;
+    uint32_t position;
+} SortEntry;
+
+static int compare_entries(const void *a, const void *b) {
+    const SortEntry *left = a;
+    const SortEntry *right = b;
+    if (left->record.hostTime != right->record.hostTime) {
+        return left->record.hostTime < right->record.hostTime ? -1 : 1;
+    }
+    if (left->source != right->source) {
+        return left->source < right->source ? -1 : 1;
+    }
+    return left->position < right->position ? -1 : (left->position > right->position);
+}
+
+static VCIOReplayTrace *trace_create(size_t capacity) {
+    VCIOReplayTrace *trace = vc_calloc(1, sizeof(VCIOReplayTrace));
+    if (trace == NULL) {
+        return NULL;
+    }
+    trace->records = vc_malloc((capacity > 0 ? capacity : 1) * sizeof(VCIOTraceRecord));
+    if (trace->records == NULL) {
+        vc_free(trace);
+        return NULL;
+    }
+    return trace;
+}
+
+static long file_record_count(FILE *file) {
+    if (fseek(file, 0, SEEK_END) != 0) {
+        return -1;
+    }
+    long size = ftell(file);
+    if (size < 0 || fseek(file, 0, SEEK_SET) != 0) {
+        return -1;
+    }
+    return size / VC_IO_TRACE_RECORD_SIZE;
+}
+
+VCIOReplayTrace *vc_io_replay_load(const char *const *paths, int count) {
+    if (paths == NULL || count <= 0) {
+        return NULL;
+    }
+
+    // 先に全ファイルの件数を数えて 1 回で確保する
+    size_t total = 0;
+    for (int i = 0; i < count; i++) {
+        FILE *file = fopen(paths[i], "rb");
+        if (file == NULL) {
+            return NULL;
+        }
+        long records = file_record_count(file);
+        fclose(file);
+        if (records < 0) {
+            return NULL;
+        }
+        total += (size_t)records;
+    }
+
+    SortEntry *entries = vc_malloc((total > 0 ? total : 1) * sizeof(SortEntry));
+    VCIOReplayTrace *trace = trace_create(total);
+    if (entries == NULL || trace == NULL) {
+        vc_free(entries);
+        vc_io_replay_free(trace);
+        return NULL;
+    }
+
+    size_t loaded = 0;
+    for (int i = 0; i < count; i++) {
+        FILE *file = fopen(paths[i], "rb");
+        if (file == NULL) {
+            break;
+        }
+        VCIOTraceRecord record;
+        uint32_t position = 0;
+        while (loaded < total && fread(&record, sizeof(record), 1, file) == 1) {
+            entries[loaded].record = record;
+            entries[loaded].source = (uint32_t)i;
+            entries[loaded].position = position++;
+            loaded++;
+        }
+        fclose(file);
+    }
+
+    qsort(entries, loaded, sizeof(SortEntry), compare_entries);
+    for (size_t i = 0; i < loaded; i++) {
+        trace->records[i] = entries[i].record;
+    }
+    trace->count = loaded;
+    vc_free(entries);
+    return trace;
+}
+
+int vc_io_replay_save(const VCIOReplayTrace *trace, const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return -1;
+    }
+    size_t written = fwrite(trace->records, sizeof(VCIOTraceRecord), trace->count, file);
+    int closed = fclose(file);
+    return written == trace->count && closed == 0 ? 0 : -1;
+}
+
+void vc_io_replay_free(VCIOReplayTrace *trace) {
+    if (trace == NULL) {
+        return;
+    }
+    vc_free(trace->records);
+    vc_free(trace);
+}
+
+size_t vc_io_replay_count(const VCIOReplayTrace *trace) {
+    return trace->count;
+}
+
+const VCIOTraceRecord *vc_io_replay_records(const VCIOReplayTrace *trace) {
+    return trace->records;
+}
+
+#pragma mark - Replay
+
+typedef struct {
+    VCAudioRing *ring;
+    int capacity;
+    int synced;                 // リングの中身をトレースに合わせ済み
+    int peerActive;
+    VCSharedRingWatch watch;
+
+    int haveConfig;
+    uint64_t anchorHostTime;
+    double hostTicksPerFrame;
+    uint32_t period;
+    uint32_t sampleRate;
+    uint64_t heartbeatTimeout;
+} ReplayState;
+
+/// 記録されたフィルレベルまでリングを満たし、そこから監視し直す
+static void resync(ReplayState *state, uint32_t fill, const float *zeros, int zerosCount, uint64_t now) {
+    VCSharedRing *view = vc_audio_ring_view(state->ring);
+    vc_shared_ring_reset(view);
+    int remaining = (int)fill < state->capacity ? (int)fill : state->capacity;
+    while (remaining > 0) {
+        int chunk = remaining < zerosCount ? remaining : zerosCount;
+        vc_shared_ring_write(view, zeros, chunk);
+        remaining -= chunk;
+    }
+    vc_shared_ring_watch_init(&state->watch, view, now, state->heartbeatTimeout);
+    state->synced = 1;
+}
+
+static void mark_mismatch(VCIOReplayResult *result, size_t index) {
+    if (result->firstMismatch < 0) {
+        result->firstMismatch = (int64_t)index;
+    }
+}
+
+int vc_io_replay_run(const VCIOReplayTrace *trace, const VCIOReplayOptions *options, VCIOReplayResult *outResult) {
+    VCIOReplayOptions defaults = { 0, 0, 0 };
+    if (options == NULL) {
+        options = &defaults;
+    }
+    VCIOReplayResult result;
+    memset(&result, 0, sizeof(result));
+    result.firstMismatch = -1;
+
+    // 読み出し先と書き込み元を兼ねる作業領域（中身は常に 0）
+    int scratchCount = options->capacity > 0 ? options->capacity : 1;
+    for (size_t i = 0; i < trace->count; i++) {
+        const VCIOTraceRecord *record = &trace->records[i];
+        uint64_t frames = 0;
+        if (record->kind == VC_IO_TRACE_READ) {
+            frames = record->frames;
+        } else if (record->kind == VC_IO_TRACE_APP_WRITE) {
+            frames = record->value;
+        } else if (record->kind == VC_IO_TRACE_CONFIG && options->capacity <= 0) {
+            frames = record->writeIndex;
+        }
+        if (frames > (uint64_t)scratchCount && frames <= (1u << 24)) {
+            scratchCount = (int)frames;
+        }
+    }
+    float *scratch = vc_calloc((size_t)scratchCount, sizeof(float));
+    if (scratch == NULL) {
+        return -1;
+    }
+
+    ReplayState state;
+    memset(&state, 0, sizeof(state));
+    int status = 0;
+    uint64_t firstHostTime = 0;
+    uint64_t lastHostTime = 0;
+
+    for (size_t i = 0; i < trace->count && status == 0; i++) {
+        const VCIOTraceRecord *record = &trace->records[i];
+        // 設定レコードの時刻は IO 開始のアンカーなので長さに含めない
+        if (record->kind != VC_IO_TRACE_CONFIG) {
+            if (firstHostTime == 0) {
+                firstHostTime = record->hostTime;
+            }
+            lastHostTime = record->hostTime;
+        }
+
+        switch (record->kind) {
+            case VC_IO_TRACE_CONFIG: {
+                int capacity = options->capacity > 0 ? options->capacity : (int)record->writeIndex;
+                if (capacity > 0 && capacity != state.capacity) {
+                    vc_audio_ring_destroy(state.ring);
+                    state.ring = vc_audio_ring_create(capacity);
+                    state.capacity = state.ring != NULL ? capacity : 0;
+                    state.synced = 0;
+                    if (state.ring == NULL) {
+                        status = -1;
+                        break;
+                    }
+                }
+                state.anchorHostTime = record->hostTime;
+                state.hostTicksPerFrame = vc_io_trace_unpack_double(record->value);
+                state.period = options->period > 0 ? (uint32_t)options->period : record->readIndex;
+                state.sampleRate = record->frames;
+                int timeoutMs = options->heartbeatTimeoutMs > 0 ? options->heartbeatTimeoutMs : kDefaultHeartbeatTimeoutMs;
+                state.heartbeatTimeout = (uint64_t)(state.hostTicksPerFrame * state.sampleRate * timeoutMs / 1000.0);
+                state.haveConfig = state.hostTicksPerFrame > 0.0 && state.period > 0 && state.sampleRate > 0;
+                break;
+            }
+
+            case VC_IO_TRACE_READ: {
+                if (!state.haveConfig || state.ring == NULL) {
+                    result.skipped++;
+                    break;
+                }
+                VCDriverReadStatus recorded = (VCDriverReadStatus)record->status;
+                if (recorded == VC_DRIVER_READ_REPLACED) {
+                    // 区画の作り直しは再現しない。張り替えた後の最初の周期で合わせ直す
+                    state.peerActive = 0;
+                    state.synced = 0;
+                    result.skipped++;
+                    break;
+                }
+
+                result.reads++;
+                result.recordedUnderruns += recorded == VC_DRIVER_READ_UNDERRUN;
+                result.recordedStalls += recorded == VC_DRIVER_READ_STALLED;
+
+                int frameCount = (int)record->frames < scratchCount ? (int)record->frames : scratchCount;
+                VCDriverReadResult replayed;
+                if (recorded == VC_DRIVER_READ_DETACHED) {
+                    replayed = vc_driver_read_input(NULL, &state.watch, record->hostTime, scratch, frameCount, &state.peerActive);
+                    state.synced = 0;
+                } else {
+                    uint32_t fill = record->writeIndex - record->readIndex;
+                    if (!state.synced) {
+                        resync(&state, fill, scratch, scratchCount, record->hostTime);
+                    }
+                    VCSharedRing *view = vc_audio_ring_view(state.ring);
+                    vc_shared_ring_set_active(view, recorded != VC_DRIVER_READ_INACTIVE);
+                    replayed = vc_driver_read_input(view, &state.watch, record->hostTime, scratch, frameCount, &state.peerActive);
+                    if ((uint32_t)replayed.available != fill) {
+                        result.fillMismatches++;
+                        mark_mismatch(&result, i);
+                    }
+                }
+
+                result.replayedUnderruns += replayed.status == VC_DRIVER_READ_UNDERRUN;
+                result.replayedStalls += replayed.status == VC_DRIVER_READ_STALLED;
+                if (replayed.status != recorded) {
+                    result.statusMismatches++;
+                    mark_mismatch(&result, i);
+                }
+                break;
+            }
+
+            case VC_IO_TRACE_APP_WRITE: {
+                if (!state.synced) {
+                    result.skipped++;
+                    break;
+                }
+                result.appWrites++;
+                result.recordedOverflows += record->frames < record->value;
+                int requested = record->value < (uint64_t)scratchCount ? (int)record->value : scratchCount;
+                int written = vc_shared_ring_write(vc_audio_ring_view(state.ring), scratch, requested);
+                result.replayedOverflows += written < requested;
+                break;
+            }
+
+            case VC_IO_TRACE_ZERO_TIMESTAMP: {
+                if (!state.haveConfig) {
+                    result.skipped++;
+                    break;
+                }
+                result.zeroTimestamps++;
+                double sampleTime;
+                uint64_t hostTime;
+                vc_driver_zero_timestamp(state.anchorHostTime, record->hostTime, state.hostTicksPerFrame, state.period,
+                                         &sampleTime, &hostTime);
+                uint64_t error = hostTime > record->value ? hostTime - record->value : record->value - hostTime;
+                if (error != 0) {
+                    result.timestampMismatches++;
+                    if (error > result.maxTimestampError) {
+                        result.maxTimestampError = error;
+                    }
+                }
+                break;
+            }
+
+            default:
+                result.skipped++;
+                break;
+        }
+    }
+
+    if (state.haveConfig) {
+        result.seconds = (double)(lastHostTime - firstHostTime) / (state.hostTicksPerFrame * state.sampleRate);
+    }
+    vc_audio_ring_destroy(state.ring);
+    vc_free(scratch);
+
+    if (status != 0 || !state.haveConfig) {
+        return -1;
+    }
+    if (outResult != NULL) {
+        *outResult = result;
+    }
+    return 0;
+}
+
+#pragma mark - Synthesis
+
+static uint32_t next_random(uint32_t *seed) {
+    // xorshift32（再現できれば十分）
+    uint32_t x = *seed != 0 ? *seed : 0x9E3779B9u;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *seed = x;
+    return x;
+}
+
+static void append(VCIOReplayTrace *trace, size_t capacity, const VCIOTraceRecord *record) {
+    if (trace->count < capacity) {
+        trace->records[trace->count++] = *record;
+    }
+}
+
+VCIOReplayTrace *vc_io_replay_synthesize(const VCIOReplaySynthOptions *options) {
+    if (options == NULL || options->seconds <= 0.0 || options->ioFrames <= 0 || options->appFrames <= 0) {
+        return NULL;
+    }
+
+    const double ticksPerFrame = 1e9 / kSynthSampleRate;
+    const uint64_t timeout = (uint64_t)(kDefaultHeartbeatTimeoutMs * 1e6);
+    const uint64_t cycles = (uint64_t)(options->seconds * kSynthSampleRate / options->ioFrames);
+    const uint64_t writes = (uint64_t)(options->seconds * kSynthSampleRate / options->appFrames) + 1;
+    const size_t capacity = (size_t)(cycles * 2 + writes + cycles * 2 / kSynthConfigInterval + 2);
+
+    VCIOReplayTrace *trace = trace_create(capacity);
+    VCAudioRing *ring = vc_audio_ring_create(options->capacity);
+    int scratchCount = options->ioFrames > options->appFrames ? options->ioFrames : options->appFrames;
+    float *scratch = vc_calloc((size_t)scratchCount, sizeof(float));
+    if (trace == NULL || ring == NULL || scratch == NULL) {
+        vc_io_replay_free(trace);
+        vc_audio_ring_destroy(ring);
+        vc_free(scratch);
+        return NULL;
+    }
+
+    VCSharedRing *view = vc_audio_ring_view(ring);
+    vc_shared_ring_set_active(view, 1);
+    VCSharedRingWatch watch;
+    vc_shared_ring_watch_init(&watch, view, kSynthBaseHostTime, timeout);
+    int peerActive = 0;
+
+    // アプリは 0 秒から書き始め、HAL は 3 IO 周期後から読む
+    const uint64_t anchor = kSynthBaseHostTime + (uint64_t)(3.0 * options->ioFrames * ticksPerFrame);
+    const double stallStart = options->stallAtSeconds;
+    const double stallEnd = options->stallAtSeconds + options->stallMs / 1000.0;
+    uint32_t seed = options->seed;
+
+    uint64_t cycle = 0;
+    uint64_t block = 0;
+    uint64_t writeTime = UINT64_MAX;    // 次のアプリの書き込み（ブロックごとに 1 回だけ決める）
+    uint64_t lastWrite = kSynthBaseHostTime;
+    uint32_t countdown = 0;
+
+    for (;;) {
+        // キャプチャ 1 ブロックが揃ってから処理の遅れぶん後に書く。停止中のブロックは書かない
+        while (writeTime == UINT64_MAX && block < writes) {
+            double ready = (double)(block + 1) * options->appFrames / kSynthSampleRate;
+            if (stallStart >= 0.0 && ready >= stallStart && ready < stallEnd) {
+                block++;
+                continue;
+            }
+            double delay = options->jitterMs * 1e6 * (next_random(&seed) / 4294967296.0);
+            writeTime = kSynthBaseHostTime + (uint64_t)(ready * 1e9 + delay);
+            if (writeTime < lastWrite) {
+                writeTime = lastWrite;
+            }
+        }
+        uint64_t readTime = cycle < cycles ? anchor + (uint64_t)((double)cycle * options->ioFrames * ticksPerFrame) : UINT64_MAX;
+        if (writeTime == UINT64_MAX && readTime == UINT64_MAX) {
+            break;
+        }
+
+        if (writeTime <= readTime) {
+            int written = vc_shared_ring_write(view, scratch, options->appFrames);
+            VCIOTraceRecord record = { writeTime, VC_IO_TRACE_APP_WRITE, 0, (uint32_t)written, 0, 0, (uint64_t)options->appFrames };
+            vc_shared_ring_indices(view, &record.writeIndex, &record.readIndex);
+            append(trace, capacity, &record);
+            lastWrite = writeTime;
+            writeTime = UINT64_MAX;
+            block++;
+            continue;
+        }
+
+        // ドライバーと同じ順: 設定（一定周期ごと）→ ゼロタイムスタンプ → ReadInput
+        if (countdown == 0) {
+            VCIOTraceRecord config = {
+                anchor, VC_IO_TRACE_CONFIG, 0, kSynthSampleRate, (uint32_t)options->capacity, kSynthPeriod,
+                vc_io_trace_pack_double(ticksPerFrame),
+            };
+            append(trace, capacity, &config);
+            countdown = kSynthConfigInterval;
+        }
+        double sampleTime;
+        uint64_t hostTime;
+        vc_driver_zero_timestamp(anchor, readTime, ticksPerFrame, kSynthPeriod, &sampleTime, &hostTime);
+        VCIOTraceRecord zero = { readTime, VC_IO_TRACE_ZERO_TIMESTAMP, 0, 0, 0, 0, hostTime };
+        append(trace, capacity, &zero);
+
+        VCDriverReadResult result = vc_driver_read_input(view, &watch, readTime, scratch, options->ioFrames, &peerActive);
+        VCIOTraceRecord read = {
+            readTime, VC_IO_TRACE_READ, (uint16_t)result.status, (uint32_t)options->ioFrames,
+            result.writeIndex, result.readIndex, vc_io_trace_pack_double((double)(cycle * (uint64_t)options->ioFrames)),
+        };
+        append(trace, capacity, &read);
+        countdown = countdown > 2 ? countdown - 2 : 0;
+        cycle++;
+    }
+
+    vc_audio_ring_destroy(ring);
+    vc_free(scratch);
+    return trace;
+}
@@ -0,0 +1,47 @@
+//
+//  VCIOTrace.c
+//  VoiceChanger
+//
+//  Compact binary IO trace records (driver IO cycles, zero timestamps, app writes),
+//  streamed through a shared ring and replayed by VCIOReplay
+//
+
+#include "include/VCIOTrace.h"
+#include <string.h>
+
+_Static_assert(sizeof(VCIOTraceRecord) == VC_IO_TRACE_RECORD_SIZE, "VCIOTraceRecord layout changed");
+
+// 共有リングの中身は float だが、レコードは float 8 個分のビット列としてそのまま運ぶ（演算はしない）
+// 読み書きは常にレコード単位なので、途中で切れたレコードは現れない
+
+int vc_io_trace_write(VCSharedRing *ring, const VCIOTraceRecord *record) {
+    if (vc_shared_ring_available_write(ring) < VC_IO_TRACE_RECORD_FLOATS) {
+        return -1;
+    }
+    float words[VC_IO_TRACE_RECORD_FLOATS];
+    memcpy(words, record, sizeof(words));
+    vc_shared_ring_write(ring, words, VC_IO_TRACE_RECORD_FLOATS);
+    return 0;
+}
+
+int vc_io_trace_read(VCSharedRing *ring, VCIOTraceRecord *outRecord) {
+    if (vc_shared_ring_available_read(ring) < VC_IO_TRACE_RECORD_FLOATS) {
+        return 0;
+    }
+    float words[VC_IO_TRACE_RECORD_FLOATS];
+    vc_shared_ring_read(ring, words, VC_IO_TRACE_RECORD_FLOATS);
+    memcpy(outRecord, words, sizeof(words));
+    return 1;
+}
+
+uint64_t vc_io_trace_pack_double(double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double vc_io_trace_unpack_double(uint64_t value) {
+    double result;
+    memcpy(&result, &value, sizeof(result));
+    return result;
+}
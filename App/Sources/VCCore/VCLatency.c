@@ -0,0 +1,379 @@
+//
+//  VCLatency.c
+//  VoiceChanger
+//
+//  End-to-end latency measurement: ring position <-> host time timelines,
+//  a lock-free latency histogram, and an active marker for DSP delay calibration
+//
+
+#include "include/VCLatency.h"
+#include "VCAlloc.h"
+#include <math.h>
+#include <stdatomic.h>
+#include <string.h>
+
+#define kMarkerBurstMs      2.0     // トーンバーストの長さ
+#define kMarkerGuardMs      20.0    // 前後の無音
+#define kMarkerToneHz       2000.0
+#define kMarkerAmplitude    0.8f
+#define kMarkerThreshold    0.05f   // 無音の中でこれを超えたらマーカーの立ち上がり
+#define kMarkerMaxDelayMs   250.0   // これより遅れたら見失ったとみなす
+#define kMarkerMinIntervalMs (2.0 * kMarkerMaxDelayMs)
+
+#pragma mark - Timeline
+
+typedef struct {
+    _Atomic uint32_t index;
+    _Atomic uint64_t hostTime;
+} TimelineSlot;
+
+struct VCLatencyTimeline {
+    TimelineSlot *slots;
+    uint32_t mask;
+    double hostTicksPerFrame;
+    _Atomic uint64_t count;     // mark した回数（書き込み側のみ進める）
+};
+
+VCLatencyTimeline *vc_latency_timeline_create(int capacity, double hostTicksPerFrame) {
+    if (capacity <= 1 || hostTicksPerFrame <= 0.0) {
+        return NULL;
+    }
+    uint32_t size = 2;
+    while (size < (uint32_t)capacity) {
+        size <<= 1;
+    }
+
+    VCLatencyTimeline *timeline = vc_calloc(1, sizeof(VCLatencyTimeline));
+    if (timeline == NULL) {
+        return NULL;
+    }
+    timeline->slots = vc_calloc(size, sizeof(TimelineSlot));
+    if (timeline->slots == NULL) {
+        vc_free(timeline);
+        return NULL;
+    }
+    timeline->mask = size - 1;
+    timeline->hostTicksPerFrame = hostTicksPerFrame;
+    atomic_init(&timeline->count, 0);
+    return timeline;
+}
+
+void vc_latency_timeline_destroy(VCLatencyTimeline *timeline) {
+    if (timeline == NULL) {
+        return;
+    }
+    vc_free(timeline->slots);
+    vc_free(timeline);
+}
+
+void vc_latency_timeline_mark(VCLatencyTimeline *timeline, uint32_t index, uint64_t hostTime) {
+    uint64_t count = atomic_load_explicit(&timeline->count, memory_order_relaxed);
+    TimelineSlot *slot = &timeline->slots[count & timeline->mask];
+    atomic_store_explicit(&slot->index, index, memory_order_relaxed);
+    atomic_store_explicit(&slot->hostTime, hostTime, memory_order_relaxed);
+    atomic_store_explicit(&timeline->count, count + 1, memory_order_release);
+}
+
+int vc_latency_timeline_lookup(const VCLatencyTimeline *timeline, uint32_t index, uint64_t *outHostTime) {
+    uint64_t count = atomic_load_explicit(&timeline->count, memory_order_acquire);
+    uint64_t size = (uint64_t)timeline->mask + 1;
+    // 書き込み中かもしれない一番古いスロットは見ない
+    uint64_t oldest = count >= size ? count - size + 1 : 0;
+
+    // index 以前で一番新しい mark（インデックスは折り返すので差で比べる）
+    for (uint64_t n = count; n > oldest; n--) {
+        const TimelineSlot *slot = &timeline->slots[(n - 1) & timeline->mask];
+        uint32_t markIndex = atomic_load_explicit(&slot->index, memory_order_relaxed);
+        uint64_t markTime = atomic_load_explicit(&slot->hostTime, memory_order_relaxed);
+        int32_t offset = (int32_t)(index - markIndex);
+        if (offset < 0) {
+            continue;
+        }
+
+        // 読んでいる間に上書きされていないこと
+        atomic_thread_fence(memory_order_acquire);
+        uint64_t now = atomic_load_explicit(&((VCLatencyTimeline *)timeline)->count, memory_order_relaxed);
+        if (now - (n - 1) >= size) {
+            return 0;
+        }
+        *outHostTime = markTime + (uint64_t)llround(offset * timeline->hostTicksPerFrame);
+        return 1;
+    }
+    return 0;
+}
+
+#pragma mark - Histogram
+
+struct VCLatencyProbe {
+    double hostTicksPerMs;
+    _Atomic uint64_t count;
+    _Atomic uint64_t overflow;
+    _Atomic uint64_t rejected;
+    _Atomic uint64_t sumUs;
+    _Atomic uint64_t minUs;
+    _Atomic uint64_t maxUs;
+    _Atomic uint32_t bins[VC_LATENCY_BINS];
+};
+
+VCLatencyProbe *vc_latency_probe_create(double hostTicksPerMs) {
+    if (hostTicksPerMs <= 0.0) {
+        return NULL;
+    }
+    VCLatencyProbe *probe = vc_calloc(1, sizeof(VCLatencyProbe));
+    if (probe == NULL) {
+        return NULL;
+    }
+    probe->hostTicksPerMs = hostTicksPerMs;
+    vc_latency_probe_reset(probe);
+    return probe;
+}
+
+void vc_latency_probe_destroy(VCLatencyProbe *probe) {
+    vc_free(probe);
+}
+
+/// 書き込みは 1 スレッドだけなので読んで足すだけでよい
+static inline void add_relaxed(_Atomic uint64_t *value, uint64_t amount) {
+    atomic_store_explicit(value, atomic_load_explicit(value, memory_order_relaxed) + amount, memory_order_relaxed);
+}
+
+void vc_latency_probe_record(VCLatencyProbe *probe, uint64_t captureHostTime, uint64_t deliveredHostTime) {
+    if (deliveredHostTime < captureHostTime) {
+        add_relaxed(&probe->rejected, 1);
+        return;
+    }
+    double ms = (double)(deliveredHostTime - captureHostTime) / probe->hostTicksPerMs;
+    uint64_t us = (uint64_t)llround(ms * 1000.0);
+
+    int bin = (int)(ms / VC_LATENCY_BIN_MS);
+    if (bin < VC_LATENCY_BINS) {
+        uint32_t current = atomic_load_explicit(&probe->bins[bin], memory_order_relaxed);
+        atomic_store_explicit(&probe->bins[bin], current + 1, memory_order_relaxed);
+    } else {
+        add_relaxed(&probe->overflow, 1);
+    }
+    if (us < atomic_load_explicit(&probe->minUs, memory_order_relaxed)) {
+        atomic_store_explicit(&probe->minUs, us, memory_order_relaxed);
+    }
+    if (us > atomic_load_explicit(&probe->maxUs, memory_order_relaxed)) {
+        atomic_store_explicit(&probe->maxUs, us, memory_order_relaxed);
+    }
+    add_relaxed(&probe->sumUs, us);
+    // count は最後に進める（読み出し側は count を見てから他を読む）
+    atomic_store_explicit(&probe->count, atomic_load_explicit(&probe->count, memory_order_relaxed) + 1,
+                          memory_order_release);
+}
+
+static double percentile(const VCLatencyStats *stats, double fraction) {
+    double target = fraction * (double)stats->count;
+    double cumulative = 0.0;
+    for (int bin = 0; bin < VC_LATENCY_BINS; bin++) {
+        double next = cumulative + stats->bins[bin];
+        if (stats->bins[bin] > 0 && next >= target) {
+            double value = (bin + (target - cumulative) / stats->bins[bin]) * VC_LATENCY_BIN_MS;
+            return fmin(fmax(value, stats->minMs), stats->maxMs);
+        }
+        cumulative = next;
+    }
+    return stats->maxMs;
+}
+
+void vc_latency_probe_read(const VCLatencyProbe *probe, VCLatencyStats *outStats) {
+    VCLatencyProbe *source = (VCLatencyProbe *)probe;
+    memset(outStats, 0, sizeof(*outStats));
+    outStats->count = atomic_load_explicit(&source->count, memory_order_acquire);
+    outStats->overflow = atomic_load_explicit(&source->overflow, memory_order_relaxed);
+    outStats->rejected = atomic_load_explicit(&source->rejected, memory_order_relaxed);
+    for (int bin = 0; bin < VC_LATENCY_BINS; bin++) {
+        outStats->bins[bin] = atomic_load_explicit(&source->bins[bin], memory_order_relaxed);
+    }
+    if (outStats->count == 0) {
+        return;
+    }
+    outStats->minMs = atomic_load_explicit(&source->minUs, memory_order_relaxed) / 1000.0;
+    outStats->maxMs = atomic_load_explicit(&source->maxUs, memory_order_relaxed) / 1000.0;
+    outStats->meanMs = atomic_load_explicit(&source->sumUs, memory_order_relaxed) / 1000.0 / (double)outStats->count;
+    outStats->p50Ms = percentile(outStats, 0.50);
+    outStats->p95Ms = percentile(outStats, 0.95);
+    outStats->p99Ms = percentile(outStats, 0.99);
+}
+
+void vc_latency_probe_reset(VCLatencyProbe *probe) {
+    atomic_store(&probe->count, 0);
+    atomic_store(&probe->overflow, 0);
+    atomic_store(&probe->rejected, 0);
+    atomic_store(&probe->sumUs, 0);
+    atomic_store(&probe->minUs, UINT64_MAX);
+    atomic_store(&probe->maxUs, 0);
+    for (int bin = 0; bin < VC_LATENCY_BINS; bin++) {
+        atomic_store(&probe->bins[bin], 0);
+    }
+}
+
+double vc_latency_stats_fraction_over(const VCLatencyStats *stats, double thresholdMs) {
+    if (stats->count == 0) {
+        return 0.0;
+    }
+    // threshold を含むビンから数える
+    int first = thresholdMs > 0.0 ? (int)(thresholdMs / VC_LATENCY_BIN_MS) : 0;
+    uint64_t over = stats->overflow;
+    for (int bin = first; bin < VC_LATENCY_BINS; bin++) {
+        over += stats->bins[bin];
+    }
+    return (double)over / (double)stats->count;
+}
+
+#pragma mark - Active Marker
+
+struct VCLatencyMarker {
+    int sampleRate;
+    float *burst;
+    int burstLength;
+    int64_t guard;
+    int64_t interval;
+    int64_t maxDelay;
+    double burstCenter;             // バースト先頭からエネルギーの重心まで（サンプル）
+
+    _Atomic int enabled;
+
+    // 入力側のみ
+    int64_t inputPosition;
+    int64_t nextBurst;
+
+    // 入力側 → 出力側（書き込み中のマーカーの先頭位置。まだなければ -1）
+    _Atomic int64_t burstStart;
+
+    // 出力側のみ
+    int64_t outputPosition;
+    int64_t measuredBurst;          // 測り終えた（または見失った）マーカー
+    int64_t trackingBurst;          // 重心を積算中のマーカー（なければ -1）
+    int64_t trackingEnd;
+    double energy;
+    double weightedEnergy;
+    _Atomic uint64_t misses;
+};
+
+VCLatencyMarker *vc_latency_marker_create(int sampleRate, double intervalMs) {
+    if (sampleRate <= 0) {
+        return NULL;
+    }
+    VCLatencyMarker *marker = vc_calloc(1, sizeof(VCLatencyMarker));
+    if (marker == NULL) {
+        return NULL;
+    }
+    marker->sampleRate = sampleRate;
+    marker->burstLength = (int)lround(kMarkerBurstMs * sampleRate / 1000.0);
+    marker->burst = vc_calloc((size_t)marker->burstLength, sizeof(float));
+    if (marker->burst == NULL) {
+        vc_free(marker);
+        return NULL;
+    }
+
+    // Hann 窓をかけたトーン（帯域が狭いので EQ / NS を通っても形が崩れにくい）
+    double energy = 0.0;
+    double weighted = 0.0;
+    for (int i = 0; i < marker->burstLength; i++) {
+        double window = 0.5 - 0.5 * cos(2.0 * M_PI * (i + 0.5) / marker->burstLength);
+        marker->burst[i] = kMarkerAmplitude * (float)(window * sin(2.0 * M_PI * kMarkerToneHz * i / sampleRate));
+        energy += (double)marker->burst[i] * marker->burst[i];
+        weighted += (double)i * marker->burst[i] * marker->burst[i];
+    }
+    marker->burstCenter = energy > 0.0 ? weighted / energy : marker->burstLength / 2.0;
+
+    if (intervalMs < kMarkerMinIntervalMs) {
+        intervalMs = kMarkerMinIntervalMs;
+    }
+    marker->guard = (int64_t)llround(kMarkerGuardMs * sampleRate / 1000.0);
+    marker->interval = (int64_t)llround(intervalMs * sampleRate / 1000.0);
+    marker->maxDelay = (int64_t)llround(kMarkerMaxDelayMs * sampleRate / 1000.0);
+    marker->nextBurst = marker->interval;
+    atomic_init(&marker->enabled, 0);
+    atomic_init(&marker->burstStart, -1);
+    marker->measuredBurst = -1;
+    marker->trackingBurst = -1;
+    atomic_init(&marker->misses, 0);
+    return marker;
+}
+
+void vc_latency_marker_destroy(VCLatencyMarker *marker) {
+    if (marker == NULL) {
+        return;
+    }
+    vc_free(marker->burst);
+    vc_free(marker);
+}
+
+void vc_latency_marker_set_enabled(VCLatencyMarker *marker, int enabled) {
+    atomic_store_explicit(&marker->enabled, enabled != 0, memory_order_relaxed);
+}
+
+void vc_latency_marker_inject(VCLatencyMarker *marker, float *samples, int count) {
+    int64_t start = marker->inputPosition;
+    marker->inputPosition += count;
+
+    for (int i = 0; i < count; i++) {
+        // 次のマーカーの先頭からの位置（前の無音は負）
+        int64_t offset = start + i - marker->nextBurst;
+        if (offset < -marker->guard) {
+            continue;
+        }
+        if (offset == -marker->guard && !atomic_load_explicit(&marker->enabled, memory_order_relaxed)) {
+            // 無効ならこのマーカーは飛ばす（途中で無効にされても書きかけは最後まで書く）
+            marker->nextBurst += marker->interval;
+            continue;
+        }
+        if (offset == 0) {
+            atomic_store_explicit(&marker->burstStart, marker->nextBurst, memory_order_release);
+        }
+        samples[i] = offset >= 0 && offset < marker->burstLength ? marker->burst[offset] : 0.0f;
+        if (offset + 1 >= marker->burstLength + marker->guard) {
+            marker->nextBurst += marker->interval;
+        }
+    }
+}
+
+int vc_latency_marker_detect(VCLatencyMarker *marker, const float *samples, int count, double *outDelayMs) {
+    int64_t start = marker->outputPosition;
+    marker->outputPosition += count;
+    int64_t burst = atomic_load_explicit(&marker->burstStart, memory_order_acquire);
+    int found = 0;
+
+    for (int i = 0; i < count; i++) {
+        int64_t position = start + i;
+
+        if (marker->trackingBurst < 0) {
+            if (burst < 0 || burst == marker->measuredBurst || position < burst) {
+                continue;
+            }
+            if (position - burst > marker->maxDelay) {
+                atomic_fetch_add_explicit(&marker->misses, 1, memory_order_relaxed);
+                marker->measuredBurst = burst;
+                continue;
+            }
+            if (fabsf(samples[i]) <= kMarkerThreshold) {
+                continue;
+            }
+            // 立ち上がりから 2 バースト分のエネルギーの重心を取る
+            marker->trackingBurst = burst;
+            marker->trackingEnd = position + 2 * marker->burstLength;
+            marker->energy = 0.0;
+            marker->weightedEnergy = 0.0;
+        }
+
+        double energy = (double)samples[i] * samples[i];
+        marker->energy += energy;
+        marker->weightedEnergy += (double)(position - marker->trackingBurst) * energy;
+        if (position + 1 >= marker->trackingEnd) {
+            double center = marker->energy > 0.0 ? marker->weightedEnergy / marker->energy : 0.0;
+            *outDelayMs = (center - marker->burstCenter) * 1000.0 / marker->sampleRate;
+            marker->measuredBurst = marker->trackingBurst;
+            marker->trackingBurst = -1;
+            found = 1;
+        }
+    }
+    return found;
+}
+
+uint64_t vc_latency_marker_misses(const VCLatencyMarker *marker) {
+    return atomic_load_explicit(&((VCLatencyMarker *)marker)->misses, memory_order_relaxed);
+}
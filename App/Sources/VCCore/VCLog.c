@@ -0,0 +1,117 @@
+//
+//  VCLog.c
+//  VoiceChanger
+//
+//  Real-time-safe binary log ring (event ID + numeric args, formatted off the RT thread)
+//
+
+#include "include/VCLog.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define kCacheLineSize 64
+
+struct VCLogRing {
+    // producer 側（RTスレッド）
+    _Atomic uint64_t tail __attribute__((aligned(kCacheLineSize)));
+    atomic_uint_fast64_t dropped;
+
+    // consumer 側（バックグラウンドスレッド）
+    _Atomic uint64_t head __attribute__((aligned(kCacheLineSize)));
+
+    uint32_t mask __attribute__((aligned(kCacheLineSize)));
+    VCLogEvent *events;
+};
+
+static uint32_t round_up_pow2(uint32_t value) {
+    uint32_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+VCLogRing *vc_log_ring_create(int capacity) {
+    if (capacity <= 0 || capacity > (1 << 24)) {
+        return NULL;
+    }
+
+    VCLogRing *ring = aligned_alloc(kCacheLineSize, sizeof(VCLogRing));
+    if (ring == NULL) {
+        return NULL;
+    }
+    memset(ring, 0, sizeof(*ring));
+
+    uint32_t size = round_up_pow2((uint32_t)capacity);
+    // 書き込み時にページフォルトしないよう、ここで確保してゼロ埋めしておく
+    ring->events = calloc(size, sizeof(VCLogEvent));
+    if (ring->events == NULL) {
+        free(ring);
+        return NULL;
+    }
+    ring->mask = size - 1;
+    atomic_store(&ring->tail, 0);
+    atomic_store(&ring->head, 0);
+    atomic_store(&ring->dropped, 0);
+    return ring;
+}
+
+void vc_log_ring_destroy(VCLogRing *ring) {
+    if (ring == NULL) {
+        return;
+    }
+    free(ring->events);
+    free(ring);
+}
+
+int vc_log_ring_capacity(const VCLogRing *ring) {
+    return (int)ring->mask + 1;
+}
+
+int vc_log_ring_write(VCLogRing *ring, uint32_t eventId, VCLogLevel level, int argCount,
+                      double arg0, double arg1, double arg2, double arg3) {
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (tail - head > ring->mask) {
+        atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+        return -1;
+    }
+
+    VCLogEvent *event = &ring->events[tail & ring->mask];
+    event->timestampNs = vc_log_now_ns();
+    event->eventId = eventId;
+    event->level = (uint16_t)level;
+    event->argCount = (uint16_t)(argCount < 0 ? 0 : (argCount > VC_LOG_MAX_ARGS ? VC_LOG_MAX_ARGS : argCount));
+    event->args[0] = arg0;
+    event->args[1] = arg1;
+    event->args[2] = arg2;
+    event->args[3] = arg3;
+
+    atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+    return 0;
+}
+
+int vc_log_ring_read(VCLogRing *ring, VCLogEvent *outEvent) {
+    uint64_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head == tail) {
+        return 0;
+    }
+
+    *outEvent = ring->events[head & ring->mask];
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    return 1;
+}
+
+uint64_t vc_log_ring_dropped(const VCLogRing *ring) {
+    return atomic_load_explicit(&((VCLogRing *)ring)->dropped, memory_order_relaxed);
+}
+
+uint64_t vc_log_now_ns(void) {
+    // macOS / Linux ともにシステムコールを伴わない（commpage / vDSO）
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
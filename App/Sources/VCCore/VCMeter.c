@@ -0,0 +1,279 @@
+//
+//  VCMeter.c
+//  VoiceChanger
+//
+//  Lock-free level meter: peak, RMS and K-weighted loudness (ITU-R BS.1770)
+//
+
+#include "include/VCMeter.h"
+#include "include/VCBiquad.h"
+#include "include/VCFastMath.h"
+#include "VCSimd.h"
+#include "VCAlloc.h"
+#include <math.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define kSubblockSeconds        0.1     // ラウドネスの集計単位（100ms）
+#define kMomentarySubblocks     4       // 400ms
+#define kShortTermSubblocks     30      // 3s
+#define kRmsTimeConstant        0.3f
+#define kPeakDecayDbPerSecond   20.0f
+#define kScratchSize            256
+
+// トリプルバッファの middle に立てる更新フラグ
+#define kSlotDirty              4u
+#define kSlotIndexMask          3u
+
+struct VCMeter {
+    float sampleRate;
+
+    // K特性（BS.1770: ハイシェルフ + RLB ハイパス）
+    VCBiquadCoeffs shelfCoeffs;
+    VCBiquadState shelfState;
+    VCBiquadCoeffs highpassCoeffs;
+    VCBiquadState highpassState;
+
+    float peak;
+    float meanSquare;
+
+    // 100ms ごとの K特性エネルギー（直近 3s 分）
+    int subblockLength;
+    int subblockFill;
+    double subblockEnergy;
+    double energies[kShortTermSubblocks];
+    int energyIndex;
+    int energyCount;
+    float momentaryLufs;
+    float shortTermLufs;
+
+    uint64_t samples;
+    float scratch[kScratchSize];
+
+    // トリプルバッファ（back = 書き込み側専用, front = 読み出し側専用）
+    VCMeterReading slots[3];
+    _Atomic uint32_t middle;
+    uint32_t back;
+    uint32_t front;
+};
+
+#pragma mark - Helpers
+
+static float to_db(float linear) {
+    return linear > 0 ? fmaxf(VC_METER_FLOOR_DB, vc_fast_linear_to_db(linear)) : VC_METER_FLOOR_DB;
+}
+
+static float energy_to_lufs(double meanSquare) {
+    if (meanSquare <= 0) {
+        return VC_METER_FLOOR_DB;
+    }
+    return fmaxf(VC_METER_FLOOR_DB, (float)(-0.691 + 10.0 * log10(meanSquare)));
+}
+
+/// BS.1770 の K特性係数（任意サンプルレート向けの双一次変換形、48kHz で規格の係数と一致）
+static void set_k_weighting(VCBiquadCoeffs *shelf, VCBiquadCoeffs *highpass, double sampleRate) {
+    // ステージ1: ハイシェルフ
+    {
+        const double frequency = 1681.974450955533;
+        const double gainDb = 3.999843853973347;
+        const double q = 0.7071752369554196;
+
+        double k = tan(M_PI * frequency / sampleRate);
+        double vh = pow(10.0, gainDb / 20.0);
+        double vb = pow(vh, 0.4996667741545416);
+        double a0 = 1.0 + k / q + k * k;
+
+        shelf->b0 = (float)((vh + vb * k / q + k * k) / a0);
+        shelf->b1 = (float)(2.0 * (k * k - vh) / a0);
+        shelf->b2 = (float)((vh - vb * k / q + k * k) / a0);
+        shelf->a1 = (float)(2.0 * (k * k - 1.0) / a0);
+        shelf->a2 = (float)((1.0 - k / q + k * k) / a0);
+    }
+
+    // ステージ2: RLB ハイパス（分子は正規化しない [1, -2, 1]）
+    {
+        const double frequency = 38.13547087602444;
+        const double q = 0.5003270373238773;
+
+        double k = tan(M_PI * frequency / sampleRate);
+        double a0 = 1.0 + k / q + k * k;
+
+        highpass->b0 = 1.0f;
+        highpass->b1 = -2.0f;
+        highpass->b2 = 1.0f;
+        highpass->a1 = (float)(2.0 * (k * k - 1.0) / a0);
+        highpass->a2 = (float)((1.0 - k / q + k * k) / a0);
+    }
+}
+
+/// ピークと二乗和
+static void block_peak_sumsq(const float *samples, int count, float *outPeak, double *outSum) {
+    float peak = 0;
+    double sum = 0;
+    int i = 0;
+
+#if VC_HAS_VECTOR_EXT
+    vc_f32x4 vPeak = vc_splat4(0.0f);
+    vc_f32x4 vSum = vc_splat4(0.0f);
+    for (; i + 4 <= count; i += 4) {
+        vc_f32x4 x = vc_load4(samples + i);
+        vPeak = vc_max4(vPeak, vc_abs4(x));
+        vSum += x * x;
+    }
+    peak = fmaxf(fmaxf(vPeak[0], vPeak[1]), fmaxf(vPeak[2], vPeak[3]));
+    sum = vc_hsum4(vSum);
+#endif
+
+    for (; i < count; i++) {
+        peak = fmaxf(peak, fabsf(samples[i]));
+        sum += samples[i] * samples[i];
+    }
+
+    *outPeak = peak;
+    *outSum = sum;
+}
+
+static void finish_subblock(VCMeter *meter) {
+    meter->energies[meter->energyIndex] = meter->subblockEnergy / meter->subblockLength;
+    meter->energyIndex = (meter->energyIndex + 1) % kShortTermSubblocks;
+    if (meter->energyCount < kShortTermSubblocks) {
+        meter->energyCount++;
+    }
+    meter->subblockEnergy = 0;
+    meter->subblockFill = 0;
+
+    // 直近から遡って窓内の平均を取る（100ms に1回なので単純ループ）
+    double momentary = 0;
+    double shortTerm = 0;
+    for (int n = 0; n < meter->energyCount; n++) {
+        double energy = meter->energies[(meter->energyIndex - 1 - n + kShortTermSubblocks) % kShortTermSubblocks];
+        if (n < kMomentarySubblocks) {
+            momentary += energy;
+        }
+        shortTerm += energy;
+    }
+    int momentaryCount = meter->energyCount < kMomentarySubblocks ? meter->energyCount : kMomentarySubblocks;
+    meter->momentaryLufs = energy_to_lufs(momentary / momentaryCount);
+    meter->shortTermLufs = energy_to_lufs(shortTerm / meter->energyCount);
+}
+
+static void publish(VCMeter *meter) {
+    VCMeterReading *reading = &meter->slots[meter->back];
+    reading->peakDb = to_db(meter->peak);
+    reading->rmsDb = to_db(sqrtf(meter->meanSquare));
+    reading->momentaryLufs = meter->momentaryLufs;
+    reading->shortTermLufs = meter->shortTermLufs;
+    reading->samples = meter->samples;
+
+    uint32_t previous = atomic_exchange_explicit(&meter->middle, meter->back | kSlotDirty, memory_order_acq_rel);
+    meter->back = previous & kSlotIndexMask;
+}
+
+#pragma mark - Public API
+
+VCMeter *vc_meter_create(int sampleRate) {
+    if (sampleRate <= 0) {
+        return NULL;
+    }
+
+    VCMeter *meter = vc_calloc(1, sizeof(VCMeter));
+    if (meter == NULL) {
+        return NULL;
+    }
+
+    meter->sampleRate = (float)sampleRate;
+    meter->subblockLength = (int)(sampleRate * kSubblockSeconds);
+    set_k_weighting(&meter->shelfCoeffs, &meter->highpassCoeffs, sampleRate);
+
+    vc_meter_reset(meter);
+    return meter;
+}
+
+void vc_meter_destroy(VCMeter *meter) {
+    vc_free(meter);
+}
+
+void vc_meter_reset(VCMeter *meter) {
+    vc_biquad_reset(&meter->shelfState);
+    vc_biquad_reset(&meter->highpassState);
+    meter->peak = 0;
+    meter->meanSquare = 0;
+    meter->subblockFill = 0;
+    meter->subblockEnergy = 0;
+    memset(meter->energies, 0, sizeof(meter->energies));
+    meter->energyIndex = 0;
+    meter->energyCount = 0;
+    meter->momentaryLufs = VC_METER_FLOOR_DB;
+    meter->shortTermLufs = VC_METER_FLOOR_DB;
+    meter->samples = 0;
+
+    for (int i = 0; i < 3; i++) {
+        meter->slots[i] = (VCMeterReading){
+            VC_METER_FLOOR_DB, VC_METER_FLOOR_DB, VC_METER_FLOOR_DB, VC_METER_FLOOR_DB, 0
+        };
+    }
+    meter->back = 0;
+    meter->front = 2;
+    atomic_store(&meter->middle, 1);
+}
+
+void vc_meter_process(VCMeter *meter, const float *samples, int count) {
+    if (count <= 0) {
+        return;
+    }
+
+    // 1. ピーク / RMS（非加重）
+    float blockPeak;
+    double blockSum;
+    block_peak_sumsq(samples, count, &blockPeak, &blockSum);
+
+    float decay = vc_fast_db_to_linear(-kPeakDecayDbPerSecond * (float)count / meter->sampleRate);
+    meter->peak = fmaxf(blockPeak, meter->peak * decay);
+
+    float alpha = 1.0f - vc_fast_expf(-(float)count / (kRmsTimeConstant * meter->sampleRate));
+    meter->meanSquare += alpha * ((float)(blockSum / count) - meter->meanSquare);
+
+    // 2. K特性ラウドネス（100ms 境界で区切りながら加重エネルギーを積算）
+    int offset = 0;
+    while (offset < count) {
+        int chunk = count - offset;
+        if (chunk > kScratchSize) {
+            chunk = kScratchSize;
+        }
+        if (chunk > meter->subblockLength - meter->subblockFill) {
+            chunk = meter->subblockLength - meter->subblockFill;
+        }
+
+        vc_biquad_process(&meter->shelfCoeffs, &meter->shelfState, samples + offset, meter->scratch, chunk);
+        vc_biquad_process(&meter->highpassCoeffs, &meter->highpassState, meter->scratch, meter->scratch, chunk);
+
+        float unusedPeak;
+        double weightedSum;
+        block_peak_sumsq(meter->scratch, chunk, &unusedPeak, &weightedSum);
+        meter->subblockEnergy += weightedSum;
+        meter->subblockFill += chunk;
+        if (meter->subblockFill == meter->subblockLength) {
+            finish_subblock(meter);
+        }
+        offset += chunk;
+    }
+
+    meter->samples += (uint64_t)count;
+    publish(meter);
+}
+
+int vc_meter_read(VCMeter *meter, VCMeterReading *outReading) {
+    int updated = 0;
+    if (atomic_load_explicit(&meter->middle, memory_order_acquire) & kSlotDirty) {
+        uint32_t previous = atomic_exchange_explicit(&meter->middle, meter->front, memory_order_acq_rel);
+        meter->front = previous & kSlotIndexMask;
+        updated = 1;
+    }
+    *outReading = meter->slots[meter->front];
+    return updated;
+}
@@ -0,0 +1,170 @@
+//
+//  VCMicFanout.c
+//  VoiceChanger
+//
+//  Fans one capture out to a chain per virtual mic, processed in parallel
+//
+
+#include "include/VCMicFanout.h"
+#include "include/VCStreamPool.h"
+#include "VCAlloc.h"
+#include <stdatomic.h>
+#include <string.h>
+
+// マイクごとの未処理ブロック上限（process は毎回待つので 1 ブロックしか溜まらない）
+#define kQueueCapacity  2
+#define kOutputAlign    64
+
+typedef struct {
+    VCChain *chain;
+    VCSharedRing *ring;
+    float *output;
+    int streamId;               // プール上の ID（マイク 0 は呼び出しスレッドで処理するので -1）
+    atomic_uint_fast64_t blocks;
+    atomic_uint_fast64_t droppedFrames;
+} VCMicSlot;
+
+struct VCMicFanout {
+    int maxFrames;
+    int workerCount;
+    VCStreamPool *pool;
+    VCMicSlot slots[VC_VIRTUAL_MIC_MAX];
+    int count;
+};
+
+#pragma mark - Processing
+
+/// 1 マイク分（呼び出しスレッドまたはプールのワーカー）
+static void process_mic(void *context, const float *input, float *output, int count) {
+    VCMicSlot *slot = (VCMicSlot *)context;
+    vc_chain_process(slot->chain, input, output, count);
+    if (slot->ring != NULL) {
+        int written = vc_shared_ring_write(slot->ring, output, count);
+        if (written < count) {
+            atomic_fetch_add_explicit(&slot->droppedFrames, (uint_fast64_t)(count - written), memory_order_relaxed);
+        }
+    }
+    atomic_fetch_add_explicit(&slot->blocks, 1, memory_order_relaxed);
+}
+
+int vc_mic_fanout_process(VCMicFanout *fanout, const float *input, int count) {
+    if (count <= 0 || count > fanout->maxFrames) {
+        return -1;
+    }
+    if (fanout->count == 0) {
+        return 0;
+    }
+
+    // 全マイクが同じ input を読む（読み取り専用なのでコピーしない）
+    for (int mic = 1; mic < fanout->count; mic++) {
+        VCMicSlot *slot = &fanout->slots[mic];
+        if (vc_stream_pool_submit(fanout->pool, slot->streamId, input, slot->output, count) != 0) {
+            // 毎回待ってから出すので満杯にはならないが、念のためこのスレッドで処理する
+            process_mic(slot, input, slot->output, count);
+        }
+    }
+    process_mic(&fanout->slots[0], input, fanout->slots[0].output, count);
+
+    if (fanout->pool != NULL) {
+        vc_stream_pool_wait(fanout->pool);
+    }
+    return 0;
+}
+
+#pragma mark - Lifecycle
+
+VCMicFanout *vc_mic_fanout_create(int maxFrames, int workerCount) {
+    if (maxFrames <= 0) {
+        return NULL;
+    }
+    VCMicFanout *fanout = vc_calloc(1, sizeof(VCMicFanout));
+    if (fanout == NULL) {
+        return NULL;
+    }
+    if (workerCount <= 0) {
+        // 呼び出しスレッドもマイク 0 を処理するので 1 コア分残す
+        workerCount = vc_stream_pool_cpu_count() - 1;
+        if (workerCount < 1) {
+            workerCount = 1;
+        }
+    }
+    fanout->maxFrames = maxFrames;
+    fanout->workerCount = workerCount;
+    return fanout;
+}
+
+void vc_mic_fanout_destroy(VCMicFanout *fanout) {
+    if (fanout == NULL) {
+        return;
+    }
+    vc_stream_pool_destroy(fanout->pool);
+    for (int i = 0; i < fanout->count; i++) {
+        vc_free(fanout->slots[i].output);
+    }
+    vc_free(fanout);
+}
+
+int vc_mic_fanout_add(VCMicFanout *fanout, VCChain *chain, VCSharedRing *ring) {
+    if (chain == NULL || fanout->count >= VC_VIRTUAL_MIC_MAX) {
+        return -1;
+    }
+    int mic = fanout->count;
+    VCMicSlot *slot = &fanout->slots[mic];
+
+    // ワーカーは 2 本目から（1 本だけなら呼び出しスレッドで足りる）
+    if (mic > 0 && fanout->pool == NULL) {
+        fanout->pool = vc_stream_pool_create(fanout->workerCount);
+        if (fanout->pool == NULL) {
+            return -1;
+        }
+    }
+
+    size_t bytes = ((size_t)fanout->maxFrames * sizeof(float) + kOutputAlign - 1) & ~(size_t)(kOutputAlign - 1);
+    float *output = vc_aligned_alloc(kOutputAlign, bytes);
+    if (output == NULL) {
+        return -1;
+    }
+    memset(output, 0, bytes);
+
+    int streamId = -1;
+    if (mic > 0) {
+        streamId = vc_stream_pool_add_processor(fanout->pool, process_mic, slot, 1, kQueueCapacity);
+        if (streamId < 0) {
+            vc_free(output);
+            return -1;
+        }
+    }
+
+    slot->chain = chain;
+    slot->ring = ring;
+    slot->output = output;
+    slot->streamId = streamId;
+    atomic_store(&slot->blocks, 0);
+    atomic_store(&slot->droppedFrames, 0);
+    fanout->count = mic + 1;
+    return mic;
+}
+
+#pragma mark - Accessors
+
+int vc_mic_fanout_count(const VCMicFanout *fanout) {
+    return fanout->count;
+}
+
+const float *vc_mic_fanout_output(const VCMicFanout *fanout, int mic) {
+    if (mic < 0 || mic >= fanout->count) {
+        return NULL;
+    }
+    return fanout->slots[mic].output;
+}
+
+void vc_mic_fanout_get_stats(const VCMicFanout *fanout, int mic, VCMicFanoutStats *outStats) {
+    memset(outStats, 0, sizeof(*outStats));
+    if (mic < 0 || mic >= fanout->count) {
+        return;
+    }
+    // 統計は process と別のスレッドから読んでよい（カウンタは relaxed の atomic）
+    VCMicSlot *slot = (VCMicSlot *)&fanout->slots[mic];
+    outStats->blocks = atomic_load_explicit(&slot->blocks, memory_order_relaxed);
+    outStats->droppedFrames = atomic_load_explicit(&slot->droppedFrames, memory_order_relaxed);
+}
@@ -0,0 +1,233 @@
+//
+//  VCMonitor.c
+//  VoiceChanger
+//
+//  Monitor path: SPSC ring from the DSP step to an output device, with
+//  a latency target and drift compensation between the two clocks
+//
+
+#include "include/VCMonitor.h"
+#include "include/VCAudioRing.h"
+#include "include/VCSharedRing.h"
+#include "VCAlloc.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define kMaxRatioDeviation  0.005   // ±0.5%（クロック偏差は通常 ±100ppm 程度）
+#define kRatioGain          0.005   // 目標比の誤差1.0あたりの比率補正（比例項）
+#define kRatioIntegralGain  0.00001 // pull ごとの積分項（定常偏差を消す）
+#define kFillSmoothing      0.01f   // 残量の平滑化係数（pull ごと）
+#define kResyncFactor       3       // 残量が目標の3倍を超えたら捨てて再同期
+
+struct VCMonitor {
+    VCSharedRing ring;
+    VCAudioRing *ownedRing;     // 外部リングに接続した場合は NULL
+    int targetLatency;
+
+    // consumer 側の状態
+    int running;                // 0 = 目標残量まで溜まるのを待っている
+    double phase;               // 次の出力フレームの入力上の小数位置
+    float smoothedFill;
+    double integral;
+    double ratio;
+
+    // 統計（producer / consumer がそれぞれ自分の分だけ更新）
+    atomic_uint_fast64_t framesPushed;
+    atomic_uint_fast64_t framesPulled;
+    atomic_uint_fast64_t underruns;
+    atomic_uint_fast64_t overruns;
+    atomic_uint_fast64_t droppedFrames;
+    _Atomic float statFill;
+    _Atomic float statRatio;
+};
+
+static inline float region_sample(const VCRingRegions *regions, int index) {
+    return index < regions->firstCount ? regions->first[index] : regions->second[index - regions->firstCount];
+}
+
+VCMonitor *vc_monitor_create(int targetLatencyFrames, int capacityFrames) {
+    if (targetLatencyFrames <= 0 || capacityFrames <= targetLatencyFrames) {
+        return NULL;
+    }
+
+    VCMonitor *monitor = vc_calloc(1, sizeof(VCMonitor));
+    if (monitor == NULL) {
+        return NULL;
+    }
+
+    monitor->ownedRing = vc_audio_ring_create(capacityFrames);
+    if (monitor->ownedRing == NULL) {
+        vc_free(monitor);
+        return NULL;
+    }
+    monitor->ring = *vc_audio_ring_view(monitor->ownedRing);
+    monitor->targetLatency = targetLatencyFrames;
+    vc_monitor_reset(monitor);
+    return monitor;
+}
+
+VCMonitor *vc_monitor_create_attached(const VCSharedRing *ring, int targetLatencyFrames) {
+    if (ring == NULL || targetLatencyFrames <= 0 || (unsigned int)targetLatencyFrames >= ring->capacity) {
+        return NULL;
+    }
+
+    VCMonitor *monitor = vc_calloc(1, sizeof(VCMonitor));
+    if (monitor == NULL) {
+        return NULL;
+    }
+
+    monitor->ring = *ring;
+    monitor->targetLatency = targetLatencyFrames;
+    atomic_store(&monitor->statRatio, 1.0f);
+    vc_monitor_restart(monitor, targetLatencyFrames);
+    return monitor;
+}
+
+void vc_monitor_destroy(VCMonitor *monitor) {
+    if (monitor == NULL) {
+        return;
+    }
+    vc_audio_ring_destroy(monitor->ownedRing);
+    vc_free(monitor);
+}
+
+int vc_monitor_target_latency(const VCMonitor *monitor) {
+    return monitor->targetLatency;
+}
+
+void vc_monitor_reset(VCMonitor *monitor) {
+    vc_shared_ring_reset(&monitor->ring);
+    monitor->running = 0;
+    monitor->phase = 0;
+    monitor->smoothedFill = (float)monitor->targetLatency;
+    monitor->integral = 0;
+    monitor->ratio = 1.0;
+
+    atomic_store(&monitor->framesPushed, 0);
+    atomic_store(&monitor->framesPulled, 0);
+    atomic_store(&monitor->underruns, 0);
+    atomic_store(&monitor->overruns, 0);
+    atomic_store(&monitor->droppedFrames, 0);
+    atomic_store(&monitor->statFill, 0.0f);
+    atomic_store(&monitor->statRatio, 1.0f);
+}
+
+int vc_monitor_restart(VCMonitor *monitor, int targetLatencyFrames) {
+    if (targetLatencyFrames <= 0 || targetLatencyFrames >= (int)monitor->ring.capacity) {
+        return -1;
+    }
+
+    vc_shared_ring_commit_read(&monitor->ring, vc_shared_ring_available_read(&monitor->ring));
+    monitor->targetLatency = targetLatencyFrames;
+    monitor->running = 0;
+    monitor->phase = 0;
+    monitor->smoothedFill = (float)targetLatencyFrames;
+    monitor->integral = 0;
+    monitor->ratio = 1.0;
+    return 0;
+}
+
+int vc_monitor_push(VCMonitor *monitor, const float *samples, int count) {
+    int written = vc_shared_ring_write(&monitor->ring, samples, count);
+    atomic_fetch_add_explicit(&monitor->framesPushed, (uint_fast64_t)written, memory_order_relaxed);
+    if (written < count) {
+        atomic_fetch_add_explicit(&monitor->overruns, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&monitor->droppedFrames, (uint_fast64_t)(count - written), memory_order_relaxed);
+    }
+    return written;
+}
+
+static void output_silence(VCMonitor *monitor, float *output, int count) {
+    memset(output, 0, (size_t)count * sizeof(float));
+    atomic_fetch_add_explicit(&monitor->framesPulled, (uint_fast64_t)count, memory_order_relaxed);
+}
+
+void vc_monitor_pull(VCMonitor *monitor, float *output, int count) {
+    if (count <= 0) {
+        return;
+    }
+
+    int available = vc_shared_ring_available_read(&monitor->ring);
+    const int target = monitor->targetLatency;
+
+    // 1. 目標残量まで溜まるまでは無音（起動直後 / アンダーラン後）
+    if (!monitor->running) {
+        if (available < target) {
+            output_silence(monitor, output, count);
+            return;
+        }
+        monitor->running = 1;
+        monitor->phase = 0;
+        monitor->smoothedFill = (float)available;
+    }
+
+    // 2. 遅延過大（出力側が止まっていた等）は目標まで捨てて再同期
+    if (available > target * kResyncFactor) {
+        int excess = available - target;
+        vc_shared_ring_commit_read(&monitor->ring, excess);
+        atomic_fetch_add_explicit(&monitor->overruns, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&monitor->droppedFrames, (uint_fast64_t)excess, memory_order_relaxed);
+        available = target;
+        monitor->smoothedFill = (float)target;
+    }
+
+    // 3. ドリフト補正: 残量が目標より多ければ速く、少なければ遅く読む
+    monitor->smoothedFill += kFillSmoothing * ((float)available - monitor->smoothedFill);
+    double error = ((double)monitor->smoothedFill - target) / target;
+    monitor->integral += kRatioIntegralGain * error;
+    if (monitor->integral > kMaxRatioDeviation) {
+        monitor->integral = kMaxRatioDeviation;
+    } else if (monitor->integral < -kMaxRatioDeviation) {
+        monitor->integral = -kMaxRatioDeviation;
+    }
+    double deviation = kRatioGain * error + monitor->integral;
+    if (deviation > kMaxRatioDeviation) {
+        deviation = kMaxRatioDeviation;
+    } else if (deviation < -kMaxRatioDeviation) {
+        deviation = -kMaxRatioDeviation;
+    }
+    monitor->ratio = 1.0 + deviation;
+
+    // 補間に必要な入力フレーム数（最後の出力フレームの次の1フレームまで）
+    double end = monitor->phase + (double)count * monitor->ratio;
+    int needed = (int)(monitor->phase + (double)(count - 1) * monitor->ratio) + 2;
+
+    VCRingRegions regions;
+    if (vc_shared_ring_read_regions(&monitor->ring, needed, &regions) < needed) {
+        // アンダーラン: 残りを捨てずに溜め直す
+        monitor->running = 0;
+        atomic_fetch_add_explicit(&monitor->underruns, 1, memory_order_relaxed);
+        output_silence(monitor, output, count);
+        return;
+    }
+
+    // 4. 線形補間リサンプル（リング内を直接参照）
+    double position = monitor->phase;
+    for (int i = 0; i < count; i++) {
+        int index = (int)position;
+        float frac = (float)(position - index);
+        float a = region_sample(&regions, index);
+        float b = region_sample(&regions, index + 1);
+        output[i] = a + frac * (b - a);
+        position += monitor->ratio;
+    }
+
+    int consumed = (int)end;
+    monitor->phase = end - consumed;
+    vc_shared_ring_commit_read(&monitor->ring, consumed);
+
+    atomic_fetch_add_explicit(&monitor->framesPulled, (uint_fast64_t)count, memory_order_relaxed);
+    atomic_store_explicit(&monitor->statFill, monitor->smoothedFill, memory_order_relaxed);
+    atomic_store_explicit(&monitor->statRatio, (float)monitor->ratio, memory_order_relaxed);
+}
+
+void vc_monitor_get_stats(VCMonitor *monitor, VCMonitorStats *outStats) {
+    outStats->framesPushed = atomic_load_explicit(&monitor->framesPushed, memory_order_relaxed);
+    outStats->framesPulled = atomic_load_explicit(&monitor->framesPulled, memory_order_relaxed);
+    outStats->underruns = atomic_load_explicit(&monitor->underruns, memory_order_relaxed);
+    outStats->overruns = atomic_load_explicit(&monitor->overruns, memory_order_relaxed);
+    outStats->droppedFrames = atomic_load_explicit(&monitor->droppedFrames, memory_order_relaxed);
+    outStats->fillFrames = atomic_load_explicit(&monitor->statFill, memory_order_relaxed);
+    outStats->ratio = atomic_load_explicit(&monitor->statRatio, memory_order_relaxed);
+}
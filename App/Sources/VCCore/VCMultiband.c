@@ -0,0 +1,270 @@
+//
+//  VCMultiband.c
+//  VoiceChanger
+//
+//  4-band compressor / de-esser on Linkwitz–Riley crossovers
+//
+
+#include "include/VCMultiband.h"
+#include "include/VCBatch.h"
+#include "include/VCBiquad.h"
+#include "include/VCFastMath.h"
+#include "VCSimd.h"
+#include "VCAlloc.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define kButterworthQ       0.70710678f // LR4 = 同じ Butterworth 2次を2段
+#define kChunk              256
+#define kControlInterval    16          // ゲインを計算し直す間隔（サンプル）
+#define kEnvelopeFloor      1e-6f       // -120 dBFS
+
+struct VCMultiband {
+    float sampleRate;
+    VCMultibandParams params;
+
+    // レーン = 帯域。バッファは samples[frame * 4 + band]
+    VCBiquadBatch split[2];     // 中央のクロスオーバー（LP, LP, HP, HP）
+    VCBiquadBatch divide[2];    // 各側の分割（LP f0, HP f0, LP f2, HP f2）
+    VCBiquadBatch align;        // 反対側のクロスオーバー分のオールパス（AP f2, AP f2, AP f0, AP f0）
+
+    float attack[VC_MULTIBAND_BANDS] __attribute__((aligned(16)));
+    float release[VC_MULTIBAND_BANDS] __attribute__((aligned(16)));
+    float envelope[VC_MULTIBAND_BANDS] __attribute__((aligned(16)));
+    float gain[VC_MULTIBAND_BANDS] __attribute__((aligned(16)));
+    float reductionDb[VC_MULTIBAND_BANDS];
+
+    float buffer[kChunk * VC_MULTIBAND_BANDS] __attribute__((aligned(16)));
+};
+
+static float clampf(float value, float lo, float hi) {
+    return fmaxf(lo, fminf(hi, value));
+}
+
+/// 時定数（ms）から 1 サンプルあたりの追従係数
+static float follow_coeff(float ms, float sampleRate) {
+    float samples = fmaxf(ms, 0.01f) * sampleRate / 1000.0f;
+    return 1.0f - expf(-1.0f / samples);
+}
+
+#pragma mark - Lifecycle
+
+void vc_multiband_params_default(VCMultibandParams *params) {
+    static const float kCrossovers[VC_MULTIBAND_BANDS - 1] = { 250.0f, 2000.0f, 5500.0f };
+    static const float kThresholds[VC_MULTIBAND_BANDS] = { -24.0f, -24.0f, -24.0f, -30.0f };
+    static const float kRatios[VC_MULTIBAND_BANDS] = { 2.5f, 2.5f, 2.5f, 4.0f };
+    static const float kAttacks[VC_MULTIBAND_BANDS] = { 10.0f, 5.0f, 3.0f, 1.0f };
+    static const float kReleases[VC_MULTIBAND_BANDS] = { 120.0f, 100.0f, 80.0f, 60.0f };
+
+    memcpy(params->crossoverHz, kCrossovers, sizeof(kCrossovers));
+    memcpy(params->thresholdDb, kThresholds, sizeof(kThresholds));
+    memcpy(params->ratio, kRatios, sizeof(kRatios));
+    memcpy(params->attackMs, kAttacks, sizeof(kAttacks));
+    memcpy(params->releaseMs, kReleases, sizeof(kReleases));
+    memset(params->makeupDb, 0, sizeof(params->makeupDb));
+    params->kneeDb = 6.0f;
+}
+
+VCMultiband *vc_multiband_create(int sampleRate) {
+    if (sampleRate <= 0) {
+        return NULL;
+    }
+    VCMultiband *multiband = vc_aligned_alloc(16, sizeof(VCMultiband));
+    if (multiband == NULL) {
+        return NULL;
+    }
+    memset(multiband, 0, sizeof(*multiband));
+    multiband->sampleRate = (float)sampleRate;
+
+    vc_biquad_batch_init(&multiband->split[0], VC_MULTIBAND_BANDS);
+    vc_biquad_batch_init(&multiband->split[1], VC_MULTIBAND_BANDS);
+    vc_biquad_batch_init(&multiband->divide[0], VC_MULTIBAND_BANDS);
+    vc_biquad_batch_init(&multiband->divide[1], VC_MULTIBAND_BANDS);
+    vc_biquad_batch_init(&multiband->align, VC_MULTIBAND_BANDS);
+
+    VCMultibandParams params;
+    vc_multiband_params_default(&params);
+    vc_multiband_set_params(multiband, &params);
+    vc_multiband_reset(multiband);
+    return multiband;
+}
+
+void vc_multiband_destroy(VCMultiband *multiband) {
+    vc_free(multiband);
+}
+
+void vc_multiband_set_params(VCMultiband *multiband, const VCMultibandParams *params) {
+    VCMultibandParams *p = &multiband->params;
+    *p = *params;
+
+    // クロスオーバーは昇順・ナイキスト未満に
+    float nyquist = multiband->sampleRate * 0.5f;
+    float lower = 20.0f;
+    for (int i = 0; i < VC_MULTIBAND_BANDS - 1; i++) {
+        p->crossoverHz[i] = clampf(p->crossoverHz[i], lower, nyquist * 0.9f);
+        lower = p->crossoverHz[i];
+    }
+    for (int b = 0; b < VC_MULTIBAND_BANDS; b++) {
+        p->ratio[b] = fmaxf(p->ratio[b], 1.0f);
+        multiband->attack[b] = follow_coeff(p->attackMs[b], multiband->sampleRate);
+        multiband->release[b] = follow_coeff(p->releaseMs[b], multiband->sampleRate);
+    }
+    p->kneeDb = fmaxf(p->kneeDb, 0.0f);
+
+    float sr = multiband->sampleRate;
+    VCBiquadCoeffs lowpass, highpass;
+    vc_biquad_set_lowpass(&lowpass, p->crossoverHz[1], kButterworthQ, sr);
+    vc_biquad_set_highpass(&highpass, p->crossoverHz[1], kButterworthQ, sr);
+    for (int stage = 0; stage < 2; stage++) {
+        vc_biquad_batch_set_lane(&multiband->split[stage], 0, &lowpass);
+        vc_biquad_batch_set_lane(&multiband->split[stage], 1, &lowpass);
+        vc_biquad_batch_set_lane(&multiband->split[stage], 2, &highpass);
+        vc_biquad_batch_set_lane(&multiband->split[stage], 3, &highpass);
+    }
+
+    VCBiquadCoeffs lowLow, lowHigh, highLow, highHigh;
+    vc_biquad_set_lowpass(&lowLow, p->crossoverHz[0], kButterworthQ, sr);
+    vc_biquad_set_highpass(&lowHigh, p->crossoverHz[0], kButterworthQ, sr);
+    vc_biquad_set_lowpass(&highLow, p->crossoverHz[2], kButterworthQ, sr);
+    vc_biquad_set_highpass(&highHigh, p->crossoverHz[2], kButterworthQ, sr);
+    for (int stage = 0; stage < 2; stage++) {
+        vc_biquad_batch_set_lane(&multiband->divide[stage], 0, &lowLow);
+        vc_biquad_batch_set_lane(&multiband->divide[stage], 1, &lowHigh);
+        vc_biquad_batch_set_lane(&multiband->divide[stage], 2, &highLow);
+        vc_biquad_batch_set_lane(&multiband->divide[stage], 3, &highHigh);
+    }
+
+    // LR4 の LP + HP は Q = 1/√2 の2次オールパスに等しい
+    VCBiquadCoeffs allpassLow, allpassHigh;
+    vc_biquad_set_allpass(&allpassLow, p->crossoverHz[0], kButterworthQ, sr);
+    vc_biquad_set_allpass(&allpassHigh, p->crossoverHz[2], kButterworthQ, sr);
+    vc_biquad_batch_set_lane(&multiband->align, 0, &allpassHigh);
+    vc_biquad_batch_set_lane(&multiband->align, 1, &allpassHigh);
+    vc_biquad_batch_set_lane(&multiband->align, 2, &allpassLow);
+    vc_biquad_batch_set_lane(&multiband->align, 3, &allpassLow);
+}
+
+void vc_multiband_get_params(const VCMultiband *multiband, VCMultibandParams *outParams) {
+    *outParams = multiband->params;
+}
+
+void vc_multiband_reset(VCMultiband *multiband) {
+    vc_biquad_batch_reset(&multiband->split[0]);
+    vc_biquad_batch_reset(&multiband->split[1]);
+    vc_biquad_batch_reset(&multiband->divide[0]);
+    vc_biquad_batch_reset(&multiband->divide[1]);
+    vc_biquad_batch_reset(&multiband->align);
+    for (int b = 0; b < VC_MULTIBAND_BANDS; b++) {
+        multiband->envelope[b] = 0;
+        multiband->gain[b] = vc_fast_db_to_linear(multiband->params.makeupDb[b]);
+        multiband->reductionDb[b] = 0;
+    }
+}
+
+void vc_multiband_get_gain_reduction(const VCMultiband *multiband, float outDb[VC_MULTIBAND_BANDS]) {
+    memcpy(outDb, multiband->reductionDb, sizeof(multiband->reductionDb));
+}
+
+#pragma mark - Processing
+
+/// エンベロープから各帯域の目標ゲイン（ソフトニー付きの静特性）
+static void compute_gains(VCMultiband *multiband, float *target) {
+    const VCMultibandParams *p = &multiband->params;
+    float knee = p->kneeDb;
+    for (int b = 0; b < VC_MULTIBAND_BANDS; b++) {
+        float level = vc_fast_linear_to_db(fmaxf(multiband->envelope[b], kEnvelopeFloor));
+        float over = level - p->thresholdDb[b];
+        float slope = 1.0f - 1.0f / p->ratio[b];
+        float reduction = 0;
+        if (2.0f * over >= knee) {
+            reduction = over * slope;
+        } else if (2.0f * over > -knee) {
+            float x = over + 0.5f * knee;
+            reduction = slope * x * x / (2.0f * knee);
+        }
+        multiband->reductionDb[b] = reduction;
+        target[b] = vc_fast_db_to_linear(p->makeupDb[b] - reduction);
+    }
+}
+
+/// 帯域分割済みのバッファにエンベロープ追従・ゲインを掛けて足し合わせる
+static void apply_dynamics(VCMultiband *multiband, float *output, int frames) {
+    const float *bands = multiband->buffer;
+    float target[VC_MULTIBAND_BANDS] __attribute__((aligned(16)));
+
+    for (int offset = 0; offset < frames; offset += kControlInterval) {
+        int n = frames - offset < kControlInterval ? frames - offset : kControlInterval;
+        const float *p = bands + offset * VC_MULTIBAND_BANDS;
+
+#if VC_HAS_VECTOR_EXT
+        // ピーク追従（上がるときは attack、下がるときは release）
+        const vc_f32x4 attack = vc_load4(multiband->attack);
+        const vc_f32x4 release = vc_load4(multiband->release);
+        vc_f32x4 envelope = vc_load4(multiband->envelope);
+        for (int i = 0; i < n; i++) {
+            vc_f32x4 level = vc_abs4(vc_load4(p + i * VC_MULTIBAND_BANDS));
+            vc_f32x4 coeff = vc_select4(level > envelope, attack, release);
+            envelope += coeff * (level - envelope);
+        }
+        vc_store4(multiband->envelope, envelope);
+
+        compute_gains(multiband, target);
+
+        // 前回のゲインから目標まで線形に動かしながら帯域を合成
+        vc_f32x4 gain = vc_load4(multiband->gain);
+        const vc_f32x4 step = (vc_load4(target) - gain) / vc_splat4((float)n);
+        for (int i = 0; i < n; i++) {
+            gain += step;
+            output[offset + i] = vc_hsum4(vc_load4(p + i * VC_MULTIBAND_BANDS) * gain);
+        }
+        vc_store4(multiband->gain, vc_load4(target));
+#else
+        for (int b = 0; b < VC_MULTIBAND_BANDS; b++) {
+            float envelope = multiband->envelope[b];
+            for (int i = 0; i < n; i++) {
+                float level = fabsf(p[i * VC_MULTIBAND_BANDS + b]);
+                float coeff = level > envelope ? multiband->attack[b] : multiband->release[b];
+                envelope += coeff * (level - envelope);
+            }
+            multiband->envelope[b] = envelope;
+        }
+
+        compute_gains(multiband, target);
+
+        float step[VC_MULTIBAND_BANDS];
+        for (int b = 0; b < VC_MULTIBAND_BANDS; b++) {
+            step[b] = (target[b] - multiband->gain[b]) / (float)n;
+        }
+        for (int i = 0; i < n; i++) {
+            float sum = 0;
+            for (int b = 0; b < VC_MULTIBAND_BANDS; b++) {
+                sum += p[i * VC_MULTIBAND_BANDS + b] * (multiband->gain[b] + step[b] * (float)(i + 1));
+            }
+            output[offset + i] = sum;
+        }
+        memcpy(multiband->gain, target, sizeof(target));
+#endif
+    }
+}
+
+void vc_multiband_process(VCMultiband *multiband, float *samples, int count) {
+    for (int offset = 0; offset < count; offset += kChunk) {
+        int frames = count - offset < kChunk ? count - offset : kChunk;
+        float *chunk = samples + offset;
+
+        // 全帯域へ同じ入力を複製し、クロスオーバーを帯域ごとのレーンとして同時に通す
+        float *buffer = multiband->buffer;
+        for (int i = 0; i < frames; i++) {
+            float *frame = buffer + i * VC_MULTIBAND_BANDS;
+            frame[0] = frame[1] = frame[2] = frame[3] = chunk[i];
+        }
+        vc_biquad_batch_process(&multiband->split[0], buffer, frames);
+        vc_biquad_batch_process(&multiband->split[1], buffer, frames);
+        vc_biquad_batch_process(&multiband->divide[0], buffer, frames);
+        vc_biquad_batch_process(&multiband->divide[1], buffer, frames);
+        vc_biquad_batch_process(&multiband->align, buffer, frames);
+
+        apply_dynamics(multiband, chunk, frames);
+    }
+}
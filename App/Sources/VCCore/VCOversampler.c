@@ -0,0 +1,279 @@
+//
+//  VCOversampler.c
+//  VoiceChanger
+//
+//  2x / 4x polyphase half-band oversampling for nonlinear stages
+//
+
+#include "include/VCOversampler.h"
+#include "VCSimd.h"
+#include "VCAlloc.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 半帯域 FIR の偶数位相の係数の数（4 の倍数）と Kaiser 窓の β
+// 1 段目（→ 2 倍）は 18 kHz〜30 kHz を遷移帯域に、2 段目（→ 4 倍）は 1 段目の像が残る 78 kHz から減衰させる
+#define kFirstStageTaps     24
+#define kFirstStageBeta     7.3
+#define kSecondStageTaps    8
+#define kSecondStageBeta    6.8
+#define kMaxStages          2
+#define kMaxTaps            kFirstStageTaps
+
+/// 半帯域フィルタ 1 段（2 倍の補間・間引き）
+///
+/// 長さ N = 2 * taps - 1 の半帯域 FIR h は中央 h[D] = 0.5（D = taps - 1）で、
+/// D から偶数だけ離れた係数は 0 になる。残りは偶数番目の h[2i]（taps 個）。
+typedef struct {
+    int taps;
+    int delay;                  // 奇数位相（中央タップ）の遅延 = (D - 1) / 2（低いほうのレート）
+    int maxInput;               // 低いほうのレートで1回に扱う最大サンプル数
+    float *coeffs;              // h[2(taps - 1 - j)]（出力位置から前向きに畳み込む順）
+
+    float *upBuffer;            // [履歴 taps - 1 | 入力]
+    float *evenBuffer;          // 間引き: 偶数サンプル [履歴 taps - 1 | 入力]
+    float *oddBuffer;           // 間引き: 奇数サンプル [履歴 delay + 1 | 入力]
+} VCHalfBand;
+
+struct VCOversampler {
+    int factor;
+    int stages;
+    int maxFrames;
+    VCHalfBand halfBands[kMaxStages];
+    float *buffers[kMaxStages + 1];     // 各レートの信号（[0] は元のレート、[stages] を呼び出し側に渡す）
+};
+
+#pragma mark - Design
+
+/// 第1種0次の変形ベッセル関数
+static double bessel_i0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+
+/// Kaiser 窓の半帯域 sinc を設計し、直流ゲインが正確に 1 になるよう偶数位相の和を 0.5 にそろえる
+static void design_half_band(float *coeffs, int taps, double beta) {
+    int length = 2 * taps - 1;
+    int center = taps - 1;
+    double sum = 0;
+    double h[kMaxTaps];
+    for (int i = 0; i < taps; i++) {
+        int n = 2 * i;
+        double offset = (double)(n - center);
+        double sinc = sin(M_PI * offset / 2.0) / (M_PI * offset);
+        double ratio = 2.0 * n / (length - 1) - 1.0;
+        double window = bessel_i0(beta * sqrt(fmax(0.0, 1.0 - ratio * ratio))) / bessel_i0(beta);
+        h[i] = sinc * window;
+        sum += h[i];
+    }
+    for (int j = 0; j < taps; j++) {
+        coeffs[j] = (float)(h[taps - 1 - j] * 0.5 / sum);
+    }
+}
+
+static int half_band_init(VCHalfBand *halfBand, int taps, double beta, int maxInput) {
+    halfBand->taps = taps;
+    halfBand->delay = (taps - 2) / 2;
+    halfBand->maxInput = maxInput;
+    halfBand->coeffs = vc_calloc((size_t)taps, sizeof(float));
+    halfBand->upBuffer = vc_calloc((size_t)(taps - 1 + maxInput), sizeof(float));
+    halfBand->evenBuffer = vc_calloc((size_t)(taps - 1 + maxInput), sizeof(float));
+    halfBand->oddBuffer = vc_calloc((size_t)(halfBand->delay + 1 + maxInput), sizeof(float));
+    if (halfBand->coeffs == NULL || halfBand->upBuffer == NULL ||
+        halfBand->evenBuffer == NULL || halfBand->oddBuffer == NULL) {
+        return -1;
+    }
+    design_half_band(halfBand->coeffs, taps, beta);
+    return 0;
+}
+
+static void half_band_free(VCHalfBand *halfBand) {
+    vc_free(halfBand->coeffs);
+    vc_free(halfBand->upBuffer);
+    vc_free(halfBand->evenBuffer);
+    vc_free(halfBand->oddBuffer);
+}
+
+static void half_band_reset(VCHalfBand *halfBand) {
+    memset(halfBand->upBuffer, 0, (size_t)(halfBand->taps - 1) * sizeof(float));
+    memset(halfBand->evenBuffer, 0, (size_t)(halfBand->taps - 1) * sizeof(float));
+    memset(halfBand->oddBuffer, 0, (size_t)(halfBand->delay + 1) * sizeof(float));
+}
+
+#pragma mark - Polyphase Kernels
+
+/// output[m * stride] = scale * Σ_j coeffs[j] * buffer[m + j]（m = 0..<count）
+static void fir_branch(const float *buffer, const float *coeffs, int taps, float scale,
+                       float *output, int stride, int count) {
+    int m = 0;
+#if VC_HAS_VECTOR_EXT
+    // 出力 4 サンプルを 1 ベクタにして、係数ごとにずらした入力を積和する
+    for (; m + 4 <= count; m += 4) {
+        vc_f32x4 acc = vc_splat4(0.0f);
+        for (int j = 0; j < taps; j++) {
+            acc += vc_splat4(coeffs[j]) * vc_load4(buffer + m + j);
+        }
+        acc *= vc_splat4(scale);
+        output[(m + 0) * stride] = acc[0];
+        output[(m + 1) * stride] = acc[1];
+        output[(m + 2) * stride] = acc[2];
+        output[(m + 3) * stride] = acc[3];
+    }
+#endif
+    for (; m < count; m++) {
+        float acc = 0;
+        for (int j = 0; j < taps; j++) {
+            acc += coeffs[j] * buffer[m + j];
+        }
+        output[m * stride] = scale * acc;
+    }
+}
+
+/// 2 倍に補間（input count → output 2 * count）
+static void half_band_up(VCHalfBand *halfBand, const float *input, float *output, int count) {
+    const int history = halfBand->taps - 1;
+    float *buffer = halfBand->upBuffer;
+    memcpy(buffer + history, input, (size_t)count * sizeof(float));
+
+    // 偶数位相: ゼロ挿入で半分になった振幅を 2 倍して戻す
+    fir_branch(buffer, halfBand->coeffs, halfBand->taps, 2.0f, output, 2, count);
+    // 奇数位相: 中央タップ（2 * 0.5）だけなので遅延した入力そのもの
+    const float *delayed = buffer + history - halfBand->delay;
+    for (int m = 0; m < count; m++) {
+        output[2 * m + 1] = delayed[m];
+    }
+
+    memmove(buffer, buffer + count, (size_t)history * sizeof(float));
+}
+
+/// 1/2 に間引き（input 2 * count → output count）
+static void half_band_down(VCHalfBand *halfBand, const float *input, float *output, int count) {
+    const int history = halfBand->taps - 1;
+    const int oddHistory = halfBand->delay + 1;
+    float *even = halfBand->evenBuffer + history;
+    float *odd = halfBand->oddBuffer + oddHistory;
+    for (int m = 0; m < count; m++) {
+        even[m] = input[2 * m];
+        odd[m] = input[2 * m + 1];
+    }
+
+    fir_branch(halfBand->evenBuffer, halfBand->coeffs, halfBand->taps, 1.0f, output, 1, count);
+    for (int m = 0; m < count; m++) {
+        output[m] += 0.5f * halfBand->oddBuffer[m];
+    }
+
+    memmove(halfBand->evenBuffer, halfBand->evenBuffer + count, (size_t)history * sizeof(float));
+    memmove(halfBand->oddBuffer, halfBand->oddBuffer + count, (size_t)oddHistory * sizeof(float));
+}
+
+#pragma mark - Lifecycle
+
+VCOversampler *vc_oversampler_create(int factor, int maxFrames) {
+    if ((factor != 1 && factor != 2 && factor != 4) || maxFrames <= 0) {
+        return NULL;
+    }
+    VCOversampler *oversampler = vc_calloc(1, sizeof(VCOversampler));
+    if (oversampler == NULL) {
+        return NULL;
+    }
+    oversampler->factor = factor;
+    oversampler->stages = factor == 4 ? 2 : factor == 2 ? 1 : 0;
+    oversampler->maxFrames = maxFrames;
+
+    int failed = 0;
+    static const int kTaps[kMaxStages] = { kFirstStageTaps, kSecondStageTaps };
+    static const double kBetas[kMaxStages] = { kFirstStageBeta, kSecondStageBeta };
+    for (int stage = 0; stage < oversampler->stages; stage++) {
+        failed |= half_band_init(&oversampler->halfBands[stage], kTaps[stage], kBetas[stage], maxFrames << stage);
+    }
+    for (int stage = 1; stage <= oversampler->stages; stage++) {
+        oversampler->buffers[stage] = vc_calloc((size_t)maxFrames << stage, sizeof(float));
+        failed |= oversampler->buffers[stage] == NULL;
+    }
+    if (oversampler->stages == 0) {
+        oversampler->buffers[0] = vc_calloc((size_t)maxFrames, sizeof(float));
+        failed |= oversampler->buffers[0] == NULL;
+    }
+    if (failed) {
+        vc_oversampler_destroy(oversampler);
+        return NULL;
+    }
+    return oversampler;
+}
+
+void vc_oversampler_destroy(VCOversampler *oversampler) {
+    if (oversampler == NULL) {
+        return;
+    }
+    for (int stage = 0; stage < oversampler->stages; stage++) {
+        half_band_free(&oversampler->halfBands[stage]);
+    }
+    for (int i = 0; i <= kMaxStages; i++) {
+        vc_free(oversampler->buffers[i]);
+    }
+    vc_free(oversampler);
+}
+
+int vc_oversampler_factor(const VCOversampler *oversampler) {
+    return oversampler->factor;
+}
+
+float vc_oversampler_latency(const VCOversampler *oversampler) {
+    // 各段の補間・間引きはどちらも高いほうのレートで D サンプル遅れる（往復で低いほうのレートの D サンプル）
+    float latency = 0;
+    float scale = 1.0f;
+    for (int stage = 0; stage < oversampler->stages; stage++) {
+        latency += (float)(oversampler->halfBands[stage].taps - 1) * scale;
+        scale *= 0.5f;
+    }
+    return latency;
+}
+
+void vc_oversampler_reset(VCOversampler *oversampler) {
+    for (int stage = 0; stage < oversampler->stages; stage++) {
+        half_band_reset(&oversampler->halfBands[stage]);
+    }
+}
+
+#pragma mark - Processing
+
+float *vc_oversampler_upsample(VCOversampler *oversampler, const float *input, int count) {
+    if (count <= 0 || count > oversampler->maxFrames) {
+        return NULL;
+    }
+    if (oversampler->stages == 0) {
+        memcpy(oversampler->buffers[0], input, (size_t)count * sizeof(float));
+        return oversampler->buffers[0];
+    }
+
+    const float *source = input;
+    for (int stage = 0; stage < oversampler->stages; stage++) {
+        half_band_up(&oversampler->halfBands[stage], source, oversampler->buffers[stage + 1], count << stage);
+        source = oversampler->buffers[stage + 1];
+    }
+    return oversampler->buffers[oversampler->stages];
+}
+
+void vc_oversampler_downsample(VCOversampler *oversampler, float *output, int count) {
+    if (count <= 0 || count > oversampler->maxFrames) {
+        return;
+    }
+    if (oversampler->stages == 0) {
+        memcpy(output, oversampler->buffers[0], (size_t)count * sizeof(float));
+        return;
+    }
+
+    // 高いレートから順に間引く（途中の段は補間で使った領域の前半へ書く）
+    for (int stage = oversampler->stages - 1; stage >= 0; stage--) {
+        float *destination = stage == 0 ? output : oversampler->buffers[stage];
+        half_band_down(&oversampler->halfBands[stage], oversampler->buffers[stage + 1], destination, count << stage);
+    }
+}
@@ -0,0 +1,378 @@
+//
+//  VCPitch.c
+//  VoiceChanger
+//
+//  Streaming f0 tracker (YIN with an incrementally updated difference function) and delay-line pitch shifter
+//
+
+#include "include/VCPitch.h"
+#include "include/VCBiquad.h"
+#include "include/VCFastMath.h"
+#include "VCSimd.h"
+#include "VCAlloc.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define kAnalysisRate       12000.0f    // 間引き後のおおよそのレート
+#define kThreshold          0.15f       // YIN の絶対閾値
+#define kUnvoicedThreshold  0.35f       // 閾値を下回らなくても、最小値がこれ未満なら低信頼の有声
+#define kEnergyFloor        1e-7f       // 窓の平均パワーがこれ以下なら無声（-70 dBFS）
+#define kRefreshLags        16          // ブロックごとに窓から計算し直すラグ数
+#define kChunk              256
+
+struct VCPitchTracker {
+    float sampleRate;
+    int decimation;
+    float rate;             // 間引き後のレート
+    int minLag;
+    int maxLag;
+    int window;             // W（積分窓）
+    int span;               // W + maxLag + 1（保持する間引き後サンプル数）
+
+    // 間引き用ローパス（4次 Butterworth）
+    VCBiquadCoeffs lowpass[2];
+    VCBiquadState lowpassState[2];
+    int phase;              // 次に拾う入力サンプルまでの残り
+    float scratch[kChunk];
+
+    // 2倍長のリング（同じ値を pos と pos + ringSize に書き、常に連続で読めるようにする）
+    float *ring;
+    int ringSize;
+    int ringPos;            // 次の書き込み位置
+    long filled;            // 取り込んだ間引き後サンプル数
+
+    float *correlation;     // r(τ) = Σ_{j ∈ 窓} x_j x_{j+τ}, τ = 0..maxLag
+    float *prefix;          // 二乗の累積和 [span + 1]
+    float *difference;      // CMNDF [maxLag + 1]
+    int refreshLag;
+
+    VCPitchEstimate estimate;
+};
+
+#pragma mark - Lifecycle
+
+VCPitchTracker *vc_pitch_create(int sampleRate, float minHz, float maxHz) {
+    if (sampleRate <= 0) {
+        return NULL;
+    }
+    if (!(minHz > 20.0f) || !(maxHz > minHz)) {
+        minHz = VC_PITCH_DEFAULT_MIN_HZ;
+        maxHz = VC_PITCH_DEFAULT_MAX_HZ;
+    }
+
+    VCPitchTracker *tracker = vc_calloc(1, sizeof(VCPitchTracker));
+    if (tracker == NULL) {
+        return NULL;
+    }
+
+    tracker->sampleRate = (float)sampleRate;
+    tracker->decimation = (int)lroundf((float)sampleRate / kAnalysisRate);
+    if (tracker->decimation < 1) {
+        tracker->decimation = 1;
+    }
+    tracker->rate = tracker->sampleRate / (float)tracker->decimation;
+    maxHz = fminf(maxHz, tracker->rate / 4.0f);
+
+    tracker->minLag = (int)floorf(tracker->rate / maxHz);
+    if (tracker->minLag < 2) {
+        tracker->minLag = 2;
+    }
+    tracker->maxLag = (int)ceilf(tracker->rate / minHz) + 1;
+    tracker->window = tracker->maxLag;
+    tracker->span = tracker->window + tracker->maxLag + 1;
+
+    tracker->ringSize = 1;
+    while (tracker->ringSize < tracker->span) {
+        tracker->ringSize <<= 1;
+    }
+
+    tracker->ring = vc_calloc((size_t)tracker->ringSize * 2, sizeof(float));
+    tracker->correlation = vc_calloc((size_t)tracker->maxLag + 4, sizeof(float));
+    tracker->prefix = vc_calloc((size_t)tracker->span + 1, sizeof(float));
+    tracker->difference = vc_calloc((size_t)tracker->maxLag + 1, sizeof(float));
+    if (tracker->ring == NULL || tracker->correlation == NULL || tracker->prefix == NULL ||
+        tracker->difference == NULL) {
+        vc_pitch_destroy(tracker);
+        return NULL;
+    }
+
+    // 間引き後のナイキストの 75% で遮断（Butterworth 4次 = Q 0.541 / 1.307）
+    float cutoff = 0.375f * tracker->rate;
+    vc_biquad_set_lowpass(&tracker->lowpass[0], cutoff, 0.5412f, tracker->sampleRate);
+    vc_biquad_set_lowpass(&tracker->lowpass[1], cutoff, 1.3066f, tracker->sampleRate);
+
+    vc_pitch_reset(tracker);
+    return tracker;
+}
+
+void vc_pitch_destroy(VCPitchTracker *tracker) {
+    if (tracker == NULL) {
+        return;
+    }
+    vc_free(tracker->ring);
+    vc_free(tracker->correlation);
+    vc_free(tracker->prefix);
+    vc_free(tracker->difference);
+    vc_free(tracker);
+}
+
+void vc_pitch_reset(VCPitchTracker *tracker) {
+    vc_biquad_reset(&tracker->lowpassState[0]);
+    vc_biquad_reset(&tracker->lowpassState[1]);
+    tracker->phase = 0;
+    memset(tracker->ring, 0, (size_t)tracker->ringSize * 2 * sizeof(float));
+    memset(tracker->correlation, 0, ((size_t)tracker->maxLag + 4) * sizeof(float));
+    tracker->ringPos = 0;
+    tracker->filled = 0;
+    tracker->refreshLag = 0;
+    memset(&tracker->estimate, 0, sizeof(tracker->estimate));
+}
+
+int vc_pitch_latency(const VCPitchTracker *tracker) {
+    return (tracker->span / 2) * tracker->decimation;
+}
+
+#pragma mark - Difference Function
+
+/// 保持している span サンプル（古い順）の先頭
+static inline const float *history(const VCPitchTracker *tracker) {
+    int start = tracker->ringPos - tracker->span;
+    if (start < 0) {
+        start += tracker->ringSize;
+    }
+    return tracker->ring + start;
+}
+
+/// 間引き後の1サンプルを取り込み、r(τ) を差分更新する
+/// 窓 [s, s + W) は1つ進み、x_{s-1} の項が抜けて x_{s+W-1} の項が入る
+static void push_sample(VCPitchTracker *tracker, float sample) {
+    tracker->ring[tracker->ringPos] = sample;
+    tracker->ring[tracker->ringPos + tracker->ringSize] = sample;
+    tracker->ringPos = (tracker->ringPos + 1) & (tracker->ringSize - 1);
+    tracker->filled++;
+
+    const float *x = history(tracker);     // x[0] = 抜ける x_{s-1}、x[span - 1] = 新しいサンプル
+    const float *leaving = x;
+    const float *entering = x + tracker->window;
+    float a = leaving[0];
+    float b = entering[0];
+    float *r = tracker->correlation;
+    int count = tracker->maxLag + 1;
+
+    int tau = 0;
+#if VC_HAS_VECTOR_EXT
+    vc_f32x4 a4 = vc_splat4(a);
+    vc_f32x4 b4 = vc_splat4(b);
+    for (; tau + 4 <= count; tau += 4) {
+        vc_f32x4 update = b4 * vc_load4(entering + tau) - a4 * vc_load4(leaving + tau);
+        vc_store4(r + tau, vc_load4(r + tau) + update);
+    }
+#endif
+    for (; tau < count; tau++) {
+        r[tau] += b * entering[tau] - a * leaving[tau];
+    }
+}
+
+/// 一部のラグを窓から直接計算して差分更新の丸め誤差を捨てる
+static void refresh_correlation(VCPitchTracker *tracker) {
+    const float *x = history(tracker) + 1;  // 窓の先頭 x_s
+    int lags = tracker->maxLag + 1;
+    for (int i = 0; i < kRefreshLags; i++) {
+        int tau = tracker->refreshLag;
+        float sum = 0;
+        for (int j = 0; j < tracker->window; j++) {
+            sum += x[j] * x[j + tau];
+        }
+        tracker->correlation[tau] = sum;
+        tracker->refreshLag = tau + 1 == lags ? 0 : tau + 1;
+    }
+}
+
+/// CMNDF を計算して最良のラグを探す
+static void find_period(VCPitchTracker *tracker) {
+    VCPitchEstimate *estimate = &tracker->estimate;
+    const float *x = history(tracker) + 1;
+    int window = tracker->window;
+    int maxLag = tracker->maxLag;
+
+    // e(τ) = Σ_{j=s+τ}^{s+τ+W-1} x_j^2 を累積和から
+    float *prefix = tracker->prefix;
+    prefix[0] = 0;
+    for (int j = 0; j < window + maxLag; j++) {
+        prefix[j + 1] = prefix[j] + x[j] * x[j];
+    }
+
+    float energy = prefix[window];
+    if (energy < kEnergyFloor * (float)window) {
+        memset(estimate, 0, sizeof(*estimate));
+        return;
+    }
+
+    // d'(τ) = d(τ) τ / Σ_{k<=τ} d(k)、d(τ) = e(0) + e(τ) - 2 r(τ)
+    float *d = tracker->difference;
+    d[0] = 1.0f;
+    float running = 0;
+    for (int tau = 1; tau <= maxLag; tau++) {
+        float shifted = prefix[tau + window] - prefix[tau];
+        float value = fmaxf(0.0f, energy + shifted - 2.0f * tracker->correlation[tau]);
+        running += value;
+        d[tau] = running > 0 ? value * (float)tau / running : 1.0f;
+    }
+
+    // 閾値を下回った最初の谷（なければ全体の最小）
+    int best = -1;
+    for (int tau = tracker->minLag; tau < maxLag; tau++) {
+        if (d[tau] < kThreshold) {
+            while (tau + 1 < maxLag && d[tau + 1] < d[tau]) {
+                tau++;
+            }
+            best = tau;
+            break;
+        }
+    }
+    if (best < 0) {
+        best = tracker->minLag;
+        for (int tau = tracker->minLag + 1; tau < maxLag; tau++) {
+            if (d[tau] < d[best]) {
+                best = tau;
+            }
+        }
+    }
+
+    // 放物線補間
+    float lag = (float)best;
+    float left = d[best - 1], center = d[best], right = d[best + 1];
+    float curvature = left - 2.0f * center + right;
+    if (curvature > 1e-9f) {
+        lag += 0.5f * (left - right) / curvature;
+    }
+
+    estimate->confidence = fmaxf(0.0f, fminf(1.0f, 1.0f - center));
+    estimate->voiced = center < kUnvoicedThreshold;
+    estimate->f0Hz = estimate->voiced ? tracker->rate / lag : 0.0f;
+}
+
+#pragma mark - Processing
+
+void vc_pitch_process(VCPitchTracker *tracker, const float *samples, int count, int search,
+                      VCPitchEstimate *outEstimate) {
+    for (int offset = 0; offset < count; offset += kChunk) {
+        int frames = count - offset < kChunk ? count - offset : kChunk;
+        const float *input = samples + offset;
+        if (tracker->decimation > 1) {
+            vc_biquad_process(&tracker->lowpass[0], &tracker->lowpassState[0], input, tracker->scratch, frames);
+            vc_biquad_process(&tracker->lowpass[1], &tracker->lowpassState[1], tracker->scratch, tracker->scratch, frames);
+            input = tracker->scratch;
+        }
+
+        int i = tracker->phase;
+        for (; i < frames; i += tracker->decimation) {
+            push_sample(tracker, input[i]);
+        }
+        tracker->phase = i - frames;
+    }
+
+    refresh_correlation(tracker);
+
+    if (!search || tracker->filled < tracker->span) {
+        memset(&tracker->estimate, 0, sizeof(tracker->estimate));
+    } else {
+        find_period(tracker);
+    }
+
+    if (outEstimate != NULL) {
+        *outEstimate = tracker->estimate;
+    }
+}
+
+#pragma mark - Shifter
+
+struct VCPitchShifter {
+    float *ring;
+    int mask;
+    int writePos;
+    float window;       // 窓長（サンプル）
+    float phase;        // 0〜1（1 本目の読み出し位置 = phase × window だけ遅れた位置）
+    float step;         // 1 サンプルあたりの phase の変化（(1 - 比) / window）
+};
+
+VCPitchShifter *vc_pitch_shifter_create(int sampleRate, float windowMs) {
+    if (sampleRate <= 0) {
+        return NULL;
+    }
+    if (!(windowMs > 0.0f)) {
+        windowMs = VC_PITCH_SHIFTER_DEFAULT_WINDOW_MS;
+    }
+
+    VCPitchShifter *shifter = vc_calloc(1, sizeof(VCPitchShifter));
+    if (shifter == NULL) {
+        return NULL;
+    }
+    shifter->window = fmaxf(8.0f, roundf(windowMs * (float)sampleRate / 1000.0f));
+
+    // 窓長 + 補間の 1 サンプルが収まる 2 のべき
+    int size = 1;
+    while (size < (int)shifter->window + 2) {
+        size <<= 1;
+    }
+    shifter->ring = vc_calloc((size_t)size, sizeof(float));
+    if (shifter->ring == NULL) {
+        vc_pitch_shifter_destroy(shifter);
+        return NULL;
+    }
+    shifter->mask = size - 1;
+    return shifter;
+}
+
+void vc_pitch_shifter_destroy(VCPitchShifter *shifter) {
+    if (shifter == NULL) {
+        return;
+    }
+    vc_free(shifter->ring);
+    vc_free(shifter);
+}
+
+void vc_pitch_shifter_reset(VCPitchShifter *shifter) {
+    memset(shifter->ring, 0, ((size_t)shifter->mask + 1) * sizeof(float));
+    shifter->writePos = 0;
+    shifter->phase = 0.0f;
+}
+
+void vc_pitch_shifter_set_semitones(VCPitchShifter *shifter, float semitones) {
+    float ratio = vc_fast_exp2f(fmaxf(-24.0f, fminf(24.0f, semitones)) / 12.0f);
+    shifter->step = (1.0f - ratio) / shifter->window;
+}
+
+/// delay サンプル前の値（線形補間）
+static inline float read_delayed(const VCPitchShifter *shifter, float delay) {
+    float position = (float)shifter->writePos - delay;
+    float base = floorf(position);
+    float frac = position - base;
+    int index = (int)base;
+    float a = shifter->ring[index & shifter->mask];
+    float b = shifter->ring[(index + 1) & shifter->mask];
+    return a + frac * (b - a);
+}
+
+void vc_pitch_shifter_process(VCPitchShifter *shifter, const float *input, float *output, int count) {
+    float window = shifter->window;
+    float phase = shifter->phase;
+    for (int i = 0; i < count; i++) {
+        shifter->ring[shifter->writePos & shifter->mask] = input[i];
+
+        float other = phase < 0.5f ? phase + 0.5f : phase - 0.5f;
+        float gain = 1.0f - fabsf(2.0f * phase - 1.0f);     // phase = 0 / 1（折り返し）で 0
+        output[i] = gain * read_delayed(shifter, phase * window) +
+                    (1.0f - gain) * read_delayed(shifter, other * window);
+
+        shifter->writePos = (shifter->writePos + 1) & shifter->mask;
+        phase += shifter->step;
+        phase -= floorf(phase);
+    }
+    shifter->phase = phase;
+}
+
+float vc_pitch_shifter_latency(const VCPitchShifter *shifter) {
+    return 0.5f * shifter->window;
+}
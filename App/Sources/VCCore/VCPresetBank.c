@@ -0,0 +1,577 @@
+//
+//  VCPresetBank.c
+//  VoiceChanger
+//
+//  Memory-mapped binary preset bank with a sorted hash index, and a file watcher for hot reload
+//
+
+#include "include/VCPresetBank.h"
+#include "VCAlloc.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define kSectionAlignment   16
+#define kMaxStringsSize     (64u << 20)
+
+#if defined(__APPLE__)
+#define VC_STAT_MTIME(info) ((info).st_mtimespec)
+#else
+#define VC_STAT_MTIME(info) ((info).st_mtim)
+#endif
+
+_Static_assert(sizeof(VCPresetBankHeader) == 64, "VCPresetBankHeader layout changed");
+_Static_assert(sizeof(VCPresetIndexEntry) == 8, "VCPresetIndexEntry layout changed");
+_Static_assert(sizeof(VCPresetRecord) == 80, "VCPresetRecord layout changed");
+
+struct VCPresetBank {
+    void *mapping;
+    size_t mappingSize;
+    int count;
+    const VCPresetIndexEntry *index;
+    const VCPresetRecord *records;
+    const char *strings;
+    VCChainParams *params;      // 開くときに変換済み
+};
+
+static uint32_t fnv1a(const void *data, size_t size, uint32_t hash) {
+    const uint8_t *bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+uint32_t vc_preset_hash(const char *id) {
+    return fnv1a(id, strlen(id), 2166136261u);
+}
+
+static uint32_t align_up(uint32_t value) {
+    return (value + kSectionAlignment - 1) & ~(uint32_t)(kSectionAlignment - 1);
+}
+
+#pragma mark - Validation
+
+static int finite_in(float value, float lo, float hi) {
+    return isfinite(value) && value >= lo && value <= hi;
+}
+
+/// レコードの値が VoicePreset の範囲に収まっているか（チェーン側でもクランプするが、壊れたファイルを弾く）
+static int valid_record(const VCPresetRecord *record, uint32_t stringsSize) {
+    if (record->idOffset >= stringsSize || record->nameOffset >= stringsSize) {
+        return 0;
+    }
+    if (record->impulseResponseOffset != VC_PRESET_NO_STRING && record->impulseResponseOffset >= stringsSize) {
+        return 0;
+    }
+    if (record->limiterOversampling != 1 && record->limiterOversampling != 2 && record->limiterOversampling != 4) {
+        return 0;
+    }
+    return finite_in(record->pitchShift, -24, 24) &&
+           finite_in(record->formantShift, -1, 1) &&
+           finite_in(record->eqLow, -24, 24) &&
+           finite_in(record->eqMid, -24, 24) &&
+           finite_in(record->eqHigh, -24, 24) &&
+           finite_in(record->noiseSuppressionStrength, 0, 1) &&
+           finite_in(record->agcTargetDb, -60, 0) &&
+           finite_in(record->compressorThresholdDb, -60, 0) &&
+           finite_in(record->compressorRatio, 1, 20) &&
+           finite_in(record->deEsserThresholdDb, -60, 0) &&
+           finite_in(record->deEsserRatio, 1, 20) &&
+           finite_in(record->convolutionMix, 0, 1);
+}
+
+static void decode_record(const VCPresetRecord *record, VCChainParams *params) {
+    vc_chain_params_default(params);
+    params->pitchShift = record->pitchShift;
+    params->formantShift = record->formantShift;
+    params->eqLow = record->eqLow;
+    params->eqMid = record->eqMid;
+    params->eqHigh = record->eqHigh;
+    params->noiseSuppressionEnabled = (record->flags & VC_PRESET_FLAG_NOISE_SUPPRESSION) != 0;
+    params->noiseSuppressionStrength = record->noiseSuppressionStrength;
+    params->agcEnabled = (record->flags & VC_PRESET_FLAG_AGC) != 0;
+    params->agcTargetDb = record->agcTargetDb;
+    params->vadEnabled = (record->flags & VC_PRESET_FLAG_VAD) != 0;
+    params->multibandEnabled = (record->flags & VC_PRESET_FLAG_MULTIBAND) != 0;
+    params->compressorThresholdDb = record->compressorThresholdDb;
+    params->compressorRatio = record->compressorRatio;
+    params->deEsserThresholdDb = record->deEsserThresholdDb;
+    params->deEsserRatio = record->deEsserRatio;
+    params->convolutionMix = record->convolutionMix;
+    params->limiterOversampling = (int)record->limiterOversampling;
+}
+
+static void encode_record(const VCChainParams *params, VCPresetRecord *record) {
+    record->flags = (params->noiseSuppressionEnabled ? VC_PRESET_FLAG_NOISE_SUPPRESSION : 0) |
+                    (params->agcEnabled ? VC_PRESET_FLAG_AGC : 0) |
+                    (params->vadEnabled ? VC_PRESET_FLAG_VAD : 0) |
+                    (params->multibandEnabled ? VC_PRESET_FLAG_MULTIBAND : 0);
+    record->pitchShift = params->pitchShift;
+    record->formantShift = params->formantShift;
+    record->eqLow = params->eqLow;
+    record->eqMid = params->eqMid;
+    record->eqHigh = params->eqHigh;
+    record->noiseSuppressionStrength = params->noiseSuppressionStrength;
+    record->agcTargetDb = params->agcTargetDb;
+    record->compressorThresholdDb = params->compressorThresholdDb;
+    record->compressorRatio = params->compressorRatio;
+    record->deEsserThresholdDb = params->deEsserThresholdDb;
+    record->deEsserRatio = params->deEsserRatio;
+    record->convolutionMix = params->convolutionMix;
+    record->limiterOversampling = (uint32_t)params->limiterOversampling;
+}
+
+/// 索引の順序（hash、同じなら id）
+static int compare_keys(uint32_t hashA, const char *idA, uint32_t hashB, const char *idB) {
+    if (hashA != hashB) {
+        return hashA < hashB ? -1 : 1;
+    }
+    return strcmp(idA, idB);
+}
+
+/// ヘッダから索引・レコード・文字列表まで、ファイル全体を検証する
+static int validate(const uint8_t *bytes, size_t size) {
+    if (size < sizeof(VCPresetBankHeader)) {
+        return 0;
+    }
+    VCPresetBankHeader header;
+    memcpy(&header, bytes, sizeof(header));
+    if (header.magic != VC_PRESET_BANK_MAGIC || header.version != VC_PRESET_BANK_VERSION ||
+        header.recordSize != sizeof(VCPresetRecord) || header.presetCount > VC_PRESET_BANK_MAX_PRESETS ||
+        header.stringsSize == 0 || header.stringsSize > kMaxStringsSize) {
+        return 0;
+    }
+
+    // セクションは決まった順・位置に並ぶ（重なりや隙間を許さない）
+    uint64_t count = header.presetCount;
+    uint64_t indexEnd = (uint64_t)header.indexOffset + count * sizeof(VCPresetIndexEntry);
+    uint64_t recordsEnd = (uint64_t)header.recordsOffset + count * sizeof(VCPresetRecord);
+    uint64_t stringsEnd = (uint64_t)header.stringsOffset + header.stringsSize;
+    if (header.indexOffset != align_up(sizeof(VCPresetBankHeader)) ||
+        header.recordsOffset != align_up((uint32_t)indexEnd) ||
+        header.stringsOffset != align_up((uint32_t)recordsEnd) ||
+        stringsEnd != size) {
+        return 0;
+    }
+    if (fnv1a(bytes + sizeof(header), size - sizeof(header), 2166136261u) != header.checksum) {
+        return 0;
+    }
+
+    // 文字列表の最後が NUL なら、範囲内のどのオフセットから読んでも表の中で終わる
+    const char *strings = (const char *)(bytes + header.stringsOffset);
+    if (strings[header.stringsSize - 1] != '\0') {
+        return 0;
+    }
+
+    const VCPresetRecord *records = (const VCPresetRecord *)(bytes + header.recordsOffset);
+    for (uint32_t i = 0; i < header.presetCount; i++) {
+        if (!valid_record(&records[i], header.stringsSize) || strings[records[i].idOffset] == '\0') {
+            return 0;
+        }
+    }
+
+    // 索引は昇順で重複なし、各レコードをちょうど 1 回ずつ指し、ハッシュが id と一致する
+    const VCPresetIndexEntry *index = (const VCPresetIndexEntry *)(bytes + header.indexOffset);
+    uint8_t *seen = vc_calloc(header.presetCount > 0 ? header.presetCount : 1, 1);
+    if (seen == NULL) {
+        return 0;
+    }
+    int ok = 1;
+    for (uint32_t i = 0; ok && i < header.presetCount; i++) {
+        uint32_t record = index[i].record;
+        if (record >= header.presetCount || seen[record]) {
+            ok = 0;
+            break;
+        }
+        seen[record] = 1;
+        const char *id = strings + records[record].idOffset;
+        if (vc_preset_hash(id) != index[i].hash) {
+            ok = 0;
+            break;
+        }
+        if (i > 0) {
+            const char *previous = strings + records[index[i - 1].record].idOffset;
+            ok = compare_keys(index[i - 1].hash, previous, index[i].hash, id) < 0;
+        }
+    }
+    vc_free(seen);
+    return ok;
+}
+
+#pragma mark - Bank
+
+VCPresetBank *vc_preset_bank_open(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(VCPresetBankHeader)) {
+        close(fd);
+        return NULL;
+    }
+    size_t size = (size_t)info.st_size;
+    void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return NULL;
+    }
+    // 検証で全体を一度読むので先読みさせる
+    posix_madvise(mapping, size, POSIX_MADV_WILLNEED);
+
+    if (!validate(mapping, size)) {
+        munmap(mapping, size);
+        return NULL;
+    }
+
+    VCPresetBankHeader header;
+    memcpy(&header, mapping, sizeof(header));
+    VCPresetBank *bank = vc_calloc(1, sizeof(VCPresetBank));
+    VCChainParams *params = vc_calloc(header.presetCount > 0 ? header.presetCount : 1, sizeof(VCChainParams));
+    if (bank == NULL || params == NULL) {
+        vc_free(bank);
+        vc_free(params);
+        munmap(mapping, size);
+        return NULL;
+    }
+
+    const uint8_t *bytes = mapping;
+    bank->mapping = mapping;
+    bank->mappingSize = size;
+    bank->count = (int)header.presetCount;
+    bank->index = (const VCPresetIndexEntry *)(bytes + header.indexOffset);
+    bank->records = (const VCPresetRecord *)(bytes + header.recordsOffset);
+    bank->strings = (const char *)(bytes + header.stringsOffset);
+    bank->params = params;
+    for (int i = 0; i < bank->count; i++) {
+        decode_record(&bank->records[i], &bank->params[i]);
+    }
+    return bank;
+}
+
+void vc_preset_bank_close(VCPresetBank *bank) {
+    if (bank == NULL) {
+        return;
+    }
+    munmap(bank->mapping, bank->mappingSize);
+    vc_free(bank->params);
+    vc_free(bank);
+}
+
+int vc_preset_bank_count(const VCPresetBank *bank) {
+    return bank->count;
+}
+
+int vc_preset_bank_find(const VCPresetBank *bank, const char *id) {
+    uint32_t hash = vc_preset_hash(id);
+
+    // hash 以上の最初の位置
+    int lo = 0, hi = bank->count;
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (bank->index[mid].hash < hash) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    // 衝突した分だけ id を比べる
+    for (int i = lo; i < bank->count && bank->index[i].hash == hash; i++) {
+        uint32_t record = bank->index[i].record;
+        if (strcmp(bank->strings + bank->records[record].idOffset, id) == 0) {
+            return (int)record;
+        }
+    }
+    return -1;
+}
+
+int vc_preset_bank_get(const VCPresetBank *bank, int index, VCPresetEntry *outEntry) {
+    if (index < 0 || index >= bank->count) {
+        return -1;
+    }
+    const VCPresetRecord *record = &bank->records[index];
+    outEntry->id = bank->strings + record->idOffset;
+    outEntry->name = bank->strings + record->nameOffset;
+    outEntry->impulseResponse = record->impulseResponseOffset == VC_PRESET_NO_STRING
+        ? NULL : bank->strings + record->impulseResponseOffset;
+    outEntry->params = bank->params[index];
+    return 0;
+}
+
+#pragma mark - Writer
+
+typedef struct {
+    uint32_t hash;
+    const char *id;
+    uint32_t record;
+} VCIndexKey;
+
+static int compare_index_keys(const void *a, const void *b) {
+    const VCIndexKey *left = a, *right = b;
+    return compare_keys(left->hash, left->id, right->hash, right->id);
+}
+
+/// 文字列表へ追加してオフセットを返す（同じ文字列も重複して持つ）
+static uint32_t append_string(char *strings, uint32_t *used, const char *value) {
+    uint32_t offset = *used;
+    size_t length = strlen(value) + 1;
+    memcpy(strings + offset, value, length);
+    *used += (uint32_t)length;
+    return offset;
+}
+
+int vc_preset_bank_write(const char *path, const VCPresetEntry *entries, int count) {
+    if (count < 0 || count > VC_PRESET_BANK_MAX_PRESETS) {
+        return -1;
+    }
+
+    uint64_t stringsSize = 1;   // 空の表でも最後を NUL にする
+    for (int i = 0; i < count; i++) {
+        if (entries[i].id == NULL || entries[i].id[0] == '\0' || entries[i].name == NULL) {
+            return -1;
+        }
+        stringsSize += strlen(entries[i].id) + 1 + strlen(entries[i].name) + 1;
+        if (entries[i].impulseResponse != NULL) {
+            stringsSize += strlen(entries[i].impulseResponse) + 1;
+        }
+    }
+    if (stringsSize > kMaxStringsSize) {
+        return -1;
+    }
+
+    VCPresetBankHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = VC_PRESET_BANK_MAGIC;
+    header.version = VC_PRESET_BANK_VERSION;
+    header.presetCount = (uint32_t)count;
+    header.recordSize = sizeof(VCPresetRecord);
+    header.indexOffset = align_up(sizeof(VCPresetBankHeader));
+    header.recordsOffset = align_up(header.indexOffset + (uint32_t)count * (uint32_t)sizeof(VCPresetIndexEntry));
+    header.stringsOffset = align_up(header.recordsOffset + (uint32_t)count * (uint32_t)sizeof(VCPresetRecord));
+    header.stringsSize = (uint32_t)stringsSize;
+    size_t size = (size_t)header.stringsOffset + header.stringsSize;
+
+    uint8_t *bytes = vc_calloc(size, 1);
+    VCIndexKey *keys = vc_calloc(count > 0 ? (size_t)count : 1, sizeof(VCIndexKey));
+    if (bytes == NULL || keys == NULL) {
+        vc_free(bytes);
+        vc_free(keys);
+        return -1;
+    }
+
+    VCPresetRecord *records = (VCPresetRecord *)(bytes + header.recordsOffset);
+    char *strings = (char *)(bytes + header.stringsOffset);
+    uint32_t used = 0;
+    for (int i = 0; i < count; i++) {
+        records[i].idOffset = append_string(strings, &used, entries[i].id);
+        records[i].nameOffset = append_string(strings, &used, entries[i].name);
+        records[i].impulseResponseOffset = entries[i].impulseResponse != NULL
+            ? append_string(strings, &used, entries[i].impulseResponse) : VC_PRESET_NO_STRING;
+        encode_record(&entries[i].params, &records[i]);
+        keys[i] = (VCIndexKey){ vc_preset_hash(entries[i].id), entries[i].id, (uint32_t)i };
+    }
+
+    int status = 0;
+    qsort(keys, (size_t)count, sizeof(VCIndexKey), compare_index_keys);
+    VCPresetIndexEntry *index = (VCPresetIndexEntry *)(bytes + header.indexOffset);
+    for (int i = 0; i < count; i++) {
+        if (i > 0 && compare_index_keys(&keys[i - 1], &keys[i]) == 0) {
+            status = -1;    // id の重複
+        }
+        index[i] = (VCPresetIndexEntry){ keys[i].hash, keys[i].record };
+    }
+    header.checksum = fnv1a(bytes + sizeof(header), size - sizeof(header), 2166136261u);
+    memcpy(bytes, &header, sizeof(header));
+
+    if (status == 0) {
+        // 一時ファイルに書き切ってから置き換える
+        size_t pathLength = strlen(path);
+        char *temporary = vc_malloc(pathLength + 32);
+        if (temporary == NULL) {
+            status = -1;
+        } else {
+            snprintf(temporary, pathLength + 32, "%s.tmp%ld", path, (long)getpid());
+            FILE *file = fopen(temporary, "wb");
+            status = file != NULL && fwrite(bytes, 1, size, file) == size ? 0 : -1;
+            if (file != NULL && fclose(file) != 0) {
+                status = -1;
+            }
+            if (status == 0 && rename(temporary, path) != 0) {
+                status = -1;
+            }
+            if (status != 0) {
+                remove(temporary);
+            }
+            vc_free(temporary);
+        }
+    }
+
+    vc_free(bytes);
+    vc_free(keys);
+    return status;
+}
+
+#pragma mark - Watcher
+
+typedef struct {
+    int exists;
+    dev_t device;
+    ino_t inode;
+    off_t size;
+    struct timespec modified;
+} VCFileStamp;
+
+struct VCPresetBankWatcher {
+    char *path;
+    int intervalMs;
+    VCPresetBankCallback callback;
+    void *context;
+
+    _Atomic(VCPresetBank *) pending;
+    _Atomic uint64_t rejected;
+    VCFileStamp stamp;          // 監視スレッドのみが触る
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wakeCond;
+    int shuttingDown;
+};
+
+static VCFileStamp file_stamp(const char *path) {
+    VCFileStamp stamp;
+    memset(&stamp, 0, sizeof(stamp));
+    struct stat info;
+    if (stat(path, &info) == 0) {
+        stamp.exists = 1;
+        stamp.device = info.st_dev;
+        stamp.inode = info.st_ino;
+        stamp.size = info.st_size;
+        stamp.modified = VC_STAT_MTIME(info);
+    }
+    return stamp;
+}
+
+static int same_stamp(const VCFileStamp *a, const VCFileStamp *b) {
+    return a->exists == b->exists && a->device == b->device && a->inode == b->inode && a->size == b->size &&
+           a->modified.tv_sec == b->modified.tv_sec && a->modified.tv_nsec == b->modified.tv_nsec;
+}
+
+/// 変わっていれば開いて検証し、受け渡し口に置く
+static void watcher_check(VCPresetBankWatcher *watcher) {
+    VCFileStamp stamp = file_stamp(watcher->path);
+    if (same_stamp(&stamp, &watcher->stamp)) {
+        return;
+    }
+    watcher->stamp = stamp;
+    if (!stamp.exists) {
+        return;     // 削除・置き換え途中。現れたら読み込む
+    }
+
+    VCPresetBank *bank = vc_preset_bank_open(watcher->path);
+    if (bank == NULL) {
+        atomic_fetch_add_explicit(&watcher->rejected, 1, memory_order_relaxed);
+        return;
+    }
+    VCPresetBank *stale = atomic_exchange_explicit(&watcher->pending, bank, memory_order_acq_rel);
+    vc_preset_bank_close(stale);
+    if (watcher->callback != NULL) {
+        watcher->callback(watcher->context);
+    }
+}
+
+static void *watcher_main(void *arg) {
+    VCPresetBankWatcher *watcher = (VCPresetBankWatcher *)arg;
+    pthread_mutex_lock(&watcher->lock);
+    while (!watcher->shuttingDown) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += watcher->intervalMs / 1000;
+        deadline.tv_nsec += (long)(watcher->intervalMs % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec += 1;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        int result = pthread_cond_timedwait(&watcher->wakeCond, &watcher->lock, &deadline);
+        if (watcher->shuttingDown) {
+            break;
+        }
+        if (result == ETIMEDOUT) {
+            pthread_mutex_unlock(&watcher->lock);
+            watcher_check(watcher);
+            pthread_mutex_lock(&watcher->lock);
+        }
+    }
+    pthread_mutex_unlock(&watcher->lock);
+    return NULL;
+}
+
+VCPresetBankWatcher *vc_preset_bank_watcher_create(const char *path, int intervalMs,
+                                                   VCPresetBankCallback callback, void *context) {
+    if (path == NULL || intervalMs <= 0) {
+        return NULL;
+    }
+    VCPresetBankWatcher *watcher = vc_calloc(1, sizeof(VCPresetBankWatcher));
+    if (watcher == NULL) {
+        return NULL;
+    }
+    size_t length = strlen(path) + 1;
+    watcher->path = vc_malloc(length);
+    if (watcher->path == NULL) {
+        vc_free(watcher);
+        return NULL;
+    }
+    memcpy(watcher->path, path, length);
+    watcher->intervalMs = intervalMs;
+    watcher->callback = callback;
+    watcher->context = context;
+    atomic_init(&watcher->pending, NULL);
+    atomic_init(&watcher->rejected, 0);
+    watcher->stamp = file_stamp(path);
+
+    pthread_mutex_init(&watcher->lock, NULL);
+    pthread_cond_init(&watcher->wakeCond, NULL);
+    if (pthread_create(&watcher->thread, NULL, watcher_main, watcher) != 0) {
+        pthread_cond_destroy(&watcher->wakeCond);
+        pthread_mutex_destroy(&watcher->lock);
+        vc_free(watcher->path);
+        vc_free(watcher);
+        return NULL;
+    }
+    return watcher;
+}
+
+void vc_preset_bank_watcher_destroy(VCPresetBankWatcher *watcher) {
+    if (watcher == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&watcher->lock);
+    watcher->shuttingDown = 1;
+    pthread_cond_signal(&watcher->wakeCond);
+    pthread_mutex_unlock(&watcher->lock);
+    pthread_join(watcher->thread, NULL);
+
+    vc_preset_bank_close(atomic_load_explicit(&watcher->pending, memory_order_acquire));
+    pthread_cond_destroy(&watcher->wakeCond);
+    pthread_mutex_destroy(&watcher->lock);
+    vc_free(watcher->path);
+    vc_free(watcher);
+}
+
+VCPresetBank *vc_preset_bank_watcher_take(VCPresetBankWatcher *watcher) {
+    return atomic_exchange_explicit(&watcher->pending, NULL, memory_order_acq_rel);
+}
+
+uint64_t vc_preset_bank_watcher_rejected(const VCPresetBankWatcher *watcher) {
+    return atomic_load_explicit(&watcher->rejected, memory_order_relaxed);
+}
@@ -0,0 +1,336 @@
+//
+//  VCSharedRing.c
+//  VoiceChanger
+//
+//  Zero-copy SPSC float ring laid out in caller-provided memory, so the
+//  same core serves in-process rings and the App <-> Driver shared memory
+//
+
+#include "include/VCSharedRing.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+#define kCacheLineSize 64
+
+// 別プロセスからも同じアドレス非依存のアトミック操作でアクセスする
+typedef struct {
+    // メタ情報（作成側が1度だけ書く。state / heartbeat のみ producer が更新）
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sampleRate;
+    uint32_t frameSize;
+    uint32_t capacity;
+    _Atomic uint32_t state;
+    _Atomic uint32_t generation;
+    _Atomic uint32_t heartbeat;
+    uint8_t pad0[kCacheLineSize - 8 * sizeof(uint32_t)];
+
+    _Atomic uint32_t writeIndex;
+    uint8_t pad1[kCacheLineSize - sizeof(uint32_t)];
+
+    // consumer が受け渡した位置と時刻（deliverySequence が奇数の間は書き換え中）
+    _Atomic uint32_t readIndex;
+    _Atomic uint32_t deliverySequence;
+    _Atomic uint64_t deliveryHostTime;
+    _Atomic uint32_t deliveryIndex;
+    uint8_t pad2[kCacheLineSize - 4 * sizeof(uint32_t) - sizeof(uint64_t)];
+} VCSharedRingHeader;
+
+_Static_assert(sizeof(VCSharedRingHeader) == VC_SHARED_RING_HEADER_SIZE, "shared ring header layout");
+_Static_assert(sizeof(_Atomic uint32_t) == sizeof(uint32_t), "shared ring atomics must be plain words");
+_Static_assert(sizeof(_Atomic uint64_t) == sizeof(uint64_t) && ATOMIC_LLONG_LOCK_FREE == 2,
+               "shared ring 64-bit atomics must be lock-free plain words");
+
+static inline VCSharedRingHeader *header_of(const VCSharedRing *ring) {
+    return (VCSharedRingHeader *)ring->header;
+}
+
+static inline int is_pow2(int value) {
+    return value > 0 && (value & (value - 1)) == 0;
+}
+
+static void make_regions(const VCSharedRing *ring, uint32_t index, int count, VCRingRegions *outRegions) {
+    uint32_t start = index & (ring->capacity - 1);
+    uint32_t firstCount = ring->capacity - start;
+    if (firstCount > (uint32_t)count) {
+        firstCount = (uint32_t)count;
+    }
+
+    outRegions->first = ring->samples + start;
+    outRegions->firstCount = (int)firstCount;
+    outRegions->second = count > (int)firstCount ? ring->samples : NULL;
+    outRegions->secondCount = count - (int)firstCount;
+}
+
+#pragma mark - Setup
+
+size_t vc_shared_ring_size(int capacity) {
+    return VC_SHARED_RING_HEADER_SIZE + (size_t)capacity * sizeof(float);
+}
+
+int vc_shared_ring_format(VCSharedRing *ring, void *memory, size_t size,
+                          int sampleRate, int frameSize, int capacity) {
+    if (memory == NULL || !is_pow2(capacity) || size < vc_shared_ring_size(capacity)) {
+        return -1;
+    }
+
+    VCSharedRingHeader *header = (VCSharedRingHeader *)memory;
+    // 接続中の相手が作り直しを検出できるよう、世代を前の値の次にする（作成中は 0）
+    uint32_t generation = header->magic == VC_SHARED_RING_MAGIC ? atomic_load(&header->generation) + 1 : 1;
+    if (generation == 0) {
+        generation = 1;
+    }
+    atomic_store(&header->generation, 0);
+    atomic_thread_fence(memory_order_release);
+
+    memset(header, 0, sizeof(*header));
+    header->version = VC_SHARED_RING_VERSION;
+    header->sampleRate = (uint32_t)sampleRate;
+    header->frameSize = (uint32_t)frameSize;
+    header->capacity = (uint32_t)capacity;
+    atomic_store(&header->state, 0);
+    atomic_store(&header->writeIndex, 0);
+    atomic_store(&header->readIndex, 0);
+    atomic_store(&header->heartbeat, 0);
+    atomic_store(&header->generation, generation);
+
+    // magic は最後に書く（接続側は magic を見てから他を読む）
+    atomic_thread_fence(memory_order_release);
+    header->magic = VC_SHARED_RING_MAGIC;
+
+    ring->header = header;
+    ring->samples = (float *)((uint8_t *)memory + VC_SHARED_RING_HEADER_SIZE);
+    ring->capacity = (unsigned int)capacity;
+    return 0;
+}
+
+int vc_shared_ring_attach(VCSharedRing *ring, void *memory, size_t size) {
+    if (memory == NULL || size < VC_SHARED_RING_HEADER_SIZE) {
+        return -1;
+    }
+
+    VCSharedRingHeader *header = (VCSharedRingHeader *)memory;
+    if (header->magic != VC_SHARED_RING_MAGIC || header->version != VC_SHARED_RING_VERSION) {
+        return -1;
+    }
+    atomic_thread_fence(memory_order_acquire);
+
+    int capacity = (int)header->capacity;
+    if (!is_pow2(capacity) || size < vc_shared_ring_size(capacity)) {
+        return -1;
+    }
+
+    ring->header = header;
+    ring->samples = (float *)((uint8_t *)memory + VC_SHARED_RING_HEADER_SIZE);
+    ring->capacity = (unsigned int)capacity;
+    return 0;
+}
+
+int vc_shared_ring_reclaim(VCSharedRing *ring, void *memory, size_t size,
+                           int sampleRate, int frameSize, int capacity) {
+    if (memory == NULL || !is_pow2(capacity) || size < vc_shared_ring_size(capacity)) {
+        return -1;
+    }
+
+    VCSharedRing existing;
+    if (vc_shared_ring_attach(&existing, memory, size) == 0) {
+        VCSharedRingHeader *header = header_of(&existing);
+        if (header->capacity == (uint32_t)capacity && header->sampleRate == (uint32_t)sampleRate &&
+            header->frameSize == (uint32_t)frameSize && atomic_load(&header->generation) != 0) {
+            // 前の producer が稼働中のまま落ちていても、再開するまでは非稼働にしておく
+            atomic_store_explicit(&header->state, 0, memory_order_release);
+            *ring = existing;
+            return 1;
+        }
+    }
+
+    return vc_shared_ring_format(ring, memory, size, sampleRate, frameSize, capacity) == 0 ? 0 : -1;
+}
+
+int vc_shared_ring_sample_rate(const VCSharedRing *ring) {
+    return (int)header_of(ring)->sampleRate;
+}
+
+int vc_shared_ring_frame_size(const VCSharedRing *ring) {
+    return (int)header_of(ring)->frameSize;
+}
+
+void vc_shared_ring_set_active(VCSharedRing *ring, int active) {
+    atomic_store_explicit(&header_of(ring)->state, active ? 1u : 0u, memory_order_release);
+}
+
+int vc_shared_ring_is_active(const VCSharedRing *ring) {
+    return atomic_load_explicit(&header_of(ring)->state, memory_order_acquire) == 1;
+}
+
+#pragma mark - Liveness
+
+uint32_t vc_shared_ring_generation(const VCSharedRing *ring) {
+    return atomic_load_explicit(&header_of(ring)->generation, memory_order_acquire);
+}
+
+void vc_shared_ring_heartbeat(VCSharedRing *ring) {
+    // 書き込むのは producer だけなので読み出して足すだけでよい
+    VCSharedRingHeader *header = header_of(ring);
+    uint32_t beat = atomic_load_explicit(&header->heartbeat, memory_order_relaxed);
+    atomic_store_explicit(&header->heartbeat, beat + 1, memory_order_release);
+}
+
+void vc_shared_ring_watch_init(VCSharedRingWatch *watch, const VCSharedRing *ring,
+                               uint64_t now, uint64_t timeout) {
+    VCSharedRingHeader *header = header_of(ring);
+    watch->generation = atomic_load_explicit(&header->generation, memory_order_acquire);
+    watch->heartbeat = atomic_load_explicit(&header->heartbeat, memory_order_acquire);
+    watch->lastBeat = now;
+    watch->timeout = timeout;
+}
+
+VCSharedRingPeer vc_shared_ring_watch_check(VCSharedRingWatch *watch, const VCSharedRing *ring,
+                                            uint64_t now) {
+    VCSharedRingHeader *header = header_of(ring);
+    if (atomic_load_explicit(&header->generation, memory_order_acquire) != watch->generation) {
+        return VC_SHARED_RING_PEER_REPLACED;
+    }
+
+    uint32_t beat = atomic_load_explicit(&header->heartbeat, memory_order_acquire);
+    uint32_t state = atomic_load_explicit(&header->state, memory_order_acquire);
+    if (beat != watch->heartbeat || state != 1) {
+        watch->heartbeat = beat;
+        watch->lastBeat = now;
+        return VC_SHARED_RING_PEER_ALIVE;
+    }
+    return now - watch->lastBeat > watch->timeout ? VC_SHARED_RING_PEER_STALLED : VC_SHARED_RING_PEER_ALIVE;
+}
+
+#pragma mark - Indices
+
+int vc_shared_ring_available_read(const VCSharedRing *ring) {
+    VCSharedRingHeader *header = header_of(ring);
+    uint32_t writeIndex = atomic_load_explicit(&header->writeIndex, memory_order_acquire);
+    uint32_t readIndex = atomic_load_explicit(&header->readIndex, memory_order_acquire);
+    return (int)(writeIndex - readIndex);
+}
+
+int vc_shared_ring_available_write(const VCSharedRing *ring) {
+    return (int)ring->capacity - vc_shared_ring_available_read(ring);
+}
+
+void vc_shared_ring_indices(const VCSharedRing *ring, uint32_t *outWriteIndex, uint32_t *outReadIndex) {
+    VCSharedRingHeader *header = header_of(ring);
+    *outWriteIndex = atomic_load_explicit(&header->writeIndex, memory_order_acquire);
+    *outReadIndex = atomic_load_explicit(&header->readIndex, memory_order_acquire);
+}
+
+int vc_shared_ring_write_regions(VCSharedRing *ring, int count, VCRingRegions *outRegions) {
+    VCSharedRingHeader *header = header_of(ring);
+    uint32_t writeIndex = atomic_load_explicit(&header->writeIndex, memory_order_relaxed);
+    uint32_t readIndex = atomic_load_explicit(&header->readIndex, memory_order_acquire);
+    int space = (int)(ring->capacity - (writeIndex - readIndex));
+    if (space > (int)ring->capacity) {
+        space = 0;
+    }
+    if (count > space) {
+        count = space;
+    }
+    if (count < 0) {
+        count = 0;
+    }
+
+    make_regions(ring, writeIndex, count, outRegions);
+    return count;
+}
+
+void vc_shared_ring_commit_write(VCSharedRing *ring, int count) {
+    VCSharedRingHeader *header = header_of(ring);
+    uint32_t writeIndex = atomic_load_explicit(&header->writeIndex, memory_order_relaxed);
+    atomic_store_explicit(&header->writeIndex, writeIndex + (uint32_t)count, memory_order_release);
+    vc_shared_ring_heartbeat(ring);
+}
+
+int vc_shared_ring_read_regions(VCSharedRing *ring, int count, VCRingRegions *outRegions) {
+    VCSharedRingHeader *header = header_of(ring);
+    uint32_t readIndex = atomic_load_explicit(&header->readIndex, memory_order_relaxed);
+    uint32_t writeIndex = atomic_load_explicit(&header->writeIndex, memory_order_acquire);
+    int available = (int)(writeIndex - readIndex);
+    // 相手プロセスが壊れたインデックスを書いても範囲外を読まない
+    if (available > (int)ring->capacity) {
+        available = 0;
+    }
+    if (count > available) {
+        count = available;
+    }
+    if (count < 0) {
+        count = 0;
+    }
+
+    make_regions(ring, readIndex, count, outRegions);
+    return count;
+}
+
+void vc_shared_ring_commit_read(VCSharedRing *ring, int count) {
+    VCSharedRingHeader *header = header_of(ring);
+    uint32_t readIndex = atomic_load_explicit(&header->readIndex, memory_order_relaxed);
+    atomic_store_explicit(&header->readIndex, readIndex + (uint32_t)count, memory_order_release);
+}
+
+#pragma mark - Copy
+
+int vc_shared_ring_write(VCSharedRing *ring, const float *samples, int count) {
+    VCRingRegions regions;
+    int granted = vc_shared_ring_write_regions(ring, count, &regions);
+    memcpy(regions.first, samples, (size_t)regions.firstCount * sizeof(float));
+    if (regions.secondCount > 0) {
+        memcpy(regions.second, samples + regions.firstCount, (size_t)regions.secondCount * sizeof(float));
+    }
+    vc_shared_ring_commit_write(ring, granted);
+    return granted;
+}
+
+int vc_shared_ring_read(VCSharedRing *ring, float *samples, int count) {
+    VCRingRegions regions;
+    int granted = vc_shared_ring_read_regions(ring, count, &regions);
+    memcpy(samples, regions.first, (size_t)regions.firstCount * sizeof(float));
+    if (regions.secondCount > 0) {
+        memcpy(samples + regions.firstCount, regions.second, (size_t)regions.secondCount * sizeof(float));
+    }
+    vc_shared_ring_commit_read(ring, granted);
+    return granted;
+}
+
+#pragma mark - Delivery Stamp
+
+void vc_shared_ring_stamp_delivery(VCSharedRing *ring, uint32_t index, uint64_t hostTime) {
+    // 書くのは consumer だけなので、読み手が途中を見たら捨てられるよう前後で番号を進める
+    VCSharedRingHeader *header = header_of(ring);
+    uint32_t sequence = atomic_load_explicit(&header->deliverySequence, memory_order_relaxed);
+    atomic_store_explicit(&header->deliverySequence, sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&header->deliveryIndex, index, memory_order_relaxed);
+    atomic_store_explicit(&header->deliveryHostTime, hostTime, memory_order_relaxed);
+    atomic_store_explicit(&header->deliverySequence, sequence + 2, memory_order_release);
+}
+
+int vc_shared_ring_delivery(const VCSharedRing *ring, uint32_t *outIndex, uint64_t *outHostTime) {
+    VCSharedRingHeader *header = header_of(ring);
+    uint32_t before = atomic_load_explicit(&header->deliverySequence, memory_order_acquire);
+    if (before == 0 || (before & 1u) != 0) {
+        return 0;
+    }
+    uint32_t index = atomic_load_explicit(&header->deliveryIndex, memory_order_relaxed);
+    uint64_t hostTime = atomic_load_explicit(&header->deliveryHostTime, memory_order_relaxed);
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&header->deliverySequence, memory_order_relaxed) != before) {
+        return 0;
+    }
+    *outIndex = index;
+    *outHostTime = hostTime;
+    return 1;
+}
+
+void vc_shared_ring_reset(VCSharedRing *ring) {
+    VCSharedRingHeader *header = header_of(ring);
+    atomic_store(&header->writeIndex, 0);
+    atomic_store(&header->readIndex, 0);
+    atomic_store(&header->deliverySequence, 0);
+}
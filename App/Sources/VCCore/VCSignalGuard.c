@@ -0,0 +1,196 @@
+//
+//  VCSignalGuard.c
+//  VoiceChanger
+//
+//  Signal-health guard: flush-to-zero on the processing thread, NaN/Inf/denormal scan, per-module reset with fade
+//
+
+#include "include/VCSignalGuard.h"
+#include "VCSimd.h"
+#include <string.h>
+
+#define kFadeMs         5.0f    // リセット後のフェードイン（クリックが目立たず、戻りも遅れない長さ）
+
+#define kExponentMask   0x7f800000
+#define kMantissaMask   0x007fffff
+
+#pragma mark - Denormals
+
+// 制御レジスタは組み込み関数・インラインアセンブラで直接読み書きする（ヘッダの intrinsics は使わない）
+#if defined(__x86_64__) || (defined(__i386__) && defined(__SSE__))
+#define VC_HAS_FLUSH_CONTROL 1
+#define kFlushBits      0x8040u     // MXCSR の FTZ（bit 15）と DAZ（bit 6）
+
+static uint64_t read_control(void) {
+    return __builtin_ia32_stmxcsr();
+}
+
+static void write_control(uint64_t value) {
+    __builtin_ia32_ldmxcsr((unsigned int)value);
+}
+#elif defined(__aarch64__)
+#define VC_HAS_FLUSH_CONTROL 1
+#define kFlushBits      (1u << 24)  // FPCR.FZ（arm64 では入力・結果の両方を 0 にする）
+
+static uint64_t read_control(void) {
+    uint64_t value;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(value));
+    return value;
+}
+
+static void write_control(uint64_t value) {
+    __asm__ __volatile__("msr fpcr, %0" : : "r"(value));
+}
+#else
+#define VC_HAS_FLUSH_CONTROL 0
+#endif
+
+int vc_denormals_flush_supported(void) {
+    return VC_HAS_FLUSH_CONTROL;
+}
+
+void vc_denormals_flush_begin(VCDenormalScope *scope) {
+    scope->changed = 0;
+#if VC_HAS_FLUSH_CONTROL
+    // 書き込みはパイプラインを止めるので、すでに有効なスレッドでは読むだけにする
+    scope->saved = read_control();
+    if ((scope->saved & kFlushBits) != kFlushBits) {
+        write_control(scope->saved | kFlushBits);
+        scope->changed = 1;
+    }
+#endif
+}
+
+void vc_denormals_flush_end(const VCDenormalScope *scope) {
+#if VC_HAS_FLUSH_CONTROL
+    if (scope->changed) {
+        write_control(scope->saved);
+    }
+#else
+    (void)scope;
+#endif
+}
+
+void vc_denormals_flush_thread(void) {
+#if VC_HAS_FLUSH_CONTROL
+    write_control(read_control() | kFlushBits);
+#endif
+}
+
+#pragma mark - Scan
+
+static int classify(int32_t bits) {
+    int32_t exponent = bits & kExponentMask;
+    int32_t mantissa = bits & kMantissaMask;
+    if (exponent == kExponentMask) {
+        return mantissa != 0 ? VC_SIGNAL_NAN : VC_SIGNAL_INFINITE;
+    }
+    return exponent == 0 && mantissa != 0 ? VC_SIGNAL_DENORMAL : 0;
+}
+
+int vc_signal_scan(const float *samples, int count) {
+    int i = 0;
+    int flags = 0;
+#if VC_HAS_VECTOR_EXT
+    // 符号を落とした整数として比べる（> 無限大 = NaN、== 無限大、0 < x < 最小の正規化数 = 非正規化数）
+    // レーンごとの比較結果は OR で貯め、ブロックの最後に 1 度だけ見る
+    const vc_i32x4 magnitudeMask = { 0x7fffffff, 0x7fffffff, 0x7fffffff, 0x7fffffff };
+    const vc_i32x4 infinity = { kExponentMask, kExponentMask, kExponentMask, kExponentMask };
+    const vc_i32x4 smallestNormal = { kMantissaMask + 1, kMantissaMask + 1, kMantissaMask + 1, kMantissaMask + 1 };
+    const vc_i32x4 zero = { 0, 0, 0, 0 };
+    vc_i32x4 nan = zero, infinite = zero, denormal = zero;
+    for (; i + 4 <= count; i += 4) {
+        vc_i32x4 bits;
+        memcpy(&bits, samples + i, sizeof(bits));
+        vc_i32x4 magnitude = bits & magnitudeMask;
+        nan |= magnitude > infinity;
+        infinite |= magnitude == infinity;
+        denormal |= (magnitude > zero) & (magnitude < smallestNormal);
+    }
+    flags |= vc_any4(nan) ? VC_SIGNAL_NAN : 0;
+    flags |= vc_any4(infinite) ? VC_SIGNAL_INFINITE : 0;
+    flags |= vc_any4(denormal) ? VC_SIGNAL_DENORMAL : 0;
+#endif
+    for (; i < count; i++) {
+        int32_t bits;
+        memcpy(&bits, samples + i, sizeof(bits));
+        flags |= classify(bits);
+    }
+    return flags;
+}
+
+int vc_signal_sanitize(const float *input, float *output, int count) {
+    int replaced = 0;
+    for (int i = 0; i < count; i++) {
+        int32_t bits;
+        memcpy(&bits, input + i, sizeof(bits));
+        if (classify(bits) != 0) {
+            output[i] = 0.0f;
+            replaced++;
+        } else {
+            output[i] = input[i];
+        }
+    }
+    return replaced;
+}
+
+#pragma mark - Guard
+
+void vc_signal_guard_init(VCSignalGuard *guard, int sampleRate) {
+    memset(guard, 0, sizeof(*guard));
+    guard->fadeLength = (int)(kFadeMs * (float)sampleRate / 1000.0f);
+    guard->fadePosition = guard->fadeLength;
+}
+
+void vc_signal_guard_reset(VCSignalGuard *guard) {
+    guard->fadePosition = guard->fadeLength;
+    guard->muted = 0;
+}
+
+int vc_signal_guard_input(VCSignalGuard *guard, const float *input, float *output, int count) {
+    guard->stats.blocks++;
+    int flags = vc_signal_scan(input, count);
+    if (flags == 0) {
+        return 0;
+    }
+    if (flags & VC_SIGNAL_NON_FINITE) {
+        guard->stats.nonFiniteInputBlocks++;
+    }
+    if (flags & VC_SIGNAL_DENORMAL) {
+        guard->stats.denormalInputBlocks++;
+    }
+    vc_signal_sanitize(input, output, count);
+    return 1;
+}
+
+int vc_signal_guard_check(VCSignalGuard *guard, int module, float *samples, int count) {
+    // 非正規化数は FTZ（使えない環境ではブロック末尾の状態の切り捨て）に任せ、ここでは壊れた値だけを見る
+    if ((vc_signal_scan(samples, count) & VC_SIGNAL_NON_FINITE) == 0) {
+        return 0;
+    }
+    memset(samples, 0, (size_t)count * sizeof(float));
+    guard->muted = 1;
+    guard->stats.resets++;
+    if (module >= 0 && module < VC_SIGNAL_GUARD_MAX_MODULES) {
+        guard->stats.moduleResets[module]++;
+    }
+    return 1;
+}
+
+void vc_signal_guard_finish(VCSignalGuard *guard, float *samples, int count) {
+    if (guard->muted) {
+        // リセットより後段の状態（残響・エンベロープ）が鳴らす分も含めて、このブロックは無音にする
+        memset(samples, 0, (size_t)count * sizeof(float));
+        guard->muted = 0;
+        guard->fadePosition = 0;
+        return;
+    }
+    if (guard->fadePosition >= guard->fadeLength) {
+        return;
+    }
+    float step = 1.0f / (float)guard->fadeLength;
+    int i = 0;
+    for (; i < count && guard->fadePosition < guard->fadeLength; i++, guard->fadePosition++) {
+        samples[i] *= (float)guard->fadePosition * step;
+    }
+}
@@ -0,0 +1,175 @@
+//
+//  VCSimd.h
+//  VoiceChanger
+//
+//  Internal 4-wide float vector helpers (SSE / NEON via compiler vector extensions)
+//
+
+#ifndef VCSimd_h
+#define VCSimd_h
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define VC_HAS_VECTOR_EXT 1
+
+/// 4レーンのfloatベクタ（x86ではSSE、arm64ではNEONにマップされる）
+typedef float vc_f32x4 __attribute__((vector_size(16)));
+typedef int32_t vc_i32x4 __attribute__((vector_size(16)));
+
+static inline vc_f32x4 vc_load4(const float *p) {
+    vc_f32x4 v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void vc_store4(float *p, vc_f32x4 v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+static inline vc_f32x4 vc_splat4(float value) {
+    return (vc_f32x4){ value, value, value, value };
+}
+
+/// mask ? a : b（mask は比較結果の全ビット1/0）
+static inline vc_f32x4 vc_select4(vc_i32x4 mask, vc_f32x4 a, vc_f32x4 b) {
+    return (vc_f32x4)((mask & (vc_i32x4)a) | (~mask & (vc_i32x4)b));
+}
+
+static inline vc_f32x4 vc_abs4(vc_f32x4 v) {
+    return (vc_f32x4)((vc_i32x4)v & (vc_i32x4){ 0x7fffffff, 0x7fffffff, 0x7fffffff, 0x7fffffff });
+}
+
+static inline vc_f32x4 vc_max4(vc_f32x4 a, vc_f32x4 b) {
+    return vc_select4(a > b, a, b);
+}
+
+static inline vc_f32x4 vc_min4(vc_f32x4 a, vc_f32x4 b) {
+    return vc_select4(a < b, a, b);
+}
+
+/// いずれかのレーンでマスクが立っているか
+static inline int vc_any4(vc_i32x4 mask) {
+    return (mask[0] | mask[1] | mask[2] | mask[3]) != 0;
+}
+
+static inline float vc_hsum4(vc_f32x4 v) {
+    return (v[0] + v[1]) + (v[2] + v[3]);
+}
+
+// MARK: - Transcendentals
+// include/VCFastMath.h のスカラー版と同じ式・係数（変えるときは両方。誤差の上限もそちらに書いてある）
+
+/// 最も近い整数（|x| < 2^22、vc_fastmath_round と同じ）
+static inline vc_f32x4 vc_round4(vc_f32x4 x, vc_i32x4 *outInteger) {
+    vc_f32x4 t = x + vc_splat4(12582912.0f);
+    *outInteger = (vc_i32x4)t - 0x4b400000;
+    return t - vc_splat4(12582912.0f);
+}
+
+static inline vc_f32x4 vc_exp_reduced4(vc_f32x4 r) {
+    vc_f32x4 p = vc_splat4(1.9875691500e-4f);
+    p = p * r + vc_splat4(1.3981999507e-3f);
+    p = p * r + vc_splat4(8.3334519073e-3f);
+    p = p * r + vc_splat4(4.1665795894e-2f);
+    p = p * r + vc_splat4(1.6666665459e-1f);
+    p = p * r + vc_splat4(5.0000001201e-1f);
+    return p * r * r + r + vc_splat4(1.0f);
+}
+
+static inline vc_f32x4 vc_exp4(vc_f32x4 x) {
+    x = vc_min4(vc_max4(x, vc_splat4(-87.0f)), vc_splat4(88.0f));
+    vc_i32x4 n;
+    vc_f32x4 fn = vc_round4(x * vc_splat4(1.44269504f), &n);
+    vc_f32x4 r = x - fn * vc_splat4(0.693359375f);
+    r -= fn * vc_splat4(-2.12194440e-4f);
+    return vc_exp_reduced4(r) * (vc_f32x4)((n + 127) << 23);
+}
+
+static inline vc_f32x4 vc_log4(vc_f32x4 x) {
+    x = vc_max4(x, vc_splat4(1.17549435e-38f));
+    vc_i32x4 bits = (vc_i32x4)x;
+    vc_f32x4 e = __builtin_convertvector((bits >> 23) - 126, vc_f32x4);
+    vc_f32x4 m = (vc_f32x4)((bits & 0x007fffff) | 0x3f000000);
+    vc_i32x4 small = m < vc_splat4(0.707106781f);
+    e -= vc_select4(small, vc_splat4(1.0f), vc_splat4(0.0f));
+    m = vc_select4(small, m + m, m) - vc_splat4(1.0f);
+    vc_f32x4 z = m * m;
+    vc_f32x4 p = vc_splat4(7.0376836292e-2f);
+    p = p * m - vc_splat4(1.1514610310e-1f);
+    p = p * m + vc_splat4(1.1676998740e-1f);
+    p = p * m - vc_splat4(1.2420140846e-1f);
+    p = p * m + vc_splat4(1.4249322787e-1f);
+    p = p * m - vc_splat4(1.6668057665e-1f);
+    p = p * m + vc_splat4(2.0000714765e-1f);
+    p = p * m - vc_splat4(2.4999993993e-1f);
+    p = p * m + vc_splat4(3.3333331174e-1f);
+    vc_f32x4 y = m * z * p + e * vc_splat4(-2.12194440e-4f) - vc_splat4(0.5f) * z;
+    return m + y + e * vc_splat4(0.693359375f);
+}
+
+static inline vc_f32x4 vc_tanh4(vc_f32x4 x) {
+    vc_f32x4 a = vc_abs4(x);
+    vc_f32x4 z = x * x;
+    vc_f32x4 p = vc_splat4(-5.70498872745e-3f);
+    p = p * z + vc_splat4(2.06390887954e-2f);
+    p = p * z - vc_splat4(5.37397155531e-2f);
+    p = p * z + vc_splat4(1.33314422036e-1f);
+    p = p * z - vc_splat4(3.33332819422e-1f);
+    vc_f32x4 small = x + x * z * p;
+
+    vc_f32x4 clamped = vc_min4(a, vc_splat4(9.0f));
+    vc_f32x4 t = vc_splat4(1.0f) - vc_splat4(2.0f) / (vc_exp4(clamped + clamped) + vc_splat4(1.0f));
+    vc_f32x4 large = (vc_f32x4)((vc_i32x4)t | ((vc_i32x4)x & (vc_i32x4)vc_splat4(-0.0f)));
+    return vc_select4(a < vc_splat4(0.625f), small, large);
+}
+
+/// 1 / (1 + e^-x)
+static inline vc_f32x4 vc_sigmoid4(vc_f32x4 x) {
+    return vc_splat4(1.0f) / (vc_splat4(1.0f) + vc_exp4(-x));
+}
+
+static inline void vc_sincos4(vc_f32x4 x, vc_f32x4 *outSin, vc_f32x4 *outCos) {
+    vc_i32x4 q;
+    vc_f32x4 fq = vc_round4(x * vc_splat4(0.636619772f), &q);
+    vc_f32x4 r = x - fq * vc_splat4(1.5703125f);
+    r -= fq * vc_splat4(4.837512969970703125e-4f);
+    r -= fq * vc_splat4(7.54978995489188216e-8f);
+
+    vc_f32x4 z = r * r;
+    vc_f32x4 s = ((vc_splat4(-1.9515295891e-4f) * z + vc_splat4(8.3321608736e-3f)) * z
+                  - vc_splat4(1.6666654611e-1f)) * z * r + r;
+    vc_f32x4 c = ((vc_splat4(2.443315711809948e-5f) * z - vc_splat4(1.388731625493765e-3f)) * z
+                  + vc_splat4(4.166664568298827e-2f)) * z * z - vc_splat4(0.5f) * z + vc_splat4(1.0f);
+
+    vc_i32x4 swap = (q & 1) != 0;
+    vc_i32x4 sinSign = ((q & 2) != 0) & (vc_i32x4)vc_splat4(-0.0f);
+    vc_i32x4 cosSign = (((q + 1) & 2) != 0) & (vc_i32x4)vc_splat4(-0.0f);
+    *outSin = (vc_f32x4)((vc_i32x4)vc_select4(swap, c, s) ^ sinSign);
+    *outCos = (vc_f32x4)((vc_i32x4)vc_select4(swap, s, c) ^ cosSign);
+}
+
+static inline vc_f32x4 vc_atan24(vc_f32x4 y, vc_f32x4 x) {
+    vc_f32x4 ax = vc_abs4(x);
+    vc_f32x4 ay = vc_abs4(y);
+    vc_f32x4 hi = vc_max4(ax, ay);
+    vc_f32x4 lo = vc_select4(ax > ay, ay, ax);
+    vc_f32x4 t = vc_select4(hi > vc_splat4(0.0f), lo / hi, vc_splat4(0.0f));
+
+    vc_i32x4 large = t > vc_splat4(0.414213562f);
+    vc_f32x4 u = vc_select4(large, (t - vc_splat4(1.0f)) / (t + vc_splat4(1.0f)), t);
+    vc_f32x4 z = u * u;
+    vc_f32x4 a = (((vc_splat4(8.05374449538e-2f) * z - vc_splat4(1.38776856032e-1f)) * z
+                   + vc_splat4(1.99777106478e-1f)) * z - vc_splat4(3.33329491539e-1f)) * z * u + u;
+    a = vc_select4(large, a + vc_splat4(0.785398163f), a);
+    a = vc_select4(ay > ax, vc_splat4(1.57079633f) - a, a);
+    a = vc_select4(x < vc_splat4(0.0f), vc_splat4(3.14159265f) - a, a);
+    return vc_select4(y < vc_splat4(0.0f), -a, a);
+}
+
+#else
+#define VC_HAS_VECTOR_EXT 0
+#endif
+
+#endif /* VCSimd_h */
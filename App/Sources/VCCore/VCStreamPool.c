@@ -0,0 +1,388 @@
+//
+//  VCStreamPool.c
+//  VoiceChanger
+//
+//  Work-stealing thread pool for processing many independent DSP streams
+//
+
+#include "include/VCStreamPool.h"
+#include "include/VCSignalGuard.h"
+#include "VCAlloc.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <unistd.h>
+
+// 1回のタスク実行で処理する最大ブロック数（超えたらキュー末尾へ回して公平性を保つ）
+#define kStreamQuantum 4
+
+typedef struct {
+    const float *input;
+    float *output;
+    int count;
+} VCBlockTask;
+
+typedef struct {
+    VCStreamProcessFn process;
+    void *context;
+    int lanes;
+
+    // SPSCブロックキュー（producer = 投入スレッド, consumer = 実行中のワーカー）
+    VCBlockTask *queue;
+    uint32_t capacity;
+    _Atomic uint32_t head;
+    _Atomic uint32_t tail;
+
+    // いずれかのワーカーのデックに入っている/実行中なら1
+    atomic_int scheduled;
+} VCStream;
+
+typedef struct {
+    VCStreamPool *pool;
+    int index;
+    pthread_t thread;
+
+    // ワーカーごとのデック（bottom = 所有者側, top = 盗む側）
+    pthread_mutex_t lock;
+    int items[VC_STREAM_POOL_MAX_STREAMS];
+    int top;
+    int count;
+
+    atomic_uint_fast64_t blocks;
+    atomic_uint_fast64_t samples;
+    atomic_uint_fast64_t tasks;
+    atomic_uint_fast64_t steals;
+} VCWorker;
+
+struct VCStreamPool {
+    VCWorker *workers;
+    int workerCount;
+
+    VCStream streams[VC_STREAM_POOL_MAX_STREAMS];
+    atomic_int streamCount;
+
+    atomic_int queuedTasks;
+    atomic_long pendingBlocks;
+
+    pthread_mutex_t sleepLock;
+    pthread_cond_t wakeCond;
+    pthread_cond_t idleCond;
+    int shuttingDown;
+};
+
+#pragma mark - Deque
+
+static void deque_push_bottom(VCWorker *worker, int streamId) {
+    pthread_mutex_lock(&worker->lock);
+    int bottom = (worker->top + worker->count) % VC_STREAM_POOL_MAX_STREAMS;
+    worker->items[bottom] = streamId;
+    worker->count++;
+    pthread_mutex_unlock(&worker->lock);
+}
+
+static void deque_push_top(VCWorker *worker, int streamId) {
+    pthread_mutex_lock(&worker->lock);
+    worker->top = (worker->top + VC_STREAM_POOL_MAX_STREAMS - 1) % VC_STREAM_POOL_MAX_STREAMS;
+    worker->items[worker->top] = streamId;
+    worker->count++;
+    pthread_mutex_unlock(&worker->lock);
+}
+
+static int deque_pop_bottom(VCWorker *worker) {
+    int streamId = -1;
+    pthread_mutex_lock(&worker->lock);
+    if (worker->count > 0) {
+        worker->count--;
+        streamId = worker->items[(worker->top + worker->count) % VC_STREAM_POOL_MAX_STREAMS];
+    }
+    pthread_mutex_unlock(&worker->lock);
+    return streamId;
+}
+
+static int deque_steal_top(VCWorker *worker) {
+    int streamId = -1;
+    // 競合中のデックは飛ばして次の候補を見る
+    if (pthread_mutex_trylock(&worker->lock) != 0) {
+        return -1;
+    }
+    if (worker->count > 0) {
+        streamId = worker->items[worker->top];
+        worker->top = (worker->top + 1) % VC_STREAM_POOL_MAX_STREAMS;
+        worker->count--;
+    }
+    pthread_mutex_unlock(&worker->lock);
+    return streamId;
+}
+
+#pragma mark - Scheduling
+
+static void schedule_stream(VCStreamPool *pool, VCWorker *worker, int streamId, int atTop) {
+    if (atTop) {
+        deque_push_top(worker, streamId);
+    } else {
+        deque_push_bottom(worker, streamId);
+    }
+    atomic_fetch_add(&pool->queuedTasks, 1);
+
+    pthread_mutex_lock(&pool->sleepLock);
+    pthread_cond_signal(&pool->wakeCond);
+    pthread_mutex_unlock(&pool->sleepLock);
+}
+
+static int stream_has_blocks(VCStream *stream) {
+    return atomic_load(&stream->tail) != atomic_load(&stream->head);
+}
+
+static int find_task(VCStreamPool *pool, VCWorker *self) {
+    int streamId = deque_pop_bottom(self);
+    if (streamId >= 0) {
+        atomic_fetch_sub(&pool->queuedTasks, 1);
+        return streamId;
+    }
+
+    for (int i = 1; i < pool->workerCount; i++) {
+        VCWorker *victim = &pool->workers[(self->index + i) % pool->workerCount];
+        streamId = deque_steal_top(victim);
+        if (streamId >= 0) {
+            atomic_fetch_sub(&pool->queuedTasks, 1);
+            atomic_fetch_add_explicit(&self->steals, 1, memory_order_relaxed);
+            return streamId;
+        }
+    }
+    return -1;
+}
+
+static void run_stream(VCStreamPool *pool, VCWorker *worker, int streamId) {
+    VCStream *stream = &pool->streams[streamId];
+    int processed = 0;
+
+    while (processed < kStreamQuantum) {
+        uint32_t head = atomic_load_explicit(&stream->head, memory_order_relaxed);
+        uint32_t tail = atomic_load_explicit(&stream->tail, memory_order_acquire);
+        if (head == tail) {
+            break;
+        }
+
+        VCBlockTask task = stream->queue[head % stream->capacity];
+        stream->process(stream->context, task.input, task.output, task.count);
+        atomic_store_explicit(&stream->head, head + 1, memory_order_release);
+
+        processed++;
+        atomic_fetch_add_explicit(&worker->blocks, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&worker->samples, (uint_fast64_t)task.count * (uint_fast64_t)stream->lanes,
+                                  memory_order_relaxed);
+
+        if (atomic_fetch_sub(&pool->pendingBlocks, 1) == 1) {
+            pthread_mutex_lock(&pool->sleepLock);
+            pthread_cond_broadcast(&pool->idleCond);
+            pthread_mutex_unlock(&pool->sleepLock);
+        }
+    }
+    atomic_fetch_add_explicit(&worker->tasks, 1, memory_order_relaxed);
+
+    // 所有権を手放してから再確認（投入側の scheduled 交換と seq_cst で整合）
+    atomic_store(&stream->scheduled, 0);
+    if (stream_has_blocks(stream) && atomic_exchange(&stream->scheduled, 1) == 0) {
+        // 量子を使い切ったストリームは後回しにする
+        schedule_stream(pool, worker, streamId, processed == kStreamQuantum);
+    }
+}
+
+static void *worker_main(void *arg) {
+    VCWorker *worker = (VCWorker *)arg;
+    VCStreamPool *pool = worker->pool;
+    vc_denormals_flush_thread();
+
+    for (;;) {
+        int streamId = find_task(pool, worker);
+        if (streamId >= 0) {
+            run_stream(pool, worker, streamId);
+            continue;
+        }
+
+        pthread_mutex_lock(&pool->sleepLock);
+        while (!pool->shuttingDown && atomic_load(&pool->queuedTasks) == 0) {
+            pthread_cond_wait(&pool->wakeCond, &pool->sleepLock);
+        }
+        int done = pool->shuttingDown && atomic_load(&pool->queuedTasks) == 0;
+        pthread_mutex_unlock(&pool->sleepLock);
+
+        if (done) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+#pragma mark - Public API
+
+int vc_stream_pool_cpu_count(void) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+}
+
+VCStreamPool *vc_stream_pool_create(int workerCount) {
+    if (workerCount <= 0) {
+        workerCount = vc_stream_pool_cpu_count();
+    }
+
+    VCStreamPool *pool = vc_calloc(1, sizeof(VCStreamPool));
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    pool->workers = vc_calloc((size_t)workerCount, sizeof(VCWorker));
+    if (pool->workers == NULL) {
+        vc_free(pool);
+        return NULL;
+    }
+    pool->workerCount = workerCount;
+
+    pthread_mutex_init(&pool->sleepLock, NULL);
+    pthread_cond_init(&pool->wakeCond, NULL);
+    pthread_cond_init(&pool->idleCond, NULL);
+
+    for (int i = 0; i < workerCount; i++) {
+        VCWorker *worker = &pool->workers[i];
+        worker->pool = pool;
+        worker->index = i;
+        pthread_mutex_init(&worker->lock, NULL);
+    }
+
+    for (int i = 0; i < workerCount; i++) {
+        if (pthread_create(&pool->workers[i].thread, NULL, worker_main, &pool->workers[i]) != 0) {
+            // 起動済みワーカーだけで動かす
+            pool->workerCount = i;
+            break;
+        }
+    }
+
+    if (pool->workerCount == 0) {
+        vc_stream_pool_destroy(pool);
+        return NULL;
+    }
+    return pool;
+}
+
+void vc_stream_pool_destroy(VCStreamPool *pool) {
+    if (pool == NULL) {
+        return;
+    }
+
+    vc_stream_pool_wait(pool);
+
+    pthread_mutex_lock(&pool->sleepLock);
+    pool->shuttingDown = 1;
+    pthread_cond_broadcast(&pool->wakeCond);
+    pthread_mutex_unlock(&pool->sleepLock);
+
+    for (int i = 0; i < pool->workerCount; i++) {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+
+    int streamCount = atomic_load(&pool->streamCount);
+    for (int i = 0; i < streamCount; i++) {
+        vc_free(pool->streams[i].queue);
+    }
+
+    vc_free(pool->workers);
+    pthread_cond_destroy(&pool->idleCond);
+    pthread_cond_destroy(&pool->wakeCond);
+    pthread_mutex_destroy(&pool->sleepLock);
+    vc_free(pool);
+}
+
+int vc_stream_pool_worker_count(const VCStreamPool *pool) {
+    return pool->workerCount;
+}
+
+static void process_chain(void *context, const float *input, float *output, int count) {
+    vc_chain_process((VCChain *)context, input, output, count);
+}
+
+int vc_stream_pool_add_stream(VCStreamPool *pool, VCChain *chain, int queueCapacity) {
+    if (chain == NULL) {
+        return -1;
+    }
+    return vc_stream_pool_add_processor(pool, process_chain, chain, 1, queueCapacity);
+}
+
+static void process_batch(void *context, const float *input, float *output, int count) {
+    vc_chain_batch_process((VCChainBatch *)context, input, output, count);
+}
+
+int vc_stream_pool_add_batch(VCStreamPool *pool, VCChainBatch *batch, int queueCapacity) {
+    if (batch == NULL) {
+        return -1;
+    }
+    return vc_stream_pool_add_processor(pool, process_batch, batch, vc_chain_batch_lanes(batch), queueCapacity);
+}
+
+int vc_stream_pool_add_processor(VCStreamPool *pool, VCStreamProcessFn process, void *context,
+                                 int lanes, int queueCapacity) {
+    int streamId = atomic_load(&pool->streamCount);
+    if (process == NULL || lanes <= 0 || queueCapacity <= 0 || streamId >= VC_STREAM_POOL_MAX_STREAMS) {
+        return -1;
+    }
+
+    VCStream *stream = &pool->streams[streamId];
+    stream->queue = vc_calloc((size_t)queueCapacity, sizeof(VCBlockTask));
+    if (stream->queue == NULL) {
+        return -1;
+    }
+    stream->process = process;
+    stream->context = context;
+    stream->lanes = lanes;
+    stream->capacity = (uint32_t)queueCapacity;
+    atomic_store(&stream->head, 0);
+    atomic_store(&stream->tail, 0);
+    atomic_store(&stream->scheduled, 0);
+
+    atomic_store(&pool->streamCount, streamId + 1);
+    return streamId;
+}
+
+int vc_stream_pool_submit(VCStreamPool *pool, int streamId, const float *input, float *output, int count) {
+    if (streamId < 0 || streamId >= atomic_load(&pool->streamCount)) {
+        return -1;
+    }
+
+    VCStream *stream = &pool->streams[streamId];
+    uint32_t tail = atomic_load_explicit(&stream->tail, memory_order_relaxed);
+    uint32_t head = atomic_load_explicit(&stream->head, memory_order_acquire);
+    if (tail - head >= stream->capacity) {
+        return -1;
+    }
+
+    stream->queue[tail % stream->capacity] = (VCBlockTask){ input, output, count };
+
+    // 完了カウントが負にならないよう、公開前に加算する
+    atomic_fetch_add(&pool->pendingBlocks, 1);
+    atomic_store(&stream->tail, tail + 1);
+
+    if (atomic_exchange(&stream->scheduled, 1) == 0) {
+        // ストリームごとのホームワーカーへ（キャッシュ局所性）
+        schedule_stream(pool, &pool->workers[streamId % pool->workerCount], streamId, 0);
+    }
+    return 0;
+}
+
+void vc_stream_pool_wait(VCStreamPool *pool) {
+    pthread_mutex_lock(&pool->sleepLock);
+    while (atomic_load(&pool->pendingBlocks) > 0) {
+        pthread_cond_wait(&pool->idleCond, &pool->sleepLock);
+    }
+    pthread_mutex_unlock(&pool->sleepLock);
+}
+
+void vc_stream_pool_get_stats(VCStreamPool *pool, VCStreamPoolStats *outStats) {
+    VCStreamPoolStats stats = {0};
+    for (int i = 0; i < pool->workerCount; i++) {
+        VCWorker *worker = &pool->workers[i];
+        stats.blocksProcessed += atomic_load_explicit(&worker->blocks, memory_order_relaxed);
+        stats.samplesProcessed += atomic_load_explicit(&worker->samples, memory_order_relaxed);
+        stats.tasksRun += atomic_load_explicit(&worker->tasks, memory_order_relaxed);
+        stats.steals += atomic_load_explicit(&worker->steals, memory_order_relaxed);
+    }
+    *outStats = stats;
+}
@@ -0,0 +1,446 @@
+//
+//  VCTapRecorder.c
+//  VoiceChanger
+//
+//  Lock-free capture taps drained by a background thread into streaming WAV / raw files
+//
+
+#include "include/VCTapRecorder.h"
+#include "include/VCAudioRing.h"
+#include "VCAlloc.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define kWriteBufferBytes   (1u << 20)          // 1 回の write の大きさ（48kHz で約 5.5 秒）
+#define kPreallocateBytes   ((off_t)64 << 20)   // ファイル領域を先に確保する単位
+#define kWavHeaderSize      92                  // RIFF + JUNK(ds64 の予約) + fmt + fact + data
+#define kPageSize           4096
+
+typedef struct {
+    VCAudioRing *owned;         // push で書き込む tap のリング（外部リングの tap は NULL）
+    VCSharedRing *source;       // 読み出すリング（owned のビューまたは外部リング）
+    uint8_t *buffer;            // 書き込みバッファ（kWriteBufferBytes）
+
+    // 録音 1 回分の状態（start / stop と書き込みスレッドだけが触る）
+    int enabled;                // push が参照する（recording より先に書く）
+    int fd;
+    VCTapFormat format;
+    size_t used;
+    uint64_t dataBytes;         // ファイルに書いた音声のバイト数
+    off_t allocated;            // 確保済みの領域の終わり
+    int failed;
+
+    _Atomic uint64_t framesWritten;
+    _Atomic uint64_t droppedFrames;
+    _Atomic uint64_t overflows;
+    _Atomic uint64_t writeErrors;
+} VCTapRecorderTap;
+
+struct VCTapRecorder {
+    int sampleRate;
+    int intervalMs;
+    VCTapRecorderTap taps[VC_TAP_RECORDER_MAX_TAPS];
+    int count;
+
+    _Atomic int recording;
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wakeCond;
+    int shuttingDown;
+    int running;
+};
+
+#pragma mark - File
+
+static void put_u16(uint8_t *bytes, uint16_t value) {
+    bytes[0] = (uint8_t)value;
+    bytes[1] = (uint8_t)(value >> 8);
+}
+
+static void put_u32(uint8_t *bytes, uint32_t value) {
+    put_u16(bytes, (uint16_t)value);
+    put_u16(bytes + 2, (uint16_t)(value >> 16));
+}
+
+static void put_u64(uint8_t *bytes, uint64_t value) {
+    put_u32(bytes, (uint32_t)value);
+    put_u32(bytes + 4, (uint32_t)(value >> 32));
+}
+
+/// 4GB までは RIFF（ds64 の場所は JUNK で予約）、超えたら RF64 にする
+/// 音声を 4 バイト境界に置くため fmt は cbSize なしの 16 バイト
+static void make_wav_header(uint8_t *header, int sampleRate, uint64_t dataBytes) {
+    uint64_t riffSize = kWavHeaderSize - 8 + dataBytes;
+    uint64_t frames = dataBytes / sizeof(float);
+    int large = riffSize > UINT32_MAX;
+
+    memset(header, 0, kWavHeaderSize);
+    memcpy(header, large ? "RF64" : "RIFF", 4);
+    put_u32(header + 4, large ? UINT32_MAX : (uint32_t)riffSize);
+    memcpy(header + 8, "WAVE", 4);
+
+    memcpy(header + 12, large ? "ds64" : "JUNK", 4);
+    put_u32(header + 16, 28);
+    if (large) {
+        put_u64(header + 20, riffSize);
+        put_u64(header + 28, dataBytes);
+        put_u64(header + 36, frames);
+        put_u32(header + 44, 0);
+    }
+
+    memcpy(header + 48, "fmt ", 4);
+    put_u32(header + 52, 16);
+    put_u16(header + 56, 3);                                    // WAVE_FORMAT_IEEE_FLOAT
+    put_u16(header + 58, 1);
+    put_u32(header + 60, (uint32_t)sampleRate);
+    put_u32(header + 64, (uint32_t)sampleRate * sizeof(float));
+    put_u16(header + 68, sizeof(float));
+    put_u16(header + 70, 32);
+
+    memcpy(header + 72, "fact", 4);
+    put_u32(header + 76, 4);
+    put_u32(header + 80, large ? UINT32_MAX : (uint32_t)frames);
+
+    memcpy(header + 84, "data", 4);
+    put_u32(header + 88, large ? UINT32_MAX : (uint32_t)dataBytes);
+}
+
+static int write_fully(int fd, const void *data, size_t size, off_t offset) {
+    const uint8_t *bytes = data;
+    while (size > 0) {
+        ssize_t written = pwrite(fd, bytes, size, offset);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return -1;
+        }
+        bytes += written;
+        size -= (size_t)written;
+        offset += written;
+    }
+    return 0;
+}
+
+/// ファイル領域を先に確保する（失敗しても書き込みは続ける）
+static void preallocate(int fd, off_t offset, off_t length) {
+#if defined(__APPLE__)
+    // F_PREALLOCATE はファイルサイズを変えない（確保は物理的な終わりから）
+    fstore_t store = { F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, length, 0 };
+    if (fcntl(fd, F_PREALLOCATE, &store) == -1) {
+        store.fst_flags = F_ALLOCATEALL;
+        fcntl(fd, F_PREALLOCATE, &store);
+    }
+    (void)offset;
+#else
+    // こちらはサイズも伸びるので、閉じるときに実際の長さへ切り詰める
+    posix_fallocate(fd, offset, length);
+#endif
+}
+
+static off_t header_size(const VCTapRecorderTap *tap) {
+    return tap->format == VC_TAP_FORMAT_WAV ? kWavHeaderSize : 0;
+}
+
+static int write_header(const VCTapRecorder *recorder, const VCTapRecorderTap *tap) {
+    if (tap->format != VC_TAP_FORMAT_WAV) {
+        return 0;
+    }
+    uint8_t header[kWavHeaderSize];
+    make_wav_header(header, recorder->sampleRate, tap->dataBytes);
+    return write_fully(tap->fd, header, sizeof(header), 0);
+}
+
+static void tap_fail(VCTapRecorderTap *tap) {
+    atomic_fetch_add_explicit(&tap->writeErrors, 1, memory_order_relaxed);
+    tap->failed = 1;
+    tap->used = 0;
+}
+
+/// バッファを追記し、ヘッダーを今の長さに更新する（途中で落ちてもここまでは読める）
+static void tap_flush(const VCTapRecorder *recorder, VCTapRecorderTap *tap) {
+    if (tap->used == 0 || tap->failed) {
+        tap->used = 0;
+        return;
+    }
+
+    off_t offset = header_size(tap) + (off_t)tap->dataBytes;
+    if (offset + (off_t)tap->used > tap->allocated) {
+        preallocate(tap->fd, tap->allocated, kPreallocateBytes);
+        tap->allocated += kPreallocateBytes;
+    }
+    if (write_fully(tap->fd, tap->buffer, tap->used, offset) != 0) {
+        tap_fail(tap);
+        return;
+    }
+
+    tap->dataBytes += tap->used;
+    atomic_fetch_add_explicit(&tap->framesWritten, tap->used / sizeof(float), memory_order_relaxed);
+    tap->used = 0;
+    if (write_header(recorder, tap) != 0) {
+        tap_fail(tap);
+    }
+}
+
+#pragma mark - Writer
+
+/// リングにある分をバッファへ移す（いっぱいになったら書き出す）
+static void tap_drain(const VCTapRecorder *recorder, VCTapRecorderTap *tap) {
+    for (;;) {
+        int space = (int)((kWriteBufferBytes - tap->used) / sizeof(float));
+        VCRingRegions regions;
+        int granted = vc_shared_ring_read_regions(tap->source, space, &regions);
+        if (granted == 0) {
+            return;
+        }
+        if (!tap->failed) {
+            uint8_t *destination = tap->buffer + tap->used;
+            memcpy(destination, regions.first, (size_t)regions.firstCount * sizeof(float));
+            if (regions.secondCount > 0) {
+                memcpy(destination + (size_t)regions.firstCount * sizeof(float), regions.second,
+                       (size_t)regions.secondCount * sizeof(float));
+            }
+            tap->used += (size_t)granted * sizeof(float);
+        }
+        vc_shared_ring_commit_read(tap->source, granted);
+
+        if (tap->used == kWriteBufferBytes) {
+            tap_flush(recorder, tap);
+        }
+    }
+}
+
+static void drain_all(VCTapRecorder *recorder) {
+    for (int i = 0; i < recorder->count; i++) {
+        if (recorder->taps[i].enabled) {
+            tap_drain(recorder, &recorder->taps[i]);
+        }
+    }
+}
+
+static void *writer_main(void *arg) {
+    VCTapRecorder *recorder = (VCTapRecorder *)arg;
+    pthread_mutex_lock(&recorder->lock);
+    while (!recorder->shuttingDown) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += recorder->intervalMs / 1000;
+        deadline.tv_nsec += (long)(recorder->intervalMs % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec += 1;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        int result = pthread_cond_timedwait(&recorder->wakeCond, &recorder->lock, &deadline);
+        if (recorder->shuttingDown) {
+            break;
+        }
+        if (result == ETIMEDOUT) {
+            pthread_mutex_unlock(&recorder->lock);
+            drain_all(recorder);
+            pthread_mutex_lock(&recorder->lock);
+        }
+    }
+    pthread_mutex_unlock(&recorder->lock);
+    return NULL;
+}
+
+#pragma mark - Lifecycle
+
+VCTapRecorder *vc_tap_recorder_create(int sampleRate, int intervalMs) {
+    if (sampleRate <= 0 || intervalMs <= 0) {
+        return NULL;
+    }
+    VCTapRecorder *recorder = vc_calloc(1, sizeof(VCTapRecorder));
+    if (recorder == NULL) {
+        return NULL;
+    }
+    recorder->sampleRate = sampleRate;
+    recorder->intervalMs = intervalMs;
+    atomic_init(&recorder->recording, 0);
+    pthread_mutex_init(&recorder->lock, NULL);
+    pthread_cond_init(&recorder->wakeCond, NULL);
+    return recorder;
+}
+
+void vc_tap_recorder_destroy(VCTapRecorder *recorder) {
+    if (recorder == NULL) {
+        return;
+    }
+    vc_tap_recorder_stop(recorder);
+    for (int i = 0; i < recorder->count; i++) {
+        vc_audio_ring_destroy(recorder->taps[i].owned);
+        vc_free(recorder->taps[i].buffer);
+    }
+    pthread_cond_destroy(&recorder->wakeCond);
+    pthread_mutex_destroy(&recorder->lock);
+    vc_free(recorder);
+}
+
+static VCTapRecorderTap *append_tap(VCTapRecorder *recorder) {
+    if (recorder->running || recorder->count >= VC_TAP_RECORDER_MAX_TAPS) {
+        return NULL;
+    }
+    VCTapRecorderTap *tap = &recorder->taps[recorder->count];
+    memset(tap, 0, sizeof(*tap));
+    tap->fd = -1;
+    tap->buffer = vc_aligned_alloc(kPageSize, kWriteBufferBytes);
+    return tap->buffer != NULL ? tap : NULL;
+}
+
+int vc_tap_recorder_add(VCTapRecorder *recorder, int ringFrames) {
+    VCTapRecorderTap *tap = append_tap(recorder);
+    if (tap == NULL) {
+        return -1;
+    }
+    tap->owned = vc_audio_ring_create(ringFrames);
+    if (tap->owned == NULL) {
+        vc_free(tap->buffer);
+        return -1;
+    }
+    tap->source = vc_audio_ring_view(tap->owned);
+    return recorder->count++;
+}
+
+int vc_tap_recorder_add_ring(VCTapRecorder *recorder, VCSharedRing *source) {
+    if (source == NULL) {
+        return -1;
+    }
+    VCTapRecorderTap *tap = append_tap(recorder);
+    if (tap == NULL) {
+        return -1;
+    }
+    tap->source = source;
+    return recorder->count++;
+}
+
+int vc_tap_recorder_count(const VCTapRecorder *recorder) {
+    return recorder->count;
+}
+
+#pragma mark - Session
+
+static void close_taps(VCTapRecorder *recorder) {
+    for (int i = 0; i < recorder->count; i++) {
+        VCTapRecorderTap *tap = &recorder->taps[i];
+        if (tap->fd >= 0) {
+            close(tap->fd);
+            tap->fd = -1;
+        }
+        tap->enabled = 0;
+    }
+}
+
+int vc_tap_recorder_start(VCTapRecorder *recorder, const char *const *paths, VCTapFormat format) {
+    if (recorder->running || paths == NULL) {
+        return -1;
+    }
+
+    for (int i = 0; i < recorder->count; i++) {
+        VCTapRecorderTap *tap = &recorder->taps[i];
+        tap->format = format;
+        tap->used = 0;
+        tap->dataBytes = 0;
+        tap->allocated = 0;
+        tap->failed = 0;
+        atomic_store_explicit(&tap->framesWritten, 0, memory_order_relaxed);
+        atomic_store_explicit(&tap->droppedFrames, 0, memory_order_relaxed);
+        atomic_store_explicit(&tap->overflows, 0, memory_order_relaxed);
+        atomic_store_explicit(&tap->writeErrors, 0, memory_order_relaxed);
+
+        // 外部リングが接続されていなければ録音しない
+        if (paths[i] == NULL || tap->source->header == NULL) {
+            continue;
+        }
+        tap->fd = open(paths[i], O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (tap->fd < 0 || write_header(recorder, tap) != 0) {
+            close_taps(recorder);
+            return -1;
+        }
+
+        // 前回の停止と競合して残った分・接続前に溜まっていた分は捨てる
+        vc_shared_ring_commit_read(tap->source, vc_shared_ring_available_read(tap->source));
+        tap->enabled = 1;
+    }
+
+    recorder->shuttingDown = 0;
+    if (pthread_create(&recorder->thread, NULL, writer_main, recorder) != 0) {
+        close_taps(recorder);
+        return -1;
+    }
+    recorder->running = 1;
+    atomic_store_explicit(&recorder->recording, 1, memory_order_release);
+    return 0;
+}
+
+void vc_tap_recorder_stop(VCTapRecorder *recorder) {
+    if (!recorder->running) {
+        return;
+    }
+    atomic_store_explicit(&recorder->recording, 0, memory_order_release);
+
+    pthread_mutex_lock(&recorder->lock);
+    recorder->shuttingDown = 1;
+    pthread_cond_signal(&recorder->wakeCond);
+    pthread_mutex_unlock(&recorder->lock);
+    pthread_join(recorder->thread, NULL);
+    recorder->running = 0;
+
+    // 残りを書き出し、先に確保した領域を実際の長さに切り詰める
+    drain_all(recorder);
+    for (int i = 0; i < recorder->count; i++) {
+        VCTapRecorderTap *tap = &recorder->taps[i];
+        if (!tap->enabled) {
+            continue;
+        }
+        tap_flush(recorder, tap);
+        if (!tap->failed && ftruncate(tap->fd, header_size(tap) + (off_t)tap->dataBytes) != 0) {
+            tap_fail(tap);
+        }
+    }
+    close_taps(recorder);
+}
+
+int vc_tap_recorder_is_recording(const VCTapRecorder *recorder) {
+    return atomic_load_explicit(&recorder->recording, memory_order_acquire);
+}
+
+#pragma mark - Audio Thread
+
+int vc_tap_recorder_push(VCTapRecorder *recorder, int tap, const float *samples, int count) {
+    if (!atomic_load_explicit(&recorder->recording, memory_order_acquire) ||
+        tap < 0 || tap >= recorder->count || count <= 0) {
+        return 0;
+    }
+    VCTapRecorderTap *target = &recorder->taps[tap];
+    if (!target->enabled || target->owned == NULL) {
+        return 0;
+    }
+
+    // ブロックの途中で切らない（IO トレースのレコードもこの単位で運ぶ）
+    if (vc_audio_ring_available_write(target->owned) < count) {
+        atomic_fetch_add_explicit(&target->droppedFrames, (uint64_t)count, memory_order_relaxed);
+        atomic_fetch_add_explicit(&target->overflows, 1, memory_order_relaxed);
+        return 0;
+    }
+    return vc_audio_ring_write(target->owned, samples, count);
+}
+
+void vc_tap_recorder_get_stats(const VCTapRecorder *recorder, int tap, VCTapStats *outStats) {
+    memset(outStats, 0, sizeof(*outStats));
+    if (tap < 0 || tap >= recorder->count) {
+        return;
+    }
+    const VCTapRecorderTap *target = &recorder->taps[tap];
+    outStats->framesWritten = atomic_load_explicit(&target->framesWritten, memory_order_relaxed);
+    outStats->droppedFrames = atomic_load_explicit(&target->droppedFrames, memory_order_relaxed);
+    outStats->overflows = atomic_load_explicit(&target->overflows, memory_order_relaxed);
+    outStats->writeErrors = atomic_load_explicit(&target->writeErrors, memory_order_relaxed);
+}
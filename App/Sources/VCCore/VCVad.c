@@ -0,0 +1,277 @@
+//
+//  VCVad.c
+//  VoiceChanger
+//
+//  Voice activity detector (energy over noise floor + spectral flatness + zero-crossing rate)
+//
+
+#include "include/VCVad.h"
+#include "include/VCFFT.h"
+#include "include/VCFastMath.h"
+#include "VCSimd.h"
+#include "VCAlloc.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define kAnalysisSize       256     // 平坦度を見る窓（48kHz で 5.3 ms）
+#define kSilenceDb          -70.0f  // これ未満は常に非発話
+#define kEnergyMarginDb     9.0f    // ノイズフロアからの余裕
+#define kFlatnessMax        0.35f   // 有声音は調波で平坦度が低い（白色雑音 ≒ 0.56）
+#define kFricativeZcr       0.25f   // 無声摩擦音のゼロ交差率（発話中の継続判定のみ）
+#define kFloorFallCoeff     0.2f    // フロアは下がるときは速く
+#define kFloorRiseDbPerSec  3.0f    // 上がるときはゆっくり（発話で持ち上がらないように）
+#define kHangoverMs         200.0f
+#define kFadeMs             30.0f
+#define kPowerFloor         1e-12f
+
+struct VCVad {
+    float sampleRate;
+    VCFFTPlan *plan;
+    float *window;          // Hann [kAnalysisSize]
+    float *history;         // 直近 kAnalysisSize サンプル
+    float *frame;           // 窓掛け後
+    float *spectrumRe;
+    float *spectrumIm;
+    float *power;
+
+    float previousSample;   // ゼロ交差をブロック境界で数えるため
+    int floorInitialized;
+    int hangoverFrames;     // 残りハングオーバー（サンプル）
+
+    VCVadState state;
+};
+
+#pragma mark - Lifecycle
+
+VCVad *vc_vad_create(int sampleRate) {
+    if (sampleRate <= 0) {
+        return NULL;
+    }
+
+    VCVad *vad = vc_calloc(1, sizeof(VCVad));
+    if (vad == NULL) {
+        return NULL;
+    }
+
+    int bins = kAnalysisSize / 2 + 1;
+    vad->sampleRate = (float)sampleRate;
+    vad->plan = vc_fft_plan_create(kAnalysisSize);
+    vad->window = vc_malloc(kAnalysisSize * sizeof(float));
+    vad->history = vc_calloc(kAnalysisSize, sizeof(float));
+    vad->frame = vc_malloc(kAnalysisSize * sizeof(float));
+    vad->spectrumRe = vc_malloc((size_t)bins * sizeof(float));
+    vad->spectrumIm = vc_malloc((size_t)bins * sizeof(float));
+    vad->power = vc_malloc((size_t)bins * sizeof(float));
+    if (vad->plan == NULL || vad->window == NULL || vad->history == NULL || vad->frame == NULL ||
+        vad->spectrumRe == NULL || vad->spectrumIm == NULL || vad->power == NULL) {
+        vc_vad_destroy(vad);
+        return NULL;
+    }
+
+    for (int i = 0; i < kAnalysisSize; i++) {
+        vad->window[i] = 0.5f - 0.5f * (float)cos(2.0 * M_PI * i / kAnalysisSize);
+    }
+
+    vc_vad_reset(vad);
+    return vad;
+}
+
+void vc_vad_destroy(VCVad *vad) {
+    if (vad == NULL) {
+        return;
+    }
+    vc_fft_plan_destroy(vad->plan);
+    vc_free(vad->window);
+    vc_free(vad->history);
+    vc_free(vad->frame);
+    vc_free(vad->spectrumRe);
+    vc_free(vad->spectrumIm);
+    vc_free(vad->power);
+    vc_free(vad);
+}
+
+void vc_vad_reset(VCVad *vad) {
+    memset(vad->history, 0, kAnalysisSize * sizeof(float));
+    vad->previousSample = 0;
+    vad->floorInitialized = 0;
+    vad->hangoverFrames = 0;
+
+    memset(&vad->state, 0, sizeof(vad->state));
+    vad->state.activity = 1.0f;
+    vad->state.energyDb = kSilenceDb;
+    vad->state.noiseFloorDb = kSilenceDb;
+    vad->state.flatness = 1.0f;
+}
+
+float vc_vad_activity(const VCVad *vad) {
+    return vad->state.activity;
+}
+
+void vc_vad_get_state(const VCVad *vad, VCVadState *outState) {
+    *outState = vad->state;
+}
+
+#pragma mark - Features
+
+/// 二乗和とゼロ交差数（符号が変わった隣接ペアの数）
+static float energy_and_crossings(const float *samples, int count, float previous, int *outCrossings) {
+    float sum = 0;
+    int crossings = 0;
+    int i = 0;
+
+    // 先頭はブロック境界をまたぐ
+    if (count > 0) {
+        sum = samples[0] * samples[0];
+        crossings = (samples[0] < 0) != (previous < 0);
+        i = 1;
+    }
+#if VC_HAS_VECTOR_EXT
+    vc_f32x4 sum4 = vc_splat4(0);
+    vc_i32x4 crossings4 = { 0, 0, 0, 0 };
+    for (; i + 4 <= count; i += 4) {
+        vc_f32x4 x = vc_load4(samples + i);
+        vc_f32x4 prev = vc_load4(samples + i - 1);
+        sum4 += x * x;
+        // 符号ビットの XOR（比較マスクは -1 なので引いて数える）
+        vc_i32x4 signChange = ((vc_i32x4)x ^ (vc_i32x4)prev) < 0;
+        crossings4 -= signChange;
+    }
+    sum += vc_hsum4(sum4);
+    crossings += crossings4[0] + crossings4[1] + crossings4[2] + crossings4[3];
+#endif
+    for (; i < count; i++) {
+        sum += samples[i] * samples[i];
+        crossings += (samples[i] < 0) != (samples[i - 1] < 0);
+    }
+
+    *outCrossings = crossings;
+    return sum;
+}
+
+/// パワースペクトルの平坦度（幾何平均 / 算術平均）
+static float flatness(const float *power, int count) {
+    float sum = 0;
+    float logSum = 0;
+    int k = 0;
+#if VC_HAS_VECTOR_EXT
+    vc_f32x4 sum4 = vc_splat4(0);
+    vc_f32x4 log4 = vc_splat4(0);
+    for (; k + 4 <= count; k += 4) {
+        vc_f32x4 p = vc_load4(power + k) + vc_splat4(kPowerFloor);
+        sum4 += p;
+        log4 += vc_log4(p);
+    }
+    sum = vc_hsum4(sum4);
+    logSum = vc_hsum4(log4);
+#endif
+    for (; k < count; k++) {
+        float p = power[k] + kPowerFloor;
+        sum += p;
+        logSum += vc_fast_logf(p);
+    }
+
+    float geometric = vc_fast_expf(logSum / (float)count);
+    float arithmetic = sum / (float)count;
+    return fminf(1.0f, geometric / arithmetic);
+}
+
+/// 直近 kAnalysisSize サンプルのスペクトル平坦度（DC とナイキストは除く）
+/// 解析コンテキストがあればその最新フレーム（同じ 256 サンプル・Hann 窓）を使い、自前では FFT しない
+static float spectral_flatness(VCVad *vad, VCAnalysisContext *analysis) {
+    int first = 1;
+    int count = kAnalysisSize / 2 - 1;
+    if (analysis != NULL) {
+        const float *power = vc_analysis_power(analysis, vc_analysis_frame_count(analysis) - 1);
+        return flatness(power + first, count);
+    }
+
+    for (int i = 0; i < kAnalysisSize; i++) {
+        vad->frame[i] = vad->history[i] * vad->window[i];
+    }
+    vc_fft_forward(vad->plan, vad->frame, vad->spectrumRe, vad->spectrumIm);
+    vc_complex_power(vad->spectrumRe + first, vad->spectrumIm + first, vad->power, count);
+    return flatness(vad->power, count);
+}
+
+static void push_history(VCVad *vad, const float *samples, int count) {
+    if (count >= kAnalysisSize) {
+        memcpy(vad->history, samples + count - kAnalysisSize, kAnalysisSize * sizeof(float));
+        return;
+    }
+    memmove(vad->history, vad->history + count, (size_t)(kAnalysisSize - count) * sizeof(float));
+    memcpy(vad->history + kAnalysisSize - count, samples, (size_t)count * sizeof(float));
+}
+
+#pragma mark - Decision
+
+int vc_vad_process(VCVad *vad, const float *samples, int count) {
+    return vc_vad_process_with_analysis(vad, samples, count, NULL);
+}
+
+int vc_vad_process_with_analysis(VCVad *vad, const float *samples, int count, VCAnalysisContext *analysis) {
+    if (count <= 0) {
+        return vad->state.speech;
+    }
+
+    VCVadState *state = &vad->state;
+    float blockSeconds = (float)count / vad->sampleRate;
+
+    int crossings;
+    float sum = energy_and_crossings(samples, count, vad->previousSample, &crossings);
+    vad->previousSample = samples[count - 1];
+    push_history(vad, samples, count);
+
+    float energyDb = 10.0f * vc_fast_log10f(sum / (float)count + kPowerFloor);
+    state->energyDb = energyDb;
+    state->zeroCrossingRate = (float)crossings / (float)count;
+
+    // ノイズフロア: 下がるときは速く、上がるときは一定速度で
+    if (!vad->floorInitialized) {
+        state->noiseFloorDb = fmaxf(energyDb, kSilenceDb);
+        vad->floorInitialized = 1;
+    } else if (energyDb < state->noiseFloorDb) {
+        state->noiseFloorDb += kFloorFallCoeff * (energyDb - state->noiseFloorDb);
+    } else {
+        state->noiseFloorDb = fminf(energyDb, state->noiseFloorDb + kFloorRiseDbPerSec * blockSeconds);
+    }
+    state->noiseFloorDb = fmaxf(state->noiseFloorDb, kSilenceDb);
+
+    // エネルギーで候補を絞ってから平坦度を計算する（無音区間は FFT しない）
+    // 発話の開始は有声音（平坦度が低い）でのみ判定する。無声摩擦音は広帯域ノイズと
+    // 区別できないので、発話中の継続（ゼロ交差率が高い）としてだけ扱う
+    float margin = energyDb - state->noiseFloorDb;
+    int rawSpeech = 0;
+    if (energyDb > kSilenceDb && margin > kEnergyMarginDb) {
+        state->flatness = spectral_flatness(vad, analysis);
+        rawSpeech = state->flatness < kFlatnessMax ||
+                    (state->speech && state->zeroCrossingRate > kFricativeZcr);
+    }
+    state->rawSpeech = rawSpeech;
+
+    // ハングオーバーとフェード
+    if (rawSpeech) {
+        vad->hangoverFrames = (int)(kHangoverMs * vad->sampleRate / 1000.0f);
+    } else {
+        vad->hangoverFrames = vad->hangoverFrames > count ? vad->hangoverFrames - count : 0;
+    }
+    state->speech = vad->hangoverFrames > 0;
+
+    // 立ち上がりは語頭を削らないよう即座に戻し、終わりだけゆっくり下げる
+    if (state->speech) {
+        state->activity = 1.0f;
+    } else {
+        state->activity = fmaxf(0.0f, state->activity - blockSeconds * 1000.0f / kFadeMs);
+    }
+
+    if (state->speech) {
+        state->speechBlocks++;
+    } else {
+        state->silentBlocks++;
+    }
+    return state->speech;
+}
@@ -0,0 +1,48 @@
+//
+//  VCVirtualMic.c
+//  VoiceChanger
+//
+//  Object-ID and shared-memory naming scheme for multiple virtual mics (shared with the driver)
+//
+
+#include "include/VCVirtualMic.h"
+#include <stdio.h>
+
+uint32_t vc_virtual_mic_object_id(int mic, VCVirtualMicObject object) {
+    if (mic < 0 || mic >= VC_VIRTUAL_MIC_MAX || (int)object < 0 || (int)object >= VC_VIRTUAL_MIC_OBJECT_COUNT) {
+        return 0;
+    }
+    if (mic == 0) {
+        return VC_VIRTUAL_MIC_PRIMARY_BASE + (uint32_t)object;
+    }
+    return VC_VIRTUAL_MIC_EXTRA_BASE + (uint32_t)(mic - 1) * VC_VIRTUAL_MIC_OBJECT_COUNT + (uint32_t)object;
+}
+
+int vc_virtual_mic_index(uint32_t objectId, VCVirtualMicObject *outObject) {
+    int mic = -1;
+    uint32_t offset = 0;
+    if (objectId >= VC_VIRTUAL_MIC_PRIMARY_BASE &&
+        objectId < VC_VIRTUAL_MIC_PRIMARY_BASE + VC_VIRTUAL_MIC_OBJECT_COUNT) {
+        mic = 0;
+        offset = objectId - VC_VIRTUAL_MIC_PRIMARY_BASE;
+    } else if (objectId >= VC_VIRTUAL_MIC_EXTRA_BASE &&
+               objectId < VC_VIRTUAL_MIC_EXTRA_BASE + (VC_VIRTUAL_MIC_MAX - 1) * VC_VIRTUAL_MIC_OBJECT_COUNT) {
+        uint32_t relative = objectId - VC_VIRTUAL_MIC_EXTRA_BASE;
+        mic = 1 + (int)(relative / VC_VIRTUAL_MIC_OBJECT_COUNT);
+        offset = relative % VC_VIRTUAL_MIC_OBJECT_COUNT;
+    }
+    if (mic >= 0 && outObject != NULL) {
+        *outObject = (VCVirtualMicObject)offset;
+    }
+    return mic;
+}
+
+int vc_virtual_mic_memory_name(int mic, char *buffer, size_t size) {
+    if (mic < 0 || mic >= VC_VIRTUAL_MIC_MAX || buffer == NULL) {
+        return -1;
+    }
+    int length = mic == 0
+        ? snprintf(buffer, size, "%s", VC_VIRTUAL_MIC_MEMORY_NAME)
+        : snprintf(buffer, size, "%s.%d", VC_VIRTUAL_MIC_MEMORY_NAME, mic + 1);
+    return length < 0 || (size_t)length >= size ? -1 : 0;
+}
@@ -0,0 +1,987 @@
+//
+//  VCVoiceConverter.c
+//  VoiceChanger
+//
+//  Causal streaming neural voice conversion: memory-mapped int8 model, cached activations, look-ahead worker
+//
+
+#include "include/VCVoiceConverter.h"
+#include "include/VCFastMath.h"
+#include "include/VCSignalGuard.h"
+#include "VCAlloc.h"
+#include "VCSimd.h"
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define kSectionAlignment   64
+#define kMaxFileSize        0x7fffffffu
+#define kMaxBatch           8       // まとめて計算するフレーム数（重みを読む回数が 1/kMaxBatch になる）
+#define kTile               4       // 重みの 1 行を共有して内積を取るフレーム数
+#define kRingFrames         32      // 補助スレッドとの入出力リング（フレーム数、2 のべき乗）
+#define kWakeTimeoutNs      1000000 // 起床の取りこぼしに備えた待機の上限（1ms）
+
+_Static_assert(sizeof(VCVoiceModelHeader) == 64, "VCVoiceModelHeader layout changed");
+_Static_assert(sizeof(VCVoiceModelTensor) == 32, "VCVoiceModelTensor layout changed");
+_Static_assert(kRingFrames > kMaxBatch + VC_VOICE_CONVERTER_MAX_LOOKAHEAD + 1, "ring too small for look-ahead");
+
+typedef struct {
+    int rows;
+    int cols;
+    int stride;
+    const int8_t *weights;  // [rows][stride]
+    const float *scales;
+    const float *bias;
+} VCTensor;
+
+struct VCVoiceModel {
+    void *mapping;
+    size_t mappingSize;
+    VCVoiceModelConfig config;
+    VCTensor encoder;
+    VCTensor conv[VC_VOICE_MODEL_MAX_CONV_LAYERS];
+    VCTensor gruInput;
+    VCTensor gruHidden;
+    VCTensor decoder;
+};
+
+static uint32_t fnv1a(const void *data, size_t size, uint32_t hash) {
+    const uint8_t *bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static size_t align_up(size_t value) {
+    return (value + kSectionAlignment - 1) & ~(size_t)(kSectionAlignment - 1);
+}
+
+static int round_up16(int value) {
+    return (value + 15) & ~15;
+}
+
+#pragma mark - Configuration
+
+static int is_power_of_two(int value) {
+    return value > 0 && (value & (value - 1)) == 0;
+}
+
+static int valid_config(const VCVoiceModelConfig *config) {
+    return config->sampleRate >= 8000 && config->sampleRate <= 192000 &&
+           is_power_of_two(config->hop) && config->hop >= 32 && config->hop <= 256 &&
+           config->channels % 16 == 0 && config->channels >= 16 && config->channels <= 1024 &&
+           config->convLayers >= 1 && config->convLayers <= VC_VOICE_MODEL_MAX_CONV_LAYERS &&
+           config->kernelSize >= 1 && config->kernelSize <= 8 &&
+           config->hiddenSize % 16 == 0 && config->hiddenSize >= 16 && config->hiddenSize <= 1024;
+}
+
+void vc_voice_model_config_default(VCVoiceModelConfig *config) {
+    config->sampleRate = 48000;
+    config->hop = 128;
+    config->channels = 256;
+    config->convLayers = 6;
+    config->kernelSize = 3;
+    config->hiddenSize = 256;
+}
+
+int vc_voice_model_layer_count(const VCVoiceModelConfig *config) {
+    return config->convLayers + 4;
+}
+
+int vc_voice_model_layer_shape(const VCVoiceModelConfig *config, int index, int *outRows, int *outCols) {
+    int layers = config->convLayers;
+    if (index < 0 || index >= layers + 4) {
+        return -1;
+    }
+    int channels = config->channels;
+    int hidden = config->hiddenSize;
+    if (index == 0) {
+        *outRows = channels;
+        *outCols = 2 * config->hop;
+    } else if (index <= layers) {
+        *outRows = channels;
+        *outCols = config->kernelSize * channels;
+    } else if (index == layers + 1) {
+        *outRows = 3 * hidden;
+        *outCols = channels;
+    } else if (index == layers + 2) {
+        *outRows = 3 * hidden;
+        *outCols = hidden;
+    } else {
+        *outRows = 2 * config->hop;
+        *outCols = hidden;
+    }
+    return 0;
+}
+
+#pragma mark - Model Files
+
+/// テンソルの配置（weights / scales / bias の順に各 64 バイト境界）を決め、ファイル全体のサイズを返す
+static size_t layout_tensors(const VCVoiceModelConfig *config, VCVoiceModelTensor *tensors) {
+    int count = vc_voice_model_layer_count(config);
+    size_t offset = align_up(sizeof(VCVoiceModelHeader) + (size_t)count * sizeof(VCVoiceModelTensor));
+    for (int t = 0; t < count; t++) {
+        int rows, cols;
+        vc_voice_model_layer_shape(config, t, &rows, &cols);
+        VCVoiceModelTensor *tensor = &tensors[t];
+        memset(tensor, 0, sizeof(*tensor));
+        tensor->rows = (uint32_t)rows;
+        tensor->cols = (uint32_t)cols;
+        tensor->stride = (uint32_t)round_up16(cols);
+        tensor->weightsOffset = (uint32_t)offset;
+        offset = align_up(offset + (size_t)rows * tensor->stride);
+        tensor->scalesOffset = (uint32_t)offset;
+        offset = align_up(offset + (size_t)rows * sizeof(float));
+        tensor->biasOffset = (uint32_t)offset;
+        offset = align_up(offset + (size_t)rows * sizeof(float));
+    }
+    return offset;
+}
+
+/// 1 行を対称に量子化する（最大絶対値を 127 に合わせる）
+static float quantize_row(const float *values, int count, int8_t *out) {
+    float peak = 0;
+    for (int i = 0; i < count; i++) {
+        peak = fmaxf(peak, fabsf(values[i]));
+    }
+    if (peak == 0 || !isfinite(peak)) {
+        memset(out, 0, (size_t)count);
+        return 0;
+    }
+    float inverse = 127.0f / peak;
+    for (int i = 0; i < count; i++) {
+        long q = lrintf(values[i] * inverse);
+        out[i] = (int8_t)(q > 127 ? 127 : q < -127 ? -127 : q);
+    }
+    return peak / 127.0f;
+}
+
+int vc_voice_model_write(const char *path, const VCVoiceModelConfig *config, const VCVoiceModelLayer *layers) {
+    if (!valid_config(config)) {
+        return -1;
+    }
+    VCVoiceModelTensor tensors[VC_VOICE_MODEL_MAX_CONV_LAYERS + 4];
+    size_t size = layout_tensors(config, tensors);
+    if (size > kMaxFileSize) {
+        return -1;
+    }
+    uint8_t *bytes = vc_calloc(1, size);
+    if (bytes == NULL) {
+        return -1;
+    }
+
+    int count = vc_voice_model_layer_count(config);
+    for (int t = 0; t < count; t++) {
+        const VCVoiceModelTensor *tensor = &tensors[t];
+        for (uint32_t r = 0; r < tensor->rows; r++) {
+            float scale = quantize_row(layers[t].weights + (size_t)r * tensor->cols, (int)tensor->cols,
+                                       (int8_t *)(bytes + tensor->weightsOffset + (size_t)r * tensor->stride));
+            float bias = layers[t].bias != NULL ? layers[t].bias[r] : 0.0f;
+            memcpy(bytes + tensor->scalesOffset + r * sizeof(float), &scale, sizeof(float));
+            memcpy(bytes + tensor->biasOffset + r * sizeof(float), &bias, sizeof(float));
+        }
+    }
+    memcpy(bytes + sizeof(VCVoiceModelHeader), tensors, (size_t)count * sizeof(VCVoiceModelTensor));
+
+    VCVoiceModelHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = VC_VOICE_MODEL_MAGIC;
+    header.version = VC_VOICE_MODEL_VERSION;
+    header.sampleRate = (uint32_t)config->sampleRate;
+    header.hop = (uint32_t)config->hop;
+    header.channels = (uint32_t)config->channels;
+    header.convLayers = (uint32_t)config->convLayers;
+    header.kernelSize = (uint32_t)config->kernelSize;
+    header.hiddenSize = (uint32_t)config->hiddenSize;
+    header.tensorCount = (uint32_t)count;
+    header.checksum = fnv1a(bytes + sizeof(header), size - sizeof(header), 2166136261u);
+    memcpy(bytes, &header, sizeof(header));
+
+    FILE *file = fopen(path, "wb");
+    int status = file != NULL && fwrite(bytes, 1, size, file) == size ? 0 : -1;
+    if (file != NULL && fclose(file) != 0) {
+        status = -1;
+    }
+    vc_free(bytes);
+    return status;
+}
+
+int vc_voice_model_write_random(const char *path, const VCVoiceModelConfig *config, uint32_t seed) {
+    if (!valid_config(config)) {
+        return -1;
+    }
+    int count = vc_voice_model_layer_count(config);
+    VCVoiceModelLayer layers[VC_VOICE_MODEL_MAX_CONV_LAYERS + 4];
+    memset(layers, 0, sizeof(layers));
+    int status = 0;
+    for (int t = 0; t < count && status == 0; t++) {
+        int rows, cols;
+        vc_voice_model_layer_shape(config, t, &rows, &cols);
+        float *weights = vc_malloc((size_t)rows * cols * sizeof(float));
+        if (weights == NULL) {
+            status = -1;
+            break;
+        }
+        // 分散を入力数で割った一様乱数（残差の conv は出力を抑えて、層を重ねても発散しないように）
+        float gain = t >= 1 && t <= config->convLayers ? 0.5f : 1.0f;
+        float range = gain * sqrtf(3.0f / (float)cols);
+        for (size_t i = 0; i < (size_t)rows * cols; i++) {
+            seed = seed * 1664525u + 1013904223u;
+            weights[i] = range * ((float)(seed >> 8) / 8388608.0f - 1.0f);
+        }
+        layers[t].weights = weights;
+    }
+    if (status == 0) {
+        status = vc_voice_model_write(path, config, layers);
+    }
+    for (int t = 0; t < count; t++) {
+        vc_free((void *)layers[t].weights);
+    }
+    return status;
+}
+
+/// ヘッダ・構成・テンソルの形と範囲・チェックサムを検証する
+static int validate(const uint8_t *bytes, size_t size, VCVoiceModelConfig *outConfig) {
+    if (size < sizeof(VCVoiceModelHeader)) {
+        return 0;
+    }
+    VCVoiceModelHeader header;
+    memcpy(&header, bytes, sizeof(header));
+    if (header.magic != VC_VOICE_MODEL_MAGIC || header.version != VC_VOICE_MODEL_VERSION ||
+        header.hop > 256 || header.channels > 1024 || header.hiddenSize > 1024 ||
+        header.convLayers > VC_VOICE_MODEL_MAX_CONV_LAYERS || header.kernelSize > 8 ||
+        header.sampleRate > 192000) {
+        return 0;
+    }
+    VCVoiceModelConfig config = {
+        .sampleRate = (int)header.sampleRate,
+        .hop = (int)header.hop,
+        .channels = (int)header.channels,
+        .convLayers = (int)header.convLayers,
+        .kernelSize = (int)header.kernelSize,
+        .hiddenSize = (int)header.hiddenSize,
+    };
+    int count = vc_voice_model_layer_count(&config);
+    if (!valid_config(&config) || header.tensorCount != (uint32_t)count ||
+        sizeof(header) + (size_t)count * sizeof(VCVoiceModelTensor) > size) {
+        return 0;
+    }
+
+    for (int t = 0; t < count; t++) {
+        VCVoiceModelTensor tensor;
+        memcpy(&tensor, bytes + sizeof(header) + (size_t)t * sizeof(tensor), sizeof(tensor));
+        int rows, cols;
+        vc_voice_model_layer_shape(&config, t, &rows, &cols);
+        size_t floats = (size_t)rows * sizeof(float);
+        if (tensor.rows != (uint32_t)rows || tensor.cols != (uint32_t)cols ||
+            tensor.stride != (uint32_t)round_up16(cols) ||
+            tensor.weightsOffset % 16 != 0 || tensor.scalesOffset % 4 != 0 || tensor.biasOffset % 4 != 0 ||
+            tensor.weightsOffset > size || (size_t)rows * tensor.stride > size - tensor.weightsOffset ||
+            tensor.scalesOffset > size || floats > size - tensor.scalesOffset ||
+            tensor.biasOffset > size || floats > size - tensor.biasOffset) {
+            return 0;
+        }
+    }
+    if (fnv1a(bytes + sizeof(header), size - sizeof(header), 2166136261u) != header.checksum) {
+        return 0;
+    }
+    *outConfig = config;
+    return 1;
+}
+
+static VCTensor map_tensor(const uint8_t *bytes, int index) {
+    VCVoiceModelTensor tensor;
+    memcpy(&tensor, bytes + sizeof(VCVoiceModelHeader) + (size_t)index * sizeof(tensor), sizeof(tensor));
+    VCTensor mapped = {
+        .rows = (int)tensor.rows,
+        .cols = (int)tensor.cols,
+        .stride = (int)tensor.stride,
+        .weights = (const int8_t *)(bytes + tensor.weightsOffset),
+        .scales = (const float *)(bytes + tensor.scalesOffset),
+        .bias = (const float *)(bytes + tensor.biasOffset),
+    };
+    return mapped;
+}
+
+VCVoiceModel *vc_voice_model_open(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(VCVoiceModelHeader) || info.st_size > kMaxFileSize) {
+        close(fd);
+        return NULL;
+    }
+    size_t size = (size_t)info.st_size;
+    void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        return NULL;
+    }
+    // 検証で全体を一度読み、以降もフレームごとに全体を読むので先読みさせる
+    posix_madvise(mapping, size, POSIX_MADV_WILLNEED);
+
+    VCVoiceModelConfig config;
+    VCVoiceModel *model = validate(mapping, size, &config) ? vc_calloc(1, sizeof(VCVoiceModel)) : NULL;
+    if (model == NULL) {
+        munmap(mapping, size);
+        return NULL;
+    }
+    model->mapping = mapping;
+    model->mappingSize = size;
+    model->config = config;
+    model->encoder = map_tensor(mapping, 0);
+    for (int l = 0; l < config.convLayers; l++) {
+        model->conv[l] = map_tensor(mapping, 1 + l);
+    }
+    model->gruInput = map_tensor(mapping, config.convLayers + 1);
+    model->gruHidden = map_tensor(mapping, config.convLayers + 2);
+    model->decoder = map_tensor(mapping, config.convLayers + 3);
+    return model;
+}
+
+void vc_voice_model_close(VCVoiceModel *model) {
+    if (model == NULL) {
+        return;
+    }
+    munmap(model->mapping, model->mappingSize);
+    vc_free(model);
+}
+
+void vc_voice_model_get_config(const VCVoiceModel *model, VCVoiceModelConfig *outConfig) {
+    *outConfig = model->config;
+}
+
+long vc_voice_model_macs_per_frame(const VCVoiceModel *model) {
+    long macs = 0;
+    for (int t = 0; t < vc_voice_model_layer_count(&model->config); t++) {
+        int rows = 0, cols = 0;
+        vc_voice_model_layer_shape(&model->config, t, &rows, &cols);
+        macs += (long)rows * cols;
+    }
+    return macs;
+}
+
+size_t vc_voice_model_weight_bytes(const VCVoiceModel *model) {
+    size_t bytes = 0;
+    for (int t = 0; t < vc_voice_model_layer_count(&model->config); t++) {
+        int rows = 0, cols = 0;
+        vc_voice_model_layer_shape(&model->config, t, &rows, &cols);
+        bytes += (size_t)rows * (size_t)round_up16(cols) + 2 * (size_t)rows * sizeof(float);
+    }
+    return bytes;
+}
+
+#pragma mark - Kernels
+
+/// w（int8、count 列）と frames 本の入力（int8 の範囲の int16）の内積。count は 16 の倍数
+typedef void (*VCDotKernel)(const int8_t *w, const int16_t *const *x, int frames, int count, int32_t *out);
+
+static void dot_scalar(const int8_t *w, const int16_t *const *x, int frames, int count, int32_t *out) {
+    for (int f = 0; f < frames; f++) {
+        int32_t sum = 0;
+        for (int i = 0; i < count; i++) {
+            sum += (int32_t)w[i] * x[f][i];
+        }
+        out[f] = sum;
+    }
+}
+
+#if VC_HAS_VECTOR_EXT
+typedef int8_t vc_i8x8 __attribute__((vector_size(8)));
+typedef int16_t vc_i16x8 __attribute__((vector_size(16)));
+typedef int32_t vc_i32x8 __attribute__((vector_size(32)));
+
+// 32 バイトのベクタは値で受け渡さない（AVX なしのビルドで ABI の警告が出る）
+static inline void accumulate(vc_i32x8 *acc, vc_i16x8 lo, vc_i16x8 hi, const int16_t *x) {
+    vc_i16x8 a, b;
+    memcpy(&a, x, sizeof(a));
+    memcpy(&b, x + 8, sizeof(b));
+    // |q| ≤ 127 なので積 2 つの和（≤ 32258）までは int16 に収まり、int32 へ広げるのは 16 列に 1 回で済む
+    *acc += __builtin_convertvector(lo * a + hi * b, vc_i32x8);
+}
+
+static inline int32_t sum8(const vc_i32x8 *acc) {
+    vc_i32x8 v = *acc;
+    return ((v[0] + v[1]) + (v[2] + v[3])) + ((v[4] + v[5]) + (v[6] + v[7]));
+}
+
+/// 16 列ずつ重みを int16 へ広げ、frames 本の入力で使い回す
+/// frames は定数で展開させる（累積をレジスタに置くため。配列にすると 3〜4 割遅い）
+static inline __attribute__((always_inline)) void dot_simd_n(const int8_t *w, const int16_t *const *x,
+                                                             const int frames, int count, int32_t *out) {
+    vc_i32x8 acc0 = { 0 }, acc1 = { 0 }, acc2 = { 0 }, acc3 = { 0 };
+    for (int i = 0; i < count; i += 16) {
+        vc_i8x8 w0, w1;
+        memcpy(&w0, w + i, sizeof(w0));
+        memcpy(&w1, w + i + 8, sizeof(w1));
+        vc_i16x8 lo = __builtin_convertvector(w0, vc_i16x8);
+        vc_i16x8 hi = __builtin_convertvector(w1, vc_i16x8);
+        accumulate(&acc0, lo, hi, x[0] + i);
+        if (frames > 1) {
+            accumulate(&acc1, lo, hi, x[1] + i);
+        }
+        if (frames > 2) {
+            accumulate(&acc2, lo, hi, x[2] + i);
+        }
+        if (frames > 3) {
+            accumulate(&acc3, lo, hi, x[3] + i);
+        }
+    }
+    out[0] = sum8(&acc0);
+    if (frames > 1) {
+        out[1] = sum8(&acc1);
+    }
+    if (frames > 2) {
+        out[2] = sum8(&acc2);
+    }
+    if (frames > 3) {
+        out[3] = sum8(&acc3);
+    }
+}
+
+static void dot_simd(const int8_t *w, const int16_t *const *x, int frames, int count, int32_t *out) {
+    _Static_assert(kTile == 4, "dot_simd unrolls up to 4 frames");
+    switch (frames) {
+        case 1: dot_simd_n(w, x, 1, count, out); break;
+        case 2: dot_simd_n(w, x, 2, count, out); break;
+        case 3: dot_simd_n(w, x, 3, count, out); break;
+        default: dot_simd_n(w, x, 4, count, out); break;
+    }
+}
+#endif
+
+/// 活性 1 フレームを int8 の範囲へ対称に量子化する（stride までの余りは 0）
+static float quantize(const float *values, int count, int stride, int16_t *out) {
+    float peak = 0;
+    for (int i = 0; i < count; i++) {
+        peak = fmaxf(peak, fabsf(values[i]));
+    }
+    if (peak == 0 || !isfinite(peak)) {
+        memset(out, 0, (size_t)stride * sizeof(int16_t));
+        return 0;
+    }
+    float inverse = 127.0f / peak;
+    for (int i = 0; i < count; i++) {
+        out[i] = (int16_t)lrintf(values[i] * inverse);
+    }
+    memset(out + count, 0, (size_t)(stride - count) * sizeof(int16_t));
+    return peak / 127.0f;
+}
+
+#pragma mark - Converter
+
+typedef struct {
+    int16_t *values;        // [span][channels]（入力を量子化したもの）
+    float *scales;          // [span]
+    int span;               // 2 のべき乗（(kernelSize - 1) × dilation + kMaxBatch 以上）
+    int dilation;
+} VCConvHistory;
+
+struct VCVoiceConverter {
+    const VCVoiceModel *model;
+    int hop;
+    int channels;
+    int hidden;
+    int lookAhead;
+    VCDotKernel dot;
+    float mix;
+
+    // 推論の状態（補助スレッドがあればそちらだけが触る）
+    float *window;          // √Hann [2·hop]（分析・合成とも。積が Hann なので overlap-add で 1 に戻る）
+    float *previous;        // 直前の hop の入力
+    float *tail;            // overlap-add の後半
+    float *frames;          // 窓を掛けた encoder 入力 [2·hop]
+    int16_t *qInput;        // [kMaxBatch][2·hop]
+    float inputScales[kMaxBatch];
+    float *features;        // [kMaxBatch][channels]（conv の残差を積み上げる）
+    VCConvHistory history[VC_VOICE_MODEL_MAX_CONV_LAYERS];
+    long position;          // 推論したフレーム数（履歴の書き込み位置）
+    int16_t *qFeatures;     // [kMaxBatch][channels]
+    float featureScales[kMaxBatch];
+    float *gates;           // 入力側の GRU ゲート [kMaxBatch][3·hidden]
+    float *recurrent;       // 状態側の GRU ゲート [3·hidden]
+    float *state;           // GRU の状態 [hidden]
+    int16_t *qState;        // [hidden]
+    int16_t *qOutput;       // [kMaxBatch][hidden]
+    float outputScales[kMaxBatch];
+    float *decoded;         // [kMaxBatch][2·hop]
+
+    // オーディオスレッドとのリング
+    float *input;           // [kRingFrames][hop]（ドライの遅延線も兼ねる）
+    float *output;          // [kRingFrames][hop]
+    atomic_long tags[kRingFrames];  // 出力スロットに入っているフレーム番号（-1 = なし）
+    atomic_long requested;  // 入力が揃ったフレーム数（オーディオスレッドが書く）
+    long computed;          // 推論したフレーム数（推論する側が書く）
+    long received;          // 受け取ったフレーム数（オーディオスレッド）
+    uint64_t lateFrames;
+    atomic_uint_fast64_t computedFrames;
+
+    // 補助スレッド
+    pthread_t thread;
+    int hasThread;
+    int shuttingDown;
+    pthread_mutex_t sleepLock;
+    pthread_cond_t wakeCond;
+    pthread_mutex_t jobLock;    // 推論中に保持（reset が完了を待つ）
+};
+
+/// 重み行列と batch フレームの積（out[f][row] = scale·Σ w·x + bias）
+static void dense(const VCVoiceConverter *converter, const VCTensor *tensor, const int16_t *x, int xStride,
+                  const float *xScales, int batch, float *out, int outStride) {
+    for (int r = 0; r < tensor->rows; r++) {
+        const int8_t *row = tensor->weights + (size_t)r * tensor->stride;
+        for (int f0 = 0; f0 < batch; f0 += kTile) {
+            int tile = batch - f0 < kTile ? batch - f0 : kTile;
+            const int16_t *columns[kTile];
+            int32_t sums[kTile];
+            for (int f = 0; f < tile; f++) {
+                columns[f] = x + (size_t)(f0 + f) * xStride;
+            }
+            converter->dot(row, columns, tile, tensor->stride, sums);
+            for (int f = 0; f < tile; f++) {
+                out[(size_t)(f0 + f) * outStride + r] =
+                    (float)sums[f] * xScales[f0 + f] * tensor->scales[r] + tensor->bias[r];
+            }
+        }
+    }
+}
+
+/// 因果畳み込み（タップごとに過去フレームの量子化済み入力を履歴から読む）、ReLU して features に足す
+static void conv_layer(VCVoiceConverter *converter, const VCTensor *tensor, VCConvHistory *history, int batch) {
+    int channels = converter->channels;
+    int kernel = tensor->cols / channels;
+    int mask = history->span - 1;
+
+    // このバッチの入力を履歴へ（以降のブロックでも kernel - 1 回読み直す）
+    for (int f = 0; f < batch; f++) {
+        int slot = (int)((converter->position + f) & mask);
+        history->scales[slot] = quantize(converter->features + (size_t)f * channels, channels, channels,
+                                         history->values + (size_t)slot * channels);
+    }
+
+    for (int r = 0; r < tensor->rows; r++) {
+        const int8_t *row = tensor->weights + (size_t)r * tensor->stride;
+        for (int f0 = 0; f0 < batch; f0 += kTile) {
+            int tile = batch - f0 < kTile ? batch - f0 : kTile;
+            float sums[kTile] = { 0 };
+            for (int k = 0; k < kernel; k++) {
+                const int16_t *columns[kTile];
+                float scales[kTile];
+                int32_t dots[kTile];
+                for (int f = 0; f < tile; f++) {
+                    long frame = converter->position + f0 + f - (long)(kernel - 1 - k) * history->dilation;
+                    int slot = (int)(frame & mask);
+                    columns[f] = history->values + (size_t)slot * channels;
+                    scales[f] = history->scales[slot];
+                }
+                converter->dot(row + (size_t)k * channels, columns, tile, channels, dots);
+                for (int f = 0; f < tile; f++) {
+                    sums[f] += (float)dots[f] * scales[f];
+                }
+            }
+            for (int f = 0; f < tile; f++) {
+                float y = sums[f] * tensor->scales[r] + tensor->bias[r];
+                converter->features[(size_t)(f0 + f) * channels + r] += y > 0 ? y : 0;
+            }
+        }
+    }
+}
+
+static float sigmoidf(float x) {
+    return 1.0f / (1.0f + vc_fast_expf(-x));
+}
+
+/// GRU（入力側のゲートはバッチでまとめて、状態側はフレームごとに順に）
+static void gru(VCVoiceConverter *converter, const VCVoiceModel *model, int batch) {
+    int channels = converter->channels;
+    int hidden = converter->hidden;
+    for (int f = 0; f < batch; f++) {
+        converter->featureScales[f] = quantize(converter->features + (size_t)f * channels, channels, channels,
+                                               converter->qFeatures + (size_t)f * channels);
+    }
+    dense(converter, &model->gruInput, converter->qFeatures, channels, converter->featureScales, batch,
+          converter->gates, 3 * hidden);
+
+    for (int f = 0; f < batch; f++) {
+        float stateScale = quantize(converter->state, hidden, hidden, converter->qState);
+        dense(converter, &model->gruHidden, converter->qState, hidden, &stateScale, 1, converter->recurrent, 3 * hidden);
+        const float *gi = converter->gates + (size_t)f * 3 * hidden;
+        const float *gh = converter->recurrent;
+        int j = 0;
+#if VC_HAS_VECTOR_EXT
+        for (; j + 4 <= hidden; j += 4) {
+            vc_f32x4 reset = vc_sigmoid4(vc_load4(gi + j) + vc_load4(gh + j));
+            vc_f32x4 update = vc_sigmoid4(vc_load4(gi + hidden + j) + vc_load4(gh + hidden + j));
+            vc_f32x4 candidate = vc_tanh4(vc_load4(gi + 2 * hidden + j) + reset * vc_load4(gh + 2 * hidden + j));
+            vc_f32x4 state = vc_load4(converter->state + j);
+            vc_store4(converter->state + j, (vc_splat4(1.0f) - update) * candidate + update * state);
+        }
+#endif
+        for (; j < hidden; j++) {
+            float reset = sigmoidf(gi[j] + gh[j]);
+            float update = sigmoidf(gi[hidden + j] + gh[hidden + j]);
+            float candidate = vc_fast_tanhf(gi[2 * hidden + j] + reset * gh[2 * hidden + j]);
+            converter->state[j] = (1.0f - update) * candidate + update * converter->state[j];
+        }
+        converter->outputScales[f] = quantize(converter->state, hidden, hidden,
+                                              converter->qOutput + (size_t)f * hidden);
+    }
+}
+
+/// リングの first から batch フレームを推論し、出力スロットに書いてタグを付ける
+static void infer(VCVoiceConverter *converter, long first, int batch) {
+    const VCVoiceModel *model = converter->model;
+    int hop = converter->hop;
+    int channels = converter->channels;
+
+    // encoder（直前 + 現在の hop に窓を掛ける）
+    for (int f = 0; f < batch; f++) {
+        const float *current = converter->input + (size_t)((first + f) & (kRingFrames - 1)) * hop;
+        for (int i = 0; i < hop; i++) {
+            converter->frames[i] = converter->previous[i] * converter->window[i];
+            converter->frames[hop + i] = current[i] * converter->window[hop + i];
+        }
+        memcpy(converter->previous, current, (size_t)hop * sizeof(float));
+        converter->inputScales[f] = quantize(converter->frames, 2 * hop, 2 * hop,
+                                             converter->qInput + (size_t)f * 2 * hop);
+    }
+    dense(converter, &model->encoder, converter->qInput, 2 * hop, converter->inputScales, batch,
+          converter->features, channels);
+    for (size_t i = 0; i < (size_t)batch * channels; i++) {
+        converter->features[i] = converter->features[i] > 0 ? converter->features[i] : 0;
+    }
+
+    for (int l = 0; l < model->config.convLayers; l++) {
+        conv_layer(converter, &model->conv[l], &converter->history[l], batch);
+    }
+    converter->position += batch;
+
+    gru(converter, model, batch);
+
+    // decoder（overlap-add で前のフレームの後半と足す）
+    dense(converter, &model->decoder, converter->qOutput, converter->hidden, converter->outputScales, batch,
+          converter->decoded, 2 * hop);
+    for (int f = 0; f < batch; f++) {
+        long frame = first + f;
+        int slot = (int)(frame & (kRingFrames - 1));
+        const float *decoded = converter->decoded + (size_t)f * 2 * hop;
+        float *out = converter->output + (size_t)slot * hop;
+        for (int i = 0; i < hop; i++) {
+            out[i] = converter->tail[i] + decoded[i] * converter->window[i];
+            converter->tail[i] = decoded[hop + i] * converter->window[hop + i];
+        }
+        atomic_store_explicit(&converter->tags[slot], frame, memory_order_release);
+    }
+    atomic_fetch_add_explicit(&converter->computedFrames, (uint64_t)batch, memory_order_relaxed);
+}
+
+#pragma mark - Worker Thread
+
+static int has_pending_frames(VCVoiceConverter *converter) {
+    return converter->computed < atomic_load_explicit(&converter->requested, memory_order_acquire);
+}
+
+static void *worker_main(void *arg) {
+    VCVoiceConverter *converter = (VCVoiceConverter *)arg;
+    vc_denormals_flush_thread();
+
+    for (;;) {
+        pthread_mutex_lock(&converter->jobLock);
+        long pending = atomic_load_explicit(&converter->requested, memory_order_acquire) - converter->computed;
+        if (pending > 0) {
+            int batch = pending < kMaxBatch ? (int)pending : kMaxBatch;
+            infer(converter, converter->computed, batch);
+            converter->computed += batch;
+        }
+        pthread_mutex_unlock(&converter->jobLock);
+        if (pending > 0) {
+            continue;
+        }
+
+        // オーディオスレッドは trylock でしか起こさないので、取りこぼしに備えて時間で区切って待つ
+        pthread_mutex_lock(&converter->sleepLock);
+        if (!converter->shuttingDown && !has_pending_frames(converter)) {
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += kWakeTimeoutNs;
+            if (deadline.tv_nsec >= 1000000000L) {
+                deadline.tv_sec += 1;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&converter->wakeCond, &converter->sleepLock, &deadline);
+        }
+        int done = converter->shuttingDown;
+        pthread_mutex_unlock(&converter->sleepLock);
+
+        if (done) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+static void wake_worker(VCVoiceConverter *converter) {
+    if (pthread_mutex_trylock(&converter->sleepLock) == 0) {
+        pthread_cond_signal(&converter->wakeCond);
+        pthread_mutex_unlock(&converter->sleepLock);
+    }
+}
+
+static void stop_worker(VCVoiceConverter *converter) {
+    if (!converter->hasThread) {
+        return;
+    }
+    pthread_mutex_lock(&converter->sleepLock);
+    converter->shuttingDown = 1;
+    pthread_cond_signal(&converter->wakeCond);
+    pthread_mutex_unlock(&converter->sleepLock);
+    pthread_join(converter->thread, NULL);
+    converter->hasThread = 0;
+}
+
+#pragma mark - Lifecycle
+
+/// 状態・履歴・リングを 0 に戻す
+static void clear_state(VCVoiceConverter *converter) {
+    int hop = converter->hop;
+    memset(converter->previous, 0, (size_t)hop * sizeof(float));
+    memset(converter->tail, 0, (size_t)hop * sizeof(float));
+    memset(converter->state, 0, (size_t)converter->hidden * sizeof(float));
+    for (int l = 0; l < converter->model->config.convLayers; l++) {
+        VCConvHistory *history = &converter->history[l];
+        memset(history->values, 0, (size_t)history->span * converter->channels * sizeof(int16_t));
+        memset(history->scales, 0, (size_t)history->span * sizeof(float));
+    }
+    memset(converter->input, 0, (size_t)kRingFrames * hop * sizeof(float));
+    memset(converter->output, 0, (size_t)kRingFrames * hop * sizeof(float));
+    for (int i = 0; i < kRingFrames; i++) {
+        atomic_store(&converter->tags[i], -1);
+    }
+    atomic_store(&converter->requested, 0);
+    converter->computed = 0;
+    converter->received = 0;
+    converter->position = 0;
+}
+
+static void *aligned_zeroed(size_t size) {
+    void *pointer = vc_aligned_alloc(kSectionAlignment, align_up(size));
+    if (pointer != NULL) {
+        memset(pointer, 0, align_up(size));
+    }
+    return pointer;
+}
+
+VCVoiceConverter *vc_voice_converter_create(const VCVoiceModel *model, const VCVoiceConverterOptions *options) {
+    if (model == NULL) {
+        return NULL;
+    }
+    VCVoiceConverterOptions defaults = { 0, 0 };
+    if (options == NULL) {
+        options = &defaults;
+    }
+    if (options->lookAheadFrames < 0 || options->lookAheadFrames > VC_VOICE_CONVERTER_MAX_LOOKAHEAD) {
+        return NULL;
+    }
+
+    VCVoiceConverter *converter = vc_calloc(1, sizeof(VCVoiceConverter));
+    if (converter == NULL) {
+        return NULL;
+    }
+    const VCVoiceModelConfig *config = &model->config;
+    int hop = config->hop;
+    int channels = config->channels;
+    int hidden = config->hiddenSize;
+    converter->model = model;
+    converter->hop = hop;
+    converter->channels = channels;
+    converter->hidden = hidden;
+    converter->lookAhead = options->lookAheadFrames;
+    converter->mix = 1.0f;
+#if VC_HAS_VECTOR_EXT
+    converter->dot = options->scalarKernels ? dot_scalar : dot_simd;
+#else
+    converter->dot = dot_scalar;
+#endif
+    pthread_mutex_init(&converter->sleepLock, NULL);
+    pthread_cond_init(&converter->wakeCond, NULL);
+    pthread_mutex_init(&converter->jobLock, NULL);
+
+    converter->window = aligned_zeroed((size_t)2 * hop * sizeof(float));
+    converter->previous = aligned_zeroed((size_t)hop * sizeof(float));
+    converter->tail = aligned_zeroed((size_t)hop * sizeof(float));
+    converter->frames = aligned_zeroed((size_t)2 * hop * sizeof(float));
+    converter->qInput = aligned_zeroed((size_t)kMaxBatch * 2 * hop * sizeof(int16_t));
+    converter->features = aligned_zeroed((size_t)kMaxBatch * channels * sizeof(float));
+    converter->qFeatures = aligned_zeroed((size_t)kMaxBatch * channels * sizeof(int16_t));
+    converter->gates = aligned_zeroed((size_t)kMaxBatch * 3 * hidden * sizeof(float));
+    converter->recurrent = aligned_zeroed((size_t)3 * hidden * sizeof(float));
+    converter->state = aligned_zeroed((size_t)hidden * sizeof(float));
+    converter->qState = aligned_zeroed((size_t)hidden * sizeof(int16_t));
+    converter->qOutput = aligned_zeroed((size_t)kMaxBatch * hidden * sizeof(int16_t));
+    converter->decoded = aligned_zeroed((size_t)kMaxBatch * 2 * hop * sizeof(float));
+    converter->input = aligned_zeroed((size_t)kRingFrames * hop * sizeof(float));
+    converter->output = aligned_zeroed((size_t)kRingFrames * hop * sizeof(float));
+    int failed = converter->window == NULL || converter->previous == NULL || converter->tail == NULL ||
+                 converter->frames == NULL || converter->qInput == NULL || converter->features == NULL ||
+                 converter->qFeatures == NULL || converter->gates == NULL || converter->recurrent == NULL ||
+                 converter->state == NULL || converter->qState == NULL || converter->qOutput == NULL ||
+                 converter->decoded == NULL || converter->input == NULL || converter->output == NULL;
+    for (int l = 0; l < config->convLayers && !failed; l++) {
+        VCConvHistory *history = &converter->history[l];
+        history->dilation = 1 << l;
+        int needed = (config->kernelSize - 1) * history->dilation + kMaxBatch;
+        history->span = 1;
+        while (history->span < needed) {
+            history->span <<= 1;
+        }
+        history->values = aligned_zeroed((size_t)history->span * channels * sizeof(int16_t));
+        history->scales = aligned_zeroed((size_t)history->span * sizeof(float));
+        failed = history->values == NULL || history->scales == NULL;
+    }
+    if (failed) {
+        vc_voice_converter_destroy(converter);
+        return NULL;
+    }
+
+    // 周期的な √Hann（2 乗の Hann は hop ずらしで足すと 1）
+    for (int i = 0; i < 2 * hop; i++) {
+        converter->window[i] = sinf((float)M_PI * ((float)i + 0.5f) / (float)(2 * hop));
+    }
+    clear_state(converter);
+
+    if (converter->lookAhead > 0 && pthread_create(&converter->thread, NULL, worker_main, converter) == 0) {
+        converter->hasThread = 1;
+    }
+    return converter;
+}
+
+void vc_voice_converter_destroy(VCVoiceConverter *converter) {
+    if (converter == NULL) {
+        return;
+    }
+    stop_worker(converter);
+    vc_free(converter->window);
+    vc_free(converter->previous);
+    vc_free(converter->tail);
+    vc_free(converter->frames);
+    vc_free(converter->qInput);
+    vc_free(converter->features);
+    vc_free(converter->qFeatures);
+    vc_free(converter->gates);
+    vc_free(converter->recurrent);
+    vc_free(converter->state);
+    vc_free(converter->qState);
+    vc_free(converter->qOutput);
+    vc_free(converter->decoded);
+    vc_free(converter->input);
+    vc_free(converter->output);
+    for (int l = 0; l < VC_VOICE_MODEL_MAX_CONV_LAYERS; l++) {
+        vc_free(converter->history[l].values);
+        vc_free(converter->history[l].scales);
+    }
+    pthread_mutex_destroy(&converter->jobLock);
+    pthread_cond_destroy(&converter->wakeCond);
+    pthread_mutex_destroy(&converter->sleepLock);
+    vc_free(converter);
+}
+
+void vc_voice_converter_reset(VCVoiceConverter *converter) {
+    // 推論中のバッチが終わるのを待ってから消す
+    pthread_mutex_lock(&converter->jobLock);
+    clear_state(converter);
+    pthread_mutex_unlock(&converter->jobLock);
+}
+
+int vc_voice_converter_try_reset(VCVoiceConverter *converter) {
+    if (pthread_mutex_trylock(&converter->jobLock) != 0) {
+        return -1;
+    }
+    clear_state(converter);
+    pthread_mutex_unlock(&converter->jobLock);
+    return 0;
+}
+
+void vc_voice_converter_set_mix(VCVoiceConverter *converter, float mix) {
+    converter->mix = fmaxf(0.0f, fminf(1.0f, mix));
+}
+
+int vc_voice_converter_hop(const VCVoiceConverter *converter) {
+    return converter->hop;
+}
+
+int vc_voice_converter_latency(const VCVoiceConverter *converter) {
+    return converter->hop * (1 + converter->lookAhead);
+}
+
+void vc_voice_converter_get_stats(const VCVoiceConverter *converter, VCVoiceConverterStats *outStats) {
+    outStats->frames = (uint64_t)converter->received;
+    outStats->computed = atomic_load_explicit(&((VCVoiceConverter *)converter)->computedFrames, memory_order_relaxed);
+    outStats->lateFrames = converter->lateFrames;
+}
+
+#pragma mark - Processing
+
+/// frame 番目の出力（hop 遅れのドライと混ぜる。結果がなければドライのまま）
+static void emit_frame(VCVoiceConverter *converter, long frame, float *out) {
+    int hop = converter->hop;
+    if (frame < 1) {
+        memset(out, 0, (size_t)hop * sizeof(float));
+        return;
+    }
+    // overlap-add の遅延（hop）に合わせ、1 つ前のフレームの入力をドライにする
+    const float *dry = converter->input + (size_t)((frame - 1) & (kRingFrames - 1)) * hop;
+    int slot = (int)(frame & (kRingFrames - 1));
+    if (atomic_load_explicit(&converter->tags[slot], memory_order_acquire) != frame) {
+        converter->lateFrames++;
+        memcpy(out, dry, (size_t)hop * sizeof(float));
+        return;
+    }
+    const float *wet = converter->output + (size_t)slot * hop;
+    float mix = converter->mix;
+    for (int i = 0; i < hop; i++) {
+        out[i] = dry[i] + mix * (wet[i] - dry[i]);
+    }
+}
+
+int vc_voice_converter_process(VCVoiceConverter *converter, const float *input, float *output, int count) {
+    int hop = converter->hop;
+    if (count % hop != 0) {
+        return -1;
+    }
+
+    for (int offset = 0; offset < count; offset += kMaxBatch * hop) {
+        int batch = (count - offset) / hop < kMaxBatch ? (count - offset) / hop : kMaxBatch;
+        long first = converter->received;
+
+        // 入力を先にリングへ取り込む（input == output でも読み終えてから書く）
+        for (int f = 0; f < batch; f++) {
+            memcpy(converter->input + (size_t)((first + f) & (kRingFrames - 1)) * hop,
+                   input + offset + (size_t)f * hop, (size_t)hop * sizeof(float));
+        }
+        converter->received += batch;
+        atomic_store_explicit(&converter->requested, converter->received, memory_order_release);
+        if (converter->hasThread) {
+            wake_worker(converter);
+        } else {
+            infer(converter, first, batch);
+            converter->computed += batch;
+        }
+
+        for (int f = 0; f < batch; f++) {
+            emit_frame(converter, first + f - converter->lookAhead, output + offset + (size_t)f * hop);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+//
+//  VCAnalysis.h
+//  VoiceChanger
+//
+//  Per-block analysis shared between chain stages
+//
+
+#ifndef VCAnalysis_h
+#define VCAnalysis_h
+
+#include "VCArena.h"
+#include "VCPitch.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 1ブロック分の解析結果
+///
+/// チェーンが解析段（VAD・ピッチ）の直後に埋め、後段はこれを読むだけにする。
+/// 同じブロックを各段が別々に解析しないための共有置き場。
+typedef struct {
+    int speech;             // VAD の判定（vadEnabled = 0 なら常に 1）
+    float activity;         // VAD の activity（0〜1）
+    VCPitchEstimate pitch;  // 非発話ブロックでは探索を省くので f0 = 0
+} VCBlockAnalysis;
+
+// MARK: - Spectral Analysis Context
+
+/// STFT の設定（48kHz で窓 5.3 ms、ホップ 2.7 ms）
+#define VC_ANALYSIS_FFT_SIZE    256
+#define VC_ANALYSIS_HOP         128
+#define VC_ANALYSIS_BINS        (VC_ANALYSIS_FFT_SIZE / 2 + 1)
+#define VC_ANALYSIS_MAX_FRAMES  32      // 1ブロックの最大フレーム数（4096 サンプル）
+#define VC_ANALYSIS_LPC_ORDER   24      // 48kHz で 4〜5 フォルマント + 声門・放射特性
+
+/// ブロック単位のスペクトル解析（不透明型）
+///
+/// ブロックの先頭で vc_analysis_begin_block にサンプルを渡しておくと、
+/// 各段が最初に要求したときだけ窓掛け + FFT・振幅・対数スペクトル・LPC を計算し、
+/// 同じブロックの2回目以降の要求はキャッシュを返す。
+/// フレームはブロック末尾から VC_ANALYSIS_HOP ずつ遡った位置で終わる Hann 窓（古い順に 0〜）。
+/// 返すポインタは次の begin_block まで有効。
+/// 作業領域は作成時に最大ブロック長分を確保し、以降はメモリ確保・ロックなし。
+typedef struct VCAnalysisContext VCAnalysisContext;
+
+/// 作成（失敗時 NULL）
+/// - Parameters:
+///   - maxFrameSize: 最大ブロック長（これより長いブロックは末尾側のフレームだけを解析する）
+///   - cache: FFT プランと窓をここから取る（NULL なら自前で作る）。コンテキストより長く生存すること
+VCAnalysisContext *vc_analysis_create(int maxFrameSize, VCPlanCache *cache);
+void vc_analysis_destroy(VCAnalysisContext *context);
+
+/// 履歴とキャッシュを破棄（FFT 回数は保持）
+void vc_analysis_reset(VCAnalysisContext *context);
+
+/// ブロックのサンプルを取り込み、キャッシュを無効にする（count は任意長）
+void vc_analysis_begin_block(VCAnalysisContext *context, const float *samples, int count);
+
+/// このブロックのフレーム数（最新フレームは count - 1）
+int vc_analysis_frame_count(const VCAnalysisContext *context);
+
+/// 窓掛け後の複素スペクトル（split 形式、VC_ANALYSIS_BINS、スケールなし）
+void vc_analysis_spectrum(VCAnalysisContext *context, int frame, const float **outRe, const float **outIm);
+
+/// パワー |X|^2 / 振幅 |X| / 対数パワー ln(|X|^2 + ε)（いずれも VC_ANALYSIS_BINS）
+const float *vc_analysis_power(VCAnalysisContext *context, int frame);
+const float *vc_analysis_magnitude(VCAnalysisContext *context, int frame);
+const float *vc_analysis_log_spectrum(VCAnalysisContext *context, int frame);
+
+/// 最新フレームの LPC 係数 a[0..VC_ANALYSIS_LPC_ORDER]（a[0] = 1、予測は x[n] ≈ -Σ a[k] x[n-k]）
+/// 自己相関はパワースペクトルの逆 FFT から求める（Levinson-Durbin）
+/// - Parameter outError: 正規化予測誤差（0〜1、NULL 可）
+const float *vc_analysis_lpc(VCAnalysisContext *context, float *outError);
+
+/// 作成からの FFT 回数（順変換 + 逆変換）
+uint64_t vc_analysis_fft_count(const VCAnalysisContext *context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCAnalysis_h */
@@ -0,0 +1,99 @@
+//
+//  VCArena.h
+//  VoiceChanger
+//
+//  Preallocated arena, FFT plan / window cache and allocation accounting
+//
+
+#ifndef VCArena_h
+#define VCArena_h
+
+#include "VCFFT.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// MARK: - Arena
+
+/// 連続領域から切り出すだけのアロケータ（不透明型）
+///
+/// 準備時に最大構成で一度だけ確保し、処理中に使う作業領域をここから割り当てる。
+/// 個別の解放はなく、破棄（または reset）でまとめて返す。
+typedef struct VCArena VCArena;
+
+/// 作成（capacity はバイト数、失敗時 NULL）
+VCArena *vc_arena_create(size_t capacity);
+void vc_arena_destroy(VCArena *arena);
+
+/// 64 バイト境界に揃えたゼロ埋め領域（残りが足りなければ NULL）
+void *vc_arena_alloc(VCArena *arena, size_t size);
+
+/// float 配列（vc_arena_alloc と同じ）
+float *vc_arena_floats(VCArena *arena, int count);
+
+size_t vc_arena_used(const VCArena *arena);
+size_t vc_arena_capacity(const VCArena *arena);
+
+/// 全領域を未使用に戻す（切り出したポインタを誰も使っていないときに呼ぶこと）
+void vc_arena_reset(VCArena *arena);
+
+// MARK: - Plan Cache
+
+/// 窓関数（いずれも周期窓）
+typedef enum {
+    VC_WINDOW_HANN = 0,
+    VC_WINDOW_SQRT_HANN = 1,    // 分析・合成の両方に掛ける WOLA 用
+    VC_WINDOW_TYPE_COUNT
+} VCWindowType;
+
+/// FFT プランと窓テーブルのキャッシュ（サイズごとに1つ、不透明型）
+///
+/// 作成は確保を伴うので prepare 時に行い、処理中は作成済みのものを引くだけにする。
+/// プランは作業領域を共有するため、1つのキャッシュは1つの処理スレッド（チェーン）で使うこと。
+typedef struct VCPlanCache VCPlanCache;
+
+VCPlanCache *vc_plan_cache_create(void);
+
+/// キャッシュが作ったプラン・窓もすべて破棄する
+void vc_plan_cache_destroy(VCPlanCache *cache);
+
+/// ブロック長 maxFrameSize までの各 2 のべき乗サイズと、その 2 倍（50% オーバーラップ用）の
+/// プラン・Hann / √Hann 窓をまとめて作る
+/// - Returns: 0 = 成功、-1 = 確保失敗
+int vc_plan_cache_prepare(VCPlanCache *cache, int maxFrameSize);
+
+/// size の FFT プラン（未作成なら作成する、size が 2 のべき乗でなければ NULL）
+VCFFTPlan *vc_plan_cache_fft(VCPlanCache *cache, int size);
+
+/// size の窓テーブル（未作成なら作成する）
+const float *vc_plan_cache_window(VCPlanCache *cache, VCWindowType type, int size);
+
+// MARK: - Allocation Accounting
+
+/// VCCore がこれまでに行ったヒープ確保の回数（全スレッド合計）
+uint64_t vc_alloc_count(void);
+
+/// 呼び出しスレッドをリアルタイム区間に入れる / 出す（入れ子可）
+/// オーディオスレッドの処理をこれで囲むと、区間内の確保が vc_realtime_alloc_count に数えられる
+void vc_realtime_enter(void);
+void vc_realtime_exit(void);
+
+/// リアルタイム区間で行われた確保の回数（0 であるべき）
+uint64_t vc_realtime_alloc_count(void);
+
+/// リアルタイム区間の確保を VCCore の外（Swift の配列・クロージャの捕捉・Task、libc）も含めて数える（既定は無効）
+/// 全スレッドの malloc にフックが入るので、テストや計測のときだけ有効にすること
+/// - Returns: 1 = 数えている（Darwin）、0 = この環境では数えられない
+int vc_realtime_track_heap(int enabled);
+
+/// vc_realtime_track_heap が有効な間に、リアルタイム区間でプロセスのヒープから確保した回数（VCCore の確保も含む）
+uint64_t vc_realtime_heap_alloc_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCArena_h */
@@ -0,0 +1,76 @@
+//
+//  VCAudioRing.h
+//  VoiceChanger
+//
+//  Portable lock-free SPSC float ring with zero-copy region access
+//
+
+#ifndef VCAudioRing_h
+#define VCAudioRing_h
+
+#include "VCSharedRing.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// オーディオリング（不透明型）
+///
+/// 書き込み1スレッド・読み出し1スレッドの SPSC リング。
+/// *_regions で内部バッファを直接参照し、commit_* で確定する（コピーなし）。
+/// いずれの操作もロック・メモリ確保をしない。
+/// 中身は VCSharedRing をヒープ上に置いたもの（共有メモリのリングと同じコア）。
+typedef struct VCAudioRing VCAudioRing;
+
+/// リング作成（容量はフレーム数、2のべき乗に切り上げ）
+VCAudioRing *vc_audio_ring_create(int capacity);
+void vc_audio_ring_destroy(VCAudioRing *ring);
+
+int vc_audio_ring_capacity(const VCAudioRing *ring);
+
+/// 共有リングとしてのビュー（リングと同じ寿命）
+VCSharedRing *vc_audio_ring_view(VCAudioRing *ring);
+
+/// consumer が1回に読むフレーム数を公開する（consumer 側。0 以下は 1。作成時は 1）
+/// 読み出しの単位を producer と共有するためのもので、リングの動作は変わらない
+void vc_audio_ring_set_block_size(VCAudioRing *ring, int blockSize);
+
+/// vc_audio_ring_set_block_size で公開した値（どちらのスレッドからも。ロックしない）
+int vc_audio_ring_block_size(const VCAudioRing *ring);
+
+/// 読み出し可能フレーム数（どちらのスレッドからも呼び出し可）
+int vc_audio_ring_available_read(const VCAudioRing *ring);
+
+/// 書き込み可能フレーム数
+int vc_audio_ring_available_write(const VCAudioRing *ring);
+
+/// 書き込み領域の取得（producer）
+/// - Returns: 取得できたフレーム数（count 以下）
+int vc_audio_ring_write_regions(VCAudioRing *ring, int count, VCRingRegions *outRegions);
+
+/// 書き込み確定（producer）
+void vc_audio_ring_commit_write(VCAudioRing *ring, int count);
+
+/// 読み出し領域の取得（consumer、確定するまで消費されない）
+/// - Returns: 取得できたフレーム数（count 以下）
+int vc_audio_ring_read_regions(VCAudioRing *ring, int count, VCRingRegions *outRegions);
+
+/// 読み出し確定（consumer）。読み出さずに捨てる場合にも使う
+void vc_audio_ring_commit_read(VCAudioRing *ring, int count);
+
+/// コピー書き込み
+/// - Returns: 書き込んだフレーム数
+int vc_audio_ring_write(VCAudioRing *ring, const float *samples, int count);
+
+/// コピー読み出し
+/// - Returns: 読み出したフレーム数
+int vc_audio_ring_read(VCAudioRing *ring, float *samples, int count);
+
+/// 空にする（producer / consumer とも停止しているときに呼ぶこと）
+void vc_audio_ring_reset(VCAudioRing *ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCAudioRing_h */
@@ -0,0 +1,90 @@
+//
+//  VCBatch.h
+//  VoiceChanger
+//
+//  Structure-of-arrays kernels that advance 4/8/16 streams per sample
+//
+
+#ifndef VCBatch_h
+#define VCBatch_h
+
+#include "VCBiquad.h"
+#include "VCChain.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 1バッチあたりの最大レーン（ストリーム）数
+#define VC_BATCH_MAX_LANES 16
+
+/// バッチデータのレイアウト: samples[frame * lanes + lane]（レーン方向にインターリーブ）
+/// lanes は 4 の倍数（4 / 8 / 16）
+
+/// SoA Biquad（レーンごとに独立した係数と状態）
+typedef struct {
+    int lanes;
+    float b0[VC_BATCH_MAX_LANES] __attribute__((aligned(16)));
+    float b1[VC_BATCH_MAX_LANES] __attribute__((aligned(16)));
+    float b2[VC_BATCH_MAX_LANES] __attribute__((aligned(16)));
+    float a1[VC_BATCH_MAX_LANES] __attribute__((aligned(16)));
+    float a2[VC_BATCH_MAX_LANES] __attribute__((aligned(16)));
+    float x1[VC_BATCH_MAX_LANES] __attribute__((aligned(16)));
+    float x2[VC_BATCH_MAX_LANES] __attribute__((aligned(16)));
+    float y1[VC_BATCH_MAX_LANES] __attribute__((aligned(16)));
+    float y2[VC_BATCH_MAX_LANES] __attribute__((aligned(16)));
+} VCBiquadBatch;
+
+/// 初期化（全レーンをパススルー係数に）
+/// - Returns: 0 成功、-1 不正なレーン数
+int vc_biquad_batch_init(VCBiquadBatch *batch, int lanes);
+
+/// レーンの係数設定
+void vc_biquad_batch_set_lane(VCBiquadBatch *batch, int lane, const VCBiquadCoeffs *coeffs);
+
+/// 全レーンのフィルタ処理（インプレース）
+void vc_biquad_batch_process(VCBiquadBatch *batch, float *samples, int frames);
+
+/// 状態リセット
+void vc_biquad_batch_reset(VCBiquadBatch *batch);
+
+/// SoA リミッター（VCLimiter と同じ特性）
+typedef struct {
+    int lanes;
+    float ceiling[VC_BATCH_MAX_LANES] __attribute__((aligned(16)));
+    float threshold[VC_BATCH_MAX_LANES] __attribute__((aligned(16)));
+    float envelope[VC_BATCH_MAX_LANES] __attribute__((aligned(16)));
+    float attackCoeff;
+    float releaseCoeff;
+} VCLimiterBatch;
+
+int vc_limiter_batch_init(VCLimiterBatch *batch, int lanes);
+void vc_limiter_batch_process(VCLimiterBatch *batch, float *samples, int frames);
+void vc_limiter_batch_reset(VCLimiterBatch *batch);
+
+/// 個別ストリームのバッファをバッチレイアウトへ詰める（NULL のレーンは無音）
+void vc_batch_pack(const float *const *inputs, float *samples, int lanes, int frames);
+
+/// バッチレイアウトから個別ストリームへ戻す（NULL のレーンは捨てる）
+void vc_batch_unpack(const float *samples, float *const *outputs, int lanes, int frames);
+
+/// 同一トポロジ（HPF → VAD → NS → AGC → EQ → Limiter）のチェーンを lanes 本まとめて処理する
+/// VAD はレーンごとに持ち、vadEnabled のレーンは VCChain と同じく非発話区間で NS を一定ゲインへ移し、AGC を据え置く
+typedef struct VCChainBatch VCChainBatch;
+
+VCChainBatch *vc_chain_batch_create(int lanes, int sampleRate);
+void vc_chain_batch_destroy(VCChainBatch *batch);
+int vc_chain_batch_lanes(const VCChainBatch *batch);
+void vc_chain_batch_set_lane_params(VCChainBatch *batch, int lane, const VCChainParams *params);
+void vc_chain_batch_reset(VCChainBatch *batch);
+
+/// バッチレイアウトのブロックを処理（input == output のインプレース処理可）
+/// 各レーンの結果は、同じパラメータの vc_chain_process に同じ長さのブロックを渡したときと一致する
+/// （VAD・AGC はブロック単位なので、VC_MAX_FRAME_SIZE を超えるブロックはその長さごとに分けて処理する）
+void vc_chain_batch_process(VCChainBatch *batch, const float *input, float *output, int frames);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCBatch_h */
@@ -0,0 +1,64 @@
+//
+//  VCBiquad.h
+//  VoiceChanger
+//
+//  Portable biquad filter kernel (RBJ cookbook, Direct Form I)
+//
+
+#ifndef VCBiquad_h
+#define VCBiquad_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Biquad係数（a0で正規化済み）
+typedef struct {
+    float b0;
+    float b1;
+    float b2;
+    float a1;
+    float a2;
+} VCBiquadCoeffs;
+
+/// Biquadフィルタ状態
+typedef struct {
+    float x1;
+    float x2;
+    float y1;
+    float y2;
+} VCBiquadState;
+
+/// パススルー係数
+void vc_biquad_set_identity(VCBiquadCoeffs *coeffs);
+
+/// ハイパス係数
+void vc_biquad_set_highpass(VCBiquadCoeffs *coeffs, float frequency, float q, float sampleRate);
+
+/// ローパス係数
+void vc_biquad_set_lowpass(VCBiquadCoeffs *coeffs, float frequency, float q, float sampleRate);
+
+/// オールパス係数（振幅 1 のまま frequency で位相が -180° 回る）
+void vc_biquad_set_allpass(VCBiquadCoeffs *coeffs, float frequency, float q, float sampleRate);
+
+/// Low Shelf 係数
+void vc_biquad_set_lowshelf(VCBiquadCoeffs *coeffs, float frequency, float gainDb, float sampleRate);
+
+/// High Shelf 係数
+void vc_biquad_set_highshelf(VCBiquadCoeffs *coeffs, float frequency, float gainDb, float sampleRate);
+
+/// Peaking EQ 係数
+void vc_biquad_set_peaking(VCBiquadCoeffs *coeffs, float frequency, float gainDb, float q, float sampleRate);
+
+/// フィルタ処理（input == output のインプレース処理可）
+void vc_biquad_process(const VCBiquadCoeffs *coeffs, VCBiquadState *state,
+                       const float *input, float *output, int count);
+
+/// 状態リセット
+void vc_biquad_reset(VCBiquadState *state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCBiquad_h */
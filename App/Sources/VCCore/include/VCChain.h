@@ -0,0 +1,150 @@
+//
+//  VCChain.h
+//  VoiceChanger
+//
+//  Portable DSP chain (HPF → AEC → VAD/Pitch → NS → AGC → Voice conversion → Multiband → EQ → Convolution → Limiter)
+//
+
+#ifndef VCChain_h
+#define VCChain_h
+
+#include "VCAnalysis.h"
+#include "VCConvolver.h"
+#include "VCEchoCanceller.h"
+#include "VCMonitor.h"
+#include "VCMultiband.h"
+#include "VCOversampler.h"
+#include "VCSignalGuard.h"
+#include "VCVad.h"
+#include "VCVoiceConverter.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 最大フレームサイズ（LatencyMode.highQuality）
+#define VC_MAX_FRAME_SIZE 512
+
+/// エコー参照の最大数（モニター出力 + リスニング出力）
+#define VC_CHAIN_MAX_ECHO_REFERENCES 2
+
+/// エコーキャンセラの処理単位（フレームサイズはこの倍数であること）
+#define VC_CHAIN_AEC_BLOCK_SIZE 128
+
+/// 信号ガードがリセットを数えるモジュール（VCSignalGuardStats.moduleResets の添字）
+typedef enum {
+    VC_CHAIN_MODULE_HPF = 0,
+    VC_CHAIN_MODULE_AEC,
+    VC_CHAIN_MODULE_VOICE,
+    VC_CHAIN_MODULE_MULTIBAND,
+    VC_CHAIN_MODULE_EQ,
+    VC_CHAIN_MODULE_CONVOLVER,
+    VC_CHAIN_MODULE_LIMITER,
+    VC_CHAIN_MODULE_COUNT
+} VCChainModule;
+
+/// チェーンパラメータ（VoicePreset に対応）
+typedef struct {
+    float pitchShift;               // -12 to +12 semitones
+    float formantShift;             // -1.0 to +1.0
+    float eqLow;                    // dB
+    float eqMid;
+    float eqHigh;
+    int noiseSuppressionEnabled;
+    float noiseSuppressionStrength; // 0 to 1
+    int agcEnabled;
+    float agcTargetDb;
+    int vadEnabled;                 // 非発話区間で NS を簡略化し、AGC の更新を止め、マルチバンドを省略する（声質変換・畳み込みは続ける）
+    int multibandEnabled;           // 帯域別コンプレッサー + ディエッサー
+    float compressorThresholdDb;    // 下3帯域
+    float compressorRatio;
+    float deEsserThresholdDb;       // 最上位帯域（歯擦音）
+    float deEsserRatio;
+    float convolutionMix;           // 0 = ドライのみ、1 = 畳み込み結果のみ（畳み込みが設定されているとき）
+    int limiterOversampling;        // リミッターを処理する倍率（1 / 2 / 4。折り返しを抑える代わりに遅延が増える）
+} VCChainParams;
+
+/// デフォルトパラメータ（VoicePreset.default と同値）
+void vc_chain_params_default(VCChainParams *params);
+
+/// DSPチェーン（不透明型）
+typedef struct VCChain VCChain;
+
+/// チェーン作成（失敗時NULL）
+VCChain *vc_chain_create(int sampleRate);
+
+/// チェーン破棄
+void vc_chain_destroy(VCChain *chain);
+
+/// 共有のプランキャッシュを使うよう作業領域を作り直す（オーディオスレッドからは呼ばないこと）
+/// 作成直後も VC_MAX_FRAME_SIZE 分の領域と自前のプランで準備済みで、process はメモリ確保をしない
+/// - Parameter cache: チェーンより長く生存し、他の処理スレッドと共有しないこと（NULL で自前に戻す）
+/// - Returns: 0 = 成功、-1 = 確保失敗（以前の状態のまま）
+int vc_chain_prepare(VCChain *chain, VCPlanCache *cache);
+
+/// パラメータ適用（processと同一スレッド、またはprocess外から呼ぶこと）
+void vc_chain_set_params(VCChain *chain, const VCChainParams *params);
+
+/// 現在のパラメータ取得
+void vc_chain_get_params(const VCChain *chain, VCChainParams *outParams);
+
+/// フィルタ状態のリセット
+void vc_chain_reset(VCChain *chain);
+
+/// エコー参照（出力コールバックが実際に鳴らした信号を push する VCMonitor）を設定する
+/// 参照が1つ以上あるとき HPF の直後でエコーキャンセルを行う。NULL で解除。
+/// 初回設定時にキャンセラを確保するため、オーディオスレッドからは呼ばないこと（process と同一スレッドは可）
+/// - Parameter reference: 設定時に溜まっている分を捨てて同期し直す。チェーンより長く生存すること
+/// - Returns: 0 = 成功、-1 = slot 範囲外 / 確保失敗
+int vc_chain_set_echo_reference(VCChain *chain, int slot, VCMonitor *reference);
+
+/// 畳み込み（プリセットが参照する IR）を設定する。NULL で解除
+/// EQ の後・リミッターの前で params.convolutionMix に応じてドライと混ぜる
+/// processと同一スレッド、またはprocess外から呼ぶこと。convolver は設定中チェーンより長く生存すること
+void vc_chain_set_convolver(VCChain *chain, VCConvolver *convolver);
+
+/// 声質変換（ニューラル）を設定する。NULL で解除
+/// AGC の後・マルチバンドの前で処理し、count が hop の倍数でないブロックは素通しにする。
+/// processと同一スレッド、またはprocess外から呼ぶこと。converter は設定中チェーンより長く生存すること
+void vc_chain_set_voice_converter(VCChain *chain, VCVoiceConverter *converter);
+
+/// チェーン自体が加える遅延（サンプル。リミッターのオーバーサンプリング分と声質変換の分）
+float vc_chain_latency(const VCChain *chain);
+
+/// マルチバンドダイナミクスの直近のゲインリダクション（dB、multibandEnabled = 0 の間は更新されない）
+void vc_chain_get_multiband_reduction(const VCChain *chain, float outDb[VC_MULTIBAND_BANDS]);
+
+/// エコーキャンセラの統計（未使用なら 0 を返し outStats はゼロ埋め）
+int vc_chain_get_echo_stats(const VCChain *chain, VCEchoCancellerStats *outStats);
+
+/// VAD の状態（vadEnabled = 0 の間は更新されない）
+void vc_chain_get_vad_state(const VCChain *chain, VCVadState *outState);
+
+/// 直近ブロックの解析結果（発話検出・ピッチ）
+void vc_chain_get_analysis(const VCChain *chain, VCBlockAnalysis *outAnalysis);
+
+/// ブロック単位のスペクトル解析コンテキスト（HPF・エコーキャンセル後の信号）
+/// チェーン内の段はこれを経由して STFT / 振幅 / 対数スペクトル / LPC を共有する。
+/// 同じブロックの process の中でのみ有効
+VCAnalysisContext *vc_chain_analysis_context(VCChain *chain);
+
+/// 信号ガード（既定で有効）
+/// 有効な間、process は FTZ/DAZ を有効にして処理し（終わったら呼び出し元の設定に戻す）、入力の NaN・無限大・
+/// 非正規化数を 0 に置き換え、モジュールの出力が壊れたらそのモジュールだけをリセットしてフェードインで戻す。
+/// 畳み込みと声質変換は背景スレッドの計算とロックを取り合うので、取れなければ取れるまで素通しにしてリセットを待つ。
+/// processと同一スレッド、またはprocess外から呼ぶこと
+void vc_chain_set_signal_guard(VCChain *chain, int enabled);
+
+/// 信号ガードの統計（無効の間は更新されない）
+void vc_chain_get_signal_guard_stats(const VCChain *chain, VCSignalGuardStats *outStats);
+
+/// 音声処理（input == output のインプレース処理可、countは任意長）
+/// エコーキャンセルは count が VC_CHAIN_AEC_BLOCK_SIZE、畳み込みは VC_CONVOLVER_BLOCK_SIZE、
+/// 声質変換は hop の倍数のときのみ行う
+void vc_chain_process(VCChain *chain, const float *input, float *output, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCChain_h */
@@ -0,0 +1,106 @@
+//
+//  VCConvolver.h
+//  VoiceChanger
+//
+//  Zero-latency non-uniform partitioned convolution and memory-mapped impulse responses
+//
+
+#ifndef VCConvolver_h
+#define VCConvolver_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 先頭パーティション長（process の count はこの倍数であること）
+#define VC_CONVOLVER_BLOCK_SIZE 128
+
+/// 分割段数の上限（先頭 + 背景スレッドで処理する段）
+#define VC_CONVOLVER_MAX_STAGES 3
+
+/// 統計
+typedef struct {
+    int length;                 // IR 長（サンプル）
+    int stages;                 // 使っている段数（先頭段を含む）
+    uint64_t blocks;            // 処理した先頭パーティション数
+    uint64_t tailBlocks;        // 背景段で計算したブロック数
+    uint64_t lateBlocks;        // 背景段の計算が間に合わず無音で代用したブロック数
+} VCConvolverStats;
+
+/// 畳み込み（不透明型）
+///
+/// IR を長さの異なるパーティションに分けて周波数領域で畳み込む（非一様分割の overlap-save）。
+/// 先頭 [0, 2048) は 128 サンプル単位でオーディオスレッド上で計算するので遅延は 0。
+/// 以降は 1024 / 8192 サンプル単位の段に分け、入力が揃ったブロックを段ごとの背景スレッドで計算する。
+/// 各段の開始位置はパーティション長の 2 倍にしてあり、背景スレッドには 1 パーティション分の猶予がある。
+/// 間に合わなかったブロックは待たずに無音で代用し lateBlocks に数える。
+/// process はメモリ確保・ブロッキングするロックなし（背景スレッドの起床は trylock のみ）。
+typedef struct VCConvolver VCConvolver;
+
+/// 作成（IR は内部のスペクトルへ変換するので、作成後は解放してよい。失敗時 NULL）
+/// - Parameter threaded: 0 なら背景段も process 内で計算する（テスト・ベンチマーク・オフライン用）
+VCConvolver *vc_convolver_create(const float *impulseResponse, int length, int threaded);
+void vc_convolver_destroy(VCConvolver *convolver);
+
+int vc_convolver_length(const VCConvolver *convolver);
+
+/// 入出力の履歴をクリア（背景スレッドの計算が終わるまで待つので、オーディオスレッドからは呼ばないこと）
+void vc_convolver_reset(VCConvolver *convolver);
+
+/// 背景スレッドが計算中でなければクリアする（待たないのでオーディオスレッドから呼べる）
+/// - Returns: 0 = クリアした、-1 = 計算中（何もしていない。次のブロックでやり直すこと）
+int vc_convolver_try_reset(VCConvolver *convolver);
+
+/// 畳み込み結果（ウェット信号のみ）を output に書く（input == output 可）
+/// - Returns: 0 = 成功、-1 = count が VC_CONVOLVER_BLOCK_SIZE の倍数でない（output は変更しない）
+int vc_convolver_process(VCConvolver *convolver, const float *input, float *output, int count);
+
+void vc_convolver_get_stats(const VCConvolver *convolver, VCConvolverStats *outStats);
+
+// MARK: - Impulse Responses
+
+/// IR ファイルを読み込んだもの
+/// 32bit float モノラルの WAV はファイルを mmap したまま samples が直接指す（コピーなし）。
+/// それ以外（16/24bit PCM、多チャンネル）は先頭チャンネルを float へ変換した領域を指す。
+typedef struct {
+    const float *samples;
+    int length;
+    int sampleRate;
+    void *mapping;          // mmap した領域
+    size_t mappingSize;
+    float *converted;       // 変換した場合のみ
+} VCImpulseResponse;
+
+/// WAV ファイル（RIFF / WAVE、PCM 16/24/32bit・float 32bit）を読み込む
+/// - Returns: 0 = 成功、-1 = 開けない / 形式が不正
+int vc_ir_load(const char *path, VCImpulseResponse *outIR);
+
+/// 読み込みで確保・マップしたものを解放
+void vc_ir_release(VCImpulseResponse *ir);
+
+/// 内蔵 IR（ファイルがなくてもプリセットから参照できる合成 IR）
+typedef enum {
+    VC_IR_PHONE = 0,        // 電話（300〜3400Hz の帯域制限、短い筐体の響き）
+    VC_IR_RADIO,            // 小型ラジオ（中域の強調と小さな箱鳴り）
+    VC_IR_HALL,             // ホール（約 2 秒で減衰する残響）
+    VC_IR_BUILTIN_COUNT
+} VCBuiltinImpulseResponse;
+
+/// 内蔵 IR の名前（"phone" / "radio" / "hall"）から種類を引く（なければ -1）
+int vc_ir_builtin_named(const char *name);
+
+/// 内蔵 IR の長さ（サンプル）
+int vc_ir_builtin_length(VCBuiltinImpulseResponse kind, int sampleRate);
+
+/// 内蔵 IR を生成する（同じ引数なら常に同じ値）
+/// - Returns: 書いたサンプル数（capacity が足りなければ -1）
+int vc_ir_builtin_render(VCBuiltinImpulseResponse kind, int sampleRate, float *output, int capacity);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCConvolver_h */
@@ -0,0 +1,43 @@
+//
+//  VCCore.h
+//  VoiceChanger
+//
+//  Portable C core (DSP kernels and transport), shared by App, Driver and Benchmarks
+//
+
+#ifndef VCCore_h
+#define VCCore_h
+
+#include "VCBiquad.h"
+#include "VCDynamics.h"
+#include "VCChain.h"
+#include "VCStreamPool.h"
+#include "VCBatch.h"
+#include "VCLog.h"
+#include "VCMeter.h"
+#include "VCSharedRing.h"
+#include "VCAudioRing.h"
+#include "VCMonitor.h"
+#include "VCFFT.h"
+#include "VCFastMath.h"
+#include "VCSignalGuard.h"
+#include "VCArena.h"
+#include "VCEchoCanceller.h"
+#include "VCVad.h"
+#include "VCPitch.h"
+#include "VCAnalysis.h"
+#include "VCConvolver.h"
+#include "VCMultiband.h"
+#include "VCOversampler.h"
+#include "VCPresetBank.h"
+#include "VCVirtualMic.h"
+#include "VCMicFanout.h"
+#include "VCTapRecorder.h"
+#include "VCDriverIO.h"
+#include "VCIOTrace.h"
+#include "VCIOReplay.h"
+#include "VCLatency.h"
+#include "VCGraph.h"
+#include "VCVoiceConverter.h"
+
+#endif /* VCCore_h */
@@ -0,0 +1,61 @@
+//
+//  VCDriverIO.h
+//  VoiceChanger
+//
+//  Portable core of the driver's IO path (virtual mic read, zero timestamp),
+//  shared by the Audio Server plug-in and the Linux IO-trace replay
+//
+
+#ifndef VCDriverIO_h
+#define VCDriverIO_h
+
+#include "VCSharedRing.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 1 IO 周期の読み出し結果
+typedef enum {
+    VC_DRIVER_READ_OK = 0,
+    VC_DRIVER_READ_DETACHED,    // 共有メモリ未接続（アプリ未起動）
+    VC_DRIVER_READ_INACTIVE,    // 接続済みだが producer が非稼働
+    VC_DRIVER_READ_REPLACED,    // 区画が作り直された（張り替えを頼むこと）
+    VC_DRIVER_READ_STALLED,     // 稼働中のまま producer が止まった（アプリが落ちた）
+    VC_DRIVER_READ_UNDERRUN,    // 足りない（無音で補完）
+} VCDriverReadStatus;
+
+/// 相手の状態の変化（状態が変わったときだけ記録するためのビット。ACTIVE → INACTIVE → LOST の順に記録する）
+enum {
+    VC_DRIVER_PEER_EVENT_ACTIVE     = 1 << 0,   // 読み出しを再開した
+    VC_DRIVER_PEER_EVENT_INACTIVE   = 1 << 1,   // 未接続 / 非稼働になった
+    VC_DRIVER_PEER_EVENT_LOST       = 1 << 2,   // 停止 / 作り直しを検出した
+};
+
+typedef struct {
+    VCDriverReadStatus status;
+    unsigned int events;        // VC_DRIVER_PEER_EVENT_*
+    uint32_t writeIndex;        // 読む前のインデックス（未接続なら 0）
+    uint32_t readIndex;
+    int available;              // 読む前のフィルレベル
+} VCDriverReadResult;
+
+/// 仮想マイクの 1 IO 周期分の読み出し（Mic_ReadInput の本体。ロック・確保なし）
+/// ring が NULL なら未接続として扱う。OK 以外は output を無音にし、リングは読み進めない。
+/// peerActive は呼び出し側が周期をまたいで持つ状態（最初は 0）
+VCDriverReadResult vc_driver_read_input(VCSharedRing *ring, VCSharedRingWatch *watch, uint64_t now,
+                                        float *output, int frameCount, int *peerActive);
+
+/// GetZeroTimeStamp の本体: アンカーからの経過を period フレームに丸めたサンプル時刻と、そのホスト時刻
+void vc_driver_zero_timestamp(uint64_t anchorHostTime, uint64_t now, double hostTicksPerFrame, uint32_t period,
+                              double *outSampleTime, uint64_t *outHostTime);
+
+/// ゼロタイムスタンプと同じ対応で、サンプル時刻（IO サイクルの mInputTime など）をホスト時刻にする
+uint64_t vc_driver_sample_host_time(uint64_t anchorHostTime, double sampleTime, double hostTicksPerFrame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCDriverIO_h */
@@ -0,0 +1,76 @@
+//
+//  VCDynamics.h
+//  VoiceChanger
+//
+//  Portable dynamics kernels: noise gate, AGC, limiter
+//
+
+#ifndef VCDynamics_h
+#define VCDynamics_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 簡易ノイズゲート（NoiseSuppressor のバックエンド）
+typedef struct {
+    float strength;     // 0 to 1
+} VCNoiseGate;
+
+void vc_noise_gate_init(VCNoiseGate *gate);
+void vc_noise_gate_set_strength(VCNoiseGate *gate, float strength);
+void vc_noise_gate_process(const VCNoiseGate *gate, float *samples, int count);
+
+/// 非発話区間でゲートの代わりに掛ける一定ゲイン（ゲートの減衰量と同じ、strength 0 なら 1）
+float vc_noise_gate_floor_gain(const VCNoiseGate *gate);
+
+/// 発話の度合い（VAD の activity）に応じてゲートと一定ゲインを混ぜる（インプレース）
+/// activity が 1 ならゲートのみ、0 なら一定ゲインのみ。途中はブロック内で activityStart → activityEnd へ線形に移す
+/// - Parameter scratch: count 個分の作業領域
+void vc_noise_gate_process_with_activity(const VCNoiseGate *gate, float *samples, float *scratch, int count,
+                                         float activityStart, float activityEnd);
+
+/// ブロック単位の自動ゲイン調整
+typedef struct {
+    float targetDb;
+    float currentGain;
+    float attackTime;
+    float releaseTime;
+    int voiceActive;    // 0 の間はゲインを据え置く（VAD から設定、既定 1）
+} VCAgc;
+
+void vc_agc_init(VCAgc *agc);
+void vc_agc_set_target(VCAgc *agc, float targetDb);
+
+/// 発話状態（非発話中はノイズに合わせてゲインを上げないよう更新を止める）
+void vc_agc_set_voice_activity(VCAgc *agc, int active);
+void vc_agc_process(VCAgc *agc, float *samples, int count);
+
+/// ブロックRMSからゲインを更新して返す（vc_agc_process の係数計算部分）
+float vc_agc_update_gain(VCAgc *agc, float rms);
+
+/// ソフトニーリミッター
+typedef struct {
+    float ceiling;
+    float threshold;
+    float attackCoeff;
+    float releaseCoeff;
+    float envelope;
+} VCLimiter;
+
+void vc_limiter_init(VCLimiter *limiter);
+void vc_limiter_set_ceiling(VCLimiter *limiter, float ceilingDb);
+
+/// factor 倍にオーバーサンプリングした信号を処理するとき、アタック・リリースの時定数を保つよう係数を換算する（1 で元に戻る）
+void vc_limiter_set_oversampling(VCLimiter *limiter, int factor);
+void vc_limiter_process(VCLimiter *limiter, float *samples, int count);
+void vc_limiter_reset(VCLimiter *limiter);
+
+/// RMS（ブロック全体）
+float vc_rms(const float *samples, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCDynamics_h */
@@ -0,0 +1,53 @@
+//
+//  VCEchoCanceller.h
+//  VoiceChanger
+//
+//  Partitioned-block frequency-domain adaptive filter (MDF) echo canceller
+//
+
+#ifndef VCEchoCanceller_h
+#define VCEchoCanceller_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 統計
+typedef struct {
+    float erleDb;               // エコー抑圧量の推定（遠端が鳴っている区間の平滑値）
+    int converged;              // フィルタが収束済みか
+    int doubleTalk;             // 現在ダブルトーク判定中か
+    uint64_t blocks;            // 処理ブロック数
+    uint64_t doubleTalkBlocks;  // ダブルトークで適応を止めたブロック数
+    uint64_t bypassedBlocks;    // 推定が悪化させるためマイク入力をそのまま出したブロック数
+} VCEchoCancellerStats;
+
+/// エコーキャンセラ（不透明型）
+///
+/// 遠端（スピーカー / ヘッドホンへ出した音）を参照に、近端（マイク）から
+/// エコー成分を差し引く。フィルタ長 tailFrames を blockSize ごとに分割し、
+/// 周波数領域で畳み込み・適応する（MDF / PBFDAF）。
+/// 処理は blockSize 単位、メモリ確保・ロックなし。
+typedef struct VCEchoCanceller VCEchoCanceller;
+
+/// 作成（blockSize は 2 のべき乗 8〜1024、失敗時 NULL）
+VCEchoCanceller *vc_aec_create(int blockSize, int tailFrames);
+void vc_aec_destroy(VCEchoCanceller *aec);
+
+int vc_aec_block_size(const VCEchoCanceller *aec);
+
+/// フィルタと統計をリセット
+void vc_aec_reset(VCEchoCanceller *aec);
+
+/// 1ブロック処理（farEnd / nearEnd / output は blockSize サンプル、nearEnd == output 可）
+void vc_aec_process(VCEchoCanceller *aec, const float *farEnd, const float *nearEnd, float *output);
+
+void vc_aec_get_stats(const VCEchoCanceller *aec, VCEchoCancellerStats *outStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCEchoCanceller_h */
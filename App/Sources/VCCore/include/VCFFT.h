@@ -0,0 +1,57 @@
+//
+//  VCFFT.h
+//  VoiceChanger
+//
+//  Portable real FFT (power-of-two sizes) and split-complex spectral kernels
+//
+
+#ifndef VCFFT_h
+#define VCFFT_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 対応する最小 / 最大サイズ
+#define VC_FFT_MIN_SIZE 16
+#define VC_FFT_MAX_SIZE 65536
+
+/// FFT プラン（不透明型）
+///
+/// 回転因子・ビット反転表・作業領域を作成時に確保する。変換はメモリ確保をしないが、
+/// 作業領域を共有するため1つのプランを同時に複数スレッドから使わないこと。
+typedef struct VCFFTPlan VCFFTPlan;
+
+/// プラン作成（size は 2 のべき乗、範囲外なら NULL）
+VCFFTPlan *vc_fft_plan_create(int size);
+void vc_fft_plan_destroy(VCFFTPlan *plan);
+
+int vc_fft_plan_size(const VCFFTPlan *plan);
+
+/// 実数 → 複素（split 形式、size/2 + 1 ビン、スケールなし）
+void vc_fft_forward(VCFFTPlan *plan, const float *input, float *outRe, float *outIm);
+
+/// 複素（size/2 + 1 ビン）→ 実数（1/size でスケールし、forward の厳密な逆変換になる）
+/// DC / ナイキストの虚部は無視する
+void vc_fft_inverse(VCFFTPlan *plan, const float *re, const float *im, float *output);
+
+// MARK: - Spectral Kernels
+
+/// accRe/Im += a * b（split 形式、count ビン）
+void vc_complex_mac(float *accRe, float *accIm,
+                    const float *aRe, const float *aIm,
+                    const float *bRe, const float *bIm, int count);
+
+/// accRe/Im += conj(a) * b
+void vc_complex_conj_mac(float *accRe, float *accIm,
+                         const float *aRe, const float *aIm,
+                         const float *bRe, const float *bIm, int count);
+
+/// outPower[k] = re[k]^2 + im[k]^2
+void vc_complex_power(const float *re, const float *im, float *outPower, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCFFT_h */
@@ -0,0 +1,229 @@
+//
+//  VCFastMath.h
+//  VoiceChanger
+//
+//  Accuracy-bounded float approximations of transcendental functions (scalar inline + 4-wide block kernels)
+//
+
+#ifndef VCFastMath_h
+#define VCFastMath_h
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 範囲縮約 + 多項式による近似（係数は Cephes の単精度版）。
+/// 入力を丸めて範囲内に収めるので、NaN・無限大・0 以下を渡しても常に有限の値を返す（libm と違う点に注意）。
+/// 誤差の上限（libm を倍精度で評価した値との比較、VCFastMathTests で検査）
+///
+///     exp / exp2         相対 1.5e-7   （x は [-87, 88] / [-126, 127] に丸める）
+///     log                絶対 1e-7 + 相対 1.2e-7   （x < FLT_MIN・NaN は FLT_MIN として扱う）
+///     log2 / log10       log の定数倍（誤差も同じ比で増減する）
+///     pow                相対 2e-7 × (1 + |y·log x|)   （x > 0 のみ意味がある）
+///     tanh               絶対 1.5e-7   （|x| > 9 は ±1）
+///     sin / cos          絶対 1.5e-7   （|x| ≤ 8192。範囲縮約の精度がそれ以上では落ちる）
+///     atan2              絶対 4e-7   （atan2(±0, x < 0) は +π）
+///     dB → linear        相対 2e-6   （[-140, 40] dB）
+///     linear → dB        絶対 1e-6 dB + 相対 2e-7
+///
+/// ブロック版（vc_fast_exp など）は 4 レーンのベクタで同じ式を評価する（input == output 可）。
+/// 個々の値はスカラー版と同じ精度だが、FMA への縮約の有無で最下位ビットが異なることがある
+
+// MARK: - Internal
+
+static inline int32_t vc_fastmath_bits(float x) {
+    int32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+static inline float vc_fastmath_float(int32_t bits) {
+    float x;
+    memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+/// 最も近い整数（|x| < 2^22）。1.5·2^23 を足すと仮数の下位ビットに整数が入るので、変換命令も libm も使わない
+static inline float vc_fastmath_round(float x, int32_t *outInteger) {
+    float t = x + 12582912.0f;
+    *outInteger = vc_fastmath_bits(t) - 0x4b400000;
+    return t - 12582912.0f;
+}
+
+/// mask（全ビット 1 / 0）? a : b を分岐なしで
+static inline float vc_fastmath_select(int32_t mask, float a, float b) {
+    return vc_fastmath_float((mask & vc_fastmath_bits(a)) | (~mask & vc_fastmath_bits(b)));
+}
+
+/// e^r（|r| ≤ ln2 / 2）
+static inline float vc_fastmath_exp_reduced(float r) {
+    float p = 1.9875691500e-4f;
+    p = p * r + 1.3981999507e-3f;
+    p = p * r + 8.3334519073e-3f;
+    p = p * r + 4.1665795894e-2f;
+    p = p * r + 1.6666665459e-1f;
+    p = p * r + 5.0000001201e-1f;
+    return p * r * r + r + 1.0f;
+}
+
+// MARK: - Exponential & Logarithm
+
+static inline float vc_fast_expf(float x) {
+    x = x > -87.0f ? x : -87.0f;
+    x = x < 88.0f ? x : 88.0f;
+    int32_t n;
+    float fn = vc_fastmath_round(x * 1.44269504f, &n);
+    float r = x - fn * 0.693359375f;            // ln2 を 2 つに分けて引く（上位は n を掛けても正確）
+    r -= fn * -2.12194440e-4f;
+    return vc_fastmath_exp_reduced(r) * vc_fastmath_float((n + 127) << 23);
+}
+
+static inline float vc_fast_exp2f(float x) {
+    x = x > -126.0f ? x : -126.0f;
+    x = x < 127.0f ? x : 127.0f;
+    int32_t n;
+    float r = (x - vc_fastmath_round(x, &n)) * 0.693147181f;
+    return vc_fastmath_exp_reduced(r) * vc_fastmath_float((n + 127) << 23);
+}
+
+static inline float vc_fast_logf(float x) {
+    x = x > 1.17549435e-38f ? x : 1.17549435e-38f;
+    int32_t bits = vc_fastmath_bits(x);
+    float e = (float)((bits >> 23) - 126);
+    float m = vc_fastmath_float((bits & 0x007fffff) | 0x3f000000);     // [0.5, 1)
+    // 仮数を [√½, √2) に寄せてから log(1 + m)（入力によって向きが変わるので分岐にしない）
+    int32_t small = -(int32_t)(m < 0.707106781f);
+    e -= vc_fastmath_select(small, 1.0f, 0.0f);
+    m = vc_fastmath_select(small, m + m, m) - 1.0f;
+    float z = m * m;
+    float p = 7.0376836292e-2f;
+    p = p * m - 1.1514610310e-1f;
+    p = p * m + 1.1676998740e-1f;
+    p = p * m - 1.2420140846e-1f;
+    p = p * m + 1.4249322787e-1f;
+    p = p * m - 1.6668057665e-1f;
+    p = p * m + 2.0000714765e-1f;
+    p = p * m - 2.4999993993e-1f;
+    p = p * m + 3.3333331174e-1f;
+    float y = m * z * p + e * -2.12194440e-4f - 0.5f * z;
+    return m + y + e * 0.693359375f;
+}
+
+static inline float vc_fast_log2f(float x) {
+    return vc_fast_logf(x) * 1.44269504f;
+}
+
+static inline float vc_fast_log10f(float x) {
+    return vc_fast_logf(x) * 0.434294482f;
+}
+
+static inline float vc_fast_powf(float x, float y) {
+    return vc_fast_expf(y * vc_fast_logf(x));
+}
+
+// MARK: - Decibels
+
+/// 10^(db / 20)
+static inline float vc_fast_db_to_linear(float db) {
+    return vc_fast_expf(db * 0.115129255f);
+}
+
+/// 20·log10(x)（x ≤ 0 は約 -758 dB）
+static inline float vc_fast_linear_to_db(float x) {
+    return vc_fast_logf(x) * 8.68588964f;
+}
+
+// MARK: - Hyperbolic & Trigonometric
+
+static inline float vc_fast_tanhf(float x) {
+    float a = x < 0 ? -x : x;
+    if (a < 0.625f) {
+        float z = x * x;
+        float p = -5.70498872745e-3f;
+        p = p * z + 2.06390887954e-2f;
+        p = p * z - 5.37397155531e-2f;
+        p = p * z + 1.33314422036e-1f;
+        p = p * z - 3.33332819422e-1f;
+        return x + x * z * p;
+    }
+    a = a < 9.0f ? a : 9.0f;    // NaN も 9（±1）になる
+    float t = 1.0f - 2.0f / (vc_fast_expf(a + a) + 1.0f);
+    return x < 0 ? -t : t;
+}
+
+static inline void vc_fast_sincosf(float x, float *outSin, float *outCos) {
+    // x = q·π/2 + r（π/2 を 3 つに分けて引く）
+    int32_t q;
+    float fq = vc_fastmath_round(x * 0.636619772f, &q);
+    float r = x - fq * 1.5703125f;
+    r -= fq * 4.837512969970703125e-4f;
+    r -= fq * 7.54978995489188216e-8f;
+
+    float z = r * r;
+    float s = ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f) * z * r + r;
+    float c = ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f) * z * z
+              - 0.5f * z + 1.0f;
+
+    // 象限: 奇数なら入れ替え、sin は q & 2、cos は (q + 1) & 2 で符号反転
+    int32_t swap = -(q & 1);
+    *outSin = vc_fastmath_float(vc_fastmath_bits(vc_fastmath_select(swap, c, s)) ^ (int32_t)((uint32_t)(q & 2) << 30));
+    *outCos = vc_fastmath_float(vc_fastmath_bits(vc_fastmath_select(swap, s, c))
+                                ^ (int32_t)((uint32_t)((q + 1) & 2) << 30));
+}
+
+static inline float vc_fast_sinf(float x) {
+    float s, c;
+    vc_fast_sincosf(x, &s, &c);
+    return s;
+}
+
+static inline float vc_fast_cosf(float x) {
+    float s, c;
+    vc_fast_sincosf(x, &s, &c);
+    return c;
+}
+
+static inline float vc_fast_atan2f(float y, float x) {
+    float ax = x < 0 ? -x : x;
+    float ay = y < 0 ? -y : y;
+    float hi = ax > ay ? ax : ay;
+    float lo = ax > ay ? ay : ax;
+    float t = hi > 0 ? lo / hi : 0.0f;      // [0, 1]
+
+    // tan(π/8) を超えたら atan(t) = π/4 + atan((t - 1) / (t + 1))
+    int large = t > 0.414213562f;
+    float u = large ? (t - 1.0f) / (t + 1.0f) : t;
+    float z = u * u;
+    float a = (((8.05374449538e-2f * z - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z - 3.33329491539e-1f)
+              * z * u + u;
+    a = large ? a + 0.785398163f : a;
+    a = ay > ax ? 1.57079633f - a : a;
+    a = x < 0 ? 3.14159265f - a : a;
+    return y < 0 ? -a : a;
+}
+
+// MARK: - Block Kernels
+
+void vc_fast_exp(const float *input, float *output, int count);
+void vc_fast_log(const float *input, float *output, int count);
+void vc_fast_tanh(const float *input, float *output, int count);
+
+/// output[i] = base[i]^exponent[i]
+void vc_fast_pow(const float *base, const float *exponent, float *output, int count);
+
+void vc_fast_sincos(const float *input, float *outSin, float *outCos, int count);
+
+/// output[i] = atan2(y[i], x[i])
+void vc_fast_atan2(const float *y, const float *x, float *output, int count);
+
+void vc_fast_db_to_linear_block(const float *input, float *output, int count);
+void vc_fast_linear_to_db_block(const float *input, float *output, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCFastMath_h */
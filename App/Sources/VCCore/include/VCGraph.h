@@ -0,0 +1,145 @@
+//
+//  VCGraph.h
+//  VoiceChanger
+//
+//  DSP graph defined by presets: topological schedule, liveness-based buffer reuse, parallel branches
+//
+
+#ifndef VCGraph_h
+#define VCGraph_h
+
+#include "VCChain.h"
+#include "VCConvolver.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 1 ノードの最大入力数（MIX）
+#define VC_GRAPH_MAX_INPUTS 4
+
+/// 最大ノード数
+#define VC_GRAPH_MAX_NODES 64
+
+/// ノードの種類と param の意味
+///
+/// | 種類        | 入力 | param                                             |
+/// |-------------|------|---------------------------------------------------|
+/// | INPUT       | 0    | -                                                 |
+/// | OUTPUT      | 1    | -                                                 |
+/// | HPF         | 1    | [0] 遮断周波数 Hz                                 |
+/// | VAD         | 1    | - （音は素通し。GATE / AGC の sidechain に指定する）|
+/// | GATE        | 1    | [0] strength 0〜1                                 |
+/// | AGC         | 1    | [0] 目標 dB                                       |
+/// | PITCH_SHIFT | 1    | [0] 半音                                          |
+/// | MULTIBAND   | 1    | [0] 下3帯域のしきい値 dB [1] 比 [2] ディエッサーのしきい値 dB [3] 比 |
+/// | EQ          | 1    | [0] low [1] mid [2] high（dB）                    |
+/// | CONVOLVER   | 1    | - （ウェットのみ。IR は vc_graph_set_convolver）  |
+/// | LIMITER     | 1    | [0] オーバーサンプリング倍率（1 / 2 / 4）         |
+/// | MIX         | 1〜4 | - （gains[i] を掛けて足す）                       |
+typedef enum {
+    VC_GRAPH_NODE_INPUT = 0,
+    VC_GRAPH_NODE_OUTPUT,
+    VC_GRAPH_NODE_HPF,
+    VC_GRAPH_NODE_VAD,
+    VC_GRAPH_NODE_GATE,
+    VC_GRAPH_NODE_AGC,
+    VC_GRAPH_NODE_PITCH_SHIFT,
+    VC_GRAPH_NODE_MULTIBAND,
+    VC_GRAPH_NODE_EQ,
+    VC_GRAPH_NODE_CONVOLVER,
+    VC_GRAPH_NODE_LIMITER,
+    VC_GRAPH_NODE_MIX,
+    VC_GRAPH_NODE_KIND_COUNT
+} VCGraphNodeKind;
+
+/// ノードの記述（配列の添字がノード番号。並び順は自由で、スケジュールは作成時に決める）
+typedef struct {
+    VCGraphNodeKind kind;
+    int inputCount;
+    int inputs[VC_GRAPH_MAX_INPUTS];    // 入力ノードの番号
+    float gains[VC_GRAPH_MAX_INPUTS];   // MIX の各入力のゲイン（リニア）
+    int sidechain;                      // GATE / AGC が従う VAD ノード（-1 = なし）
+    float param[4];
+} VCGraphNodeDesc;
+
+/// 記述を既定値で初期化する（入力なし、sidechain なし、種類ごとの既定の param）
+void vc_graph_node_init(VCGraphNodeDesc *node, VCGraphNodeKind kind);
+
+/// 作成オプション
+typedef struct {
+    int naiveBuffers;   // ノードごとに専用のバッファを持つ（比較用。再利用もインプレースもしない）
+    int workerCount;    // 0 = 処理スレッドのみで直列、> 0 = 独立な枝を workerCount 本の補助スレッドと並行に処理
+} VCGraphOptions;
+
+/// 作成の結果
+typedef enum {
+    VC_GRAPH_OK = 0,
+    VC_GRAPH_ERROR_INVALID = -1,    // 種類・入力数・入力の番号・sidechain が不正
+    VC_GRAPH_ERROR_CYCLE = -2,      // 閉路がある
+    VC_GRAPH_ERROR_ENDPOINTS = -3,  // INPUT / OUTPUT がちょうど 1 つずつでない
+    VC_GRAPH_ERROR_MEMORY = -4,
+} VCGraphError;
+
+/// 構成の要約（ベンチマーク・テスト用）
+typedef struct {
+    int nodeCount;          // スケジュールしたノード（OUTPUT に届かないノードは除く）
+    int bufferCount;        // 作業バッファの数
+    size_t bufferBytes;     // 作業バッファの合計（各 VC_MAX_FRAME_SIZE サンプル）
+    int taskCount;          // 並行処理の単位（分岐も合流もないノードの連なり）
+    int levelCount;         // タスクの段数（同じ段のタスクは互いに依存しない）
+    int maxParallel;        // 1 段の最大タスク数
+} VCGraphInfo;
+
+/// DSP グラフ（不透明型）
+///
+/// 作成時にノードを 1 度だけトポロジカル順に並べ、OUTPUT に届かないノードを外す。
+/// 作業バッファは生存区間で割り当てる: 最後の読み手が済んだバッファは次のノードに回し、
+/// 1 入力のノードは入力の最後の読み手なら入力のバッファに上書きする。
+/// そのため直列の連なりは 1 本のバッファで済み、本数は同時に生きている枝の数まで減る。
+/// sidechain は順序だけに効き、VAD の音のバッファは延命しない。
+/// 並行処理では分岐・合流のない連なりを 1 タスクとし、同じ段のタスクを補助スレッドと分け合う
+/// （段ごとに待ち合わせるので、生存区間も段単位で数える）。
+/// process はメモリ確保・ロックなし。
+typedef struct VCGraph VCGraph;
+
+/// 作成（オーディオスレッドからは呼ばないこと）
+/// - Parameter options: NULL で既定（専用バッファなし、直列）
+/// - Parameter outError: NULL 可
+/// - Returns: 失敗時 NULL
+VCGraph *vc_graph_create(int sampleRate, const VCGraphNodeDesc *nodes, int count,
+                         const VCGraphOptions *options, VCGraphError *outError);
+
+/// 破棄（補助スレッドも止める）
+void vc_graph_destroy(VCGraph *graph);
+
+/// CONVOLVER ノードの IR（NULL で素通し）。process と同一スレッド、または process 外から呼ぶこと
+/// convolver は設定中グラフより長く生存し、ノード間で共有しないこと
+/// - Returns: 0 = 成功、-1 = 番号が CONVOLVER でない
+int vc_graph_set_convolver(VCGraph *graph, int node, VCConvolver *convolver);
+
+/// すべてのノードの状態をリセット
+void vc_graph_reset(VCGraph *graph);
+
+void vc_graph_get_info(const VCGraph *graph, VCGraphInfo *outInfo);
+
+/// 実行順（ノード番号）を書き出す
+/// - Returns: スケジュールしたノード数（capacity を超える分は書かない）
+int vc_graph_schedule(const VCGraph *graph, int *outNodes, int capacity);
+
+/// ノードの作業バッファの番号（スケジュール外なら -1）
+int vc_graph_node_buffer(const VCGraph *graph, int node);
+
+/// INPUT から OUTPUT までで最も長い経路の遅延（サンプル。ピッチシフトとオーバーサンプリング分）
+float vc_graph_latency(const VCGraph *graph);
+
+/// 音声処理（input == output 可、count は任意長で VC_MAX_FRAME_SIZE ごとに区切る）
+/// CONVOLVER は count が VC_CONVOLVER_BLOCK_SIZE の倍数のときのみ畳み込み、それ以外は素通しにする
+void vc_graph_process(VCGraph *graph, const float *input, float *output, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCGraph_h */
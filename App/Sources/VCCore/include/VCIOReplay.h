@@ -0,0 +1,100 @@
+//
+//  VCIOReplay.h
+//  VoiceChanger
+//
+//  Deterministic replay of IO traces through the driver's read path (VCDriverIO)
+//  on a simulated ring, faster than real time and without CoreAudio
+//
+
+#ifndef VCIOReplay_h
+#define VCIOReplay_h
+
+#include "VCIOTrace.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct VCIOReplayTrace VCIOReplayTrace;
+
+// MARK: - Trace Files
+
+/// トレースファイル（VCIOTraceRecord を並べただけ）を読み、ホスト時刻順に混ぜる
+/// 同じ時刻のレコードは paths の順、ファイル内の順に並べる。末尾の半端なバイトは無視する
+/// - Returns: 失敗（開けない・メモリ不足）なら NULL
+VCIOReplayTrace *vc_io_replay_load(const char *const *paths, int count);
+
+/// 混ぜた結果を 1 つのファイルに書く（0 = 成功）
+int vc_io_replay_save(const VCIOReplayTrace *trace, const char *path);
+
+void vc_io_replay_free(VCIOReplayTrace *trace);
+
+size_t vc_io_replay_count(const VCIOReplayTrace *trace);
+const VCIOTraceRecord *vc_io_replay_records(const VCIOReplayTrace *trace);
+
+// MARK: - Replay
+
+/// 再生の条件（0 はトレースに記録された値を使う。変えると「この変更で何が起きたか」を見られる）
+typedef struct {
+    int capacity;               // 仮想マイクのリング容量（2 のべき乗）
+    int period;                 // ゼロタイムスタンプの周期（フレーム）
+    int heartbeatTimeoutMs;     // producer 停止とみなすまで（0 = ドライバーと同じ 15ms）
+} VCIOReplayOptions;
+
+/// 再生結果（recorded はトレースに記録された値、replayed は再生で得た値）
+typedef struct {
+    uint64_t reads;
+    uint64_t appWrites;
+    uint64_t zeroTimestamps;
+    uint64_t skipped;                   // 設定の前・再同期の前・区画の作り直しのレコード
+
+    uint64_t recordedUnderruns;
+    uint64_t replayedUnderruns;
+    uint64_t recordedStalls;
+    uint64_t replayedStalls;
+    uint64_t recordedOverflows;         // アプリの書き込みが入りきらなかった回数
+    uint64_t replayedOverflows;
+
+    uint64_t statusMismatches;          // ReadInput の結果が記録と違った周期
+    uint64_t fillMismatches;            // 読む前のフィルレベルが記録と違った周期
+    int64_t firstMismatch;              // 最初に食い違ったレコードの番号（なければ -1）
+
+    uint64_t timestampMismatches;       // ゼロタイムスタンプのホスト時刻が記録と違った回数
+    uint64_t maxTimestampError;         // その最大の差（ホスト時刻）
+
+    double seconds;                     // トレースが覆う時間
+} VCIOReplayResult;
+
+/// トレースを再生する（options は NULL 可）
+///
+/// 最初の設定レコードからリングを作り、最初の ReadInput で記録されたフィルレベルに合わせてから、
+/// アプリの書き込みと ReadInput / GetZeroTimeStamp をホスト時刻順に VCDriverIO へ流す。
+/// 未接続・作り直しの後は次の ReadInput で合わせ直す。非稼働は記録どおりに再現する。
+/// - Returns: 0 = 成功、-1 = 設定レコードがない・メモリ不足
+int vc_io_replay_run(const VCIOReplayTrace *trace, const VCIOReplayOptions *options, VCIOReplayResult *outResult);
+
+// MARK: - Synthesis
+
+/// 合成トレースの条件（実機なしでリプレイとベンチマークを回すため）
+typedef struct {
+    double seconds;
+    int ioFrames;               // HAL の IO バッファ（inIOBufferFrameSize）
+    int appFrames;              // アプリが 1 回に書くフレーム数
+    int capacity;               // リング容量（2 のべき乗）
+    double jitterMs;            // アプリの書き込みの遅れ（0〜jitterMs の一様乱数）
+    double stallAtSeconds;      // この時刻からアプリが書き込みを止める（負ならなし）
+    double stallMs;
+    uint32_t seed;
+} VCIOReplaySynthOptions;
+
+/// ドライバーとアプリの動きを VCDriverIO でそのまま走らせてトレースを作る（時計は ns 単位）
+/// - Returns: 失敗なら NULL
+VCIOReplayTrace *vc_io_replay_synthesize(const VCIOReplaySynthOptions *options);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCIOReplay_h */
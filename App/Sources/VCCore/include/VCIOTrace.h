@@ -0,0 +1,64 @@
+//
+//  VCIOTrace.h
+//  VoiceChanger
+//
+//  Compact binary IO trace records (driver IO cycles, zero timestamps, app writes),
+//  streamed through a shared ring and replayed by VCIOReplay
+//
+
+#ifndef VCIOTrace_h
+#define VCIOTrace_h
+
+#include "VCSharedRing.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VC_IO_TRACE_RECORD_SIZE     32
+#define VC_IO_TRACE_RECORD_FLOATS   (VC_IO_TRACE_RECORD_SIZE / 4)   // 共有リング上の 1 レコード
+
+/// レコードの種類
+typedef enum {
+    VC_IO_TRACE_CONFIG = 1,         // リプレイに必要な設定（IO 開始・接続し直し・一定周期ごと）
+    VC_IO_TRACE_READ,               // 仮想マイク 0 の ReadInput 1 周期
+    VC_IO_TRACE_ZERO_TIMESTAMP,     // GetZeroTimeStamp
+    VC_IO_TRACE_APP_WRITE,          // アプリが仮想マイク 0 のリングへ書いた
+} VCIOTraceKind;
+
+/// トレースの 1 レコード（ファイル上もこのまま。リトルエンディアン）
+///
+/// 種類ごとのフィールドの意味:
+///   CONFIG:         hostTime = IO 開始のアンカー、frames = サンプルレート、
+///                   writeIndex = リング容量、readIndex = ゼロタイムスタンプの周期、value = ホスト時刻 / フレーム（double）
+///   READ:           frames = inIOBufferFrameSize、status = VCDriverReadStatus、
+///                   writeIndex / readIndex = 読む前、value = HAL の入力サンプル時刻（double）
+///   ZERO_TIMESTAMP: value = 返したホスト時刻
+///   APP_WRITE:      frames = 書けたフレーム数、value = 書こうとしたフレーム数、writeIndex / readIndex = 書いた後
+typedef struct {
+    uint64_t hostTime;      // mach_absolute_time
+    uint16_t kind;          // VCIOTraceKind
+    uint16_t status;
+    uint32_t frames;
+    uint32_t writeIndex;
+    uint32_t readIndex;
+    uint64_t value;
+} VCIOTraceRecord;
+
+/// レコードを共有リングへ書く（producer のみ。入りきらなければ書かずに -1）
+int vc_io_trace_write(VCSharedRing *ring, const VCIOTraceRecord *record);
+
+/// 共有リングから 1 レコード読む（consumer のみ）
+/// - Returns: 1 = 読んだ、0 = ない
+int vc_io_trace_read(VCSharedRing *ring, VCIOTraceRecord *outRecord);
+
+/// value に double を入れる / 取り出す（ビット列のまま）
+uint64_t vc_io_trace_pack_double(double value);
+double vc_io_trace_unpack_double(uint64_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCIOTrace_h */
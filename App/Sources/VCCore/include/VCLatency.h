@@ -0,0 +1,106 @@
+//
+//  VCLatency.h
+//  VoiceChanger
+//
+//  End-to-end latency measurement: ring position <-> host time timelines,
+//  a lock-free latency histogram, and an active marker for DSP delay calibration
+//
+
+#ifndef VCLatency_h
+#define VCLatency_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// MARK: - Timeline
+
+/// リングの位置とホスト時刻の対応（不透明型）
+///
+/// 書き込み側はブロックを書く前に「このブロックの先頭の位置 = このホスト時刻」を mark し、
+/// 読み出し側は位置からホスト時刻を引く（直前の mark からサンプル数ぶん進める）。
+/// mark は 1 スレッド、lookup は 1 スレッドから。どちらもロック・確保をしない。
+typedef struct VCLatencyTimeline VCLatencyTimeline;
+
+/// - Parameters:
+///   - capacity: 覚えておく mark の数（2 のべき乗に切り上げる）
+///   - hostTicksPerFrame: 1 サンプルあたりのホスト時刻
+VCLatencyTimeline *vc_latency_timeline_create(int capacity, double hostTicksPerFrame);
+void vc_latency_timeline_destroy(VCLatencyTimeline *timeline);
+
+void vc_latency_timeline_mark(VCLatencyTimeline *timeline, uint32_t index, uint64_t hostTime);
+
+/// index 番目のサンプルのホスト時刻
+/// - Returns: 1 = 引けた、0 = mark がない / 覚えている範囲より古い
+int vc_latency_timeline_lookup(const VCLatencyTimeline *timeline, uint32_t index, uint64_t *outHostTime);
+
+// MARK: - Histogram
+
+#define VC_LATENCY_BINS     256
+#define VC_LATENCY_BIN_MS   1.0     // 0〜256ms を 1ms 刻み。超えた分は overflow
+
+typedef struct {
+    uint64_t count;
+    uint64_t overflow;          // VC_LATENCY_BINS * VC_LATENCY_BIN_MS 以上
+    uint64_t rejected;          // 受け渡しがキャプチャより前（時計が合っていない）
+    double minMs;
+    double meanMs;
+    double maxMs;
+    double p50Ms;               // ビンの中で線形補間
+    double p95Ms;
+    double p99Ms;
+    uint32_t bins[VC_LATENCY_BINS];
+} VCLatencyStats;
+
+/// レイテンシのヒストグラム（不透明型）
+/// record は 1 スレッドから（ロック・確保なし）、read はどのスレッドからでも（更新途中の値が混ざることはある）
+typedef struct VCLatencyProbe VCLatencyProbe;
+
+VCLatencyProbe *vc_latency_probe_create(double hostTicksPerMs);
+void vc_latency_probe_destroy(VCLatencyProbe *probe);
+
+/// キャプチャした時刻と受け渡した時刻の組を 1 つ数える
+void vc_latency_probe_record(VCLatencyProbe *probe, uint64_t captureHostTime, uint64_t deliveredHostTime);
+
+void vc_latency_probe_read(const VCLatencyProbe *probe, VCLatencyStats *outStats);
+
+/// 0 に戻す（record するスレッドから、または止まっているときに）
+void vc_latency_probe_reset(VCLatencyProbe *probe);
+
+/// ヒストグラムのうち thresholdMs 以上の割合（0〜1）
+double vc_latency_stats_fraction_over(const VCLatencyStats *stats, double thresholdMs);
+
+// MARK: - Active Marker
+
+/// 校正用のマーカー（不透明型）
+///
+/// 入力側（DSP 前）で一定間隔ごとに前後を無音にした短いトーンバーストを書き込み、
+/// 出力側（DSP 後）でそのエネルギーの重心を探して、DSP の内部遅延（ルックアヘッド・フィルター）を測る。
+/// 位置の対応はサンプル数で取るので、両側とも同じストリームを順に、欠けなく渡すこと（無効の間も）。
+/// inject は 1 スレッド、detect は 1 スレッドから。どちらもロック・確保をしない。
+typedef struct VCLatencyMarker VCLatencyMarker;
+
+/// 作った直後は無効（inject は位置を進めるだけ）
+VCLatencyMarker *vc_latency_marker_create(int sampleRate, double intervalMs);
+void vc_latency_marker_destroy(VCLatencyMarker *marker);
+
+/// どのスレッドからでも。次のマーカーの手前の無音から効く
+void vc_latency_marker_set_enabled(VCLatencyMarker *marker, int enabled);
+
+/// 入力に書き込む（マーカーの前後は元の音を無音に置き換える）
+void vc_latency_marker_inject(VCLatencyMarker *marker, float *samples, int count);
+
+/// 出力から探す
+/// - Returns: 1 = このブロックで測れた（outDelayMs に遅れ）、0 = まだ
+int vc_latency_marker_detect(VCLatencyMarker *marker, const float *samples, int count, double *outDelayMs);
+
+/// 見つけられなかったマーカーの数
+uint64_t vc_latency_marker_misses(const VCLatencyMarker *marker);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCLatency_h */
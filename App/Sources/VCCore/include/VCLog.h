@@ -0,0 +1,74 @@
+//
+//  VCLog.h
+//  VoiceChanger
+//
+//  Real-time-safe binary log ring (event ID + numeric args, formatted off the RT thread)
+//
+
+#ifndef VCLog_h
+#define VCLog_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 1イベントあたりの最大引数数
+#define VC_LOG_MAX_ARGS 4
+
+/// ログレベル（Swift の LogLevel と同じ値）
+typedef enum {
+    VCLogLevelDebug = 0,
+    VCLogLevelInfo = 1,
+    VCLogLevelWarning = 2,
+    VCLogLevelError = 3,
+    VCLogLevelCritical = 4,
+} VCLogLevel;
+
+/// バイナリログイベント（文字列を含まない固定長レコード）
+typedef struct {
+    uint64_t timestampNs;       // vc_log_now_ns()
+    uint32_t eventId;           // 呼び出し側で定義するイベントID
+    uint16_t level;             // VCLogLevel
+    uint16_t argCount;
+    double args[VC_LOG_MAX_ARGS];
+} VCLogEvent;
+
+/// ログリング（不透明型）
+///
+/// 書き込みスレッド1本・読み出しスレッド1本の SPSC リング。
+/// 書き込みはロック・メモリ確保・システムコールなしの wait-free で、
+/// 満杯時はイベントを捨てて dropped を数える。
+/// RTスレッドごとに1本作り、バックグラウンドスレッドでまとめて読み出して整形する。
+typedef struct VCLogRing VCLogRing;
+
+/// リング作成（capacity は2のべき乗に切り上げ）
+VCLogRing *vc_log_ring_create(int capacity);
+
+/// リング破棄
+void vc_log_ring_destroy(VCLogRing *ring);
+
+/// 容量（イベント数）
+int vc_log_ring_capacity(const VCLogRing *ring);
+
+/// イベント書き込み（RTスレッドから呼び出し可）
+/// - Returns: 0 成功、-1 満杯で破棄
+int vc_log_ring_write(VCLogRing *ring, uint32_t eventId, VCLogLevel level, int argCount,
+                      double arg0, double arg1, double arg2, double arg3);
+
+/// イベント読み出し（バックグラウンドスレッド）
+/// - Returns: 1 読み出した、0 空
+int vc_log_ring_read(VCLogRing *ring, VCLogEvent *outEvent);
+
+/// 満杯で破棄されたイベント数（累計）
+uint64_t vc_log_ring_dropped(const VCLogRing *ring);
+
+/// 単調増加クロック（ナノ秒、RTスレッドから呼び出し可）
+uint64_t vc_log_now_ns(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCLog_h */
@@ -0,0 +1,53 @@
+//
+//  VCMeter.h
+//  VoiceChanger
+//
+//  Lock-free level meter: peak, RMS and K-weighted loudness (ITU-R BS.1770)
+//
+
+#ifndef VCMeter_h
+#define VCMeter_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 表示下限（無音時の値）
+#define VC_METER_FLOOR_DB -120.0f
+
+/// メーター読み値
+typedef struct {
+    float peakDb;           // ピーク（ホールド後 20dB/s で減衰）
+    float rmsDb;            // RMS（300ms 時定数）
+    float momentaryLufs;    // K特性ラウドネス 400ms 窓
+    float shortTermLufs;    // K特性ラウドネス 3s 窓
+    uint64_t samples;       // 計測済みサンプル数（更新検出用）
+} VCMeterReading;
+
+/// メーター（不透明型）
+///
+/// vc_meter_process は計測スレッド（同時に1スレッド）から、vc_meter_read は表示スレッド
+/// （同時に1スレッド）から呼ぶ。両者はトリプルバッファで受け渡され、どちらもロックや
+/// メモリ確保をしない。
+typedef struct VCMeter VCMeter;
+
+VCMeter *vc_meter_create(int sampleRate);
+void vc_meter_destroy(VCMeter *meter);
+
+/// 計測（オーディオスレッドから呼び出し可）
+void vc_meter_process(VCMeter *meter, const float *samples, int count);
+
+/// 最新の読み値を取得
+/// - Returns: 前回の呼び出し以降に更新があれば 1
+int vc_meter_read(VCMeter *meter, VCMeterReading *outReading);
+
+/// 状態リセット（計測スレッドが止まっているときに呼ぶこと）
+void vc_meter_reset(VCMeter *meter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCMeter_h */
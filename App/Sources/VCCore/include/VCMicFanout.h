@@ -0,0 +1,61 @@
+//
+//  VCMicFanout.h
+//  VoiceChanger
+//
+//  Fans one capture out to a chain per virtual mic, processed in parallel
+//
+
+#ifndef VCMicFanout_h
+#define VCMicFanout_h
+
+#include <stdint.h>
+#include "VCChain.h"
+#include "VCSharedRing.h"
+#include "VCVirtualMic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// マイクごとの統計
+typedef struct {
+    uint64_t blocks;            // 処理したブロック数
+    uint64_t droppedFrames;     // 共有リングが満杯で書けなかったフレーム数（ドライバが読んでいない）
+} VCMicFanoutStats;
+
+/// 1 つのキャプチャを複数のマイクへ配る（不透明型）
+///
+/// 各マイクは独立した VCChain と出力先の共有リングを持つ。1 ブロックの入力は全チェーンが
+/// 同じ領域を読むだけで、コピーしない。各チェーンは自分の出力領域へ書き、共有リングへ書き込む。
+/// マイク 0 は呼び出しスレッドで、残りは VCStreamPool のワーカーで並行に処理する。
+/// 登録・パラメータ変更は process と同じスレッドで、ブロックの合間に行うこと。
+typedef struct VCMicFanout VCMicFanout;
+
+/// 作成（1 ブロックは maxFrames サンプルまで。workerCount <= 0 なら CPU 数 - 1、最低 1）
+/// ワーカーは 2 本目のマイクを登録したときに起動する
+VCMicFanout *vc_mic_fanout_create(int maxFrames, int workerCount);
+
+/// 破棄（チェーン・リングは所有しない）
+void vc_mic_fanout_destroy(VCMicFanout *fanout);
+
+/// マイクを登録する。chain・ring はファンアウトより長く生存すること（ring は NULL 可 = 出力領域のみ）
+/// - Returns: マイク番号（登録順）、失敗時 -1（上限 VC_VIRTUAL_MIC_MAX / 確保失敗）
+int vc_mic_fanout_add(VCMicFanout *fanout, VCChain *chain, VCSharedRing *ring);
+
+int vc_mic_fanout_count(const VCMicFanout *fanout);
+
+/// 1 ブロックを全マイクで処理し、全マイクが終わるまで待つ
+/// - Returns: 0 = 成功、-1 = count が 1〜maxFrames の範囲外
+int vc_mic_fanout_process(VCMicFanout *fanout, const float *input, int count);
+
+/// 直近の process でマイク mic が出力したサンプル（次の process まで有効。範囲外なら NULL）
+const float *vc_mic_fanout_output(const VCMicFanout *fanout, int mic);
+
+/// マイク mic の統計（範囲外ならゼロ埋め）
+void vc_mic_fanout_get_stats(const VCMicFanout *fanout, int mic, VCMicFanoutStats *outStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCMicFanout_h */
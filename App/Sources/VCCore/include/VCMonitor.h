@@ -0,0 +1,73 @@
+//
+//  VCMonitor.h
+//  VoiceChanger
+//
+//  Monitor path: SPSC ring from the DSP step to an output device, with
+//  a latency target and drift compensation between the two clocks
+//
+
+#ifndef VCMonitor_h
+#define VCMonitor_h
+
+#include <stdint.h>
+
+#include "VCSharedRing.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// モニター統計
+typedef struct {
+    uint64_t framesPushed;
+    uint64_t framesPulled;
+    uint64_t underruns;         // 出力側が追いついて無音を出した回数
+    uint64_t overruns;          // 溢れ / 遅延過大で捨てて再同期した回数
+    uint64_t droppedFrames;
+    float fillFrames;           // 平滑化したリング残量（= モニター遅延）
+    float ratio;                // 出力1フレームあたりに消費する入力フレーム数
+} VCMonitorStats;
+
+/// モニター（不透明型）
+///
+/// push は DSP 側（1スレッド）、pull は出力デバイスのコールバック（1スレッド）から呼ぶ。
+/// 入力と出力は別クロックで動くため、pull 側でリング残量を目標遅延に保つよう
+/// 読み出し比率を ±0.5% の範囲で調整し、線形補間でリサンプルする。
+typedef struct VCMonitor VCMonitor;
+
+/// - Parameters:
+///   - targetLatencyFrames: 目標のリング残量（push / pull のブロックサイズより大きくすること）
+///   - capacityFrames: リング容量（目標の4倍以上を推奨）
+VCMonitor *vc_monitor_create(int targetLatencyFrames, int capacityFrames);
+
+/// 既存のリング（共有メモリ等）の consumer として作成する。push は使わず相手側が書き込む
+/// - Parameter ring: ビューはコピーする。メモリはモニターより長く生存すること
+VCMonitor *vc_monitor_create_attached(const VCSharedRing *ring, int targetLatencyFrames);
+
+void vc_monitor_destroy(VCMonitor *monitor);
+
+int vc_monitor_target_latency(const VCMonitor *monitor);
+
+/// 処理済みブロックの投入（DSP スレッド）
+/// - Returns: 書き込んだフレーム数（満杯分は捨てる）
+int vc_monitor_push(VCMonitor *monitor, const float *samples, int count);
+
+/// 出力バッファを埋める（出力コールバック）。常に count フレーム書き込む
+void vc_monitor_pull(VCMonitor *monitor, float *output, int count);
+
+/// 溜まっている分を捨て、新しい目標遅延で溜め直す（consumer 側の操作）
+/// pull が止まっているときに呼ぶこと。push は動いていてもよい
+/// - Returns: 0 = 成功、-1 = 目標が容量を超える
+int vc_monitor_restart(VCMonitor *monitor, int targetLatencyFrames);
+
+/// 統計取得（任意のスレッド）
+void vc_monitor_get_stats(VCMonitor *monitor, VCMonitorStats *outStats);
+
+/// 初期状態に戻す（push / pull とも停止しているときに呼ぶこと）
+void vc_monitor_reset(VCMonitor *monitor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCMonitor_h */
@@ -0,0 +1,65 @@
+//
+//  VCMultiband.h
+//  VoiceChanger
+//
+//  4-band compressor / de-esser on Linkwitz–Riley crossovers
+//
+
+#ifndef VCMultiband_h
+#define VCMultiband_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 帯域数（SIMD の 1 ベクタに全帯域を載せる）
+#define VC_MULTIBAND_BANDS 4
+
+/// 最上位の帯域（歯擦音）。ここのコンプレッサーがディエッサーになる
+#define VC_MULTIBAND_SIBILANCE_BAND (VC_MULTIBAND_BANDS - 1)
+
+/// パラメータ（帯域は低い順）
+typedef struct {
+    float crossoverHz[VC_MULTIBAND_BANDS - 1];  // 昇順
+    float thresholdDb[VC_MULTIBAND_BANDS];
+    float ratio[VC_MULTIBAND_BANDS];            // 1 = 圧縮なし
+    float attackMs[VC_MULTIBAND_BANDS];
+    float releaseMs[VC_MULTIBAND_BANDS];
+    float makeupDb[VC_MULTIBAND_BANDS];
+    float kneeDb;                               // ソフトニーの幅
+} VCMultibandParams;
+
+/// 既定値（250 / 2000 / 5500 Hz で分割、低〜中域は緩い圧縮、5.5kHz 以上はディエッサー）
+void vc_multiband_params_default(VCMultibandParams *params);
+
+/// マルチバンドダイナミクス（不透明型）
+///
+/// 4次 Linkwitz–Riley のクロスオーバーを木構造に組み（中央で2分割してから各側を分割）、
+/// 反対側のクロスオーバー分のオールパスで位相を揃えるので、
+/// 圧縮しなければ帯域の和は振幅特性が平坦なオールパスになる。
+/// フィルタは 4 帯域を SoA の 4 レーンとして VCBiquadBatch で同時に進め、
+/// エンベロープ追従とゲインも 4 帯域まとめてベクタ演算する（ゲインの計算は 16 サンプルごと、間は線形補間）。
+/// 処理はメモリ確保・ロックなし。
+typedef struct VCMultiband VCMultiband;
+
+/// 作成（失敗時 NULL）
+VCMultiband *vc_multiband_create(int sampleRate);
+void vc_multiband_destroy(VCMultiband *multiband);
+
+/// パラメータ適用（クロスオーバーの係数を計算し直す。フィルタの状態は保つ）
+void vc_multiband_set_params(VCMultiband *multiband, const VCMultibandParams *params);
+void vc_multiband_get_params(const VCMultiband *multiband, VCMultibandParams *outParams);
+
+void vc_multiband_reset(VCMultiband *multiband);
+
+/// 処理（インプレース、count は任意長）
+void vc_multiband_process(VCMultiband *multiband, float *samples, int count);
+
+/// 直近のゲインリダクション（dB、0 以上。メイクアップを含まない）
+void vc_multiband_get_gain_reduction(const VCMultiband *multiband, float outDb[VC_MULTIBAND_BANDS]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCMultiband_h */
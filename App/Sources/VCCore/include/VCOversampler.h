@@ -0,0 +1,53 @@
+//
+//  VCOversampler.h
+//  VoiceChanger
+//
+//  2x / 4x polyphase half-band oversampling for nonlinear stages
+//
+
+#ifndef VCOversampler_h
+#define VCOversampler_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 対応する最大の倍率
+#define VC_OVERSAMPLER_MAX_FACTOR 4
+
+/// オーバーサンプラー（不透明型）
+///
+/// 半帯域 FIR（Kaiser 窓の sinc）を 2 倍ずつ重ねる。半帯域フィルタは係数の半分が 0 で、
+/// 残りの奇数位相は中央タップだけの遅延になるので、ポリフェーズに分けると偶数位相の FIR だけを計算すればよい。
+/// FIR は出力 4 サンプルを 1 ベクタとしてまとめて計算する。
+/// 18 kHz までを通し、折り返す成分は約 -70 dB 以下に抑える。
+/// 非線形処理は upsample が返す領域をその場で書き換え、downsample で元のレートに戻す。
+/// upsample / downsample はメモリ確保・ロックなし。
+typedef struct VCOversampler VCOversampler;
+
+/// 作成（factor は 1 / 2 / 4、1 回に扱うのは maxFrames サンプルまで。失敗時 NULL）
+/// factor = 1 はコピーするだけ（遅延 0）で、倍率を切り替える呼び出し側のコードを揃えるためにある
+VCOversampler *vc_oversampler_create(int factor, int maxFrames);
+void vc_oversampler_destroy(VCOversampler *oversampler);
+
+int vc_oversampler_factor(const VCOversampler *oversampler);
+
+/// アップ → ダウンの往復で生じる遅延（元のレートのサンプル数。4 倍では 0.5 刻み）
+float vc_oversampler_latency(const VCOversampler *oversampler);
+
+/// フィルタの履歴をクリア
+void vc_oversampler_reset(VCOversampler *oversampler);
+
+/// count サンプルを補間し、count * factor サンプルの領域を返す（次の upsample まで有効）
+/// - Returns: count が 1〜maxFrames の範囲外なら NULL
+float *vc_oversampler_upsample(VCOversampler *oversampler, const float *input, int count);
+
+/// upsample が返した領域（書き換え済み）を帯域制限して間引き、count サンプルを output に書く
+/// count は直前の upsample と同じであること
+void vc_oversampler_downsample(VCOversampler *oversampler, float *output, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCOversampler_h */
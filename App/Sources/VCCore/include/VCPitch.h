@@ -0,0 +1,81 @@
+//
+//  VCPitch.h
+//  VoiceChanger
+//
+//  Streaming f0 tracker (YIN with an incrementally updated difference function) and delay-line pitch shifter
+//
+
+#ifndef VCPitch_h
+#define VCPitch_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 探索範囲の既定値（話し声）
+#define VC_PITCH_DEFAULT_MIN_HZ 60.0f
+#define VC_PITCH_DEFAULT_MAX_HZ 800.0f
+
+/// 1ブロックの推定結果
+typedef struct {
+    float f0Hz;         // 有声でなければ 0
+    float confidence;   // 0〜1（1 - 正規化差分関数の最小値）
+    int voiced;
+} VCPitchEstimate;
+
+/// ピッチトラッカー（不透明型）
+///
+/// 入力を 12kHz 付近へ間引き、YIN の差分関数を直近の窓について保持する。
+/// 自己相関項は新しいサンプルの分を足し、窓から出た分を引いて更新するので、
+/// ブロックあたりのコストはホップ長 × 最大ラグに比例する（窓長には依らない）。
+/// 丸め誤差が溜まらないよう、毎ブロック一部のラグを窓から計算し直す。
+/// 処理はメモリ確保・ロックなし。
+typedef struct VCPitchTracker VCPitchTracker;
+
+/// 作成（範囲外の指定は既定値に丸める、失敗時 NULL）
+VCPitchTracker *vc_pitch_create(int sampleRate, float minHz, float maxHz);
+void vc_pitch_destroy(VCPitchTracker *tracker);
+
+void vc_pitch_reset(VCPitchTracker *tracker);
+
+/// サンプルを取り込む（count は任意長）。search = 0 なら履歴の更新のみで探索しない（無音区間用）
+/// - Parameter outEstimate: 直近の窓の推定（NULL 可）
+void vc_pitch_process(VCPitchTracker *tracker, const float *samples, int count, int search,
+                      VCPitchEstimate *outEstimate);
+
+/// 遅延（窓の中心から現在までのサンプル数、入力レート）
+int vc_pitch_latency(const VCPitchTracker *tracker);
+
+// MARK: - Shifter
+
+/// 窓長の既定値（ms）
+#define VC_PITCH_SHIFTER_DEFAULT_WINDOW_MS 30.0f
+
+/// ピッチシフター（不透明型）
+///
+/// 遅延線から 2 つの位置を 2^(semitones/12) 倍の速さで読み、窓長の半周期ずらして三角窓で混ぜる。
+/// 読み出し位置が窓の端で折り返すとき、そちらのゲインは 0 なので継ぎ目は出ない。
+/// 周期に合わせて切らないぶん窓の周期のうなりが残るので、原音に重ねるレイヤー向け。
+/// 処理はメモリ確保・ロックなし。
+typedef struct VCPitchShifter VCPitchShifter;
+
+/// 作成（windowMs <= 0 なら既定値、失敗時 NULL）
+VCPitchShifter *vc_pitch_shifter_create(int sampleRate, float windowMs);
+void vc_pitch_shifter_destroy(VCPitchShifter *shifter);
+
+void vc_pitch_shifter_reset(VCPitchShifter *shifter);
+
+/// 移調量（半音、-24〜+24 に丸める）
+void vc_pitch_shifter_set_semitones(VCPitchShifter *shifter, float semitones);
+
+/// 処理（input == output のインプレース処理可、count は任意長）
+void vc_pitch_shifter_process(VCPitchShifter *shifter, const float *input, float *output, int count);
+
+/// 平均の遅延（サンプル、窓長の半分）
+float vc_pitch_shifter_latency(const VCPitchShifter *shifter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCPitch_h */
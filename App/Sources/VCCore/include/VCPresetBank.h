@@ -0,0 +1,150 @@
+//
+//  VCPresetBank.h
+//  VoiceChanger
+//
+//  Memory-mapped binary preset bank with a sorted hash index, and a file watcher for hot reload
+//
+
+#ifndef VCPresetBank_h
+#define VCPresetBank_h
+
+#include "VCChain.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// MARK: - File Layout
+
+/// ファイル形式（リトルエンディアン、各セクションは 16 バイト境界）
+///
+///     VCPresetBankHeader
+///     VCPresetIndexEntry[presetCount]   ハッシュ → レコード番号（hash, レコードの id の順に昇順）
+///     VCPresetRecord[presetCount]
+///     文字列表（NUL 終端の UTF-8）
+///
+/// レイアウトを変えるときは VC_PRESET_BANK_VERSION を上げる（古い版は開かない）
+#define VC_PRESET_BANK_MAGIC        0x42504356u     // "VCPB"
+#define VC_PRESET_BANK_VERSION      1
+#define VC_PRESET_BANK_MAX_PRESETS  65536
+#define VC_PRESET_NO_STRING         0xffffffffu     // 文字列なし（IR を使わないプリセット）
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t presetCount;
+    uint32_t recordSize;        // sizeof(VCPresetRecord)
+    uint32_t indexOffset;       // ファイル先頭からのバイト数
+    uint32_t recordsOffset;
+    uint32_t stringsOffset;
+    uint32_t stringsSize;
+    uint32_t checksum;          // ヘッダ以降の全バイトの FNV-1a
+    uint32_t reserved[7];
+} VCPresetBankHeader;
+
+typedef struct {
+    uint32_t hash;              // id の FNV-1a
+    uint32_t record;
+} VCPresetIndexEntry;
+
+/// フラグ（VoicePreset の Bool）
+enum {
+    VC_PRESET_FLAG_NOISE_SUPPRESSION = 1u << 0,
+    VC_PRESET_FLAG_AGC               = 1u << 1,
+    VC_PRESET_FLAG_VAD               = 1u << 2,
+    VC_PRESET_FLAG_MULTIBAND         = 1u << 3,
+};
+
+/// プリセット 1 件（固定長 80 バイト）
+typedef struct {
+    uint32_t idOffset;          // 文字列表内のオフセット
+    uint32_t nameOffset;
+    uint32_t impulseResponseOffset;
+    uint32_t flags;
+    float pitchShift;
+    float formantShift;
+    float eqLow;
+    float eqMid;
+    float eqHigh;
+    float noiseSuppressionStrength;
+    float agcTargetDb;
+    float compressorThresholdDb;
+    float compressorRatio;
+    float deEsserThresholdDb;
+    float deEsserRatio;
+    float convolutionMix;
+    uint32_t limiterOversampling;
+    uint32_t reserved[3];
+} VCPresetRecord;
+
+/// id のハッシュ（32bit FNV-1a）
+uint32_t vc_preset_hash(const char *id);
+
+// MARK: - Bank
+
+/// 書き出し・取り出しに使うプリセット（文字列はバンクのマップ領域または呼び出し側を指す）
+typedef struct {
+    const char *id;
+    const char *name;
+    const char *impulseResponse;    // NULL = IR なし
+    VCChainParams params;           // convolutionMix は IR がなくてもそのまま保存する
+} VCPresetEntry;
+
+/// プリセットバンク（不透明型）
+///
+/// ファイルを読み取り専用で mmap し、開くときにヘッダ・索引・全レコード・文字列・チェックサムを検証して、
+/// 各レコードを VCChainParams へ変換しておく（以降の取り出しはコピーのみ）。
+/// 開いた後は変更されないので、複数スレッドから同時に読んでよい。
+typedef struct VCPresetBank VCPresetBank;
+
+/// 開いて検証する（数千件でも数 ms 以内。オーディオスレッドからは呼ばないこと）
+/// - Returns: 失敗時 NULL（開けない / 版が違う / 範囲外のオフセット / 値が不正 / チェックサム不一致）
+VCPresetBank *vc_preset_bank_open(const char *path);
+void vc_preset_bank_close(VCPresetBank *bank);
+
+int vc_preset_bank_count(const VCPresetBank *bank);
+
+/// id からレコード番号を引く（索引を二分探索。なければ -1）
+int vc_preset_bank_find(const VCPresetBank *bank, const char *id);
+
+/// index 番目のプリセット（文字列はバンクを閉じるまで有効）
+/// - Returns: 0 = 成功、-1 = 範囲外
+int vc_preset_bank_get(const VCPresetBank *bank, int index, VCPresetEntry *outEntry);
+
+/// バンクを書き出す（同じディレクトリの一時ファイルに書いてから rename するので、監視側が書きかけを読むことはない）
+/// - Returns: 0 = 成功、-1 = 書けない / id の重複・空・件数超過
+int vc_preset_bank_write(const char *path, const VCPresetEntry *entries, int count);
+
+// MARK: - Watcher
+
+/// 新しいバンクを検証し終えたときに監視スレッドから呼ばれる（vc_preset_bank_watcher_take で受け取る）
+typedef void (*VCPresetBankCallback)(void *context);
+
+/// ファイル監視（不透明型）
+///
+/// 背景スレッドが intervalMs ごとにファイルの inode・サイズ・更新時刻を調べ、変わっていれば
+/// そのスレッドで開いて検証し、受け渡し口に置く。利用側は好きなタイミングで take して差し替える。
+/// オーディオ処理は古いバンクのパラメータのまま続くので止まらない。
+typedef struct VCPresetBankWatcher VCPresetBankWatcher;
+
+/// 作成時点のファイルを基準にし、以降の変更だけを読み込む（失敗時 NULL）
+/// - Parameter callback: NULL 可。監視スレッドから呼ばれるので、ブロックしないこと
+VCPresetBankWatcher *vc_preset_bank_watcher_create(const char *path, int intervalMs,
+                                                   VCPresetBankCallback callback, void *context);
+
+/// 監視スレッドを止めて破棄する（受け取られていないバンクも閉じる）
+void vc_preset_bank_watcher_destroy(VCPresetBankWatcher *watcher);
+
+/// 検証済みの新しいバンクを受け取る（所有権ごと渡す。なければ NULL）
+/// 受け取る前に次の変更を読み込んだ場合は古いほうを閉じ、最新だけを残す
+VCPresetBank *vc_preset_bank_watcher_take(VCPresetBankWatcher *watcher);
+
+/// 変更を検知したが検証に失敗した回数（書きかけ・壊れたファイル）
+uint64_t vc_preset_bank_watcher_rejected(const VCPresetBankWatcher *watcher);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCPresetBank_h */
@@ -0,0 +1,134 @@
+//
+//  VCSharedRing.h
+//  VoiceChanger
+//
+//  Zero-copy SPSC float ring laid out in caller-provided memory, so the
+//  same core serves in-process rings and the App <-> Driver shared memory
+//
+
+#ifndef VCSharedRing_h
+#define VCSharedRing_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VC_SHARED_RING_MAGIC        0x4D564356  // 'VCVM'
+#define VC_SHARED_RING_VERSION      3
+#define VC_SHARED_RING_HEADER_SIZE  192
+
+/// 連続領域2つ（折り返しがなければ second は NULL / 0）
+typedef struct {
+    float *first;
+    int firstCount;
+    float *second;
+    int secondCount;
+} VCRingRegions;
+
+/// 共有リングのビュー（メモリは所有しない）
+///
+/// メモリレイアウト（プロセス間 ABI）:
+///   [0, 64)    メタ情報: magic, version, sampleRate, frameSize, capacity, state, generation, heartbeat
+///   [64, 128)  writeIndex（producer のみ更新）
+///   [128, 192) readIndex、受け渡しの刻印（consumer のみ更新）
+///   [192, ...) float samples[capacity]
+/// インデックスは単調増加の uint32、容量は2のべき乗。
+/// generation は作成（format）のたびに増え、heartbeat は producer が書き込むたびに進む。
+typedef struct {
+    void *header;
+    float *samples;
+    unsigned int capacity;
+} VCSharedRing;
+
+/// 相手の状態（vc_shared_ring_watch_check の結果）
+typedef enum {
+    VC_SHARED_RING_PEER_ALIVE = 0,
+    VC_SHARED_RING_PEER_STALLED,    // 稼働中のまま heartbeat が timeout 以上止まっている（producer が落ちた）
+    VC_SHARED_RING_PEER_REPLACED,   // 作り直された（このビューは古いので接続し直すこと）
+} VCSharedRingPeer;
+
+/// 相手の監視状態（監視する側のスレッドだけが持つ。時刻の単位は呼び出し側の時計に合わせる）
+typedef struct {
+    uint32_t generation;
+    uint32_t heartbeat;
+    uint64_t lastBeat;
+    uint64_t timeout;
+} VCSharedRingWatch;
+
+/// 必要なバイト数（容量は2のべき乗であること）
+size_t vc_shared_ring_size(int capacity);
+
+/// メモリを初期化してビューを作る（作成側。他方はまだ接続していないこと）
+/// - Returns: 0 = 成功、-1 = 容量が2のべき乗でない / サイズ不足
+int vc_shared_ring_format(VCSharedRing *ring, void *memory, size_t size,
+                          int sampleRate, int frameSize, int capacity);
+
+/// 初期化済みメモリに接続する（magic / version / サイズを検証）
+/// - Returns: 0 = 成功、-1 = 不正なヘッダー
+int vc_shared_ring_attach(VCSharedRing *ring, void *memory, size_t size);
+
+/// 作成側の再起動用: 同じレイアウトの区画が残っていれば引き継ぎ、なければ作成する
+/// 引き継いだ場合はインデックスと世代をそのまま使うので、接続中の相手は張り替えずに再開できる
+/// - Returns: 1 = 引き継いだ（state は 0 に戻す）、0 = 作成した、-1 = 失敗
+int vc_shared_ring_reclaim(VCSharedRing *ring, void *memory, size_t size,
+                           int sampleRate, int frameSize, int capacity);
+
+int vc_shared_ring_sample_rate(const VCSharedRing *ring);
+int vc_shared_ring_frame_size(const VCSharedRing *ring);
+
+/// producer の状態（0 = 停止、1 = 稼働）。consumer は非稼働なら無音を出す
+void vc_shared_ring_set_active(VCSharedRing *ring, int active);
+int vc_shared_ring_is_active(const VCSharedRing *ring);
+
+/// 作成のたびに増える世代（0 = 作成中）
+uint32_t vc_shared_ring_generation(const VCSharedRing *ring);
+
+/// producer の生存通知（commit_write でも進む）
+void vc_shared_ring_heartbeat(VCSharedRing *ring);
+
+/// 監視を始める（接続した直後に呼ぶ）
+void vc_shared_ring_watch_init(VCSharedRingWatch *watch, const VCSharedRing *ring,
+                               uint64_t now, uint64_t timeout);
+
+/// 相手の状態を調べる（アトミックな読み出しのみなので IO スレッドから呼べる）
+/// producer が非稼働（state = 0）の間は停止とみなさない
+VCSharedRingPeer vc_shared_ring_watch_check(VCSharedRingWatch *watch, const VCSharedRing *ring,
+                                            uint64_t now);
+
+int vc_shared_ring_available_read(const VCSharedRing *ring);
+int vc_shared_ring_available_write(const VCSharedRing *ring);
+
+/// 今のインデックス（トレース用。どちらのスレッドからも呼べる）
+void vc_shared_ring_indices(const VCSharedRing *ring, uint32_t *outWriteIndex, uint32_t *outReadIndex);
+
+/// 書き込み領域の取得 / 確定（producer）
+int vc_shared_ring_write_regions(VCSharedRing *ring, int count, VCRingRegions *outRegions);
+void vc_shared_ring_commit_write(VCSharedRing *ring, int count);
+
+/// 読み出し領域の取得 / 確定（consumer）
+int vc_shared_ring_read_regions(VCSharedRing *ring, int count, VCRingRegions *outRegions);
+void vc_shared_ring_commit_read(VCSharedRing *ring, int count);
+
+/// コピー書き込み / 読み出し
+int vc_shared_ring_write(VCSharedRing *ring, const float *samples, int count);
+int vc_shared_ring_read(VCSharedRing *ring, float *samples, int count);
+
+/// 受け渡しの刻印（consumer）: リングの index 番目のサンプルを hostTime の時刻として渡した
+/// レイテンシの計測用。producer 側は vc_shared_ring_delivery で最新の刻印を読む
+void vc_shared_ring_stamp_delivery(VCSharedRing *ring, uint32_t index, uint64_t hostTime);
+
+/// 最新の受け渡しの刻印（どちらのスレッドからも呼べる）
+/// - Returns: 1 = 読めた、0 = まだない / 書き換え中
+int vc_shared_ring_delivery(const VCSharedRing *ring, uint32_t *outIndex, uint64_t *outHostTime);
+
+/// 空にする（producer / consumer とも停止しているときに呼ぶこと）
+void vc_shared_ring_reset(VCSharedRing *ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCSharedRing_h */
@@ -0,0 +1,107 @@
+//
+//  VCSignalGuard.h
+//  VoiceChanger
+//
+//  Signal-health guard: flush-to-zero on the processing thread, NaN/Inf/denormal scan, per-module reset with fade
+//
+
+#ifndef VCSignalGuard_h
+#define VCSignalGuard_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// リセット回数を数えるモジュールの最大数（モジュールの番号は使う側が決める。VCChainModule など）
+#define VC_SIGNAL_GUARD_MAX_MODULES 16
+
+/// vc_signal_scan の結果（ビットの組み合わせ）
+typedef enum {
+    VC_SIGNAL_NAN = 1 << 0,
+    VC_SIGNAL_INFINITE = 1 << 1,
+    VC_SIGNAL_DENORMAL = 1 << 2,
+} VCSignalFlags;
+
+#define VC_SIGNAL_NON_FINITE (VC_SIGNAL_NAN | VC_SIGNAL_INFINITE)
+
+// MARK: - Denormals
+
+/// 非正規化数を 0 として扱う（FTZ: 結果を 0 に、DAZ: 入力を 0 として読む）設定の退避先
+typedef struct {
+    uint64_t saved;
+    int changed;
+} VCDenormalScope;
+
+/// このビルドで FTZ/DAZ を切り替えられるか（x86 の MXCSR、arm64 の FPCR.FZ。ほかは 0）
+int vc_denormals_flush_supported(void);
+
+/// 呼び出したスレッドで FTZ/DAZ を有効にし、元の設定を scope に退避する（すでに有効なら何もしない）
+/// Swift の協調スレッドなど他の処理と共有するスレッドでは、ブロックの処理をこれと end で囲んで設定を漏らさないこと
+void vc_denormals_flush_begin(VCDenormalScope *scope);
+void vc_denormals_flush_end(const VCDenormalScope *scope);
+
+/// 呼び出したスレッドで以降ずっと有効にする（VCCore が作る処理スレッドの先頭で呼ぶ）
+void vc_denormals_flush_thread(void);
+
+/// 非正規化数なら 0（FTZ が使えない環境で、再帰フィルタの状態をブロックの終わりに落とす）
+static inline float vc_flush_denormal(float x) {
+    return x > -1.17549435e-38f && x < 1.17549435e-38f ? 0.0f : x;
+}
+
+// MARK: - Scan
+
+/// NaN・無限大・非正規化数を含むかを 4 レーンずつ調べる（VCSignalFlags の組み合わせ、0 = 正常）
+int vc_signal_scan(const float *samples, int count);
+
+/// NaN・無限大・非正規化数を 0 に置き換えて写す（input == output 可）
+/// - Returns: 置き換えたサンプル数
+int vc_signal_sanitize(const float *input, float *output, int count);
+
+// MARK: - Guard
+
+/// 統計
+typedef struct {
+    uint64_t blocks;                    // 検査したブロック数
+    uint64_t nonFiniteInputBlocks;      // 入力に NaN・無限大があったブロック数（0 に置き換えて処理）
+    uint64_t denormalInputBlocks;       // 入力に非正規化数があったブロック数（同上）
+    uint64_t resets;                    // モジュールをリセットした回数の合計
+    uint64_t moduleResets[VC_SIGNAL_GUARD_MAX_MODULES];
+} VCSignalGuardStats;
+
+/// ブロック単位の検査とリセット後のフェード
+///
+/// 入力は処理の前に検査して壊れたサンプルを 0 にする（状態に NaN を持ち込ませない）。
+/// 各モジュールの出力に NaN・無限大が出たら、呼び出し側がそのモジュールの状態だけをリセットし、
+/// そのブロックは無音、次のブロックから短くフェードインして戻す。
+/// 検査は確保・ロックなしで、処理スレッドから呼べる
+typedef struct {
+    VCSignalGuardStats stats;
+    int fadeLength;
+    int fadePosition;       // fadeLength に達したらフェードなし
+    int muted;              // このブロックでモジュールをリセットした
+} VCSignalGuard;
+
+void vc_signal_guard_init(VCSignalGuard *guard, int sampleRate);
+
+/// フェードを打ち切る（統計は残す。チェーンのリセット時に）
+void vc_signal_guard_reset(VCSignalGuard *guard);
+
+/// ブロックの入力を検査する。壊れたサンプルがあれば 0 に置き換えて output に写す
+/// - Returns: 1 = output に写した（以降は output をインプレースで処理すること）、0 = input のまま使える
+int vc_signal_guard_input(VCSignalGuard *guard, const float *input, float *output, int count);
+
+/// モジュールの出力を検査する。NaN・無限大があればブロックを 0 にし、リセットとして数える
+/// - Parameter module: 0..<VC_SIGNAL_GUARD_MAX_MODULES
+/// - Returns: 1 = 呼び出し側がそのモジュールの状態をリセットすること
+int vc_signal_guard_check(VCSignalGuard *guard, int module, float *samples, int count);
+
+/// チェーンの出力の仕上げ（リセットしたブロックは無音に、その後はフェードイン）
+void vc_signal_guard_finish(VCSignalGuard *guard, float *samples, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCSignalGuard_h */
@@ -0,0 +1,82 @@
+//
+//  VCStreamPool.h
+//  VoiceChanger
+//
+//  Work-stealing thread pool for processing many independent DSP streams
+//
+
+#ifndef VCStreamPool_h
+#define VCStreamPool_h
+
+#include <stdint.h>
+#include "VCChain.h"
+#include "VCBatch.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 登録可能な最大ストリーム数
+#define VC_STREAM_POOL_MAX_STREAMS 256
+
+/// プール統計
+typedef struct {
+    uint64_t blocksProcessed;
+    uint64_t samplesProcessed;
+    uint64_t tasksRun;          // ストリームタスクの実行回数
+    uint64_t steals;            // 他ワーカーから奪ったタスク数
+} VCStreamPoolStats;
+
+/// ストリーム処理プール（不透明型）
+///
+/// 各ストリームは独立した VCChain を持ち、ブロック単位のタスクとして処理される。
+/// 同一ストリームのブロックは投入順に1つずつ処理され、異なるストリームのブロックは
+/// 別コアで並行に処理される。空いたワーカーは他ワーカーのキューからタスクを奪う。
+typedef struct VCStreamPool VCStreamPool;
+
+/// オンラインCPU数
+int vc_stream_pool_cpu_count(void);
+
+/// プール作成（workerCount <= 0 ならCPU数）
+VCStreamPool *vc_stream_pool_create(int workerCount);
+
+/// プール破棄（未処理ブロックは処理してから終了）
+void vc_stream_pool_destroy(VCStreamPool *pool);
+
+/// ワーカー数
+int vc_stream_pool_worker_count(const VCStreamPool *pool);
+
+/// ブロック処理関数（count はフレーム数）
+typedef void (*VCStreamProcessFn)(void *context, const float *input, float *output, int count);
+
+/// ストリーム登録。chain はプールが所有しない
+/// - Returns: ストリームID、失敗時 -1
+int vc_stream_pool_add_stream(VCStreamPool *pool, VCChain *chain, int queueCapacity);
+
+/// SoA バッチ（lanes 本のチェーン）を1ストリームとして登録。batch はプールが所有しない
+/// 投入するブロックはバッチレイアウト（vc_batch_pack）で、count はフレーム数
+/// - Returns: ストリームID、失敗時 -1
+int vc_stream_pool_add_batch(VCStreamPool *pool, VCChainBatch *batch, int queueCapacity);
+
+/// 任意の処理関数をストリームとして登録（VCChainBatch など複数レーンをまとめたもの）
+/// lanes は1フレームあたりのサンプル数（統計用）
+/// - Returns: ストリームID、失敗時 -1
+int vc_stream_pool_add_processor(VCStreamPool *pool, VCStreamProcessFn process, void *context,
+                                 int lanes, int queueCapacity);
+
+/// ブロック投入（ストリームごとに単一スレッドから呼ぶこと）
+/// input/output はブロック処理完了まで有効であること
+/// - Returns: 0 成功、-1 キュー満杯または不正なID
+int vc_stream_pool_submit(VCStreamPool *pool, int streamId, const float *input, float *output, int count);
+
+/// 投入済みブロックがすべて処理されるまで待機
+void vc_stream_pool_wait(VCStreamPool *pool);
+
+/// 統計取得
+void vc_stream_pool_get_stats(VCStreamPool *pool, VCStreamPoolStats *outStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCStreamPool_h */
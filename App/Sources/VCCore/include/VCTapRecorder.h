@@ -0,0 +1,78 @@
+//
+//  VCTapRecorder.h
+//  VoiceChanger
+//
+//  Lock-free capture taps drained by a background thread into streaming WAV / raw files
+//
+
+#ifndef VCTapRecorder_h
+#define VCTapRecorder_h
+
+#include "VCSharedRing.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define VC_TAP_RECORDER_MAX_TAPS    8
+
+/// 出力形式（どちらもモノラル float32 リトルエンディアン）
+typedef enum {
+    VC_TAP_FORMAT_WAV = 0,  // WAVE_FORMAT_IEEE_FLOAT。4GB を超えたら RF64 にする
+    VC_TAP_FORMAT_RAW,      // ヘッダーなし
+} VCTapFormat;
+
+/// 録音 1 回分の統計（start で 0 に戻る）
+typedef struct {
+    uint64_t framesWritten;     // ファイルへ書いたフレーム数
+    uint64_t droppedFrames;     // リングが満杯で捨てたフレーム数（push 側で数える）
+    uint64_t overflows;         // 捨てた push の回数
+    uint64_t writeErrors;       // 書き込みに失敗した回数（以降その tap の音声は捨てる）
+} VCTapStats;
+
+/// 録音タップ（不透明型）
+///
+/// tap ごとに事前確保した SPSC リングを持ち、オーディオスレッドは push でコピーするだけ
+/// （ロック・確保・システムコールなし。録音していなければ何もしない）。
+/// 録音中は背景スレッドが intervalMs ごとに各リングを読み、大きな書き込みバッファにまとめて
+/// 追記する。ファイルは先に領域を確保しておき、ヘッダーは書き込みのたびに更新するので、
+/// 途中で落ちてもそこまでは読める。
+/// tap の追加は録音前に行う。オブジェクトはエンジンと同じ寿命で使い回し、start / stop で録音 1 回分になる。
+typedef struct VCTapRecorder VCTapRecorder;
+
+/// - Parameter intervalMs: 背景スレッドがリングを読む間隔
+VCTapRecorder *vc_tap_recorder_create(int sampleRate, int intervalMs);
+void vc_tap_recorder_destroy(VCTapRecorder *recorder);
+
+/// push で書き込む tap を追加する（ringFrames は intervalMs より十分長くする）
+/// - Returns: tap 番号、失敗時 -1
+int vc_tap_recorder_add(VCTapRecorder *recorder, int ringFrames);
+
+/// 外部のリング（別プロセスが書く共有メモリなど）をそのまま読む tap を追加する（push は使わない）
+/// ring はビューの置き場所だけを覚える。録音開始時に接続されていなければその tap は録音しない
+int vc_tap_recorder_add_ring(VCTapRecorder *recorder, VCSharedRing *source);
+
+int vc_tap_recorder_count(const VCTapRecorder *recorder);
+
+/// 録音を始める（paths は tap 数ぶん。NULL の tap は録音しない。リングに残っていた分は捨てる）
+/// - Returns: 0 = 成功、-1 = 録音中 / ファイルを作れない / スレッドを起動できない
+int vc_tap_recorder_start(VCTapRecorder *recorder, const char *const *paths, VCTapFormat format);
+
+/// 残りを書き出してヘッダーを確定し、ファイルを閉じる（録音していなければ何もしない）
+void vc_tap_recorder_stop(VCTapRecorder *recorder);
+
+int vc_tap_recorder_is_recording(const VCTapRecorder *recorder);
+
+/// オーディオスレッドから呼ぶ（録音中でなければ 0 を返すだけ）
+/// - Returns: リングへ書いたフレーム数（入りきらなければブロックごと捨てて 0。droppedFrames に数える）
+int vc_tap_recorder_push(VCTapRecorder *recorder, int tap, const float *samples, int count);
+
+/// 統計（どのスレッドからでも読める）
+void vc_tap_recorder_get_stats(const VCTapRecorder *recorder, int tap, VCTapStats *outStats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCTapRecorder_h */
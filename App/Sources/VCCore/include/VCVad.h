@@ -0,0 +1,63 @@
+//
+//  VCVad.h
+//  VoiceChanger
+//
+//  Voice activity detector (energy over noise floor + spectral flatness + zero-crossing rate)
+//
+
+#ifndef VCVad_h
+#define VCVad_h
+
+#include "VCAnalysis.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 判定状態（直近ブロック）
+typedef struct {
+    int speech;                 // 発話中（ハングオーバー込み）
+    int rawSpeech;              // このブロック単体の判定
+    float activity;             // 重い処理の適用率 0〜1（ブロック末尾、フェード込み）
+    float energyDb;             // ブロックの平均パワー（dBFS）
+    float noiseFloorDb;         // 追従中のノイズフロア
+    float flatness;             // スペクトル平坦度 0（トーン）〜 1（白色雑音）
+    float zeroCrossingRate;     // 0〜1（サンプルあたり）
+    uint64_t speechBlocks;
+    uint64_t silentBlocks;
+} VCVadState;
+
+/// VAD（不透明型）
+///
+/// ブロックのパワー・ゼロ交差率と、直近 256 サンプルのスペクトル平坦度から発話を判定する。
+/// 発話終了後はハングオーバーの間は発話扱いを続け、その後 activity を数十 ms かけて 0 へ下げる
+/// （発話開始時は即 1 に戻す）。
+/// 処理はメモリ確保・ロックなし。
+typedef struct VCVad VCVad;
+
+/// 作成（失敗時 NULL）
+VCVad *vc_vad_create(int sampleRate);
+void vc_vad_destroy(VCVad *vad);
+
+/// ノイズフロアと判定をリセット（activity は 1 から始まる）
+void vc_vad_reset(VCVad *vad);
+
+/// 1ブロック解析（count は任意長、samples は変更しない）
+/// - Returns: 発話中なら 1（ハングオーバー込み）
+int vc_vad_process(VCVad *vad, const float *samples, int count);
+
+/// vc_vad_process と同じだが、平坦度は共有の解析コンテキストから得る（自前の FFT を省く）
+/// - Parameter analysis: 同じブロックで begin_block 済みであること（NULL なら vc_vad_process と同じ）
+int vc_vad_process_with_analysis(VCVad *vad, const float *samples, int count, VCAnalysisContext *analysis);
+
+/// 重い処理の適用率（0 = 完全に省略してよい）
+float vc_vad_activity(const VCVad *vad);
+
+void vc_vad_get_state(const VCVad *vad, VCVadState *outState);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCVad_h */
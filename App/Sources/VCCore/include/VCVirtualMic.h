@@ -0,0 +1,54 @@
+//
+//  VCVirtualMic.h
+//  VoiceChanger
+//
+//  Object-ID and shared-memory naming scheme for multiple virtual mics (shared with the driver)
+//
+
+#ifndef VCVirtualMic_h
+#define VCVirtualMic_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// 公開する仮想マイクの最大数（ドライバのデバイス数はこれ以下で固定）
+#define VC_VIRTUAL_MIC_MAX              8
+
+/// 共有メモリ名（マイク 0 はサフィックスなし、マイク k は ".k+1"。macOS の名前上限 31 文字に収まる）
+#define VC_VIRTUAL_MIC_MEMORY_NAME      "com.voicechanger.audio"
+#define VC_VIRTUAL_MIC_MEMORY_NAME_MAX  32
+
+/// マイク 0 のオブジェクトID（ドライバの kObjectID_Device〜kObjectID_Mute_Input と同じ）
+#define VC_VIRTUAL_MIC_PRIMARY_BASE     2
+/// マイク 1 以降のオブジェクトID（マイクごとに VC_VIRTUAL_MIC_OBJECT_COUNT 個ずつ連番）
+#define VC_VIRTUAL_MIC_EXTRA_BASE       16
+
+/// マイク 1 本が持つオブジェクト（ID の並び順）
+typedef enum {
+    VC_VIRTUAL_MIC_DEVICE = 0,
+    VC_VIRTUAL_MIC_STREAM,
+    VC_VIRTUAL_MIC_VOLUME,
+    VC_VIRTUAL_MIC_MUTE,
+    VC_VIRTUAL_MIC_OBJECT_COUNT
+} VCVirtualMicObject;
+
+/// mic 番目のマイクの object のオブジェクトID（範囲外なら 0 = kAudioObjectUnknown）
+uint32_t vc_virtual_mic_object_id(int mic, VCVirtualMicObject object);
+
+/// オブジェクトID からマイク番号を引く（仮想マイクのオブジェクトでなければ -1）
+/// - Parameter outObject: NULL 可
+int vc_virtual_mic_index(uint32_t objectId, VCVirtualMicObject *outObject);
+
+/// mic 番目のマイクの共有メモリ名
+/// - Returns: 0 = 成功、-1 = 範囲外 / バッファ不足
+int vc_virtual_mic_memory_name(int mic, char *buffer, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCVirtualMic_h */
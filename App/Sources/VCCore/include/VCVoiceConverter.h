@@ -0,0 +1,175 @@
+//
+//  VCVoiceConverter.h
+//  VoiceChanger
+//
+//  Causal streaming neural voice conversion: memory-mapped int8 model, cached activations, look-ahead worker
+//
+
+#ifndef VCVoiceConverter_h
+#define VCVoiceConverter_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// MARK: - Model
+
+/// ネットワーク（hop サンプルごとに 1 フレーム、すべて因果的）
+///
+///     encoder   直前 + 現在の hop（2·hop サンプル、√Hann 窓）→ channels、ReLU
+///     conv[l]   kernelSize タップ・dilation 2^l の因果畳み込み channels → channels、ReLU、残差
+///     gru       channels → hiddenSize（ゲート順 r, z, n）
+///     decoder   hiddenSize → 2·hop サンプル、√Hann 窓で overlap-add（アルゴリズム遅延 hop）
+///
+/// 重みは行ごとのスケールを持つ int8（実数値 = scale[row] × q、q は -127〜127）、バイアスは float。
+/// 活性はフレームごとに int8 の範囲へ量子化し、内積は int32 で正確に累積する
+typedef struct {
+    int sampleRate;
+    int hop;            // 32〜256 の 2 のべき乗
+    int channels;       // 16 の倍数、16〜1024
+    int convLayers;     // 1〜VC_VOICE_MODEL_MAX_CONV_LAYERS
+    int kernelSize;     // 1〜8
+    int hiddenSize;     // 16 の倍数、16〜1024
+} VCVoiceModelConfig;
+
+#define VC_VOICE_MODEL_MAX_CONV_LAYERS 12
+
+/// ファイル形式（リトルエンディアン）
+///
+///     VCVoiceModelHeader
+///     VCVoiceModelTensor[tensorCount]   encoder, conv[0..convLayers), gruInput, gruHidden, decoder の順
+///     各テンソルの int8 重み [rows][stride]・float scale[rows]・float bias[rows]（それぞれ 64 バイト境界）
+///
+/// stride は cols を 16 に切り上げた値で、余りの列は 0。
+/// レイアウトを変えるときは VC_VOICE_MODEL_VERSION を上げる（古い版は開かない）
+#define VC_VOICE_MODEL_MAGIC    0x4d564356u     // "VCVM"
+#define VC_VOICE_MODEL_VERSION  1
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t sampleRate;
+    uint32_t hop;
+    uint32_t channels;
+    uint32_t convLayers;
+    uint32_t kernelSize;
+    uint32_t hiddenSize;
+    uint32_t tensorCount;       // convLayers + 4
+    uint32_t checksum;          // ヘッダ以降の全バイトの FNV-1a
+    uint32_t reserved[6];
+} VCVoiceModelHeader;
+
+typedef struct {
+    uint32_t rows;
+    uint32_t cols;
+    uint32_t stride;
+    uint32_t weightsOffset;     // ファイル先頭からのバイト数
+    uint32_t scalesOffset;
+    uint32_t biasOffset;
+    uint32_t reserved[2];
+} VCVoiceModelTensor;
+
+/// 層（書き出し用の float 値、行優先 rows × cols）
+typedef struct {
+    const float *weights;
+    const float *bias;          // NULL = 0
+} VCVoiceModelLayer;
+
+/// テンソルの数
+int vc_voice_model_layer_count(const VCVoiceModelConfig *config);
+
+/// index 番目のテンソルの形
+/// - Returns: 0 = 成功、-1 = 範囲外
+int vc_voice_model_layer_shape(const VCVoiceModelConfig *config, int index, int *outRows, int *outCols);
+
+/// 既定の構成（48kHz、hop 128、256 チャンネル × 6 層、kernel 3、GRU 256）
+void vc_voice_model_config_default(VCVoiceModelConfig *config);
+
+/// 学習済みの float 重みを行ごとに int8 へ量子化して書き出す
+/// - Parameter layers: vc_voice_model_layer_count 個（vc_voice_model_layer_shape の形）
+/// - Returns: 0 = 成功、-1 = 構成が範囲外 / 書けない
+int vc_voice_model_write(const char *path, const VCVoiceModelConfig *config, const VCVoiceModelLayer *layers);
+
+/// 乱数の重みで書き出す（学習していないモデル。計算量・ストリーミングの検証とベンチマーク用）
+int vc_voice_model_write_random(const char *path, const VCVoiceModelConfig *config, uint32_t seed);
+
+/// 声質変換モデル（不透明型）
+///
+/// ファイルを読み取り専用で mmap し、重みはマップした領域を直接読む（コピーしない）。
+/// 開いた後は変更されないので、複数の変換器で共有してよい
+typedef struct VCVoiceModel VCVoiceModel;
+
+/// 開いて検証する（オーディオスレッドからは呼ばないこと）
+/// - Returns: 失敗時 NULL（開けない / 版が違う / 構成が範囲外 / オフセット不正 / チェックサム不一致）
+VCVoiceModel *vc_voice_model_open(const char *path);
+void vc_voice_model_close(VCVoiceModel *model);
+
+void vc_voice_model_get_config(const VCVoiceModel *model, VCVoiceModelConfig *outConfig);
+
+/// 1 フレームの積和回数
+long vc_voice_model_macs_per_frame(const VCVoiceModel *model);
+
+/// 重みの合計サイズ（バイト、int8 + scale + bias）
+size_t vc_voice_model_weight_bytes(const VCVoiceModel *model);
+
+// MARK: - Converter
+
+/// 作成オプション
+typedef struct {
+    int lookAheadFrames;    // 0 = process 内で計算、> 0 = 補助スレッドが計算し、この hop 数だけ遅らせて受け取る
+    int scalarKernels;      // SIMD を使わない（比較用。結果はビット単位で同じ）
+} VCVoiceConverterOptions;
+
+/// 統計
+typedef struct {
+    uint64_t frames;        // 受け取ったフレーム数
+    uint64_t computed;      // 推論したフレーム数
+    uint64_t lateFrames;    // 補助スレッドが間に合わずドライで代用したフレーム数
+} VCVoiceConverterStats;
+
+#define VC_VOICE_CONVERTER_MAX_LOOKAHEAD 16
+
+/// ストリーミングの声質変換（不透明型）
+///
+/// 各層の過去の活性（量子化済み）と GRU の状態を保持し、ブロックごとには新しいフレームの分だけ計算する。
+/// 補助スレッドを使う場合、オーディオスレッドは入力をリングへ書いて起こし、lookAheadFrames だけ前の
+/// 結果を読むだけになる。間に合わなかったフレームは待たずにドライで代用し lateFrames に数える
+/// （推論は続けるので状態は途切れない）。
+/// process はメモリ確保・ブロッキングするロックなし（起床は trylock のみ）
+typedef struct VCVoiceConverter VCVoiceConverter;
+
+/// 作成（model は変換器より長く生存すること。失敗時 NULL）
+/// - Parameter options: NULL で既定（補助スレッドなし、SIMD）
+VCVoiceConverter *vc_voice_converter_create(const VCVoiceModel *model, const VCVoiceConverterOptions *options);
+void vc_voice_converter_destroy(VCVoiceConverter *converter);
+
+/// 状態・履歴をクリア（補助スレッドの計算が終わるまで待つので、オーディオスレッドからは呼ばないこと）
+void vc_voice_converter_reset(VCVoiceConverter *converter);
+
+/// 補助スレッドが推論中でなければクリアする（待たないのでオーディオスレッドから呼べる）
+/// - Returns: 0 = クリアした、-1 = 推論中（何もしていない）
+int vc_voice_converter_try_reset(VCVoiceConverter *converter);
+
+/// 変換結果とドライの比率（0 = ドライのみ、1 = 変換結果のみ、既定 1。process と同一スレッドから）
+void vc_voice_converter_set_mix(VCVoiceConverter *converter, float mix);
+
+/// hop（process の count はこの倍数であること）
+int vc_voice_converter_hop(const VCVoiceConverter *converter);
+
+/// 遅延（サンプル。hop + lookAheadFrames × hop、ドライも同じだけ遅らせて混ぜる）
+int vc_voice_converter_latency(const VCVoiceConverter *converter);
+
+void vc_voice_converter_get_stats(const VCVoiceConverter *converter, VCVoiceConverterStats *outStats);
+
+/// 音声処理（input == output 可）
+/// - Returns: 0 = 成功、-1 = count が hop の倍数でない（output は変更しない）
+int vc_voice_converter_process(VCVoiceConverter *converter, const float *input, float *output, int count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* VCVoiceConverter_h */
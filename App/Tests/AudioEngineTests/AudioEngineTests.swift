@@ -1,4 +1,6 @@
 import XCTest
+import DSP
+import VCCore
 @testable import AudioEngine
 
 final class AudioEngineTests: XCTestCase {
@@ -19,6 +21,8 @@ final class AudioEngineTests: XCTestCase {
         XCTAssertEqual(LatencyMode.ultraLow.frameSize, 128)
         XCTAssertEqual(LatencyMode.balanced.frameSize, 256)
         XCTAssertEqual(LatencyMode.highQuality.frameSize, 512)
+        XCTAssertEqual(LatencyMode.maxFrameSize, 512)
+        XCTAssertEqual(LatencyMode.maxFrameSize, LatencyMode.allCases.map(\.frameSize).max())
     }
 
     // MARK: - Engine Stats Tests
@@ -32,6 +36,90 @@ final class AudioEngineTests: XCTestCase {
         XCTAssertEqual(stats.droppedFrames, 0)
     }
 
+    // MARK: - Processing Path Tests
+
+    /// キャプチャリング → DSP → 共有メモリ・録音タップ（処理キュー）が、Swift 側も含めてブロックごとに確保しない
+    func testCaptureProcessingDoesNotAllocate() throws {
+        try XCTSkipIf(vc_realtime_track_heap(1) == 0, "この環境ではプロセスのヒープ確保を数えられない")
+        defer { vc_realtime_track_heap(0) }
+
+        let engine = AudioEngine()
+        try engine.prepareBuffers()
+        let frameSize = LatencyMode.balanced.frameSize
+        let signal: [Float] = (0..<frameSize * 40).map { 0.2 * sin(Float($0) * 2 * .pi * 160 / 48000) }
+
+        signal.withUnsafeBufferPointer { input in
+            // 初回だけの準備（型メタデータ・遅延初期化）を済ませてから数える
+            engine.processCapture(input.baseAddress!, count: frameSize)
+
+            let heapBefore = vc_realtime_heap_alloc_count()
+            let coreBefore = vc_realtime_alloc_count()
+            for offset in stride(from: frameSize, to: input.count, by: frameSize) {
+                engine.processCapture(input.baseAddress! + offset, count: frameSize)
+            }
+            XCTAssertEqual(vc_realtime_heap_alloc_count() - heapBefore, 0, "Swift / libc allocated on the processing queue")
+            XCTAssertEqual(vc_realtime_alloc_count() - coreBefore, 0, "VCCore allocated on the processing queue")
+        }
+    }
+
+    /// DSP 後の録音タップは処理キューから DSP の直後に push するので、ブロックが欠けず・入れ替わらずに並ぶ
+    func testProcessedTapRecordsEveryBlockInOrder() async throws {
+        let engine = AudioEngine()
+        try engine.prepareBuffers()
+        let directory = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString)
+        defer { try? FileManager.default.removeItem(at: directory) }
+
+        let frameSize = LatencyMode.balanced.frameSize
+        let blocks = 24
+        let signal: [Float] = (0..<frameSize * blocks).map { 0.2 * sin(Float($0) * 2 * .pi * (120 + Float($0 / frameSize) * 40) / 48000) }
+
+        let urls = try engine.startRecording(to: directory)
+        signal.withUnsafeBufferPointer { input in
+            for offset in stride(from: 0, to: input.count, by: frameSize) {
+                engine.processCapture(input.baseAddress! + offset, count: frameSize)
+            }
+        }
+        engine.stopRecording()
+
+        // 同じ既定のチェーンにブロック順で通したものと一致する
+        let reference = DSPChain()
+        var expected: [Float] = []
+        for offset in stride(from: 0, to: signal.count, by: frameSize) {
+            var frame = AudioFrame(samples: Array(signal[offset..<offset + frameSize]))
+            await reference.process(&frame)
+            expected += frame.samples
+        }
+
+        let processedURL = try XCTUnwrap(urls.first { $0.lastPathComponent.contains("-processed.") })
+        let data = try Data(contentsOf: processedURL)
+        let wavHeaderSize = 92
+        let recorded = data.dropFirst(wavHeaderSize).withUnsafeBytes { Array($0.bindMemory(to: Float.self)) }
+        XCTAssertEqual(recorded.count, expected.count)
+        XCTAssertLessThanOrEqual(zip(recorded, expected).map { abs($0 - $1) }.max() ?? 0, 1e-6)
+        XCTAssertEqual(engine.recordingStats().first { $0.tap == .processed }?.droppedFrames, 0)
+    }
+
+    /// レイテンシモードの切り替えは処理キューで反映され、以降はそのブロック長で読み出す
+    func testLatencyModeChangeAppliesToProcessingQueue() async throws {
+        let engine = AudioEngine()
+        try engine.prepareBuffers()
+        let directory = FileManager.default.temporaryDirectory.appendingPathComponent(UUID().uuidString)
+        defer { try? FileManager.default.removeItem(at: directory) }
+
+        let frameSize = LatencyMode.ultraLow.frameSize
+        let block = [Float](repeating: 0.1, count: frameSize)
+        try engine.startRecording(to: directory)
+
+        // 既定（balanced）では 128 フレームは 1 ブロックに満たない
+        block.withUnsafeBufferPointer { engine.processCapture($0.baseAddress!, count: frameSize) }
+        await engine.setLatencyMode(.ultraLow)
+        block.withUnsafeBufferPointer { engine.processCapture($0.baseAddress!, count: frameSize) }
+        engine.stopRecording()
+
+        // 切り替え後の読み出しで、溜まっていた分と合わせて 2 ブロック処理した
+        XCTAssertEqual(engine.recordingStats().first { $0.tap == .processed }?.framesWritten, UInt64(2 * frameSize))
+    }
+
     // MARK: - Device Manager Tests
 
     func testDeviceManagerInitialization() {
@@ -46,6 +46,26 @@ final class DSPChainTests: XCTestCase {
         XCTAssertEqual(frame.samples, originalSamples)
     }
 
+    /// 出力タップの付け外しはキュー上で呼んだ順に反映され、外した後のブロックは push されない
+    func testOutputTapChangesApplyInQueueOrder() {
+        let queue = DispatchSerialQueue(label: "test.dspchain")
+        let chain = DSPChain(queue: queue)
+        let first = CountingTap()
+        let second = CountingTap()
+        var block = [Float](repeating: 0.1, count: 256)
+
+        block.withUnsafeMutableBufferPointer { buffer in
+            queue.async { chain.applyOutputTap(first) }
+            queue.async { chain.applyOutputTap(second) }
+            queue.sync { chain.process(inPlace: buffer) }
+            queue.async { chain.applyOutputTap(nil) }
+            queue.sync { chain.process(inPlace: buffer) }
+        }
+
+        XCTAssertEqual(first.samples, 0)
+        XCTAssertEqual(second.samples, 256)
+    }
+
     // MARK: - Limiter Tests
 
     func testLimiterClamps() {
@@ -60,6 +80,25 @@ final class DSPChainTests: XCTestCase {
         XCTAssertEqual(frame.samples[3], -0.5, accuracy: 0.001)
     }
 
+    // MARK: - Multi-Stream Tests
+
+    func testMultiStreamEngineProcessesAllStreams() {
+        let engine = MultiStreamEngine(workerCount: 2, blockSize: 256)
+        XCTAssertNotNil(engine.addStream(preset: .default))
+        XCTAssertNotNil(engine.addStream(preset: .maleToFemale))
+
+        var buffers: [[Float]] = [
+            (0..<1000).map { sin(Float($0) * 0.05) },
+            (0..<700).map { sin(Float($0) * 0.02) },
+        ]
+        engine.process(&buffers)
+
+        XCTAssertEqual(buffers[0].count, 1000)
+        XCTAssertEqual(buffers[1].count, 700)
+        // 1000 → 4ブロック, 700 → 3ブロック
+        XCTAssertEqual(engine.stats.blocksProcessed, 7)
+    }
+
     // MARK: - Preset Tests
 
     func testDefaultPresetLoad() {
@@ -73,6 +112,8 @@ final class DSPChainTests: XCTestCase {
         XCTAssertEqual(preset.id, "male_to_female")
         XCTAssertGreaterThan(preset.pitchShift, 0)
         XCTAssertGreaterThan(preset.formantShift, 0)
+        XCTAssertEqual(preset.chainParams.multibandEnabled, 1)
+        XCTAssertLessThan(preset.chainParams.deEsserThresholdDb, VoicePreset.default.deEsserThresholdDb)
     }
 
     func testFemaleToMalePreset() {
@@ -81,4 +122,84 @@ final class DSPChainTests: XCTestCase {
         XCTAssertLessThan(preset.pitchShift, 0)
         XCTAssertLessThan(preset.formantShift, 0)
     }
+
+    func testConvolutionPresetsReferenceBuiltinImpulseResponses() {
+        for id in ["phone", "radio", "hall"] {
+            let preset = VoicePreset.load(id: id)
+            XCTAssertEqual(preset?.impulseResponse, id)
+            XCTAssertGreaterThan(preset?.chainParams.convolutionMix ?? 0, 0)
+            XCTAssertNotNil(ImpulseResponseLibrary.samples(for: id))
+        }
+        XCTAssertNil(ImpulseResponseLibrary.samples(for: "/nonexistent/ir.wav"))
+        XCTAssertEqual(VoicePreset.default.chainParams.convolutionMix, 0)
+    }
+
+    func testGraphPresetReplacesLinearChain() async throws {
+        await dspChain.loadPreset("duet")
+        let running = await dspChain.isRunningGraph
+        XCTAssertTrue(running)
+        let latency = await dspChain.processingLatency()
+        XCTAssertGreaterThan(latency, 720)      // 1 オクターブ下のレイヤー（30ms 窓の半分）
+
+        var frame = AudioFrame(samples: (0..<256).map { 0.3 * sinf(Float($0) * 0.05) })
+        await dspChain.process(&frame)
+        XCTAssertTrue(frame.samples.allSatisfy(\.isFinite))
+
+        // 並行処理に切り替えても作り直せる。グラフのないプリセットでは直列チェーンに戻る
+        await dspChain.setGraphWorkers(1)
+        let parallel = await dspChain.isRunningGraph
+        XCTAssertTrue(parallel)
+        await dspChain.loadPreset("hall")
+        let linear = await dspChain.isRunningGraph
+        XCTAssertFalse(linear)
+
+        let decoded = try JSONDecoder().decode(VoicePreset.self, from: JSONEncoder().encode(VoicePreset.duet))
+        XCTAssertEqual(decoded.graph, VoicePreset.duet.graph)
+    }
+
+    func testMissingVoiceModelLeavesChainUnchanged() async {
+        let latency = await dspChain.processingLatency()
+        let opened = await dspChain.setVoiceModel(path: "/nonexistent/model.vcvm")
+        XCTAssertFalse(opened)
+        let stats = await dspChain.voiceConverterStats()
+        XCTAssertNil(stats)
+        let unchanged = await dspChain.processingLatency()
+        XCTAssertEqual(unchanged, latency)
+        let cleared = await dspChain.setVoiceModel(path: nil)
+        XCTAssertTrue(cleared)
+    }
+
+    func testPresetBankRoundTripsVoicePresets() async throws {
+        let path = FileManager.default.temporaryDirectory
+            .appendingPathComponent("vc-presets-\(UUID().uuidString).vcpb").path
+        defer { try? FileManager.default.removeItem(atPath: path) }
+
+        var tuned = VoicePreset(id: "tuned", name: "Tuned")
+        tuned.limiterOversampling = 4
+        XCTAssertTrue(PresetBank.write(VoicePreset.builtins + [tuned], to: path))
+
+        let bank = try XCTUnwrap(PresetBank(path: path))
+        XCTAssertEqual(bank.count, VoicePreset.builtins.count + 1)
+        let hall = try XCTUnwrap(bank.preset(id: "hall"))
+        XCTAssertEqual(hall.impulseResponse, "hall")
+        XCTAssertEqual(hall.convolutionMix, VoicePreset.hall.convolutionMix)
+        XCTAssertEqual(bank.preset(id: "male_to_female")?.deEsserThresholdDb, VoicePreset.maleToFemale.deEsserThresholdDb)
+        XCTAssertEqual(bank.preset(id: "tuned")?.limiterOversampling, 4)
+        XCTAssertNil(bank.preset(id: "missing"))
+
+        let chain = DSPChain()
+        let opened = await chain.setPresetBank(path: path)
+        XCTAssertTrue(opened)
+        let available = await chain.availablePresets()
+        XCTAssertEqual(available.map(\.id).sorted(), (VoicePreset.builtins.map(\.id) + ["tuned"]).sorted())
+    }
+}
+
+/// push されたサンプル数を数えるタップ
+private final class CountingTap: AudioOutputTap {
+    private(set) var samples = 0
+
+    func push(_ samples: UnsafeBufferPointer<Float>) {
+        self.samples += samples.count
+    }
 }
@@ -0,0 +1,108 @@
+import XCTest
+import VCCore
+
+final class VCAnalysisTests: XCTestCase {
+
+    private let sampleRate = 48000
+
+    // MARK: - Lazy STFT
+
+    func testSpectraAreComputedOncePerFrame() {
+        let context = vc_analysis_create(512, nil)!
+        defer { vc_analysis_destroy(context) }
+
+        // 3 kHz = ビン 16 ちょうど
+        let tone = (0..<512).map { 0.5 * sin(2 * Float.pi * 3000 * Float($0) / Float(sampleRate)) }
+        for _ in 0..<2 {
+            vc_analysis_begin_block(context, tone, 512)
+        }
+        XCTAssertEqual(vc_analysis_frame_count(context), 4)
+
+        for frame in Int32(0)..<4 {
+            let magnitude = UnsafeBufferPointer(start: vc_analysis_magnitude(context, frame), count: Int(VC_ANALYSIS_BINS))
+            XCTAssertEqual(magnitude.indices.max { magnitude[$0] < magnitude[$1] }, 16)
+            // Hann 窓のコヒーレントゲイン 0.5 × 振幅 0.5 × N/2
+            XCTAssertEqual(magnitude[16], 32, accuracy: 0.01)
+        }
+        XCTAssertEqual(vc_analysis_fft_count(context), 4)
+
+        // 同じブロックの2回目以降・派生スペクトルは FFT しない
+        for frame in Int32(0)..<4 {
+            _ = vc_analysis_power(context, frame)
+            _ = vc_analysis_log_spectrum(context, frame)
+        }
+        XCTAssertEqual(vc_analysis_fft_count(context), 4)
+
+        vc_analysis_begin_block(context, tone, 512)
+        _ = vc_analysis_magnitude(context, 3)
+        XCTAssertEqual(vc_analysis_fft_count(context), 5)
+    }
+
+    // MARK: - LPC
+
+    func testLpcEnvelopePeaksAtResonance() {
+        let context = vc_analysis_create(256, nil)!
+        defer { vc_analysis_destroy(context) }
+
+        // AR(2): x[n] = 1.6 x[n-1] - 0.8 x[n-2] + e[n]（極の角度 0.464 rad = ビン 18.9）
+        var seed: UInt32 = 4
+        var history: (Float, Float) = (0, 0)
+        for _ in 0..<4 {
+            let block: [Float] = (0..<256).map { _ in
+                seed = seed &* 1664525 &+ 1013904223
+                let excitation = (Float(seed >> 8) / 16777216 - 0.5) * 0.1
+                let sample = 1.6 * history.0 - 0.8 * history.1 + excitation
+                history = (sample, history.0)
+                return sample
+            }
+            vc_analysis_begin_block(context, block, 256)
+        }
+
+        var error: Float = 0
+        let a = UnsafeBufferPointer(start: vc_analysis_lpc(context, &error), count: Int(VC_ANALYSIS_LPC_ORDER) + 1)
+        XCTAssertEqual(a[0], 1)
+        XCTAssertLessThan(error, 0.1)
+
+        let envelope = (0...128).map { bin -> Float in
+            var re: Float = 0, im: Float = 0
+            for (k, coefficient) in a.enumerated() {
+                let omega = 2 * Float.pi * Float(bin * k) / 256
+                re += coefficient * cos(omega)
+                im -= coefficient * sin(omega)
+            }
+            return 1 / (re * re + im * im)
+        }
+        let peak = envelope.indices.max { envelope[$0] < envelope[$1] }!
+        XCTAssertEqual(Double(peak), 19, accuracy: 3)
+    }
+
+    // MARK: - Chain
+
+    func testChainVadSharesContextAndSkipsSilence() {
+        let chain = vc_chain_create(Int32(sampleRate))!
+        defer { vc_chain_destroy(chain) }
+        let context = vc_chain_analysis_context(chain)!
+
+        var output = [Float](repeating: 0, count: 256)
+        let silence = [Float](repeating: 0, count: 256)
+        for _ in 0..<50 {
+            vc_chain_process(chain, silence, &output, 256)
+        }
+        XCTAssertEqual(vc_analysis_fft_count(context), 0)
+
+        // 発話中は VAD の平坦度のために最新フレームだけ（ブロックあたり 1 回）
+        var n = 0
+        for _ in 0..<50 {
+            let block: [Float] = (0..<256).map { _ in
+                let phase = 2 * Float.pi * 150 * Float(n) / Float(sampleRate)
+                n += 1
+                return 0.2 * (1...6).reduce(0) { $0 + sin(phase * Float($1)) / Float($1) }
+            }
+            vc_chain_process(chain, block, &output, 256)
+        }
+        XCTAssertEqual(vc_analysis_fft_count(context), 50)
+        var state = VCVadState()
+        vc_chain_get_vad_state(chain, &state)
+        XCTAssertEqual(state.speech, 1)
+    }
+}
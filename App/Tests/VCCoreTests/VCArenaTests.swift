@@ -0,0 +1,152 @@
+import XCTest
+import VCCore
+
+final class VCArenaTests: XCTestCase {
+
+    private let sampleRate = 48000
+
+    /// body の間に VCCore が確保した回数を数え、0 でなければ失敗させる
+    private func assertNoAllocations(_ label: String, file: StaticString = #filePath, line: UInt = #line,
+                                     _ body: () -> Void) {
+        let before = vc_realtime_alloc_count()
+        vc_realtime_enter()
+        body()
+        vc_realtime_exit()
+        XCTAssertEqual(vc_realtime_alloc_count() - before, 0, "\(label) allocated during process",
+                       file: file, line: line)
+    }
+
+    // MARK: - Arena
+
+    func testArenaAlignsAndRefusesOverflow() {
+        let arena = vc_arena_create(1000)!
+        defer { vc_arena_destroy(arena) }
+
+        let first = vc_arena_floats(arena, 3)!
+        let second = vc_arena_floats(arena, 100)!
+        XCTAssertEqual(Int(bitPattern: first) % 64, 0)
+        XCTAssertEqual(Int(bitPattern: second) - Int(bitPattern: first), 64)
+        XCTAssertEqual(vc_arena_used(arena), 64 + 448)
+
+        // 容量（64 の倍数に切り上げて 1024）を超える分は NULL
+        XCTAssertNil(vc_arena_alloc(arena, 1024 - 512 + 1))
+        XCTAssertNotNil(vc_arena_alloc(arena, 1024 - 512))
+
+        vc_arena_reset(arena)
+        XCTAssertEqual(vc_arena_used(arena), 0)
+    }
+
+    func testPlanCacheReturnsSameTables() {
+        let cache = vc_plan_cache_create()!
+        defer { vc_plan_cache_destroy(cache) }
+        XCTAssertEqual(vc_plan_cache_prepare(cache, 512), 0)
+
+        let allocations = vc_alloc_count()
+        for size: Int32 in [128, 256, 512, 1024] {
+            let plan = vc_plan_cache_fft(cache, size)
+            XCTAssertNotNil(plan)
+            XCTAssertEqual(vc_fft_plan_size(plan), size)
+            XCTAssertEqual(vc_plan_cache_fft(cache, size), plan)
+            XCTAssertEqual(vc_plan_cache_window(cache, VC_WINDOW_HANN, size),
+                           vc_plan_cache_window(cache, VC_WINDOW_HANN, size))
+        }
+        XCTAssertEqual(vc_alloc_count(), allocations)
+        XCTAssertNil(vc_plan_cache_fft(cache, 384))
+
+        // √Hann の二乗は Hann
+        let hann = vc_plan_cache_window(cache, VC_WINDOW_HANN, 256)!
+        let root = vc_plan_cache_window(cache, VC_WINDOW_SQRT_HANN, 256)!
+        for i in stride(from: 0, to: 256, by: 17) {
+            XCTAssertEqual(root[i] * root[i], hann[i], accuracy: 1e-6)
+        }
+    }
+
+    // MARK: - Allocation Harness
+
+    func testHarnessDetectsAllocation() {
+        let before = vc_realtime_alloc_count()
+        vc_realtime_enter()
+        vc_meter_destroy(vc_meter_create(Int32(sampleRate)))
+        vc_realtime_exit()
+        XCTAssertEqual(vc_realtime_alloc_count() - before, 1)
+
+        // 区間外の確保は数えない
+        vc_meter_destroy(vc_meter_create(Int32(sampleRate)))
+        XCTAssertEqual(vc_realtime_alloc_count() - before, 1)
+    }
+
+    func testHeapHarnessCountsAllocationsOutsideVCCore() throws {
+        try XCTSkipIf(vc_realtime_track_heap(1) == 0, "この環境ではプロセスのヒープ確保を数えられない")
+        defer { vc_realtime_track_heap(0) }
+
+        let before = vc_realtime_heap_alloc_count()
+        vc_realtime_enter()
+        let buffer = UnsafeMutablePointer<Float>.allocate(capacity: 256)
+        buffer.deallocate()
+        vc_realtime_exit()
+        XCTAssertGreaterThanOrEqual(vc_realtime_heap_alloc_count() - before, 1)
+
+        // 区間外の確保は数えない
+        let counted = vc_realtime_heap_alloc_count()
+        UnsafeMutablePointer<Float>.allocate(capacity: 256).deallocate()
+        XCTAssertEqual(vc_realtime_heap_alloc_count(), counted)
+    }
+
+    func testNoStageAllocatesDuringProcess() {
+        let cache = vc_plan_cache_create()!
+        defer { vc_plan_cache_destroy(cache) }
+        XCTAssertEqual(vc_plan_cache_prepare(cache, 512), 0)
+
+        let chain = vc_chain_create(Int32(sampleRate))!
+        defer { vc_chain_destroy(chain) }
+        XCTAssertEqual(vc_chain_prepare(chain, cache), 0)
+        let references = (0..<Int(VC_CHAIN_MAX_ECHO_REFERENCES)).map { _ in vc_monitor_create(384, 4800)! }
+        defer { references.forEach { vc_monitor_destroy($0) } }
+        for (slot, reference) in references.enumerated() {
+            XCTAssertEqual(vc_chain_set_echo_reference(chain, Int32(slot), reference), 0)
+        }
+
+        let meter = vc_meter_create(Int32(sampleRate))!
+        defer { vc_meter_destroy(meter) }
+        let batch = vc_chain_batch_create(4, Int32(sampleRate))!
+        defer { vc_chain_batch_destroy(batch) }
+
+        // 発話 0.5 秒 + 無音 0.5 秒（VAD の切り替え・ピッチ探索・エコーキャンセルを通す）
+        let signal: [Float] = (0..<sampleRate).map { i in
+            guard i < sampleRate / 2 else { return 0 }
+            let phase = 2 * Float.pi * 160 * Float(i) / Float(sampleRate)
+            return 0.2 * (1...6).reduce(0) { $0 + sin(phase * Float($1)) / Float($1) }
+        }
+        var output = [Float](repeating: 0, count: 512)
+        var lanes = [Float](repeating: 0, count: 4 * 512)
+        var reading = VCMeterReading()
+
+        for blockSize in [128, 256, 512] {
+            assertNoAllocations("block \(blockSize)") {
+                signal.withUnsafeBufferPointer { input in
+                    for offset in stride(from: 0, to: input.count - blockSize + 1, by: blockSize) {
+                        let block = input.baseAddress! + offset
+                        references.forEach { _ = vc_monitor_push($0, block, Int32(blockSize)) }
+                        vc_chain_process(chain, block, &output, Int32(blockSize))
+
+                        // 後段が共有スペクトルを一通り要求する
+                        let context = vc_chain_analysis_context(chain)
+                        let frames = vc_analysis_frame_count(context)
+                        for frame in 0..<frames {
+                            _ = vc_analysis_magnitude(context, frame)
+                            _ = vc_analysis_log_spectrum(context, frame)
+                        }
+                        _ = vc_analysis_lpc(context, nil)
+
+                        vc_meter_process(meter, output, Int32(blockSize))
+                        lanes.withUnsafeMutableBufferPointer { buffer in
+                            vc_chain_batch_process(batch, buffer.baseAddress, buffer.baseAddress, Int32(blockSize))
+                        }
+                    }
+                }
+                _ = vc_meter_read(meter, &reading)
+                vc_chain_reset(chain)
+            }
+        }
+    }
+}
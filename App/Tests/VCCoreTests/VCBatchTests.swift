@@ -0,0 +1,144 @@
+import XCTest
+import VCCore
+
+final class VCBatchTests: XCTestCase {
+
+    private let frames = 256
+
+    private func params(forLane lane: Int) -> VCChainParams {
+        var params = VCChainParams()
+        vc_chain_params_default(&params)
+        params.eqLow = Float(lane % 5) - 2
+        params.eqHigh = Float(lane % 3)
+        params.noiseSuppressionEnabled = Int32(lane % 2)
+        params.agcEnabled = lane % 3 == 0 ? 0 : 1
+        return params
+    }
+
+    private func signal(lane: Int, block: Int) -> [Float] {
+        (0..<frames).map { i in
+            let t = Float(block * frames + i)
+            let level: Float = block % 7 == 0 ? 1.5 : 0.2
+            return level * sin(t * 2 * .pi * Float(110 + 30 * lane) / 48000)
+        }
+    }
+
+    /// 発話のあとに弱い雑音と完全な無音が続く信号（VAD が非発話へ移り、activity が 0 まで下がる）
+    private func speechThenSilence(lane: Int, block: Int) -> [Float] {
+        var seed = UInt32(truncatingIfNeeded: lane * 7919 + block * 104729 + 1)
+        return (0..<frames).map { i in
+            seed = seed &* 1664525 &+ 1013904223
+            let noise = (Float(seed >> 8) / 16777216 - 0.5) * 0.002
+            let t = Float(block * frames + i)
+            switch (block / 20) % 3 {
+            case 0: return 0.3 * sin(t * 2 * .pi * Float(110 + 30 * lane) / 48000) + noise
+            case 1: return noise
+            default: return 0
+            }
+        }
+    }
+
+    /// lanes 本のスカラーチェーンと同じパラメータのバッチに同じ信号を通し、最大の差を返す
+    private func maxDifferenceFromScalarChains(lanes: Int, blocks: Int,
+                                               params: (Int) -> VCChainParams,
+                                               signal: (Int, Int) -> [Float]) -> Float {
+        let batch = vc_chain_batch_create(Int32(lanes), 48000)!
+        defer { vc_chain_batch_destroy(batch) }
+
+        var chains: [OpaquePointer] = []
+        for lane in 0..<lanes {
+            var laneParams = params(lane)
+            let chain = vc_chain_create(48000)!
+            vc_chain_set_params(chain, &laneParams)
+            vc_chain_batch_set_lane_params(batch, Int32(lane), &laneParams)
+            chains.append(chain)
+        }
+        defer { chains.forEach { vc_chain_destroy($0) } }
+
+        var maxDifference: Float = 0
+        for block in 0..<blocks {
+            let inputs = (0..<lanes).map { signal($0, block) }
+
+            var packed = [Float](repeating: 0, count: frames * lanes)
+            for lane in 0..<lanes {
+                for frame in 0..<frames {
+                    packed[frame * lanes + lane] = inputs[lane][frame]
+                }
+            }
+            packed.withUnsafeMutableBufferPointer { buffer in
+                vc_chain_batch_process(batch, buffer.baseAddress, buffer.baseAddress, Int32(frames))
+            }
+
+            for lane in 0..<lanes {
+                var expected = [Float](repeating: 0, count: frames)
+                vc_chain_process(chains[lane], inputs[lane], &expected, Int32(frames))
+                for frame in 0..<frames {
+                    maxDifference = max(maxDifference, abs(expected[frame] - packed[frame * lanes + lane]))
+                }
+            }
+        }
+        return maxDifference
+    }
+
+    // MARK: - Chain Batch Tests
+
+    /// 各レーンの出力が同じパラメータのスカラーチェーンと一致する
+    func testBatchMatchesScalarChain() {
+        for lanes in [4, 8, 16] {
+            let maxDifference = maxDifferenceFromScalarChains(lanes: lanes, blocks: 50,
+                                                              params: params(forLane:), signal: signal(lane:block:))
+            XCTAssertLessThan(maxDifference, 1e-5, "lanes=\(lanes)")
+        }
+    }
+
+    /// 非発話区間の NS（一定ゲインへのクロスフェード）と AGC の据え置きもレーンごとに一致する
+    func testBatchMatchesScalarChainThroughVoiceActivityChanges() {
+        let params: (Int) -> VCChainParams = { lane in
+            var laneParams = self.params(forLane: lane)
+            laneParams.vadEnabled = lane % 4 == 3 ? 0 : 1
+            return laneParams
+        }
+        for lanes in [4, 8, 16] {
+            let maxDifference = maxDifferenceFromScalarChains(lanes: lanes, blocks: 120,
+                                                              params: params, signal: speechThenSilence(lane:block:))
+            XCTAssertLessThan(maxDifference, 1e-5, "lanes=\(lanes)")
+        }
+    }
+
+    func testCreateRejectsInvalidLaneCount() {
+        XCTAssertNil(vc_chain_batch_create(6, 48000))
+        XCTAssertNil(vc_chain_batch_create(32, 48000))
+    }
+
+    // MARK: - Pack / Unpack Tests
+
+    func testPackUnpackRoundTrip() {
+        let lanes = 4
+        let inputs: [[Float]] = (0..<lanes).map { lane in (0..<frames).map { Float(lane * 1000 + $0) } }
+        var outputs = [[Float]](repeating: [Float](repeating: 0, count: frames), count: lanes)
+        var packed = [Float](repeating: 0, count: frames * lanes)
+
+        let inputPointers = inputs.map { input -> UnsafeMutablePointer<Float> in
+            let pointer = UnsafeMutablePointer<Float>.allocate(capacity: frames)
+            pointer.initialize(from: input, count: frames)
+            return pointer
+        }
+        let outputPointers = (0..<lanes).map { _ in UnsafeMutablePointer<Float>.allocate(capacity: frames) }
+        defer {
+            inputPointers.forEach { $0.deallocate() }
+            outputPointers.forEach { $0.deallocate() }
+        }
+
+        var constInputs: [UnsafePointer<Float>?] = inputPointers.map { UnsafePointer($0) }
+        var mutableOutputs: [UnsafeMutablePointer<Float>?] = outputPointers
+        vc_batch_pack(&constInputs, &packed, Int32(lanes), Int32(frames))
+        vc_batch_unpack(packed, &mutableOutputs, Int32(lanes), Int32(frames))
+
+        XCTAssertEqual(packed[1], inputs[1][0])
+        XCTAssertEqual(packed[lanes + 2], inputs[2][1])
+        for lane in 0..<lanes {
+            outputs[lane] = Array(UnsafeBufferPointer(start: outputPointers[lane], count: frames))
+        }
+        XCTAssertEqual(outputs, inputs)
+    }
+}
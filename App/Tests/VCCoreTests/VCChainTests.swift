@@ -0,0 +1,74 @@
+import XCTest
+import VCCore
+
+final class VCChainTests: XCTestCase {
+
+    // MARK: - Biquad Tests
+
+    func testHighPassRemovesDC() {
+        var coeffs = VCBiquadCoeffs()
+        var state = VCBiquadState()
+        vc_biquad_set_highpass(&coeffs, 80, 0.707, 48000)
+
+        var samples = [Float](repeating: 0.5, count: 48000)
+        samples.withUnsafeMutableBufferPointer { buffer in
+            vc_biquad_process(&coeffs, &state, buffer.baseAddress, buffer.baseAddress, Int32(buffer.count))
+        }
+
+        // 1秒後にはDC成分がほぼ消えている
+        XCTAssertEqual(samples.last!, 0, accuracy: 1e-3)
+    }
+
+    func testIdentityBiquadIsPassthrough() {
+        var coeffs = VCBiquadCoeffs()
+        var state = VCBiquadState()
+        vc_biquad_set_identity(&coeffs)
+
+        let input: [Float] = (0..<64).map { Float($0) / 64 }
+        var output = [Float](repeating: 0, count: input.count)
+        vc_biquad_process(&coeffs, &state, input, &output, Int32(input.count))
+
+        XCTAssertEqual(output, input)
+    }
+
+    // MARK: - Chain Tests
+
+    func testChainSilenceStaysSilent() {
+        let chain = vc_chain_create(48000)!
+        defer { vc_chain_destroy(chain) }
+
+        var samples = [Float](repeating: 0, count: 256)
+        samples.withUnsafeMutableBufferPointer { buffer in
+            vc_chain_process(chain, buffer.baseAddress, buffer.baseAddress, Int32(buffer.count))
+        }
+
+        XCTAssertTrue(samples.allSatisfy { $0 == 0 })
+    }
+
+    func testChainOutputIsLimited() {
+        let chain = vc_chain_create(48000)!
+        defer { vc_chain_destroy(chain) }
+
+        let input: [Float] = (0..<4800).map { 2.0 * sin(Float($0) * 2 * .pi * 440 / 48000) }
+        var output = [Float](repeating: 0, count: input.count)
+        vc_chain_process(chain, input, &output, Int32(input.count))
+
+        XCTAssertLessThanOrEqual(output.map(abs).max()!, 0.9)
+    }
+
+    func testChainParamsRoundTrip() {
+        let chain = vc_chain_create(48000)!
+        defer { vc_chain_destroy(chain) }
+
+        var params = VCChainParams()
+        vc_chain_params_default(&params)
+        params.eqLow = 3
+        params.agcEnabled = 0
+        vc_chain_set_params(chain, &params)
+
+        var result = VCChainParams()
+        vc_chain_get_params(chain, &result)
+        XCTAssertEqual(result.eqLow, 3)
+        XCTAssertEqual(result.agcEnabled, 0)
+    }
+}
@@ -0,0 +1,210 @@
+import XCTest
+import VCCore
+
+final class VCConvolverTests: XCTestCase {
+
+    private func random(count: Int, seed: inout UInt32) -> [Float] {
+        (0..<count).map { _ in
+            seed = seed &* 1664525 &+ 1013904223
+            return Float(seed >> 8) / 16777216 - 0.5
+        }
+    }
+
+    /// 減衰する乱数 IR（全段にまたがる長さ）
+    private func impulseResponse(count: Int, seed: inout UInt32) -> [Float] {
+        random(count: count, seed: &seed).enumerated().map { $0.element * exp(-Float($0.offset) / 8000) }
+    }
+
+    private func process(_ convolver: OpaquePointer, _ input: [Float], blockSize: Int,
+                         pauseMicroseconds: UInt32 = 0) -> [Float] {
+        var output = [Float](repeating: 0, count: input.count)
+        input.withUnsafeBufferPointer { source in
+            output.withUnsafeMutableBufferPointer { destination in
+                for offset in stride(from: 0, to: input.count, by: blockSize) {
+                    XCTAssertEqual(vc_convolver_process(convolver, source.baseAddress! + offset,
+                                                        destination.baseAddress! + offset, Int32(blockSize)), 0)
+                    if pauseMicroseconds > 0 {
+                        usleep(pauseMicroseconds)
+                    }
+                }
+            }
+        }
+        return output
+    }
+
+    /// 直接計算した畳み込みとの最大誤差（step おきに検査）
+    private func maxError(_ output: [Float], input: [Float], ir: [Float], step: Int = 7) -> Double {
+        var worst = 0.0
+        for n in stride(from: 0, to: output.count, by: step) {
+            var sum = 0.0
+            for k in 0...min(n, ir.count - 1) {
+                sum += Double(ir[k]) * Double(input[n - k])
+            }
+            worst = max(worst, abs(sum - Double(output[n])))
+        }
+        return worst
+    }
+
+    // MARK: - Convolution
+
+    func testMatchesDirectConvolutionAcrossStages() {
+        var seed: UInt32 = 1
+        let ir = impulseResponse(count: 20000, seed: &seed)
+        let input = random(count: 128 * 320, seed: &seed)
+
+        for blockSize in [128, 512] {
+            let convolver = vc_convolver_create(ir, Int32(ir.count), 0)!
+            defer { vc_convolver_destroy(convolver) }
+
+            let output = process(convolver, input, blockSize: blockSize)
+            XCTAssertLessThan(maxError(output, input: input, ir: ir), 1e-4)
+
+            var stats = VCConvolverStats()
+            vc_convolver_get_stats(convolver, &stats)
+            XCTAssertEqual(stats.stages, 3)
+            XCTAssertGreaterThan(stats.tailBlocks, 0)
+            XCTAssertEqual(stats.lateBlocks, 0)
+        }
+    }
+
+    func testImpulseComesOutWithoutLatency() {
+        let ir: [Float] = (0..<300).map { Float($0 + 1) / 300 }
+        let convolver = vc_convolver_create(ir, Int32(ir.count), 0)!
+        defer { vc_convolver_destroy(convolver) }
+
+        var impulse = [Float](repeating: 0, count: 384)
+        impulse[0] = 1
+        let output = process(convolver, impulse, blockSize: 128)
+        for i in 0..<ir.count {
+            XCTAssertEqual(output[i], ir[i], accuracy: 1e-5)
+        }
+
+        let odd = [Float](repeating: 0, count: 100)
+        var oddOutput = [Float](repeating: 0, count: 100)
+        XCTAssertEqual(vc_convolver_process(convolver, odd, &oddOutput, 100), -1)
+    }
+
+    func testBackgroundStagesKeepUpInRealTime() {
+        var seed: UInt32 = 2
+        let ir = impulseResponse(count: 40000, seed: &seed)
+        let input = random(count: 128 * 400, seed: &seed)
+        let convolver = vc_convolver_create(ir, Int32(ir.count), 1)!
+        defer { vc_convolver_destroy(convolver) }
+
+        // 128 サンプル（2.7ms）ごとにほぼ実時間ぶん待ち、背景スレッドに時間を与える
+        let output = process(convolver, input, blockSize: 128, pauseMicroseconds: 2000)
+        var stats = VCConvolverStats()
+        vc_convolver_get_stats(convolver, &stats)
+        XCTAssertEqual(stats.lateBlocks, 0)
+        XCTAssertLessThan(maxError(output, input: input, ir: ir, step: 31), 1e-4)
+
+        // リセット後は履歴が残らない
+        vc_convolver_reset(convolver)
+        let silence = process(convolver, [Float](repeating: 0, count: 128 * 200), blockSize: 128, pauseMicroseconds: 2000)
+        XCTAssertTrue(silence.allSatisfy { $0 == 0 })
+    }
+
+    // MARK: - Impulse Responses
+
+    private func writeWav(_ url: URL, samples: [Float], pcm16: Bool) throws {
+        var data = Data()
+        func append<T: FixedWidthInteger>(_ value: T) {
+            withUnsafeBytes(of: value.littleEndian) { data.append(contentsOf: $0) }
+        }
+        let bytesPerSample = pcm16 ? 2 : 4
+        data.append(contentsOf: Array("RIFF".utf8))
+        append(UInt32(36 + samples.count * bytesPerSample))
+        data.append(contentsOf: Array("WAVEfmt ".utf8))
+        append(UInt32(16))
+        append(UInt16(pcm16 ? 1 : 3))
+        append(UInt16(1))
+        append(UInt32(48000))
+        append(UInt32(48000 * bytesPerSample))
+        append(UInt16(bytesPerSample))
+        append(UInt16(bytesPerSample * 8))
+        data.append(contentsOf: Array("data".utf8))
+        append(UInt32(samples.count * bytesPerSample))
+        for sample in samples {
+            if pcm16 {
+                append(Int16(sample * 32767))
+            } else {
+                append(sample.bitPattern)
+            }
+        }
+        try data.write(to: url)
+    }
+
+    func testLoadsWavByMappingFloatData() throws {
+        let samples: [Float] = (0..<1000).map { Float($0) / 1000 }
+        let directory = FileManager.default.temporaryDirectory
+        let floatURL = directory.appendingPathComponent("vc-ir-float-\(UUID().uuidString).wav")
+        let pcmURL = directory.appendingPathComponent("vc-ir-pcm-\(UUID().uuidString).wav")
+        try writeWav(floatURL, samples: samples, pcm16: false)
+        try writeWav(pcmURL, samples: samples, pcm16: true)
+        defer {
+            try? FileManager.default.removeItem(at: floatURL)
+            try? FileManager.default.removeItem(at: pcmURL)
+        }
+
+        // float モノラルはマップした領域を直接指す
+        var ir = VCImpulseResponse()
+        XCTAssertEqual(vc_ir_load(floatURL.path, &ir), 0)
+        XCTAssertEqual(ir.length, 1000)
+        XCTAssertEqual(ir.sampleRate, 48000)
+        XCTAssertNil(ir.converted)
+        XCTAssertEqual(ir.samples[500], 0.5)
+        vc_ir_release(&ir)
+
+        XCTAssertEqual(vc_ir_load(pcmURL.path, &ir), 0)
+        XCTAssertNotNil(ir.converted)
+        XCTAssertEqual(ir.samples[500], 0.5, accuracy: 1e-4)
+        vc_ir_release(&ir)
+
+        XCTAssertEqual(vc_ir_load("/nonexistent/ir.wav", &ir), -1)
+    }
+
+    func testBuiltinImpulseResponsesAreNormalized() {
+        for name in ["phone", "radio", "hall"] {
+            let index = vc_ir_builtin_named(name)
+            XCTAssertGreaterThanOrEqual(index, 0)
+            let kind = VCBuiltinImpulseResponse(rawValue: UInt32(index))
+            let length = Int(vc_ir_builtin_length(kind, 48000))
+            var samples = [Float](repeating: 0, count: length)
+            XCTAssertEqual(vc_ir_builtin_render(kind, 48000, &samples, Int32(length)), Int32(length))
+            let energy = samples.reduce(0) { $0 + $1 * $1 }
+            XCTAssertEqual(energy, 1, accuracy: 1e-3)
+        }
+        XCTAssertEqual(vc_ir_builtin_named("cathedral"), -1)
+    }
+
+    func testChainMixesConvolutionBeforeLimiter() {
+        let chain = vc_chain_create(48000)!
+        defer { vc_chain_destroy(chain) }
+        var params = VCChainParams()
+        vc_chain_params_default(&params)
+        params.noiseSuppressionEnabled = 0
+        params.agcEnabled = 0
+        params.vadEnabled = 0
+        vc_chain_set_params(chain, &params)
+
+        // IR = 0.5 倍の単位インパルス → mix 1 なら振幅が半分になる
+        let ir: [Float] = [0.5]
+        let convolver = vc_convolver_create(ir, 1, 0)!
+        defer { vc_convolver_destroy(convolver) }
+
+        let input: [Float] = (0..<1024).map { 0.2 * sin(Float($0) * 2 * .pi * 1000 / 48000) }
+        var dry = [Float](repeating: 0, count: input.count)
+        vc_chain_process(chain, input, &dry, Int32(input.count))
+
+        vc_chain_reset(chain)
+        vc_chain_set_convolver(chain, convolver)
+        params.convolutionMix = 1
+        vc_chain_set_params(chain, &params)
+        var wet = [Float](repeating: 0, count: input.count)
+        vc_chain_process(chain, input, &wet, Int32(input.count))
+
+        for i in 0..<input.count {
+            XCTAssertEqual(wet[i], 0.5 * dry[i], accuracy: 1e-5)
+        }
+    }
+}
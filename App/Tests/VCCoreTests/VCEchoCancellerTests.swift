@@ -0,0 +1,121 @@
+import XCTest
+import VCCore
+
+final class VCEchoCancellerTests: XCTestCase {
+
+    private func noise(count: Int, amplitude: Float, seed: UInt32) -> [Float] {
+        var state = seed
+        return (0..<count).map { _ in
+            state = state &* 1664525 &+ 1013904223
+            return (Float(state >> 8) / 16777216 - 0.5) * 2 * amplitude
+        }
+    }
+
+    // MARK: - FFT
+
+    func testForwardMatchesNaiveDft() {
+        let size = 64
+        let plan = vc_fft_plan_create(Int32(size))!
+        defer { vc_fft_plan_destroy(plan) }
+
+        let input = noise(count: size, amplitude: 1, seed: 1)
+        var re = [Float](repeating: 0, count: size / 2 + 1)
+        var im = [Float](repeating: 0, count: size / 2 + 1)
+        vc_fft_forward(plan, input, &re, &im)
+
+        for k in 0...(size / 2) {
+            var expectedRe = 0.0
+            var expectedIm = 0.0
+            for n in 0..<size {
+                let angle = -2 * Double.pi * Double(k * n) / Double(size)
+                expectedRe += Double(input[n]) * cos(angle)
+                expectedIm += Double(input[n]) * sin(angle)
+            }
+            XCTAssertEqual(Double(re[k]), expectedRe, accuracy: 1e-4)
+            XCTAssertEqual(Double(im[k]), expectedIm, accuracy: 1e-4)
+        }
+    }
+
+    func testInverseRoundTrip() {
+        XCTAssertNil(vc_fft_plan_create(100))
+        XCTAssertNil(vc_fft_plan_create(8))
+
+        let size = 1024
+        let plan = vc_fft_plan_create(Int32(size))!
+        defer { vc_fft_plan_destroy(plan) }
+
+        let input = noise(count: size, amplitude: 1, seed: 2)
+        var re = [Float](repeating: 0, count: size / 2 + 1)
+        var im = [Float](repeating: 0, count: size / 2 + 1)
+        var output = [Float](repeating: 0, count: size)
+        vc_fft_forward(plan, input, &re, &im)
+        vc_fft_inverse(plan, re, im, &output)
+
+        for n in 0..<size {
+            XCTAssertEqual(output[n], input[n], accuracy: 1e-5)
+        }
+    }
+
+    // MARK: - Echo Canceller
+
+    func testCreateValidatesBlockSize() {
+        XCTAssertNil(vc_aec_create(100, 4800))
+        XCTAssertNil(vc_aec_create(2048, 4800))
+        XCTAssertNil(vc_aec_create(128, 0))
+
+        let aec = vc_aec_create(128, 4800)!
+        XCTAssertEqual(vc_aec_block_size(aec), 128)
+        vc_aec_destroy(aec)
+    }
+
+    /// 遅延 + 減衰する経路のエコーを 20dB 以上抑圧する
+    func testCancelsSyntheticEcho() {
+        let blockSize = 128
+        let total = 48000 * 4
+        let far = noise(count: total, amplitude: 0.3, seed: 3)
+
+        // 30 サンプル遅延、時定数 40 サンプルで減衰する 400 タップの経路
+        var response = noise(count: 400, amplitude: 1, seed: 4)
+        for i in response.indices {
+            response[i] = i < 30 ? 0 : response[i] * 0.1 * expf(-Float(i - 30) / 40)
+        }
+        var near = [Float](repeating: 0, count: total)
+        for n in 0..<total {
+            var sum: Float = 0
+            for k in 0..<min(response.count, n + 1) {
+                sum += response[k] * far[n - k]
+            }
+            near[n] = sum
+        }
+
+        let aec = vc_aec_create(Int32(blockSize), 1024)!
+        defer { vc_aec_destroy(aec) }
+
+        var output = [Float](repeating: 0, count: total)
+        for offset in stride(from: 0, to: total, by: blockSize) {
+            far.withUnsafeBufferPointer { farBuffer in
+                near.withUnsafeBufferPointer { nearBuffer in
+                    output.withUnsafeMutableBufferPointer { outBuffer in
+                        vc_aec_process(aec, farBuffer.baseAddress! + offset,
+                                       nearBuffer.baseAddress! + offset, outBuffer.baseAddress! + offset)
+                    }
+                }
+            }
+        }
+
+        // 最後の1秒
+        var echoEnergy: Float = 0
+        var residualEnergy: Float = 0
+        for n in (total - 48000)..<total {
+            echoEnergy += near[n] * near[n]
+            residualEnergy += output[n] * output[n]
+        }
+        let erle = 10 * log10f(echoEnergy / residualEnergy)
+        XCTAssertGreaterThan(erle, 20)
+
+        var stats = VCEchoCancellerStats()
+        vc_aec_get_stats(aec, &stats)
+        XCTAssertEqual(stats.converged, 1)
+        XCTAssertEqual(stats.blocks, UInt64(total / blockSize))
+    }
+}
@@ -0,0 +1,151 @@
+import XCTest
+import VCCore
+
+final class VCFastMathTests: XCTestCase {
+
+    private func sweep(_ lo: Float, _ hi: Float, count: Int = 100_003) -> [Float] {
+        (0..<count).map { lo + (hi - lo) * Float($0) / Float(count - 1) }
+    }
+
+    /// 正の正規化数全体から（仮数も乱数にして、結果が float でちょうど表せる入力に偏らないように）
+    private func positiveFloats(count: Int = 100_000) -> [Float] {
+        var seed: UInt32 = 5
+        return (0..<count).map { _ in
+            seed = seed &* 1664525 &+ 1013904223
+            return Float(bitPattern: 0x0080_0000 + seed % (0x7f00_0000 - 0x0080_0000))
+        }
+    }
+
+    private func block(_ kernel: (UnsafePointer<Float>, UnsafeMutablePointer<Float>, Int32) -> Void,
+                       _ input: [Float]) -> [Float] {
+        var output = [Float](repeating: 0, count: input.count)
+        kernel(input, &output, Int32(input.count))
+        return output
+    }
+
+    // MARK: - Exponential & Logarithm
+
+    func testExpStaysWithinRelativeBound() {
+        let input = sweep(-87, 88)
+        let output = block(vc_fast_exp, input)
+        for (x, y) in zip(input, output) {
+            let expected = exp(Double(x))
+            XCTAssertLessThanOrEqual(abs(Double(vc_fast_expf(x)) - expected) / expected, 1.5e-7, "x=\(x)")
+            XCTAssertLessThanOrEqual(abs(Double(y) - expected) / expected, 1.5e-7, "x=\(x)")
+        }
+        for x in sweep(-126, 127, count: 10_007) {
+            let expected = exp2(Double(x))
+            XCTAssertLessThanOrEqual(abs(Double(vc_fast_exp2f(x)) - expected) / expected, 1.5e-7, "x=\(x)")
+        }
+    }
+
+    func testLogStaysWithinBound() {
+        let input = positiveFloats()
+        let output = block(vc_fast_log, input)
+        for (x, y) in zip(input, output) {
+            let expected = log(Double(x))
+            let bound = 1e-7 + 1.2e-7 * abs(expected)
+            XCTAssertLessThanOrEqual(abs(Double(vc_fast_logf(x)) - expected), bound, "x=\(x)")
+            XCTAssertLessThanOrEqual(abs(Double(y) - expected), bound, "x=\(x)")
+        }
+    }
+
+    func testPowStaysWithinBound() {
+        var seed: UInt32 = 3
+        for _ in 0..<100_000 {
+            seed = seed &* 1664525 &+ 1013904223
+            let x = Float(exp(Double(seed >> 8) / 16_777_216 * 14 - 7))
+            seed = seed &* 1664525 &+ 1013904223
+            let y = Float(Double(seed >> 8) / 16_777_216 * 8 - 4)
+            let expected = pow(Double(x), Double(y))
+            let bound = 2e-7 * (1 + abs(Double(y) * log(Double(x))))
+            XCTAssertLessThanOrEqual(abs(Double(vc_fast_powf(x, y)) - expected) / expected, bound, "\(x)^\(y)")
+        }
+    }
+
+    // MARK: - Decibels
+
+    func testDecibelConversionsStayWithinBounds() {
+        let decibels = sweep(-140, 40)
+        let linear = block(vc_fast_db_to_linear_block, decibels)
+        for (db, y) in zip(decibels, linear) {
+            let expected = pow(10, Double(db) / 20)
+            XCTAssertLessThanOrEqual(abs(Double(vc_fast_db_to_linear(db)) - expected) / expected, 2e-6, "\(db) dB")
+            XCTAssertLessThanOrEqual(abs(Double(y) - expected) / expected, 2e-6, "\(db) dB")
+        }
+
+        let input = positiveFloats()
+        let output = block(vc_fast_linear_to_db_block, input)
+        for (x, y) in zip(input, output) {
+            let expected = 20 * log10(Double(x))
+            let bound = 1e-6 + 2e-7 * abs(expected)
+            XCTAssertLessThanOrEqual(abs(Double(vc_fast_linear_to_db(x)) - expected), bound, "x=\(x)")
+            XCTAssertLessThanOrEqual(abs(Double(y) - expected), bound, "x=\(x)")
+        }
+        XCTAssertEqual(vc_fast_db_to_linear(0), 1)
+    }
+
+    // MARK: - Hyperbolic & Trigonometric
+
+    func testTanhStaysWithinBoundAndSaturates() {
+        let input = sweep(-12, 12)
+        let output = block(vc_fast_tanh, input)
+        for (x, y) in zip(input, output) {
+            let expected = tanh(Double(x))
+            XCTAssertLessThanOrEqual(abs(Double(vc_fast_tanhf(x)) - expected), 1.5e-7, "x=\(x)")
+            XCTAssertLessThanOrEqual(abs(Double(y) - expected), 1.5e-7, "x=\(x)")
+        }
+        XCTAssertEqual(vc_fast_tanhf(0), 0)
+        XCTAssertEqual(vc_fast_tanhf(20), 1)
+        XCTAssertEqual(vc_fast_tanhf(-20), -1)
+    }
+
+    func testSinCosStayWithinBound() {
+        let input = sweep(-8192, 8192, count: 400_009)
+        var sines = [Float](repeating: 0, count: input.count)
+        var cosines = [Float](repeating: 0, count: input.count)
+        vc_fast_sincos(input, &sines, &cosines, Int32(input.count))
+        for i in input.indices {
+            let x = Double(input[i])
+            XCTAssertLessThanOrEqual(abs(Double(sines[i]) - sin(x)), 1.5e-7, "x=\(x)")
+            XCTAssertLessThanOrEqual(abs(Double(cosines[i]) - cos(x)), 1.5e-7, "x=\(x)")
+            XCTAssertLessThanOrEqual(abs(Double(vc_fast_sinf(input[i])) - sin(x)), 1.5e-7, "x=\(x)")
+            XCTAssertLessThanOrEqual(abs(Double(vc_fast_cosf(input[i])) - cos(x)), 1.5e-7, "x=\(x)")
+        }
+    }
+
+    func testAtan2StaysWithinBoundInAllQuadrants() {
+        var seed: UInt32 = 9
+        var ys = [Float](), xs = [Float]()
+        for _ in 0..<100_000 {
+            seed = seed &* 1664525 &+ 1013904223
+            ys.append(Float(seed >> 8) / 16_777_216 * 10 - 5)
+            seed = seed &* 1664525 &+ 1013904223
+            xs.append(Float(seed >> 8) / 16_777_216 * 10 - 5)
+        }
+        var output = [Float](repeating: 0, count: ys.count)
+        vc_fast_atan2(ys, xs, &output, Int32(ys.count))
+        for i in ys.indices {
+            let expected = atan2(Double(ys[i]), Double(xs[i]))
+            XCTAssertLessThanOrEqual(abs(Double(vc_fast_atan2f(ys[i], xs[i])) - expected), 4e-7)
+            XCTAssertLessThanOrEqual(abs(Double(output[i]) - expected), 4e-7)
+        }
+        XCTAssertEqual(vc_fast_atan2f(0, 0), 0)
+        XCTAssertEqual(vc_fast_atan2f(1, 0), .pi / 2, accuracy: 2e-7)
+        XCTAssertEqual(vc_fast_atan2f(0, -1), .pi, accuracy: 4e-7)
+    }
+
+    // MARK: - Non-finite Inputs
+
+    /// libm と違い、NaN・無限大・0 以下でも有限の値を返す（DSP の状態に NaN を持ち込まない）
+    func testNonFiniteInputsGiveFiniteResults() {
+        let input: [Float] = [.nan, .infinity, -.infinity, 0, -1, 1e30, -1e30]
+        for kernel in [vc_fast_exp, vc_fast_log, vc_fast_tanh, vc_fast_db_to_linear_block,
+                       vc_fast_linear_to_db_block] as [(UnsafePointer<Float>, UnsafeMutablePointer<Float>, Int32) -> Void] {
+            XCTAssertTrue(block(kernel, input).allSatisfy(\.isFinite))
+        }
+        XCTAssertTrue(input.map { vc_fast_logf($0) }.allSatisfy(\.isFinite))
+        XCTAssertTrue(input.map { vc_fast_expf($0) }.allSatisfy(\.isFinite))
+        XCTAssertTrue(input.map { vc_fast_tanhf($0) }.allSatisfy(\.isFinite))
+    }
+}
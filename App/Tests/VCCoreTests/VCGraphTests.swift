@@ -0,0 +1,180 @@
+import XCTest
+import VCCore
+
+final class VCGraphTests: XCTestCase {
+
+    private let sampleRate: Int32 = 48000
+    private let blockSize = 256
+
+    private func node(_ kind: VCGraphNodeKind, _ inputs: [Int32] = [], sidechain: Int32 = -1,
+                      gains: [Float] = [], param: Float? = nil) -> VCGraphNodeDesc {
+        var desc = VCGraphNodeDesc()
+        vc_graph_node_init(&desc, kind)
+        desc.inputCount = Int32(inputs.count)
+        desc.sidechain = sidechain
+        withUnsafeMutableBytes(of: &desc.inputs) { raw in
+            for (i, input) in inputs.enumerated() { raw.bindMemory(to: Int32.self)[i] = input }
+        }
+        withUnsafeMutableBytes(of: &desc.gains) { raw in
+            for (i, gain) in gains.enumerated() { raw.bindMemory(to: Float.self)[i] = gain }
+        }
+        if let param {
+            desc.param.0 = param
+        }
+        return desc
+    }
+
+    /// input → hpf → vad → gate → agc → eq → limiter → output（gate / agc は vad に従う）
+    private var linear: [VCGraphNodeDesc] {
+        [
+            node(VC_GRAPH_NODE_INPUT),
+            node(VC_GRAPH_NODE_HPF, [0]),
+            node(VC_GRAPH_NODE_VAD, [1]),
+            node(VC_GRAPH_NODE_GATE, [2], sidechain: 2),
+            node(VC_GRAPH_NODE_AGC, [3], sidechain: 2),
+            node(VC_GRAPH_NODE_EQ, [4]),
+            node(VC_GRAPH_NODE_LIMITER, [5]),
+            node(VC_GRAPH_NODE_OUTPUT, [6]),
+        ]
+    }
+
+    /// agc の後で原音・1 オクターブ下のレイヤー・ハイパスした枝に分かれて mix で合流する。最後の eq は出力に届かない
+    private var layered: [VCGraphNodeDesc] {
+        [
+            node(VC_GRAPH_NODE_INPUT),
+            node(VC_GRAPH_NODE_HPF, [0]),
+            node(VC_GRAPH_NODE_VAD, [1]),
+            node(VC_GRAPH_NODE_GATE, [2], sidechain: 2),
+            node(VC_GRAPH_NODE_AGC, [3], sidechain: 2),
+            node(VC_GRAPH_NODE_PITCH_SHIFT, [4], param: -12),
+            node(VC_GRAPH_NODE_EQ, [5]),
+            node(VC_GRAPH_NODE_HPF, [4], param: 1000),
+            node(VC_GRAPH_NODE_MIX, [4, 6, 7], gains: [0.8, 0.45, 0.3]),
+            node(VC_GRAPH_NODE_LIMITER, [8], param: 2),
+            node(VC_GRAPH_NODE_OUTPUT, [9]),
+            node(VC_GRAPH_NODE_EQ, [0]),
+        ]
+    }
+
+    private func makeGraph(_ nodes: [VCGraphNodeDesc], naive: Bool = false, workers: Int32 = 0) -> OpaquePointer {
+        var descs = nodes
+        var options = VCGraphOptions(naiveBuffers: naive ? 1 : 0, workerCount: workers)
+        var error = VC_GRAPH_OK
+        let graph = vc_graph_create(sampleRate, &descs, Int32(descs.count), &options, &error)
+        XCTAssertEqual(error, VC_GRAPH_OK)
+        return graph!
+    }
+
+    private func render(_ graph: OpaquePointer, seconds: Double = 0.5) -> [Float] {
+        let count = Int(Double(sampleRate) * seconds) / blockSize * blockSize
+        var signal = (0..<count).map { i -> Float in
+            let speech: Float = i % 12000 < 8000 ? 1 : 0
+            return 0.3 * sinf(0.03 * Float(i)) * speech + 0.002 * sinf(1.7 * Float(i))
+        }
+        signal.withUnsafeMutableBufferPointer { buffer in
+            for offset in stride(from: 0, to: count, by: blockSize) {
+                vc_graph_process(graph, buffer.baseAddress! + offset, buffer.baseAddress! + offset, Int32(blockSize))
+            }
+        }
+        return signal
+    }
+
+    // MARK: - Scheduling
+
+    func testScheduleIsTopologicalAndSkipsDeadNodes() {
+        let nodes = layered
+        let graph = makeGraph(nodes)
+        defer { vc_graph_destroy(graph) }
+
+        var schedule = [Int32](repeating: -1, count: nodes.count)
+        let count = Int(vc_graph_schedule(graph, &schedule, Int32(schedule.count)))
+        XCTAssertEqual(count, nodes.count - 1)
+        XCTAssertFalse(schedule.prefix(count).contains(11))
+        XCTAssertEqual(vc_graph_node_buffer(graph, 11), -1)
+
+        for (position, index) in schedule.prefix(count).enumerated() {
+            var desc = nodes[Int(index)]
+            let inputs = withUnsafeBytes(of: &desc.inputs) { Array($0.bindMemory(to: Int32.self).prefix(Int(desc.inputCount))) }
+            for dependency in inputs + (desc.sidechain >= 0 ? [desc.sidechain] : []) {
+                let before = schedule.prefix(position).contains(dependency)
+                XCTAssertTrue(before, "node \(index) runs before \(dependency)")
+            }
+        }
+
+        // ピッチシフト（30ms 窓の半分）+ 2 倍オーバーサンプリング
+        XCTAssertGreaterThan(vc_graph_latency(graph), 720)
+    }
+
+    func testRejectsInvalidGraphs() {
+        func error(_ nodes: [VCGraphNodeDesc]) -> VCGraphError {
+            var descs = nodes
+            var error = VC_GRAPH_OK
+            XCTAssertNil(vc_graph_create(sampleRate, &descs, Int32(descs.count), nil, &error))
+            return error
+        }
+
+        XCTAssertEqual(error([node(VC_GRAPH_NODE_INPUT), node(VC_GRAPH_NODE_MIX, [0, 2]), node(VC_GRAPH_NODE_HPF, [1]),
+                              node(VC_GRAPH_NODE_OUTPUT, [2])]), VC_GRAPH_ERROR_CYCLE)
+        XCTAssertEqual(error([node(VC_GRAPH_NODE_INPUT), node(VC_GRAPH_NODE_OUTPUT, [0]), node(VC_GRAPH_NODE_OUTPUT, [0])]),
+                       VC_GRAPH_ERROR_ENDPOINTS)
+        XCTAssertEqual(error([node(VC_GRAPH_NODE_INPUT), node(VC_GRAPH_NODE_AGC, [0], sidechain: 0),
+                              node(VC_GRAPH_NODE_OUTPUT, [1])]), VC_GRAPH_ERROR_INVALID)
+        XCTAssertEqual(error([node(VC_GRAPH_NODE_INPUT), node(VC_GRAPH_NODE_HPF, [0, 0]), node(VC_GRAPH_NODE_OUTPUT, [1])]),
+                       VC_GRAPH_ERROR_INVALID)
+        XCTAssertEqual(error([node(VC_GRAPH_NODE_INPUT), node(VC_GRAPH_NODE_OUTPUT, [5])]), VC_GRAPH_ERROR_INVALID)
+    }
+
+    // MARK: - Buffers
+
+    func testBuffersFollowLiveness() {
+        var info = VCGraphInfo()
+
+        // 直列なら全ノードが 1 本のバッファに上書きしていく
+        let chain = makeGraph(linear)
+        vc_graph_get_info(chain, &info)
+        vc_graph_destroy(chain)
+        XCTAssertEqual(info.nodeCount, 8)
+        XCTAssertEqual(info.bufferCount, 1)
+
+        // 合流までは 3 本の枝が同時に生きている
+        let graph = makeGraph(layered)
+        vc_graph_get_info(graph, &info)
+        vc_graph_destroy(graph)
+        XCTAssertEqual(info.bufferCount, 3)
+        XCTAssertEqual(info.bufferBytes, 3 * Int(VC_MAX_FRAME_SIZE) * MemoryLayout<Float>.size)
+        XCTAssertEqual(info.maxParallel, 2)
+
+        let naive = makeGraph(layered, naive: true)
+        vc_graph_get_info(naive, &info)
+        vc_graph_destroy(naive)
+        XCTAssertEqual(info.bufferCount, 11)
+    }
+
+    func testReuseAndParallelMatchNaiveBuffers() {
+        let naive = makeGraph(layered, naive: true)
+        let reused = makeGraph(layered)
+        let parallel = makeGraph(layered, workers: 2)
+        defer {
+            vc_graph_destroy(naive)
+            vc_graph_destroy(reused)
+            vc_graph_destroy(parallel)
+        }
+
+        let expected = render(naive)
+        XCTAssertGreaterThan(expected.map(abs).max() ?? 0, 0.1)
+        XCTAssertEqual(render(reused), expected)
+        XCTAssertEqual(render(parallel), expected)
+    }
+
+    func testMixReadsTheSameInputTwice() {
+        // 1 つ目と同じ入力を重ねて読む MIX は上書きしない
+        let graph = makeGraph([node(VC_GRAPH_NODE_INPUT), node(VC_GRAPH_NODE_MIX, [0, 0], gains: [0.5, 0.25]),
+                               node(VC_GRAPH_NODE_OUTPUT, [1])])
+        defer { vc_graph_destroy(graph) }
+
+        let input: [Float] = (0..<blockSize).map { Float($0) / Float(blockSize) }
+        var output = [Float](repeating: 0, count: blockSize)
+        vc_graph_process(graph, input, &output, Int32(blockSize))
+        XCTAssertEqual(output, input.map { 0.75 * $0 })
+    }
+}
@@ -0,0 +1,144 @@
+import XCTest
+import VCCore
+
+final class VCIOReplayTests: XCTestCase {
+
+    private var directory: URL!
+
+    override func setUp() {
+        directory = FileManager.default.temporaryDirectory.appendingPathComponent("vc-iotrace-\(UUID().uuidString)")
+        try? FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(at: directory)
+    }
+
+    /// 10 秒・途中で 50ms 止まるトレース
+    private func synthesize() -> OpaquePointer {
+        var options = VCIOReplaySynthOptions(
+            seconds: 10, ioFrames: 512, appFrames: 256, capacity: 16384,
+            jitterMs: 4, stallAtSeconds: 5, stallMs: 50, seed: 7
+        )
+        return vc_io_replay_synthesize(&options)!
+    }
+
+    private func run(_ trace: OpaquePointer, capacity: Int32 = 0) -> VCIOReplayResult {
+        var options = VCIOReplayOptions(capacity: capacity, period: 0, heartbeatTimeoutMs: 0)
+        var result = VCIOReplayResult()
+        XCTAssertEqual(vc_io_replay_run(trace, &options, &result), 0)
+        return result
+    }
+
+    func testReplaysSynthesizedTraceExactly() {
+        let trace = synthesize()
+        defer { vc_io_replay_free(trace) }
+
+        let result = run(trace)
+        XCTAssertEqual(result.reads, 937)
+        XCTAssertGreaterThan(result.appWrites, 0)
+        XCTAssertEqual(result.zeroTimestamps, result.reads)
+        XCTAssertEqual(result.seconds, 10, accuracy: 0.1)
+
+        // 停止を含めて記録どおりに再現する
+        XCTAssertGreaterThan(result.recordedStalls, 0)
+        XCTAssertEqual(result.replayedStalls, result.recordedStalls)
+        XCTAssertEqual(result.replayedUnderruns, result.recordedUnderruns)
+        XCTAssertEqual(result.statusMismatches, 0)
+        XCTAssertEqual(result.fillMismatches, 0)
+        XCTAssertEqual(result.firstMismatch, -1)
+        XCTAssertEqual(result.timestampMismatches, 0)
+    }
+
+    func testMergesDriverAndAppFilesByHostTime() throws {
+        let trace = synthesize()
+        defer { vc_io_replay_free(trace) }
+
+        // アプリの書き込みとそれ以外を別ファイルにして読み直す（同時刻はアプリが先なので app を先に渡す）
+        let records = UnsafeBufferPointer(start: vc_io_replay_records(trace), count: vc_io_replay_count(trace))
+        let isApp = { (record: VCIOTraceRecord) in record.kind == UInt16(VC_IO_TRACE_APP_WRITE.rawValue) }
+        let appURL = directory.appendingPathComponent("app.vctrace")
+        let driverURL = directory.appendingPathComponent("driver.vctrace")
+        try records.filter(isApp).withUnsafeBytes { try Data($0).write(to: appURL) }
+        try records.filter { !isApp($0) }.withUnsafeBytes { try Data($0).write(to: driverURL) }
+
+        let paths = [appURL.path, driverURL.path].map { strdup($0)! }
+        defer { paths.forEach { free($0) } }
+        let pointers: [UnsafePointer<CChar>?] = paths.map { UnsafePointer($0) }
+        let merged = try XCTUnwrap(vc_io_replay_load(pointers, 2))
+        defer { vc_io_replay_free(merged) }
+
+        XCTAssertEqual(vc_io_replay_count(merged), records.count)
+        let expected = run(trace)
+        let result = run(merged)
+        XCTAssertEqual(result.statusMismatches, 0)
+        XCTAssertEqual(result.fillMismatches, 0)
+        XCTAssertEqual(result.replayedUnderruns, expected.replayedUnderruns)
+        XCTAssertEqual(result.replayedStalls, expected.replayedStalls)
+    }
+
+    func testCapacityOverrideShowsDivergence() {
+        let trace = synthesize()
+        defer { vc_io_replay_free(trace) }
+
+        // 記録の 2 周期分しか入らないリングではアプリの書き込みが溢れ、読み出しが足りなくなる
+        let result = run(trace, capacity: 512)
+        XCTAssertEqual(result.recordedOverflows, 0)
+        XCTAssertGreaterThan(result.replayedOverflows, 0)
+        XCTAssertGreaterThan(result.replayedUnderruns, result.recordedUnderruns)
+        XCTAssertGreaterThan(result.statusMismatches, 0)
+        XCTAssertGreaterThanOrEqual(result.firstMismatch, 0)
+    }
+
+    func testDriverReadStatuses() {
+        let ring = vc_audio_ring_create(1024)!
+        defer { vc_audio_ring_destroy(ring) }
+        let view = vc_audio_ring_view(ring)!
+        var watch = VCSharedRingWatch()
+        vc_shared_ring_watch_init(&watch, view, 0, 100)
+        var peerActive: Int32 = 0
+        var output = [Float](repeating: 1, count: 256)
+
+        // 未接続
+        var result = vc_driver_read_input(nil, &watch, 0, &output, 256, &peerActive)
+        XCTAssertEqual(result.status, VC_DRIVER_READ_DETACHED)
+        XCTAssertEqual(result.events, 0)
+        XCTAssertEqual(output, [Float](repeating: 0, count: 256))
+
+        // 読めたら ACTIVE を 1 回だけ
+        vc_shared_ring_set_active(view, 1)
+        let block = [Float](repeating: 0.5, count: 512)
+        vc_shared_ring_write(view, block, 512)
+        result = vc_driver_read_input(view, &watch, 10, &output, 256, &peerActive)
+        XCTAssertEqual(result.status, VC_DRIVER_READ_OK)
+        XCTAssertEqual(result.events, UInt32(VC_DRIVER_PEER_EVENT_ACTIVE))
+        XCTAssertEqual(result.available, 512)
+        XCTAssertEqual(output, [Float](repeating: 0.5, count: 256))
+        result = vc_driver_read_input(view, &watch, 20, &output, 256, &peerActive)
+        XCTAssertEqual(result.events, 0)
+
+        // 足りない間はアンダーラン、heartbeat が timeout 以上止まると停止
+        result = vc_driver_read_input(view, &watch, 30, &output, 256, &peerActive)
+        XCTAssertEqual(result.status, VC_DRIVER_READ_UNDERRUN)
+        XCTAssertEqual(result.available, 0)
+        result = vc_driver_read_input(view, &watch, 200, &output, 256, &peerActive)
+        XCTAssertEqual(result.status, VC_DRIVER_READ_STALLED)
+        XCTAssertEqual(result.events, UInt32(VC_DRIVER_PEER_EVENT_LOST))
+        XCTAssertEqual(peerActive, 0)
+
+        // 非稼働
+        vc_shared_ring_set_active(view, 0)
+        result = vc_driver_read_input(view, &watch, 210, &output, 256, &peerActive)
+        XCTAssertEqual(result.status, VC_DRIVER_READ_INACTIVE)
+        XCTAssertEqual(result.events, 0)
+    }
+
+    func testZeroTimestampRoundsToPeriod() {
+        var sampleTime = 0.0
+        var hostTime: UInt64 = 0
+        // 1 フレーム = 10 tick、周期 256 フレーム
+        vc_driver_zero_timestamp(1000, 1000 + 10 * 600, 10, 256, &sampleTime, &hostTime)
+        XCTAssertEqual(sampleTime, 512)
+        XCTAssertEqual(hostTime, 1000 + 5120)
+    }
+}
@@ -0,0 +1,199 @@
+import XCTest
+import VCCore
+
+final class VCLatencyTests: XCTestCase {
+
+    func testTimelineExtrapolatesFromNearestMark() {
+        let timeline = vc_latency_timeline_create(3, 10)!
+        defer { vc_latency_timeline_destroy(timeline) }
+        var hostTime: UInt64 = 0
+
+        XCTAssertEqual(vc_latency_timeline_lookup(timeline, 0, &hostTime), 0)
+        vc_latency_timeline_mark(timeline, 100, 5000)
+        vc_latency_timeline_mark(timeline, 200, 7000)
+        XCTAssertEqual(vc_latency_timeline_lookup(timeline, 150, &hostTime), 1)
+        XCTAssertEqual(hostTime, 5500)
+        XCTAssertEqual(vc_latency_timeline_lookup(timeline, 210, &hostTime), 1)
+        XCTAssertEqual(hostTime, 7100)
+        XCTAssertEqual(vc_latency_timeline_lookup(timeline, 50, &hostTime), 0)
+
+        // 容量（4 に切り上げ）を超えた古い mark は引けない
+        vc_latency_timeline_mark(timeline, 300, 8000)
+        vc_latency_timeline_mark(timeline, 400, 9000)
+        vc_latency_timeline_mark(timeline, 500, 10000)
+        XCTAssertEqual(vc_latency_timeline_lookup(timeline, 150, &hostTime), 0)
+        XCTAssertEqual(vc_latency_timeline_lookup(timeline, 350, &hostTime), 1)
+        XCTAssertEqual(hostTime, 8500)
+    }
+
+    func testTimelineAcrossIndexWrap() {
+        let timeline = vc_latency_timeline_create(4, 1)!
+        defer { vc_latency_timeline_destroy(timeline) }
+        var hostTime: UInt64 = 0
+
+        vc_latency_timeline_mark(timeline, 0xFFFF_FF00, 1000)
+        XCTAssertEqual(vc_latency_timeline_lookup(timeline, 0x10, &hostTime), 1)
+        XCTAssertEqual(hostTime, 1000 + 0x110)
+    }
+
+    func testHistogramPercentiles() {
+        // 1 tick = 1µs
+        let probe = vc_latency_probe_create(1000)!
+        defer { vc_latency_probe_destroy(probe) }
+
+        for i in 0..<100 {
+            vc_latency_probe_record(probe, 0, UInt64(10_000 + i * 100))     // 10.0〜19.9ms
+        }
+        vc_latency_probe_record(probe, 0, 300_000)                          // 範囲外
+        vc_latency_probe_record(probe, 10, 5)                               // 時計が逆
+
+        var stats = VCLatencyStats()
+        vc_latency_probe_read(probe, &stats)
+        XCTAssertEqual(stats.count, 101)
+        XCTAssertEqual(stats.overflow, 1)
+        XCTAssertEqual(stats.rejected, 1)
+        XCTAssertEqual(stats.minMs, 10)
+        XCTAssertEqual(stats.maxMs, 300)
+        XCTAssertEqual(stats.p50Ms, 15, accuracy: 0.2)
+        XCTAssertEqual(stats.p95Ms, 19.6, accuracy: 0.2)
+        XCTAssertEqual(vc_latency_stats_fraction_over(&stats, 15), 51.0 / 101.0, accuracy: 1e-9)
+
+        vc_latency_probe_reset(probe)
+        vc_latency_probe_read(probe, &stats)
+        XCTAssertEqual(stats.count, 0)
+        XCTAssertEqual(stats.p50Ms, 0)
+    }
+
+    /// 入力 → 遅延線 → 出力でマーカーの遅れを測る
+    private func measureMarker(delay: Int, enabled: Bool = true) -> (delays: [Double], misses: UInt64) {
+        let marker = vc_latency_marker_create(48000, 500)!
+        defer { vc_latency_marker_destroy(marker) }
+        vc_latency_marker_set_enabled(marker, enabled ? 1 : 0)
+
+        var line = [Float](repeating: 0, count: 8192)
+        var position = 0
+        var block = [Float](repeating: 0, count: 256)
+        var delays: [Double] = []
+        for b in 0..<(48000 * 3 / 256) {
+            for i in 0..<256 {
+                block[i] = 0.03 * sinf(0.05 * Float(b * 256 + i))
+            }
+            vc_latency_marker_inject(marker, &block, 256)
+            for i in 0..<256 {
+                line[(position + delay) % line.count] = block[i]
+                block[i] = line[position % line.count]
+                position += 1
+            }
+            var delayMs = 0.0
+            if vc_latency_marker_detect(marker, block, 256, &delayMs) != 0 {
+                delays.append(delayMs)
+            }
+        }
+        return (delays, vc_latency_marker_misses(marker))
+    }
+
+    func testMarkerMeasuresDelayLine() {
+        for delay in [0, 37, 480, 2400] {
+            let result = measureMarker(delay: delay)
+            XCTAssertGreaterThanOrEqual(result.delays.count, 4)
+            XCTAssertEqual(result.misses, 0)
+            for measured in result.delays {
+                XCTAssertEqual(measured, Double(delay) / 48, accuracy: 0.05)
+            }
+        }
+
+        // 無効の間は何もしない
+        let disabled = measureMarker(delay: 100, enabled: false)
+        XCTAssertTrue(disabled.delays.isEmpty)
+        XCTAssertEqual(disabled.misses, 0)
+    }
+
+    func testMarkerLostWhenOutputSilent() {
+        let marker = vc_latency_marker_create(48000, 500)!
+        defer { vc_latency_marker_destroy(marker) }
+        vc_latency_marker_set_enabled(marker, 1)
+
+        var block = [Float](repeating: 0, count: 256)
+        let silence = [Float](repeating: 0, count: 256)
+        var delayMs = 0.0
+        for _ in 0..<600 {
+            vc_latency_marker_inject(marker, &block, 256)
+            XCTAssertEqual(vc_latency_marker_detect(marker, silence, 256, &delayMs), 0)
+        }
+        XCTAssertGreaterThanOrEqual(vc_latency_marker_misses(marker), 4)
+    }
+
+    /// キャプチャ → キャプチャリング → 共有リング → ドライバーの受け渡しを時刻付きでたどる
+    func testPipelineMeasuresBufferedLatency() {
+        let ticksPerFrame = 1e6 / 48000     // 1 tick = 1µs
+        let capture = vc_audio_ring_create(2048)!
+        let output = vc_audio_ring_create(16384)!
+        defer {
+            vc_audio_ring_destroy(capture)
+            vc_audio_ring_destroy(output)
+        }
+        let captureView = vc_audio_ring_view(capture)!
+        let outputView = vc_audio_ring_view(output)!
+        vc_shared_ring_set_active(outputView, 1)
+
+        let captureTimeline = vc_latency_timeline_create(64, ticksPerFrame)!
+        let outputTimeline = vc_latency_timeline_create(64, ticksPerFrame)!
+        let probe = vc_latency_probe_create(1000)!
+        defer {
+            vc_latency_timeline_destroy(captureTimeline)
+            vc_latency_timeline_destroy(outputTimeline)
+            vc_latency_probe_destroy(probe)
+        }
+
+        var delivery: UInt32 = 0
+        var deliveryHostTime: UInt64 = 0
+        XCTAssertEqual(vc_shared_ring_delivery(outputView, &delivery, &deliveryHostTime), 0)
+
+        var block = [Float](repeating: 0, count: 512)
+        var writeIndex: UInt32 = 0
+        var readIndex: UInt32 = 0
+        var lastDelivery: UInt32?
+        for k in 0..<2000 {
+            // 入力コールバック（256 フレーム）
+            let now = UInt64((Double(k * 256) * ticksPerFrame).rounded())
+            vc_shared_ring_indices(captureView, &writeIndex, &readIndex)
+            vc_latency_timeline_mark(captureTimeline, writeIndex, now)
+            vc_audio_ring_write(capture, block, 256)
+
+            // 処理: キャプチャ時刻を共有リングの位置へ付け替える
+            vc_shared_ring_indices(captureView, &writeIndex, &readIndex)
+            var captureTime: UInt64 = 0
+            XCTAssertEqual(vc_latency_timeline_lookup(captureTimeline, readIndex, &captureTime), 1)
+            XCTAssertEqual(captureTime, now)
+            vc_audio_ring_read(capture, &block, 256)
+            vc_shared_ring_indices(outputView, &writeIndex, &readIndex)
+            vc_latency_timeline_mark(outputTimeline, writeIndex, captureTime)
+            vc_shared_ring_write(outputView, block, 256)
+
+            // ドライバー: 9 ブロック溜まってから 512 フレームずつ、IO 周期の 3ms 後に渡す
+            if k % 2 == 1 && k > 8 {
+                vc_shared_ring_indices(outputView, &writeIndex, &readIndex)
+                vc_shared_ring_read(outputView, &block, 512)
+                vc_shared_ring_stamp_delivery(outputView, readIndex, now + 3000)
+            }
+
+            // 書き込み側が刻印を読む
+            if vc_shared_ring_delivery(outputView, &delivery, &deliveryHostTime) != 0, delivery != lastDelivery {
+                lastDelivery = delivery
+                var captured: UInt64 = 0
+                if vc_latency_timeline_lookup(outputTimeline, delivery, &captured) != 0 {
+                    vc_latency_probe_record(probe, captured, deliveryHostTime)
+                }
+            }
+        }
+
+        // リングに 2304 フレーム溜まったまま（48ms）+ 受け渡しの 3ms
+        var stats = VCLatencyStats()
+        vc_latency_probe_read(probe, &stats)
+        XCTAssertGreaterThan(stats.count, 900)
+        XCTAssertEqual(stats.rejected, 0)
+        XCTAssertEqual(stats.minMs, 51, accuracy: 0.01)
+        XCTAssertEqual(stats.maxMs, 51, accuracy: 0.01)
+        XCTAssertEqual(stats.p50Ms, 51, accuracy: 0.01)
+    }
+}
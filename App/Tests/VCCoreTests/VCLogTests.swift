@@ -0,0 +1,46 @@
+import XCTest
+import VCCore
+
+final class VCLogTests: XCTestCase {
+
+    func testEventsAreReadInOrder() {
+        let ring = vc_log_ring_create(8)!
+        defer { vc_log_ring_destroy(ring) }
+
+        for index in 0..<5 {
+            XCTAssertEqual(vc_log_ring_write(ring, UInt32(index), VCLogLevelWarning, 2, Double(index), -1, 0, 0), 0)
+        }
+
+        var event = VCLogEvent()
+        for index in 0..<5 {
+            XCTAssertEqual(vc_log_ring_read(ring, &event), 1)
+            XCTAssertEqual(event.eventId, UInt32(index))
+            XCTAssertEqual(event.level, UInt16(VCLogLevelWarning.rawValue))
+            XCTAssertEqual(event.argCount, 2)
+            XCTAssertEqual(event.args.0, Double(index))
+            XCTAssertEqual(event.args.1, -1)
+        }
+        XCTAssertEqual(vc_log_ring_read(ring, &event), 0)
+    }
+
+    func testFullRingDropsAndCounts() {
+        let ring = vc_log_ring_create(5)!
+        defer { vc_log_ring_destroy(ring) }
+
+        // 2のべき乗に切り上げ
+        XCTAssertEqual(vc_log_ring_capacity(ring), 8)
+
+        for index in 0..<10 {
+            vc_log_ring_write(ring, UInt32(index), VCLogLevelDebug, 0, 0, 0, 0, 0)
+        }
+        XCTAssertEqual(vc_log_ring_dropped(ring), 2)
+
+        // 先に書かれた8件が残っている
+        var event = VCLogEvent()
+        var eventIds: [UInt32] = []
+        while vc_log_ring_read(ring, &event) != 0 {
+            eventIds.append(event.eventId)
+        }
+        XCTAssertEqual(eventIds, Array(0..<8))
+    }
+}
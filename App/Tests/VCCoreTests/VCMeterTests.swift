@@ -0,0 +1,60 @@
+import XCTest
+import VCCore
+
+final class VCMeterTests: XCTestCase {
+
+    private func feed(_ meter: OpaquePointer, seconds: Float, _ signal: (Int) -> Float) {
+        let blockSize = 256
+        var block = [Float](repeating: 0, count: blockSize)
+        var n = 0
+        for _ in 0..<Int(seconds * 48000) / blockSize {
+            for i in 0..<blockSize {
+                block[i] = signal(n)
+                n += 1
+            }
+            vc_meter_process(meter, block, Int32(blockSize))
+        }
+    }
+
+    /// BS.1770 の校正点: 0dBFS の 1kHz 正弦波は -3.01 LUFS
+    func testFullScaleSineCalibration() {
+        let meter = vc_meter_create(48000)!
+        defer { vc_meter_destroy(meter) }
+
+        feed(meter, seconds: 4) { sin(Float($0) * 2 * .pi * 1000 / 48000) }
+
+        var reading = VCMeterReading()
+        XCTAssertEqual(vc_meter_read(meter, &reading), 1)
+        XCTAssertEqual(reading.peakDb, 0, accuracy: 0.05)
+        XCTAssertEqual(reading.rmsDb, -3.01, accuracy: 0.05)
+        XCTAssertEqual(reading.momentaryLufs, -3.01, accuracy: 0.1)
+        XCTAssertEqual(reading.shortTermLufs, -3.01, accuracy: 0.1)
+    }
+
+    func testSilenceReadsFloor() {
+        let meter = vc_meter_create(48000)!
+        defer { vc_meter_destroy(meter) }
+
+        feed(meter, seconds: 1) { _ in 0 }
+
+        var reading = VCMeterReading()
+        vc_meter_read(meter, &reading)
+        XCTAssertEqual(reading.peakDb, VC_METER_FLOOR_DB)
+        XCTAssertEqual(reading.shortTermLufs, VC_METER_FLOOR_DB)
+    }
+
+    func testReadReportsUpdatesOnlyOnce() {
+        let meter = vc_meter_create(48000)!
+        defer { vc_meter_destroy(meter) }
+
+        var reading = VCMeterReading()
+        XCTAssertEqual(vc_meter_read(meter, &reading), 0)
+
+        feed(meter, seconds: 0.1) { _ in 0.5 }
+        XCTAssertEqual(vc_meter_read(meter, &reading), 1)
+        XCTAssertEqual(reading.samples, 4608)
+        XCTAssertEqual(vc_meter_read(meter, &reading), 0)
+        // 更新がなくても最新値を返す
+        XCTAssertEqual(reading.samples, 4608)
+    }
+}
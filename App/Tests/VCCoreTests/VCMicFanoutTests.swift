@@ -0,0 +1,164 @@
+import XCTest
+import VCCore
+
+final class VCMicFanoutTests: XCTestCase {
+
+    private let blockSize = 256
+    private let blockCount = 32
+    private let ringCapacity = 16384
+
+    private func makeInput() -> [Float] {
+        (0..<(blockSize * blockCount)).map { i in 0.4 * sin(Float(i) * 0.013) }
+    }
+
+    private func makeChain(mic: Int) -> OpaquePointer {
+        let chain = vc_chain_create(48000)!
+        var params = VCChainParams()
+        vc_chain_params_default(&params)
+        params.eqHigh = Float(mic) * 2
+        params.pitchShift = mic % 2 == 0 ? 0 : 3
+        vc_chain_set_params(chain, &params)
+        return chain
+    }
+
+    // MARK: - Naming Scheme
+
+    /// マイク 0 はドライバの従来の ID・共有メモリ名のまま、以降は重ならない範囲に並ぶ
+    func testObjectIdsAndNames() {
+        XCTAssertEqual(vc_virtual_mic_object_id(0, VC_VIRTUAL_MIC_DEVICE), 2)
+        XCTAssertEqual(vc_virtual_mic_object_id(0, VC_VIRTUAL_MIC_MUTE), 5)
+        XCTAssertEqual(vc_virtual_mic_object_id(1, VC_VIRTUAL_MIC_DEVICE), 16)
+        XCTAssertEqual(vc_virtual_mic_object_id(2, VC_VIRTUAL_MIC_STREAM), 21)
+        XCTAssertEqual(vc_virtual_mic_object_id(Int32(VC_VIRTUAL_MIC_MAX), VC_VIRTUAL_MIC_DEVICE), 0)
+
+        var seen = Set<UInt32>()
+        for mic in 0..<Int32(VC_VIRTUAL_MIC_MAX) {
+            for raw in 0..<VC_VIRTUAL_MIC_OBJECT_COUNT.rawValue {
+                let object = VCVirtualMicObject(rawValue: raw)
+                let id = vc_virtual_mic_object_id(mic, object)
+                XCTAssertTrue(seen.insert(id).inserted)
+                // 仮想スピーカー（6, 7）とは重ならない
+                XCTAssertFalse(id == 6 || id == 7)
+
+                var decoded = VC_VIRTUAL_MIC_DEVICE
+                XCTAssertEqual(vc_virtual_mic_index(id, &decoded), mic)
+                XCTAssertEqual(decoded, object)
+            }
+        }
+        XCTAssertEqual(vc_virtual_mic_index(1, nil), -1)
+        XCTAssertEqual(vc_virtual_mic_index(6, nil), -1)
+
+        var buffer = [CChar](repeating: 0, count: Int(VC_VIRTUAL_MIC_MEMORY_NAME_MAX))
+        XCTAssertEqual(vc_virtual_mic_memory_name(0, &buffer, buffer.count), 0)
+        XCTAssertEqual(String(cString: buffer), "com.voicechanger.audio")
+        XCTAssertEqual(vc_virtual_mic_memory_name(3, &buffer, buffer.count), 0)
+        XCTAssertEqual(String(cString: buffer), "com.voicechanger.audio.4")
+        XCTAssertEqual(vc_virtual_mic_memory_name(Int32(VC_VIRTUAL_MIC_MAX), &buffer, buffer.count), -1)
+        XCTAssertEqual(vc_virtual_mic_memory_name(1, &buffer, 8), -1)
+    }
+
+    // MARK: - Fan-out
+
+    /// 同じ入力を読む各マイクの出力が、チェーンを単独で処理した結果と一致し、入力は書き換えない
+    func testFanoutMatchesIndividualChains() {
+        let micCount = 4
+        let input = makeInput()
+
+        var expected: [[Float]] = []
+        for mic in 0..<micCount {
+            let chain = makeChain(mic: mic)
+            var output = [Float](repeating: 0, count: input.count)
+            for b in 0..<blockCount {
+                input.withUnsafeBufferPointer { source in
+                    output.withUnsafeMutableBufferPointer { destination in
+                        vc_chain_process(chain, source.baseAddress! + b * blockSize,
+                                         destination.baseAddress! + b * blockSize, Int32(blockSize))
+                    }
+                }
+            }
+            expected.append(output)
+            vc_chain_destroy(chain)
+        }
+
+        let fanout = vc_mic_fanout_create(Int32(blockSize), 2)!
+        let chains = (0..<micCount).map { makeChain(mic: $0) }
+        for (mic, chain) in chains.enumerated() {
+            XCTAssertEqual(vc_mic_fanout_add(fanout, chain, nil), Int32(mic))
+        }
+        XCTAssertEqual(vc_mic_fanout_count(fanout), Int32(micCount))
+
+        var actual = [[Float]](repeating: [], count: micCount)
+        input.withUnsafeBufferPointer { source in
+            for b in 0..<blockCount {
+                XCTAssertEqual(vc_mic_fanout_process(fanout, source.baseAddress! + b * blockSize, Int32(blockSize)), 0)
+                for mic in 0..<micCount {
+                    let output = vc_mic_fanout_output(fanout, Int32(mic))!
+                    actual[mic].append(contentsOf: UnsafeBufferPointer(start: output, count: blockSize))
+                }
+            }
+        }
+
+        XCTAssertEqual(input, makeInput())
+        for mic in 0..<micCount {
+            XCTAssertEqual(actual[mic], expected[mic], "mic \(mic)")
+            var stats = VCMicFanoutStats()
+            vc_mic_fanout_get_stats(fanout, Int32(mic), &stats)
+            XCTAssertEqual(stats.blocks, UInt64(blockCount))
+        }
+        // マイクごとにプリセットが違うので出力も違う
+        XCTAssertNotEqual(actual[0], actual[1])
+        XCTAssertNil(vc_mic_fanout_output(fanout, Int32(micCount)))
+        XCTAssertEqual(vc_mic_fanout_process(fanout, input, Int32(blockSize + 1)), -1)
+
+        vc_mic_fanout_destroy(fanout)
+        chains.forEach { vc_chain_destroy($0) }
+    }
+
+    /// 各マイクは自分の共有リングへ書き、読まれずに満杯になった分は捨てて数える
+    func testFanoutWritesEachRingAndCountsDrops() {
+        let micCount = 2
+        let size = vc_shared_ring_size(Int32(ringCapacity))
+        let memory = (0..<micCount).map { _ in UnsafeMutableRawPointer.allocate(byteCount: size, alignment: 64) }
+        let rings = UnsafeMutablePointer<VCSharedRing>.allocate(capacity: micCount)
+        rings.initialize(repeating: VCSharedRing(), count: micCount)
+        for mic in 0..<micCount {
+            XCTAssertEqual(vc_shared_ring_format(rings + mic, memory[mic], size, 48000, Int32(blockSize), Int32(ringCapacity)), 0)
+        }
+
+        let fanout = vc_mic_fanout_create(Int32(blockSize), 1)!
+        let chains = (0..<micCount).map { makeChain(mic: $0) }
+        for mic in 0..<micCount {
+            XCTAssertGreaterThanOrEqual(vc_mic_fanout_add(fanout, chains[mic], rings + mic), 0)
+        }
+
+        let input = makeInput()
+        input.withUnsafeBufferPointer { source in
+            XCTAssertEqual(vc_mic_fanout_process(fanout, source.baseAddress!, Int32(blockSize)), 0)
+        }
+        var read = [Float](repeating: 0, count: blockSize)
+        for mic in 0..<micCount {
+            XCTAssertEqual(vc_shared_ring_available_read(rings + mic), Int32(blockSize))
+            XCTAssertEqual(vc_shared_ring_read(rings + mic, &read, Int32(blockSize)), Int32(blockSize))
+            let output = vc_mic_fanout_output(fanout, Int32(mic))!
+            XCTAssertEqual(read, Array(UnsafeBufferPointer(start: output, count: blockSize)))
+        }
+
+        // ドライバが読まないまま容量 + 1 ブロック分を書く
+        let blocks = ringCapacity / blockSize + 1
+        input.withUnsafeBufferPointer { source in
+            for _ in 0..<blocks {
+                vc_mic_fanout_process(fanout, source.baseAddress!, Int32(blockSize))
+            }
+        }
+        for mic in 0..<micCount {
+            var stats = VCMicFanoutStats()
+            vc_mic_fanout_get_stats(fanout, Int32(mic), &stats)
+            XCTAssertEqual(stats.droppedFrames, UInt64(blockSize))
+        }
+
+        vc_mic_fanout_destroy(fanout)
+        chains.forEach { vc_chain_destroy($0) }
+        rings.deallocate()
+        memory.forEach { $0.deallocate() }
+    }
+}
@@ -0,0 +1,163 @@
+import XCTest
+import VCCore
+
+final class VCMonitorTests: XCTestCase {
+
+    // MARK: - VCAudioRing
+
+    func testRingRegionsWrapAround() {
+        let ring = vc_audio_ring_create(100)!
+        defer { vc_audio_ring_destroy(ring) }
+
+        // 2のべき乗に切り上げ
+        XCTAssertEqual(vc_audio_ring_capacity(ring), 128)
+
+        var scratch = [Float](repeating: 0, count: 128)
+        XCTAssertEqual(vc_audio_ring_write(ring, scratch, 100), 100)
+        XCTAssertEqual(vc_audio_ring_read(ring, &scratch, 100), 100)
+
+        let block = (0..<64).map { Float($0) }
+        XCTAssertEqual(vc_audio_ring_write(ring, block, 64), 64)
+
+        var regions = VCRingRegions()
+        XCTAssertEqual(vc_audio_ring_read_regions(ring, 64, &regions), 64)
+        XCTAssertEqual(regions.firstCount, 28)
+        XCTAssertEqual(regions.secondCount, 36)
+        XCTAssertEqual(regions.first[0], 0)
+        XCTAssertEqual(regions.second[0], 28)
+
+        // 確定するまでは消費されない
+        XCTAssertEqual(vc_audio_ring_available_read(ring), 64)
+        vc_audio_ring_commit_read(ring, 64)
+        XCTAssertEqual(vc_audio_ring_available_read(ring), 0)
+    }
+
+    func testRingRejectsWriteWhenFull() {
+        let ring = vc_audio_ring_create(64)!
+        defer { vc_audio_ring_destroy(ring) }
+
+        let block = [Float](repeating: 1, count: 48)
+        XCTAssertEqual(vc_audio_ring_write(ring, block, 48), 48)
+        XCTAssertEqual(vc_audio_ring_write(ring, block, 48), 16)
+        XCTAssertEqual(vc_audio_ring_available_write(ring), 0)
+    }
+
+    // MARK: - VCMonitor（模擬出力クロック）
+
+    private struct SimulationResult {
+        var meanFill: Double
+        var meanRatio: Double
+        var underrunsAfterSettling: UInt64
+    }
+
+    /// 入力クロックで 256 フレームを push、(1 + drift) 倍速い出力クロックで 512 フレームを pull する
+    private func simulate(drift: Double, seconds: Double) -> SimulationResult {
+        let target: Int32 = 1024
+        let monitor = vc_monitor_create(target, 8192)!
+        defer { vc_monitor_destroy(monitor) }
+
+        let pushFrames = 256
+        let pullFrames = 512
+        let pushPeriod = Double(pushFrames) / 48000
+        let pullPeriod = Double(pullFrames) / (48000 * (1 + drift))
+        let settleTime = 10.0
+
+        var input = [Float](repeating: 0, count: pushFrames)
+        var output = [Float](repeating: 0, count: pullFrames)
+        var n = 0
+        var pushTime = 0.0
+        var pullTime = 0.0
+
+        var stats = VCMonitorStats()
+        var underrunsAtSettle: UInt64?
+        var fillSum = 0.0
+        var ratioSum = 0.0
+        var samples = 0
+
+        while pushTime < seconds {
+            if pushTime <= pullTime {
+                for i in 0..<pushFrames {
+                    input[i] = sin(Float(n) * 0.01)
+                    n += 1
+                }
+                vc_monitor_push(monitor, input, Int32(pushFrames))
+                pushTime += pushPeriod
+            } else {
+                vc_monitor_pull(monitor, &output, Int32(pullFrames))
+                pullTime += pullPeriod
+
+                guard pullTime > settleTime else { continue }
+                vc_monitor_get_stats(monitor, &stats)
+                if underrunsAtSettle == nil {
+                    underrunsAtSettle = stats.underruns
+                }
+                fillSum += Double(stats.fillFrames)
+                ratioSum += Double(stats.ratio)
+                samples += 1
+            }
+        }
+
+        vc_monitor_get_stats(monitor, &stats)
+        return SimulationResult(
+            meanFill: fillSum / Double(samples),
+            meanRatio: ratioSum / Double(samples),
+            underrunsAfterSettling: stats.underruns - (underrunsAtSettle ?? 0)
+        )
+    }
+
+    func testDriftCompensationHoldsTargetLatency() {
+        for drift in [200e-6, -200e-6, 1000e-6, -3000e-6] {
+            let result = simulate(drift: drift, seconds: 60)
+
+            XCTAssertEqual(result.underrunsAfterSettling, 0, "drift \(drift)")
+            XCTAssertEqual(result.meanFill, 1024, accuracy: 1024 * 0.05, "drift \(drift)")
+            // 出力が速い分だけ入力を遅く読む
+            XCTAssertEqual(result.meanRatio, 1 / (1 + drift), accuracy: 150e-6, "drift \(drift)")
+        }
+    }
+
+    func testPrimesWithSilenceUntilTarget() {
+        let monitor = vc_monitor_create(512, 4096)!
+        defer { vc_monitor_destroy(monitor) }
+
+        let block = [Float](repeating: 0.5, count: 256)
+        var output = [Float](repeating: 1, count: 256)
+
+        vc_monitor_push(monitor, block, 256)
+        vc_monitor_pull(monitor, &output, 256)
+        XCTAssertTrue(output.allSatisfy { $0 == 0 })
+
+        vc_monitor_push(monitor, block, 256)
+        vc_monitor_pull(monitor, &output, 256)
+        XCTAssertEqual(output[0], 0.5, accuracy: 1e-6)
+        XCTAssertEqual(output[255], 0.5, accuracy: 1e-6)
+
+        var stats = VCMonitorStats()
+        vc_monitor_get_stats(monitor, &stats)
+        XCTAssertEqual(stats.underruns, 0)
+    }
+
+    func testStalledOutputResyncsToTarget() {
+        let monitor = vc_monitor_create(512, 4096)!
+        defer { vc_monitor_destroy(monitor) }
+
+        // 出力が止まっている間に溜まった分は捨てて目標遅延に戻す
+        let block = [Float](repeating: 0.25, count: 256)
+        for _ in 0..<12 {
+            vc_monitor_push(monitor, block, 256)
+        }
+        var output = [Float](repeating: 0, count: 256)
+        vc_monitor_pull(monitor, &output, 256)
+
+        var stats = VCMonitorStats()
+        vc_monitor_get_stats(monitor, &stats)
+        XCTAssertEqual(stats.overruns, 1)
+        XCTAssertEqual(stats.droppedFrames, UInt64(12 * 256 - 512))
+
+        // 溜め直し
+        XCTAssertEqual(vc_monitor_restart(monitor, 1024), 0)
+        vc_monitor_pull(monitor, &output, 256)
+        XCTAssertTrue(output.allSatisfy { $0 == 0 })
+        XCTAssertEqual(vc_monitor_restart(monitor, 8192), -1)
+    }
+}
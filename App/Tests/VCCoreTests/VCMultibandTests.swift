@@ -0,0 +1,130 @@
+import XCTest
+import VCCore
+
+final class VCMultibandTests: XCTestCase {
+
+    private func sine(_ frequency: Float, amplitude: Float = 0.5, count: Int = 48000) -> [Float] {
+        (0..<count).map { amplitude * sin(Float($0) * 2 * .pi * frequency / 48000) }
+    }
+
+    /// 後半（エンベロープ・フィルタが落ち着いた区間）の RMS を入力比の dB で
+    private func gainDb(_ output: [Float], amplitude: Float = 0.5) -> Float {
+        let tail = output[(output.count / 2)...]
+        let rms = sqrt(tail.reduce(0) { $0 + $1 * $1 } / Float(tail.count))
+        return 20 * log10(rms / (amplitude / sqrt(2)))
+    }
+
+    func testBandsSumFlatWithoutCompression() {
+        let multiband = vc_multiband_create(48000)!
+        defer { vc_multiband_destroy(multiband) }
+        var params = VCMultibandParams()
+        vc_multiband_params_default(&params)
+        params.ratio = (1, 1, 1, 1)
+        vc_multiband_set_params(multiband, &params)
+
+        // クロスオーバー付近を含めて振幅特性は平坦（任意長のブロックで処理）
+        for frequency: Float in [60, 250, 700, 2000, 3500, 5500, 8000, 15000] {
+            vc_multiband_reset(multiband)
+            var samples = sine(frequency)
+            samples.withUnsafeMutableBufferPointer { buffer in
+                for offset in stride(from: 0, to: buffer.count, by: 100) {
+                    vc_multiband_process(multiband, buffer.baseAddress! + offset, Int32(min(100, buffer.count - offset)))
+                }
+            }
+            XCTAssertEqual(gainDb(samples), 0, accuracy: 0.05, "\(frequency) Hz")
+        }
+    }
+
+    func testDeEsserReducesSibilanceOnly() {
+        let multiband = vc_multiband_create(48000)!
+        defer { vc_multiband_destroy(multiband) }
+        var params = VCMultibandParams()
+        vc_multiband_params_default(&params)
+        params.thresholdDb = (0, 0, 0, -30)
+        vc_multiband_set_params(multiband, &params)
+
+        var voiced = sine(500)
+        vc_multiband_process(multiband, &voiced, Int32(voiced.count))
+        XCTAssertEqual(gainDb(voiced), 0, accuracy: 0.1)
+
+        vc_multiband_reset(multiband)
+        var sibilant = sine(7000)
+        vc_multiband_process(multiband, &sibilant, Int32(sibilant.count))
+        XCTAssertLessThan(gainDb(sibilant), -6)
+
+        var reduction: (Float, Float, Float, Float) = (0, 0, 0, 0)
+        withUnsafeMutablePointer(to: &reduction) {
+            $0.withMemoryRebound(to: Float.self, capacity: 4) { vc_multiband_get_gain_reduction(multiband, $0) }
+        }
+        XCTAssertEqual(reduction.0, 0)
+        XCTAssertGreaterThan(reduction.3, 10)
+    }
+
+    func testChainAppliesMultibandOnlyWhenEnabled() {
+        let chain = vc_chain_create(48000)!
+        defer { vc_chain_destroy(chain) }
+        var params = VCChainParams()
+        vc_chain_params_default(&params)
+        params.noiseSuppressionEnabled = 0
+        params.agcEnabled = 0
+        params.vadEnabled = 0
+        vc_chain_set_params(chain, &params)
+
+        let input = sine(7000, amplitude: 0.3, count: 9600)
+        var bypass = [Float](repeating: 0, count: input.count)
+        vc_chain_process(chain, input, &bypass, Int32(input.count))
+
+        vc_chain_reset(chain)
+        params.multibandEnabled = 1
+        params.deEsserThresholdDb = -40
+        params.deEsserRatio = 8
+        vc_chain_set_params(chain, &params)
+        var processed = [Float](repeating: 0, count: input.count)
+        vc_chain_process(chain, input, &processed, Int32(input.count))
+
+        XCTAssertLessThan(gainDb(processed, amplitude: 0.3), gainDb(bypass, amplitude: 0.3) - 6)
+    }
+
+    /// VAD が非発話と判定した（activity 0 の）ブロックではマルチバンドを省略し、状態もクリアしている
+    func testChainRestsMultibandWhileInactive() {
+        var params = VCChainParams()
+        vc_chain_params_default(&params)
+        params.noiseSuppressionEnabled = 0
+        params.agcEnabled = 0
+        params.vadEnabled = 1
+        let plain = vc_chain_create(48000)!
+        defer { vc_chain_destroy(plain) }
+        vc_chain_set_params(plain, &params)
+        params.multibandEnabled = 1
+        params.deEsserThresholdDb = -40
+        params.deEsserRatio = 8
+        let chain = vc_chain_create(48000)!
+        defer { vc_chain_destroy(chain) }
+        vc_chain_set_params(chain, &params)
+
+        // 広帯域のノイズ（ディエッサーが効く帯域を含む）を 1 秒
+        var seed: UInt32 = 1
+        let frameSize = 256
+        var input = [Float](repeating: 0, count: frameSize)
+        var withBands = [Float](repeating: 0, count: frameSize)
+        var withoutBands = [Float](repeating: 0, count: frameSize)
+        for _ in 0..<(48000 / frameSize) {
+            for i in 0..<frameSize {
+                seed = seed &* 1664525 &+ 1013904223
+                input[i] = 0.05 * (Float(seed >> 8) / Float(1 << 24) * 2 - 1)
+            }
+            vc_chain_process(chain, input, &withBands, Int32(frameSize))
+            vc_chain_process(plain, input, &withoutBands, Int32(frameSize))
+        }
+
+        var vad = VCVadState()
+        vc_chain_get_vad_state(chain, &vad)
+        XCTAssertEqual(vad.activity, 0)
+        XCTAssertEqual(withBands, withoutBands)
+        var reduction: (Float, Float, Float, Float) = (1, 1, 1, 1)
+        withUnsafeMutablePointer(to: &reduction) {
+            $0.withMemoryRebound(to: Float.self, capacity: 4) { vc_chain_get_multiband_reduction(chain, $0) }
+        }
+        XCTAssertEqual(reduction.3, 0)
+    }
+}
@@ -0,0 +1,111 @@
+import XCTest
+import VCCore
+
+final class VCOversamplerTests: XCTestCase {
+
+    private let fftSize = 4096
+
+    /// 往復させる。非線形処理は高いレートの領域をその場で書き換える
+    private func roundTrip(_ oversampler: OpaquePointer, _ input: [Float], blockSize: Int,
+                           nonlinearity: ((Float) -> Float)? = nil) -> [Float] {
+        let factor = Int(vc_oversampler_factor(oversampler))
+        var output = [Float](repeating: 0, count: input.count)
+        input.withUnsafeBufferPointer { source in
+            output.withUnsafeMutableBufferPointer { destination in
+                for offset in stride(from: 0, to: input.count, by: blockSize) {
+                    let frames = min(blockSize, input.count - offset)
+                    let upsampled = vc_oversampler_upsample(oversampler, source.baseAddress! + offset, Int32(frames))!
+                    if let nonlinearity {
+                        for i in 0..<frames * factor {
+                            upsampled[i] = nonlinearity(upsampled[i])
+                        }
+                    }
+                    vc_oversampler_downsample(oversampler, destination.baseAddress! + offset, Int32(frames))
+                }
+            }
+        }
+        return output
+    }
+
+    /// 基本波の整数倍以外のビンに入った電力の割合（dB）
+    private func aliasingDb(_ signal: ArraySlice<Float>, bin: Int) -> Float {
+        let plan = vc_fft_plan_create(Int32(fftSize))!
+        defer { vc_fft_plan_destroy(plan) }
+        var re = [Float](repeating: 0, count: fftSize / 2 + 1)
+        var im = re
+        var power = re
+        vc_fft_forward(plan, Array(signal), &re, &im)
+        vc_complex_power(re, im, &power, Int32(power.count))
+        var total: Float = 0
+        var aliased: Float = 0
+        for k in 1...(fftSize / 2) {
+            total += power[k]
+            if k % bin != 0 {
+                aliased += power[k]
+            }
+        }
+        return 10 * log10(aliased / total)
+    }
+
+    func testPassbandIsFlatAndDelayedByReportedLatency() {
+        XCTAssertNil(vc_oversampler_create(3, 512))
+
+        for (factor, latency) in [(1, Float(0)), (2, 23), (4, 26.5)] {
+            let oversampler = vc_oversampler_create(Int32(factor), 512)!
+            defer { vc_oversampler_destroy(oversampler) }
+            XCTAssertEqual(vc_oversampler_latency(oversampler), latency)
+
+            // 任意長のブロックで往復させ、報告された遅延だけずらした正弦波と比較する
+            let omega = 2 * Float.pi * 1000 / 48000
+            let input = (0..<9600).map { 0.5 * sin(omega * Float($0)) }
+            let output = roundTrip(oversampler, input, blockSize: 300)
+            for n in stride(from: 2000, to: input.count, by: 13) {
+                XCTAssertEqual(output[n], 0.5 * sin(omega * (Float(n) - latency)), accuracy: 1e-4)
+            }
+        }
+    }
+
+    func testOversamplingSuppressesAliasingOfSweptSines() {
+        let oversamplers = [1, 4].map { vc_oversampler_create(Int32($0), 512)! }
+        defer { oversamplers.forEach { vc_oversampler_destroy($0) } }
+
+        // 歪ませた正弦波（469 Hz〜4.7 kHz）。高調波がナイキストを超えて折り返す
+        for bin in stride(from: 40, through: 400, by: 60) {
+            let omega = 2 * Float.pi * Float(bin) / Float(fftSize)
+            let input = (0..<(2 * fftSize)).map { 0.8 * sin(omega * Float($0)) }
+            let aliasing = oversamplers.map { oversampler -> Float in
+                vc_oversampler_reset(oversampler)
+                let output = roundTrip(oversampler, input, blockSize: 512) { tanh(4 * $0) }
+                return aliasingDb(output[fftSize...], bin: bin)
+            }
+            if bin >= 280 {
+                XCTAssertGreaterThan(aliasing[0], -45, "bin \(bin)")
+            }
+            XCTAssertLessThan(aliasing[1], -55, "bin \(bin)")
+        }
+    }
+
+    func testChainReportsLimiterOversamplingLatency() {
+        let chain = vc_chain_create(48000)!
+        defer { vc_chain_destroy(chain) }
+        XCTAssertEqual(vc_chain_latency(chain), 0)
+
+        var params = VCChainParams()
+        vc_chain_params_default(&params)
+        params.limiterOversampling = 4
+        vc_chain_set_params(chain, &params)
+        XCTAssertEqual(vc_chain_latency(chain), 26.5)
+
+        // 大きすぎる入力でも上限付近に収まる
+        let input: [Float] = (0..<4800).map { 3 * sin(Float($0) * 2 * .pi * 440 / 48000) }
+        var output = [Float](repeating: 0, count: input.count)
+        for offset in stride(from: 0, to: input.count, by: 480) {
+            input.withUnsafeBufferPointer { source in
+                output.withUnsafeMutableBufferPointer { destination in
+                    vc_chain_process(chain, source.baseAddress! + offset, destination.baseAddress! + offset, 480)
+                }
+            }
+        }
+        XCTAssertLessThan(output.map(abs).max()!, 0.95)
+    }
+}
@@ -0,0 +1,127 @@
+import XCTest
+import VCCore
+
+final class VCPitchTests: XCTestCase {
+
+    private let sampleRate = 48000
+    private let blockSize = 128
+
+    private func harmonic(count: Int, f0: Float, harmonics: Int) -> [Float] {
+        (0..<count).map { i in
+            let phase = 2 * Float.pi * f0 * Float(i) / Float(sampleRate)
+            var sample: Float = 0
+            for harmonic in 1...harmonics {
+                sample += sin(phase * Float(harmonic)) / Float(harmonic)
+            }
+            return 0.2 * sample
+        }
+    }
+
+    private func noise(count: Int, amplitude: Float) -> [Float] {
+        var seed: UInt32 = 7
+        return (0..<count).map { _ in
+            seed = seed &* 1664525 &+ 1013904223
+            return (Float(seed >> 8) / 16777216 - 0.5) * 2 * amplitude
+        }
+    }
+
+    private func track(_ samples: [Float], search: Int32 = 1) -> [VCPitchEstimate] {
+        let tracker = vc_pitch_create(Int32(sampleRate), VC_PITCH_DEFAULT_MIN_HZ, VC_PITCH_DEFAULT_MAX_HZ)!
+        defer { vc_pitch_destroy(tracker) }
+        var estimates: [VCPitchEstimate] = []
+        for offset in stride(from: 0, to: samples.count - blockSize + 1, by: blockSize) {
+            var estimate = VCPitchEstimate()
+            samples.withUnsafeBufferPointer { buffer in
+                vc_pitch_process(tracker, buffer.baseAddress! + offset, Int32(blockSize), search, &estimate)
+            }
+            estimates.append(estimate)
+        }
+        return estimates
+    }
+
+    // MARK: - Tracking
+
+    func testTracksHarmonicSignals() {
+        for (f0, harmonics) in [(Float(95), 10), (150, 6), (300, 3), (520, 2)] {
+            // 窓が埋まる 100ms 以降は 1% 以内
+            let estimates = track(harmonic(count: sampleRate / 2, f0: f0, harmonics: harmonics)).dropFirst(40)
+            for estimate in estimates {
+                XCTAssertEqual(estimate.voiced, 1)
+                XCTAssertEqual(estimate.f0Hz, f0, accuracy: f0 * 0.01)
+                XCTAssertGreaterThan(estimate.confidence, 0.9)
+            }
+        }
+    }
+
+    func testNoiseAndSilenceAreUnvoiced() {
+        let noisy = track(noise(count: sampleRate / 2, amplitude: 0.1)).dropFirst(40)
+        XCTAssertTrue(noisy.allSatisfy { $0.voiced == 0 || $0.confidence < 0.7 })
+
+        let silent = track([Float](repeating: 0, count: sampleRate / 4)).dropFirst(40)
+        XCTAssertTrue(silent.allSatisfy { $0.voiced == 0 && $0.f0Hz == 0 })
+    }
+
+    func testSkippingSearchStillKeepsHistory() {
+        let tracker = vc_pitch_create(Int32(sampleRate), VC_PITCH_DEFAULT_MIN_HZ, VC_PITCH_DEFAULT_MAX_HZ)!
+        defer { vc_pitch_destroy(tracker) }
+        let signal = harmonic(count: sampleRate / 4, f0: 200, harmonics: 4)
+
+        // 探索なしで履歴だけ流した直後でも、次のブロックから正しく推定できる
+        var estimate = VCPitchEstimate()
+        signal.withUnsafeBufferPointer { buffer in
+            let blocks = signal.count / blockSize
+            for block in 0..<blocks - 1 {
+                vc_pitch_process(tracker, buffer.baseAddress! + block * blockSize, Int32(blockSize), 0, &estimate)
+                XCTAssertEqual(estimate.f0Hz, 0)
+            }
+            vc_pitch_process(tracker, buffer.baseAddress! + (blocks - 1) * blockSize, Int32(blockSize), 1, &estimate)
+        }
+        XCTAssertEqual(estimate.f0Hz, 200, accuracy: 2)
+    }
+
+    // MARK: - Chain
+
+    func testChainPublishesBlockAnalysis() {
+        let chain = vc_chain_create(Int32(sampleRate))!
+        defer { vc_chain_destroy(chain) }
+        var params = VCChainParams()
+        vc_chain_params_default(&params)
+        params.vadEnabled = 0
+        vc_chain_set_params(chain, &params)
+
+        var signal = harmonic(count: sampleRate / 2, f0: 180, harmonics: 6)
+        signal.withUnsafeMutableBufferPointer { buffer in
+            for offset in stride(from: 0, to: buffer.count, by: blockSize) {
+                vc_chain_process(chain, buffer.baseAddress! + offset, buffer.baseAddress! + offset, Int32(blockSize))
+            }
+        }
+
+        var analysis = VCBlockAnalysis()
+        vc_chain_get_analysis(chain, &analysis)
+        XCTAssertEqual(analysis.speech, 1)
+        XCTAssertEqual(analysis.pitch.voiced, 1)
+        XCTAssertEqual(analysis.pitch.f0Hz, 180, accuracy: 2)
+    }
+
+    // MARK: - Shifter
+
+    func testShifterTransposesHarmonicSignal() {
+        for semitones: Float in [12, 7, -5, -12] {
+            let shifter = vc_pitch_shifter_create(Int32(sampleRate), 0)!
+            defer { vc_pitch_shifter_destroy(shifter) }
+            vc_pitch_shifter_set_semitones(shifter, semitones)
+            XCTAssertEqual(vc_pitch_shifter_latency(shifter), 720)
+
+            var signal = harmonic(count: sampleRate / 2, f0: 200, harmonics: 3)
+            signal.withUnsafeMutableBufferPointer { buffer in
+                vc_pitch_shifter_process(shifter, buffer.baseAddress!, buffer.baseAddress!, Int32(buffer.count))
+            }
+            // 窓の継ぎ目をまたいでも、推定は移調先の 1% 以内
+            let expected = 200 * exp2(semitones / 12)
+            for estimate in track(signal).dropFirst(60) {
+                XCTAssertEqual(estimate.voiced, 1)
+                XCTAssertEqual(estimate.f0Hz, expected, accuracy: expected * 0.01)
+            }
+        }
+    }
+}
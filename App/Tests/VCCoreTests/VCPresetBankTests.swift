@@ -0,0 +1,101 @@
+import XCTest
+import VCCore
+
+final class VCPresetBankTests: XCTestCase {
+
+    private var path: String!
+
+    override func setUp() {
+        path = FileManager.default.temporaryDirectory
+            .appendingPathComponent("vc-presets-\(UUID().uuidString).vcpb").path
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(atPath: path)
+    }
+
+    /// id / name は呼び出し中だけ有効な C 文字列で渡す
+    private func write(count: Int, pitch: (Int) -> Float = { Float($0 % 25 - 12) }) -> Int32 {
+        let ids = (0..<count).map { strdup("preset_\($0)")! }
+        let names = (0..<count).map { strdup("Preset \($0)")! }
+        let hall = strdup("hall")!
+        defer {
+            (ids + names + [hall]).forEach { free($0) }
+        }
+        var entries = (0..<count).map { i -> VCPresetEntry in
+            var params = VCChainParams()
+            vc_chain_params_default(&params)
+            params.pitchShift = pitch(i)
+            params.limiterOversampling = i % 2 == 0 ? 1 : 2
+            return VCPresetEntry(id: ids[i], name: names[i], impulseResponse: i % 3 == 0 ? UnsafePointer(hall) : nil,
+                                 params: params)
+        }
+        return vc_preset_bank_write(path, &entries, Int32(count))
+    }
+
+    func testRoundTripsAndFindsEveryPreset() {
+        XCTAssertEqual(write(count: 1000), 0)
+        let bank = vc_preset_bank_open(path)!
+        defer { vc_preset_bank_close(bank) }
+        XCTAssertEqual(vc_preset_bank_count(bank), 1000)
+
+        for i in 0..<1000 {
+            let index = vc_preset_bank_find(bank, "preset_\(i)")
+            XCTAssertEqual(index, Int32(i))
+            var entry = VCPresetEntry()
+            XCTAssertEqual(vc_preset_bank_get(bank, index, &entry), 0)
+            XCTAssertEqual(String(cString: entry.name), "Preset \(i)")
+            XCTAssertEqual(entry.params.pitchShift, Float(i % 25 - 12))
+            XCTAssertEqual(entry.params.limiterOversampling, i % 2 == 0 ? 1 : 2)
+            XCTAssertEqual(entry.impulseResponse.map { String(cString: $0) }, i % 3 == 0 ? "hall" : nil)
+        }
+        XCTAssertEqual(vc_preset_bank_find(bank, "missing"), -1)
+    }
+
+    func testRejectsCorruptedAndInvalidBanks() throws {
+        XCTAssertEqual(write(count: 10), 0)
+        var bytes = try Data(contentsOf: URL(fileURLWithPath: path))
+
+        // 1 バイト書き換えただけでもチェックサムで弾く
+        bytes[200] ^= 0x55
+        try bytes.write(to: URL(fileURLWithPath: path))
+        XCTAssertNil(vc_preset_bank_open(path))
+
+        // 範囲外の値も書き出しはできるが、開くときに弾く
+        XCTAssertEqual(write(count: 10, pitch: { $0 == 5 ? .nan : 0 }), 0)
+        XCTAssertNil(vc_preset_bank_open(path))
+
+        XCTAssertNil(vc_preset_bank_open("/nonexistent/presets.vcpb"))
+    }
+
+    func testWatcherHotSwapsValidatedBank() throws {
+        XCTAssertEqual(write(count: 10), 0)
+        let watcher = vc_preset_bank_watcher_create(path, 10, nil, nil)!
+        defer { vc_preset_bank_watcher_destroy(watcher) }
+
+        // 変更がなければ何も渡さない
+        usleep(50_000)
+        XCTAssertNil(vc_preset_bank_watcher_take(watcher))
+
+        XCTAssertEqual(write(count: 20, pitch: { _ in 7 }), 0)
+        var reloaded: OpaquePointer?
+        for _ in 0..<100 where reloaded == nil {
+            usleep(10_000)
+            reloaded = vc_preset_bank_watcher_take(watcher)
+        }
+        let bank = try XCTUnwrap(reloaded)
+        defer { vc_preset_bank_close(bank) }
+        XCTAssertEqual(vc_preset_bank_count(bank), 20)
+        var entry = VCPresetEntry()
+        vc_preset_bank_get(bank, vc_preset_bank_find(bank, "preset_3"), &entry)
+        XCTAssertEqual(entry.params.pitchShift, 7)
+
+        // 壊れたファイルは受け渡さず数える
+        try Data("not a preset bank".utf8).write(to: URL(fileURLWithPath: path))
+        for _ in 0..<100 where vc_preset_bank_watcher_rejected(watcher) == 0 {
+            usleep(10_000)
+        }
+        XCTAssertEqual(vc_preset_bank_watcher_rejected(watcher), 1)
+        XCTAssertNil(vc_preset_bank_watcher_take(watcher))
+    }
+}
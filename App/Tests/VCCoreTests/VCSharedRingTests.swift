@@ -0,0 +1,262 @@
+import XCTest
+import VCCore
+
+final class VCSharedRingTests: XCTestCase {
+
+    private let capacity: Int32 = 1024
+
+    /// 64バイト境界の共有メモリ相当
+    private func allocateMemory(capacity: Int32) -> (UnsafeMutableRawPointer, Int) {
+        let size = vc_shared_ring_size(capacity)
+        let memory = UnsafeMutableRawPointer.allocate(byteCount: size, alignment: 64)
+        memory.initializeMemory(as: UInt8.self, repeating: 0, count: size)
+        return (memory, size)
+    }
+
+    // MARK: - Format / Attach
+
+    func testAttachValidatesHeader() {
+        let (memory, size) = allocateMemory(capacity: capacity)
+        defer { memory.deallocate() }
+
+        var ring = VCSharedRing()
+        // 未初期化（magic なし）
+        XCTAssertEqual(vc_shared_ring_attach(&ring, memory, size), -1)
+
+        // 2のべき乗以外 / サイズ不足は作成できない
+        XCTAssertEqual(vc_shared_ring_format(&ring, memory, size, 48000, 256, 1000), -1)
+        XCTAssertEqual(vc_shared_ring_format(&ring, memory, size - 4, 48000, 256, capacity), -1)
+
+        XCTAssertEqual(vc_shared_ring_format(&ring, memory, size, 48000, 256, capacity), 0)
+        var attached = VCSharedRing()
+        XCTAssertEqual(vc_shared_ring_attach(&attached, memory, size), 0)
+        XCTAssertEqual(attached.capacity, UInt32(capacity))
+        XCTAssertEqual(vc_shared_ring_sample_rate(&attached), 48000)
+        XCTAssertEqual(vc_shared_ring_frame_size(&attached), 256)
+
+        // マッピングがヘッダーの容量より小さい
+        XCTAssertEqual(vc_shared_ring_attach(&attached, memory, size - 4), -1)
+
+        // 旧レイアウト（version 1）は拒否
+        memory.storeBytes(of: UInt32(1), toByteOffset: 4, as: UInt32.self)
+        XCTAssertEqual(vc_shared_ring_attach(&attached, memory, size), -1)
+    }
+
+    // MARK: - Cross View
+
+    func testTwoViewsShareIndices() {
+        let (memory, size) = allocateMemory(capacity: capacity)
+        defer { memory.deallocate() }
+
+        var producer = VCSharedRing()
+        var consumer = VCSharedRing()
+        XCTAssertEqual(vc_shared_ring_format(&producer, memory, size, 48000, 256, capacity), 0)
+        XCTAssertEqual(vc_shared_ring_attach(&consumer, memory, size), 0)
+
+        XCTAssertEqual(vc_shared_ring_is_active(&consumer), 0)
+        vc_shared_ring_set_active(&producer, 1)
+        XCTAssertEqual(vc_shared_ring_is_active(&consumer), 1)
+
+        // 容量を何周かしても順序が保たれる
+        var block = [Float](repeating: 0, count: 384)
+        var output = [Float](repeating: 0, count: 384)
+        var next: Float = 0
+        var expected: Float = 0
+        for _ in 0..<20 {
+            for i in block.indices {
+                block[i] = next
+                next += 1
+            }
+            XCTAssertEqual(vc_shared_ring_write(&producer, block, 384), 384)
+            XCTAssertEqual(vc_shared_ring_available_read(&consumer), 384)
+            XCTAssertEqual(vc_shared_ring_read(&consumer, &output, 384), 384)
+            for value in output {
+                XCTAssertEqual(value, expected)
+                expected += 1
+            }
+        }
+
+        // consumer の読み出し位置は producer 側の空き容量に反映される
+        XCTAssertEqual(vc_shared_ring_write(&producer, block, 384), 384)
+        XCTAssertEqual(vc_shared_ring_available_write(&producer), Int32(capacity) - 384)
+    }
+
+    func testCorruptIndicesNeverReadOutOfRange() {
+        let (memory, size) = allocateMemory(capacity: capacity)
+        defer { memory.deallocate() }
+
+        var ring = VCSharedRing()
+        XCTAssertEqual(vc_shared_ring_format(&ring, memory, size, 48000, 256, capacity), 0)
+
+        // 相手プロセスが容量を超える writeIndex を書いた
+        memory.storeBytes(of: UInt32(capacity * 4), toByteOffset: 64, as: UInt32.self)
+        var regions = VCRingRegions()
+        XCTAssertEqual(vc_shared_ring_read_regions(&ring, 256, &regions), 0)
+        XCTAssertEqual(vc_shared_ring_write_regions(&ring, 256, &regions), 0)
+    }
+
+    /// プロセス内リングは consumer の読み出し単位を公開できる（producer が滞留をブロック数で数える）
+    func testAudioRingPublishesBlockSize() {
+        let ring = vc_audio_ring_create(capacity)!
+        defer { vc_audio_ring_destroy(ring) }
+
+        XCTAssertEqual(vc_audio_ring_block_size(ring), 1)
+        vc_audio_ring_set_block_size(ring, 256)
+        XCTAssertEqual(vc_audio_ring_block_size(ring), 256)
+        vc_audio_ring_set_block_size(ring, 0)
+        XCTAssertEqual(vc_audio_ring_block_size(ring), 1)
+
+        // 読み書きには影響しない
+        let block = [Float](repeating: 0.5, count: 100)
+        XCTAssertEqual(vc_audio_ring_write(ring, block, 100), 100)
+        XCTAssertEqual(vc_audio_ring_available_read(ring), 100)
+    }
+
+    // MARK: - Liveness
+
+    /// 作り直すたびに世代が進み、同じレイアウトの引き継ぎではインデックスも世代も変わらない
+    func testFormatBumpsGenerationAndReclaimKeepsIndices() {
+        let (memory, size) = allocateMemory(capacity: capacity)
+        defer { memory.deallocate() }
+
+        var producer = VCSharedRing()
+        var consumer = VCSharedRing()
+        XCTAssertEqual(vc_shared_ring_reclaim(&producer, memory, size, 48000, 256, capacity), 0)
+        XCTAssertEqual(vc_shared_ring_generation(&producer), 1)
+        XCTAssertEqual(vc_shared_ring_attach(&consumer, memory, size), 0)
+
+        let block = [Float](repeating: 0.5, count: 100)
+        var output = [Float](repeating: 0, count: 40)
+        vc_shared_ring_set_active(&producer, 1)
+        XCTAssertEqual(vc_shared_ring_write(&producer, block, 100), 100)
+        XCTAssertEqual(vc_shared_ring_read(&consumer, &output, 40), 40)
+
+        // App が落ちて再起動した（稼働中のまま残っている）
+        var relaunched = VCSharedRing()
+        XCTAssertEqual(vc_shared_ring_reclaim(&relaunched, memory, size, 48000, 256, capacity), 1)
+        XCTAssertEqual(vc_shared_ring_generation(&consumer), 1)
+        XCTAssertEqual(vc_shared_ring_available_read(&consumer), 60)
+        XCTAssertEqual(vc_shared_ring_is_active(&consumer), 0)
+
+        // レイアウトが違えば作り直す
+        XCTAssertEqual(vc_shared_ring_reclaim(&relaunched, memory, size, 48000, 512, capacity), 0)
+        XCTAssertEqual(vc_shared_ring_generation(&consumer), 2)
+        XCTAssertEqual(vc_shared_ring_available_read(&consumer), 0)
+        XCTAssertEqual(vc_shared_ring_format(&relaunched, memory, size, 48000, 256, capacity), 0)
+        XCTAssertEqual(vc_shared_ring_generation(&consumer), 3)
+    }
+
+    /// 稼働中に heartbeat が止まれば停止、世代が変われば作り直しと判定する（時刻は任意の単位）
+    func testWatchDetectsStalledAndReplacedProducer() {
+        let (memory, size) = allocateMemory(capacity: capacity)
+        defer { memory.deallocate() }
+
+        var producer = VCSharedRing()
+        var consumer = VCSharedRing()
+        XCTAssertEqual(vc_shared_ring_format(&producer, memory, size, 48000, 256, capacity), 0)
+        XCTAssertEqual(vc_shared_ring_attach(&consumer, memory, size), 0)
+
+        var watch = VCSharedRingWatch()
+        vc_shared_ring_watch_init(&watch, &consumer, 0, 100)
+
+        // 非稼働の間は何も書かなくても停止とみなさない
+        XCTAssertEqual(vc_shared_ring_watch_check(&watch, &consumer, 1000), VC_SHARED_RING_PEER_ALIVE)
+
+        vc_shared_ring_set_active(&producer, 1)
+        XCTAssertEqual(vc_shared_ring_watch_check(&watch, &consumer, 1100), VC_SHARED_RING_PEER_ALIVE)
+        XCTAssertEqual(vc_shared_ring_watch_check(&watch, &consumer, 1101), VC_SHARED_RING_PEER_STALLED)
+
+        // 書き込みで heartbeat が進む
+        let block = [Float](repeating: 0.5, count: 64)
+        vc_shared_ring_write(&producer, block, 64)
+        XCTAssertEqual(vc_shared_ring_watch_check(&watch, &consumer, 1200), VC_SHARED_RING_PEER_ALIVE)
+        XCTAssertEqual(vc_shared_ring_watch_check(&watch, &consumer, 1350), VC_SHARED_RING_PEER_STALLED)
+
+        // 引き継いだ App が書き始めれば同じビューのまま再開する
+        var relaunched = VCSharedRing()
+        XCTAssertEqual(vc_shared_ring_reclaim(&relaunched, memory, size, 48000, 256, capacity), 1)
+        vc_shared_ring_set_active(&relaunched, 1)
+        vc_shared_ring_write(&relaunched, block, 64)
+        XCTAssertEqual(vc_shared_ring_watch_check(&watch, &consumer, 1400), VC_SHARED_RING_PEER_ALIVE)
+
+        // 作り直されたら、接続し直すまで作り直しのまま
+        XCTAssertEqual(vc_shared_ring_format(&relaunched, memory, size, 48000, 256, capacity), 0)
+        XCTAssertEqual(vc_shared_ring_watch_check(&watch, &consumer, 1410), VC_SHARED_RING_PEER_REPLACED)
+        XCTAssertEqual(vc_shared_ring_watch_check(&watch, &consumer, 1420), VC_SHARED_RING_PEER_REPLACED)
+        XCTAssertEqual(vc_shared_ring_attach(&consumer, memory, size), 0)
+        vc_shared_ring_watch_init(&watch, &consumer, 1430, 100)
+        XCTAssertEqual(vc_shared_ring_watch_check(&watch, &consumer, 1440), VC_SHARED_RING_PEER_ALIVE)
+    }
+
+    // MARK: - Loopback
+
+    /// App → mic ring → ドライバー IO → speaker ring → VCMonitor の往復遅延（サンプル単位）
+    func testLoopbackLatencyIsBoundedByBlockSizes() {
+        let (micMemory, micSize) = allocateMemory(capacity: capacity * 4)
+        let (speakerMemory, speakerSize) = allocateMemory(capacity: capacity * 4)
+        defer {
+            micMemory.deallocate()
+            speakerMemory.deallocate()
+        }
+
+        var appMic = VCSharedRing()
+        var driverMic = VCSharedRing()
+        var appSpeaker = VCSharedRing()
+        var driverSpeaker = VCSharedRing()
+        XCTAssertEqual(vc_shared_ring_format(&appMic, micMemory, micSize, 48000, 256, capacity * 4), 0)
+        XCTAssertEqual(vc_shared_ring_format(&appSpeaker, speakerMemory, speakerSize, 48000, 256, capacity * 4), 0)
+        XCTAssertEqual(vc_shared_ring_attach(&driverMic, micMemory, micSize), 0)
+        XCTAssertEqual(vc_shared_ring_attach(&driverSpeaker, speakerMemory, speakerSize), 0)
+
+        let target: Int32 = 1024
+        let listening = vc_monitor_create_attached(&appSpeaker, target)!
+        defer { vc_monitor_destroy(listening) }
+
+        // 128 サンプル刻みで時刻を進め、各クロックの境界でブロックを受け渡す
+        let appFrames = 256
+        let ioFrames = 512
+        let outputFrames = 512
+        var appBlock = [Float](repeating: 0, count: appFrames)
+        var ioBuffer = [Float](repeating: 0, count: ioFrames)
+        var output = [Float](repeating: 0, count: outputFrames)
+
+        let markerTime = 48000
+        var detectedTime: Int?
+        var previous: Float = 0
+
+        for time in stride(from: 0, to: 96000, by: 128) {
+            if time % appFrames == 0 {
+                for i in appBlock.indices {
+                    appBlock[i] = time + i == markerTime ? 1 : 0
+                }
+                vc_shared_ring_write(&appMic, appBlock, Int32(appFrames))
+            }
+            if time % ioFrames == 0 {
+                // ドライバーは不足時に消費せず無音を返す
+                if vc_shared_ring_available_read(&driverMic) >= Int32(ioFrames) {
+                    vc_shared_ring_read(&driverMic, &ioBuffer, Int32(ioFrames))
+                } else {
+                    ioBuffer = [Float](repeating: 0, count: ioFrames)
+                }
+                vc_shared_ring_write(&driverSpeaker, ioBuffer, Int32(ioFrames))
+            }
+            if time % outputFrames == 256 {
+                vc_monitor_pull(listening, &output, Int32(outputFrames))
+                for (i, value) in output.enumerated() {
+                    if detectedTime == nil && value > 0.25 && previous <= 0.25 {
+                        detectedTime = time + i
+                    }
+                    previous = value
+                }
+            }
+        }
+
+        guard let detectedTime = detectedTime else {
+            return XCTFail("marker not received")
+        }
+        let latency = detectedTime - markerTime
+        // 下限はモニターの目標遅延、上限はそれに各ブロックの待ちを足したもの
+        XCTAssertGreaterThanOrEqual(latency, Int(target) - outputFrames)
+        XCTAssertLessThanOrEqual(latency, Int(target) + appFrames + ioFrames + outputFrames)
+    }
+}
@@ -0,0 +1,142 @@
+import XCTest
+import VCCore
+
+final class VCSignalGuardTests: XCTestCase {
+
+    private func process(_ chain: OpaquePointer, _ samples: inout [Float]) {
+        samples.withUnsafeMutableBufferPointer { buffer in
+            vc_chain_process(chain, buffer.baseAddress, buffer.baseAddress, Int32(buffer.count))
+        }
+    }
+
+    private func tone(_ count: Int, phase: Int = 0) -> [Float] {
+        (0..<count).map { 0.3 * sin(Float($0 + phase) * 2 * .pi * 220 / 48000) }
+    }
+
+    private func moduleResets(_ stats: VCSignalGuardStats, _ module: VCChainModule) -> UInt64 {
+        withUnsafeBytes(of: stats.moduleResets) { Array($0.bindMemory(to: UInt64.self))[Int(module.rawValue)] }
+    }
+
+    // MARK: - Scan Tests
+
+    func testScanFindsBrokenValuesInVectorLanesAndTail() {
+        let cases: [(Float, Int32)] = [
+            (.nan, Int32(VC_SIGNAL_NAN.rawValue)),
+            (-.infinity, Int32(VC_SIGNAL_INFINITE.rawValue)),
+            (.leastNonzeroMagnitude, Int32(VC_SIGNAL_DENORMAL.rawValue)),
+            (-.leastNormalMagnitude / 2, Int32(VC_SIGNAL_DENORMAL.rawValue)),
+        ]
+        // 11 = 4 レーン × 2 + 端数 3（どの位置でも見つかること）
+        for (value, flag) in cases {
+            for position in 0..<11 {
+                var samples = tone(11)
+                samples[position] = value
+                XCTAssertEqual(vc_signal_scan(samples, 11), flag, "\(value) at \(position)")
+            }
+        }
+        let clean: [Float] = [0, -0, 1, -1, .leastNormalMagnitude, .greatestFiniteMagnitude, 0.5]
+        XCTAssertEqual(vc_signal_scan(clean, Int32(clean.count)), 0)
+    }
+
+    func testSanitizeZeroesOnlyBrokenSamples() {
+        let input: [Float] = [0.25, .nan, -0.5, .infinity, .leastNonzeroMagnitude, 1]
+        var output = [Float](repeating: 9, count: input.count)
+        XCTAssertEqual(vc_signal_sanitize(input, &output, Int32(input.count)), 3)
+        XCTAssertEqual(output, [0.25, 0, -0.5, 0, 0, 1])
+    }
+
+    // MARK: - Denormal Tests
+
+    func testFlushScopeTreatsDenormalsAsZeroAndRestores() throws {
+        try XCTSkipIf(vc_denormals_flush_supported() == 0, "FTZ/DAZ を切り替えられない環境")
+        var coeffs = VCBiquadCoeffs()
+        var state = VCBiquadState()
+        vc_biquad_set_identity(&coeffs)
+        let input: [Float] = [.leastNonzeroMagnitude]
+        var output: [Float] = [1]
+
+        var scope = VCDenormalScope()
+        vc_denormals_flush_begin(&scope)
+        vc_biquad_process(&coeffs, &state, input, &output, 1)
+        vc_denormals_flush_end(&scope)
+        XCTAssertEqual(output[0], 0)
+
+        vc_biquad_reset(&state)
+        vc_biquad_process(&coeffs, &state, input, &output, 1)
+        XCTAssertEqual(output[0], .leastNonzeroMagnitude)
+    }
+
+    // MARK: - Chain Guard Tests
+
+    func testChainRecoversFromNaNInput() {
+        let chain = vc_chain_create(48000)!
+        defer { vc_chain_destroy(chain) }
+
+        for block in 0..<8 {
+            var samples = tone(256, phase: block * 256)
+            if block == 2 {
+                samples[40] = .nan
+                samples[41] = .infinity
+            }
+            process(chain, &samples)
+            XCTAssertTrue(samples.allSatisfy(\.isFinite), "block \(block)")
+            XCTAssertGreaterThan(samples.map(abs).max()!, 0, "block \(block)")
+        }
+
+        var stats = VCSignalGuardStats()
+        vc_chain_get_signal_guard_stats(chain, &stats)
+        XCTAssertEqual(stats.blocks, 8)
+        XCTAssertEqual(stats.nonFiniteInputBlocks, 1)
+        XCTAssertEqual(stats.resets, 0)     // 入力で止めたので、どのモジュールの状態も壊れていない
+    }
+
+    func testBrokenModuleIsResetAndFadesBackIn() {
+        let chain = vc_chain_create(48000)!
+        defer { vc_chain_destroy(chain) }
+        var params = VCChainParams()
+        vc_chain_params_default(&params)
+        params.convolutionMix = 0.5
+        vc_chain_set_params(chain, &params)
+
+        // 壊れた IR（NaN を含む）の畳み込みは毎ブロック壊れるので、そのたびにリセットして無音にする
+        var ir = [Float](repeating: 0, count: 512)
+        ir[0] = 1
+        ir[100] = .nan
+        let broken = vc_convolver_create(ir, Int32(ir.count), 0)!
+        defer { vc_convolver_destroy(broken) }
+        vc_chain_set_convolver(chain, broken)
+        for block in 0..<3 {
+            var samples = tone(256, phase: block * 256)
+            process(chain, &samples)
+            XCTAssertTrue(samples.allSatisfy { $0 == 0 }, "block \(block)")
+        }
+        var stats = VCSignalGuardStats()
+        vc_chain_get_signal_guard_stats(chain, &stats)
+        XCTAssertEqual(moduleResets(stats, VC_CHAIN_MODULE_CONVOLVER), 3)
+        XCTAssertEqual(moduleResets(stats, VC_CHAIN_MODULE_HPF), 0)
+        XCTAssertEqual(stats.resets, 3)
+
+        // 直した IR に差し替えると、次のブロックは 0 からフェードインして戻る
+        ir[100] = 0
+        let fixed = vc_convolver_create(ir, Int32(ir.count), 0)!
+        defer { vc_convolver_destroy(fixed) }
+        vc_chain_set_convolver(chain, fixed)
+        var samples = tone(512, phase: 3 * 256)
+        process(chain, &samples)
+        XCTAssertTrue(samples.allSatisfy(\.isFinite))
+        XCTAssertLessThan(abs(samples[1]), 0.01)
+        XCTAssertGreaterThan(samples[300...].map(abs).max()!, 0.05)
+    }
+
+    func testDisabledGuardLeavesCountersUntouched() {
+        let chain = vc_chain_create(48000)!
+        defer { vc_chain_destroy(chain) }
+        vc_chain_set_signal_guard(chain, 0)
+
+        var samples = tone(256)
+        process(chain, &samples)
+        var stats = VCSignalGuardStats()
+        vc_chain_get_signal_guard_stats(chain, &stats)
+        XCTAssertEqual(stats.blocks, 0)
+    }
+}
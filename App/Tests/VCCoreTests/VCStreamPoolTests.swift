@@ -0,0 +1,86 @@
+import XCTest
+import VCCore
+
+final class VCStreamPoolTests: XCTestCase {
+
+    private let blockSize = 256
+    private let blocksPerStream = 64
+
+    private func makeInput(stream: Int) -> [Float] {
+        (0..<(blockSize * blocksPerStream)).map { i in
+            0.5 * sin(Float(i) * Float(stream + 1) * 0.01)
+        }
+    }
+
+    private func makeChain(stream: Int) -> OpaquePointer {
+        let chain = vc_chain_create(48000)!
+        var params = VCChainParams()
+        vc_chain_params_default(&params)
+        params.eqLow = Float(stream % 4)
+        vc_chain_set_params(chain, &params)
+        return chain
+    }
+
+    /// 並列処理結果がストリームごとの逐次処理と一致する（ブロック順序が保たれる）
+    func testParallelMatchesSequential() {
+        let streamCount = 8
+
+        var expected: [[Float]] = []
+        for s in 0..<streamCount {
+            let chain = makeChain(stream: s)
+            var samples = makeInput(stream: s)
+            samples.withUnsafeMutableBufferPointer { buffer in
+                for b in 0..<blocksPerStream {
+                    let block = buffer.baseAddress! + b * blockSize
+                    vc_chain_process(chain, block, block, Int32(blockSize))
+                }
+            }
+            expected.append(samples)
+            vc_chain_destroy(chain)
+        }
+
+        let pool = vc_stream_pool_create(4)!
+        let chains = (0..<streamCount).map { makeChain(stream: $0) }
+        for chain in chains {
+            XCTAssertGreaterThanOrEqual(vc_stream_pool_add_stream(pool, chain, 8), 0)
+        }
+
+        let total = blockSize * blocksPerStream
+        let buffers = (0..<streamCount).map { s -> UnsafeMutablePointer<Float> in
+            let pointer = UnsafeMutablePointer<Float>.allocate(capacity: total)
+            pointer.initialize(from: makeInput(stream: s), count: total)
+            return pointer
+        }
+
+        for b in 0..<blocksPerStream {
+            for s in 0..<streamCount {
+                let block = buffers[s] + b * blockSize
+                while vc_stream_pool_submit(pool, Int32(s), block, block, Int32(blockSize)) != 0 {
+                    vc_stream_pool_wait(pool)
+                }
+            }
+        }
+        vc_stream_pool_wait(pool)
+
+        var stats = VCStreamPoolStats()
+        vc_stream_pool_get_stats(pool, &stats)
+        XCTAssertEqual(stats.blocksProcessed, UInt64(streamCount * blocksPerStream))
+
+        for s in 0..<streamCount {
+            XCTAssertEqual(Array(UnsafeBufferPointer(start: buffers[s], count: total)), expected[s])
+            buffers[s].deallocate()
+        }
+
+        vc_stream_pool_destroy(pool)
+        chains.forEach { vc_chain_destroy($0) }
+    }
+
+    func testSubmitRejectsUnknownStream() {
+        let pool = vc_stream_pool_create(1)!
+        defer { vc_stream_pool_destroy(pool) }
+
+        let input = [Float](repeating: 0, count: blockSize)
+        var output = [Float](repeating: 0, count: blockSize)
+        XCTAssertEqual(vc_stream_pool_submit(pool, 0, input, &output, Int32(blockSize)), -1)
+    }
+}
@@ -0,0 +1,123 @@
+import XCTest
+import VCCore
+
+final class VCTapRecorderTests: XCTestCase {
+
+    private var directory: URL!
+
+    override func setUp() {
+        directory = FileManager.default.temporaryDirectory.appendingPathComponent("vc-taps-\(UUID().uuidString)")
+        try? FileManager.default.createDirectory(at: directory, withIntermediateDirectories: true)
+    }
+
+    override func tearDown() {
+        try? FileManager.default.removeItem(at: directory)
+    }
+
+    private func start(_ recorder: OpaquePointer, files: [String?], format: VCTapFormat) -> Int32 {
+        let paths = files.map { $0.map { strdup(directory.appendingPathComponent($0).path)! } }
+        defer { paths.forEach { free($0) } }
+        return vc_tap_recorder_start(recorder, paths.map { $0.map { UnsafePointer($0) } }, format)
+    }
+
+    private func readUInt32(_ data: Data, _ offset: Int) -> UInt32 {
+        data[offset..<offset + 4].enumerated().reduce(0) { $0 | UInt32($1.element) << (8 * $1.offset) }
+    }
+
+    func testWritesFloatWavWithFinalHeader() throws {
+        let recorder = vc_tap_recorder_create(48000, 5)!
+        defer { vc_tap_recorder_destroy(recorder) }
+        XCTAssertEqual(vc_tap_recorder_add(recorder, 4096), 0)
+
+        // 録音前の push は何もしない
+        var block = [Float](repeating: 0, count: 256)
+        XCTAssertEqual(vc_tap_recorder_push(recorder, 0, block, 256), 0)
+
+        XCTAssertEqual(start(recorder, files: ["tap.wav"], format: VC_TAP_FORMAT_WAV), 0)
+        XCTAssertEqual(vc_tap_recorder_is_recording(recorder), 1)
+        for b in 0..<100 {
+            for i in 0..<256 {
+                block[i] = Float(b * 256 + i)
+            }
+            XCTAssertEqual(vc_tap_recorder_push(recorder, 0, block, 256), 256)
+            usleep(1000)
+        }
+        vc_tap_recorder_stop(recorder)
+        XCTAssertEqual(vc_tap_recorder_is_recording(recorder), 0)
+
+        var stats = VCTapStats()
+        vc_tap_recorder_get_stats(recorder, 0, &stats)
+        XCTAssertEqual(stats.framesWritten, 25600)
+        XCTAssertEqual(stats.droppedFrames, 0)
+
+        // RIFF / WAVE、IEEE float モノラル、data の長さ、中身
+        let data = try Data(contentsOf: directory.appendingPathComponent("tap.wav"))
+        XCTAssertEqual(data.count, 92 + 25600 * 4)
+        XCTAssertEqual(String(decoding: data[0..<4], as: UTF8.self), "RIFF")
+        XCTAssertEqual(readUInt32(data, 4), UInt32(data.count - 8))
+        XCTAssertEqual(String(decoding: data[8..<12], as: UTF8.self), "WAVE")
+        XCTAssertEqual(String(decoding: data[48..<52], as: UTF8.self), "fmt ")
+        XCTAssertEqual(readUInt32(data, 56) & 0xFFFF, 3)
+        XCTAssertEqual(readUInt32(data, 60), 48000)
+        XCTAssertEqual(String(decoding: data[84..<88], as: UTF8.self), "data")
+        XCTAssertEqual(readUInt32(data, 88), 25600 * 4)
+        let samples = data[92...].withUnsafeBytes { Array($0.bindMemory(to: Float.self)) }
+        XCTAssertEqual(samples, (0..<25600).map { Float($0) })
+    }
+
+    func testCountsOverflowWhenWriterFallsBehind() throws {
+        // 読み出し間隔より短いリングへ一度に書くと溢れる（入りきらないブロックは数えて捨てる）
+        let recorder = vc_tap_recorder_create(48000, 1000)!
+        defer { vc_tap_recorder_destroy(recorder) }
+        XCTAssertEqual(vc_tap_recorder_add(recorder, 1024), 0)
+        XCTAssertEqual(start(recorder, files: ["tap.f32"], format: VC_TAP_FORMAT_RAW), 0)
+
+        let block = [Float](repeating: 0.5, count: 256)
+        var accepted = 0
+        for _ in 0..<8 {
+            accepted += Int(vc_tap_recorder_push(recorder, 0, block, 256))
+        }
+        vc_tap_recorder_stop(recorder)
+
+        var stats = VCTapStats()
+        vc_tap_recorder_get_stats(recorder, 0, &stats)
+        XCTAssertEqual(accepted, 1024)
+        XCTAssertEqual(stats.droppedFrames, 1024)
+        XCTAssertEqual(stats.overflows, 4)
+        XCTAssertEqual(stats.framesWritten, 1024)
+
+        // RAW はヘッダーなし
+        let data = try Data(contentsOf: directory.appendingPathComponent("tap.f32"))
+        XCTAssertEqual(data.count, 1024 * 4)
+    }
+
+    func testDrainsExternalRingAndSkipsUnusedTaps() throws {
+        let recorder = vc_tap_recorder_create(48000, 5)!
+        let source = vc_audio_ring_create(8192)!
+        defer {
+            vc_tap_recorder_destroy(recorder)
+            vc_audio_ring_destroy(source)
+        }
+        XCTAssertEqual(vc_tap_recorder_add(recorder, 4096), 0)
+        XCTAssertEqual(vc_tap_recorder_add_ring(recorder, vc_audio_ring_view(source)), 1)
+        XCTAssertEqual(vc_tap_recorder_count(recorder), 2)
+
+        // 録音前に溜まっていた分は捨てる
+        let stale = [Float](repeating: 9, count: 512)
+        vc_audio_ring_write(source, stale, 512)
+
+        XCTAssertEqual(start(recorder, files: [nil, "external.wav"], format: VC_TAP_FORMAT_WAV), 0)
+        let block = [Float](repeating: 0.25, count: 480)
+        XCTAssertEqual(vc_tap_recorder_push(recorder, 0, block, 480), 0)
+        XCTAssertEqual(vc_audio_ring_write(source, block, 480), 480)
+        vc_tap_recorder_stop(recorder)
+
+        var stats = VCTapStats()
+        vc_tap_recorder_get_stats(recorder, 1, &stats)
+        XCTAssertEqual(stats.framesWritten, 480)
+        let data = try Data(contentsOf: directory.appendingPathComponent("external.wav"))
+        let samples = data[92...].withUnsafeBytes { Array($0.bindMemory(to: Float.self)) }
+        XCTAssertEqual(samples, block)
+        XCTAssertFalse(FileManager.default.fileExists(atPath: directory.appendingPathComponent("tap.wav").path))
+    }
+}
@@ -0,0 +1,96 @@
+import XCTest
+import VCCore
+
+final class VCVadTests: XCTestCase {
+
+    private let sampleRate = 48000
+    private let blockSize = 256
+
+    private func noise(count: Int, amplitude: Float, seed: inout UInt32) -> [Float] {
+        (0..<count).map { _ in
+            seed = seed &* 1664525 &+ 1013904223
+            return (Float(seed >> 8) / 16777216 - 0.5) * 2 * amplitude
+        }
+    }
+
+    /// 基音 + 倍音（有声音相当）+ 背景雑音
+    private func voiced(count: Int, f0: Float, seed: inout UInt32) -> [Float] {
+        let background = noise(count: count, amplitude: 0.003, seed: &seed)
+        return (0..<count).map { i in
+            let phase = 2 * Float.pi * f0 * Float(i) / Float(sampleRate)
+            var sample: Float = 0
+            for harmonic in 1...6 {
+                sample += sin(phase * Float(harmonic)) / Float(harmonic)
+            }
+            return 0.2 * sample + background[i]
+        }
+    }
+
+    private func process(_ vad: OpaquePointer, _ samples: [Float]) -> [VCVadState] {
+        var states: [VCVadState] = []
+        for offset in stride(from: 0, to: samples.count - blockSize + 1, by: blockSize) {
+            samples.withUnsafeBufferPointer { buffer in
+                _ = vc_vad_process(vad, buffer.baseAddress! + offset, Int32(blockSize))
+            }
+            var state = VCVadState()
+            vc_vad_get_state(vad, &state)
+            states.append(state)
+        }
+        return states
+    }
+
+    // MARK: - Detection
+
+    func testNoiseIsNotSpeechAndVoiceIs() {
+        let vad = vc_vad_create(Int32(sampleRate))!
+        defer { vc_vad_destroy(vad) }
+        var seed: UInt32 = 1
+
+        // 背景雑音 1 秒でフロアを学習 → 平坦度 0.56 前後の広帯域ノイズ（-30dBFS）は発話にしない
+        let floor = process(vad, noise(count: sampleRate, amplitude: 0.003, seed: &seed))
+        XCTAssertTrue(floor.allSatisfy { $0.rawSpeech == 0 })
+        let burst = process(vad, noise(count: sampleRate / 10, amplitude: 0.05, seed: &seed))
+        XCTAssertTrue(burst.allSatisfy { $0.rawSpeech == 0 })
+        XCTAssertGreaterThan(burst.last!.flatness, 0.4)
+
+        let voice = process(vad, voiced(count: sampleRate / 2, f0: 140, seed: &seed))
+        XCTAssertTrue(voice.dropFirst().allSatisfy { $0.speech == 1 })
+        XCTAssertLessThan(voice.last!.flatness, 0.35)
+    }
+
+    func testHangoverThenSmoothFade() {
+        let vad = vc_vad_create(Int32(sampleRate))!
+        defer { vc_vad_destroy(vad) }
+        var seed: UInt32 = 2
+
+        _ = process(vad, noise(count: sampleRate, amplitude: 0.003, seed: &seed))
+        _ = process(vad, voiced(count: sampleRate / 2, f0: 200, seed: &seed))
+        let tail = process(vad, noise(count: sampleRate, amplitude: 0.003, seed: &seed))
+
+        // 200ms は発話扱いのまま、その後 activity は段差なく 0 まで下がる
+        let hangoverBlocks = 200 * sampleRate / 1000 / blockSize
+        XCTAssertTrue(tail.prefix(hangoverBlocks - 1).allSatisfy { $0.speech == 1 && $0.activity == 1 })
+        XCTAssertEqual(tail.last!.speech, 0)
+        XCTAssertEqual(tail.last!.activity, 0)
+        for (previous, next) in zip(tail, tail.dropFirst()) {
+            XCTAssertLessThanOrEqual(next.activity, previous.activity)
+            XCTAssertLessThan(previous.activity - next.activity, 0.2)
+        }
+    }
+
+    // MARK: - AGC
+
+    func testAgcHoldsGainWhileInactive() {
+        var agc = VCAgc()
+        vc_agc_init(&agc)
+        let gain = vc_agc_update_gain(&agc, 0.1)
+
+        vc_agc_set_voice_activity(&agc, 0)
+        for _ in 0..<100 {
+            XCTAssertEqual(vc_agc_update_gain(&agc, 0.001), gain)
+        }
+
+        vc_agc_set_voice_activity(&agc, 1)
+        XCTAssertGreaterThan(vc_agc_update_gain(&agc, 0.001), gain)
+    }
+}
@@ -0,0 +1,152 @@
+import XCTest
+import VCCore
+
+final class VCVoiceConverterTests: XCTestCase {
+
+    private var modelPath = ""
+    private var model: OpaquePointer!
+
+    /// 小さい乱数のモデル（64 チャンネル × 4 層、GRU 64、hop 128）
+    override func setUpWithError() throws {
+        var config = VCVoiceModelConfig()
+        vc_voice_model_config_default(&config)
+        config.channels = 64
+        config.convLayers = 4
+        config.hiddenSize = 64
+        modelPath = FileManager.default.temporaryDirectory
+            .appendingPathComponent("vc-voice-\(UUID().uuidString).vcvm").path
+        XCTAssertEqual(vc_voice_model_write_random(modelPath, &config, 7), 0)
+        model = try XCTUnwrap(vc_voice_model_open(modelPath))
+    }
+
+    override func tearDown() {
+        vc_voice_model_close(model)
+        try? FileManager.default.removeItem(atPath: modelPath)
+    }
+
+    private func signal(count: Int) -> [Float] {
+        (0..<count).map { 0.3 * sinf(0.03 * Float($0)) + 0.01 * sinf(1.7 * Float($0)) }
+    }
+
+    private func makeConverter(lookAhead: Int32 = 0, scalar: Bool = false) -> OpaquePointer {
+        var options = VCVoiceConverterOptions(lookAheadFrames: lookAhead, scalarKernels: scalar ? 1 : 0)
+        return vc_voice_converter_create(model, &options)!
+    }
+
+    private func process(_ converter: OpaquePointer, _ input: [Float], blockSize: Int,
+                         pauseMicroseconds: UInt32 = 0) -> [Float] {
+        var output = [Float](repeating: 0, count: input.count)
+        input.withUnsafeBufferPointer { source in
+            output.withUnsafeMutableBufferPointer { destination in
+                for offset in stride(from: 0, to: input.count, by: blockSize) {
+                    XCTAssertEqual(vc_voice_converter_process(converter, source.baseAddress! + offset,
+                                                              destination.baseAddress! + offset, Int32(blockSize)), 0)
+                    if pauseMicroseconds > 0 {
+                        usleep(pauseMicroseconds)
+                    }
+                }
+            }
+        }
+        return output
+    }
+
+    // MARK: - Model
+
+    func testModelRoundTripsConfigAndRejectsCorruption() throws {
+        var config = VCVoiceModelConfig()
+        vc_voice_model_get_config(model, &config)
+        XCTAssertEqual(config.hop, 128)
+        XCTAssertEqual(config.channels, 64)
+        XCTAssertEqual(vc_voice_model_layer_count(&config), 8)
+        XCTAssertGreaterThan(vc_voice_model_macs_per_frame(model), 0)
+        XCTAssertGreaterThan(vc_voice_model_weight_bytes(model), 0)
+
+        // 範囲外の構成は書かない。1 バイト壊れたファイル・存在しないファイルは開かない
+        var invalid = config
+        invalid.channels = 40
+        XCTAssertEqual(vc_voice_model_write_random(modelPath + ".invalid", &invalid, 1), -1)
+        let handle = try XCTUnwrap(FileHandle(forUpdatingAtPath: modelPath))
+        handle.seek(toFileOffset: 5000)
+        handle.write(Data([0x55]))
+        handle.closeFile()
+        XCTAssertNil(vc_voice_model_open(modelPath))
+        XCTAssertNil(vc_voice_model_open("/nonexistent/model.vcvm"))
+    }
+
+    // MARK: - Streaming
+
+    func testOutputDoesNotDependOnBlockSizeOrKernels() {
+        let input = signal(count: 128 * 9 * 20)
+        let simd = makeConverter()
+        let scalar = makeConverter(scalar: true)
+        defer {
+            vc_voice_converter_destroy(simd)
+            vc_voice_converter_destroy(scalar)
+        }
+        let reference = process(simd, input, blockSize: 128)
+        XCTAssertTrue(reference.allSatisfy(\.isFinite))
+        XCTAssertGreaterThan(reference.map(abs).max() ?? 0, 0)
+
+        // 状態を持ち回るので、ブロックの切り方や SIMD / スカラーによらずビット単位で同じ
+        XCTAssertEqual(process(scalar, input, blockSize: 1152), reference)
+        vc_voice_converter_reset(simd)
+        XCTAssertEqual(process(simd, input, blockSize: 384), reference)
+
+        var output = [Float](repeating: 0, count: 100)
+        XCTAssertEqual(vc_voice_converter_process(simd, input, &output, 100), -1)
+    }
+
+    func testMixZeroPassesDryDelayedByHop() {
+        let input = signal(count: 4096)
+        let converter = makeConverter()
+        defer { vc_voice_converter_destroy(converter) }
+        vc_voice_converter_set_mix(converter, 0)
+        XCTAssertEqual(vc_voice_converter_latency(converter), 128)
+        let output = process(converter, input, blockSize: 256)
+        XCTAssertEqual(Array(output[128...]), Array(input[..<(input.count - 128)]))
+    }
+
+    func testWorkerMatchesInlineOutputDelayedByLookAhead() {
+        let input = signal(count: 256 * 60)
+        let inline = makeConverter()
+        let worker = makeConverter(lookAhead: 4)
+        defer {
+            vc_voice_converter_destroy(inline)
+            vc_voice_converter_destroy(worker)
+        }
+        XCTAssertEqual(vc_voice_converter_latency(worker), 128 * 5)
+        let reference = process(inline, input, blockSize: 256)
+        // ブロック周期（5.3ms）より短い間隔でも、補助スレッドが十分先に計算を終えていれば遅れは出ない
+        let output = process(worker, input, blockSize: 256, pauseMicroseconds: 2000)
+
+        var stats = VCVoiceConverterStats()
+        vc_voice_converter_get_stats(worker, &stats)
+        XCTAssertEqual(stats.frames, UInt64(input.count / 128))
+        if stats.lateFrames == 0 {
+            XCTAssertEqual(Array(output[512...]), Array(reference[..<(input.count - 512)]))
+        }
+        XCTAssertTrue(output.allSatisfy(\.isFinite))
+    }
+
+    func testChainAddsConverterLatency() {
+        let chain = vc_chain_create(48000)!
+        let converter = makeConverter()
+        defer {
+            vc_chain_destroy(chain)
+            vc_voice_converter_destroy(converter)
+        }
+        let base = vc_chain_latency(chain)
+        vc_chain_set_voice_converter(chain, converter)
+        XCTAssertEqual(vc_chain_latency(chain), base + 128)
+
+        var output = [Float](repeating: 0, count: 256)
+        vc_chain_process(chain, signal(count: 256), &output, 256)
+        XCTAssertTrue(output.allSatisfy(\.isFinite))
+        var stats = VCVoiceConverterStats()
+        vc_voice_converter_get_stats(converter, &stats)
+        XCTAssertEqual(stats.frames, 2)
+
+        vc_chain_set_voice_converter(chain, nil)
+        XCTAssertEqual(vc_chain_latency(chain), base)
+    }
+}
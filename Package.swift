@@ -12,6 +12,8 @@ let package = Package(
         .executable(name: "VoiceChanger", targets: ["VoiceChangerApp"]),
         .library(name: "AudioEngine", targets: ["AudioEngine"]),
         .library(name: "DSP", targets: ["DSP"]),
+        .executable(name: "VCBench", targets: ["VCBench"]),
+        .executable(name: "VCReplay", targets: ["VCReplay"]),
     ],
     dependencies: [
         // 将来的に追加予定
@@ -28,17 +30,28 @@ let package = Package(
         // オーディオエンジン
         .target(
             name: "AudioEngine",
-            dependencies: ["DSP", "Utilities", "CHelpers"],
+            dependencies: ["DSP", "Utilities", "CHelpers", "VCCore"],
             path: "App/Sources/Audio"
         ),
 
         // DSP処理
         .target(
             name: "DSP",
-            dependencies: ["Utilities"],
+            dependencies: ["Utilities", "VCCore"],
             path: "App/Sources/DSP"
         ),
 
+        // ポータブルCコア（DSPカーネル/ストリーム処理、Linuxでもビルド可）
+        .target(
+            name: "VCCore",
+            path: "App/Sources/VCCore",
+            publicHeadersPath: "include",
+            linkerSettings: [
+                .linkedLibrary("pthread", .when(platforms: [.linux])),
+                .linkedLibrary("m", .when(platforms: [.linux])),
+            ]
+        ),
+
         // UI（SwiftUI）
         .target(
             name: "UI",
@@ -62,7 +75,7 @@ let package = Package(
         // ユーティリティ
         .target(
             name: "Utilities",
-            dependencies: ["CHelpers"],
+            dependencies: ["CHelpers", "VCCore"],
             path: "App/Sources/Utilities"
         ),
 
@@ -77,5 +90,34 @@ let package = Package(
             dependencies: ["AudioEngine"],
             path: "App/Tests/AudioEngineTests"
         ),
+        .testTarget(
+            name: "VCCoreTests",
+            dependencies: ["VCCore"],
+            path: "App/Tests/VCCoreTests"
+        ),
+
+        // ベンチマーク（swift run -c release VCBench）
+        .executableTarget(
+            name: "VCBench",
+            dependencies: ["VCCore"],
+            path: "App/Benchmarks/VCBench"
+        ),
+
+        // IO トレースのリプレイ（swift run -c release VCReplay iotrace-*.vctrace）
+        .executableTarget(
+            name: "VCReplay",
+            dependencies: ["VCCore"],
+            path: "App/Tools/VCReplay"
+        ),
     ]
 )
+
+// Linux では Apple フレームワークに依存しないポータブルコアのみビルドする
+#if os(Linux)
+let portableTargets: Set<String> = ["VCCore", "VCCoreTests", "VCBench", "VCReplay"]
+package.targets = package.targets.filter { portableTargets.contains($0.name) }
+package.products = [
+    .executable(name: "VCBench", targets: ["VCBench"]),
+    .executable(name: "VCReplay", targets: ["VCReplay"]),
+]
+#endif
@@ -10,6 +10,7 @@ SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 PROJECT_ROOT="$(dirname "$SCRIPT_DIR")"
 DRIVER_DIR="$PROJECT_ROOT/VirtualMicDriver"
 BUILD_DIR="$PROJECT_ROOT/build/driver"
+CORE_DIR="$PROJECT_ROOT/App/Sources/VCCore"
 DRIVER_NAME="VirtualMicDriver.driver"
 
 # カラー出力
@@ -39,6 +40,11 @@ echo_info "Building Virtual Mic Driver..."
 SOURCES=(
     "$DRIVER_DIR/Sources/VirtualMicDriver.c"
     "$DRIVER_DIR/Sources/VirtualMicProperties.c"
+    "$CORE_DIR/VCDriverIO.c"
+    "$CORE_DIR/VCIOTrace.c"
+    "$CORE_DIR/VCLog.c"
+    "$CORE_DIR/VCSharedRing.c"
+    "$CORE_DIR/VCVirtualMic.c"
 )
 
 # コンパイラフラグ
@@ -51,6 +57,7 @@ CFLAGS=(
     -Wextra
     -fvisibility=hidden
     -I"$DRIVER_DIR/Sources"
+    -I"$CORE_DIR/include"
 )
 
 # リンカフラグ
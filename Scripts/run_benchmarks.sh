@@ -0,0 +1,101 @@
+#!/bin/bash
+#
+# run_benchmarks.sh
+# ベンチマークスイート（VCBench --suite）を実行し、保存済みのベースラインと比べる
+# macOS / Linux どちらでも、画面なしで動く（CI 用）
+#
+# ベースラインは App/Benchmarks/Baselines/<OS>-<arch>.json。比べるのは同じマシンで取ったものだけにすること
+#
+
+set -e
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$(dirname "$SCRIPT_DIR")"
+BUILD_DIR="$PROJECT_ROOT/build/bench"
+BASELINE_DIR="$PROJECT_ROOT/App/Benchmarks/Baselines"
+
+# カラー出力
+RED='\033[0;31m'
+GREEN='\033[0;32m'
+YELLOW='\033[1;33m'
+NC='\033[0m' # No Color
+
+echo_info() {
+    echo -e "${GREEN}[INFO]${NC} $1"
+}
+
+echo_warn() {
+    echo -e "${YELLOW}[WARN]${NC} $1"
+}
+
+echo_error() {
+    echo -e "${RED}[ERROR]${NC} $1"
+}
+
+# 引数パース（残りはケース名のフィルターとして VCBench に渡す）
+UPDATE=0
+TOLERANCE="0.25"
+QUICK=""
+FILTERS=()
+while [[ $# -gt 0 ]]; do
+    case $1 in
+        --update)
+            UPDATE=1
+            shift
+            ;;
+        --tolerance)
+            TOLERANCE="$2"
+            shift 2
+            ;;
+        --quick)
+            QUICK="--quick"
+            shift
+            ;;
+        -*)
+            echo_error "Unknown option: $1"
+            echo "Usage: $0 [--update] [--quick] [--tolerance 0.25] [filter ...]"
+            exit 1
+            ;;
+        *)
+            FILTERS+=("$1")
+            shift
+            ;;
+    esac
+done
+
+PLATFORM="$(uname -s | tr '[:upper:]' '[:lower:]')-$(uname -m)"
+BASELINE="$BASELINE_DIR/$PLATFORM.json"
+RESULT="$BUILD_DIR/bench-$(date +%Y%m%d-%H%M%S).json"
+
+cd "$PROJECT_ROOT"
+
+echo_info "Building VCBench (release)..."
+swift build -c release --product VCBench --build-path "$BUILD_DIR"
+
+mkdir -p "$BUILD_DIR"
+if [ "$UPDATE" = "1" ]; then
+    echo_info "Recording baseline: $BASELINE"
+    mkdir -p "$BASELINE_DIR"
+    "$BUILD_DIR/release/VCBench" --suite $QUICK --json "$BASELINE" "${FILTERS[@]}"
+    exit 0
+fi
+
+if [ ! -f "$BASELINE" ]; then
+    echo_warn "No baseline for $PLATFORM (record one with --update)"
+    "$BUILD_DIR/release/VCBench" --suite $QUICK --json "$RESULT" "${FILTERS[@]}"
+    echo_info "Results: $RESULT"
+    exit 0
+fi
+
+set +e
+"$BUILD_DIR/release/VCBench" --suite $QUICK --json "$RESULT" --baseline "$BASELINE" --tolerance "$TOLERANCE" "${FILTERS[@]}"
+STATUS=$?
+set -e
+
+echo_info "Results: $RESULT"
+if [ $STATUS -eq 4 ]; then
+    echo_error "Performance regression against $BASELINE"
+elif [ $STATUS -ne 0 ]; then
+    echo_error "VCBench failed ($STATUS)"
+fi
+exit $STATUS
@@ -7,7 +7,9 @@
 
 #include "VirtualMicDriver.h"
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <fcntl.h>
+#include <stdio.h>
 #include <unistd.h>
 #include <pthread.h>
 #include <os/log.h>
@@ -23,6 +25,15 @@ static os_log_t gLog = NULL;
 #define LOG_INFO(fmt, ...)  os_log_info(gLog, fmt, ##__VA_ARGS__)
 #define LOG_ERROR(fmt, ...) os_log_error(gLog, fmt, ##__VA_ARGS__)
 
+// IO スレッド用（wait-free、文字列整形はドレインスレッドで行う）
+// リングはデバイスごと（IO スレッドごと）に分ける。書き込み側が複数になると末尾の更新が競合する
+#define LOG_RT(io, event, arg0, arg1) \
+    do { \
+        if ((io)->logRing != NULL) { \
+            vc_log_ring_write((io)->logRing, (event), VCLogLevelDebug, 2, (arg0), (arg1), 0, 0); \
+        } \
+    } while (0)
+
 // Forward declarations for static functions
 static HRESULT VirtualMic_QueryInterface(void* inDriver, REFIID inUUID, LPVOID* outInterface);
 static ULONG VirtualMic_AddRef(void* inDriver);
@@ -46,8 +57,22 @@ static OSStatus VirtualMic_WillDoIOOperation(AudioServerPlugInDriverRef inDriver
 static OSStatus VirtualMic_BeginIOOperation(AudioServerPlugInDriverRef inDriver, AudioObjectID inDeviceObjectID, UInt32 inClientID, UInt32 inOperationID, UInt32 inIOBufferFrameSize, const AudioServerPlugInIOCycleInfo* inIOCycleInfo);
 static OSStatus VirtualMic_DoIOOperation(AudioServerPlugInDriverRef inDriver, AudioObjectID inDeviceObjectID, AudioObjectID inStreamObjectID, UInt32 inClientID, UInt32 inOperationID, UInt32 inIOBufferFrameSize, const AudioServerPlugInIOCycleInfo* inIOCycleInfo, void* ioMainBuffer, void* ioSecondaryBuffer);
 static OSStatus VirtualMic_EndIOOperation(AudioServerPlugInDriverRef inDriver, AudioObjectID inDeviceObjectID, UInt32 inClientID, UInt32 inOperationID, UInt32 inIOBufferFrameSize, const AudioServerPlugInIOCycleInfo* inIOCycleInfo);
-static OSStatus SharedMemory_Open(VirtualMicDriverState* state);
-static void SharedMemory_Close(VirtualMicDriverState* state);
+static void Device_InitState(DeviceIOState* io, AudioObjectID deviceID, AudioObjectID streamID, bool isInput, int micIndex, const char* memoryName);
+static VCDriverReadResult Mic_ReadInput(DeviceIOState* io, Float32* outputBuffer, UInt32 frameCount, UInt64 now, Float64 inputSampleTime);
+static void Tap_WriteDelivered(const Float32* buffer, UInt32 frameCount);
+static void Trace_Write(const DeviceIOState* io, const VCIOTraceRecord* record);
+static void Speaker_WriteMix(DeviceIOState* io, const Float32* mixBuffer, UInt32 frameCount);
+static void SharedMemory_InitLink(SharedMemoryLink* link, const char* name);
+static OSStatus SharedMemory_Open(const char* name, SharedMemoryMapping* memory);
+static void SharedMemory_Close(SharedMemoryMapping* memory);
+static SharedMemoryMapping* SharedMemory_Acquire(SharedMemoryLink* link);
+static void SharedMemory_Request(SharedMemoryLink* link, unsigned int request);
+static void SharedMemory_Maintain(SharedMemoryLink* link, UInt64 now);
+static void SharedMemory_StartRemap(VirtualMicDriverState* state);
+static void* SharedMemory_RemapThread(void* arg);
+static void DriverLog_Start(VirtualMicDriverState* state);
+static void DriverLog_Drain(DeviceIOState* io);
+static void* DriverLog_DrainThread(void* arg);
 
 #pragma mark - Driver Interface
 
@@ -151,22 +176,109 @@ static OSStatus VirtualMic_Initialize(AudioServerPlugInDriverRef inDriver, Audio
     mach_timebase_info(&timebaseInfo);
     Float64 hostTicksPerSecond = (Float64)timebaseInfo.denom * 1000000000.0 / (Float64)timebaseInfo.numer;
     gDriverState.hostTicksPerFrame = hostTicksPerSecond / kSampleRate;
-
-    // 初期値設定
-    gDriverState.inputVolumeScalar = 1.0f;
-    gDriverState.inputMute = false;
-    gDriverState.anchorHostTime = mach_absolute_time();
+    gDriverState.heartbeatTimeoutTicks = (UInt64)(hostTicksPerSecond * kHeartbeatTimeoutMs / 1000.0);
+    gDriverState.remapRetryTicks = (UInt64)(hostTicksPerSecond * kRemapRetryIntervalMs / 1000.0);
+
+    // 初期値設定（仮想マイクごとに別の共有メモリ）
+    for (int mic = 0; mic < kMicDeviceCount; mic++) {
+        char memoryName[VC_VIRTUAL_MIC_MEMORY_NAME_MAX];
+        vc_virtual_mic_memory_name(mic, memoryName, sizeof(memoryName));
+        Device_InitState(&gDriverState.mics[mic],
+                         vc_virtual_mic_object_id(mic, VC_VIRTUAL_MIC_DEVICE),
+                         vc_virtual_mic_object_id(mic, VC_VIRTUAL_MIC_STREAM),
+                         true, mic, memoryName);
+    }
+    Device_InitState(&gDriverState.speaker, kObjectID_Device_Speaker, kObjectID_Stream_Output, false, -1, kSpeakerMemoryName);
+    SharedMemory_InitLink(&gDriverState.tap, kTapMemoryName);
+    SharedMemory_InitLink(&gDriverState.trace, kTraceMemoryName);
 
     // mutex初期化
     pthread_mutex_init(&gDriverState.stateMutex, NULL);
     pthread_mutex_init(&gDriverState.ioMutex, NULL);
 
-    // 共有メモリを開く（存在しなければNULLのまま）
-    SharedMemory_Open(&gDriverState);
+    // RTログ
+    DriverLog_Start(&gDriverState);
+
+    // 共有メモリを開く（存在しなければ未接続のまま。アプリが使わないマイクは無音）
+    for (int mic = 0; mic < kMicDeviceCount; mic++) {
+        SharedMemoryLink* link = &gDriverState.mics[mic].memory;
+        SharedMemory_Open(link->name, atomic_load(&link->current));
+    }
+    SharedMemory_Open(gDriverState.speaker.memory.name, atomic_load(&gDriverState.speaker.memory.current));
+    SharedMemory_Open(gDriverState.tap.name, atomic_load(&gDriverState.tap.current));
+    SharedMemory_Open(gDriverState.trace.name, atomic_load(&gDriverState.trace.current));
+
+    // 後から起動したアプリ・作り直された区画への接続は保守スレッドで行う
+    SharedMemory_StartRemap(&gDriverState);
 
     return noErr;
 }
 
+static void Device_InitState(DeviceIOState* io, AudioObjectID deviceID, AudioObjectID streamID, bool isInput, int micIndex, const char* memoryName) {
+    io->deviceID = deviceID;
+    io->streamID = streamID;
+    io->isInput = isInput;
+    io->micIndex = micIndex;
+    atomic_store(&io->volumeScalar, 1.0f);
+    atomic_store(&io->mute, false);
+    atomic_store(&io->isIORunning, false);
+    io->ioClientCount = 0;
+    io->anchorHostTime = mach_absolute_time();
+    SharedMemory_InitLink(&io->memory, memoryName);
+    io->peerActive = 0;
+    io->logRing = NULL;
+    io->reportedLogDrops = 0;
+}
+
+VirtualMicObjectKind VirtualMic_ObjectKind(AudioObjectID inObjectID) {
+    switch (inObjectID) {
+        case kObjectID_PlugIn:
+            return kObjectKind_PlugIn;
+        case kObjectID_Device_Speaker:
+            return kObjectKind_Device;
+        case kObjectID_Stream_Output:
+            return kObjectKind_Stream;
+    }
+
+    VCVirtualMicObject object;
+    int mic = vc_virtual_mic_index(inObjectID, &object);
+    if (mic < 0 || mic >= kMicDeviceCount) {
+        return kObjectKind_Unknown;
+    }
+    switch (object) {
+        case VC_VIRTUAL_MIC_DEVICE:
+            return kObjectKind_Device;
+        case VC_VIRTUAL_MIC_STREAM:
+            return kObjectKind_Stream;
+        case VC_VIRTUAL_MIC_VOLUME:
+            return kObjectKind_Volume;
+        case VC_VIRTUAL_MIC_MUTE:
+            return kObjectKind_Mute;
+        default:
+            return kObjectKind_Unknown;
+    }
+}
+
+DeviceIOState* VirtualMic_DeviceState(AudioObjectID inObjectID) {
+    if (inObjectID == kObjectID_Device_Speaker) {
+        return &gDriverState.speaker;
+    }
+    VCVirtualMicObject object;
+    int mic = vc_virtual_mic_index(inObjectID, &object);
+    if (mic < 0 || mic >= kMicDeviceCount || object != VC_VIRTUAL_MIC_DEVICE) {
+        return NULL;
+    }
+    return &gDriverState.mics[mic];
+}
+
+DeviceIOState* VirtualMic_MicState(AudioObjectID inObjectID) {
+    int mic = vc_virtual_mic_index(inObjectID, NULL);
+    if (mic < 0 || mic >= kMicDeviceCount) {
+        return NULL;
+    }
+    return &gDriverState.mics[mic];
+}
+
 #pragma mark - Device Management
 
 static OSStatus VirtualMic_CreateDevice(AudioServerPlugInDriverRef inDriver, CFDictionaryRef inDescription, const AudioServerPlugInClientInfo* inClientInfo, AudioObjectID* outDeviceObjectID) {
@@ -230,8 +342,8 @@ static Boolean VirtualMic_HasProperty(AudioServerPlugInDriverRef inDriver, Audio
     (void)inDriver;
     (void)inClientProcessID;
 
-    switch (inObjectID) {
-        case kObjectID_PlugIn:
+    switch (VirtualMic_ObjectKind(inObjectID)) {
+        case kObjectKind_PlugIn:
             switch (inAddress->mSelector) {
                 case kAudioObjectPropertyBaseClass:
                 case kAudioObjectPropertyClass:
@@ -245,7 +357,7 @@ static Boolean VirtualMic_HasProperty(AudioServerPlugInDriverRef inDriver, Audio
             }
             break;
 
-        case kObjectID_Device:
+        case kObjectKind_Device:
             switch (inAddress->mSelector) {
                 case kAudioObjectPropertyBaseClass:
                 case kAudioObjectPropertyClass:
@@ -272,7 +384,7 @@ static Boolean VirtualMic_HasProperty(AudioServerPlugInDriverRef inDriver, Audio
             }
             break;
 
-        case kObjectID_Stream_Input:
+        case kObjectKind_Stream:
             switch (inAddress->mSelector) {
                 case kAudioObjectPropertyBaseClass:
                 case kAudioObjectPropertyClass:
@@ -291,8 +403,8 @@ static Boolean VirtualMic_HasProperty(AudioServerPlugInDriverRef inDriver, Audio
             }
             break;
 
-        case kObjectID_Volume_Input:
-        case kObjectID_Mute_Input:
+        case kObjectKind_Volume:
+        case kObjectKind_Mute:
             switch (inAddress->mSelector) {
                 case kAudioObjectPropertyBaseClass:
                 case kAudioObjectPropertyClass:
@@ -309,6 +421,9 @@ static Boolean VirtualMic_HasProperty(AudioServerPlugInDriverRef inDriver, Audio
                     return true;
             }
             break;
+
+        case kObjectKind_Unknown:
+            break;
     }
 
     return false;
@@ -320,32 +435,35 @@ static OSStatus VirtualMic_IsPropertySettable(AudioServerPlugInDriverRef inDrive
 
     *outIsSettable = false;
 
-    switch (inObjectID) {
-        case kObjectID_Device:
+    switch (VirtualMic_ObjectKind(inObjectID)) {
+        case kObjectKind_Device:
             if (inAddress->mSelector == kAudioDevicePropertyNominalSampleRate) {
                 *outIsSettable = false;  // サンプルレート固定
             }
             break;
 
-        case kObjectID_Stream_Input:
+        case kObjectKind_Stream:
             if (inAddress->mSelector == kAudioStreamPropertyVirtualFormat ||
                 inAddress->mSelector == kAudioStreamPropertyPhysicalFormat) {
                 *outIsSettable = false;  // フォーマット固定
             }
             break;
 
-        case kObjectID_Volume_Input:
+        case kObjectKind_Volume:
             if (inAddress->mSelector == kAudioLevelControlPropertyScalarValue ||
                 inAddress->mSelector == kAudioLevelControlPropertyDecibelValue) {
                 *outIsSettable = true;
             }
             break;
 
-        case kObjectID_Mute_Input:
+        case kObjectKind_Mute:
             if (inAddress->mSelector == kAudioBooleanControlPropertyValue) {
                 *outIsSettable = true;
             }
             break;
+
+        default:
+            break;
     }
 
     return noErr;
@@ -430,15 +548,27 @@ static OSStatus VirtualMic_GetPropertyDataSize(AudioServerPlugInDriverRef inDriv
         case kAudioObjectPropertyControlList:
             // オブジェクトによって異なる
             if (inObjectID == kObjectID_PlugIn) {
-                *outDataSize = sizeof(AudioObjectID);  // 1デバイス
-            } else if (inObjectID == kObjectID_Device) {
+                *outDataSize = sizeof(AudioObjectID) * kDeviceCount;
+            } else if (VirtualMic_ObjectKind(inObjectID) == kObjectKind_Device && inObjectID != kObjectID_Device_Speaker) {
                 if (inAddress->mSelector == kAudioDevicePropertyStreams) {
-                    *outDataSize = sizeof(AudioObjectID);  // 1ストリーム
+                    // 入力ストリームのみ
+                    bool matches = inAddress->mScope != kAudioObjectPropertyScopeOutput;
+                    *outDataSize = matches ? sizeof(AudioObjectID) : 0;
                 } else if (inAddress->mSelector == kAudioObjectPropertyControlList) {
                     *outDataSize = sizeof(AudioObjectID) * 2;  // Volume + Mute
                 } else {
                     *outDataSize = sizeof(AudioObjectID) * 3;  // Stream + Volume + Mute
                 }
+            } else if (inObjectID == kObjectID_Device_Speaker) {
+                if (inAddress->mSelector == kAudioDevicePropertyStreams) {
+                    // 出力ストリームのみ
+                    bool matches = inAddress->mScope != kAudioObjectPropertyScopeInput;
+                    *outDataSize = matches ? sizeof(AudioObjectID) : 0;
+                } else if (inAddress->mSelector == kAudioObjectPropertyControlList) {
+                    *outDataSize = 0;
+                } else {
+                    *outDataSize = sizeof(AudioObjectID);  // Stream
+                }
             }
             break;
 
@@ -452,30 +582,28 @@ static OSStatus VirtualMic_GetPropertyDataSize(AudioServerPlugInDriverRef inDriv
 static OSStatus VirtualMic_GetPropertyData(AudioServerPlugInDriverRef inDriver, AudioObjectID inObjectID, pid_t inClientProcessID, const AudioObjectPropertyAddress* inAddress, UInt32 inQualifierDataSize, const void* inQualifierData, UInt32 inDataSize, UInt32* outDataSize, void* outData) {
     (void)inDriver;
     (void)inClientProcessID;
-    (void)inQualifierDataSize;
-    (void)inQualifierData;
 
     OSStatus result = noErr;
 
-    switch (inObjectID) {
-        case kObjectID_PlugIn:
-            result = VirtualMic_GetPlugInPropertyData(inAddress, inDataSize, outDataSize, outData);
+    switch (VirtualMic_ObjectKind(inObjectID)) {
+        case kObjectKind_PlugIn:
+            result = VirtualMic_GetPlugInPropertyData(inAddress, inQualifierDataSize, inQualifierData, inDataSize, outDataSize, outData);
             break;
 
-        case kObjectID_Device:
-            result = VirtualMic_GetDevicePropertyData(inAddress, inDataSize, outDataSize, outData);
+        case kObjectKind_Device:
+            result = VirtualMic_GetDevicePropertyData(inObjectID, inAddress, inDataSize, outDataSize, outData);
             break;
 
-        case kObjectID_Stream_Input:
-            result = VirtualMic_GetStreamPropertyData(inAddress, inDataSize, outDataSize, outData);
+        case kObjectKind_Stream:
+            result = VirtualMic_GetStreamPropertyData(inObjectID, inAddress, inDataSize, outDataSize, outData);
             break;
 
-        case kObjectID_Volume_Input:
-            result = VirtualMic_GetVolumePropertyData(inAddress, inDataSize, outDataSize, outData);
+        case kObjectKind_Volume:
+            result = VirtualMic_GetVolumePropertyData(inObjectID, inAddress, inDataSize, outDataSize, outData);
             break;
 
-        case kObjectID_Mute_Input:
-            result = VirtualMic_GetMutePropertyData(inAddress, inDataSize, outDataSize, outData);
+        case kObjectKind_Mute:
+            result = VirtualMic_GetMutePropertyData(inObjectID, inAddress, inDataSize, outDataSize, outData);
             break;
 
         default:
@@ -494,21 +622,18 @@ static OSStatus VirtualMic_SetPropertyData(AudioServerPlugInDriverRef inDriver,
     (void)inDataSize;
 
     OSStatus result = noErr;
+    DeviceIOState* mic = VirtualMic_MicState(inObjectID);
 
-    switch (inObjectID) {
-        case kObjectID_Volume_Input:
+    switch (VirtualMic_ObjectKind(inObjectID)) {
+        case kObjectKind_Volume:
             if (inAddress->mSelector == kAudioLevelControlPropertyScalarValue) {
-                pthread_mutex_lock(&gDriverState.stateMutex);
-                gDriverState.inputVolumeScalar = *(Float32*)inData;
-                pthread_mutex_unlock(&gDriverState.stateMutex);
+                atomic_store_explicit(&mic->volumeScalar, *(Float32*)inData, memory_order_relaxed);
             }
             break;
 
-        case kObjectID_Mute_Input:
+        case kObjectKind_Mute:
             if (inAddress->mSelector == kAudioBooleanControlPropertyValue) {
-                pthread_mutex_lock(&gDriverState.stateMutex);
-                gDriverState.inputMute = (*(UInt32*)inData != 0);
-                pthread_mutex_unlock(&gDriverState.stateMutex);
+                atomic_store_explicit(&mic->mute, *(UInt32*)inData != 0, memory_order_relaxed);
             }
             break;
 
@@ -524,24 +649,36 @@ static OSStatus VirtualMic_SetPropertyData(AudioServerPlugInDriverRef inDriver,
 
 static OSStatus VirtualMic_StartIO(AudioServerPlugInDriverRef inDriver, AudioObjectID inDeviceObjectID, UInt32 inClientID) {
     (void)inDriver;
-    (void)inDeviceObjectID;
     (void)inClientID;
 
-    LOG_INFO("VirtualMic_StartIO");
+    LOG_INFO("VirtualMic_StartIO (device %u)", (unsigned)inDeviceObjectID);
 
-    pthread_mutex_lock(&gDriverState.stateMutex);
+    DeviceIOState* io = VirtualMic_DeviceState(inDeviceObjectID);
+    if (io == NULL) {
+        return kAudioHardwareBadObjectError;
+    }
 
-    if (gDriverState.ioClientCount == 0) {
-        gDriverState.anchorHostTime = mach_absolute_time();
-        atomic_store(&gDriverState.isIORunning, true);
+    pthread_mutex_lock(&gDriverState.stateMutex);
 
-        // 共有メモリを再接続（アプリが起動している場合）
-        if (gDriverState.sharedBuffer == NULL) {
-            SharedMemory_Open(&gDriverState);
+    if (io->ioClientCount == 0) {
+        io->anchorHostTime = mach_absolute_time();
+
+        // 未接続なら保守スレッドにすぐ開いてもらう（shm_open / mmap はロックの外。開けたら IO の先頭で受け取る）
+        SharedMemoryMapping* memory = SharedMemory_Acquire(&io->memory);
+        if (memory->mapping == NULL) {
+            SharedMemory_Request(&io->memory, kRemapRequest_Start);
+        } else {
+            vc_shared_ring_watch_init(&memory->watch, &memory->ring, mach_absolute_time(), gDriverState.heartbeatTimeoutTicks);
+            // 仮想スピーカーはドライバが producer（あとから受け取った区画は Speaker_WriteMix が稼働にする）
+            if (!io->isInput) {
+                vc_shared_ring_set_active(&memory->ring, 1);
+            }
         }
+
+        atomic_store(&io->isIORunning, true);
     }
 
-    gDriverState.ioClientCount++;
+    io->ioClientCount++;
 
     pthread_mutex_unlock(&gDriverState.stateMutex);
 
@@ -550,18 +687,27 @@ static OSStatus VirtualMic_StartIO(AudioServerPlugInDriverRef inDriver, AudioObj
 
 static OSStatus VirtualMic_StopIO(AudioServerPlugInDriverRef inDriver, AudioObjectID inDeviceObjectID, UInt32 inClientID) {
     (void)inDriver;
-    (void)inDeviceObjectID;
     (void)inClientID;
 
-    LOG_INFO("VirtualMic_StopIO");
+    LOG_INFO("VirtualMic_StopIO (device %u)", (unsigned)inDeviceObjectID);
+
+    DeviceIOState* io = VirtualMic_DeviceState(inDeviceObjectID);
+    if (io == NULL) {
+        return kAudioHardwareBadObjectError;
+    }
 
     pthread_mutex_lock(&gDriverState.stateMutex);
 
-    if (gDriverState.ioClientCount > 0) {
-        gDriverState.ioClientCount--;
+    if (io->ioClientCount > 0) {
+        io->ioClientCount--;
+
+        if (io->ioClientCount == 0) {
+            atomic_store(&io->isIORunning, false);
 
-        if (gDriverState.ioClientCount == 0) {
-            atomic_store(&gDriverState.isIORunning, false);
+            SharedMemoryMapping* memory = atomic_load(&io->memory.current);
+            if (!io->isInput && memory->mapping != NULL) {
+                vc_shared_ring_set_active(&memory->ring, 0);
+            }
         }
     }
 
@@ -572,36 +718,52 @@ static OSStatus VirtualMic_StopIO(AudioServerPlugInDriverRef inDriver, AudioObje
 
 static OSStatus VirtualMic_GetZeroTimeStamp(AudioServerPlugInDriverRef inDriver, AudioObjectID inDeviceObjectID, UInt32 inClientID, Float64* outSampleTime, UInt64* outHostTime, UInt64* outSeed) {
     (void)inDriver;
-    (void)inDeviceObjectID;
     (void)inClientID;
 
-    UInt64 currentHostTime = mach_absolute_time();
-    UInt64 elapsedHostTime = currentHostTime - gDriverState.anchorHostTime;
-    Float64 elapsedSampleTime = elapsedHostTime / gDriverState.hostTicksPerFrame;
+    DeviceIOState* io = VirtualMic_DeviceState(inDeviceObjectID);
+    if (io == NULL) {
+        return kAudioHardwareBadObjectError;
+    }
 
     // ゼロタイムスタンプを計算（周期に丸める）
-    UInt64 samplePeriod = (UInt64)kFrameSize;
-    UInt64 sampleTimePeriods = (UInt64)elapsedSampleTime / samplePeriod;
-
-    *outSampleTime = (Float64)(sampleTimePeriods * samplePeriod);
-    *outHostTime = gDriverState.anchorHostTime + (UInt64)(*outSampleTime * gDriverState.hostTicksPerFrame);
+    UInt64 currentHostTime = mach_absolute_time();
+    vc_driver_zero_timestamp(io->anchorHostTime, currentHostTime, gDriverState.hostTicksPerFrame, kFrameSize,
+                             outSampleTime, outHostTime);
     *outSeed = 1;
 
+    if (io->micIndex == 0) {
+        VCIOTraceRecord record = { currentHostTime, VC_IO_TRACE_ZERO_TIMESTAMP, 0, 0, 0, 0, *outHostTime };
+        Trace_Write(io, &record);
+    }
+
     return noErr;
 }
 
 static OSStatus VirtualMic_WillDoIOOperation(AudioServerPlugInDriverRef inDriver, AudioObjectID inDeviceObjectID, UInt32 inClientID, UInt32 inOperationID, Boolean* outWillDo, Boolean* outIsInput) {
     (void)inDriver;
-    (void)inDeviceObjectID;
     (void)inClientID;
 
     *outWillDo = false;
     *outIsInput = false;
 
+    DeviceIOState* io = VirtualMic_DeviceState(inDeviceObjectID);
+    if (io == NULL) {
+        return kAudioHardwareBadObjectError;
+    }
+
     switch (inOperationID) {
         case kAudioServerPlugInIOOperationReadInput:
-            *outWillDo = true;
-            *outIsInput = true;
+            if (io->isInput) {
+                *outWillDo = true;
+                *outIsInput = true;
+            }
+            break;
+
+        case kAudioServerPlugInIOOperationWriteMix:
+            if (!io->isInput) {
+                *outWillDo = true;
+                *outIsInput = false;
+            }
             break;
     }
 
@@ -621,73 +783,185 @@ static OSStatus VirtualMic_BeginIOOperation(AudioServerPlugInDriverRef inDriver,
 
 static OSStatus VirtualMic_DoIOOperation(AudioServerPlugInDriverRef inDriver, AudioObjectID inDeviceObjectID, AudioObjectID inStreamObjectID, UInt32 inClientID, UInt32 inOperationID, UInt32 inIOBufferFrameSize, const AudioServerPlugInIOCycleInfo* inIOCycleInfo, void* ioMainBuffer, void* ioSecondaryBuffer) {
     (void)inDriver;
-    (void)inDeviceObjectID;
     (void)inStreamObjectID;
     (void)inClientID;
-    (void)inIOCycleInfo;
     (void)ioSecondaryBuffer;
 
-    if (inOperationID != kAudioServerPlugInIOOperationReadInput) {
-        return noErr;
+    DeviceIOState* io = VirtualMic_DeviceState(inDeviceObjectID);
+    if (io == NULL) {
+        return kAudioHardwareBadObjectError;
     }
 
-    Float32* outputBuffer = (Float32*)ioMainBuffer;
-    VCSharedBuffer* shared = gDriverState.sharedBuffer;
+    switch (inOperationID) {
+        case kAudioServerPlugInIOOperationReadInput:
+            if (io->isInput) {
+                UInt64 now = mach_absolute_time();
+                VCDriverReadResult result = Mic_ReadInput(io, (Float32*)ioMainBuffer, inIOBufferFrameSize, now,
+                                                          inIOCycleInfo->mInputTime.mSampleTime);
+                if (io->micIndex == 0) {
+                    Tap_WriteDelivered((const Float32*)ioMainBuffer, inIOBufferFrameSize);
+                    VCIOTraceRecord record = {
+                        now, VC_IO_TRACE_READ, (uint16_t)result.status, inIOBufferFrameSize,
+                        result.writeIndex, result.readIndex,
+                        vc_io_trace_pack_double(inIOCycleInfo->mInputTime.mSampleTime),
+                    };
+                    Trace_Write(io, &record);
+                }
+            }
+            break;
 
-    // 共有メモリがない、または非アクティブの場合は無音
-    if (shared == NULL ||
-        shared->magic != kSharedMemoryMagic ||
-        atomic_load(&shared->state) != 1) {
-        memset(outputBuffer, 0, inIOBufferFrameSize * sizeof(Float32));
-        return noErr;
+        case kAudioServerPlugInIOOperationWriteMix:
+            if (!io->isInput) {
+                Speaker_WriteMix(io, (const Float32*)ioMainBuffer, inIOBufferFrameSize);
+            }
+            break;
     }
 
-    // リングバッファから読み取り
-    uint32_t readIdx = atomic_load(&shared->readIndex);
-    uint32_t writeIdx = atomic_load(&shared->writeIndex);
-    uint32_t bufferSize = shared->bufferFrames * shared->frameSize;
+    return noErr;
+}
 
-    uint32_t available = (writeIdx >= readIdx) ?
-        (writeIdx - readIdx) :
-        (bufferSize - readIdx + writeIdx);
+/// 仮想マイク: アプリが書いたリングから読み出す（IO スレッド）
+/// 読み出しの本体は VCDriverIO（IO トレースのリプレイと同じコード）。ここは接続の張り替えとログ、ボリューム、受け渡しの刻印だけ
+static VCDriverReadResult Mic_ReadInput(DeviceIOState* io, Float32* outputBuffer, UInt32 frameCount, UInt64 now, Float64 inputSampleTime) {
+    SharedMemoryMapping* memory = SharedMemory_Acquire(&io->memory);
+    VCSharedRing* ring = memory->mapping != NULL ? &memory->ring : NULL;
 
-    if (available < inIOBufferFrameSize) {
-        // アンダーラン - 無音で補完
-        memset(outputBuffer, 0, inIOBufferFrameSize * sizeof(Float32));
-        return noErr;
+    // アプリが未起動なら保守スレッドに接続を頼む
+    if (ring == NULL) {
+        SharedMemory_Request(&io->memory, kRemapRequest_Open);
     }
 
-    // 読み取り位置
-    uint32_t startPos = readIdx % bufferSize;
+    VCDriverReadResult result = vc_driver_read_input(ring, &memory->watch, now, outputBuffer, (int)frameCount, &io->peerActive);
 
-    if (startPos + inIOBufferFrameSize <= bufferSize) {
-        // 連続コピー
-        memcpy(outputBuffer, &shared->samples[startPos], inIOBufferFrameSize * sizeof(Float32));
-    } else {
-        // 2分割コピー（wrap-around）
-        uint32_t firstPart = bufferSize - startPos;
-        memcpy(outputBuffer, &shared->samples[startPos], firstPart * sizeof(Float32));
-        memcpy(outputBuffer + firstPart, shared->samples, (inIOBufferFrameSize - firstPart) * sizeof(Float32));
+    // 状態が変わったときだけ記録する
+    if (result.events & VC_DRIVER_PEER_EVENT_ACTIVE) {
+        LOG_RT(io, kDriverLogEvent_SourceActive, 0, 0);
+    }
+    if (result.events & VC_DRIVER_PEER_EVENT_INACTIVE) {
+        LOG_RT(io, kDriverLogEvent_SourceInactive, 0, 0);
+    }
+    if (result.events & VC_DRIVER_PEER_EVENT_LOST) {
+        VCSharedRingPeer peer = result.status == VC_DRIVER_READ_REPLACED ? VC_SHARED_RING_PEER_REPLACED : VC_SHARED_RING_PEER_STALLED;
+        LOG_RT(io, kDriverLogEvent_PeerLost, peer, vc_shared_ring_generation(ring));
+    }
+
+    switch (result.status) {
+        case VC_DRIVER_READ_REPLACED:
+            // 古いビューは読まずに張り替えを待つ
+            SharedMemory_Request(&io->memory, kRemapRequest_Replaced);
+            return result;
+        case VC_DRIVER_READ_UNDERRUN:
+            // アンダーラン - 無音で補完
+            LOG_RT(io, kDriverLogEvent_Underrun, frameCount, result.available);
+            return result;
+        case VC_DRIVER_READ_OK:
+            break;
+        default:
+            return result;
     }
 
-    // 読み取りインデックス更新
-    atomic_store(&shared->readIndex, readIdx + inIOBufferFrameSize);
+    // このブロックの先頭をクライアントに渡す時刻（ゼロタイムスタンプと同じ時間軸）をアプリに返す
+    vc_shared_ring_stamp_delivery(ring, result.readIndex,
+                                  vc_driver_sample_host_time(io->anchorHostTime, inputSampleTime, gDriverState.hostTicksPerFrame));
 
-    // ミュート/ボリューム適用
-    pthread_mutex_lock(&gDriverState.stateMutex);
-    bool mute = gDriverState.inputMute;
-    Float32 volume = gDriverState.inputVolumeScalar;
-    pthread_mutex_unlock(&gDriverState.stateMutex);
+    // ミュート/ボリューム適用（ロックせずに読む。StartIO / StopIO が stateMutex を持っていても待たない）
+    bool mute = atomic_load_explicit(&io->mute, memory_order_relaxed);
+    Float32 volume = atomic_load_explicit(&io->volumeScalar, memory_order_relaxed);
 
     if (mute) {
-        memset(outputBuffer, 0, inIOBufferFrameSize * sizeof(Float32));
+        memset(outputBuffer, 0, frameCount * sizeof(Float32));
     } else if (volume != 1.0f) {
-        for (UInt32 i = 0; i < inIOBufferFrameSize; i++) {
+        for (UInt32 i = 0; i < frameCount; i++) {
             outputBuffer[i] *= volume;
         }
     }
+    return result;
+}
 
-    return noErr;
+/// 仮想スピーカー: クライアントのミックスをアプリ向けリングへ書き込む（IO スレッド）
+/// アプリが読んでいなければリングが満杯になり、新しい分を捨てる
+static void Speaker_WriteMix(DeviceIOState* io, const Float32* mixBuffer, UInt32 frameCount) {
+    SharedMemoryMapping* memory = SharedMemory_Acquire(&io->memory);
+    if (memory->mapping == NULL) {
+        SharedMemory_Request(&io->memory, kRemapRequest_Open);
+        if (io->peerActive) {
+            io->peerActive = 0;
+            LOG_RT(io, kDriverLogEvent_SinkDetached, 0, 0);
+        }
+        return;
+    }
+
+    // アプリ（consumer）が区画を作り直した
+    VCSharedRingPeer peer = vc_shared_ring_watch_check(&memory->watch, &memory->ring, mach_absolute_time());
+    if (peer == VC_SHARED_RING_PEER_REPLACED) {
+        SharedMemory_Request(&io->memory, kRemapRequest_Replaced);
+        if (io->peerActive) {
+            io->peerActive = 0;
+            LOG_RT(io, kDriverLogEvent_PeerLost, peer, vc_shared_ring_generation(&memory->ring));
+        }
+        return;
+    }
+    // 張り替えた直後の区画はまだ非稼働
+    if (!vc_shared_ring_is_active(&memory->ring)) {
+        vc_shared_ring_set_active(&memory->ring, 1);
+    }
+    io->peerActive = 1;
+
+    int written = vc_shared_ring_write(&memory->ring, mixBuffer, (int)frameCount);
+    if (written < (int)frameCount) {
+        LOG_RT(io, kDriverLogEvent_Overflow, frameCount, written);
+    }
+}
+
+/// 録音タップ: 仮想マイク 0 が HAL に渡した音声をアプリ向けリングへ書き込む（IO スレッド）
+/// アプリが録音していなければ区画がないか満杯なので、何も書かずに戻る
+static void Tap_WriteDelivered(const Float32* buffer, UInt32 frameCount) {
+    SharedMemoryLink* link = &gDriverState.tap;
+    SharedMemoryMapping* memory = SharedMemory_Acquire(link);
+    if (memory->mapping == NULL) {
+        SharedMemory_Request(link, kRemapRequest_Open);
+        return;
+    }
+    if (vc_shared_ring_watch_check(&memory->watch, &memory->ring, mach_absolute_time()) == VC_SHARED_RING_PEER_REPLACED) {
+        SharedMemory_Request(link, kRemapRequest_Replaced);
+        return;
+    }
+    vc_shared_ring_write(&memory->ring, buffer, (int)frameCount);
+}
+
+/// IO トレース: 仮想マイク 0 の IO 周期とゼロタイムスタンプを記録する（IO スレッド）
+/// 再生に必要な設定（アンカー・リング容量・時計）は変わったとき、または kTraceConfigInterval 周期ごとに先に書く
+/// アプリが記録していなければ区画がないか満杯なので、何も書かずに戻る
+static void Trace_Write(const DeviceIOState* io, const VCIOTraceRecord* record) {
+    SharedMemoryLink* link = &gDriverState.trace;
+    SharedMemoryMapping* memory = SharedMemory_Acquire(link);
+    if (memory->mapping == NULL) {
+        SharedMemory_Request(link, kRemapRequest_Open);
+        return;
+    }
+    if (vc_shared_ring_watch_check(&memory->watch, &memory->ring, mach_absolute_time()) == VC_SHARED_RING_PEER_REPLACED) {
+        SharedMemory_Request(link, kRemapRequest_Replaced);
+        gDriverState.traceConfigCountdown = 0;
+        return;
+    }
+
+    SharedMemoryMapping* source = atomic_load_explicit(&io->memory.current, memory_order_relaxed);
+    UInt32 capacity = source->mapping != NULL ? source->ring.capacity : 0;
+    if (gDriverState.traceConfigCountdown == 0 || io->anchorHostTime != gDriverState.traceAnchor ||
+        capacity != gDriverState.traceCapacity) {
+        VCIOTraceRecord config = {
+            io->anchorHostTime, VC_IO_TRACE_CONFIG, 0, (uint32_t)kSampleRate, capacity, kFrameSize,
+            vc_io_trace_pack_double(gDriverState.hostTicksPerFrame),
+        };
+        if (vc_io_trace_write(&memory->ring, &config) != 0) {
+            return;
+        }
+        gDriverState.traceAnchor = io->anchorHostTime;
+        gDriverState.traceCapacity = capacity;
+        gDriverState.traceConfigCountdown = kTraceConfigInterval;
+    }
+    gDriverState.traceConfigCountdown--;
+    vc_io_trace_write(&memory->ring, record);
 }
 
 static OSStatus VirtualMic_EndIOOperation(AudioServerPlugInDriverRef inDriver, AudioObjectID inDeviceObjectID, UInt32 inClientID, UInt32 inOperationID, UInt32 inIOBufferFrameSize, const AudioServerPlugInIOCycleInfo* inIOCycleInfo) {
@@ -703,48 +977,251 @@ static OSStatus VirtualMic_EndIOOperation(AudioServerPlugInDriverRef inDriver, A
 
 #pragma mark - Shared Memory
 
-static OSStatus SharedMemory_Open(VirtualMicDriverState* state) {
-    int fd = shm_open(kSharedMemoryName, O_RDONLY, 0644);
+static void SharedMemory_InitLink(SharedMemoryLink* link, const char* name) {
+    snprintf(link->name, sizeof(link->name), "%s", name);
+    for (int slot = 0; slot < 2; slot++) {
+        link->slots[slot].mapping = NULL;
+        link->slots[slot].fd = -1;
+    }
+    atomic_store(&link->current, &link->slots[0]);
+    atomic_store(&link->pending, NULL);
+    atomic_store(&link->request, 0);
+    link->nextRetryTime = 0;
+}
+
+static OSStatus SharedMemory_Open(const char* name, SharedMemoryMapping* memory) {
+    // consumer 側もインデックスを書くため読み書きでマップする
+    int fd = shm_open(name, O_RDWR, 0644);
     if (fd < 0) {
-        LOG_DEBUG("Shared memory not available yet");
+        LOG_DEBUG("Shared memory %{public}s not available yet", name);
         return kAudioHardwareNotReadyError;
     }
 
-    // サイズ計算
-    size_t headerSize = 64;  // アライメント済み
-    size_t bufferSize = kFrameSize * kBufferFrameCount * sizeof(float);
-    size_t totalSize = headerSize + bufferSize;
+    // サイズはアプリ側が決める（ヘッダーの容量と突き合わせて検証）
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size < VC_SHARED_RING_HEADER_SIZE) {
+        LOG_ERROR("Shared memory %{public}s has invalid size", name);
+        close(fd);
+        return kAudioHardwareUnspecifiedError;
+    }
+    size_t totalSize = (size_t)info.st_size;
 
-    void* ptr = mmap(NULL, totalSize, PROT_READ, MAP_SHARED, fd, 0);
+    void* ptr = mmap(NULL, totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
     if (ptr == MAP_FAILED) {
-        LOG_ERROR("Failed to mmap shared memory");
+        LOG_ERROR("Failed to mmap shared memory %{public}s", name);
         close(fd);
         return kAudioHardwareUnspecifiedError;
     }
 
-    state->sharedBuffer = (VCSharedBuffer*)ptr;
-    state->sharedMemoryFD = fd;
-    state->sharedMemorySize = totalSize;
+    memory->fd = fd;
+    memory->size = totalSize;
 
     // 検証
-    if (state->sharedBuffer->magic != kSharedMemoryMagic) {
-        LOG_ERROR("Invalid shared memory magic");
-        SharedMemory_Close(state);
+    if (vc_shared_ring_attach(&memory->ring, ptr, totalSize) != 0 ||
+        vc_shared_ring_sample_rate(&memory->ring) != (int)kSampleRate) {
+        LOG_ERROR("Invalid shared memory header in %{public}s", name);
+        munmap(ptr, totalSize);
+        SharedMemory_Close(memory);
         return kAudioHardwareUnspecifiedError;
     }
 
-    LOG_INFO("Shared memory opened successfully");
+    // IO スレッドは mapping を見て接続を判断するので最後に公開する
+    vc_shared_ring_watch_init(&memory->watch, &memory->ring, mach_absolute_time(), gDriverState.heartbeatTimeoutTicks);
+    memory->mapping = ptr;
+
+    LOG_INFO("Shared memory %{public}s opened successfully (generation %u)", name,
+             (unsigned)vc_shared_ring_generation(&memory->ring));
     return noErr;
 }
 
-static void SharedMemory_Close(VirtualMicDriverState* state) {
-    if (state->sharedBuffer != NULL) {
-        munmap(state->sharedBuffer, state->sharedMemorySize);
-        state->sharedBuffer = NULL;
+static void SharedMemory_Close(SharedMemoryMapping* memory) {
+    if (memory->mapping != NULL) {
+        munmap(memory->mapping, memory->size);
+        memory->mapping = NULL;
+    }
+
+    if (memory->fd >= 0) {
+        close(memory->fd);
+        memory->fd = -1;
+    }
+}
+
+/// IO の先頭で張り替えを受け取る（IO スレッド。ロックしない）
+/// current を切り替えてから pending を空にするので、保守スレッドは pending が空なら古い接続を閉じてよい
+static SharedMemoryMapping* SharedMemory_Acquire(SharedMemoryLink* link) {
+    SharedMemoryMapping* next = atomic_load_explicit(&link->pending, memory_order_acquire);
+    if (next != NULL) {
+        atomic_store_explicit(&link->current, next, memory_order_release);
+        atomic_store_explicit(&link->pending, NULL, memory_order_release);
+        return next;
+    }
+    return atomic_load_explicit(&link->current, memory_order_relaxed);
+}
+
+/// 保守スレッドに張り替えを頼む（IO スレッド。同じ要求が残っている間は起こし直さない）
+static void SharedMemory_Request(SharedMemoryLink* link, unsigned int request) {
+    unsigned int previous = atomic_fetch_or_explicit(&link->request, request, memory_order_release);
+    if ((previous & request) == 0 && gDriverState.remapSignal != MACH_PORT_NULL) {
+        semaphore_signal(gDriverState.remapSignal);
     }
+}
+
+/// 1つの接続先の張り替え（保守スレッド）
+static void SharedMemory_Maintain(SharedMemoryLink* link, UInt64 now) {
+    // IO スレッドがまだ受け取っていない
+    if (atomic_load_explicit(&link->pending, memory_order_acquire) != NULL) {
+        return;
+    }
+
+    // 受け取り済みなら、もう一方は IO スレッドが使っていないので閉じる
+    SharedMemoryMapping* current = atomic_load_explicit(&link->current, memory_order_acquire);
+    SharedMemoryMapping* spare = current == &link->slots[0] ? &link->slots[1] : &link->slots[0];
+    SharedMemory_Close(spare);
+
+    unsigned int request = atomic_load_explicit(&link->request, memory_order_acquire);
+    if (request == 0) {
+        return;
+    }
+    // アプリの起動待ちは間隔を空ける（要求は残しておき、IO スレッドが起こし直さないようにする）
+    if ((request & (kRemapRequest_Replaced | kRemapRequest_Start)) == 0 && now < link->nextRetryTime) {
+        return;
+    }
+    atomic_fetch_and_explicit(&link->request, ~request, memory_order_acq_rel);
+    link->nextRetryTime = now + gDriverState.remapRetryTicks;
+
+    if (SharedMemory_Open(link->name, spare) != noErr) {
+        return;
+    }
+    atomic_store_explicit(&link->pending, spare, memory_order_release);
+    LOG_INFO("Shared memory %{public}s remapped", link->name);
+}
+
+static void SharedMemory_StartRemap(VirtualMicDriverState* state) {
+    if (state->remapSignal != MACH_PORT_NULL) {
+        return;
+    }
+    if (semaphore_create(mach_task_self(), &state->remapSignal, SYNC_POLICY_FIFO, 0) != KERN_SUCCESS) {
+        LOG_ERROR("Failed to create shared memory remap semaphore");
+        state->remapSignal = MACH_PORT_NULL;
+        return;
+    }
+
+    // ドライバは coreaudiod と同じ寿命なので、スレッドは終了させない
+    if (pthread_create(&state->remapThread, NULL, SharedMemory_RemapThread, state) != 0) {
+        LOG_ERROR("Failed to start shared memory remap thread");
+        semaphore_destroy(mach_task_self(), state->remapSignal);
+        state->remapSignal = MACH_PORT_NULL;
+        return;
+    }
+    pthread_detach(state->remapThread);
+}
+
+/// IO スレッドの要求で起き、区画を開いて pending に置く（RT ではないので shm_open / mmap してよい）
+static void* SharedMemory_RemapThread(void* arg) {
+    VirtualMicDriverState* state = (VirtualMicDriverState*)arg;
+    mach_timespec_t interval = { 0, kRemapRetryIntervalMs * 1000000 };
+
+    for (;;) {
+        semaphore_timedwait(state->remapSignal, interval);
+
+        // 区画を開くのはこのスレッドだけなので、ロックは持たない（IO スレッドへは pending で渡す）
+        UInt64 now = mach_absolute_time();
+        for (int mic = 0; mic < kMicDeviceCount; mic++) {
+            SharedMemory_Maintain(&state->mics[mic].memory, now);
+        }
+        SharedMemory_Maintain(&state->speaker.memory, now);
+        SharedMemory_Maintain(&state->tap, now);
+        SharedMemory_Maintain(&state->trace, now);
+    }
+    return NULL;
+}
+
+#pragma mark - RT Log
+
+static void DriverLog_Start(VirtualMicDriverState* state) {
+    if (state->speaker.logRing != NULL) {
+        return;
+    }
+
+    bool created = true;
+    for (int mic = 0; mic < kMicDeviceCount; mic++) {
+        state->mics[mic].logRing = vc_log_ring_create(kDriverLogRingCapacity);
+        created = created && state->mics[mic].logRing != NULL;
+    }
+    state->speaker.logRing = vc_log_ring_create(kDriverLogRingCapacity);
+    created = created && state->speaker.logRing != NULL;
+
+    // ドライバは coreaudiod と同じ寿命なので、スレッドは終了させない
+    if (!created) {
+        LOG_ERROR("Failed to create RT log rings");
+    } else if (pthread_create(&state->logThread, NULL, DriverLog_DrainThread, state) != 0) {
+        LOG_ERROR("Failed to start RT log drain thread");
+    } else {
+        pthread_detach(state->logThread);
+        return;
+    }
+
+    // LOG_RT はリングがなければ何もしない
+    for (int mic = 0; mic < kMicDeviceCount; mic++) {
+        vc_log_ring_destroy(state->mics[mic].logRing);
+        state->mics[mic].logRing = NULL;
+    }
+    vc_log_ring_destroy(state->speaker.logRing);
+    state->speaker.logRing = NULL;
+}
+
+/// 1つのデバイスのリングを空にする（ドレインスレッド）
+/// 仮想マイクは複数あるので、どのデバイスのイベントかを共有メモリの名前で添える
+static void DriverLog_Drain(DeviceIOState* io) {
+    const char* device = io->memory.name;
+    VCLogEvent event;
+    while (vc_log_ring_read(io->logRing, &event)) {
+        switch (event.eventId) {
+            case kDriverLogEvent_Underrun:
+                LOG_DEBUG("[%{public}s] Underrun: requested %u frames, available %u", device,
+                          (unsigned)event.args[0], (unsigned)event.args[1]);
+                break;
+            case kDriverLogEvent_SourceInactive:
+                LOG_DEBUG("[%{public}s] Shared memory source inactive, outputting silence", device);
+                break;
+            case kDriverLogEvent_SourceActive:
+                LOG_DEBUG("[%{public}s] Shared memory source active", device);
+                break;
+            case kDriverLogEvent_Overflow:
+                LOG_DEBUG("[%{public}s] Speaker overflow: wrote %u of %u frames", device,
+                          (unsigned)event.args[1], (unsigned)event.args[0]);
+                break;
+            case kDriverLogEvent_SinkDetached:
+                LOG_DEBUG("[%{public}s] Speaker shared memory not connected, dropping mix", device);
+                break;
+            case kDriverLogEvent_PeerLost:
+                LOG_INFO("[%{public}s] Shared memory peer %{public}s (generation %u)", device,
+                         event.args[0] == VC_SHARED_RING_PEER_REPLACED ? "replaced" : "stopped",
+                         (unsigned)event.args[1]);
+                break;
+            default:
+                LOG_DEBUG("[%{public}s] Unknown RT log event %u", device, event.eventId);
+                break;
+        }
+    }
+
+    uint64_t dropped = vc_log_ring_dropped(io->logRing);
+    if (dropped != io->reportedLogDrops) {
+        LOG_INFO("[%{public}s] RT log dropped %llu events", device, (unsigned long long)(dropped - io->reportedLogDrops));
+        io->reportedLogDrops = dropped;
+    }
+}
+
+static void* DriverLog_DrainThread(void* arg) {
+    VirtualMicDriverState* state = (VirtualMicDriverState*)arg;
+
+    for (;;) {
+        for (int mic = 0; mic < kMicDeviceCount; mic++) {
+            DriverLog_Drain(&state->mics[mic]);
+        }
+        DriverLog_Drain(&state->speaker);
 
-    if (state->sharedMemoryFD >= 0) {
-        close(state->sharedMemoryFD);
-        state->sharedMemoryFD = -1;
+        usleep(kDriverLogDrainIntervalMs * 1000);
     }
+    return NULL;
 }
@@ -10,9 +10,15 @@
 
 #include <CoreAudio/AudioServerPlugIn.h>
 #include <CoreFoundation/CoreFoundation.h>
+#include <mach/mach.h>
 #include <mach/mach_time.h>
 #include <stdatomic.h>
 #include <pthread.h>
+#include "VCDriverIO.h"
+#include "VCIOTrace.h"
+#include "VCLog.h"
+#include "VCSharedRing.h"
+#include "VCVirtualMic.h"
 
 #pragma mark - Constants
 
@@ -21,39 +27,105 @@
 #define kBitsPerChannel         32
 #define kChannelsPerFrame       1
 #define kFrameSize              256
-#define kBufferFrameCount       64
 
 // オブジェクトID
+// 仮想マイクは vc_virtual_mic_object_id の方式で番号を振る（マイク 0 は下の 2〜5、マイク k は 16 + 4(k-1) から）
 enum {
     kObjectID_PlugIn            = 1,
-    kObjectID_Device            = 2,
+    kObjectID_Device            = 2,    // 仮想マイク 0
     kObjectID_Stream_Input      = 3,
     kObjectID_Volume_Input      = 4,
     kObjectID_Mute_Input        = 5,
+    kObjectID_Device_Speaker    = 6,    // 仮想スピーカー（Listening モード）
+    kObjectID_Stream_Output     = 7,
 };
 
-// 共有メモリ
-#define kSharedMemoryName       "com.voicechanger.audio"
-#define kSharedMemoryMagic      0x4D564356  // 'VCVM'
-#define kSharedMemoryVersion    1
+// 公開する仮想マイクの数（マイクごとにデバイス・入力ストリーム・ボリューム・ミュートを持つ）
+#define kMicDeviceCount         4
+#define kDeviceCount            (kMicDeviceCount + 1)   // + 仮想スピーカー
 
-#pragma mark - Shared Memory Structure
+_Static_assert(kMicDeviceCount <= VC_VIRTUAL_MIC_MAX, "kMicDeviceCount exceeds VC_VIRTUAL_MIC_MAX");
+_Static_assert(kObjectID_Device_Speaker < VC_VIRTUAL_MIC_EXTRA_BASE, "speaker IDs overlap the extra mic IDs");
 
+// 共有メモリ（どちらもアプリが作成し、ドライバは接続のみ。レイアウトは VCSharedRing）
+// 仮想マイク k は vc_virtual_mic_memory_name の名前（com.voicechanger.audio, com.voicechanger.audio.2, ...）
+#define kSpeakerMemoryName      "com.voicechanger.speaker"  // Driver → App（仮想スピーカー）
+#define kTapMemoryName          "com.voicechanger.tap"      // Driver → App（仮想マイク 0 が渡した音声。アプリの録音用）
+#define kTraceMemoryName        "com.voicechanger.iotrace"  // Driver → App（仮想マイク 0 の IO トレース。VCIOTrace のレコード）
+
+// IO トレースの設定レコードを入れ直す間隔（IO 周期。途中から記録を始めても再生できるように）
+#define kTraceConfigInterval    512
+
+// 共有メモリの監視（DoIO で相手の停止・作り直しを検出し、張り替えは保守スレッドで行う）
+#define kHeartbeatTimeoutMs     15      // producer の heartbeat がこれ以上止まったら停止とみなす
+#define kRemapRetryIntervalMs   100     // 区画がまだない間の再接続の間隔
+
+enum {
+    kRemapRequest_Open      = 1 << 0,   // 未接続（アプリの起動待ち。間隔を空けて試す）
+    kRemapRequest_Replaced  = 1 << 1,   // アプリが区画を作り直した（すぐに張り替える）
+    kRemapRequest_Start     = 1 << 2,   // StartIO の時点で未接続（すぐに開く）
+};
+
+// RTログ（DoIO から LOG_RT で記録し、ドレインスレッドで os_log に出力）
+// VCLogRing は書き込み側が1つだけのリングなので、IO スレッドを持つデバイスごとに1本ずつ持つ
+#define kDriverLogRingCapacity  256
+#define kDriverLogDrainIntervalMs 100
+
+enum {
+    kDriverLogEvent_Underrun        = 1,    // args: 要求フレーム数, 利用可能フレーム数
+    kDriverLogEvent_SourceInactive  = 2,    // 共有メモリ未接続または非アクティブ
+    kDriverLogEvent_SourceActive    = 3,    // 共有メモリからの読み取り再開
+    kDriverLogEvent_Overflow        = 4,    // args: 書き込みフレーム数, 書き込めたフレーム数（仮想スピーカー）
+    kDriverLogEvent_SinkDetached    = 5,    // 仮想スピーカーの共有メモリ未接続
+    kDriverLogEvent_PeerLost        = 6,    // args: VCSharedRingPeer, 世代（アプリの停止 / 作り直し）
+};
+
+#pragma mark - Device IO State
+
+// 共有メモリの接続（mmap したリング）
 typedef struct {
-    // ヘッダー (64 bytes aligned)
-    uint32_t magic;
-    uint32_t version;
-    uint32_t sampleRate;
-    uint32_t frameSize;
-    uint32_t bufferFrames;
-    _Atomic uint32_t writeIndex;
-    _Atomic uint32_t readIndex;
-    _Atomic uint32_t state;         // 0=inactive, 1=active
-    uint32_t reserved[8];
-
-    // リングバッファ (starts at offset 64)
-    float samples[];
-} VCSharedBuffer;
+    void* mapping;
+    size_t size;
+    int fd;
+    VCSharedRing ring;              // mapping != NULL のときのみ有効
+    VCSharedRingWatch watch;        // IO スレッドのみが更新
+} SharedMemoryMapping;
+
+// 共有メモリの接続先（張り替えは保守スレッドが開き、IO スレッドは IO の先頭で受け取るだけ）
+// 区画を開く（shm_open / mmap）のは初期化と保守スレッドだけで、どのロックも持たずに行う
+// 使い終わった接続は、IO スレッドが pending を受け取ったあとに保守スレッドが閉じる
+typedef struct {
+    char name[VC_VIRTUAL_MIC_MEMORY_NAME_MAX];
+    SharedMemoryMapping slots[2];
+    _Atomic(SharedMemoryMapping*) current;  // IO スレッドが使う接続（IO スレッドのみが切り替える）
+    _Atomic(SharedMemoryMapping*) pending;  // 保守スレッドが開いた次の接続
+    atomic_uint request;                    // IO スレッド → 保守スレッド（kRemapRequest_*）
+    UInt64 nextRetryTime;                   // 保守スレッドのみ
+} SharedMemoryLink;
+
+// デバイスごとの IO 状態
+typedef struct {
+    AudioObjectID deviceID;
+    AudioObjectID streamID;
+    bool isInput;
+    int micIndex;                   // 仮想マイクの番号（仮想スピーカーは -1）
+
+    // ボリューム/ミュート（仮想マイクのみ。プロパティ側が書き、IO スレッドはロックせずに読む）
+    _Atomic(Float32) volumeScalar;
+    atomic_bool mute;
+
+    atomic_bool isIORunning;
+    UInt32 ioClientCount;           // stateMutex で保護
+    UInt64 anchorHostTime;
+
+    SharedMemoryLink memory;
+    int peerActive;                 // IO スレッドのみが読み書き（状態変化時だけ記録する）
+
+    // RTログ（書き込みはこのデバイスの IO スレッドのみ。読み出しはドレインスレッド）
+    // 仮想マイクはそれぞれ別の IO スレッドで ReadInput するので、マイク同士でも共有しない
+    VCLogRing* logRing;
+    uint64_t reportedLogDrops;      // ドレインスレッドのみ
+} DeviceIOState;
 
 #pragma mark - Driver State
 
@@ -63,25 +135,33 @@ typedef struct {
 
     // タイミング
     Float64 hostTicksPerFrame;
-    UInt64 anchorHostTime;
+    UInt64 heartbeatTimeoutTicks;
+    UInt64 remapRetryTicks;
 
-    // 状態
-    atomic_bool isIORunning;
-    UInt32 ioClientCount;
+    // デバイス（仮想マイク / 仮想スピーカー）
+    DeviceIOState mics[kMicDeviceCount];
+    DeviceIOState speaker;
 
-    // 共有メモリ
-    VCSharedBuffer* sharedBuffer;
-    int sharedMemoryFD;
-    size_t sharedMemorySize;
+    // 録音タップ（書き込みは仮想マイク 0 の IO スレッドのみ）
+    SharedMemoryLink tap;
 
-    // ボリューム/ミュート
-    Float32 inputVolumeScalar;
-    bool inputMute;
+    // IO トレース（書き込みは仮想マイク 0 の IO スレッドのみ。最後に書いた設定を覚えておく）
+    SharedMemoryLink trace;
+    UInt64 traceAnchor;
+    UInt32 traceCapacity;
+    UInt32 traceConfigCountdown;
 
     // mutex
     pthread_mutex_t stateMutex;
     pthread_mutex_t ioMutex;
 
+    // 共有メモリの保守（IO スレッドは semaphore_signal で起こす）
+    semaphore_t remapSignal;
+    pthread_t remapThread;
+
+    // RTログ（リングは各デバイスが持ち、ドレインスレッドがまとめて読む）
+    pthread_t logThread;
+
 } VirtualMicDriverState;
 
 #pragma mark - Function Prototypes
@@ -89,12 +169,30 @@ typedef struct {
 // ファクトリ関数
 extern void* VirtualMic_Create(CFAllocatorRef inAllocator, CFUUIDRef inRequestedTypeUUID);
 
+// オブジェクトの種類（仮想マイクは複数あるので、プロパティは ID ではなく種類で振り分ける）
+typedef enum {
+    kObjectKind_Unknown = 0,
+    kObjectKind_PlugIn,
+    kObjectKind_Device,
+    kObjectKind_Stream,
+    kObjectKind_Volume,
+    kObjectKind_Mute,
+} VirtualMicObjectKind;
+
+VirtualMicObjectKind VirtualMic_ObjectKind(AudioObjectID inObjectID);
+
+// デバイスIDから IO 状態を引く（不明なら NULL）
+DeviceIOState* VirtualMic_DeviceState(AudioObjectID inObjectID);
+
+// 仮想マイクのオブジェクト（デバイス・ストリーム・コントロール）から、そのマイクの IO 状態を引く（不明なら NULL）
+DeviceIOState* VirtualMic_MicState(AudioObjectID inObjectID);
+
 // プロパティ取得ヘルパー（VirtualMicProperties.c で定義）
-OSStatus VirtualMic_GetPlugInPropertyData(const AudioObjectPropertyAddress* inAddress, UInt32 inDataSize, UInt32* outDataSize, void* outData);
-OSStatus VirtualMic_GetDevicePropertyData(const AudioObjectPropertyAddress* inAddress, UInt32 inDataSize, UInt32* outDataSize, void* outData);
-OSStatus VirtualMic_GetStreamPropertyData(const AudioObjectPropertyAddress* inAddress, UInt32 inDataSize, UInt32* outDataSize, void* outData);
-OSStatus VirtualMic_GetVolumePropertyData(const AudioObjectPropertyAddress* inAddress, UInt32 inDataSize, UInt32* outDataSize, void* outData);
-OSStatus VirtualMic_GetMutePropertyData(const AudioObjectPropertyAddress* inAddress, UInt32 inDataSize, UInt32* outDataSize, void* outData);
+OSStatus VirtualMic_GetPlugInPropertyData(const AudioObjectPropertyAddress* inAddress, UInt32 inQualifierDataSize, const void* inQualifierData, UInt32 inDataSize, UInt32* outDataSize, void* outData);
+OSStatus VirtualMic_GetDevicePropertyData(AudioObjectID inObjectID, const AudioObjectPropertyAddress* inAddress, UInt32 inDataSize, UInt32* outDataSize, void* outData);
+OSStatus VirtualMic_GetStreamPropertyData(AudioObjectID inObjectID, const AudioObjectPropertyAddress* inAddress, UInt32 inDataSize, UInt32* outDataSize, void* outData);
+OSStatus VirtualMic_GetVolumePropertyData(AudioObjectID inObjectID, const AudioObjectPropertyAddress* inAddress, UInt32 inDataSize, UInt32* outDataSize, void* outData);
+OSStatus VirtualMic_GetMutePropertyData(AudioObjectID inObjectID, const AudioObjectPropertyAddress* inAddress, UInt32 inDataSize, UInt32* outDataSize, void* outData);
 
 // グローバルドライバ状態（VirtualMicDriver.c で定義）
 extern VirtualMicDriverState gDriverState;
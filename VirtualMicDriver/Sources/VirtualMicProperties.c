@@ -10,7 +10,44 @@
 
 #pragma mark - PlugIn Properties
 
-OSStatus VirtualMic_GetPlugInPropertyData(const AudioObjectPropertyAddress* inAddress, UInt32 inDataSize, UInt32* outDataSize, void* outData) {
+// 仮想マイクの UID（マイク 0 は従来のまま。番号は共有メモリ名のサフィックスと揃える）
+static CFStringRef MicUID(int mic) {
+    const CFStringRef uids[VC_VIRTUAL_MIC_MAX] = {
+        CFSTR("com.voicechanger.virtualmicdriver"),
+        CFSTR("com.voicechanger.virtualmicdriver.mic2"),
+        CFSTR("com.voicechanger.virtualmicdriver.mic3"),
+        CFSTR("com.voicechanger.virtualmicdriver.mic4"),
+        CFSTR("com.voicechanger.virtualmicdriver.mic5"),
+        CFSTR("com.voicechanger.virtualmicdriver.mic6"),
+        CFSTR("com.voicechanger.virtualmicdriver.mic7"),
+        CFSTR("com.voicechanger.virtualmicdriver.mic8"),
+    };
+    return uids[mic];
+}
+
+static CFStringRef MicName(int mic) {
+    const CFStringRef names[VC_VIRTUAL_MIC_MAX] = {
+        CFSTR("VoiceChanger Virtual Mic"),
+        CFSTR("VoiceChanger Virtual Mic 2"),
+        CFSTR("VoiceChanger Virtual Mic 3"),
+        CFSTR("VoiceChanger Virtual Mic 4"),
+        CFSTR("VoiceChanger Virtual Mic 5"),
+        CFSTR("VoiceChanger Virtual Mic 6"),
+        CFSTR("VoiceChanger Virtual Mic 7"),
+        CFSTR("VoiceChanger Virtual Mic 8"),
+    };
+    return names[mic];
+}
+
+// デバイスIDと UID の対応
+static CFStringRef DeviceUID(AudioObjectID inObjectID) {
+    if (inObjectID == kObjectID_Device_Speaker) {
+        return CFSTR("com.voicechanger.virtualmicdriver.speaker");
+    }
+    return MicUID(VirtualMic_MicState(inObjectID)->micIndex);
+}
+
+OSStatus VirtualMic_GetPlugInPropertyData(const AudioObjectPropertyAddress* inAddress, UInt32 inQualifierDataSize, const void* inQualifierData, UInt32 inDataSize, UInt32* outDataSize, void* outData) {
     OSStatus result = noErr;
 
     switch (inAddress->mSelector) {
@@ -44,16 +81,32 @@ OSStatus VirtualMic_GetPlugInPropertyData(const AudioObjectPropertyAddress* inAd
 
         case kAudioObjectPropertyOwnedObjects:
         case kAudioPlugInPropertyDeviceList:
-            *outDataSize = sizeof(AudioObjectID);
-            if (inDataSize >= sizeof(AudioObjectID)) {
-                *(AudioObjectID*)outData = kObjectID_Device;
+            *outDataSize = sizeof(AudioObjectID) * kDeviceCount;
+            if (inDataSize >= sizeof(AudioObjectID) * kDeviceCount) {
+                AudioObjectID* ids = (AudioObjectID*)outData;
+                for (int mic = 0; mic < kMicDeviceCount; mic++) {
+                    ids[mic] = gDriverState.mics[mic].deviceID;
+                }
+                ids[kMicDeviceCount] = kObjectID_Device_Speaker;
             }
             break;
 
         case kAudioPlugInPropertyTranslateUIDToDevice:
             *outDataSize = sizeof(AudioObjectID);
             if (inDataSize >= sizeof(AudioObjectID)) {
-                *(AudioObjectID*)outData = kObjectID_Device;
+                AudioObjectID device = kAudioObjectUnknown;
+                if (inQualifierDataSize >= sizeof(CFStringRef) && inQualifierData != NULL) {
+                    CFStringRef uid = *(const CFStringRef*)inQualifierData;
+                    for (int mic = 0; mic < kMicDeviceCount; mic++) {
+                        if (CFEqual(uid, MicUID(mic))) {
+                            device = gDriverState.mics[mic].deviceID;
+                        }
+                    }
+                    if (CFEqual(uid, DeviceUID(kObjectID_Device_Speaker))) {
+                        device = kObjectID_Device_Speaker;
+                    }
+                }
+                *(AudioObjectID*)outData = device;
             }
             break;
 
@@ -74,8 +127,10 @@ OSStatus VirtualMic_GetPlugInPropertyData(const AudioObjectPropertyAddress* inAd
 
 #pragma mark - Device Properties
 
-OSStatus VirtualMic_GetDevicePropertyData(const AudioObjectPropertyAddress* inAddress, UInt32 inDataSize, UInt32* outDataSize, void* outData) {
+OSStatus VirtualMic_GetDevicePropertyData(AudioObjectID inObjectID, const AudioObjectPropertyAddress* inAddress, UInt32 inDataSize, UInt32* outDataSize, void* outData) {
     OSStatus result = noErr;
+    bool isSpeaker = (inObjectID == kObjectID_Device_Speaker);
+    DeviceIOState* io = VirtualMic_DeviceState(inObjectID);
 
     switch (inAddress->mSelector) {
         case kAudioObjectPropertyBaseClass:
@@ -102,7 +157,7 @@ OSStatus VirtualMic_GetDevicePropertyData(const AudioObjectPropertyAddress* inAd
         case kAudioObjectPropertyName:
             *outDataSize = sizeof(CFStringRef);
             if (inDataSize >= sizeof(CFStringRef)) {
-                *(CFStringRef*)outData = CFSTR("VoiceChanger Virtual Mic");
+                *(CFStringRef*)outData = isSpeaker ? CFSTR("VoiceChanger Virtual Speaker") : MicName(io->micIndex);
             }
             break;
 
@@ -116,7 +171,7 @@ OSStatus VirtualMic_GetDevicePropertyData(const AudioObjectPropertyAddress* inAd
         case kAudioDevicePropertyDeviceUID:
             *outDataSize = sizeof(CFStringRef);
             if (inDataSize >= sizeof(CFStringRef)) {
-                *(CFStringRef*)outData = CFSTR("com.voicechanger.virtualmicdriver");
+                *(CFStringRef*)outData = DeviceUID(inObjectID);
             }
             break;
 
@@ -144,15 +199,16 @@ OSStatus VirtualMic_GetDevicePropertyData(const AudioObjectPropertyAddress* inAd
         case kAudioDevicePropertyDeviceIsRunning:
             *outDataSize = sizeof(UInt32);
             if (inDataSize >= sizeof(UInt32)) {
-                *(UInt32*)outData = atomic_load(&gDriverState.isIORunning) ? 1 : 0;
+                *(UInt32*)outData = (io != NULL && atomic_load(&io->isIORunning)) ? 1 : 0;
             }
             break;
 
         case kAudioDevicePropertyDeviceCanBeDefaultDevice:
             *outDataSize = sizeof(UInt32);
             if (inDataSize >= sizeof(UInt32)) {
-                // 入力デバイスのみ（スコープによる）
-                *(UInt32*)outData = (inAddress->mScope == kAudioObjectPropertyScopeInput) ? 1 : 0;
+                // 仮想マイクは入力、仮想スピーカーは出力のみ（スコープによる）
+                AudioObjectPropertyScope scope = isSpeaker ? kAudioObjectPropertyScopeOutput : kAudioObjectPropertyScopeInput;
+                *(UInt32*)outData = (inAddress->mScope == scope) ? 1 : 0;
             }
             break;
 
@@ -170,33 +226,47 @@ OSStatus VirtualMic_GetDevicePropertyData(const AudioObjectPropertyAddress* inAd
             }
             break;
 
-        case kAudioDevicePropertyStreams:
-            if (inAddress->mScope == kAudioObjectPropertyScopeInput) {
+        case kAudioDevicePropertyStreams: {
+            // Global スコープでは全ストリームを返す
+            AudioObjectPropertyScope otherScope = isSpeaker ? kAudioObjectPropertyScopeInput : kAudioObjectPropertyScopeOutput;
+            if (inAddress->mScope != otherScope) {
                 *outDataSize = sizeof(AudioObjectID);
                 if (inDataSize >= sizeof(AudioObjectID)) {
-                    *(AudioObjectID*)outData = kObjectID_Stream_Input;
+                    *(AudioObjectID*)outData = io->streamID;
                 }
             } else {
                 *outDataSize = 0;
             }
             break;
+        }
 
         case kAudioObjectPropertyControlList:
+            if (isSpeaker) {
+                *outDataSize = 0;  // コントロールなし
+                break;
+            }
             *outDataSize = sizeof(AudioObjectID) * 2;
             if (inDataSize >= sizeof(AudioObjectID) * 2) {
                 AudioObjectID* ids = (AudioObjectID*)outData;
-                ids[0] = kObjectID_Volume_Input;
-                ids[1] = kObjectID_Mute_Input;
+                ids[0] = vc_virtual_mic_object_id(io->micIndex, VC_VIRTUAL_MIC_VOLUME);
+                ids[1] = vc_virtual_mic_object_id(io->micIndex, VC_VIRTUAL_MIC_MUTE);
             }
             break;
 
         case kAudioObjectPropertyOwnedObjects:
+            if (isSpeaker) {
+                *outDataSize = sizeof(AudioObjectID);
+                if (inDataSize >= sizeof(AudioObjectID)) {
+                    *(AudioObjectID*)outData = kObjectID_Stream_Output;
+                }
+                break;
+            }
             *outDataSize = sizeof(AudioObjectID) * 3;
             if (inDataSize >= sizeof(AudioObjectID) * 3) {
                 AudioObjectID* ids = (AudioObjectID*)outData;
-                ids[0] = kObjectID_Stream_Input;
-                ids[1] = kObjectID_Volume_Input;
-                ids[2] = kObjectID_Mute_Input;
+                ids[0] = io->streamID;
+                ids[1] = vc_virtual_mic_object_id(io->micIndex, VC_VIRTUAL_MIC_VOLUME);
+                ids[2] = vc_virtual_mic_object_id(io->micIndex, VC_VIRTUAL_MIC_MUTE);
             }
             break;
 
@@ -247,8 +317,9 @@ OSStatus VirtualMic_GetDevicePropertyData(const AudioObjectPropertyAddress* inAd
 
 #pragma mark - Stream Properties
 
-OSStatus VirtualMic_GetStreamPropertyData(const AudioObjectPropertyAddress* inAddress, UInt32 inDataSize, UInt32* outDataSize, void* outData) {
+OSStatus VirtualMic_GetStreamPropertyData(AudioObjectID inObjectID, const AudioObjectPropertyAddress* inAddress, UInt32 inDataSize, UInt32* outDataSize, void* outData) {
     OSStatus result = noErr;
+    bool isOutput = (inObjectID == kObjectID_Stream_Output);
 
     switch (inAddress->mSelector) {
         case kAudioObjectPropertyBaseClass:
@@ -268,14 +339,14 @@ OSStatus VirtualMic_GetStreamPropertyData(const AudioObjectPropertyAddress* inAd
         case kAudioObjectPropertyOwner:
             *outDataSize = sizeof(AudioObjectID);
             if (inDataSize >= sizeof(AudioObjectID)) {
-                *(AudioObjectID*)outData = kObjectID_Device;
+                *(AudioObjectID*)outData = isOutput ? kObjectID_Device_Speaker : VirtualMic_MicState(inObjectID)->deviceID;
             }
             break;
 
         case kAudioObjectPropertyName:
             *outDataSize = sizeof(CFStringRef);
             if (inDataSize >= sizeof(CFStringRef)) {
-                *(CFStringRef*)outData = CFSTR("VoiceChanger Input");
+                *(CFStringRef*)outData = isOutput ? CFSTR("VoiceChanger Output") : CFSTR("VoiceChanger Input");
             }
             break;
 
@@ -289,14 +360,14 @@ OSStatus VirtualMic_GetStreamPropertyData(const AudioObjectPropertyAddress* inAd
         case kAudioStreamPropertyDirection:
             *outDataSize = sizeof(UInt32);
             if (inDataSize >= sizeof(UInt32)) {
-                *(UInt32*)outData = 1;  // 1 = input
+                *(UInt32*)outData = isOutput ? 0 : 1;  // 0 = output, 1 = input
             }
             break;
 
         case kAudioStreamPropertyTerminalType:
             *outDataSize = sizeof(UInt32);
             if (inDataSize >= sizeof(UInt32)) {
-                *(UInt32*)outData = kAudioStreamTerminalTypeMicrophone;
+                *(UInt32*)outData = isOutput ? kAudioStreamTerminalTypeSpeaker : kAudioStreamTerminalTypeMicrophone;
             }
             break;
 
@@ -358,8 +429,9 @@ OSStatus VirtualMic_GetStreamPropertyData(const AudioObjectPropertyAddress* inAd
 
 #pragma mark - Volume Control Properties
 
-OSStatus VirtualMic_GetVolumePropertyData(const AudioObjectPropertyAddress* inAddress, UInt32 inDataSize, UInt32* outDataSize, void* outData) {
+OSStatus VirtualMic_GetVolumePropertyData(AudioObjectID inObjectID, const AudioObjectPropertyAddress* inAddress, UInt32 inDataSize, UInt32* outDataSize, void* outData) {
     OSStatus result = noErr;
+    DeviceIOState* mic = VirtualMic_MicState(inObjectID);
 
     switch (inAddress->mSelector) {
         case kAudioObjectPropertyBaseClass:
@@ -379,7 +451,7 @@ OSStatus VirtualMic_GetVolumePropertyData(const AudioObjectPropertyAddress* inAd
         case kAudioObjectPropertyOwner:
             *outDataSize = sizeof(AudioObjectID);
             if (inDataSize >= sizeof(AudioObjectID)) {
-                *(AudioObjectID*)outData = kObjectID_Device;
+                *(AudioObjectID*)outData = mic->deviceID;
             }
             break;
 
@@ -404,18 +476,14 @@ OSStatus VirtualMic_GetVolumePropertyData(const AudioObjectPropertyAddress* inAd
         case kAudioLevelControlPropertyScalarValue:
             *outDataSize = sizeof(Float32);
             if (inDataSize >= sizeof(Float32)) {
-                pthread_mutex_lock(&gDriverState.stateMutex);
-                *(Float32*)outData = gDriverState.inputVolumeScalar;
-                pthread_mutex_unlock(&gDriverState.stateMutex);
+                *(Float32*)outData = atomic_load_explicit(&mic->volumeScalar, memory_order_relaxed);
             }
             break;
 
         case kAudioLevelControlPropertyDecibelValue:
             *outDataSize = sizeof(Float32);
             if (inDataSize >= sizeof(Float32)) {
-                pthread_mutex_lock(&gDriverState.stateMutex);
-                Float32 scalar = gDriverState.inputVolumeScalar;
-                pthread_mutex_unlock(&gDriverState.stateMutex);
+                Float32 scalar = atomic_load_explicit(&mic->volumeScalar, memory_order_relaxed);
                 // スカラー値をdBに変換 (0-1 -> -96 to 0 dB)
                 *(Float32*)outData = (scalar > 0) ? (20.0f * log10f(scalar)) : -96.0f;
             }
@@ -446,8 +514,9 @@ OSStatus VirtualMic_GetVolumePropertyData(const AudioObjectPropertyAddress* inAd
 
 #pragma mark - Mute Control Properties
 
-OSStatus VirtualMic_GetMutePropertyData(const AudioObjectPropertyAddress* inAddress, UInt32 inDataSize, UInt32* outDataSize, void* outData) {
+OSStatus VirtualMic_GetMutePropertyData(AudioObjectID inObjectID, const AudioObjectPropertyAddress* inAddress, UInt32 inDataSize, UInt32* outDataSize, void* outData) {
     OSStatus result = noErr;
+    DeviceIOState* mic = VirtualMic_MicState(inObjectID);
 
     switch (inAddress->mSelector) {
         case kAudioObjectPropertyBaseClass:
@@ -467,7 +536,7 @@ OSStatus VirtualMic_GetMutePropertyData(const AudioObjectPropertyAddress* inAddr
         case kAudioObjectPropertyOwner:
             *outDataSize = sizeof(AudioObjectID);
             if (inDataSize >= sizeof(AudioObjectID)) {
-                *(AudioObjectID*)outData = kObjectID_Device;
+                *(AudioObjectID*)outData = mic->deviceID;
             }
             break;
 
@@ -492,9 +561,7 @@ OSStatus VirtualMic_GetMutePropertyData(const AudioObjectPropertyAddress* inAddr
         case kAudioBooleanControlPropertyValue:
             *outDataSize = sizeof(UInt32);
             if (inDataSize >= sizeof(UInt32)) {
-                pthread_mutex_lock(&gDriverState.stateMutex);
-                *(UInt32*)outData = gDriverState.inputMute ? 1 : 0;
-                pthread_mutex_unlock(&gDriverState.stateMutex);
+                *(UInt32*)outData = atomic_load_explicit(&mic->mute, memory_order_relaxed) ? 1 : 0;
             }
             break;
 